@@ -342,6 +342,88 @@ const char *aom_codec_error(aom_codec_ctx_t *ctx);
  */
 const char *aom_codec_error_detail(aom_codec_ctx_t *ctx);
 
+/*
+ * Run Time CPU Detection Interface
+ *
+ * Functions with SIMD versions are bound to the best version the CPU supports
+ * when the first codec instance is initialized. The functions below list and
+ * override these bindings.
+ */
+
+/*!\brief Pin run time CPU detected functions to a SIMD tier
+ *
+ * Replaces the overrides of a previous call with the rules of spec, a comma
+ * separated list of name=tier pairs such as
+ * "aom_sad16x16=sse2,av1_convolve_*=ssse3". A name ending in '*' matches
+ * all the functions starting with that prefix, and the last matching rule
+ * wins. tier is "c" or a SIMD extension, e.g. "sse4_1", "avx2" or "neon".
+ * Each matching function is bound to its best version that the CPU supports
+ * without going above that tier. Rules for extensions of other architectures
+ * are ignored. The AOM_RTCD_OVERRIDE environment variable takes the same
+ * rules, which apply before the ones set here.
+ *
+ * This must not be called while a codec instance is running. Overrides only
+ * affect functions that are selected at run time, see
+ * aom_codec_get_rtcd_binding().
+ *
+ * \param[in]    spec    Rules to apply, NULL or "" to clear them.
+ *
+ * \retval #AOM_CODEC_OK
+ *     The overrides were applied.
+ * \retval #AOM_CODEC_INVALID_PARAM
+ *     spec is malformed or names an unknown tier. The overrides are left
+ *     unchanged.
+ */
+aom_codec_err_t aom_codec_set_rtcd_override(const char *spec);
+
+/*!\brief Get the active binding of a run time CPU detected function
+ *
+ * Iterates over the functions of the function tables that have been set up,
+ * which happens when the first codec instance is initialized. Functions that
+ * are bound at build time are listed too.
+ *
+ * \param[in]    index   Index of the function, starting from 0.
+ * \param[out]   name    Name of the function.
+ * \param[out]   tier    Tier of the active version, e.g. "c" or "avx2".
+ *
+ * \return 1 if the function exists, 0 when index is past the last function.
+ */
+int aom_codec_get_rtcd_binding(int index, const char **name, const char **tier);
+
+/*
+ * Thread Pool Interface
+ *
+ * Process-wide setting of the threads that run the jobs of the codec
+ * instances.
+ */
+
+/*!\brief Run the worker threads of codec instances on a shared pool
+ *
+ * With num_threads > 0, the encoder and decoder instances that start their
+ * worker threads afterwards, usually with their first frame, do not create
+ * threads of their own. Their tile, row and filter jobs run on a process-wide
+ * pool of num_threads threads instead. Each instance has at most threads - 1
+ * jobs running on the pool at once, where threads is g_threads of the encoder
+ * or threads of the decoder configuration, and the instances with queued jobs
+ * are served in turn. The thread that calls the codec runs the jobs of its
+ * instance that have not started when it needs their results. 0, the
+ * default, gives each instance threads of its own.
+ *
+ * This must not be called while an instance that uses the pool exists.
+ *
+ * \param[in]    num_threads    Number of threads of the pool, at most 64.
+ *
+ * \retval #AOM_CODEC_OK
+ *     The pool size was set.
+ * \retval #AOM_CODEC_INVALID_PARAM
+ *     num_threads is out of range.
+ * \retval #AOM_CODEC_INCAPABLE
+ *     The library was built without multithreading support.
+ * \retval #AOM_CODEC_ERROR
+ *     An instance uses the pool.
+ */
+aom_codec_err_t aom_codec_set_shared_thread_pool(int num_threads);
+
 /* REQUIRED FUNCTIONS
  *
  * The following functions are required to be implemented for all codecs.
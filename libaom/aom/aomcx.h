@@ -1092,6 +1092,104 @@ enum aome_enc_control_id {
    * Bit value 0: Main Tier; 1: High Tier.
    */
   AV1E_SET_TIER_MASK,
+
+  /*!\brief Codec control function to configure scalable (SVC) encoding with
+   * per-layer rate control, aom_svc_params_t* parameter
+   *
+   * The encoder then codes every superframe as number_spatial_layers
+   * consecutive calls to aom_codec_encode() with the same full resolution
+   * image and pts, one per spatial layer, and picks the temporal layer of
+   * each superframe itself. Requires one pass CBR encoding with
+   * g_lag_in_frames set to 0, and must be called before the first frame.
+   */
+  AV1E_SET_SVC_PARAMS,
+
+  /*!\brief Codec control function to get the spatial and temporal layer of
+   * the last encoded frame, aom_svc_layer_id_t* parameter
+   */
+  AV1E_GET_SVC_LAYER_ID,
+
+  /*!\brief Codec control function to attach motion and partition hints to
+   * the next coded frame, aom_motion_hints_t* parameter
+   *
+   * The hints typically come from the decoder of the source of a transcode
+   * or from another encode of the same content. Hinted motion vectors seed
+   * the full pixel motion search with a reduced search range and hinted
+   * block sizes prune the partition search. The encoder copies the hints;
+   * they are dropped once the next frame is coded. Requires
+   * g_lag_in_frames set to 0, so that the next frame coded is the next input
+   * frame. Passing NULL clears the pending hints.
+   */
+  AV1E_SET_MOTION_HINTS,
+
+  /*!\brief Codec control function to set the path of an analysis cache file,
+   * const char* parameter
+   *
+   * The first pass statistics, the gf group structure decisions and the
+   * temporal dependency analysis are read from the file when it holds them
+   * and added to it otherwise, so that later encodes of the same source can
+   * skip the analysis. Records are matched by the source content and by the
+   * settings that change the analysis, such as the speed, the lag, the gf
+   * interval limits and the enabled tools, but not by the rate control
+   * settings: encodes at other bitrates or cq levels reuse the analysis and
+   * the gf group structure of the encode that wrote it. Set it in both
+   * passes of a two pass encode. Fails if the file exists but holds the
+   * cache of an encode of another frame size. Must be called before the
+   * first frame.
+   */
+  AV1E_SET_ANALYSIS_CACHE,
+
+  /*!\brief Codec control function to allocate the reference frames with a
+   * small border, unsigned int parameter
+   *
+   * The motion search stays within the small border and the predictions of
+   * blocks at the frame edge, scaled references included, are built from
+   * copies of the reference with emulated edges. This saves memory but
+   * costs encoding time: at 352x288, speed 4, a frame buffer takes 299520
+   * instead of 612864 bytes and a frame takes 2398 instead of 2324 ms to
+   * encode. Encodes with resize or superres keep the full border. Must be
+   * called before the first frame.
+   *
+   * By default, this feature is off.
+   *
+   * The controls from here on are numbered after the common controls of
+   * aom.h, which start at 128.
+   */
+  AV1E_SET_ENABLE_SMALL_BORDER = AOM_COMMON_CTRL_ID_MAX,
+
+  /*!\brief Codec control function to time the stages of the encoder,
+   * unsigned int parameter
+   *
+   * When enabled, the wall clock time each stage takes in every
+   * aom_codec_encode() call is measured and can be read with
+   * AV1E_GET_STAGE_TIMING. The times belong to this encoder instance only.
+   *
+   * By default, this feature is off.
+   */
+  AV1E_SET_STAGE_TIMING,
+
+  /*!\brief Codec control function to get the time each stage took in the
+   * last aom_codec_encode() call, aom_enc_stage_timing_t* parameter
+   *
+   * All times are zero unless AV1E_SET_STAGE_TIMING is enabled.
+   */
+  AV1E_GET_STAGE_TIMING,
+
+  /*!\brief Codec control function to pin the worker threads to CPUs,
+   * unsigned int parameter
+   *
+   * When enabled, each worker thread is pinned to a CPU the process may run
+   * on, filling the NUMA node of the calling thread first. With row based
+   * multi-threading, the tiles of a frame are split into contiguous ranges,
+   * one per node in proportion to its workers, and the workers take the rows
+   * of the tiles of their node before those of other nodes, so that each
+   * tile is written by the same node frame after frame. Must be set before
+   * the worker threads are created by the first multi-threaded frame. Has no
+   * effect with the shared thread pool or where the CPUs cannot be queried.
+   *
+   * By default, this feature is off.
+   */
+  AV1E_SET_THREAD_AFFINITY,
 };
 
 /*!\brief aom 1-D scaling mode
@@ -1155,6 +1253,98 @@ typedef struct aom_scaling_mode {
   AOM_SCALING_MODE v_scaling_mode; /**< vertical scaling mode   */
 } aom_scaling_mode_t;
 
+/*!\brief Max number of spatial layers */
+#define AOM_MAX_SS_LAYERS 3
+/*!\brief Max number of temporal layers */
+#define AOM_MAX_TS_LAYERS 3
+/*!\brief Max number of layers */
+#define AOM_MAX_LAYERS (AOM_MAX_SS_LAYERS * AOM_MAX_TS_LAYERS)
+
+/*!\brief  aom scalable coding parameters
+ *
+ * Layer arrays are indexed by spatial_layer_id * number_temporal_layers +
+ * temporal_layer_id. The bitrate of a temporal layer includes all the lower
+ * temporal layers of the same spatial layer, while spatial layers are counted
+ * separately: the stream bitrate is the sum over spatial layers of the top
+ * temporal layer bitrates.
+ */
+typedef struct aom_svc_params {
+  int number_spatial_layers;  /**< Number of spatial layers, 1..3 */
+  int number_temporal_layers; /**< Number of temporal layers, 1..3 */
+  int max_quantizers[AOM_MAX_LAYERS]; /**< Max quantizer (0..63) per layer */
+  int min_quantizers[AOM_MAX_LAYERS]; /**< Min quantizer (0..63) per layer */
+  /*! Downscaling numerator of each spatial layer, relative to g_w/g_h. */
+  int scaling_factor_num[AOM_MAX_SS_LAYERS];
+  /*! Downscaling denominator of each spatial layer. */
+  int scaling_factor_den[AOM_MAX_SS_LAYERS];
+  /*! Target bitrate of each layer, in kilobits per second. */
+  int layer_target_bitrate[AOM_MAX_LAYERS];
+} aom_svc_params_t;
+
+/*!\brief  aom scalable layer of a frame */
+typedef struct aom_svc_layer_id {
+  int spatial_layer_id;  /**< Spatial layer id */
+  int temporal_layer_id; /**< Temporal layer id */
+} aom_svc_layer_id_t;
+
+/*!\brief Number of references a motion hint can point to (LAST..ALTREF) */
+#define AOM_MOTION_HINT_REFS 7
+
+/*!\brief  aom motion vector hint of a 16x16 block */
+typedef struct aom_mv_hint {
+  int16_t row;   /**< Vertical motion in 1/8 pel */
+  int16_t col;   /**< Horizontal motion in 1/8 pel */
+  uint8_t valid; /**< Nonzero if the block has a hint for the reference */
+} aom_mv_hint_t;
+
+/*!\brief  aom motion and partition hints of a frame
+ *
+ * The hints are given per 16x16 block, in raster order, for a frame of
+ * rows x cols 16x16 blocks, the same grid as aom_active_map_t.
+ */
+typedef struct aom_motion_hints {
+  unsigned int rows; /**< Number of 16x16 block rows */
+  unsigned int cols; /**< Number of 16x16 block columns */
+  /*!\brief Motion vectors into each reference, LAST (0) to ALTREF (6). An
+   * entry may be NULL if there are no hints for that reference.
+   */
+  aom_mv_hint_t *mvs[AOM_MOTION_HINT_REFS];
+  /*!\brief Suggested coding block width of each 16x16 block as log2 of the
+   * width in pixels (3 for 8x8 up to 7 for 128x128), 0 for no suggestion.
+   * May be NULL.
+   */
+  uint8_t *block_size_log2;
+} aom_motion_hints_t;
+
+/*!\brief Encoder stages timed by AV1E_SET_STAGE_TIMING */
+typedef enum {
+  AOM_ENC_STAGE_LOOKAHEAD,        /**< Copying sources into the lookahead */
+  AOM_ENC_STAGE_TEMPORAL_FILTER,  /**< Temporal filtering of ARF sources */
+  AOM_ENC_STAGE_TPL,              /**< Temporal dependency model */
+  AOM_ENC_STAGE_MODE_SEARCH,      /**< Partition and mode search */
+  AOM_ENC_STAGE_LOOP_FILTER,      /**< Deblocking level search and filter */
+  AOM_ENC_STAGE_CDEF,             /**< CDEF search and filter */
+  AOM_ENC_STAGE_LOOP_RESTORATION, /**< Restoration search and filter */
+  AOM_ENC_STAGE_PACK_BITSTREAM,   /**< Writing the bitstream */
+  AOM_ENC_STAGE_FIRST_PASS,       /**< First pass analysis */
+  AOM_ENC_STAGES                  /**< Number of stages */
+} aom_enc_stage_t;
+
+/*!\brief Time each encoder stage took in one aom_codec_encode() call */
+typedef struct aom_enc_stage_timing {
+  /*!\brief Wall clock time of each stage, in microseconds, indexed by
+   * aom_enc_stage_t. Stages that ran several times, such as the packing of
+   * recoded frames, are summed.
+   */
+  uint64_t time_us[AOM_ENC_STAGES];
+  /*!\brief CPU time the thread that called aom_codec_encode() spent in each
+   * stage, in microseconds, indexed by aom_enc_stage_t. The CPU time of
+   * worker threads is not included. Wall clock time where the system has no
+   * per-thread CPU clock.
+   */
+  uint64_t cpu_time_us[AOM_ENC_STAGES];
+} aom_enc_stage_timing_t;
+
 /*!brief AV1 encoder content type */
 typedef enum {
   AOM_CONTENT_DEFAULT,
@@ -1512,6 +1702,30 @@ AOM_CTRL_USE_TYPE(AV1E_SET_TARGET_SEQ_LEVEL_IDX, int)
 AOM_CTRL_USE_TYPE(AV1E_SET_TIER_MASK, unsigned int)
 #define AOM_CTRL_AV1E_SET_TIER_MASK
 
+AOM_CTRL_USE_TYPE(AV1E_SET_SVC_PARAMS, aom_svc_params_t *)
+#define AOM_CTRL_AV1E_SET_SVC_PARAMS
+
+AOM_CTRL_USE_TYPE(AV1E_GET_SVC_LAYER_ID, aom_svc_layer_id_t *)
+#define AOM_CTRL_AV1E_GET_SVC_LAYER_ID
+
+AOM_CTRL_USE_TYPE(AV1E_SET_MOTION_HINTS, aom_motion_hints_t *)
+#define AOM_CTRL_AV1E_SET_MOTION_HINTS
+
+AOM_CTRL_USE_TYPE(AV1E_SET_ANALYSIS_CACHE, const char *)
+#define AOM_CTRL_AV1E_SET_ANALYSIS_CACHE
+
+AOM_CTRL_USE_TYPE(AV1E_SET_ENABLE_SMALL_BORDER, unsigned int)
+#define AOM_CTRL_AV1E_SET_ENABLE_SMALL_BORDER
+
+AOM_CTRL_USE_TYPE(AV1E_SET_STAGE_TIMING, unsigned int)
+#define AOM_CTRL_AV1E_SET_STAGE_TIMING
+
+AOM_CTRL_USE_TYPE(AV1E_GET_STAGE_TIMING, aom_enc_stage_timing_t *)
+#define AOM_CTRL_AV1E_GET_STAGE_TIMING
+
+AOM_CTRL_USE_TYPE(AV1E_SET_THREAD_AFFINITY, unsigned int)
+#define AOM_CTRL_AV1E_SET_THREAD_AFFINITY
+
 /*!\endcond */
 /*! @} - end defgroup aom_encoder */
 #ifdef __cplusplus
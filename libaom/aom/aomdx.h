@@ -100,6 +100,50 @@ typedef struct av1_ext_ref_frame {
   int num;
 } av1_ext_ref_frame_t;
 
+/*!\brief Decoder stages timed by AV1D_SET_STAGE_TIMING */
+typedef enum {
+  AOM_DEC_STAGE_HEADER,           /**< Frame header parsing and setup */
+  AOM_DEC_STAGE_TILES,            /**< Tile parsing and reconstruction */
+  AOM_DEC_STAGE_LOOP_FILTER,      /**< Deblocking filter, in AOM_DEC_STAGE_TILES
+                                       when it runs with the tile jobs */
+  AOM_DEC_STAGE_CDEF,             /**< CDEF */
+  AOM_DEC_STAGE_LOOP_RESTORATION, /**< Superres and loop restoration */
+  AOM_DEC_STAGE_FILM_GRAIN,       /**< Film grain synthesis */
+  AOM_DEC_STAGE_OUTPUT,           /**< Output downscaling */
+  AOM_DEC_STAGES                  /**< Number of stages */
+} aom_dec_stage_t;
+
+/*!\brief Maximum number of tile workers in aom_dec_stage_timing_t */
+#define AOM_DEC_STAGE_TIMING_MAX_WORKERS 64
+
+/*!\brief Time each decoder stage took since the last aom_codec_decode() call
+ * started.
+ */
+typedef struct aom_dec_stage_timing {
+  /*! Wall clock time of each stage in microseconds, by aom_dec_stage_t. */
+  uint64_t time_us[AOM_DEC_STAGES];
+  /*! CPU time the thread that called aom_codec_decode() spent in each
+   * stage in microseconds, by aom_dec_stage_t. The CPU time of the other tile
+   * workers is in worker_cpu_us. Wall clock time where the system has no
+   * per-thread CPU clock.
+   */
+  uint64_t cpu_time_us[AOM_DEC_STAGES];
+  /*! Number of tile workers that decoded tiles. The main thread is one of
+   * them. Zero if the tiles were decoded without workers.
+   */
+  int num_workers;
+  /*! Time each tile worker spent decoding tiles in microseconds. */
+  uint64_t worker_busy_us[AOM_DEC_STAGE_TIMING_MAX_WORKERS];
+  /*! Time each tile worker was not decoding tiles while the tiles stage
+   * ran, in microseconds.
+   */
+  uint64_t worker_idle_us[AOM_DEC_STAGE_TIMING_MAX_WORKERS];
+  /*! CPU time each tile worker spent decoding tiles in microseconds. Wall
+   * clock time where the system has no per-thread CPU clock.
+   */
+  uint64_t worker_cpu_us[AOM_DEC_STAGE_TIMING_MAX_WORKERS];
+} aom_dec_stage_timing_t;
+
 /*!\enum aom_dec_control_id
  * \brief AOM decoder control functions
  *
@@ -252,6 +296,68 @@ enum aom_dec_control_id {
    */
   AV1D_SET_SKIP_FILM_GRAIN,
 
+  /** control function to set the fast preview level, for scrubbing and
+   * thumbnails where bit exact output is not needed. Valid values are
+   * integers from 0 to 3:
+   * 0 decodes all frames exactly (the default).
+   * 1 skips the deblocking filter, CDEF and loop restoration on frames that
+   *   no later frame references. Only those frames differ from an exact
+   *   decode.
+   * 2 also skips CDEF and loop restoration on all other frames. Their errors
+   *   drift into the frames that reference them.
+   * 3 skips the deblocking filter, CDEF and loop restoration on all frames.
+   * Superres upscaling is always done, as the frame size depends on it.
+   */
+  AV1D_SET_FAST_PREVIEW,
+
+  /** control function to decode only key frames and intra-only frames, for
+   * thumbnails and seeking. The frame headers of all other frames are parsed
+   * just far enough to find their type, and their tile data is skipped.
+   * Existing frames are shown only if they are key frames that were not shown
+   * before. The argument is an integer. The default value is 0.
+   */
+  AV1D_SET_KEY_FRAMES_ONLY,
+
+  /** control function to downscale the output frames by 1, 2 or 4 in each
+   * dimension. The decoded frames are box filtered after film grain is
+   * applied, and odd sizes round up. The argument is an integer. The default
+   * value is 1.
+   */
+  AV1D_SET_OUTPUT_DOWNSCALE,
+
+  /** control function to time the stages of the decoder. When enabled, the
+   * wall clock time of each stage and the time each tile worker was busy are
+   * measured for this decoder instance, and can be read with
+   * AV1D_GET_STAGE_TIMING. The argument is an integer. The default value is
+   * 0.
+   */
+  AV1D_SET_STAGE_TIMING,
+
+  /** control function to get the stage times since the last
+   * aom_codec_decode() call started, which include the film grain and
+   * output of the frames returned by aom_codec_get_frame() after it. The
+   * argument is a pointer to aom_dec_stage_timing_t.
+   */
+  AV1D_GET_STAGE_TIMING,
+
+  /** control function to reduce the memory used by a decoder instance, for
+   * applications that decode many streams at the same time. When enabled,
+   * the motion vectors, motion field and segmentation maps are only
+   * allocated when the stream uses them, the prediction scratch buffers are
+   * taken from a pool shared by all the decoders of the process while a frame
+   * is decoded, and row based multithreading is replaced by tile based
+   * multithreading. The output is unchanged. The argument is an integer and
+   * must be set before the first frame is decoded. The default value is 0.
+   */
+  AV1D_SET_LOW_MEMORY,
+
+  /** control function to get the largest number of bytes held by the decoder
+   * for the stream after decoding a frame. This counts the frame buffers and
+   * the buffers sized by the stream, not the fixed size of the instance. The
+   * argument is a pointer to uint64_t.
+   */
+  AV1D_GET_PEAK_MEMORY,
+
   AOM_DECODER_CTRL_ID_MAX,
 };
 
@@ -305,6 +411,20 @@ AOM_CTRL_USE_TYPE(AV1D_SET_ROW_MT, unsigned int)
 #define AOM_CTRL_AV1D_SET_ROW_MT
 AOM_CTRL_USE_TYPE(AV1D_SET_SKIP_FILM_GRAIN, int)
 #define AOM_CTRL_AV1D_SET_SKIP_FILM_GRAIN
+AOM_CTRL_USE_TYPE(AV1D_SET_FAST_PREVIEW, int)
+#define AOM_CTRL_AV1D_SET_FAST_PREVIEW
+AOM_CTRL_USE_TYPE(AV1D_SET_KEY_FRAMES_ONLY, int)
+#define AOM_CTRL_AV1D_SET_KEY_FRAMES_ONLY
+AOM_CTRL_USE_TYPE(AV1D_SET_OUTPUT_DOWNSCALE, int)
+#define AOM_CTRL_AV1D_SET_OUTPUT_DOWNSCALE
+AOM_CTRL_USE_TYPE(AV1D_SET_STAGE_TIMING, int)
+#define AOM_CTRL_AV1D_SET_STAGE_TIMING
+AOM_CTRL_USE_TYPE(AV1D_GET_STAGE_TIMING, aom_dec_stage_timing_t *)
+#define AOM_CTRL_AV1D_GET_STAGE_TIMING
+AOM_CTRL_USE_TYPE(AV1D_SET_LOW_MEMORY, int)
+#define AOM_CTRL_AV1D_SET_LOW_MEMORY
+AOM_CTRL_USE_TYPE(AV1D_GET_PEAK_MEMORY, uint64_t *)
+#define AOM_CTRL_AV1D_GET_PEAK_MEMORY
 AOM_CTRL_USE_TYPE(AV1D_SET_IS_ANNEXB, unsigned int)
 #define AOM_CTRL_AV1D_SET_IS_ANNEXB
 AOM_CTRL_USE_TYPE(AV1D_SET_OPERATING_POINT, int)
@@ -21,6 +21,8 @@
 
 #include "aom/aom_integer.h"
 #include "aom/internal/aom_codec_internal.h"
+#include "aom_ports/aom_rtcd.h"
+#include "aom_util/aom_thread.h"
 
 #define SAVE_STATUS(ctx, var) (ctx ? (ctx->err = var) : var)
 
@@ -30,6 +32,24 @@ const char *aom_codec_version_str(void) { return VERSION_STRING_NOSP; }
 
 const char *aom_codec_version_extra_str(void) { return VERSION_EXTRA; }
 
+aom_codec_err_t aom_codec_set_rtcd_override(const char *spec) {
+  return aom_rtcd_set_override(spec) ? AOM_CODEC_INVALID_PARAM : AOM_CODEC_OK;
+}
+
+aom_codec_err_t aom_codec_set_shared_thread_pool(int num_threads) {
+  if (num_threads < 0 || num_threads > MAX_NUM_THREADS)
+    return AOM_CODEC_INVALID_PARAM;
+  if (!CONFIG_MULTITHREAD && num_threads > 0) return AOM_CODEC_INCAPABLE;
+  return aom_worker_pool_set_threads(num_threads) ? AOM_CODEC_OK
+                                                  : AOM_CODEC_ERROR;
+}
+
+int aom_codec_get_rtcd_binding(int index, const char **name,
+                               const char **tier) {
+  if (!name || !tier) return 0;
+  return aom_rtcd_get_binding(index, name, tier);
+}
+
 const char *aom_codec_iface_name(aom_codec_iface_t *iface) {
   return iface ? iface->name : "<invalid interface>";
 }
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <arm_neon.h>
+#include <assert.h>
+
+#include "config/aom_config.h"
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom/aom_integer.h"
+#include "aom_dsp/aom_dsp_common.h"
+#include "av1/common/arm/transpose_neon.h"
+
+// One pass of the 8 point Hadamard transform on 8 vectors, with the outputs in
+// the same order as hadamard_col8() in aom_dsp/avg.c.
+static INLINE void hadamard8x8_one_pass(int16x8_t *a0, int16x8_t *a1,
+                                        int16x8_t *a2, int16x8_t *a3,
+                                        int16x8_t *a4, int16x8_t *a5,
+                                        int16x8_t *a6, int16x8_t *a7) {
+  const int16x8_t b0 = vaddq_s16(*a0, *a1);
+  const int16x8_t b1 = vsubq_s16(*a0, *a1);
+  const int16x8_t b2 = vaddq_s16(*a2, *a3);
+  const int16x8_t b3 = vsubq_s16(*a2, *a3);
+  const int16x8_t b4 = vaddq_s16(*a4, *a5);
+  const int16x8_t b5 = vsubq_s16(*a4, *a5);
+  const int16x8_t b6 = vaddq_s16(*a6, *a7);
+  const int16x8_t b7 = vsubq_s16(*a6, *a7);
+
+  const int16x8_t c0 = vaddq_s16(b0, b2);
+  const int16x8_t c1 = vaddq_s16(b1, b3);
+  const int16x8_t c2 = vsubq_s16(b0, b2);
+  const int16x8_t c3 = vsubq_s16(b1, b3);
+  const int16x8_t c4 = vaddq_s16(b4, b6);
+  const int16x8_t c5 = vaddq_s16(b5, b7);
+  const int16x8_t c6 = vsubq_s16(b4, b6);
+  const int16x8_t c7 = vsubq_s16(b5, b7);
+
+  *a0 = vaddq_s16(c0, c4);
+  *a1 = vsubq_s16(c2, c6);
+  *a2 = vsubq_s16(c0, c4);
+  *a3 = vaddq_s16(c2, c6);
+  *a4 = vaddq_s16(c3, c7);
+  *a5 = vsubq_s16(c3, c7);
+  *a6 = vsubq_s16(c1, c5);
+  *a7 = vaddq_s16(c1, c5);
+}
+
+static INLINE void store_s16_to_tran_low(tran_low_t *coeff, const int16x8_t a) {
+  vst1q_s32(coeff, vmovl_s16(vget_low_s16(a)));
+  vst1q_s32(coeff + 4, vmovl_s16(vget_high_s16(a)));
+}
+
+void aom_hadamard_8x8_neon(const int16_t *src_diff, ptrdiff_t src_stride,
+                           tran_low_t *coeff) {
+  int16x8_t a0 = vld1q_s16(src_diff);
+  int16x8_t a1 = vld1q_s16(src_diff + src_stride);
+  int16x8_t a2 = vld1q_s16(src_diff + 2 * src_stride);
+  int16x8_t a3 = vld1q_s16(src_diff + 3 * src_stride);
+  int16x8_t a4 = vld1q_s16(src_diff + 4 * src_stride);
+  int16x8_t a5 = vld1q_s16(src_diff + 5 * src_stride);
+  int16x8_t a6 = vld1q_s16(src_diff + 6 * src_stride);
+  int16x8_t a7 = vld1q_s16(src_diff + 7 * src_stride);
+
+  // Columns first, then rows. The transposes keep the coefficient order
+  // identical to the C version.
+  hadamard8x8_one_pass(&a0, &a1, &a2, &a3, &a4, &a5, &a6, &a7);
+  transpose_s16_8x8(&a0, &a1, &a2, &a3, &a4, &a5, &a6, &a7);
+  hadamard8x8_one_pass(&a0, &a1, &a2, &a3, &a4, &a5, &a6, &a7);
+  transpose_s16_8x8(&a0, &a1, &a2, &a3, &a4, &a5, &a6, &a7);
+
+  store_s16_to_tran_low(coeff + 0, a0);
+  store_s16_to_tran_low(coeff + 8, a1);
+  store_s16_to_tran_low(coeff + 16, a2);
+  store_s16_to_tran_low(coeff + 24, a3);
+  store_s16_to_tran_low(coeff + 32, a4);
+  store_s16_to_tran_low(coeff + 40, a5);
+  store_s16_to_tran_low(coeff + 48, a6);
+  store_s16_to_tran_low(coeff + 56, a7);
+}
+
+void aom_hadamard_16x16_neon(const int16_t *src_diff, ptrdiff_t src_stride,
+                             tran_low_t *coeff) {
+  int i;
+
+  // Top left first.
+  aom_hadamard_8x8_neon(src_diff, src_stride, coeff);
+  // Top right.
+  aom_hadamard_8x8_neon(src_diff + 8, src_stride, coeff + 64);
+  // Bottom left.
+  aom_hadamard_8x8_neon(src_diff + 8 * src_stride, src_stride, coeff + 128);
+  // Bottom right.
+  aom_hadamard_8x8_neon(src_diff + 8 * src_stride + 8, src_stride, coeff + 192);
+
+  for (i = 0; i < 64; i += 4) {
+    const int32x4_t a0 = vld1q_s32(coeff + i);
+    const int32x4_t a1 = vld1q_s32(coeff + i + 64);
+    const int32x4_t a2 = vld1q_s32(coeff + i + 128);
+    const int32x4_t a3 = vld1q_s32(coeff + i + 192);
+
+    // Halving adds are (a + b) >> 1, matching the C version.
+    const int32x4_t b0 = vhaddq_s32(a0, a1);
+    const int32x4_t b1 = vhsubq_s32(a0, a1);
+    const int32x4_t b2 = vhaddq_s32(a2, a3);
+    const int32x4_t b3 = vhsubq_s32(a2, a3);
+
+    vst1q_s32(coeff + i, vaddq_s32(b0, b2));
+    vst1q_s32(coeff + i + 64, vaddq_s32(b1, b3));
+    vst1q_s32(coeff + i + 128, vsubq_s32(b0, b2));
+    vst1q_s32(coeff + i + 192, vsubq_s32(b1, b3));
+  }
+}
+
+int aom_satd_neon(const tran_low_t *coeff, int length) {
+  int i;
+  int32x4_t sum = vdupq_n_s32(0);
+
+  assert(length % 4 == 0);
+  // coeff: 16 bits, so the 32-bit lanes cannot overflow for length <= 1024.
+  for (i = 0; i < length; i += 4) {
+    sum = vaddq_s32(sum, vabsq_s32(vld1q_s32(coeff + i)));
+  }
+
+  {
+    const int64x2_t sum_64 = vpaddlq_s32(sum);
+    return (int)(vgetq_lane_s64(sum_64, 0) + vgetq_lane_s64(sum_64, 1));
+  }
+}
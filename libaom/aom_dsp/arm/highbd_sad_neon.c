@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <arm_neon.h>
+
+#include "config/aom_config.h"
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom/aom_integer.h"
+#include "aom_dsp/aom_dsp_common.h"
+
+static INLINE unsigned int horizontal_add_u32x4(const uint32x4_t sum) {
+  const uint64x2_t b = vpaddlq_u32(sum);
+  return (unsigned int)(vgetq_lane_u64(b, 0) + vgetq_lane_u64(b, 1));
+}
+
+// Adds the absolute differences of one row of 'w' pixels to 'sum'. The 32-bit
+// lanes hold at most 128 * 128 / 4 differences of 12-bit pixels.
+static INLINE uint32x4_t highbd_sad_row(const uint16_t *src,
+                                        const uint16_t *ref, int w,
+                                        uint32x4_t sum) {
+  if (w == 4) return vaddw_u16(sum, vabd_u16(vld1_u16(src), vld1_u16(ref)));
+  for (int j = 0; j < w; j += 8) {
+    sum = vpadalq_u16(sum, vabdq_u16(vld1q_u16(src + j), vld1q_u16(ref + j)));
+  }
+  return sum;
+}
+
+static INLINE unsigned int highbd_sad_neon(const uint16_t *src, int src_stride,
+                                           const uint16_t *ref, int ref_stride,
+                                           int w, int h) {
+  uint32x4_t sum = vdupq_n_u32(0);
+  for (int i = 0; i < h; ++i) {
+    sum = highbd_sad_row(src, ref, w, sum);
+    src += src_stride;
+    ref += ref_stride;
+  }
+  return horizontal_add_u32x4(sum);
+}
+
+static INLINE void highbd_sad4d_neon(const uint16_t *src, int src_stride,
+                                     const uint8_t *const ref8[],
+                                     int ref_stride, int w, int h,
+                                     uint32_t *res) {
+  const uint16_t *ref[4];
+  uint32x4_t sum[4];
+  for (int k = 0; k < 4; ++k) {
+    ref[k] = CONVERT_TO_SHORTPTR(ref8[k]);
+    sum[k] = vdupq_n_u32(0);
+  }
+  for (int i = 0; i < h; ++i) {
+    for (int k = 0; k < 4; ++k) {
+      sum[k] = highbd_sad_row(src, ref[k], w, sum[k]);
+      ref[k] += ref_stride;
+    }
+    src += src_stride;
+  }
+  for (int k = 0; k < 4; ++k) res[k] = horizontal_add_u32x4(sum[k]);
+}
+
+#define HIGHBD_SAD_WXH_NEON(w, h)                                              \
+  unsigned int aom_highbd_sad##w##x##h##_neon(                                 \
+      const uint8_t *src, int src_stride, const uint8_t *ref,                  \
+      int ref_stride) {                                                        \
+    return highbd_sad_neon(CONVERT_TO_SHORTPTR(src), src_stride,               \
+                           CONVERT_TO_SHORTPTR(ref), ref_stride, w, h);        \
+  }                                                                            \
+                                                                               \
+  void aom_highbd_sad##w##x##h##x4d_neon(                                      \
+      const uint8_t *src, int src_stride, const uint8_t *const ref[],          \
+      int ref_stride, uint32_t *res) {                                         \
+    highbd_sad4d_neon(CONVERT_TO_SHORTPTR(src), src_stride, ref, ref_stride,   \
+                      w, h, res);                                              \
+  }
+
+HIGHBD_SAD_WXH_NEON(128, 128)
+HIGHBD_SAD_WXH_NEON(128, 64)
+HIGHBD_SAD_WXH_NEON(64, 128)
+HIGHBD_SAD_WXH_NEON(64, 64)
+HIGHBD_SAD_WXH_NEON(64, 32)
+HIGHBD_SAD_WXH_NEON(32, 64)
+HIGHBD_SAD_WXH_NEON(32, 32)
+HIGHBD_SAD_WXH_NEON(32, 16)
+HIGHBD_SAD_WXH_NEON(16, 32)
+HIGHBD_SAD_WXH_NEON(16, 16)
+HIGHBD_SAD_WXH_NEON(16, 8)
+HIGHBD_SAD_WXH_NEON(8, 16)
+HIGHBD_SAD_WXH_NEON(8, 8)
+HIGHBD_SAD_WXH_NEON(8, 4)
+HIGHBD_SAD_WXH_NEON(4, 8)
+HIGHBD_SAD_WXH_NEON(4, 4)
+HIGHBD_SAD_WXH_NEON(4, 16)
+HIGHBD_SAD_WXH_NEON(16, 4)
+HIGHBD_SAD_WXH_NEON(8, 32)
+HIGHBD_SAD_WXH_NEON(32, 8)
+HIGHBD_SAD_WXH_NEON(16, 64)
+HIGHBD_SAD_WXH_NEON(64, 16)
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <arm_neon.h>
+
+#include "config/aom_config.h"
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom/aom_integer.h"
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_dsp/aom_filter.h"
+
+// The differences of 12-bit pixels fit in int16 and their squares in int32.
+// The squares of one row are summed in 32 bits (at most 128 * 4095^2 / 4 per
+// lane) before being widened into the 64-bit total.
+static INLINE void highbd_variance_neon(const uint16_t *a, int a_stride,
+                                        const uint16_t *b, int b_stride, int w,
+                                        int h, uint64_t *sse, int64_t *sum) {
+  int32x4_t sum_s32 = vdupq_n_s32(0);
+  uint64x2_t sse_u64 = vdupq_n_u64(0);
+
+  for (int i = 0; i < h; ++i) {
+    int32x4_t sse_s32;
+    if (w == 4) {
+      const int16x4_t diff =
+          vreinterpret_s16_u16(vsub_u16(vld1_u16(a), vld1_u16(b)));
+      sum_s32 = vaddw_s16(sum_s32, diff);
+      sse_s32 = vmull_s16(diff, diff);
+    } else {
+      sse_s32 = vdupq_n_s32(0);
+      for (int j = 0; j < w; j += 8) {
+        const int16x8_t diff = vreinterpretq_s16_u16(
+            vsubq_u16(vld1q_u16(a + j), vld1q_u16(b + j)));
+        sum_s32 = vpadalq_s16(sum_s32, diff);
+        sse_s32 = vmlal_s16(sse_s32, vget_low_s16(diff), vget_low_s16(diff));
+        sse_s32 = vmlal_s16(sse_s32, vget_high_s16(diff), vget_high_s16(diff));
+      }
+    }
+    sse_u64 = vpadalq_u32(sse_u64, vreinterpretq_u32_s32(sse_s32));
+    a += a_stride;
+    b += b_stride;
+  }
+
+  const int64x2_t sum_s64 = vpaddlq_s32(sum_s32);
+  *sum = vgetq_lane_s64(sum_s64, 0) + vgetq_lane_s64(sum_s64, 1);
+  *sse = vgetq_lane_u64(sse_u64, 0) + vgetq_lane_u64(sse_u64, 1);
+}
+
+// Matches the rounding of highbd_{8,10,12}_variance() and the HIGHBD_VAR
+// wrappers in aom_dsp/variance.c.
+static INLINE uint32_t highbd_variance_bd(const uint8_t *a8, int a_stride,
+                                          const uint8_t *b8, int b_stride,
+                                          int w, int h, int bd,
+                                          uint32_t *sse) {
+  uint64_t sse_long;
+  int64_t sum_long;
+  int sum;
+  highbd_variance_neon(CONVERT_TO_SHORTPTR(a8), a_stride,
+                       CONVERT_TO_SHORTPTR(b8), b_stride, w, h, &sse_long,
+                       &sum_long);
+  if (bd == 8) {
+    *sse = (uint32_t)sse_long;
+    sum = (int)sum_long;
+    return *sse - (uint32_t)(((int64_t)sum * sum) / (w * h));
+  }
+  *sse = (uint32_t)ROUND_POWER_OF_TWO(sse_long, 2 * (bd - 8));
+  sum = (int)ROUND_POWER_OF_TWO(sum_long, bd - 8);
+  const int64_t var = (int64_t)(*sse) - (((int64_t)sum * sum) / (w * h));
+  return (var >= 0) ? (uint32_t)var : 0;
+}
+
+// One pass of the 2-tap bilinear filter of
+// aom_highbd_var_filter_block2d_bil_{first,second}_pass(). 12-bit pixels times
+// the filter taps need 32 bits before the rounding shift.
+static void highbd_var_filter_block2d_bil(const uint16_t *src_ptr,
+                                          uint16_t *output_ptr,
+                                          int src_pixels_per_line,
+                                          int pixel_step, int output_height,
+                                          int output_width,
+                                          const uint8_t *filter) {
+  const uint16x4_t f0 = vdup_n_u16(filter[0]);
+  const uint16x4_t f1 = vdup_n_u16(filter[1]);
+
+  for (int i = 0; i < output_height; ++i) {
+    if (output_width == 4) {
+      const uint32x4_t sum = vmlal_u16(vmull_u16(vld1_u16(src_ptr), f0),
+                                       vld1_u16(src_ptr + pixel_step), f1);
+      vst1_u16(output_ptr, vrshrn_n_u32(sum, FILTER_BITS));
+    } else {
+      for (int j = 0; j < output_width; j += 8) {
+        const uint16x8_t s0 = vld1q_u16(src_ptr + j);
+        const uint16x8_t s1 = vld1q_u16(src_ptr + j + pixel_step);
+        const uint32x4_t lo = vmlal_u16(vmull_u16(vget_low_u16(s0), f0),
+                                        vget_low_u16(s1), f1);
+        const uint32x4_t hi = vmlal_u16(vmull_u16(vget_high_u16(s0), f0),
+                                        vget_high_u16(s1), f1);
+        vst1q_u16(output_ptr + j, vcombine_u16(vrshrn_n_u32(lo, FILTER_BITS),
+                                               vrshrn_n_u32(hi, FILTER_BITS)));
+      }
+    }
+    src_ptr += src_pixels_per_line;
+    output_ptr += output_width;
+  }
+}
+
+#define HIGHBD_VARIANCE_WXH_NEON(bd, w, h)                                    \
+  uint32_t aom_highbd_##bd##_variance##w##x##h##_neon(                        \
+      const uint8_t *a, int a_stride, const uint8_t *b, int b_stride,         \
+      uint32_t *sse) {                                                        \
+    return highbd_variance_bd(a, a_stride, b, b_stride, w, h, bd, sse);       \
+  }                                                                           \
+                                                                              \
+  uint32_t aom_highbd_##bd##_sub_pixel_variance##w##x##h##_neon(              \
+      const uint8_t *src, int src_stride, int xoffset, int yoffset,           \
+      const uint8_t *dst, int dst_stride, uint32_t *sse) {                    \
+    uint16_t fdata3[(h + 1) * w];                                             \
+    uint16_t temp2[h * w];                                                    \
+                                                                              \
+    highbd_var_filter_block2d_bil(CONVERT_TO_SHORTPTR(src), fdata3,           \
+                                  src_stride, 1, h + 1, w,                    \
+                                  bilinear_filters_2t[xoffset]);              \
+    highbd_var_filter_block2d_bil(fdata3, temp2, w, w, h, w,                  \
+                                  bilinear_filters_2t[yoffset]);              \
+    return highbd_variance_bd(CONVERT_TO_BYTEPTR(temp2), w, dst, dst_stride,  \
+                              w, h, bd, sse);                                 \
+  }
+
+#define HIGHBD_VARIANCES_NEON(w, h)  \
+  HIGHBD_VARIANCE_WXH_NEON(8, w, h)  \
+  HIGHBD_VARIANCE_WXH_NEON(10, w, h) \
+  HIGHBD_VARIANCE_WXH_NEON(12, w, h)
+
+HIGHBD_VARIANCES_NEON(128, 128)
+HIGHBD_VARIANCES_NEON(128, 64)
+HIGHBD_VARIANCES_NEON(64, 128)
+HIGHBD_VARIANCES_NEON(64, 64)
+HIGHBD_VARIANCES_NEON(64, 32)
+HIGHBD_VARIANCES_NEON(32, 64)
+HIGHBD_VARIANCES_NEON(32, 32)
+HIGHBD_VARIANCES_NEON(32, 16)
+HIGHBD_VARIANCES_NEON(16, 32)
+HIGHBD_VARIANCES_NEON(16, 16)
+HIGHBD_VARIANCES_NEON(16, 8)
+HIGHBD_VARIANCES_NEON(8, 16)
+HIGHBD_VARIANCES_NEON(8, 8)
+HIGHBD_VARIANCES_NEON(8, 4)
+HIGHBD_VARIANCES_NEON(4, 8)
+HIGHBD_VARIANCES_NEON(4, 4)
+HIGHBD_VARIANCES_NEON(4, 16)
+HIGHBD_VARIANCES_NEON(16, 4)
+HIGHBD_VARIANCES_NEON(8, 32)
+HIGHBD_VARIANCES_NEON(32, 8)
+HIGHBD_VARIANCES_NEON(16, 64)
+HIGHBD_VARIANCES_NEON(64, 16)
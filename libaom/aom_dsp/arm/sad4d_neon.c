@@ -15,6 +15,8 @@
 #include "config/aom_dsp_rtcd.h"
 
 #include "aom/aom_integer.h"
+#include "aom_dsp/aom_dsp_common.h"
+#include "av1/common/arm/mem_neon.h"
 
 static INLINE unsigned int horizontal_long_add_16x8(const uint16x8_t vec_lo,
                                                     const uint16x8_t vec_hi) {
@@ -224,3 +226,111 @@ void aom_sad16x16x4d_neon(const uint8_t *src, int src_stride,
   res[2] = horizontal_long_add_16x8(vec_sum_ref2_lo, vec_sum_ref2_hi);
   res[3] = horizontal_long_add_16x8(vec_sum_ref3_lo, vec_sum_ref3_hi);
 }
+
+static INLINE uint32_t horizontal_add_u32x4(const uint32x4_t a) {
+  const uint64x2_t b = vpaddlq_u32(a);
+  const uint32x2_t c = vadd_u32(vreinterpret_u32_u64(vget_low_u64(b)),
+                                vreinterpret_u32_u64(vget_high_u64(b)));
+  return vget_lane_u32(c, 0);
+}
+
+// Accumulate the absolute differences of one row of w pixels, w a multiple of
+// 8, into the 16-bit lanes of sum.
+static INLINE uint16x8_t sad_row_neon(const uint8_t *src, const uint8_t *ref,
+                                      int w, uint16x8_t sum) {
+  int j;
+  if (w == 8) return vabal_u8(sum, vld1_u8(src), vld1_u8(ref));
+  for (j = 0; j < w; j += 16) {
+    const uint8x16_t vec_src = vld1q_u8(src + j);
+    const uint8x16_t vec_ref = vld1q_u8(ref + j);
+    sum = vabal_u8(sum, vget_low_u8(vec_src), vget_low_u8(vec_ref));
+    sum = vabal_u8(sum, vget_high_u8(vec_src), vget_high_u8(vec_ref));
+  }
+  return sum;
+}
+
+static INLINE void sad_x4d_neon(const uint8_t *src, int src_stride,
+                                const uint8_t *const ref[4], int ref_stride,
+                                uint32_t *res, int w, int h) {
+  // Each 16-bit lane gathers w / 8 differences of up to 255 per row; widen to
+  // 32 bits before that can overflow.
+  const int rows_per_flush = AOMMIN(h, 2048 / w);
+  uint32x4_t vec_sum[4] = { vdupq_n_u32(0), vdupq_n_u32(0), vdupq_n_u32(0),
+                            vdupq_n_u32(0) };
+  int i = 0, k;
+
+  while (i < h) {
+    const int rows_end = AOMMIN(h, i + rows_per_flush);
+    uint16x8_t vec_acc[4] = { vdupq_n_u16(0), vdupq_n_u16(0), vdupq_n_u16(0),
+                              vdupq_n_u16(0) };
+    for (; i < rows_end; ++i) {
+      const uint8_t *const src_row = src + i * src_stride;
+      for (k = 0; k < 4; ++k) {
+        vec_acc[k] =
+            sad_row_neon(src_row, ref[k] + i * ref_stride, w, vec_acc[k]);
+      }
+    }
+    for (k = 0; k < 4; ++k) vec_sum[k] = vpadalq_u16(vec_sum[k], vec_acc[k]);
+  }
+
+  for (k = 0; k < 4; ++k) res[k] = horizontal_add_u32x4(vec_sum[k]);
+}
+
+// 4 wide blocks process two rows per iteration. h is at most 16, so the
+// 16-bit lanes cannot overflow.
+static INLINE void sad4xh_x4d_neon(const uint8_t *src, int src_stride,
+                                   const uint8_t *const ref[4], int ref_stride,
+                                   uint32_t *res, int h) {
+  uint16x8_t vec_sum[4] = { vdupq_n_u16(0), vdupq_n_u16(0), vdupq_n_u16(0),
+                            vdupq_n_u16(0) };
+  uint32x2_t vec_src = vdup_n_u32(0);
+  uint32x2_t vec_ref = vdup_n_u32(0);
+  int i, k;
+
+  for (i = 0; i < h; i += 2) {
+    load_unaligned_u8_4x2(src + i * src_stride, src_stride, &vec_src);
+    for (k = 0; k < 4; ++k) {
+      load_unaligned_u8_4x2(ref[k] + i * ref_stride, ref_stride, &vec_ref);
+      vec_sum[k] = vabal_u8(vec_sum[k], vreinterpret_u8_u32(vec_src),
+                            vreinterpret_u8_u32(vec_ref));
+    }
+  }
+
+  for (k = 0; k < 4; ++k) {
+    res[k] = horizontal_add_u32x4(vpaddlq_u16(vec_sum[k]));
+  }
+}
+
+#define SAD_X4D_NEON(w, h)                                            \
+  void aom_sad##w##x##h##x4d_neon(const uint8_t *src, int src_stride, \
+                                  const uint8_t *const ref[4],        \
+                                  int ref_stride, uint32_t *res) {    \
+    sad_x4d_neon(src, src_stride, ref, ref_stride, res, w, h);        \
+  }
+
+#define SAD4_X4D_NEON(h)                                                   \
+  void aom_sad4x##h##x4d_neon(const uint8_t *src, int src_stride,          \
+                              const uint8_t *const ref[4], int ref_stride, \
+                              uint32_t *res) {                             \
+    sad4xh_x4d_neon(src, src_stride, ref, ref_stride, res, h);             \
+  }
+
+SAD_X4D_NEON(128, 128)
+SAD_X4D_NEON(128, 64)
+SAD_X4D_NEON(64, 128)
+SAD_X4D_NEON(64, 32)
+SAD_X4D_NEON(32, 64)
+SAD_X4D_NEON(32, 16)
+SAD_X4D_NEON(16, 32)
+SAD_X4D_NEON(16, 8)
+SAD_X4D_NEON(8, 16)
+SAD_X4D_NEON(8, 8)
+SAD_X4D_NEON(8, 4)
+SAD_X4D_NEON(16, 4)
+SAD_X4D_NEON(8, 32)
+SAD_X4D_NEON(32, 8)
+SAD_X4D_NEON(16, 64)
+SAD_X4D_NEON(64, 16)
+SAD4_X4D_NEON(4)
+SAD4_X4D_NEON(8)
+SAD4_X4D_NEON(16)
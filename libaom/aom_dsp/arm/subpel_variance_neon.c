@@ -19,6 +19,39 @@
 
 #include "aom_dsp/aom_filter.h"
 #include "aom_dsp/variance.h"
+#include "av1/common/arm/mem_neon.h"
+
+// Filters two rows at a time. The output rows are packed, 4 bytes apart.
+static void var_filter_block2d_bil_w4(const uint8_t *src_ptr,
+                                      uint8_t *output_ptr,
+                                      unsigned int src_pixels_per_line,
+                                      int pixel_step,
+                                      unsigned int output_height,
+                                      unsigned int output_width,
+                                      const uint8_t *filter) {
+  const uint8x8_t f0 = vmov_n_u8(filter[0]);
+  const uint8x8_t f1 = vmov_n_u8(filter[1]);
+  uint32x2_t src_0 = vdup_n_u32(0);
+  uint32x2_t src_1 = vdup_n_u32(0);
+  unsigned int i;
+  (void)output_width;
+  for (i = 0; i + 1 < output_height; i += 2) {
+    load_unaligned_u8_4x2(src_ptr, src_pixels_per_line, &src_0);
+    load_unaligned_u8_4x2(src_ptr + pixel_step, src_pixels_per_line, &src_1);
+    const uint16x8_t a = vmull_u8(vreinterpret_u8_u32(src_0), f0);
+    const uint16x8_t b = vmlal_u8(a, vreinterpret_u8_u32(src_1), f1);
+    vst1_u8(output_ptr, vrshrn_n_u16(b, FILTER_BITS));
+    src_ptr += 2 * src_pixels_per_line;
+    output_ptr += 8;
+  }
+  if (i < output_height) {
+    load_unaligned_u8_4x1(src_ptr, src_pixels_per_line, &src_0);
+    load_unaligned_u8_4x1(src_ptr + pixel_step, src_pixels_per_line, &src_1);
+    const uint16x8_t a = vmull_u8(vreinterpret_u8_u32(src_0), f0);
+    const uint16x8_t b = vmlal_u8(a, vreinterpret_u8_u32(src_1), f1);
+    store_unaligned_u8_4x1(output_ptr, vrshrn_n_u16(b, FILTER_BITS), 0);
+  }
+}
 
 static void var_filter_block2d_bil_w8(const uint8_t *src_ptr,
                                       uint8_t *output_ptr,
@@ -129,3 +162,36 @@ unsigned int aom_sub_pixel_variance64x64_neon(const uint8_t *src,
                              bilinear_filters_2t[yoffset]);
   return aom_variance64x64_neon(temp2, 64, dst, dst_stride, sse);
 }
+
+#define SUBPEL_VARIANCE_WXH_NEON(w, h, filter_w)                               \
+  unsigned int aom_sub_pixel_variance##w##x##h##_neon(                         \
+      const uint8_t *src, int src_stride, int xoffset, int yoffset,            \
+      const uint8_t *dst, int dst_stride, unsigned int *sse) {                 \
+    DECLARE_ALIGNED(16, uint8_t, temp2[h * w]);                                \
+    DECLARE_ALIGNED(16, uint8_t, fdata3[(h + 1) * w]);                         \
+                                                                               \
+    var_filter_block2d_bil_##filter_w(src, fdata3, src_stride, 1, h + 1, w,   \
+                                      bilinear_filters_2t[xoffset]);           \
+    var_filter_block2d_bil_##filter_w(fdata3, temp2, w, w, h, w,              \
+                                      bilinear_filters_2t[yoffset]);           \
+    return aom_variance##w##x##h##_neon(temp2, w, dst, dst_stride, sse);      \
+  }
+
+SUBPEL_VARIANCE_WXH_NEON(128, 128, w16)
+SUBPEL_VARIANCE_WXH_NEON(128, 64, w16)
+SUBPEL_VARIANCE_WXH_NEON(64, 128, w16)
+SUBPEL_VARIANCE_WXH_NEON(64, 32, w16)
+SUBPEL_VARIANCE_WXH_NEON(32, 64, w16)
+SUBPEL_VARIANCE_WXH_NEON(32, 16, w16)
+SUBPEL_VARIANCE_WXH_NEON(16, 32, w16)
+SUBPEL_VARIANCE_WXH_NEON(16, 8, w16)
+SUBPEL_VARIANCE_WXH_NEON(8, 16, w8)
+SUBPEL_VARIANCE_WXH_NEON(8, 4, w8)
+SUBPEL_VARIANCE_WXH_NEON(4, 8, w4)
+SUBPEL_VARIANCE_WXH_NEON(4, 4, w4)
+SUBPEL_VARIANCE_WXH_NEON(4, 16, w4)
+SUBPEL_VARIANCE_WXH_NEON(16, 4, w16)
+SUBPEL_VARIANCE_WXH_NEON(8, 32, w8)
+SUBPEL_VARIANCE_WXH_NEON(32, 8, w16)
+SUBPEL_VARIANCE_WXH_NEON(16, 64, w16)
+SUBPEL_VARIANCE_WXH_NEON(64, 16, w16)
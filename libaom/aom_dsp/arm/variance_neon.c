@@ -15,7 +15,9 @@
 #include "config/aom_config.h"
 
 #include "aom/aom_integer.h"
+#include "aom_dsp/aom_dsp_common.h"
 #include "aom_ports/mem.h"
+#include "av1/common/arm/mem_neon.h"
 
 static INLINE int horizontal_add_s16x8(const int16x8_t v_16x8) {
   const int32x4_t a = vpaddlq_s16(v_16x8);
@@ -61,6 +63,49 @@ static void variance_neon_w8(const uint8_t *a, int a_stride, const uint8_t *b,
   *sse = (unsigned int)horizontal_add_s32x4(vaddq_s32(v_sse_lo, v_sse_hi));
 }
 
+static void variance_neon_w4(const uint8_t *a, int a_stride, const uint8_t *b,
+                             int b_stride, int h, uint32_t *sse, int *sum) {
+  int16x8_t v_sum = vdupq_n_s16(0);
+  int32x4_t v_sse_lo = vdupq_n_s32(0);
+  int32x4_t v_sse_hi = vdupq_n_s32(0);
+  uint32x2_t v_a = vdup_n_u32(0);
+  uint32x2_t v_b = vdup_n_u32(0);
+
+  for (int i = 0; i < h; i += 2) {
+    load_unaligned_u8_4x2(a, a_stride, &v_a);
+    load_unaligned_u8_4x2(b, b_stride, &v_b);
+    const int16x8_t sv_diff = vreinterpretq_s16_u16(
+        vsubl_u8(vreinterpret_u8_u32(v_a), vreinterpret_u8_u32(v_b)));
+    v_sum = vaddq_s16(v_sum, sv_diff);
+    v_sse_lo =
+        vmlal_s16(v_sse_lo, vget_low_s16(sv_diff), vget_low_s16(sv_diff));
+    v_sse_hi =
+        vmlal_s16(v_sse_hi, vget_high_s16(sv_diff), vget_high_s16(sv_diff));
+    a += 2 * a_stride;
+    b += 2 * b_stride;
+  }
+
+  *sum = horizontal_add_s16x8(v_sum);
+  *sse = (unsigned int)horizontal_add_s32x4(vaddq_s32(v_sse_lo, v_sse_hi));
+}
+
+// Splits the block into blocks of at most 1024 pixels for variance_neon_w8().
+static void variance_neon_wxh(const uint8_t *a, int a_stride, const uint8_t *b,
+                              int b_stride, int w, int h, uint32_t *sse,
+                              int *sum) {
+  const int block_h = AOMMIN(h, 1024 / w);
+  *sse = 0;
+  *sum = 0;
+  for (int i = 0; i < h; i += block_h) {
+    uint32_t block_sse;
+    int block_sum;
+    variance_neon_w8(a + i * a_stride, a_stride, b + i * b_stride, b_stride, w,
+                     block_h, &block_sse, &block_sum);
+    *sse += block_sse;
+    *sum += block_sum;
+  }
+}
+
 void aom_get8x8var_neon(const uint8_t *a, int a_stride, const uint8_t *b,
                         int b_stride, unsigned int *sse, int *sum) {
   variance_neon_w8(a, a_stride, b, b_stride, 8, 8, sse, sum);
@@ -398,3 +443,30 @@ unsigned int aom_get4x4sse_cs_neon(const unsigned char *src_ptr,
 
   return vget_lane_u32(vreinterpret_u32_s64(d0s64), 0);
 }
+
+#define VARIANCE_WXH_NEON(w, h, shift)                                        \
+  unsigned int aom_variance##w##x##h##_neon(const uint8_t *a, int a_stride,   \
+                                            const uint8_t *b, int b_stride,   \
+                                            unsigned int *sse) {              \
+    int sum;                                                                  \
+    if (w == 4)                                                               \
+      variance_neon_w4(a, a_stride, b, b_stride, h, sse, &sum);               \
+    else                                                                      \
+      variance_neon_wxh(a, a_stride, b, b_stride, w, h, sse, &sum);           \
+    return *sse - (unsigned int)(((int64_t)sum * sum) >> shift);              \
+  }
+
+VARIANCE_WXH_NEON(128, 128, 14)
+VARIANCE_WXH_NEON(128, 64, 13)
+VARIANCE_WXH_NEON(64, 128, 13)
+VARIANCE_WXH_NEON(32, 16, 9)
+VARIANCE_WXH_NEON(16, 32, 9)
+VARIANCE_WXH_NEON(8, 4, 5)
+VARIANCE_WXH_NEON(4, 8, 5)
+VARIANCE_WXH_NEON(4, 4, 4)
+VARIANCE_WXH_NEON(4, 16, 6)
+VARIANCE_WXH_NEON(16, 4, 6)
+VARIANCE_WXH_NEON(8, 32, 8)
+VARIANCE_WXH_NEON(32, 8, 8)
+VARIANCE_WXH_NEON(16, 64, 10)
+VARIANCE_WXH_NEON(64, 16, 10)
@@ -256,6 +256,43 @@ VARIANCES(32, 8)
 VARIANCES(16, 64)
 VARIANCES(64, 16)
 
+// Sub-pixel variance of 4 candidate positions against the same source block,
+// as used by the sub-pixel motion search.
+#define SUBPIX_VAR_X4D(W, H)                                             \
+  void aom_sub_pixel_variance##W##x##H##x4d_c(                           \
+      const uint8_t *const a[4], int a_stride, const int *xoffset,       \
+      const int *yoffset, const uint8_t *b, int b_stride, uint32_t *var, \
+      uint32_t *sse) {                                                   \
+    int i;                                                               \
+    for (i = 0; i < 4; ++i) {                                            \
+      var[i] = aom_sub_pixel_variance##W##x##H##_c(                      \
+          a[i], a_stride, xoffset[i], yoffset[i], b, b_stride, &sse[i]); \
+    }                                                                    \
+  }
+
+SUBPIX_VAR_X4D(128, 128)
+SUBPIX_VAR_X4D(128, 64)
+SUBPIX_VAR_X4D(64, 128)
+SUBPIX_VAR_X4D(64, 64)
+SUBPIX_VAR_X4D(64, 32)
+SUBPIX_VAR_X4D(32, 64)
+SUBPIX_VAR_X4D(32, 32)
+SUBPIX_VAR_X4D(32, 16)
+SUBPIX_VAR_X4D(16, 32)
+SUBPIX_VAR_X4D(16, 16)
+SUBPIX_VAR_X4D(16, 8)
+SUBPIX_VAR_X4D(8, 16)
+SUBPIX_VAR_X4D(8, 8)
+SUBPIX_VAR_X4D(8, 4)
+SUBPIX_VAR_X4D(4, 8)
+SUBPIX_VAR_X4D(4, 4)
+SUBPIX_VAR_X4D(4, 16)
+SUBPIX_VAR_X4D(16, 4)
+SUBPIX_VAR_X4D(8, 32)
+SUBPIX_VAR_X4D(32, 8)
+SUBPIX_VAR_X4D(16, 64)
+SUBPIX_VAR_X4D(64, 16)
+
 GET_VAR(16, 16)
 GET_VAR(8, 8)
 
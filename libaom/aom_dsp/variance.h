@@ -46,6 +46,11 @@ typedef unsigned int (*aom_subpixvariance_fn_t)(const uint8_t *a, int a_stride,
                                                 const uint8_t *b, int b_stride,
                                                 unsigned int *sse);
 
+typedef void (*aom_subpixvariance_x4d_fn_t)(
+    const uint8_t *const a[4], int a_stride, const int *xoffset,
+    const int *yoffset, const uint8_t *b, int b_stride, unsigned int *var,
+    unsigned int *sse);
+
 typedef unsigned int (*aom_subp_avg_variance_fn_t)(
     const uint8_t *a, int a_stride, int xoffset, int yoffset, const uint8_t *b,
     int b_stride, unsigned int *sse, const uint8_t *second_pred);
@@ -93,6 +98,7 @@ typedef struct aom_variance_vtable {
   aom_sad_avg_fn_t sdaf;
   aom_variance_fn_t vf;
   aom_subpixvariance_fn_t svf;
+  aom_subpixvariance_x4d_fn_t svfx4d;
   aom_subp_avg_variance_fn_t svaf;
   aom_sad_multi_d_fn_t sdx4df;
   aom_masked_sad_fn_t msdf;
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <emmintrin.h>  // SSE2
+
+#include "config/aom_config.h"
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom_dsp/aom_filter.h"
+
+static INLINE __m128i load8_8to16_sse2(const uint8_t *const p) {
+  const __m128i p0 = _mm_loadl_epi64((const __m128i *)p);
+  return _mm_unpacklo_epi8(p0, _mm_setzero_si128());
+}
+
+// Accumulate 4 32bit numbers in val to 1 32bit number
+static INLINE unsigned int add32x4_sse2(__m128i val) {
+  val = _mm_add_epi32(val, _mm_srli_si128(val, 8));
+  val = _mm_add_epi32(val, _mm_srli_si128(val, 4));
+  return _mm_cvtsi128_si32(val);
+}
+
+// 2-tap bilinear filter of 8 16-bit values, as in
+// aom_var_filter_block2d_bil_{first,second}_pass_c(). The taps sum to 128, so
+// the intermediate values fit in 16 bits.
+static INLINE __m128i bil_filter_8(const __m128i a, const __m128i b,
+                                   const __m128i f0, const __m128i f1) {
+  const __m128i round = _mm_set1_epi16(1 << (FILTER_BITS - 1));
+  const __m128i sum =
+      _mm_add_epi16(_mm_mullo_epi16(a, f0), _mm_mullo_epi16(b, f1));
+  return _mm_srli_epi16(_mm_add_epi16(sum, round), FILTER_BITS);
+}
+
+// Horizontally filter 8 pixels of one row.
+static INLINE __m128i bil_first_pass_8(const uint8_t *a, const __m128i f0,
+                                       const __m128i f1) {
+  return bil_filter_8(load8_8to16_sse2(a), load8_8to16_sse2(a + 1), f0, f1);
+}
+
+// Evaluate 4 candidates against the source block b, one column of 8 pixels
+// at a time. Each source row is loaded once and shared by the 4 candidates,
+// and each filtered candidate row is reused by the vertical pass of the next
+// row.
+static INLINE void sub_pixel_variance_x4d_sse2(
+    const uint8_t *const a[4], int a_stride, const int *xoffset,
+    const int *yoffset, const uint8_t *b, int b_stride, int w, int h,
+    uint32_t *var, uint32_t *sse) {
+  const __m128i one = _mm_set1_epi16(1);
+  __m128i hf0[4], hf1[4], vf0[4], vf1[4];
+  __m128i vsse[4], vsum[4];
+  int i, j, k;
+
+  assert(w % 8 == 0);
+  for (k = 0; k < 4; ++k) {
+    hf0[k] = _mm_set1_epi16(bilinear_filters_2t[xoffset[k]][0]);
+    hf1[k] = _mm_set1_epi16(bilinear_filters_2t[xoffset[k]][1]);
+    vf0[k] = _mm_set1_epi16(bilinear_filters_2t[yoffset[k]][0]);
+    vf1[k] = _mm_set1_epi16(bilinear_filters_2t[yoffset[k]][1]);
+    vsse[k] = _mm_setzero_si128();
+    vsum[k] = _mm_setzero_si128();
+  }
+
+  for (j = 0; j < w; j += 8) {
+    __m128i prev[4];
+    for (k = 0; k < 4; ++k) {
+      prev[k] = bil_first_pass_8(a[k] + j, hf0[k], hf1[k]);
+    }
+    for (i = 0; i < h; ++i) {
+      const __m128i src = load8_8to16_sse2(b + i * b_stride + j);
+      for (k = 0; k < 4; ++k) {
+        const __m128i cur =
+            bil_first_pass_8(a[k] + (i + 1) * a_stride + j, hf0[k], hf1[k]);
+        const __m128i pred = bil_filter_8(prev[k], cur, vf0[k], vf1[k]);
+        const __m128i diff = _mm_sub_epi16(pred, src);
+        vsse[k] = _mm_add_epi32(vsse[k], _mm_madd_epi16(diff, diff));
+        vsum[k] = _mm_add_epi32(vsum[k], _mm_madd_epi16(diff, one));
+        prev[k] = cur;
+      }
+    }
+  }
+
+  for (k = 0; k < 4; ++k) {
+    const int sum = (int)add32x4_sse2(vsum[k]);
+    sse[k] = add32x4_sse2(vsse[k]);
+    var[k] = sse[k] - (uint32_t)(((int64_t)sum * sum) / (w * h));
+  }
+}
+
+#define SUBPIX_VAR_X4D_SSE2(w, h)                                              \
+  void aom_sub_pixel_variance##w##x##h##x4d_sse2(                              \
+      const uint8_t *const a[4], int a_stride, const int *xoffset,             \
+      const int *yoffset, const uint8_t *b, int b_stride, uint32_t *var,       \
+      uint32_t *sse) {                                                         \
+    sub_pixel_variance_x4d_sse2(a, a_stride, xoffset, yoffset, b, b_stride, w, \
+                                h, var, sse);                                  \
+  }
+
+SUBPIX_VAR_X4D_SSE2(128, 128)
+SUBPIX_VAR_X4D_SSE2(128, 64)
+SUBPIX_VAR_X4D_SSE2(64, 128)
+SUBPIX_VAR_X4D_SSE2(64, 64)
+SUBPIX_VAR_X4D_SSE2(64, 32)
+SUBPIX_VAR_X4D_SSE2(32, 64)
+SUBPIX_VAR_X4D_SSE2(32, 32)
+SUBPIX_VAR_X4D_SSE2(32, 16)
+SUBPIX_VAR_X4D_SSE2(16, 32)
+SUBPIX_VAR_X4D_SSE2(16, 16)
+SUBPIX_VAR_X4D_SSE2(16, 8)
+SUBPIX_VAR_X4D_SSE2(8, 16)
+SUBPIX_VAR_X4D_SSE2(8, 8)
+SUBPIX_VAR_X4D_SSE2(8, 4)
+SUBPIX_VAR_X4D_SSE2(16, 4)
+SUBPIX_VAR_X4D_SSE2(8, 32)
+SUBPIX_VAR_X4D_SSE2(32, 8)
+SUBPIX_VAR_X4D_SSE2(16, 64)
+SUBPIX_VAR_X4D_SSE2(64, 16)
@@ -15,6 +15,7 @@ set(AOM_AOM_PORTS_AOM_PORTS_CMAKE_ 1)
 
 list(APPEND AOM_PORTS_INCLUDES
             "${AOM_ROOT}/aom_ports/aom_once.h"
+            "${AOM_ROOT}/aom_ports/aom_rtcd.h"
             "${AOM_ROOT}/aom_ports/aom_timer.h"
             "${AOM_ROOT}/aom_ports/bitops.h"
             "${AOM_ROOT}/aom_ports/emmintrin_compat.h"
@@ -25,6 +26,9 @@ list(APPEND AOM_PORTS_INCLUDES
             "${AOM_ROOT}/aom_ports/sanitizer.h"
             "${AOM_ROOT}/aom_ports/system_state.h")
 
+list(APPEND AOM_PORTS_SOURCES "${AOM_ROOT}/aom_ports/aom_rtcd.c"
+            "${AOM_ROOT}/aom_ports/aom_timer.c")
+
 list(APPEND AOM_PORTS_ASM_X86 "${AOM_ROOT}/aom_ports/emms.asm")
 
 list(APPEND AOM_PORTS_INCLUDES_X86 "${AOM_ROOT}/aom_ports/x86_abi_support.asm")
@@ -46,8 +50,11 @@ list(APPEND AOM_PORTS_SOURCES_PPC "${AOM_ROOT}/aom_ports/ppc.h"
 #
 # For all target platforms:
 #
+# * Adds the sources in AOM_PORTS_SOURCES to the libaom target.
 # * The libaom target must exist before this function is called.
 function(setup_aom_ports_targets)
+  target_sources(aom PRIVATE ${AOM_PORTS_SOURCES})
+
   if("${AOM_TARGET_CPU}" MATCHES "^x86")
     add_asm_library("aom_ports" "AOM_PORTS_ASM_X86" "aom")
     set(aom_ports_has_symbols 1)
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "config/aom_config.h"
+
+#include "aom_ports/aom_once.h"
+#include "aom_ports/aom_rtcd.h"
+#include "aom_util/aom_thread.h"
+
+#define MAX_RULES 64
+#define MAX_PATTERN_LEN 64
+#define MAX_TIER_LEN 8
+
+typedef struct {
+  char pattern[MAX_PATTERN_LEN];
+  int prefix;  // Set when the pattern ended with '*'.
+  char tier[MAX_TIER_LEN];
+} rtcd_rule_t;
+
+typedef struct {
+  rtcd_rule_t rules[MAX_RULES];
+  int num_rules;
+} rtcd_rules_t;
+
+// Tier names of all the architectures supported by rtcd.pl.
+static const char *const known_tiers[] = { "c",      "mmx",    "sse",
+                                           "sse2",   "sse3",   "ssse3",
+                                           "sse4_1", "sse4_2", "avx",
+                                           "avx2",   "neon",   "dspr2",
+                                           "msa",    "vsx",    "mips32",
+                                           "mips64" };
+
+static rtcd_rules_t env_rules;
+static rtcd_rules_t api_rules;
+static int env_rules_parsed;
+static aom_rtcd_table_t *tables;
+
+#if CONFIG_MULTITHREAD
+static pthread_mutex_t rtcd_mutex;
+
+static void init_rtcd_mutex(void) { pthread_mutex_init(&rtcd_mutex, NULL); }
+
+static void rtcd_lock(void) {
+  aom_once(init_rtcd_mutex);
+  pthread_mutex_lock(&rtcd_mutex);
+}
+
+static void rtcd_unlock(void) { pthread_mutex_unlock(&rtcd_mutex); }
+#else
+static void rtcd_lock(void) {}
+static void rtcd_unlock(void) {}
+#endif  // CONFIG_MULTITHREAD
+
+static int is_known_tier(const char *tier) {
+  for (size_t i = 0; i < sizeof(known_tiers) / sizeof(known_tiers[0]); ++i) {
+    if (!strcmp(tier, known_tiers[i])) return 1;
+  }
+  return 0;
+}
+
+// Parses a comma separated list of name=tier rules. Returns -1 on error.
+static int parse_rules(const char *spec, rtcd_rules_t *rules) {
+  rules->num_rules = 0;
+  if (!spec) return 0;
+  while (*spec) {
+    const char *end = strchr(spec, ',');
+    const char *eq;
+    size_t name_len, tier_len;
+    rtcd_rule_t *rule;
+
+    if (!end) end = spec + strlen(spec);
+    if (end == spec) {
+      ++spec;
+      continue;
+    }
+    eq = memchr(spec, '=', end - spec);
+    if (!eq || rules->num_rules == MAX_RULES) return -1;
+    name_len = eq - spec;
+    tier_len = end - eq - 1;
+    if (name_len == 0 || name_len >= MAX_PATTERN_LEN || tier_len == 0 ||
+        tier_len >= MAX_TIER_LEN) {
+      return -1;
+    }
+
+    rule = &rules->rules[rules->num_rules];
+    memcpy(rule->pattern, spec, name_len);
+    rule->pattern[name_len] = '\0';
+    rule->prefix = rule->pattern[name_len - 1] == '*';
+    if (rule->prefix) rule->pattern[name_len - 1] = '\0';
+    memcpy(rule->tier, eq + 1, tier_len);
+    rule->tier[tier_len] = '\0';
+    if (!is_known_tier(rule->tier)) return -1;
+    ++rules->num_rules;
+    spec = *end ? end + 1 : end;
+  }
+  return 0;
+}
+
+static void parse_env_rules(void) {
+  if (env_rules_parsed) return;
+  if (parse_rules(getenv("AOM_RTCD_OVERRIDE"), &env_rules))
+    env_rules.num_rules = 0;
+  env_rules_parsed = 1;
+}
+
+static const rtcd_rule_t *last_match(const rtcd_rules_t *rules,
+                                     const char *name) {
+  for (int i = rules->num_rules - 1; i >= 0; --i) {
+    const rtcd_rule_t *const rule = &rules->rules[i];
+    if (rule->prefix ? !strncmp(name, rule->pattern, strlen(rule->pattern))
+                     : !strcmp(name, rule->pattern)) {
+      return rule;
+    }
+  }
+  return NULL;
+}
+
+static int find_tier(const aom_rtcd_table_t *table, const char *tier) {
+  for (int i = 0; i < table->num_tiers; ++i) {
+    if (!strcmp(tier, table->tier_names[i])) return i;
+  }
+  return -1;
+}
+
+// Binds the function to its best version supported by the CPU that is not
+// above the tier of the last matching rule, or to its default binding. When
+// all the versions it may be bound to are above that tier, e.g. "c" for a
+// function that has a required SSE2 version, the lowest one is used.
+static void bind_function(const aom_rtcd_table_t *table, int index) {
+  const aom_rtcd_func_t *const func = &table->funcs[index];
+  const rtcd_rule_t *rule;
+  aom_rtcd_fn_t fn = table->defaults[index];
+  int tier;
+
+  if (!func->ptr) return;
+  rule = last_match(&api_rules, func->name);
+  if (!rule) rule = last_match(&env_rules, func->name);
+  tier = rule ? find_tier(table, rule->tier) : -1;
+  if (tier >= 0) {
+    fn = table->impls[func->first_impl + func->min_impl].fn;
+    for (int i = func->num_impls - 1; i >= func->min_impl; --i) {
+      const aom_rtcd_impl_t *const impl = &table->impls[func->first_impl + i];
+      const int needed = table->tier_flags[impl->tier];
+      if (impl->tier <= tier && (table->flags & needed) == needed) {
+        fn = impl->fn;
+        break;
+      }
+    }
+  }
+  *func->ptr = fn;
+}
+
+void aom_rtcd_register(aom_rtcd_table_t *table, int flags) {
+  aom_rtcd_table_t **last;
+
+  rtcd_lock();
+  parse_env_rules();
+  table->flags = flags;
+  table->next = NULL;
+  for (int i = 0; i < table->num_funcs; ++i) {
+    const aom_rtcd_func_t *const func = &table->funcs[i];
+    table->defaults[i] = func->ptr ? *func->ptr : NULL;
+    bind_function(table, i);
+  }
+  for (last = &tables; *last; last = &(*last)->next) {
+  }
+  *last = table;
+  rtcd_unlock();
+}
+
+int aom_rtcd_set_override(const char *spec) {
+  rtcd_rules_t rules;
+
+  if (parse_rules(spec, &rules)) return -1;
+  rtcd_lock();
+  parse_env_rules();
+  api_rules = rules;
+  for (const aom_rtcd_table_t *table = tables; table; table = table->next) {
+    for (int i = 0; i < table->num_funcs; ++i) bind_function(table, i);
+  }
+  rtcd_unlock();
+  return 0;
+}
+
+int aom_rtcd_get_binding(int index, const char **name, const char **tier) {
+  int found = 0;
+
+  rtcd_lock();
+  for (const aom_rtcd_table_t *table = tables; table && index >= 0;
+       table = table->next) {
+    if (index < table->num_funcs) {
+      const aom_rtcd_func_t *const func = &table->funcs[index];
+      const aom_rtcd_impl_t *const impls = &table->impls[func->first_impl];
+      *name = func->name;
+      const aom_rtcd_fn_t fn =
+          func->ptr ? *func->ptr : impls[func->min_impl].fn;
+      *tier = "unknown";
+      for (int i = 0; i < func->num_impls; ++i) {
+        if (impls[i].fn == fn) *tier = table->tier_names[impls[i].tier];
+      }
+      found = 1;
+      break;
+    }
+    index -= table->num_funcs;
+  }
+  rtcd_unlock();
+  return found;
+}
+
+const aom_rtcd_table_t *aom_rtcd_get_function(int index, int *func_index) {
+  const aom_rtcd_table_t *found = NULL;
+
+  rtcd_lock();
+  for (const aom_rtcd_table_t *table = tables; table && index >= 0;
+       table = table->next) {
+    if (index < table->num_funcs) {
+      *func_index = index;
+      found = table;
+      break;
+    }
+    index -= table->num_funcs;
+  }
+  rtcd_unlock();
+  return found;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_AOM_PORTS_AOM_RTCD_H_
+#define AOM_AOM_PORTS_AOM_RTCD_H_
+
+// Registry of the run time CPU detected (RTCD) function tables. The tables
+// are generated by build/cmake/rtcd.pl, and each one is registered by its
+// setup_rtcd_internal() once the default bindings are in place. This allows
+// to pin functions to a lower SIMD tier at run time, either with
+// aom_rtcd_set_override() or the AOM_RTCD_OVERRIDE environment variable, and
+// to list the active binding of every function.
+//
+// An override spec is a comma separated list of name=tier rules, e.g.
+// "aom_sad16x16=sse2,av1_convolve_*=ssse3,*=sse4_1". A name ending in '*'
+// matches every function starting with that prefix, and when several rules
+// match a function the last one wins. A function is bound to its best version
+// that the CPU supports and that does not go above the requested tier.
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*aom_rtcd_fn_t)(void);
+
+typedef struct aom_rtcd_impl {
+  aom_rtcd_fn_t fn;
+  int tier;  // Index in aom_rtcd_table_t::tier_names.
+} aom_rtcd_impl_t;
+
+typedef struct aom_rtcd_func {
+  const char *name;
+  // The function pointer, or NULL when the function is bound at build time.
+  aom_rtcd_fn_t *ptr;
+  // Versions of the function in impls, in increasing tier order. The first one
+  // is always supported by the CPU.
+  int first_impl;
+  int num_impls;
+  // Index in the versions of the lowest one the function may be bound to. The
+  // versions below it, e.g. the C version of a function that requires SSE2,
+  // are compiled but only listed for benchmarking. For a function bound at
+  // build time, this is its only binding.
+  int min_impl;
+  // Return type and parameters as declared in the _defs.pl file, e.g.
+  // "unsigned int(const uint8_t *src_ptr, int src_stride, ...)".
+  const char *proto;
+} aom_rtcd_func_t;
+
+typedef struct aom_rtcd_table {
+  const aom_rtcd_func_t *funcs;
+  int num_funcs;
+  const aom_rtcd_impl_t *impls;
+  // Names of the tiers, "c" first, and the CPU capability flags they need.
+  const char *const *tier_names;
+  const int *tier_flags;
+  int num_tiers;
+  // Filled in by aom_rtcd_register().
+  aom_rtcd_fn_t *defaults;
+  int flags;
+  struct aom_rtcd_table *next;
+} aom_rtcd_table_t;
+
+// Adds a table whose function pointers hold their default bindings, and
+// applies the current overrides to it. flags are the CPU capabilities used to
+// pick the defaults.
+void aom_rtcd_register(aom_rtcd_table_t *table, int flags);
+
+// Replaces the overrides set by a previous call with the rules of spec, which
+// may be NULL or empty, and rebinds the functions of all registered tables.
+// The rules of AOM_RTCD_OVERRIDE apply first. Returns 0 on success and -1 if
+// spec is invalid, in which case the overrides are left unchanged. This must
+// not be called while a codec instance is running.
+int aom_rtcd_set_override(const char *spec);
+
+// Gets the name of the function at index in the registered tables and the
+// tier of its active binding. Returns 0 when index is past the last function.
+int aom_rtcd_get_binding(int index, const char **name, const char **tier);
+
+// Gets the table holding the function at index in the registered tables, and
+// the index of the function in that table. Returns NULL when index is past the
+// last function. The versions of the function that the CPU supports are the
+// ones whose tier_flags are all set in the flags of the table.
+const aom_rtcd_table_t *aom_rtcd_get_function(int index, int *func_index);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AOM_PORTS_AOM_RTCD_H_
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+// Enable POSIX.1b in glibc so that we can call clock_gettime(). This must be
+// before any #include statements.
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include <time.h>
+
+#include "aom_ports/aom_timer.h"
+
+int64_t aom_thread_cpu_time_us(void) {
+#if CONFIG_OS_SUPPORT && defined(_WIN32)
+  FILETIME creation, exit, kernel, user;
+  if (GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+    const uint64_t kernel_100ns =
+        ((uint64_t)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+    const uint64_t user_100ns =
+        ((uint64_t)user.dwHighDateTime << 32) | user.dwLowDateTime;
+    return (int64_t)((kernel_100ns + user_100ns) / 10);
+  }
+  // No thread CPU clock: fall back to the wall clock.
+  LARGE_INTEGER counter, freq;
+  QueryPerformanceCounter(&counter);
+  QueryPerformanceFrequency(&freq);
+  return counter.QuadPart / freq.QuadPart * 1000000 +
+         counter.QuadPart % freq.QuadPart * 1000000 / freq.QuadPart;
+#elif CONFIG_OS_SUPPORT
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+  struct timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+  // No thread CPU clock: fall back to the wall clock.
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+#else
+  return 0;
+#endif
+}
@@ -108,4 +108,17 @@ static INLINE int aom_usec_timer_elapsed(struct aom_usec_timer *t) {
 
 #endif /* CONFIG_OS_SUPPORT */
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Returns the CPU time the calling thread has used, in microseconds. Falls
+// back to the wall clock time where there is no per-thread CPU clock. Only
+// differences between two calls on the same thread are meaningful.
+int64_t aom_thread_cpu_time_us(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
 #endif  // AOM_AOM_PORTS_AOM_TIMER_H_
@@ -27,6 +27,7 @@ extern "C" {
 #define AOM_BORDER_IN_PIXELS 288
 #define AOM_ENC_NO_SCALE_BORDER 160
 #define AOM_ENC_LOOKAHEAD_BORDER 64
+#define AOM_ENC_SMALL_BORDER 64
 #define AOM_DEC_BORDER_IN_PIXELS 64
 
 typedef struct yv12_buffer_config {
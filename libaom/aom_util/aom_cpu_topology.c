@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+// Enable GNU extensions in glibc so that we can call sched_getaffinity() and
+// sched_getcpu(). This must be before any #include statements.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <string.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <stdio.h>
+#elif defined(_WIN32)
+#include <windows.h>  // NOLINT
+#ifndef WINAPI_FAMILY_PARTITION
+#define WINAPI_PARTITION_DESKTOP 1
+#define WINAPI_FAMILY_PARTITION(x) x
+#endif
+#endif
+
+#include "aom_util/aom_cpu_topology.h"
+
+// Lists the CPUs node by node. cpu_node[cpu] is the node number of a CPU the
+// process may run on and -1 for the other CPUs.
+static void list_cpus(const int *cpu_node, int current_cpu,
+                      AomCpuTopology *topology) {
+  for (int node = 0; node < AOM_MAX_NUMA_NODES; ++node) {
+    const int num_cpus = topology->num_cpus;
+    for (int cpu = 0; cpu < AOM_MAX_CPUS; ++cpu) {
+      if (cpu_node[cpu] != node) continue;
+      if (cpu == current_cpu) {
+        topology->current_cpu = topology->num_cpus;
+        topology->current_node = topology->num_nodes;
+      }
+      topology->cpu[topology->num_cpus] = cpu;
+      topology->node[topology->num_cpus++] = topology->num_nodes;
+    }
+    if (topology->num_cpus > num_cpus) ++topology->num_nodes;
+  }
+}
+
+#if defined(__linux__)
+// Moves the CPUs of a sysfs CPU list, such as "0-7,16-23", to 'node'.
+static void read_node_cpus(FILE *file, int node, int *cpu_node) {
+  int first, last, c;
+  while (fscanf(file, "%d", &first) == 1) {
+    last = first;
+    c = fgetc(file);
+    if (c == '-') {
+      if (fscanf(file, "%d", &last) != 1) break;
+      c = fgetc(file);
+    }
+    for (int cpu = first; cpu >= 0 && cpu <= last && cpu < AOM_MAX_CPUS;
+         ++cpu) {
+      if (cpu_node[cpu] >= 0) cpu_node[cpu] = node;
+    }
+    if (c != ',') break;
+  }
+}
+#endif  // defined(__linux__)
+
+int aom_get_cpu_topology(AomCpuTopology *topology) {
+  int cpu_node[AOM_MAX_CPUS];
+  memset(topology, 0, sizeof(*topology));
+#if defined(__linux__)
+  cpu_set_t allowed;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return 0;
+  // The CPUs missing from the node lists, as on kernels without NUMA support,
+  // stay on node 0.
+  for (int cpu = 0; cpu < AOM_MAX_CPUS; ++cpu) {
+    cpu_node[cpu] = cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed) ? 0 : -1;
+  }
+  for (int node = 0; node < AOM_MAX_NUMA_NODES; ++node) {
+    char path[64];
+    FILE *file;
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist",
+             node);
+    file = fopen(path, "r");
+    if (file == NULL) continue;
+    read_node_cpus(file, node, cpu_node);
+    fclose(file);
+  }
+  list_cpus(cpu_node, sched_getcpu(), topology);
+#elif defined(_WIN32) && WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+  DWORD_PTR process_mask, system_mask;
+  ULONG highest_node;
+  const int mask_bits = (int)(8 * sizeof(process_mask));
+  if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask,
+                              &system_mask))
+    return 0;
+  for (int cpu = 0; cpu < AOM_MAX_CPUS; ++cpu) {
+    cpu_node[cpu] = cpu < mask_bits && ((process_mask >> cpu) & 1) ? 0 : -1;
+  }
+  if (GetNumaHighestNodeNumber(&highest_node)) {
+    for (int node = 0; node <= (int)highest_node && node < AOM_MAX_NUMA_NODES;
+         ++node) {
+      ULONGLONG node_mask;
+      if (!GetNumaNodeProcessorMask((UCHAR)node, &node_mask)) continue;
+      for (int cpu = 0; cpu < mask_bits; ++cpu) {
+        if (((node_mask >> cpu) & 1) && cpu_node[cpu] >= 0)
+          cpu_node[cpu] = node;
+      }
+    }
+  }
+#if _WIN32_WINNT >= 0x0600  // Windows Vista / Server 2008 or greater
+  list_cpus(cpu_node, (int)GetCurrentProcessorNumber(), topology);
+#else
+  list_cpus(cpu_node, -1, topology);
+#endif
+#else
+  (void)cpu_node;
+  (void)list_cpus;
+  return 0;
+#endif
+  return topology->num_cpus > 0;
+}
+
+void aom_get_cpu_order(const AomCpuTopology *topology, int *order) {
+  const int current = topology->current_cpu;
+  const int current_node = topology->node[current];
+  int n = 0;
+  // The CPUs of the node of the current CPU, from the current one on and
+  // wrapping around within the node.
+  for (int i = current; i < topology->num_cpus; ++i) {
+    if (topology->node[i] == current_node) order[n++] = i;
+  }
+  for (int i = 0; i < current; ++i) {
+    if (topology->node[i] == current_node) order[n++] = i;
+  }
+  // The other nodes, from the next one on.
+  for (int i = current + 1; i < topology->num_cpus; ++i) {
+    if (topology->node[i] != current_node) order[n++] = i;
+  }
+  for (int i = 0; i < current; ++i) {
+    if (topology->node[i] != current_node) order[n++] = i;
+  }
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+//
+// CPU topology
+//
+// Lists the CPUs the process may run on, grouped by NUMA node, so that worker
+// threads can be pinned next to the memory they work on.
+
+#ifndef AOM_AOM_UTIL_AOM_CPU_TOPOLOGY_H_
+#define AOM_AOM_UTIL_AOM_CPU_TOPOLOGY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AOM_MAX_CPUS 1024
+#define AOM_MAX_NUMA_NODES 64
+
+typedef struct {
+  int num_cpus;
+  int num_nodes;
+  // The CPUs node by node, in ascending order within a node, and the index of
+  // the node of each CPU, from 0 to num_nodes - 1.
+  int cpu[AOM_MAX_CPUS];
+  int node[AOM_MAX_CPUS];
+  // Index in cpu[] of the CPU the calling thread ran on and its node, or 0 if
+  // unknown.
+  int current_cpu;
+  int current_node;
+} AomCpuTopology;
+
+// Fills 'topology' with the CPUs the process may run on. The CPUs of systems
+// without NUMA information belong to a single node. Returns 0 if the CPUs
+// cannot be queried on this platform.
+int aom_get_cpu_topology(AomCpuTopology *topology);
+
+// Fills order[0] to order[num_cpus - 1] with the indices in topology->cpu[] of
+// the CPUs in the order threads working with the calling thread should take
+// them: the current CPU, the other CPUs of its node and then the CPUs of the
+// other nodes.
+void aom_get_cpu_order(const AomCpuTopology *topology, int *order);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AOM_UTIL_AOM_CPU_TOPOLOGY_H_
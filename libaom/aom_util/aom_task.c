@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "aom_mem/aom_mem.h"
+#include "aom_util/aom_task.h"
+
+#if CONFIG_MULTITHREAD
+#define TASK_LOCK(mutex) pthread_mutex_lock(mutex)
+#define TASK_UNLOCK(mutex) pthread_mutex_unlock(mutex)
+#else
+#define TASK_LOCK(mutex)
+#define TASK_UNLOCK(mutex)
+#endif  // CONFIG_MULTITHREAD
+
+// The ready tasks of a worker. Each task is queued once per run, so the queue
+// never wraps.
+typedef struct {
+  int *tasks;
+  int head;
+  int tail;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t mutex;
+#endif
+} TaskQueue;
+
+typedef struct {
+  AomTaskGraph *graph;
+  int thread_id;
+} TaskWorkerData;
+
+struct AomTaskSched {
+  // Number of unfinished dependencies of each task.
+  int *pending;
+  // The successors of task i are successors[first_successor[i]] to
+  // successors[first_successor[i + 1] - 1].
+  int *first_successor;
+  int *successors;
+  TaskQueue *queues;
+  int *queue_buf;
+  TaskWorkerData *worker_data;
+  int num_workers;
+  // The fields below are guarded by 'mutex'.
+  int num_ready;
+  int num_left;
+  int error;
+#if CONFIG_MULTITHREAD
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+#endif
+};
+
+int aom_task_graph_alloc(AomTaskGraph *graph, int max_tasks, int max_deps,
+                         int max_workers) {
+  assert(max_tasks > 0 && max_deps >= 0 && max_workers > 0);
+  if (max_tasks > graph->max_tasks || max_deps > graph->max_deps ||
+      max_workers > graph->max_workers) {
+    struct AomTaskSched *sched;
+    aom_task_graph_free(graph);
+    // aom_malloc(0) may return NULL.
+    max_deps = max_deps > 0 ? max_deps : 1;
+    graph->tasks = (AomTask *)aom_malloc(max_tasks * sizeof(*graph->tasks));
+    graph->deps = (int(*)[2])aom_malloc(max_deps * sizeof(*graph->deps));
+    sched = graph->sched =
+        (struct AomTaskSched *)aom_calloc(1, sizeof(*graph->sched));
+    if (graph->tasks == NULL || graph->deps == NULL || sched == NULL) {
+      aom_task_graph_free(graph);
+      return 0;
+    }
+    sched->pending = (int *)aom_malloc(max_tasks * sizeof(*sched->pending));
+    sched->first_successor =
+        (int *)aom_malloc((max_tasks + 1) * sizeof(*sched->first_successor));
+    sched->successors =
+        (int *)aom_malloc(max_deps * sizeof(*sched->successors));
+    sched->queues =
+        (TaskQueue *)aom_calloc(max_workers, sizeof(*sched->queues));
+    sched->queue_buf =
+        (int *)aom_malloc(max_workers * max_tasks * sizeof(*sched->queue_buf));
+    sched->worker_data = (TaskWorkerData *)aom_malloc(
+        max_workers * sizeof(*sched->worker_data));
+    if (sched->pending == NULL || sched->first_successor == NULL ||
+        sched->successors == NULL || sched->queues == NULL ||
+        sched->queue_buf == NULL || sched->worker_data == NULL) {
+      aom_task_graph_free(graph);
+      return 0;
+    }
+    for (int i = 0; i < max_workers; ++i) {
+      sched->queues[i].tasks = sched->queue_buf + i * max_tasks;
+#if CONFIG_MULTITHREAD
+      pthread_mutex_init(&sched->queues[i].mutex, NULL);
+#endif
+    }
+#if CONFIG_MULTITHREAD
+    pthread_mutex_init(&sched->mutex, NULL);
+    pthread_cond_init(&sched->cond, NULL);
+#endif
+    graph->max_tasks = max_tasks;
+    graph->max_deps = max_deps;
+    graph->max_workers = max_workers;
+  }
+  graph->num_tasks = 0;
+  graph->num_deps = 0;
+  return 1;
+}
+
+int aom_task_graph_add(AomTaskGraph *graph, AomTaskHook hook, void *arg1,
+                       void *arg2) {
+  AomTask *const task = &graph->tasks[graph->num_tasks];
+  assert(graph->num_tasks < graph->max_tasks);
+  task->hook = hook;
+  task->arg1 = arg1;
+  task->arg2 = arg2;
+  return graph->num_tasks++;
+}
+
+void aom_task_graph_add_dependency(AomTaskGraph *graph, int task,
+                                   int successor) {
+  assert(graph->num_deps < graph->max_deps);
+  assert(task >= 0 && task < successor && successor < graph->num_tasks);
+  graph->deps[graph->num_deps][0] = task;
+  graph->deps[graph->num_deps][1] = successor;
+  ++graph->num_deps;
+}
+
+static void push_task(TaskQueue *queue, int task) {
+  TASK_LOCK(&queue->mutex);
+  queue->tasks[queue->tail++] = task;
+  TASK_UNLOCK(&queue->mutex);
+}
+
+// Takes the newest task of the queue of the worker, or the oldest task of the
+// queue of another worker. Returns -1 if all the queues are empty.
+static int get_task(struct AomTaskSched *sched, int thread_id) {
+  int task = -1;
+  TaskQueue *queue = &sched->queues[thread_id];
+  TASK_LOCK(&queue->mutex);
+  if (queue->tail > queue->head) task = queue->tasks[--queue->tail];
+  TASK_UNLOCK(&queue->mutex);
+
+  for (int i = 1; task < 0 && i < sched->num_workers; ++i) {
+    queue = &sched->queues[(thread_id + i) % sched->num_workers];
+    TASK_LOCK(&queue->mutex);
+    if (queue->tail > queue->head) task = queue->tasks[queue->head++];
+    TASK_UNLOCK(&queue->mutex);
+  }
+  return task;
+}
+
+static int task_worker_hook(void *arg1, void *unused) {
+  const TaskWorkerData *const data = (const TaskWorkerData *)arg1;
+  const AomTaskGraph *const graph = data->graph;
+  struct AomTaskSched *const sched = graph->sched;
+  const int thread_id = data->thread_id;
+  (void)unused;
+
+  while (1) {
+    const int task = get_task(sched, thread_id);
+    TASK_LOCK(&sched->mutex);
+    if (task < 0) {
+      int done;
+#if CONFIG_MULTITHREAD
+      while (!sched->num_ready && sched->num_left && !sched->error)
+        pthread_cond_wait(&sched->cond, &sched->mutex);
+#endif
+      done = !sched->num_left || sched->error;
+      TASK_UNLOCK(&sched->mutex);
+      if (done) break;
+      continue;
+    }
+    --sched->num_ready;
+    if (sched->error) {
+      TASK_UNLOCK(&sched->mutex);
+      break;
+    }
+    TASK_UNLOCK(&sched->mutex);
+
+    const AomTask *const t = &graph->tasks[task];
+    const int ok = t->hook(t->arg1, t->arg2, thread_id);
+
+    TASK_LOCK(&sched->mutex);
+    if (ok) {
+      --sched->num_left;
+      for (int i = sched->first_successor[task];
+           i < sched->first_successor[task + 1]; ++i) {
+        const int successor = sched->successors[i];
+        if (--sched->pending[successor] == 0) {
+          // Run the successor in this worker while its inputs are in cache.
+          push_task(&sched->queues[thread_id], successor);
+          ++sched->num_ready;
+#if CONFIG_MULTITHREAD
+          pthread_cond_signal(&sched->cond);
+#endif
+        }
+      }
+    } else {
+      sched->error = 1;
+    }
+#if CONFIG_MULTITHREAD
+    if (!sched->num_left || sched->error) pthread_cond_broadcast(&sched->cond);
+#endif
+    TASK_UNLOCK(&sched->mutex);
+    if (!ok) break;
+  }
+  return 1;
+}
+
+int aom_task_graph_run(AomTaskGraph *graph, AVxWorker *workers,
+                       int num_workers, int main_worker) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  struct AomTaskSched *const sched = graph->sched;
+  const int num_tasks = graph->num_tasks;
+  int *first_successor;
+  int num_roots = 0;
+  int root;
+  int i;
+
+  assert(num_workers > 0 && num_workers <= graph->max_workers);
+  assert(main_worker >= 0 && main_worker < num_workers);
+  if (num_tasks == 0) return 1;
+  first_successor = sched->first_successor;
+
+  // Count the dependencies of each task and list its successors in the order
+  // they were added.
+  memset(sched->pending, 0, num_tasks * sizeof(*sched->pending));
+  memset(first_successor, 0, (num_tasks + 1) * sizeof(*first_successor));
+  for (i = 0; i < graph->num_deps; ++i) {
+    ++sched->pending[graph->deps[i][1]];
+    ++first_successor[graph->deps[i][0] + 1];
+  }
+  for (i = 0; i < num_tasks; ++i) first_successor[i + 1] += first_successor[i];
+  for (i = 0; i < graph->num_deps; ++i) {
+    sched->successors[first_successor[graph->deps[i][0]]++] = graph->deps[i][1];
+  }
+  for (i = num_tasks; i > 0; --i) first_successor[i] = first_successor[i - 1];
+  first_successor[0] = 0;
+
+  // Deal the tasks that have no dependency to the workers. A worker takes the
+  // newest task of its queue, so each queue gets its tasks in reverse order.
+  for (i = 0; i < num_workers; ++i) {
+    sched->queues[i].head = 0;
+    sched->queues[i].tail = 0;
+  }
+  for (i = 0; i < num_tasks; ++i) num_roots += !sched->pending[i];
+  for (i = num_tasks - 1, root = num_roots; i >= 0; --i) {
+    if (!sched->pending[i]) push_task(&sched->queues[--root % num_workers], i);
+  }
+  sched->num_workers = num_workers;
+  sched->num_ready = num_roots;
+  sched->num_left = num_tasks;
+  sched->error = 0;
+
+  for (i = 0; i < num_workers; ++i) {
+    AVxWorker *const worker = &workers[i];
+    sched->worker_data[i].graph = graph;
+    sched->worker_data[i].thread_id = i;
+    worker->hook = task_worker_hook;
+    worker->data1 = &sched->worker_data[i];
+    worker->data2 = NULL;
+    worker->had_error = 0;
+    if (i != main_worker) winterface->launch(worker);
+  }
+  winterface->execute(&workers[main_worker]);
+  for (i = 0; i < num_workers; ++i) winterface->sync(&workers[i]);
+  return !sched->error;
+}
+
+void aom_task_graph_free(AomTaskGraph *graph) {
+  struct AomTaskSched *const sched = graph->sched;
+  if (sched != NULL) {
+#if CONFIG_MULTITHREAD
+    // The mutexes are set up once the allocation succeeded.
+    if (graph->max_workers > 0) {
+      for (int i = 0; i < graph->max_workers; ++i) {
+        pthread_mutex_destroy(&sched->queues[i].mutex);
+      }
+      pthread_mutex_destroy(&sched->mutex);
+      pthread_cond_destroy(&sched->cond);
+    }
+#endif
+    aom_free(sched->pending);
+    aom_free(sched->first_successor);
+    aom_free(sched->successors);
+    aom_free(sched->queues);
+    aom_free(sched->queue_buf);
+    aom_free(sched->worker_data);
+    aom_free(sched);
+  }
+  aom_free(graph->tasks);
+  aom_free(graph->deps);
+  memset(graph, 0, sizeof(*graph));
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+//
+// Task graph scheduler
+//
+// A task graph holds jobs and the dependencies between them. Running it on a
+// set of AVxWorkers starts each task as soon as the tasks it depends on are
+// done, so the stages of a frame overlap instead of waiting for each other at
+// a barrier. Each worker keeps a queue of ready tasks: it runs the tasks that
+// it made ready first and takes the oldest tasks of the other workers when its
+// own queue is empty.
+//
+// The tile jobs, the loop filter, CDEF and loop restoration rows run on task
+// graphs. The superblock row jobs of the row-based multithreading of the
+// encoder and decoder keep their per-column sync: the superblocks of a row
+// only wait for the superblocks above and to the right of them, which a task
+// per row cannot express without running the rows of a tile one at a time.
+// The loop filter, CDEF and loop restoration stages are separate graphs, as
+// superres upscaling and the saving of the restoration boundary lines work on
+// the whole frame between them.
+
+#ifndef AOM_AOM_UTIL_AOM_TASK_H_
+#define AOM_AOM_UTIL_AOM_TASK_H_
+
+#include "aom_util/aom_thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Runs a task. 'thread_id' is the index of the worker that runs the task in
+// the array given to aom_task_graph_run(). Returns 0 on error.
+typedef int (*AomTaskHook)(void *arg1, void *arg2, int thread_id);
+
+typedef struct {
+  AomTaskHook hook;
+  void *arg1;
+  void *arg2;
+} AomTask;
+
+typedef struct AomTaskGraph {
+  AomTask *tasks;
+  int num_tasks;
+  int max_tasks;
+  // Dependencies as (task, successor) pairs.
+  int (*deps)[2];
+  int num_deps;
+  int max_deps;
+  int max_workers;
+  // State of aom_task_graph_run().
+  struct AomTaskSched *sched;
+} AomTaskGraph;
+
+// Makes room in a zero initialized or reset graph for 'max_tasks' tasks with
+// 'max_deps' dependencies, run on up to 'max_workers' workers, and removes
+// the tasks of the graph. Returns 0 on allocation failure.
+int aom_task_graph_alloc(AomTaskGraph *graph, int max_tasks, int max_deps,
+                         int max_workers);
+
+// Adds a task to the graph and returns its index.
+int aom_task_graph_add(AomTaskGraph *graph, AomTaskHook hook, void *arg1,
+                       void *arg2);
+
+// Makes task 'successor' wait for task 'task' to be done. 'task' must have
+// been added before 'successor', which keeps the graph free of cycles.
+void aom_task_graph_add_dependency(AomTaskGraph *graph, int task,
+                                   int successor);
+
+// Runs the tasks of the graph on 'workers', which must have been reset, and
+// replaces their hooks and data. workers[main_worker] runs in the calling
+// thread. The tasks without dependencies are started in the order they were
+// added. Returns 0 if a task failed, in which case the tasks that were not
+// started yet are not run.
+int aom_task_graph_run(AomTaskGraph *graph, AVxWorker *workers,
+                       int num_workers, int main_worker);
+
+// Frees the memory of the graph and zeroes it.
+void aom_task_graph_free(AomTaskGraph *graph);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AOM_UTIL_AOM_TASK_H_
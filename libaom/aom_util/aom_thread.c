@@ -14,7 +14,8 @@
 // Original source:
 //  https://chromium.googlesource.com/webm/libwebp
 
-// Enable GNU extensions in glibc so that we can call pthread_setname_np().
+// Enable GNU extensions in glibc so that we can call pthread_setname_np() and
+// sched_setaffinity().
 // This must be before any #include statements.
 #ifndef _GNU_SOURCE
 #define _GNU_SOURCE
@@ -22,8 +23,12 @@
 
 #include <assert.h>
 #include <string.h>  // for memset()
+#if defined(__linux__)
+#include <sched.h>
+#endif
 
 #include "aom_mem/aom_mem.h"
+#include "aom_ports/aom_once.h"
 #include "aom_util/aom_thread.h"
 
 #if CONFIG_MULTITHREAD
@@ -32,36 +37,64 @@ struct AVxWorkerImpl {
   pthread_mutex_t mutex_;
   pthread_cond_t condition_;
   pthread_t thread_;
+  // Used instead of the fields above by the workers of a group: the next job
+  // in the queue of the group, and whether the job of the worker is queued.
+  AVxWorker *next_;
+  int queued_;
 };
 
 //------------------------------------------------------------------------------
 
 static void execute(AVxWorker *const worker);  // Forward declaration.
 
-static THREADFN thread_loop(void *ptr) {
-  AVxWorker *const worker = (AVxWorker *)ptr;
+static void set_thread_name(const char *name) {
 #ifdef __APPLE__
-  if (worker->thread_name != NULL) {
+  if (name != NULL) {
     // Apple's version of pthread_setname_np takes one argument and operates on
     // the current thread only. The maximum size of the thread_name buffer was
     // noted in the Chromium source code and was confirmed by experiments. If
     // thread_name is too long, pthread_setname_np returns -1 with errno
     // ENAMETOOLONG (63).
     char thread_name[64];
-    strncpy(thread_name, worker->thread_name, sizeof(thread_name));
+    strncpy(thread_name, name, sizeof(thread_name));
     thread_name[sizeof(thread_name) - 1] = '\0';
     pthread_setname_np(thread_name);
   }
 #elif defined(__GLIBC__) || defined(__BIONIC__)
-  if (worker->thread_name != NULL) {
+  if (name != NULL) {
     // Linux and Android require names (with nul) fit in 16 chars, otherwise
     // pthread_setname_np() returns ERANGE (34).
     char thread_name[16];
-    strncpy(thread_name, worker->thread_name, sizeof(thread_name));
+    strncpy(thread_name, name, sizeof(thread_name));
     thread_name[sizeof(thread_name) - 1] = '\0';
     pthread_setname_np(pthread_self(), thread_name);
   }
+#else
+  (void)name;
+#endif
+}
+
+// Pins the calling thread to 'cpu' if it is not negative. The pinning is a
+// placement hint, so failures are ignored.
+static void set_thread_cpu(int cpu) {
+  if (cpu < 0) return;
+#if defined(__linux__)
+  if (cpu < CPU_SETSIZE) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+  }
+#elif defined(_WIN32) && !HAVE_PTHREAD_H && !defined(USE_CREATE_THREAD)
+  if (cpu < (int)(8 * sizeof(DWORD_PTR)))
+    SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu);
 #endif
+}
+
+static THREADFN thread_loop(void *ptr) {
+  AVxWorker *const worker = (AVxWorker *)ptr;
+  set_thread_name(worker->thread_name);
+  set_thread_cpu(worker->cpu);
   int done = 0;
   while (!done) {
     pthread_mutex_lock(&worker->impl_->mutex_);
@@ -103,6 +136,130 @@ static void change_state(AVxWorker *const worker, AVxWorkerStatus new_status) {
   pthread_mutex_unlock(&worker->impl_->mutex_);
 }
 
+//------------------------------------------------------------------------------
+// Process-wide worker pool
+
+struct AVxWorkerGroup {
+  int max_active;
+  int active;         // Number of jobs of the group running on the pool.
+  AVxWorker *head;    // Queue of the launched jobs that have not started.
+  AVxWorker *tail;
+  AVxWorkerGroup *next;
+};
+
+typedef struct {
+  // Serializes the creation and destruction of groups, which start and stop
+  // the threads.
+  pthread_mutex_t setup_mutex;
+  pthread_mutex_t mutex;
+  pthread_cond_t job_cond;   // Signaled when a job is queued or on stop.
+  pthread_cond_t done_cond;  // Broadcast when a job finishes.
+  pthread_t threads[MAX_NUM_THREADS];
+  int num_threads;  // Number of threads started with the first group.
+  int num_running;
+  int stop;
+  AVxWorkerGroup *groups;
+  AVxWorkerGroup *next_group;  // Group served first by the next free thread.
+} AVxWorkerPool;
+
+static AVxWorkerPool pool;
+
+static void init_pool(void) {
+  pthread_mutex_init(&pool.setup_mutex, NULL);
+  pthread_mutex_init(&pool.mutex, NULL);
+  pthread_cond_init(&pool.job_cond, NULL);
+  pthread_cond_init(&pool.done_cond, NULL);
+}
+
+// Takes the next job to run, serving the groups with queued jobs in turn.
+// Must be called with pool.mutex held.
+static AVxWorker *take_pool_job(void) {
+  AVxWorkerGroup *group = pool.next_group;
+  if (group == NULL) return NULL;
+  do {
+    AVxWorkerGroup *const next = group->next ? group->next : pool.groups;
+    if (group->head != NULL && group->active < group->max_active) {
+      AVxWorker *const job = group->head;
+      group->head = job->impl_->next_;
+      if (group->head == NULL) group->tail = NULL;
+      job->impl_->queued_ = 0;
+      ++group->active;
+      pool.next_group = next;
+      return job;
+    }
+    group = next;
+  } while (group != pool.next_group);
+  return NULL;
+}
+
+static THREADFN pool_thread_loop(void *ptr) {
+  (void)ptr;
+  set_thread_name("aom pool worker");
+  pthread_mutex_lock(&pool.mutex);
+  while (!pool.stop) {
+    AVxWorker *const job = take_pool_job();
+    if (job == NULL) {
+      pthread_cond_wait(&pool.job_cond, &pool.mutex);
+      continue;
+    }
+    pthread_mutex_unlock(&pool.mutex);
+    execute(job);
+    pthread_mutex_lock(&pool.mutex);
+    --job->group->active;
+    job->status_ = OK;
+    pthread_cond_broadcast(&pool.done_cond);
+  }
+  pthread_mutex_unlock(&pool.mutex);
+  return THREAD_RETURN(NULL);
+}
+
+// Waits for the job of the worker to finish. A job that has not started yet
+// runs in the calling thread, so that the owner of the group always makes
+// progress, whatever the other groups keep the pool threads busy with.
+static void pool_sync(AVxWorker *const worker) {
+  if (worker->impl_ == NULL) return;
+  pthread_mutex_lock(&pool.mutex);
+  if (worker->impl_->queued_) {
+    AVxWorkerGroup *const group = worker->group;
+    AVxWorker *prev = NULL;
+    AVxWorker *job = group->head;
+    while (job != worker) {
+      prev = job;
+      job = job->impl_->next_;
+    }
+    if (prev == NULL)
+      group->head = worker->impl_->next_;
+    else
+      prev->impl_->next_ = worker->impl_->next_;
+    if (group->tail == worker) group->tail = prev;
+    worker->impl_->queued_ = 0;
+    pthread_mutex_unlock(&pool.mutex);
+    execute(worker);
+    pthread_mutex_lock(&pool.mutex);
+    worker->status_ = OK;
+  }
+  while (worker->status_ == WORK) {
+    pthread_cond_wait(&pool.done_cond, &pool.mutex);
+  }
+  pthread_mutex_unlock(&pool.mutex);
+}
+
+static void pool_launch(AVxWorker *const worker) {
+  AVxWorkerGroup *const group = worker->group;
+  pool_sync(worker);
+  pthread_mutex_lock(&pool.mutex);
+  worker->status_ = WORK;
+  worker->impl_->next_ = NULL;
+  worker->impl_->queued_ = 1;
+  if (group->tail == NULL)
+    group->head = worker;
+  else
+    group->tail->impl_->next_ = worker;
+  group->tail = worker;
+  pthread_cond_signal(&pool.job_cond);
+  pthread_mutex_unlock(&pool.mutex);
+}
+
 #endif  // CONFIG_MULTITHREAD
 
 //------------------------------------------------------------------------------
@@ -110,11 +267,15 @@ static void change_state(AVxWorker *const worker, AVxWorkerStatus new_status) {
 static void init(AVxWorker *const worker) {
   memset(worker, 0, sizeof(*worker));
   worker->status_ = NOT_OK;
+  worker->cpu = -1;
 }
 
 static int sync(AVxWorker *const worker) {
 #if CONFIG_MULTITHREAD
-  change_state(worker, OK);
+  if (worker->group != NULL)
+    pool_sync(worker);
+  else
+    change_state(worker, OK);
 #endif
   assert(worker->status_ <= OK);
   return !worker->had_error;
@@ -129,6 +290,11 @@ static int reset(AVxWorker *const worker) {
     if (worker->impl_ == NULL) {
       return 0;
     }
+    if (worker->group != NULL) {
+      // The jobs run on the threads of the pool.
+      worker->status_ = OK;
+      return 1;
+    }
     if (pthread_mutex_init(&worker->impl_->mutex_, NULL)) {
       goto Error;
     }
@@ -166,7 +332,10 @@ static void execute(AVxWorker *const worker) {
 
 static void launch(AVxWorker *const worker) {
 #if CONFIG_MULTITHREAD
-  change_state(worker, WORK);
+  if (worker->group != NULL)
+    pool_launch(worker);
+  else
+    change_state(worker, WORK);
 #else
   execute(worker);
 #endif
@@ -174,7 +343,12 @@ static void launch(AVxWorker *const worker) {
 
 static void end(AVxWorker *const worker) {
 #if CONFIG_MULTITHREAD
-  if (worker->impl_ != NULL) {
+  if (worker->group != NULL) {
+    pool_sync(worker);
+    worker->status_ = NOT_OK;
+    aom_free(worker->impl_);
+    worker->impl_ = NULL;
+  } else if (worker->impl_ != NULL) {
     change_state(worker, NOT_OK);
     pthread_join(worker->impl_->thread_, NULL);
     pthread_mutex_destroy(&worker->impl_->mutex_);
@@ -210,3 +384,81 @@ const AVxWorkerInterface *aom_get_worker_interface(void) {
 }
 
 //------------------------------------------------------------------------------
+
+#if CONFIG_MULTITHREAD
+int aom_worker_pool_set_threads(int num_threads) {
+  if (num_threads < 0 || num_threads > MAX_NUM_THREADS) return 0;
+  aom_once(init_pool);
+  pthread_mutex_lock(&pool.setup_mutex);
+  const int ok = pool.groups == NULL;
+  if (ok) pool.num_threads = num_threads;
+  pthread_mutex_unlock(&pool.setup_mutex);
+  return ok;
+}
+
+AVxWorkerGroup *aom_worker_group_create(int max_active) {
+  aom_once(init_pool);
+  pthread_mutex_lock(&pool.setup_mutex);
+  if (pool.num_threads == 0 || max_active <= 0) {
+    pthread_mutex_unlock(&pool.setup_mutex);
+    return NULL;
+  }
+  while (pool.num_running < pool.num_threads &&
+         !pthread_create(&pool.threads[pool.num_running], NULL,
+                         pool_thread_loop, NULL)) {
+    ++pool.num_running;
+  }
+  AVxWorkerGroup *group = NULL;
+  if (pool.num_running > 0)
+    group = (AVxWorkerGroup *)aom_calloc(1, sizeof(*group));
+  if (group != NULL) {
+    group->max_active = max_active;
+    pthread_mutex_lock(&pool.mutex);
+    group->next = pool.groups;
+    pool.groups = group;
+    if (pool.next_group == NULL) pool.next_group = group;
+    pthread_mutex_unlock(&pool.mutex);
+  }
+  pthread_mutex_unlock(&pool.setup_mutex);
+  return group;
+}
+
+void aom_worker_group_destroy(AVxWorkerGroup *group) {
+  if (group == NULL) return;
+  pthread_mutex_lock(&pool.setup_mutex);
+  pthread_mutex_lock(&pool.mutex);
+  assert(group->head == NULL && group->active == 0);
+  AVxWorkerGroup **p = &pool.groups;
+  while (*p != group) p = &(*p)->next;
+  *p = group->next;
+  if (pool.next_group == group)
+    pool.next_group = group->next ? group->next : pool.groups;
+  const int last = pool.groups == NULL;
+  if (last) {
+    pool.stop = 1;
+    pthread_cond_broadcast(&pool.job_cond);
+  }
+  pthread_mutex_unlock(&pool.mutex);
+  if (last) {
+    // The threads are started again with the next group.
+    for (int i = 0; i < pool.num_running; ++i) {
+      pthread_join(pool.threads[i], NULL);
+    }
+    pool.num_running = 0;
+    pool.stop = 0;
+  }
+  pthread_mutex_unlock(&pool.setup_mutex);
+  aom_free(group);
+}
+#else
+int aom_worker_pool_set_threads(int num_threads) { return num_threads == 0; }
+
+AVxWorkerGroup *aom_worker_group_create(int max_active) {
+  (void)max_active;
+  return NULL;
+}
+
+void aom_worker_group_destroy(AVxWorkerGroup *group) { (void)group; }
+#endif  // CONFIG_MULTITHREAD
+
+//------------------------------------------------------------------------------
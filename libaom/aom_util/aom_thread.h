@@ -377,6 +377,10 @@ typedef int (*AVxWorkerHook)(void *, void *);
 // Platform-dependent implementation details for the worker.
 typedef struct AVxWorkerImpl AVxWorkerImpl;
 
+// Workers that run their jobs on the process-wide worker pool, see
+// aom_worker_group_create().
+typedef struct AVxWorkerGroup AVxWorkerGroup;
+
 // Synchronization object used to launch job in the worker thread
 typedef struct {
   AVxWorkerImpl *impl_;
@@ -389,6 +393,14 @@ typedef struct {
   void *data1;         // first argument passed to 'hook'
   void *data2;         // second argument passed to 'hook'
   int had_error;       // true if a call to 'hook' returned false
+  // If set before reset() is first called, the jobs of the worker run on the
+  // threads of the pool instead of a thread of its own. Only used by the
+  // default interface.
+  AVxWorkerGroup *group;
+  // If not negative before reset() is first called, the thread of the worker
+  // is pinned to this CPU. Only used by the default interface, and not for
+  // the workers of a group.
+  int cpu;
 } AVxWorker;
 
 // The interface for all thread-worker related functions. All these functions
@@ -426,6 +438,23 @@ int aom_set_worker_interface(const AVxWorkerInterface *const winterface);
 // Retrieve the currently set thread worker interface.
 const AVxWorkerInterface *aom_get_worker_interface(void);
 
+// Sets the number of threads of the process-wide worker pool. 0, the default,
+// disables the pool. Returns false if num_threads is out of range or if a
+// group exists.
+int aom_worker_pool_set_threads(int num_threads);
+
+// Returns a new group of workers that has at most max_active jobs running on
+// the pool at once, or NULL if the pool is disabled or on failure. The
+// threads of the pool start with the first group and stop with the last one.
+// Groups with queued jobs are served in turn, and sync() runs a job that has
+// not started in the calling thread. As jobs may wait for each other, a job
+// must only wait for work that a running job or the caller of sync() took
+// on.
+AVxWorkerGroup *aom_worker_group_create(int max_active);
+
+// Destroys a group once all its workers have been ended.
+void aom_worker_group_destroy(AVxWorkerGroup *group);
+
 //------------------------------------------------------------------------------
 
 #ifdef __cplusplus
@@ -15,6 +15,10 @@ set(AOM_AOM_UTIL_AOM_UTIL_CMAKE_ 1)
 
 list(APPEND AOM_UTIL_SOURCES "${AOM_ROOT}/aom_util/aom_thread.c"
             "${AOM_ROOT}/aom_util/aom_thread.h"
+            "${AOM_ROOT}/aom_util/aom_task.c"
+            "${AOM_ROOT}/aom_util/aom_task.h"
+            "${AOM_ROOT}/aom_util/aom_cpu_topology.c"
+            "${AOM_ROOT}/aom_util/aom_cpu_topology.h"
             "${AOM_ROOT}/aom_util/endian_inl.h"
             "${AOM_ROOT}/aom_util/debug_util.c"
             "${AOM_ROOT}/aom_util/debug_util.h")
@@ -106,15 +106,36 @@ static const arg_def_t outallarg = ARG_DEF(
     NULL, "all-layers", 0, "Output all decoded frames of a scalable bitstream");
 static const arg_def_t skipfilmgrain =
     ARG_DEF(NULL, "skip-film-grain", 0, "Skip film grain application");
+static const arg_def_t fastpreviewarg =
+    ARG_DEF(NULL, "fast-preview", 1,
+            "Skip in-loop filters for faster, inexact previews (0: off, "
+            "1: non-reference frames, 2: also CDEF and loop restoration of "
+            "all frames, 3: all filters of all frames)");
+static const arg_def_t keyframesonlyarg =
+    ARG_DEF(NULL, "key-frames-only", 0,
+            "Decode only key frames and intra-only frames");
+static const arg_def_t downscalearg =
+    ARG_DEF(NULL, "downscale", 1, "Downscale output frames by 1, 2 or 4");
+static const arg_def_t seekkeyframearg =
+    ARG_DEF(NULL, "seek-key-frame", 1,
+            "Start at the last key frame at or before temporal unit n "
+            "(OBU input only)");
+static const arg_def_t lowmemoryarg =
+    ARG_DEF(NULL, "low-memory", 0,
+            "Reduce the memory used by the decoder, with the same output");
+static const arg_def_t rtcdarg =
+    ARG_DEF(NULL, "print-rtcd-bindings", 0,
+            "Show the version used of every SIMD optimized function");
 
 static const arg_def_t *all_args[] = {
-  &help,           &codecarg,   &use_yv12,      &use_i420,
-  &flipuvarg,      &rawvideo,   &noblitarg,     &progressarg,
-  &limitarg,       &skiparg,    &postprocarg,   &summaryarg,
-  &outputfile,     &threadsarg, &verbosearg,    &scalearg,
-  &fb_arg,         &md5arg,     &framestatsarg, &continuearg,
-  &outbitdeptharg, &isannexb,   &oppointarg,    &outallarg,
-  &skipfilmgrain,  NULL
+  &help,             &codecarg,         &use_yv12,         &use_i420,
+  &flipuvarg,        &rawvideo,         &noblitarg,        &progressarg,
+  &limitarg,         &skiparg,          &postprocarg,      &summaryarg,
+  &outputfile,       &threadsarg,       &verbosearg,       &scalearg,
+  &fb_arg,           &md5arg,           &framestatsarg,    &continuearg,
+  &outbitdeptharg,   &isannexb,         &oppointarg,       &outallarg,
+  &skipfilmgrain,    &fastpreviewarg,   &keyframesonlyarg, &downscalearg,
+  &seekkeyframearg,  &lowmemoryarg,     &rtcdarg,          NULL
 };
 
 #if CONFIG_LIBYUV
@@ -460,6 +481,12 @@ static int main_loop(int argc, const char **argv_) {
   int operating_point = 0;
   int output_all_layers = 0;
   int skip_film_grain = 0;
+  int fast_preview = 0;
+  int key_frames_only = 0;
+  int output_downscale = 1;
+  int seek_temporal_unit = 0;
+  int low_memory = 0;
+  int print_rtcd = 0;
   aom_image_t *scaled_img = NULL;
   aom_image_t *img_shifted = NULL;
   int frame_avail, got_data, flush_decoder = 0;
@@ -576,6 +603,18 @@ static int main_loop(int argc, const char **argv_) {
       output_all_layers = 1;
     } else if (arg_match(&arg, &skipfilmgrain, argi)) {
       skip_film_grain = 1;
+    } else if (arg_match(&arg, &fastpreviewarg, argi)) {
+      fast_preview = arg_parse_int(&arg);
+    } else if (arg_match(&arg, &keyframesonlyarg, argi)) {
+      key_frames_only = 1;
+    } else if (arg_match(&arg, &downscalearg, argi)) {
+      output_downscale = arg_parse_int(&arg);
+    } else if (arg_match(&arg, &seekkeyframearg, argi)) {
+      seek_temporal_unit = arg_parse_uint(&arg);
+    } else if (arg_match(&arg, &lowmemoryarg, argi)) {
+      low_memory = 1;
+    } else if (arg_match(&arg, &rtcdarg, argi)) {
+      print_rtcd = 1;
     } else {
       argj++;
     }
@@ -709,6 +748,55 @@ static int main_loop(int argc, const char **argv_) {
     goto fail;
   }
 
+  if (aom_codec_control(&decoder, AV1D_SET_FAST_PREVIEW, fast_preview)) {
+    fprintf(stderr, "Failed to set fast_preview: %s\n",
+            aom_codec_error(&decoder));
+    goto fail;
+  }
+
+  if (aom_codec_control(&decoder, AV1D_SET_KEY_FRAMES_ONLY, key_frames_only)) {
+    fprintf(stderr, "Failed to set key_frames_only: %s\n",
+            aom_codec_error(&decoder));
+    goto fail;
+  }
+
+  if (aom_codec_control(&decoder, AV1D_SET_OUTPUT_DOWNSCALE,
+                        output_downscale)) {
+    fprintf(stderr, "Failed to set output_downscale: %s\n",
+            aom_codec_error(&decoder));
+    goto fail;
+  }
+
+  if (aom_codec_control(&decoder, AV1D_SET_LOW_MEMORY, low_memory)) {
+    fprintf(stderr, "Failed to set low_memory: %s\n",
+            aom_codec_error(&decoder));
+    goto fail;
+  }
+
+  if (seek_temporal_unit) {
+    struct ObuDecKeyFrameIndex key_frame_index = { NULL, 0 };
+    if (aom_input_ctx.file_type != FILE_TYPE_OBU ||
+        obudec_build_key_frame_index(&obu_ctx, &key_frame_index)) {
+      fprintf(stderr, "Failed to build the key frame index.\n");
+      goto fail;
+    }
+    size_t key_frame = 0;
+    while (key_frame + 1 < key_frame_index.num_key_frames &&
+           key_frame_index.key_frames[key_frame + 1].temporal_unit <=
+               seek_temporal_unit) {
+      ++key_frame;
+    }
+    if (obudec_seek_to_key_frame(&obu_ctx, &key_frame_index, key_frame)) {
+      fprintf(stderr, "Failed to seek to temporal unit %d.\n",
+              seek_temporal_unit);
+      obudec_free_key_frame_index(&key_frame_index);
+      goto fail;
+    }
+    fprintf(stderr, "Seeking to the key frame in temporal unit %d.\n",
+            key_frame_index.key_frames[key_frame].temporal_unit);
+    obudec_free_key_frame_index(&key_frame_index);
+  }
+
   if (arg_skip) fprintf(stderr, "Skipping first %d frames.\n", arg_skip);
   while (arg_skip) {
     if (read_frame(&input, &buf, &bytes_in_buffer, &buffer_size)) break;
@@ -954,6 +1042,17 @@ static int main_loop(int argc, const char **argv_) {
     fprintf(stderr, "\n");
   }
 
+  if (summary) {
+    uint64_t peak_memory = 0;
+    if (!aom_codec_control(&decoder, AV1D_GET_PEAK_MEMORY, &peak_memory)) {
+      fprintf(stderr, "Peak decoder memory: %" PRId64 " bytes\n",
+              (int64_t)peak_memory);
+    }
+  }
+
+  // The function tables are set up with the first decoded frame.
+  if (print_rtcd) print_rtcd_bindings(stderr);
+
   if (frames_corrupted) {
     fprintf(stderr, "WARNING: %d frames corrupted.\n", frames_corrupted);
   } else {
@@ -144,6 +144,10 @@ static const arg_def_t pass_arg =
     ARG_DEF(NULL, "pass", 1, "Pass to execute (1/2)");
 static const arg_def_t fpf_name =
     ARG_DEF(NULL, "fpf", 1, "First pass statistics file name");
+static const arg_def_t shared_first_pass =
+    ARG_DEF(NULL, "shared-first-pass", 0,
+            "Run the first pass on the first stream only and use its "
+            "statistics for all streams");
 static const arg_def_t limit =
     ARG_DEF(NULL, "limit", 1, "Stop encoding after n input frames");
 static const arg_def_t skip =
@@ -188,6 +192,9 @@ static const arg_def_t disable_warnings =
 static const arg_def_t disable_warning_prompt =
     ARG_DEF("y", "disable-warning-prompt", 0,
             "Display warnings, but do not prompt user to continue.");
+static const arg_def_t rtcdarg =
+    ARG_DEF(NULL, "print-rtcd-bindings", 0,
+            "Show the version used of every SIMD optimized function");
 static const struct arg_enum_list bitdepth_enum[] = {
   { "8", AOM_BITS_8 }, { "10", AOM_BITS_10 }, { "12", AOM_BITS_12 }, { NULL, 0 }
 };
@@ -214,6 +221,7 @@ static const arg_def_t *main_args[] = { &help,
                                         &passes,
                                         &pass_arg,
                                         &fpf_name,
+                                        &shared_first_pass,
                                         &limit,
                                         &skip,
                                         &good_dl,
@@ -228,6 +236,7 @@ static const arg_def_t *main_args[] = { &help,
                                         &rate_hist_n,
                                         &disable_warnings,
                                         &disable_warning_prompt,
+                                        &rtcdarg,
                                         &recontest,
                                         NULL };
 
@@ -606,6 +615,18 @@ static const arg_def_t film_grain_test =
 static const arg_def_t film_grain_table =
     ARG_DEF(NULL, "film-grain-table", 1,
             "Path to file containing film grain parameters");
+static const arg_def_t analysis_cache =
+    ARG_DEF(NULL, "analysis-cache", 1,
+            "Path to file caching the encoder analysis for re-encodes of the "
+            "same source at any rate target, extended if it exists");
+static const arg_def_t enable_small_border =
+    ARG_DEF(NULL, "enable-small-border", 1,
+            "Allocate reference frames with a small border and emulate the "
+            "frame edges in motion compensation (0: off (default), 1: on)");
+static const arg_def_t thread_affinity =
+    ARG_DEF(NULL, "thread-affinity", 1,
+            "Pin the worker threads to CPUs and keep the row jobs of a tile on "
+            "one NUMA node (0: off (default), 1: on)");
 #if CONFIG_DENOISE
 static const arg_def_t denoise_noise_level =
     ARG_DEF(NULL, "denoise-noise-level", 1,
@@ -856,6 +877,9 @@ static const arg_def_t *av1_args[] = { &cpu_used_av1,
                                        &timing_info,
                                        &film_grain_test,
                                        &film_grain_table,
+                                       &analysis_cache,
+                                       &enable_small_border,
+                                       &thread_affinity,
 #if CONFIG_DENOISE
                                        &denoise_noise_level,
                                        &denoise_block_size,
@@ -955,6 +979,9 @@ static const int av1_arg_ctrl_map[] = { AOME_SET_CPUUSED,
                                         AV1E_SET_TIMING_INFO_TYPE,
                                         AV1E_SET_FILM_GRAIN_TEST_VECTOR,
                                         AV1E_SET_FILM_GRAIN_TABLE,
+                                        AV1E_SET_ANALYSIS_CACHE,
+                                        AV1E_SET_ENABLE_SMALL_BORDER,
+                                        AV1E_SET_THREAD_AFFINITY,
 #if CONFIG_DENOISE
                                         AV1E_SET_DENOISE_NOISE_LEVEL,
                                         AV1E_SET_DENOISE_BLOCK_SIZE,
@@ -1035,6 +1062,7 @@ struct stream_config {
   int arg_ctrl_cnt;
   int write_webm;
   const char *film_grain_filename;
+  const char *analysis_cache_filename;
   int write_ivf;
   // whether to use 16bit internal buffers
   int use_16bit_internal;
@@ -1179,6 +1207,10 @@ static void parse_global_config(struct AvxEncoderConfig *global, int argc,
       global->disable_warnings = 1;
     else if (arg_match(&arg, &disable_warning_prompt, argi))
       global->disable_warning_prompt = 1;
+    else if (arg_match(&arg, &rtcdarg, argi))
+      global->print_rtcd_bindings = 1;
+    else if (arg_match(&arg, &shared_first_pass, argi))
+      global->shared_first_pass = 1;
     else
       argj++;
   }
@@ -1210,6 +1242,11 @@ static void parse_global_config(struct AvxEncoderConfig *global, int argc,
     warn("Enforcing one-pass encoding in realtime mode\n");
     global->passes = 1;
   }
+
+  if (global->shared_first_pass && global->passes != 2) {
+    warn("Ignoring --shared-first-pass in one-pass mode\n");
+    global->shared_first_pass = 0;
+  }
 }
 
 static void open_input_file(struct AvxInputContext *input,
@@ -1325,6 +1362,10 @@ static void set_config_arg_ctrls(struct stream_config *config, int key,
     config->film_grain_filename = arg->val;
     return;
   }
+  if (key == AV1E_SET_ANALYSIS_CACHE) {
+    config->analysis_cache_filename = arg->val;
+    return;
+  }
 
   // For target level, the settings should accumulate rather than overwrite,
   // so we simply append it.
@@ -1562,7 +1603,6 @@ static int parse_stream_params(struct AvxEncoderConfig *global,
 static void validate_stream_config(const struct stream_state *stream,
                                    const struct AvxEncoderConfig *global) {
   const struct stream_state *streami;
-  (void)global;
 
   if (!stream->config.cfg.g_w || !stream->config.cfg.g_h)
     fatal(
@@ -1592,7 +1632,7 @@ static void validate_stream_config(const struct stream_state *stream,
     }
 
     /* Check for two streams sharing a stats file. */
-    if (streami != stream) {
+    if (streami != stream && !global->shared_first_pass) {
       const char *a = stream->config.stats_fn;
       const char *b = streami->config.stats_fn;
       if (a && b && !strcmp(a, b))
@@ -1754,7 +1794,22 @@ static void close_output_file(struct stream_state *stream,
 }
 
 static void setup_pass(struct stream_state *stream,
+                       struct stream_state *first_stream,
                        struct AvxEncoderConfig *global, int pass) {
+  if (global->shared_first_pass && stream != first_stream) {
+    /* Only the first stream ran the first pass. Its statistics are
+     * normalized per macroblock, so they also drive the rate control of the
+     * lower resolution streams.
+     */
+    assert(pass == 1);
+    stream->config.cfg.g_pass = AOM_RC_LAST_PASS;
+    stream->config.cfg.rc_twopass_stats_in = stats_get(&first_stream->stats);
+    stream->cx_time = 0;
+    stream->nbytes = 0;
+    stream->frames_out = 0;
+    return;
+  }
+
   if (stream->config.stats_fn) {
     if (!stats_open_file(&stream->stats, stream->config.stats_fn, pass))
       fatal("Failed to open statistics store");
@@ -1804,6 +1859,11 @@ static void initialize_encoder(struct stream_state *stream,
     aom_codec_control_(&stream->encoder, AV1E_SET_FILM_GRAIN_TABLE,
                        stream->config.film_grain_filename);
   }
+  if (stream->config.analysis_cache_filename) {
+    aom_codec_control_(&stream->encoder, AV1E_SET_ANALYSIS_CACHE,
+                       stream->config.analysis_cache_filename);
+    ctx_exit_on_error(&stream->encoder, "Failed to open analysis cache");
+  }
 
 #if CONFIG_AV1_DECODER
   if (global->test_decode != TEST_DECODE_OFF) {
@@ -2345,12 +2405,29 @@ int main(int argc, const char **argv_) {
       set_stream_dimensions(stream, input.width, input.height);
     }
     FOREACH_STREAM(stream, streams) { validate_stream_config(stream, &global); }
+    if (global.shared_first_pass &&
+        pass == (global.pass ? global.pass - 1 : 0)) {
+      FOREACH_STREAM(stream, streams) {
+        if (stream == streams) continue;
+        if (stream->config.stats_fn &&
+            (!streams->config.stats_fn ||
+             strcmp(stream->config.stats_fn, streams->config.stats_fn)))
+          warn("Stream %d: --fpf is ignored with --shared-first-pass",
+               stream->index);
+        if (stream->config.cfg.g_w > streams->config.cfg.g_w ||
+            stream->config.cfg.g_h > streams->config.cfg.g_h)
+          warn("Stream %d: --shared-first-pass expects the first stream to "
+               "have the largest frame size",
+               stream->index);
+      }
+    }
 
     /* Ensure that --passes and --pass are consistent. If --pass is set and
      * --passes=2, ensure --fpf was set.
      */
     if (global.pass && global.passes == 2) {
       FOREACH_STREAM(stream, streams) {
+        if (global.shared_first_pass && stream != streams) break;
         if (!stream->config.stats_fn)
           die("Stream %d: Must specify --fpf when --pass=%d"
               " and --passes=2\n",
@@ -2401,7 +2478,16 @@ int main(int argc, const char **argv_) {
       }
     }
 
-    FOREACH_STREAM(stream, streams) { setup_pass(stream, &global, pass); }
+    /* With --shared-first-pass the other streams sit out the first pass. */
+    struct stream_state *other_streams = NULL;
+    if (global.shared_first_pass && pass == 0) {
+      other_streams = streams->next;
+      streams->next = NULL;
+    }
+
+    FOREACH_STREAM(stream, streams) {
+      setup_pass(stream, streams, &global, pass);
+    }
     FOREACH_STREAM(stream, streams) { initialize_encoder(stream, &global); }
     FOREACH_STREAM(stream, streams) {
       open_output_file(stream, &global, &input.pixel_aspect_ratio);
@@ -2591,6 +2677,7 @@ int main(int argc, const char **argv_) {
     FOREACH_STREAM(stream, streams) {
       stats_close(&stream->stats, global.passes - 1);
     }
+    if (other_streams) streams->next = other_streams;
 
     if (global.pass) break;
   }
@@ -2609,6 +2696,8 @@ int main(int argc, const char **argv_) {
   }
   FOREACH_STREAM(stream, streams) { destroy_rate_histogram(stream->rate_hist); }
 
+  if (global.print_rtcd_bindings) print_rtcd_bindings(stderr);
+
 #if CONFIG_INTERNAL_STATS
   /* TODO(jkoleszar): This doesn't belong in this executable. Do it for now,
    * to match some existing utilities.
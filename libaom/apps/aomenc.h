@@ -37,6 +37,7 @@ struct AvxEncoderConfig {
   const struct AvxInterface *codec;
   int passes;
   int pass;
+  int shared_first_pass;
   int usage;
   ColorInputType color_type;
   int quiet;
@@ -52,6 +53,7 @@ struct AvxEncoderConfig {
   int show_rate_hist_buckets;
   int disable_warnings;
   int disable_warning_prompt;
+  int print_rtcd_bindings;
   int experimental_bitstream;
   aom_chroma_sample_position_t csp;
 };
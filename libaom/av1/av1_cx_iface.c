@@ -142,6 +142,8 @@ struct av1_extracfg {
   unsigned int tier_mask;
   COST_UPDATE_TYPE coeff_cost_upd_freq;
   COST_UPDATE_TYPE mode_cost_upd_freq;
+  unsigned int enable_small_border;
+  unsigned int thread_affinity;
 };
 
 static struct av1_extracfg default_extra_cfg = {
@@ -255,6 +257,8 @@ static struct av1_extracfg default_extra_cfg = {
   0,            // tier_mask
   COST_UPD_SB,  // coeff_cost_upd_freq
   COST_UPD_SB,  // mode_cost_upd_freq
+  0,            // enable_small_border
+  0,            // thread_affinity
 };
 
 struct aom_codec_alg_priv {
@@ -339,8 +343,8 @@ static aom_codec_err_t validate_config(aom_codec_alg_priv_t *ctx,
   RANGE_CHECK_HI(extra_cfg, min_gf_interval, MAX_LAG_BUFFERS - 1);
   RANGE_CHECK_HI(extra_cfg, max_gf_interval, MAX_LAG_BUFFERS - 1);
   if (extra_cfg->max_gf_interval > 0) {
-    RANGE_CHECK(extra_cfg, max_gf_interval, MAX(2, extra_cfg->min_gf_interval),
-                (MAX_LAG_BUFFERS - 1));
+    RANGE_CHECK(extra_cfg, max_gf_interval,
+                AOMMAX(2, extra_cfg->min_gf_interval), (MAX_LAG_BUFFERS - 1));
   }
   RANGE_CHECK_HI(extra_cfg, gf_max_pyr_height, 4);
 
@@ -467,6 +471,8 @@ static aom_codec_err_t validate_config(aom_codec_alg_priv_t *ctx,
   RANGE_CHECK_HI(extra_cfg, disable_trellis_quant, 3);
   RANGE_CHECK(extra_cfg, coeff_cost_upd_freq, 0, 2);
   RANGE_CHECK(extra_cfg, mode_cost_upd_freq, 0, 2);
+  RANGE_CHECK_HI(extra_cfg, enable_small_border, 1);
+  RANGE_CHECK_HI(extra_cfg, thread_affinity, 1);
 
   RANGE_CHECK(extra_cfg, min_partition_size, 4, 128);
   RANGE_CHECK(extra_cfg, max_partition_size, 4, 128);
@@ -757,6 +763,7 @@ static aom_codec_err_t set_encoder_config(
   }
 
   oxcf->row_mt = extra_cfg->row_mt;
+  oxcf->thread_affinity = extra_cfg->thread_affinity;
 
   oxcf->tile_columns = extra_cfg->tile_columns;
   oxcf->tile_rows = extra_cfg->tile_rows;
@@ -843,9 +850,12 @@ static aom_codec_err_t set_encoder_config(
 
   oxcf->chroma_subsampling_x = extra_cfg->chroma_subsampling_x;
   oxcf->chroma_subsampling_y = extra_cfg->chroma_subsampling_y;
-  oxcf->border_in_pixels = (oxcf->resize_mode || oxcf->superres_mode)
-                               ? AOM_BORDER_IN_PIXELS
-                               : AOM_ENC_NO_SCALE_BORDER;
+  if (oxcf->resize_mode || oxcf->superres_mode)
+    oxcf->border_in_pixels = AOM_BORDER_IN_PIXELS;
+  else if (extra_cfg->enable_small_border)
+    oxcf->border_in_pixels = AOM_ENC_SMALL_BORDER;
+  else
+    oxcf->border_in_pixels = AOM_ENC_NO_SCALE_BORDER;
   memcpy(oxcf->target_seq_level_idx, extra_cfg->target_seq_level_idx,
          sizeof(oxcf->target_seq_level_idx));
   oxcf->tier_mask = extra_cfg->tier_mask;
@@ -1563,6 +1573,39 @@ static aom_codec_err_t ctrl_set_tier_mask(aom_codec_alg_priv_t *ctx,
   return update_extra_cfg(ctx, &extra_cfg);
 }
 
+static aom_codec_err_t ctrl_set_enable_small_border(aom_codec_alg_priv_t *ctx,
+                                                   va_list args) {
+  // The frame buffers are allocated with the border of the first frame.
+  if (ctx->cpi->common.current_frame.frame_number > 0)
+    return AOM_CODEC_INCAPABLE;
+  struct av1_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.enable_small_border = CAST(AV1E_SET_ENABLE_SMALL_BORDER, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static aom_codec_err_t ctrl_set_thread_affinity(aom_codec_alg_priv_t *ctx,
+                                                va_list args) {
+  // The worker threads are pinned when they are created.
+  if (ctx->cpi->num_workers > 0) return AOM_CODEC_INCAPABLE;
+  struct av1_extracfg extra_cfg = ctx->extra_cfg;
+  extra_cfg.thread_affinity = CAST(AV1E_SET_THREAD_AFFINITY, args);
+  return update_extra_cfg(ctx, &extra_cfg);
+}
+
+static aom_codec_err_t ctrl_set_stage_timing(aom_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  ctx->cpi->stage_timing_enabled = CAST(AV1E_SET_STAGE_TIMING, args) != 0;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_stage_timing(aom_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  aom_enc_stage_timing_t *const arg = va_arg(args, aom_enc_stage_timing_t *);
+  if (arg == NULL) return AOM_CODEC_INVALID_PARAM;
+  *arg = ctx->cpi->stage_timing;
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_err_t encoder_init(aom_codec_ctx_t *ctx,
                                     aom_codec_priv_enc_mr_cfg_t *data) {
   aom_codec_err_t res = AOM_CODEC_OK;
@@ -1671,6 +1714,7 @@ static aom_codec_err_t encoder_encode(aom_codec_alg_priv_t *ctx,
   }
 
   aom_codec_pkt_list_init(&ctx->pkt_list);
+  av1_zero(cpi->stage_timing);
 
   volatile aom_enc_frame_flags_t flags = enc_flags;
 
@@ -2140,6 +2184,76 @@ static aom_codec_err_t ctrl_get_seq_level_idx(aom_codec_alg_priv_t *ctx,
   return av1_get_seq_level_idx(ctx->cpi, arg);
 }
 
+static aom_codec_err_t ctrl_set_svc_params(aom_codec_alg_priv_t *ctx,
+                                           va_list args) {
+  aom_svc_params_t *const params = va_arg(args, aom_svc_params_t *);
+  AV1_COMP *const cpi = ctx->cpi;
+  if (params == NULL) return AOM_CODEC_INVALID_PARAM;
+  if (params->number_spatial_layers < 1 ||
+      params->number_spatial_layers > AOM_MAX_SS_LAYERS ||
+      params->number_temporal_layers < 1 ||
+      params->number_temporal_layers > AOM_MAX_TS_LAYERS)
+    return AOM_CODEC_INVALID_PARAM;
+  for (int sl = 0; sl < params->number_spatial_layers; ++sl) {
+    for (int tl = 0; tl < params->number_temporal_layers; ++tl) {
+      const int layer = sl * params->number_temporal_layers + tl;
+      if (params->min_quantizers[layer] < 0 ||
+          params->max_quantizers[layer] > 63 ||
+          params->min_quantizers[layer] > params->max_quantizers[layer])
+        return AOM_CODEC_INVALID_PARAM;
+      // Temporal layer bitrates include the layers below them.
+      if (params->layer_target_bitrate[layer] <= 0 ||
+          (tl > 0 && params->layer_target_bitrate[layer] <
+                         params->layer_target_bitrate[layer - 1]))
+        return AOM_CODEC_INVALID_PARAM;
+    }
+  }
+  // Layers are rate controlled as one pass CBR streams without lookahead.
+  if (ctx->cfg.rc_end_usage != AOM_CBR || ctx->cfg.g_pass != AOM_RC_ONE_PASS ||
+      ctx->cfg.g_lag_in_frames != 0)
+    return AOM_CODEC_INVALID_PARAM;
+  // The operating points are fixed by the sequence header.
+  if (cpi->seq_params_locked) return AOM_CODEC_INCAPABLE;
+
+  cpi->use_svc =
+      params->number_spatial_layers * params->number_temporal_layers > 1;
+  if (cpi->use_svc) {
+    av1_init_layer_context(cpi, params);
+  } else {
+    cpi->common.number_spatial_layers = 1;
+    cpi->common.number_temporal_layers = 1;
+  }
+  av1_change_config(cpi, &ctx->oxcf);
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_svc_layer_id(aom_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  aom_svc_layer_id_t *const layer_id = va_arg(args, aom_svc_layer_id_t *);
+  if (layer_id == NULL) return AOM_CODEC_INVALID_PARAM;
+  layer_id->spatial_layer_id = ctx->cpi->common.spatial_layer_id;
+  layer_id->temporal_layer_id = ctx->cpi->common.temporal_layer_id;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_motion_hints(aom_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  aom_motion_hints_t *const hints = va_arg(args, aom_motion_hints_t *);
+  // Without lookahead the next frame coded is the next input frame.
+  if (ctx->cfg.g_lag_in_frames != 0) return AOM_CODEC_INCAPABLE;
+  if (av1_set_motion_hints(ctx->cpi, hints)) return AOM_CODEC_INVALID_PARAM;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_analysis_cache(aom_codec_alg_priv_t *ctx,
+                                               va_list args) {
+  const char *const filename = va_arg(args, const char *);
+  if (ctx->cpi->common.current_frame.frame_number > 0)
+    return AOM_CODEC_INCAPABLE;
+  if (av1_open_analysis_cache(ctx->cpi, filename)) return AOM_CODEC_ERROR;
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { AV1_COPY_REFERENCE, ctrl_copy_reference },
   { AOME_USE_REFERENCE, ctrl_use_reference },
@@ -2255,6 +2369,12 @@ static aom_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { AV1E_ENABLE_MOTION_VECTOR_UNIT_TEST, ctrl_enable_motion_vector_unit_test },
   { AV1E_SET_TARGET_SEQ_LEVEL_IDX, ctrl_set_target_seq_level_idx },
   { AV1E_SET_TIER_MASK, ctrl_set_tier_mask },
+  { AV1E_SET_SVC_PARAMS, ctrl_set_svc_params },
+  { AV1E_SET_MOTION_HINTS, ctrl_set_motion_hints },
+  { AV1E_SET_ANALYSIS_CACHE, ctrl_set_analysis_cache },
+  { AV1E_SET_ENABLE_SMALL_BORDER, ctrl_set_enable_small_border },
+  { AV1E_SET_STAGE_TIMING, ctrl_set_stage_timing },
+  { AV1E_SET_THREAD_AFFINITY, ctrl_set_thread_affinity },
 
   // Getters
   { AOME_GET_LAST_QUANTIZER, ctrl_get_quantizer },
@@ -2266,6 +2386,8 @@ static aom_codec_ctrl_fn_map_t encoder_ctrl_maps[] = {
   { AV1E_SET_CHROMA_SUBSAMPLING_X, ctrl_set_chroma_subsampling_x },
   { AV1E_SET_CHROMA_SUBSAMPLING_Y, ctrl_set_chroma_subsampling_y },
   { AV1E_GET_SEQ_LEVEL_IDX, ctrl_get_seq_level_idx },
+  { AV1E_GET_SVC_LAYER_ID, ctrl_get_svc_layer_id },
+  { AV1E_GET_STAGE_TIMING, ctrl_get_stage_timing },
   { -1, NULL },
 };
 
@@ -31,6 +31,7 @@
 #include "av1/decoder/decoder.h"
 #include "av1/decoder/decodeframe.h"
 #include "av1/decoder/obu.h"
+#include "av1/decoder/scratch_pool.h"
 
 #include "av1/av1_iface_common.h"
 
@@ -53,6 +54,11 @@ struct aom_codec_alg_priv {
   unsigned int tile_mode;
   unsigned int ext_tile_debug;
   unsigned int row_mt;
+  int fast_preview;
+  int key_frames_only;
+  int low_memory;
+  int output_downscale;
+  int stage_timing;
   EXTERNAL_REFERENCES ext_refs;
   unsigned int is_annexb;
   int operating_point;
@@ -66,6 +72,7 @@ struct aom_codec_alg_priv {
   int next_output_worker_id;
 
   aom_image_t *image_with_grain[MAX_NUM_SPATIAL_LAYERS];
+  aom_image_t *downscaled_image[MAX_NUM_SPATIAL_LAYERS];
   int need_resync;  // wait for key/intra-only frame
   // BufferPool that holds all reference frames. Shared by all the FrameWorkers.
   BufferPool *buffer_pool;
@@ -106,6 +113,8 @@ static aom_codec_err_t decoder_init(aom_codec_ctx_t *ctx,
       priv->cfg.cfg.ext_partition = 1;
     }
     av1_zero(priv->image_with_grain);
+    av1_zero(priv->downscaled_image);
+    priv->output_downscale = 1;
     // Turn row_mt on by default.
     priv->row_mt = 1;
 
@@ -138,6 +147,7 @@ static aom_codec_err_t decoder_destroy(aom_codec_alg_priv_t *ctx) {
 #if CONFIG_MULTITHREAD
     pthread_mutex_destroy(&ctx->buffer_pool->pool_mutex);
 #endif
+    if (ctx->low_memory) av1_scratch_pool_remove_user();
   }
 
   if (ctx->buffer_pool) {
@@ -149,6 +159,7 @@ static aom_codec_err_t decoder_destroy(aom_codec_alg_priv_t *ctx) {
   aom_free(ctx->buffer_pool);
   for (int i = 0; i < MAX_NUM_SPATIAL_LAYERS; i++) {
     if (ctx->image_with_grain[i]) aom_img_free(ctx->image_with_grain[i]);
+    if (ctx->downscaled_image[i]) aom_img_free(ctx->downscaled_image[i]);
   }
   aom_free(ctx);
   return AOM_CODEC_OK;
@@ -459,6 +470,8 @@ static aom_codec_err_t init_decoder(aom_codec_alg_priv_t *ctx) {
     set_error_detail(ctx, "Failed to allocate frame_workers");
     return AOM_CODEC_MEM_ERROR;
   }
+  // Removed by decoder_destroy().
+  if (ctx->low_memory) av1_scratch_pool_add_user();
 
   for (i = 0; i < ctx->num_frame_workers; ++i) {
     AVxWorker *const worker = &ctx->frame_workers[i];
@@ -494,6 +507,10 @@ static aom_codec_err_t init_decoder(aom_codec_alg_priv_t *ctx) {
     frame_worker_data->pbi->output_all_layers = ctx->output_all_layers;
     frame_worker_data->pbi->ext_tile_debug = ctx->ext_tile_debug;
     frame_worker_data->pbi->row_mt = ctx->row_mt;
+    frame_worker_data->pbi->fast_preview = ctx->fast_preview;
+    frame_worker_data->pbi->key_frames_only = ctx->key_frames_only;
+    frame_worker_data->pbi->stage_timing_enabled = ctx->stage_timing;
+    frame_worker_data->pbi->low_memory = ctx->low_memory;
 
     worker->hook = frame_worker_hook;
     // The main thread acts as Frame Worker 0.
@@ -551,6 +568,9 @@ static aom_codec_err_t decode_one(aom_codec_alg_priv_t *ctx,
   frame_worker_data->pbi->dec_tile_col = ctx->decode_tile_col;
   frame_worker_data->pbi->ext_tile_debug = ctx->ext_tile_debug;
   frame_worker_data->pbi->row_mt = ctx->row_mt;
+  frame_worker_data->pbi->fast_preview = ctx->fast_preview;
+  frame_worker_data->pbi->key_frames_only = ctx->key_frames_only;
+  frame_worker_data->pbi->stage_timing_enabled = ctx->stage_timing;
   frame_worker_data->pbi->ext_refs = ctx->ext_refs;
 
   frame_worker_data->pbi->common.is_annexb = ctx->is_annexb;
@@ -649,6 +669,17 @@ static aom_codec_err_t decoder_decode(aom_codec_alg_priv_t *ctx,
     if (res != AOM_CODEC_OK) return res;
   }
 
+  if (ctx->stage_timing) {
+    FrameWorkerData *const frame_worker_data =
+        (FrameWorkerData *)ctx->frame_workers[0].data1;
+    AV1Decoder *const pbi = frame_worker_data->pbi;
+    av1_zero(pbi->stage_timing);
+    for (int i = 0; i < pbi->num_workers; ++i) {
+      pbi->thread_data[i].busy_time_us = 0;
+      pbi->thread_data[i].cpu_time_us = 0;
+    }
+  }
+
   const uint8_t *data_start = data;
   const uint8_t *data_end = data + data_sz;
 
@@ -738,6 +769,88 @@ static aom_image_t *add_grain_if_needed(aom_image_t *img,
   return grain_img_buf;
 }
 
+// Averages each factor x factor block of a src_w x src_h plane into one
+// sample. The blocks at the right and bottom edges may be smaller.
+static void downscale_plane(const uint8_t *src, int src_stride, int src_w,
+                            int src_h, uint8_t *dst, int dst_stride,
+                            int factor, int use_highbitdepth) {
+  for (int y = 0; y * factor < src_h; ++y) {
+    const int rows = AOMMIN(factor, src_h - y * factor);
+    const uint8_t *const src_row = src + y * factor * src_stride;
+    for (int x = 0; x * factor < src_w; ++x) {
+      const int cols = AOMMIN(factor, src_w - x * factor);
+      const int count = rows * cols;
+      int sum = 0;
+      for (int r = 0; r < rows; ++r) {
+        if (use_highbitdepth) {
+          const uint16_t *const s =
+              (const uint16_t *)(src_row + r * src_stride) + x * factor;
+          for (int c = 0; c < cols; ++c) sum += s[c];
+        } else {
+          const uint8_t *const s = src_row + r * src_stride + x * factor;
+          for (int c = 0; c < cols; ++c) sum += s[c];
+        }
+      }
+      const int avg = (sum + count / 2) / count;
+      if (use_highbitdepth)
+        ((uint16_t *)(dst + y * dst_stride))[x] = (uint16_t)avg;
+      else
+        dst[y * dst_stride + x] = (uint8_t)avg;
+    }
+  }
+}
+
+static aom_image_t *downscale_if_needed(aom_image_t *img,
+                                        aom_image_t **scaled_img_ptr,
+                                        int factor) {
+  if (factor == 1) return img;
+
+  aom_image_t *scaled_img = *scaled_img_ptr;
+
+  const unsigned int w = (img->d_w + factor - 1) / factor;
+  const unsigned int h = (img->d_h + factor - 1) / factor;
+
+  if (scaled_img) {
+    if (w != scaled_img->d_w || h != scaled_img->d_h ||
+        img->fmt != scaled_img->fmt) {
+      aom_img_free(scaled_img);
+      scaled_img = NULL;
+      *scaled_img_ptr = NULL;
+    }
+  }
+  if (!scaled_img) {
+    scaled_img = aom_img_alloc(NULL, img->fmt, w, h, 16);
+    *scaled_img_ptr = scaled_img;
+    if (!scaled_img) return NULL;
+  }
+
+  scaled_img->bit_depth = img->bit_depth;
+  scaled_img->r_w = (img->r_w + factor - 1) / factor;
+  scaled_img->r_h = (img->r_h + factor - 1) / factor;
+  scaled_img->cp = img->cp;
+  scaled_img->tc = img->tc;
+  scaled_img->mc = img->mc;
+  scaled_img->monochrome = img->monochrome;
+  scaled_img->csp = img->csp;
+  scaled_img->range = img->range;
+  scaled_img->temporal_id = img->temporal_id;
+  scaled_img->spatial_id = img->spatial_id;
+  scaled_img->user_priv = img->user_priv;
+  scaled_img->fb_priv = img->fb_priv;
+
+  const int use_highbitdepth = (img->fmt & AOM_IMG_FMT_HIGHBITDEPTH) != 0;
+  const int num_planes = img->monochrome ? 1 : 3;
+  for (int plane = 0; plane < num_planes; ++plane) {
+    const int ssx = plane ? img->x_chroma_shift : 0;
+    const int ssy = plane ? img->y_chroma_shift : 0;
+    downscale_plane(img->planes[plane], img->stride[plane],
+                    (img->d_w + ssx) >> ssx, (img->d_h + ssy) >> ssy,
+                    scaled_img->planes[plane], scaled_img->stride[plane],
+                    factor, use_highbitdepth);
+  }
+  return scaled_img;
+}
+
 static aom_image_t *decoder_get_frame(aom_codec_alg_priv_t *ctx,
                                       aom_codec_iter_t *iter) {
   aom_image_t *img = NULL;
@@ -831,11 +944,22 @@ static aom_image_t *decoder_get_frame(aom_codec_alg_priv_t *ctx,
           img->temporal_id = cm->temporal_layer_id;
           img->spatial_id = cm->spatial_layer_id;
           if (cm->skip_film_grain) grain_params->apply_grain = 0;
+          start_dec_stage_timing(pbi, AOM_DEC_STAGE_FILM_GRAIN);
           aom_image_t *res = add_grain_if_needed(
               img, &ctx->image_with_grain[*index], grain_params);
+          end_dec_stage_timing(pbi, AOM_DEC_STAGE_FILM_GRAIN);
           if (!res) {
             aom_internal_error(&pbi->common.error, AOM_CODEC_CORRUPT_FRAME,
                                "Grain systhesis failed\n");
+          } else {
+            start_dec_stage_timing(pbi, AOM_DEC_STAGE_OUTPUT);
+            res = downscale_if_needed(res, &ctx->downscaled_image[*index],
+                                      ctx->output_downscale);
+            end_dec_stage_timing(pbi, AOM_DEC_STAGE_OUTPUT);
+            if (!res) {
+              aom_internal_error(&pbi->common.error, AOM_CODEC_MEM_ERROR,
+                                 "Output downscale failed\n");
+            }
           }
           *index += 1;  // Advance the iterator to point to the next image
           return res;
@@ -1354,6 +1478,82 @@ static aom_codec_err_t ctrl_set_row_mt(aom_codec_alg_priv_t *ctx,
   return AOM_CODEC_OK;
 }
 
+static aom_codec_err_t ctrl_set_fast_preview(aom_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  const int fast_preview = va_arg(args, int);
+  if (fast_preview < FAST_PREVIEW_OFF || fast_preview > FAST_PREVIEW_NO_FILTERS)
+    return AOM_CODEC_INVALID_PARAM;
+  ctx->fast_preview = fast_preview;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_key_frames_only(aom_codec_alg_priv_t *ctx,
+                                                va_list args) {
+  ctx->key_frames_only = va_arg(args, int) != 0;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_output_downscale(aom_codec_alg_priv_t *ctx,
+                                                 va_list args) {
+  const int output_downscale = va_arg(args, int);
+  if (output_downscale != 1 && output_downscale != 2 && output_downscale != 4)
+    return AOM_CODEC_INVALID_PARAM;
+  ctx->output_downscale = output_downscale;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_stage_timing(aom_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  ctx->stage_timing = va_arg(args, int) != 0;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_set_low_memory(aom_codec_alg_priv_t *ctx,
+                                           va_list args) {
+  const int low_memory = va_arg(args, int) != 0;
+  // The buffers are set up for the mode by the first frame.
+  if (ctx->frame_workers != NULL && low_memory != ctx->low_memory)
+    return AOM_CODEC_ERROR;
+  ctx->low_memory = low_memory;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_peak_memory(aom_codec_alg_priv_t *ctx,
+                                            va_list args) {
+  uint64_t *const peak_memory = va_arg(args, uint64_t *);
+  if (peak_memory == NULL) return AOM_CODEC_INVALID_PARAM;
+  *peak_memory = 0;
+  if (ctx->frame_workers == NULL) return AOM_CODEC_OK;
+
+  const FrameWorkerData *const frame_worker_data =
+      (FrameWorkerData *)ctx->frame_workers[0].data1;
+  *peak_memory = frame_worker_data->pbi->peak_memory_usage;
+  return AOM_CODEC_OK;
+}
+
+static aom_codec_err_t ctrl_get_stage_timing(aom_codec_alg_priv_t *ctx,
+                                             va_list args) {
+  aom_dec_stage_timing_t *const timing = va_arg(args, aom_dec_stage_timing_t *);
+  if (timing == NULL) return AOM_CODEC_INVALID_PARAM;
+  memset(timing, 0, sizeof(*timing));
+  if (ctx->frame_workers == NULL || !ctx->stage_timing) return AOM_CODEC_OK;
+
+  const FrameWorkerData *const frame_worker_data =
+      (FrameWorkerData *)ctx->frame_workers[0].data1;
+  const AV1Decoder *const pbi = frame_worker_data->pbi;
+  *timing = pbi->stage_timing;
+  timing->num_workers =
+      AOMMIN(timing->num_workers, AOM_DEC_STAGE_TIMING_MAX_WORKERS);
+  const uint64_t tiles_us = timing->time_us[AOM_DEC_STAGE_TILES];
+  for (int i = 0; i < timing->num_workers; ++i) {
+    const uint64_t busy_us = pbi->thread_data[i].busy_time_us;
+    timing->worker_busy_us[i] = busy_us;
+    timing->worker_idle_us[i] = tiles_us > busy_us ? tiles_us - busy_us : 0;
+    timing->worker_cpu_us[i] = pbi->thread_data[i].cpu_time_us;
+  }
+  return AOM_CODEC_OK;
+}
+
 static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AV1_COPY_REFERENCE, ctrl_copy_reference },
 
@@ -1378,6 +1578,11 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AV1D_SET_ROW_MT, ctrl_set_row_mt },
   { AV1D_SET_EXT_REF_PTR, ctrl_set_ext_ref_ptr },
   { AV1D_SET_SKIP_FILM_GRAIN, ctrl_set_skip_film_grain },
+  { AV1D_SET_FAST_PREVIEW, ctrl_set_fast_preview },
+  { AV1D_SET_KEY_FRAMES_ONLY, ctrl_set_key_frames_only },
+  { AV1D_SET_OUTPUT_DOWNSCALE, ctrl_set_output_downscale },
+  { AV1D_SET_STAGE_TIMING, ctrl_set_stage_timing },
+  { AV1D_SET_LOW_MEMORY, ctrl_set_low_memory },
 
   // Getters
   { AOMD_GET_FRAME_CORRUPTED, ctrl_get_frame_corrupted },
@@ -1395,6 +1600,8 @@ static aom_codec_ctrl_fn_map_t decoder_ctrl_maps[] = {
   { AV1_GET_REFERENCE, ctrl_get_reference },
   { AV1D_GET_FRAME_HEADER_INFO, ctrl_get_frame_header_info },
   { AV1D_GET_TILE_DATA, ctrl_get_tile_data },
+  { AV1D_GET_STAGE_TIMING, ctrl_get_stage_timing },
+  { AV1D_GET_PEAK_MEMORY, ctrl_get_peak_memory },
 
   { -1, NULL },
 };
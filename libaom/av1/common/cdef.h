@@ -42,6 +42,19 @@ int sb_compute_cdef_list(const AV1_COMMON *const cm, int mi_row, int mi_col,
                          cdef_list *dlist, BLOCK_SIZE bsize);
 void av1_cdef_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm, MACROBLOCKD *xd);
 
+// Sets up the planes of 'xd' for 'frame' and allocates the saved lines.
+void av1_cdef_init_frame(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
+                         MACROBLOCKD *xd, CdefLineBuf *linebuf);
+void av1_cdef_free_lines(CdefLineBuf *linebuf);
+// Saves the unfiltered top and bottom CDEF_VBORDER lines of filter block row
+// 'fbr'. Must run before the row and the rows next to it are filtered.
+void av1_cdef_save_fb_row_lines(const AV1_COMMON *cm, const MACROBLOCKD *xd,
+                                const CdefLineBuf *linebuf, int fbr);
+// Filters filter block row 'fbr'. Rows fbr - 1, fbr and fbr + 1 must have been
+// saved.
+void av1_cdef_fb_row(const AV1_COMMON *cm, const MACROBLOCKD *xd,
+                     const CdefLineBuf *linebuf, int fbr);
+
 void av1_cdef_search(YV12_BUFFER_CONFIG *frame, const YV12_BUFFER_CONFIG *ref,
                      AV1_COMMON *cm, MACROBLOCKD *xd, int fast);
 
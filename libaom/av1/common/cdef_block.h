@@ -40,6 +40,13 @@ typedef struct {
   uint8_t bx;
 } cdef_list;
 
+/* Unfiltered lines kept for every filter block row of a frame, so the rows can
+   be filtered in any order once the rows next to them have been saved. */
+typedef struct CdefLineBuf {
+  uint16_t *lines[3];
+  int stride;
+} CdefLineBuf;
+
 typedef void (*cdef_filter_block_func)(uint8_t *dst8, uint16_t *dst16,
                                        int dstride, const uint16_t *in,
                                        int pri_strength, int sec_strength,
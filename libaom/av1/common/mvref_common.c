@@ -949,6 +949,9 @@ static int motion_field_projection(AV1_COMMON *cm,
       start_frame_buf->mi_cols != cm->mi_cols)
     return 0;
 
+  // Not stored by a decoder in low memory mode, see AV1D_SET_LOW_MEMORY.
+  if (start_frame_buf->mvs == NULL) return 0;
+
   const int start_frame_order_hint = start_frame_buf->order_hint;
   const unsigned int *const ref_order_hints =
       &start_frame_buf->ref_order_hints[0];
@@ -1010,11 +1013,15 @@ void av1_setup_motion_field(AV1_COMMON *cm) {
   memset(cm->ref_frame_side, 0, sizeof(cm->ref_frame_side));
   if (!order_hint_info->enable_order_hint) return;
 
+  // A decoder in low memory mode allocates tpl_mvs with the first frame that
+  // uses it.
   TPL_MV_REF *tpl_mvs_base = cm->tpl_mvs;
-  int size = ((cm->mi_rows + MAX_MIB_SIZE) >> 1) * (cm->mi_stride >> 1);
-  for (int idx = 0; idx < size; ++idx) {
-    tpl_mvs_base[idx].mfmv0.as_int = INVALID_MV;
-    tpl_mvs_base[idx].ref_frame_offset = 0;
+  if (tpl_mvs_base) {
+    int size = ((cm->mi_rows + MAX_MIB_SIZE) >> 1) * (cm->mi_stride >> 1);
+    for (int idx = 0; idx < size; ++idx) {
+      tpl_mvs_base[idx].mfmv0.as_int = INVALID_MV;
+      tpl_mvs_base[idx].ref_frame_offset = 0;
+    }
   }
 
   const int cur_order_hint = cm->cur_frame->order_hint;
@@ -1038,6 +1045,8 @@ void av1_setup_motion_field(AV1_COMMON *cm) {
       cm->ref_frame_side[ref_frame] = -1;
   }
 
+  if (tpl_mvs_base == NULL) return;
+
   int ref_stamp = MFMV_STACK_SIZE - 1;
 
   if (ref_buf[LAST_FRAME - LAST_FRAME] != NULL) {
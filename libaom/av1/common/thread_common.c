@@ -9,127 +9,44 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include <assert.h>
+
 #include "config/aom_config.h"
 #include "config/aom_scale_rtcd.h"
 
 #include "aom_dsp/aom_dsp_common.h"
 #include "aom_mem/aom_mem.h"
 #include "av1/common/av1_loopfilter.h"
+#include "av1/common/cdef.h"
 #include "av1/common/entropymode.h"
 #include "av1/common/thread_common.h"
 #include "av1/common/reconinter.h"
 
-// Set up nsync by width.
-static INLINE int get_sync_range(int width) {
-  // nsync numbers are picked by testing. For example, for 4k
-  // video, using 4 gives best performance.
-  if (width < 640)
-    return 1;
-  else if (width <= 1280)
-    return 2;
-  else if (width <= 4096)
-    return 4;
-  else
-    return 8;
-}
-
-static INLINE int get_lr_sync_range(int width) {
-#if 0
-  // nsync numbers are picked by testing. For example, for 4k
-  // video, using 4 gives best performance.
-  if (width < 640)
-    return 1;
-  else if (width <= 1280)
-    return 2;
-  else if (width <= 4096)
-    return 4;
-  else
-    return 8;
-#else
-  (void)width;
-  return 1;
-#endif
-}
-
-// Allocate memory for lf row synchronization
+// Allocate memory for lf row jobs. Keeps the graph, which may hold other jobs.
 static void loop_filter_alloc(AV1LfSync *lf_sync, AV1_COMMON *cm, int rows,
-                              int width, int num_workers) {
-  lf_sync->rows = rows;
-#if CONFIG_MULTITHREAD
-  {
-    int i, j;
-
-    for (j = 0; j < MAX_MB_PLANE; j++) {
-      CHECK_MEM_ERROR(cm, lf_sync->mutex_[j],
-                      aom_malloc(sizeof(*(lf_sync->mutex_[j])) * rows));
-      if (lf_sync->mutex_[j]) {
-        for (i = 0; i < rows; ++i) {
-          pthread_mutex_init(&lf_sync->mutex_[j][i], NULL);
-        }
-      }
+                              int num_workers) {
+  aom_free(lf_sync->lfdata);
+  aom_free(lf_sync->job_queue);
+  lf_sync->lfdata = NULL;
+  lf_sync->job_queue = NULL;
+  lf_sync->rows = 0;
+  lf_sync->num_workers = 0;
 
-      CHECK_MEM_ERROR(cm, lf_sync->cond_[j],
-                      aom_malloc(sizeof(*(lf_sync->cond_[j])) * rows));
-      if (lf_sync->cond_[j]) {
-        for (i = 0; i < rows; ++i) {
-          pthread_cond_init(&lf_sync->cond_[j][i], NULL);
-        }
-      }
-    }
-
-    CHECK_MEM_ERROR(cm, lf_sync->job_mutex,
-                    aom_malloc(sizeof(*(lf_sync->job_mutex))));
-    if (lf_sync->job_mutex) {
-      pthread_mutex_init(lf_sync->job_mutex, NULL);
-    }
-  }
-#endif  // CONFIG_MULTITHREAD
   CHECK_MEM_ERROR(cm, lf_sync->lfdata,
                   aom_malloc(num_workers * sizeof(*(lf_sync->lfdata))));
-  lf_sync->num_workers = num_workers;
-
-  for (int j = 0; j < MAX_MB_PLANE; j++) {
-    CHECK_MEM_ERROR(cm, lf_sync->cur_sb_col[j],
-                    aom_malloc(sizeof(*(lf_sync->cur_sb_col[j])) * rows));
-  }
   CHECK_MEM_ERROR(
       cm, lf_sync->job_queue,
       aom_malloc(sizeof(*(lf_sync->job_queue)) * rows * MAX_MB_PLANE * 2));
-  // Set up nsync.
-  lf_sync->sync_range = get_sync_range(width);
+  lf_sync->rows = rows;
+  lf_sync->num_workers = num_workers;
 }
 
-// Deallocate lf synchronization related mutex and data
+// Deallocate lf row jobs and data
 void av1_loop_filter_dealloc(AV1LfSync *lf_sync) {
   if (lf_sync != NULL) {
-    int j;
-#if CONFIG_MULTITHREAD
-    int i;
-    for (j = 0; j < MAX_MB_PLANE; j++) {
-      if (lf_sync->mutex_[j] != NULL) {
-        for (i = 0; i < lf_sync->rows; ++i) {
-          pthread_mutex_destroy(&lf_sync->mutex_[j][i]);
-        }
-        aom_free(lf_sync->mutex_[j]);
-      }
-      if (lf_sync->cond_[j] != NULL) {
-        for (i = 0; i < lf_sync->rows; ++i) {
-          pthread_cond_destroy(&lf_sync->cond_[j][i]);
-        }
-        aom_free(lf_sync->cond_[j]);
-      }
-    }
-    if (lf_sync->job_mutex != NULL) {
-      pthread_mutex_destroy(lf_sync->job_mutex);
-      aom_free(lf_sync->job_mutex);
-    }
-#endif  // CONFIG_MULTITHREAD
     aom_free(lf_sync->lfdata);
-    for (j = 0; j < MAX_MB_PLANE; j++) {
-      aom_free(lf_sync->cur_sb_col[j]);
-    }
-
     aom_free(lf_sync->job_queue);
+    aom_task_graph_free(&lf_sync->graph);
     // clear the structure as the source of this call may be a resize in which
     // case this call will be followed by an _alloc() which may fail.
     av1_zero(*lf_sync);
@@ -150,70 +67,12 @@ static void loop_filter_data_reset(LFWorkerData *lf_data,
   }
 }
 
-static INLINE void sync_read(AV1LfSync *const lf_sync, int r, int c,
-                             int plane) {
-#if CONFIG_MULTITHREAD
-  const int nsync = lf_sync->sync_range;
-
-  if (r && !(c & (nsync - 1))) {
-    pthread_mutex_t *const mutex = &lf_sync->mutex_[plane][r - 1];
-    pthread_mutex_lock(mutex);
-
-    while (c > lf_sync->cur_sb_col[plane][r - 1] - nsync) {
-      pthread_cond_wait(&lf_sync->cond_[plane][r - 1], mutex);
-    }
-    pthread_mutex_unlock(mutex);
-  }
-#else
-  (void)lf_sync;
-  (void)r;
-  (void)c;
-  (void)plane;
-#endif  // CONFIG_MULTITHREAD
-}
-
-static INLINE void sync_write(AV1LfSync *const lf_sync, int r, int c,
-                              const int sb_cols, int plane) {
-#if CONFIG_MULTITHREAD
-  const int nsync = lf_sync->sync_range;
-  int cur;
-  // Only signal when there are enough filtered SB for next row to run.
-  int sig = 1;
-
-  if (c < sb_cols - 1) {
-    cur = c;
-    if (c % nsync) sig = 0;
-  } else {
-    cur = sb_cols + nsync;
-  }
-
-  if (sig) {
-    pthread_mutex_lock(&lf_sync->mutex_[plane][r]);
-
-    lf_sync->cur_sb_col[plane][r] = cur;
-
-    pthread_cond_broadcast(&lf_sync->cond_[plane][r]);
-    pthread_mutex_unlock(&lf_sync->mutex_[plane][r]);
-  }
-#else
-  (void)lf_sync;
-  (void)r;
-  (void)c;
-  (void)sb_cols;
-  (void)plane;
-#endif  // CONFIG_MULTITHREAD
-}
-
 static void enqueue_lf_jobs(AV1LfSync *lf_sync, AV1_COMMON *cm, int start,
-                            int stop,
-#if LOOP_FILTER_BITMASK
-                            int is_decoding,
-#endif
-                            int plane_start, int plane_end) {
+                            int stop, int step, int plane_start,
+                            int plane_end) {
   int mi_row, plane, dir;
   AV1LfMTInfo *lf_job_queue = lf_sync->job_queue;
   lf_sync->jobs_enqueued = 0;
-  lf_sync->jobs_dequeued = 0;
 
   for (dir = 0; dir < 2; dir++) {
     for (plane = plane_start; plane < plane_end; plane++) {
@@ -223,16 +82,7 @@ static void enqueue_lf_jobs(AV1LfSync *lf_sync, AV1_COMMON *cm, int start,
         continue;
       else if (plane == 2 && !(cm->lf.filter_level_v))
         continue;
-#if LOOP_FILTER_BITMASK
-      int step = MAX_MIB_SIZE;
-      if (is_decoding) {
-        step = MI_SIZE_64X64;
-      }
-      for (mi_row = start; mi_row < stop; mi_row += step)
-#else
-      for (mi_row = start; mi_row < stop; mi_row += MAX_MIB_SIZE)
-#endif
-      {
+      for (mi_row = start; mi_row < stop; mi_row += step) {
         lf_job_queue->mi_row = mi_row;
         lf_job_queue->plane = plane;
         lf_job_queue->dir = dir;
@@ -243,229 +93,144 @@ static void enqueue_lf_jobs(AV1LfSync *lf_sync, AV1_COMMON *cm, int start,
   }
 }
 
-static AV1LfMTInfo *get_lf_job_info(AV1LfSync *lf_sync) {
-  AV1LfMTInfo *cur_job_info = NULL;
-
-#if CONFIG_MULTITHREAD
-  pthread_mutex_lock(lf_sync->job_mutex);
-
-  if (lf_sync->jobs_dequeued < lf_sync->jobs_enqueued) {
-    cur_job_info = lf_sync->job_queue + lf_sync->jobs_dequeued;
-    lf_sync->jobs_dequeued++;
+// Loop filters one superblock row of a plane in one direction.
+static int loop_filter_task(void *arg1, void *arg2, int thread_id) {
+  const AV1LfMTInfo *const job = (const AV1LfMTInfo *)arg1;
+  LFWorkerData *const lf_data = &((AV1LfSync *)arg2)->lfdata[thread_id];
+  AV1_COMMON *const cm = lf_data->cm;
+  struct macroblockd_plane *const planes = lf_data->planes;
+  const int mi_row = job->mi_row;
+  const int plane = job->plane;
+
+  for (int mi_col = 0; mi_col < cm->mi_cols; mi_col += MAX_MIB_SIZE) {
+    av1_setup_dst_planes(planes, cm->seq_params.sb_size, lf_data->frame_buffer,
+                         mi_row, mi_col, plane, plane + 1);
+    if (job->dir == 0) {
+      av1_filter_block_plane_vert(cm, lf_data->xd, plane, &planes[plane],
+                                  mi_row, mi_col);
+    } else {
+      av1_filter_block_plane_horz(cm, lf_data->xd, plane, &planes[plane],
+                                  mi_row, mi_col);
+    }
   }
-
-  pthread_mutex_unlock(lf_sync->job_mutex);
-#else
-  (void)lf_sync;
-#endif
-
-  return cur_job_info;
+  return 1;
 }
 
-// Implement row loopfiltering for each thread.
-static INLINE void thread_loop_filter_rows(
-    const YV12_BUFFER_CONFIG *const frame_buffer, AV1_COMMON *const cm,
-    struct macroblockd_plane *planes, MACROBLOCKD *xd,
-    AV1LfSync *const lf_sync) {
-  const int sb_cols =
-      ALIGN_POWER_OF_TWO(cm->mi_cols, MAX_MIB_SIZE_LOG2) >> MAX_MIB_SIZE_LOG2;
-  int mi_row, mi_col, plane, dir;
-  int r, c;
-
-  while (1) {
-    AV1LfMTInfo *cur_job_info = get_lf_job_info(lf_sync);
-
-    if (cur_job_info != NULL) {
-      mi_row = cur_job_info->mi_row;
-      plane = cur_job_info->plane;
-      dir = cur_job_info->dir;
-      r = mi_row >> MAX_MIB_SIZE_LOG2;
-
-      if (dir == 0) {
-        for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MAX_MIB_SIZE) {
-          c = mi_col >> MAX_MIB_SIZE_LOG2;
-
-          av1_setup_dst_planes(planes, cm->seq_params.sb_size, frame_buffer,
-                               mi_row, mi_col, plane, plane + 1);
-
-          av1_filter_block_plane_vert(cm, xd, plane, &planes[plane], mi_row,
-                                      mi_col);
-          sync_write(lf_sync, r, c, sb_cols, plane);
-        }
-      } else if (dir == 1) {
-        for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MAX_MIB_SIZE) {
-          c = mi_col >> MAX_MIB_SIZE_LOG2;
-
-          // Wait for vertical edge filtering of the top-right block to be
-          // completed
-          sync_read(lf_sync, r, c, plane);
-
-          // Wait for vertical edge filtering of the right block to be
-          // completed
-          sync_read(lf_sync, r + 1, c, plane);
-
-          av1_setup_dst_planes(planes, cm->seq_params.sb_size, frame_buffer,
-                               mi_row, mi_col, plane, plane + 1);
-          av1_filter_block_plane_horz(cm, xd, plane, &planes[plane], mi_row,
-                                      mi_col);
-        }
-      }
+#if LOOP_FILTER_BITMASK
+static int loop_filter_bitmask_task(void *arg1, void *arg2, int thread_id) {
+  const AV1LfMTInfo *const job = (const AV1LfMTInfo *)arg1;
+  LFWorkerData *const lf_data = &((AV1LfSync *)arg2)->lfdata[thread_id];
+  AV1_COMMON *const cm = lf_data->cm;
+  struct macroblockd_plane *const planes = lf_data->planes;
+  const int mi_row = job->mi_row;
+  const int plane = job->plane;
+
+  for (int mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_SIZE_64X64) {
+    av1_setup_dst_planes(planes, BLOCK_64X64, lf_data->frame_buffer, mi_row,
+                         mi_col, plane, plane + 1);
+    if (job->dir == 0) {
+      av1_filter_block_plane_bitmask_vert(cm, &planes[plane], plane, mi_row,
+                                          mi_col);
     } else {
-      break;
+      av1_filter_block_plane_bitmask_horz(cm, &planes[plane], plane, mi_row,
+                                          mi_col);
     }
   }
-}
-
-// Row-based multi-threaded loopfilter hook
-static int loop_filter_row_worker(void *arg1, void *arg2) {
-  AV1LfSync *const lf_sync = (AV1LfSync *)arg1;
-  LFWorkerData *const lf_data = (LFWorkerData *)arg2;
-  thread_loop_filter_rows(lf_data->frame_buffer, lf_data->cm, lf_data->planes,
-                          lf_data->xd, lf_sync);
   return 1;
 }
+#endif  // LOOP_FILTER_BITMASK
 
+// Sets up the row jobs of the rows [start, stop) of the frame and adds them to
+// 'graph'. The horizontal edges of a row are filtered after the vertical edges
+// of the row and of the row above.
+static void add_lf_tasks(AomTaskGraph *graph, YV12_BUFFER_CONFIG *frame,
+                         AV1_COMMON *cm, MACROBLOCKD *xd, int start, int stop,
+                         int plane_start, int plane_end, int is_bitmask,
+                         const int *tile_row_tasks, int num_workers,
+                         AV1LfSync *lf_sync) {
+  const int step_log2 = is_bitmask ? MIN_MIB_SIZE_LOG2 : MAX_MIB_SIZE_LOG2;
+  const int rows = ALIGN_POWER_OF_TWO(cm->mi_rows, step_log2) >> step_log2;
+  const int mib_size_log2 = cm->seq_params.mib_size_log2;
+  AomTaskHook hook = loop_filter_task;
+  int num_vert_jobs;
 #if LOOP_FILTER_BITMASK
-static INLINE void thread_loop_filter_bitmask_rows(
-    const YV12_BUFFER_CONFIG *const frame_buffer, AV1_COMMON *const cm,
-    struct macroblockd_plane *planes, MACROBLOCKD *xd,
-    AV1LfSync *const lf_sync) {
-  const int sb_cols =
-      ALIGN_POWER_OF_TWO(cm->mi_cols, MIN_MIB_SIZE_LOG2) >> MIN_MIB_SIZE_LOG2;
-  int mi_row, mi_col, plane, dir;
-  int r, c;
-  (void)xd;
-
-  while (1) {
-    AV1LfMTInfo *cur_job_info = get_lf_job_info(lf_sync);
-
-    if (cur_job_info != NULL) {
-      mi_row = cur_job_info->mi_row;
-      plane = cur_job_info->plane;
-      dir = cur_job_info->dir;
-      r = mi_row >> MIN_MIB_SIZE_LOG2;
-
-      if (dir == 0) {
-        for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_SIZE_64X64) {
-          c = mi_col >> MIN_MIB_SIZE_LOG2;
-
-          av1_setup_dst_planes(planes, BLOCK_64X64, frame_buffer, mi_row,
-                               mi_col, plane, plane + 1);
-
-          av1_filter_block_plane_bitmask_vert(cm, &planes[plane], plane, mi_row,
-                                              mi_col);
-          sync_write(lf_sync, r, c, sb_cols, plane);
-        }
-      } else if (dir == 1) {
-        for (mi_col = 0; mi_col < cm->mi_cols; mi_col += MI_SIZE_64X64) {
-          c = mi_col >> MIN_MIB_SIZE_LOG2;
-
-          // Wait for vertical edge filtering of the top-right block to be
-          // completed
-          sync_read(lf_sync, r, c, plane);
-
-          // Wait for vertical edge filtering of the right block to be
-          // completed
-          sync_read(lf_sync, r + 1, c, plane);
-
-          av1_setup_dst_planes(planes, BLOCK_64X64, frame_buffer, mi_row,
-                               mi_col, plane, plane + 1);
-          av1_filter_block_plane_bitmask_horz(cm, &planes[plane], plane, mi_row,
-                                              mi_col);
+  if (is_bitmask) hook = loop_filter_bitmask_task;
+#endif
+
+  if (rows != lf_sync->rows || num_workers > lf_sync->num_workers) {
+    loop_filter_alloc(lf_sync, cm, rows, num_workers);
+  }
+  enqueue_lf_jobs(lf_sync, cm, start, stop, 1 << step_log2, plane_start,
+                  plane_end);
+  for (int i = 0; i < num_workers; ++i) {
+    loop_filter_data_reset(&lf_sync->lfdata[i], frame, cm, xd);
+  }
+
+  // The jobs of both directions cover the same planes and rows.
+  num_vert_jobs = lf_sync->jobs_enqueued / 2;
+  for (int i = 0; i < lf_sync->jobs_enqueued; ++i) {
+    const AV1LfMTInfo *const job = &lf_sync->job_queue[i];
+    const int task = aom_task_graph_add(graph, hook, (void *)job, lf_sync);
+    if (job->dir == 0) {
+      if (tile_row_tasks == NULL) continue;
+      for (int tile_row = 0; tile_row < cm->tile_rows; ++tile_row) {
+        const int tile_start = cm->tile_row_start_sb[tile_row] << mib_size_log2;
+        const int tile_end = cm->tile_row_start_sb[tile_row + 1]
+                             << mib_size_log2;
+        if (tile_start < job->mi_row + (1 << step_log2) &&
+            tile_end > job->mi_row) {
+          aom_task_graph_add_dependency(graph, tile_row_tasks[tile_row], task);
         }
       }
     } else {
-      break;
+      aom_task_graph_add_dependency(graph, task - num_vert_jobs, task);
+      if (job->mi_row > start) {
+        assert(lf_sync->job_queue[i - num_vert_jobs - 1].plane == job->plane);
+        aom_task_graph_add_dependency(graph, task - num_vert_jobs - 1, task);
+      }
     }
   }
 }
 
-// Row-based multi-threaded loopfilter hook
-static int loop_filter_bitmask_row_worker(void *arg1, void *arg2) {
-  AV1LfSync *const lf_sync = (AV1LfSync *)arg1;
-  LFWorkerData *const lf_data = (LFWorkerData *)arg2;
-  thread_loop_filter_bitmask_rows(lf_data->frame_buffer, lf_data->cm,
-                                  lf_data->planes, lf_data->xd, lf_sync);
-  return 1;
-}
-#endif  // LOOP_FILTER_BITMASK
-
 static void loop_filter_rows_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
                                 MACROBLOCKD *xd, int start, int stop,
-                                int plane_start, int plane_end,
-#if LOOP_FILTER_BITMASK
-                                int is_decoding,
-#endif
-                                AVxWorker *workers, int nworkers,
+                                int plane_start, int plane_end, int is_bitmask,
+                                AVxWorker *workers, int num_workers,
                                 AV1LfSync *lf_sync) {
-  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
-#if LOOP_FILTER_BITMASK
-  int sb_rows;
-  if (is_decoding) {
-    sb_rows =
-        ALIGN_POWER_OF_TWO(cm->mi_rows, MIN_MIB_SIZE_LOG2) >> MIN_MIB_SIZE_LOG2;
-  } else {
-    sb_rows =
-        ALIGN_POWER_OF_TWO(cm->mi_rows, MAX_MIB_SIZE_LOG2) >> MAX_MIB_SIZE_LOG2;
-  }
-#else
-  // Number of superblock rows and cols
   const int sb_rows =
-      ALIGN_POWER_OF_TWO(cm->mi_rows, MAX_MIB_SIZE_LOG2) >> MAX_MIB_SIZE_LOG2;
-#endif
-  const int num_workers = nworkers;
-  int i;
+      ALIGN_POWER_OF_TWO(cm->mi_rows, MIN_MIB_SIZE_LOG2) >> MIN_MIB_SIZE_LOG2;
 
-  if (!lf_sync->sync_range || sb_rows != lf_sync->rows ||
-      num_workers > lf_sync->num_workers) {
-    av1_loop_filter_dealloc(lf_sync);
-    loop_filter_alloc(lf_sync, cm, sb_rows, cm->width, num_workers);
+  if (!aom_task_graph_alloc(&lf_sync->graph, 2 * MAX_MB_PLANE * sb_rows,
+                            3 * MAX_MB_PLANE * sb_rows, num_workers)) {
+    aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                       "Failed to allocate lf_sync->graph");
   }
+  add_lf_tasks(&lf_sync->graph, frame, cm, xd, start, stop, plane_start,
+               plane_end, is_bitmask, NULL, num_workers, lf_sync);
+  aom_task_graph_run(&lf_sync->graph, workers, num_workers,
+                     num_workers - 1);
+}
 
-  // Initialize cur_sb_col to -1 for all SB rows.
-  for (i = 0; i < MAX_MB_PLANE; i++) {
-    memset(lf_sync->cur_sb_col[i], -1,
-           sizeof(*(lf_sync->cur_sb_col[i])) * sb_rows);
-  }
-
-  enqueue_lf_jobs(lf_sync, cm, start, stop,
-#if LOOP_FILTER_BITMASK
-                  is_decoding,
-#endif
-                  plane_start, plane_end);
-
-  // Set up loopfilter thread data.
-  for (i = 0; i < num_workers; ++i) {
-    AVxWorker *const worker = &workers[i];
-    LFWorkerData *const lf_data = &lf_sync->lfdata[i];
-
-#if LOOP_FILTER_BITMASK
-    if (is_decoding) {
-      worker->hook = loop_filter_bitmask_row_worker;
-    } else {
-      worker->hook = loop_filter_row_worker;
-    }
-#else
-    worker->hook = loop_filter_row_worker;
-#endif
-    worker->data1 = lf_sync;
-    worker->data2 = lf_data;
-
-    // Loopfilter data
-    loop_filter_data_reset(lf_data, frame, cm, xd);
+int av1_loop_filter_max_tasks(const AV1_COMMON *cm) {
+  const int sb_rows =
+      ALIGN_POWER_OF_TWO(cm->mi_rows, MAX_MIB_SIZE_LOG2) >> MAX_MIB_SIZE_LOG2;
+  return 2 * MAX_MB_PLANE * sb_rows;
+}
 
-    // Start loopfiltering
-    if (i == num_workers - 1) {
-      winterface->execute(worker);
-    } else {
-      winterface->launch(worker);
-    }
-  }
+int av1_loop_filter_max_task_deps(const AV1_COMMON *cm) {
+  const int sb_rows =
+      ALIGN_POWER_OF_TWO(cm->mi_rows, MAX_MIB_SIZE_LOG2) >> MAX_MIB_SIZE_LOG2;
+  return MAX_MB_PLANE * (3 * sb_rows + cm->tile_rows);
+}
 
-  // Wait till all rows are finished
-  for (i = 0; i < num_workers; ++i) {
-    winterface->sync(&workers[i]);
-  }
+void av1_loop_filter_add_tasks(AomTaskGraph *graph, YV12_BUFFER_CONFIG *frame,
+                               AV1_COMMON *cm, MACROBLOCKD *xd,
+                               int plane_start, int plane_end,
+                               const int *tile_row_tasks, int num_workers,
+                               AV1LfSync *lf_sync) {
+  av1_loop_filter_frame_init(cm, plane_start, plane_end);
+  add_lf_tasks(graph, frame, cm, xd, 0, cm->mi_rows, plane_start, plane_end, 0,
+               tile_row_tasks, num_workers, lf_sync);
 }
 
 void av1_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
@@ -517,100 +282,87 @@ void av1_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
   }
 #else
   loop_filter_rows_mt(frame, cm, xd, start_mi_row, end_mi_row, plane_start,
-                      plane_end, workers, num_workers, lf_sync);
+                      plane_end, 0, workers, num_workers, lf_sync);
 #endif
 }
 
-static INLINE void lr_sync_read(void *const lr_sync, int r, int c, int plane) {
-#if CONFIG_MULTITHREAD
-  AV1LrSync *const loop_res_sync = (AV1LrSync *)lr_sync;
-  const int nsync = loop_res_sync->sync_range;
+typedef struct {
+  AV1_COMMON *cm;
+  MACROBLOCKD *xd;
+  AV1CdefSync *cdef_sync;
+} CdefTaskData;
+
+// Saves the unfiltered border lines of one filter block row.
+static int cdef_save_lines_task(void *arg1, void *arg2, int thread_id) {
+  const CdefTaskData *const data = (const CdefTaskData *)arg2;
+  (void)thread_id;
+  av1_cdef_save_fb_row_lines(data->cm, data->xd, &data->cdef_sync->linebuf,
+                             *(const int *)arg1);
+  return 1;
+}
 
-  if (r && !(c & (nsync - 1))) {
-    pthread_mutex_t *const mutex = &loop_res_sync->mutex_[plane][r - 1];
-    pthread_mutex_lock(mutex);
+// Filters one filter block row.
+static int cdef_row_task(void *arg1, void *arg2, int thread_id) {
+  const CdefTaskData *const data = (const CdefTaskData *)arg2;
+  (void)thread_id;
+  av1_cdef_fb_row(data->cm, data->xd, &data->cdef_sync->linebuf,
+                  *(const int *)arg1);
+  return 1;
+}
 
-    while (c > loop_res_sync->cur_sb_col[plane][r - 1] - nsync) {
-      pthread_cond_wait(&loop_res_sync->cond_[plane][r - 1], mutex);
+void av1_cdef_frame_mt(YV12_BUFFER_CONFIG *frame, AV1_COMMON *cm,
+                       MACROBLOCKD *xd, AVxWorker *workers, int num_workers,
+                       AV1CdefSync *cdef_sync) {
+  const int nvfb = (cm->mi_rows + MI_SIZE_64X64 - 1) / MI_SIZE_64X64;
+  CdefTaskData data = { cm, xd, cdef_sync };
+
+  if (nvfb != cdef_sync->num_rows) {
+    aom_free(cdef_sync->rows);
+    cdef_sync->num_rows = 0;
+    CHECK_MEM_ERROR(cm, cdef_sync->rows,
+                    aom_malloc(sizeof(*cdef_sync->rows) * nvfb));
+    for (int fbr = 0; fbr < nvfb; ++fbr) cdef_sync->rows[fbr] = fbr;
+    cdef_sync->num_rows = nvfb;
+  }
+  if (!aom_task_graph_alloc(&cdef_sync->graph, 2 * nvfb, 3 * nvfb,
+                            num_workers)) {
+    aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                       "Failed to allocate cdef_sync->graph");
+  }
+  av1_cdef_init_frame(frame, cm, xd, &cdef_sync->linebuf);
+
+  // Task fbr saves the lines of row fbr and task nvfb + fbr filters the row,
+  // which reads the saved lines of the rows above and below it.
+  for (int fbr = 0; fbr < nvfb; ++fbr) {
+    aom_task_graph_add(&cdef_sync->graph, cdef_save_lines_task,
+                       &cdef_sync->rows[fbr], &data);
+  }
+  for (int fbr = 0; fbr < nvfb; ++fbr) {
+    const int task = aom_task_graph_add(&cdef_sync->graph, cdef_row_task,
+                                        &cdef_sync->rows[fbr], &data);
+    for (int r = AOMMAX(fbr - 1, 0); r <= AOMMIN(fbr + 1, nvfb - 1); ++r) {
+      aom_task_graph_add_dependency(&cdef_sync->graph, r, task);
     }
-    pthread_mutex_unlock(mutex);
   }
-#else
-  (void)lr_sync;
-  (void)r;
-  (void)c;
-  (void)plane;
-#endif  // CONFIG_MULTITHREAD
+  aom_task_graph_run(&cdef_sync->graph, workers, num_workers, num_workers - 1);
+  av1_cdef_free_lines(&cdef_sync->linebuf);
 }
 
-static INLINE void lr_sync_write(void *const lr_sync, int r, int c,
-                                 const int sb_cols, int plane) {
-#if CONFIG_MULTITHREAD
-  AV1LrSync *const loop_res_sync = (AV1LrSync *)lr_sync;
-  const int nsync = loop_res_sync->sync_range;
-  int cur;
-  // Only signal when there are enough filtered SB for next row to run.
-  int sig = 1;
-
-  if (c < sb_cols - 1) {
-    cur = c;
-    if (c % nsync) sig = 0;
-  } else {
-    cur = sb_cols + nsync;
-  }
-
-  if (sig) {
-    pthread_mutex_lock(&loop_res_sync->mutex_[plane][r]);
-
-    loop_res_sync->cur_sb_col[plane][r] = cur;
-
-    pthread_cond_broadcast(&loop_res_sync->cond_[plane][r]);
-    pthread_mutex_unlock(&loop_res_sync->mutex_[plane][r]);
+void av1_cdef_dealloc(AV1CdefSync *cdef_sync) {
+  if (cdef_sync != NULL) {
+    aom_free(cdef_sync->rows);
+    av1_cdef_free_lines(&cdef_sync->linebuf);
+    aom_task_graph_free(&cdef_sync->graph);
+    av1_zero(*cdef_sync);
   }
-#else
-  (void)lr_sync;
-  (void)r;
-  (void)c;
-  (void)sb_cols;
-  (void)plane;
-#endif  // CONFIG_MULTITHREAD
 }
 
-// Allocate memory for loop restoration row synchronization
+// Allocate memory for loop restoration row jobs
 static void loop_restoration_alloc(AV1LrSync *lr_sync, AV1_COMMON *cm,
                                    int num_workers, int num_rows_lr,
-                                   int num_planes, int width) {
+                                   int num_planes) {
   lr_sync->rows = num_rows_lr;
   lr_sync->num_planes = num_planes;
-#if CONFIG_MULTITHREAD
-  {
-    int i, j;
-
-    for (j = 0; j < num_planes; j++) {
-      CHECK_MEM_ERROR(cm, lr_sync->mutex_[j],
-                      aom_malloc(sizeof(*(lr_sync->mutex_[j])) * num_rows_lr));
-      if (lr_sync->mutex_[j]) {
-        for (i = 0; i < num_rows_lr; ++i) {
-          pthread_mutex_init(&lr_sync->mutex_[j][i], NULL);
-        }
-      }
-
-      CHECK_MEM_ERROR(cm, lr_sync->cond_[j],
-                      aom_malloc(sizeof(*(lr_sync->cond_[j])) * num_rows_lr));
-      if (lr_sync->cond_[j]) {
-        for (i = 0; i < num_rows_lr; ++i) {
-          pthread_cond_init(&lr_sync->cond_[j][i], NULL);
-        }
-      }
-    }
-
-    CHECK_MEM_ERROR(cm, lr_sync->job_mutex,
-                    aom_malloc(sizeof(*(lr_sync->job_mutex))));
-    if (lr_sync->job_mutex) {
-      pthread_mutex_init(lr_sync->job_mutex, NULL);
-    }
-  }
-#endif  // CONFIG_MULTITHREAD
   CHECK_MEM_ERROR(cm, lr_sync->lrworkerdata,
                   aom_malloc(num_workers * sizeof(*(lr_sync->lrworkerdata))));
 
@@ -629,47 +381,14 @@ static void loop_restoration_alloc(AV1LrSync *lr_sync, AV1_COMMON *cm,
 
   lr_sync->num_workers = num_workers;
 
-  for (int j = 0; j < num_planes; j++) {
-    CHECK_MEM_ERROR(
-        cm, lr_sync->cur_sb_col[j],
-        aom_malloc(sizeof(*(lr_sync->cur_sb_col[j])) * num_rows_lr));
-  }
   CHECK_MEM_ERROR(
       cm, lr_sync->job_queue,
       aom_malloc(sizeof(*(lr_sync->job_queue)) * num_rows_lr * num_planes));
-  // Set up nsync.
-  lr_sync->sync_range = get_lr_sync_range(width);
 }
 
-// Deallocate loop restoration synchronization related mutex and data
+// Deallocate loop restoration row jobs and data
 void av1_loop_restoration_dealloc(AV1LrSync *lr_sync, int num_workers) {
   if (lr_sync != NULL) {
-    int j;
-#if CONFIG_MULTITHREAD
-    int i;
-    for (j = 0; j < MAX_MB_PLANE; j++) {
-      if (lr_sync->mutex_[j] != NULL) {
-        for (i = 0; i < lr_sync->rows; ++i) {
-          pthread_mutex_destroy(&lr_sync->mutex_[j][i]);
-        }
-        aom_free(lr_sync->mutex_[j]);
-      }
-      if (lr_sync->cond_[j] != NULL) {
-        for (i = 0; i < lr_sync->rows; ++i) {
-          pthread_cond_destroy(&lr_sync->cond_[j][i]);
-        }
-        aom_free(lr_sync->cond_[j]);
-      }
-    }
-    if (lr_sync->job_mutex != NULL) {
-      pthread_mutex_destroy(lr_sync->job_mutex);
-      aom_free(lr_sync->job_mutex);
-    }
-#endif  // CONFIG_MULTITHREAD
-    for (j = 0; j < MAX_MB_PLANE; j++) {
-      aom_free(lr_sync->cur_sb_col[j]);
-    }
-
     aom_free(lr_sync->job_queue);
 
     if (lr_sync->lrworkerdata) {
@@ -682,6 +401,7 @@ void av1_loop_restoration_dealloc(AV1LrSync *lr_sync, int num_workers) {
       }
       aom_free(lr_sync->lrworkerdata);
     }
+    aom_task_graph_free(&lr_sync->graph);
 
     // clear the structure as the source of this call may be a resize in which
     // case this call will be followed by an _alloc() which may fail.
@@ -697,7 +417,6 @@ static void enqueue_lr_jobs(AV1LrSync *lr_sync, AV1LrStruct *lr_ctxt,
   AV1LrMTInfo *lr_job_queue = lr_sync->job_queue;
   int32_t lr_job_counter[2], num_even_lr_jobs = 0;
   lr_sync->jobs_enqueued = 0;
-  lr_sync->jobs_dequeued = 0;
 
   for (int plane = 0; plane < num_planes; plane++) {
     if (cm->rst_info[plane].frame_restoration_type == RESTORE_NONE) continue;
@@ -767,33 +486,15 @@ static void enqueue_lr_jobs(AV1LrSync *lr_sync, AV1LrStruct *lr_ctxt,
   }
 }
 
-static AV1LrMTInfo *get_lr_job_info(AV1LrSync *lr_sync) {
-  AV1LrMTInfo *cur_job_info = NULL;
-
-#if CONFIG_MULTITHREAD
-  pthread_mutex_lock(lr_sync->job_mutex);
-
-  if (lr_sync->jobs_dequeued < lr_sync->jobs_enqueued) {
-    cur_job_info = lr_sync->job_queue + lr_sync->jobs_dequeued;
-    lr_sync->jobs_dequeued++;
-  }
-
-  pthread_mutex_unlock(lr_sync->job_mutex);
-#else
-  (void)lr_sync;
-#endif
-
-  return cur_job_info;
-}
-
-// Implement row loop restoration for each thread.
-static int loop_restoration_row_worker(void *arg1, void *arg2) {
-  AV1LrSync *const lr_sync = (AV1LrSync *)arg1;
-  LRWorkerData *lrworkerdata = (LRWorkerData *)arg2;
+// Restores one row of restoration units of a plane and copies the rows that no
+// other job reads back to the frame.
+static int loop_restoration_task(void *arg1, void *arg2, int thread_id) {
+  const AV1LrMTInfo *const cur_job_info = (const AV1LrMTInfo *)arg1;
+  LRWorkerData *const lrworkerdata =
+      &((AV1LrSync *)arg2)->lrworkerdata[thread_id];
   AV1LrStruct *lr_ctxt = (AV1LrStruct *)lrworkerdata->lr_ctxt;
   FilterFrameCtxt *ctxt = lr_ctxt->ctxt;
-  int lr_unit_row;
-  int plane;
+  const int plane = cur_job_info->plane;
   const int tile_row = LR_TILE_ROW;
   const int tile_col = LR_TILE_COL;
   const int tile_cols = LR_TILE_COLS;
@@ -804,41 +505,24 @@ static int loop_restoration_row_worker(void *arg1, void *arg2) {
   static const copy_fun copy_funs[3] = { aom_yv12_partial_coloc_copy_y,
                                          aom_yv12_partial_coloc_copy_u,
                                          aom_yv12_partial_coloc_copy_v };
-
-  while (1) {
-    AV1LrMTInfo *cur_job_info = get_lr_job_info(lr_sync);
-    if (cur_job_info != NULL) {
-      RestorationTileLimits limits;
-      sync_read_fn_t on_sync_read;
-      sync_write_fn_t on_sync_write;
-      limits.v_start = cur_job_info->v_start;
-      limits.v_end = cur_job_info->v_end;
-      lr_unit_row = cur_job_info->lr_unit_row;
-      plane = cur_job_info->plane;
-      const int unit_idx0 = tile_idx * ctxt[plane].rsi->units_per_tile;
-
-      // sync_mode == 1 implies only sync read is required in LR Multi-threading
-      // sync_mode == 0 implies only sync write is required.
-      on_sync_read =
-          cur_job_info->sync_mode == 1 ? lr_sync_read : av1_lr_sync_read_dummy;
-      on_sync_write = cur_job_info->sync_mode == 0 ? lr_sync_write
-                                                   : av1_lr_sync_write_dummy;
-
-      av1_foreach_rest_unit_in_row(
-          &limits, &(ctxt[plane].tile_rect), lr_ctxt->on_rest_unit, lr_unit_row,
-          ctxt[plane].rsi->restoration_unit_size, unit_idx0,
-          ctxt[plane].rsi->horz_units_per_tile,
-          ctxt[plane].rsi->vert_units_per_tile, plane, &ctxt[plane],
-          lrworkerdata->rst_tmpbuf, lrworkerdata->rlbs, on_sync_read,
-          on_sync_write, lr_sync);
-
-      copy_funs[plane](lr_ctxt->dst, lr_ctxt->frame, ctxt[plane].tile_rect.left,
-                       ctxt[plane].tile_rect.right, cur_job_info->v_copy_start,
-                       cur_job_info->v_copy_end);
-    } else {
-      break;
-    }
-  }
+  RestorationTileLimits limits;
+  limits.v_start = cur_job_info->v_start;
+  limits.v_end = cur_job_info->v_end;
+  const int unit_idx0 = tile_idx * ctxt[plane].rsi->units_per_tile;
+
+  // The rows next to an odd row are done before it starts, so the rows need
+  // no sync of their own.
+  av1_foreach_rest_unit_in_row(
+      &limits, &(ctxt[plane].tile_rect), lr_ctxt->on_rest_unit,
+      cur_job_info->lr_unit_row, ctxt[plane].rsi->restoration_unit_size,
+      unit_idx0, ctxt[plane].rsi->horz_units_per_tile,
+      ctxt[plane].rsi->vert_units_per_tile, plane, &ctxt[plane],
+      lrworkerdata->rst_tmpbuf, lrworkerdata->rlbs, av1_lr_sync_read_dummy,
+      av1_lr_sync_write_dummy, NULL);
+
+  copy_funs[plane](lr_ctxt->dst, lr_ctxt->frame, ctxt[plane].tile_rect.left,
+                   ctxt[plane].tile_rect.right, cur_job_info->v_copy_start,
+                   cur_job_info->v_copy_end);
   return 1;
 }
 
@@ -849,7 +533,6 @@ static void foreach_rest_unit_in_planes_mt(AV1LrStruct *lr_ctxt,
 
   const int num_planes = av1_num_planes(cm);
 
-  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
   int num_rows_lr = 0;
 
   for (int plane = 0; plane < num_planes; plane++) {
@@ -868,41 +551,41 @@ static void foreach_rest_unit_in_planes_mt(AV1LrStruct *lr_ctxt,
   int i;
   assert(MAX_MB_PLANE == 3);
 
-  if (!lr_sync->sync_range || num_rows_lr != lr_sync->rows ||
+  if (!lr_sync->lrworkerdata || num_rows_lr != lr_sync->rows ||
       num_workers > lr_sync->num_workers || num_planes != lr_sync->num_planes) {
-    av1_loop_restoration_dealloc(lr_sync, num_workers);
-    loop_restoration_alloc(lr_sync, cm, num_workers, num_rows_lr, num_planes,
-                           cm->width);
-  }
-
-  // Initialize cur_sb_col to -1 for all SB rows.
-  for (i = 0; i < num_planes; i++) {
-    memset(lr_sync->cur_sb_col[i], -1,
-           sizeof(*(lr_sync->cur_sb_col[i])) * num_rows_lr);
+    av1_loop_restoration_dealloc(lr_sync, lr_sync->num_workers);
+    loop_restoration_alloc(lr_sync, cm, num_workers, num_rows_lr, num_planes);
   }
 
   enqueue_lr_jobs(lr_sync, lr_ctxt, cm);
 
-  // Set up looprestoration thread data.
   for (i = 0; i < num_workers; ++i) {
-    AVxWorker *const worker = &workers[i];
     lr_sync->lrworkerdata[i].lr_ctxt = (void *)lr_ctxt;
-    worker->hook = loop_restoration_row_worker;
-    worker->data1 = lr_sync;
-    worker->data2 = &lr_sync->lrworkerdata[i];
-
-    // Start loopfiltering
-    if (i == num_workers - 1) {
-      winterface->execute(worker);
-    } else {
-      winterface->launch(worker);
-    }
   }
 
-  // Wait till all rows are finished
-  for (i = 0; i < num_workers; ++i) {
-    winterface->sync(&workers[i]);
+  // The even rows of all planes are queued first, then the odd rows. An odd
+  // row reads the rows above and below it, so it waits for both.
+  if (!aom_task_graph_alloc(&lr_sync->graph, num_rows_lr * num_planes,
+                            2 * num_rows_lr * num_planes, num_workers)) {
+    aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                       "Failed to allocate lr_sync->graph");
+  }
+  int first_even_job[MAX_MB_PLANE] = { 0 };
+  for (i = 0; i < lr_sync->jobs_enqueued; ++i) {
+    const AV1LrMTInfo *const job = &lr_sync->job_queue[i];
+    const int task = aom_task_graph_add(&lr_sync->graph, loop_restoration_task,
+                                        (void *)job, lr_sync);
+    if (job->sync_mode == 0) {
+      if (job->lr_unit_row == 0) first_even_job[job->plane] = task;
+      continue;
+    }
+    const int above = first_even_job[job->plane] + (job->lr_unit_row >> 1);
+    aom_task_graph_add_dependency(&lr_sync->graph, above, task);
+    if (job->lr_unit_row + 1 < ctxt[job->plane].rsi->vert_units_per_tile) {
+      aom_task_graph_add_dependency(&lr_sync->graph, above + 1, task);
+    }
   }
+  aom_task_graph_run(&lr_sync->graph, workers, num_workers, num_workers - 1);
 }
 
 void av1_loop_restoration_filter_frame_mt(YV12_BUFFER_CONFIG *frame,
@@ -15,6 +15,8 @@
 #include "config/aom_config.h"
 
 #include "av1/common/av1_loopfilter.h"
+#include "av1/common/cdef_block.h"
+#include "aom_util/aom_task.h"
 #include "aom_util/aom_thread.h"
 
 #ifdef __cplusplus
@@ -29,29 +31,18 @@ typedef struct AV1LfMTInfo {
   int dir;
 } AV1LfMTInfo;
 
-// Loopfilter row synchronization
+// Loopfilter row jobs
 typedef struct AV1LfSyncData {
-#if CONFIG_MULTITHREAD
-  pthread_mutex_t *mutex_[MAX_MB_PLANE];
-  pthread_cond_t *cond_[MAX_MB_PLANE];
-#endif
-  // Allocate memory to store the loop-filtered superblock index in each row.
-  int *cur_sb_col[MAX_MB_PLANE];
-  // The optimal sync_range for different resolution and platform should be
-  // determined by testing. Currently, it is chosen to be a power-of-2 number.
-  int sync_range;
   int rows;
 
   // Row-based parallel loopfilter data
   LFWorkerData *lfdata;
   int num_workers;
 
-#if CONFIG_MULTITHREAD
-  pthread_mutex_t *job_mutex;
-#endif
   AV1LfMTInfo *job_queue;
   int jobs_enqueued;
-  int jobs_dequeued;
+  // Runs the jobs of av1_loop_filter_frame_mt().
+  AomTaskGraph graph;
 } AV1LfSync;
 
 typedef struct AV1LrMTInfo {
@@ -70,31 +61,20 @@ typedef struct LoopRestorationWorkerData {
   void *lr_ctxt;
 } LRWorkerData;
 
-// Looprestoration row synchronization
+// Looprestoration row jobs
 typedef struct AV1LrSyncData {
-#if CONFIG_MULTITHREAD
-  pthread_mutex_t *mutex_[MAX_MB_PLANE];
-  pthread_cond_t *cond_[MAX_MB_PLANE];
-#endif
-  // Allocate memory to store the loop-restoration block index in each row.
-  int *cur_sb_col[MAX_MB_PLANE];
-  // The optimal sync_range for different resolution and platform should be
-  // determined by testing. Currently, it is chosen to be a power-of-2 number.
-  int sync_range;
   int rows;
   int num_planes;
 
   int num_workers;
 
-#if CONFIG_MULTITHREAD
-  pthread_mutex_t *job_mutex;
-#endif
-  // Row-based parallel loopfilter data
+  // Row-based parallel loop restoration data
   LRWorkerData *lrworkerdata;
 
   AV1LrMTInfo *job_queue;
   int jobs_enqueued;
-  int jobs_dequeued;
+  // Runs the jobs of av1_loop_restoration_filter_frame_mt().
+  AomTaskGraph graph;
 } AV1LrSync;
 
 // Deallocate loopfilter synchronization related mutex and data.
@@ -108,6 +88,37 @@ void av1_loop_filter_frame_mt(YV12_BUFFER_CONFIG *frame, struct AV1Common *cm,
 #endif
                               AVxWorker *workers, int num_workers,
                               AV1LfSync *lf_sync);
+
+// Upper bounds of the number of tasks and dependencies that
+// av1_loop_filter_add_tasks() adds to a graph.
+int av1_loop_filter_max_tasks(const struct AV1Common *cm);
+int av1_loop_filter_max_task_deps(const struct AV1Common *cm);
+
+// Adds the jobs that loop filter the frame to 'graph', to be run on up to
+// 'num_workers' workers. When 'tile_row_tasks' is not NULL, the rows of tile
+// row i wait for task tile_row_tasks[i]. Does not support the loop filter
+// bitmasks.
+void av1_loop_filter_add_tasks(AomTaskGraph *graph, YV12_BUFFER_CONFIG *frame,
+                               struct AV1Common *cm, struct macroblockd *mbd,
+                               int plane_start, int plane_end,
+                               const int *tile_row_tasks, int num_workers,
+                               AV1LfSync *lf_sync);
+
+// CDEF filter block row jobs
+typedef struct AV1CdefSyncData {
+  CdefLineBuf linebuf;
+  // Row index of each job, passed to the row tasks.
+  int *rows;
+  int num_rows;
+  // Runs the jobs of av1_cdef_frame_mt().
+  AomTaskGraph graph;
+} AV1CdefSync;
+
+void av1_cdef_frame_mt(YV12_BUFFER_CONFIG *frame, struct AV1Common *cm,
+                       struct macroblockd *xd, AVxWorker *workers,
+                       int num_workers, AV1CdefSync *cdef_sync);
+void av1_cdef_dealloc(AV1CdefSync *cdef_sync);
+
 void av1_loop_restoration_filter_frame_mt(YV12_BUFFER_CONFIG *frame,
                                           struct AV1Common *cm,
                                           int optimized_lr, AVxWorker *workers,
@@ -61,6 +61,7 @@
 #include "av1/decoder/decoder.h"
 #include "av1/decoder/decodetxb.h"
 #include "av1/decoder/detokenize.h"
+#include "av1/decoder/scratch_pool.h"
 
 #define ACCT_STR __func__
 
@@ -1895,6 +1896,12 @@ static void setup_segmentation(AV1_COMMON *const cm,
     segfeatures_copy(&cm->cur_frame->seg, seg);
     return;
   }
+  if (cm->cur_frame->seg_map == NULL) {
+    // Only left unallocated in low memory mode.
+    CHECK_MEM_ERROR(cm, cm->cur_frame->seg_map,
+                    (uint8_t *)aom_calloc(cm->mi_rows * cm->mi_cols,
+                                          sizeof(*cm->cur_frame->seg_map)));
+  }
   if (cm->seg.enabled && cm->prev_frame &&
       (cm->mi_rows == cm->prev_frame->mi_rows) &&
       (cm->mi_cols == cm->prev_frame->mi_cols)) {
@@ -2330,7 +2337,29 @@ static void setup_superres(AV1_COMMON *const cm, struct aom_read_bit_buffer *rb,
   }
 }
 
-static void resize_context_buffers(AV1_COMMON *cm, int width, int height) {
+// Low memory mode version of ensure_mv_buffer(), see AV1D_SET_LOW_MEMORY. The
+// motion vectors of the frame are only stored when the sequence lets later
+// frames project them. The segmentation map is allocated by
+// setup_segmentation() and cm->tpl_mvs by the first frame that uses them.
+static void ensure_mv_buffer_low_memory(RefCntBuffer *buf, AV1_COMMON *cm) {
+  if (buf->mi_rows != cm->mi_rows || buf->mi_cols != cm->mi_cols) {
+    aom_free(buf->mvs);
+    buf->mvs = NULL;
+    aom_free(buf->seg_map);
+    buf->seg_map = NULL;
+    buf->mi_rows = cm->mi_rows;
+    buf->mi_cols = cm->mi_cols;
+  }
+  if (buf->mvs == NULL && cm->seq_params.order_hint_info.enable_ref_frame_mvs) {
+    CHECK_MEM_ERROR(cm, buf->mvs,
+                    (MV_REF *)aom_calloc(
+                        ((cm->mi_rows + 1) >> 1) * ((cm->mi_cols + 1) >> 1),
+                        sizeof(*buf->mvs)));
+  }
+}
+
+static void resize_context_buffers(AV1Decoder *pbi, int width, int height) {
+  AV1_COMMON *const cm = &pbi->common;
 #if CONFIG_SIZE_LIMIT
   if (width > DECODE_WIDTH_LIMIT || height > DECODE_HEIGHT_LIMIT)
     aom_internal_error(&cm->error, AOM_CODEC_CORRUPT_FRAME,
@@ -2363,7 +2392,10 @@ static void resize_context_buffers(AV1_COMMON *cm, int width, int height) {
     cm->height = height;
   }
 
-  ensure_mv_buffer(cm->cur_frame, cm);
+  if (pbi->low_memory)
+    ensure_mv_buffer_low_memory(cm->cur_frame, cm);
+  else
+    ensure_mv_buffer(cm->cur_frame, cm);
   cm->cur_frame->width = cm->width;
   cm->cur_frame->height = cm->height;
 }
@@ -2397,8 +2429,9 @@ static void setup_buffer_pool(AV1_COMMON *cm) {
   cm->cur_frame->buf.render_height = cm->render_height;
 }
 
-static void setup_frame_size(AV1_COMMON *cm, int frame_size_override_flag,
+static void setup_frame_size(AV1Decoder *pbi, int frame_size_override_flag,
                              struct aom_read_bit_buffer *rb) {
+  AV1_COMMON *const cm = &pbi->common;
   const SequenceHeader *const seq_params = &cm->seq_params;
   int width, height;
 
@@ -2417,7 +2450,7 @@ static void setup_frame_size(AV1_COMMON *cm, int frame_size_override_flag,
   }
 
   setup_superres(cm, rb, &width, &height);
-  resize_context_buffers(cm, width, height);
+  resize_context_buffers(pbi, width, height);
   setup_render_size(cm, rb);
   setup_buffer_pool(cm);
 }
@@ -2435,8 +2468,9 @@ static INLINE int valid_ref_frame_img_fmt(aom_bit_depth_t ref_bit_depth,
          ref_yss == this_yss;
 }
 
-static void setup_frame_size_with_refs(AV1_COMMON *cm,
+static void setup_frame_size_with_refs(AV1Decoder *pbi,
                                        struct aom_read_bit_buffer *rb) {
+  AV1_COMMON *const cm = &pbi->common;
   int width, height;
   int found = 0;
   int has_valid_ref_frame = 0;
@@ -2458,7 +2492,7 @@ static void setup_frame_size_with_refs(AV1_COMMON *cm,
         cm->render_width = buf->render_width;
         cm->render_height = buf->render_height;
         setup_superres(cm, rb, &width, &height);
-        resize_context_buffers(cm, width, height);
+        resize_context_buffers(pbi, width, height);
         found = 1;
         break;
       }
@@ -2472,7 +2506,7 @@ static void setup_frame_size_with_refs(AV1_COMMON *cm,
 
     av1_read_frame_size(rb, num_bits_width, num_bits_height, &width, &height);
     setup_superres(cm, rb, &width, &height);
-    resize_context_buffers(cm, width, height);
+    resize_context_buffers(pbi, width, height);
     setup_render_size(cm, rb);
   }
 
@@ -3321,13 +3355,19 @@ static void tile_worker_hook_init(AV1Decoder *const pbi,
 #endif
 }
 
-static int tile_worker_hook(void *arg1, void *arg2) {
-  DecWorkerData *const thread_data = (DecWorkerData *)arg1;
+// Decodes the tile of a tile job.
+static int tile_task_hook(void *arg1, void *arg2, int thread_id) {
+  const TileJobsDec *const job = (const TileJobsDec *)arg1;
   AV1Decoder *const pbi = (AV1Decoder *)arg2;
   AV1_COMMON *cm = &pbi->common;
+  DecWorkerData *const thread_data = pbi->thread_data + thread_id;
   ThreadData *const td = thread_data->td;
+  const TileInfo *const tile_info = &job->tile_data->tile_info;
+  struct aom_usec_timer timer;
   uint8_t allow_update_cdf;
 
+  if (td->xd.corrupted) return 0;
+
   // The jmp_buf is valid only for the duration of the function that calls
   // setjmp(). Therefore, this function must reset the 'setjmp' field to 0
   // before it returns.
@@ -3337,33 +3377,35 @@ static int tile_worker_hook(void *arg1, void *arg2) {
     return 0;
   }
   thread_data->error_info.setjmp = 1;
+  if (pbi->stage_timing_enabled) aom_usec_timer_start(&timer);
+  const int64_t cpu_start_us =
+      pbi->stage_timing_enabled ? aom_thread_cpu_time_us() : 0;
 
   allow_update_cdf = cm->large_scale_tile ? 0 : 1;
   allow_update_cdf = allow_update_cdf && !cm->disable_cdf_update;
 
   set_decode_func_pointers(td, 0x3);
+  tile_worker_hook_init(pbi, thread_data, job->tile_buffer, job->tile_data,
+                        allow_update_cdf);
+  decode_tile(pbi, td, tile_info->tile_row, tile_info->tile_col);
+  thread_data->error_info.setjmp = 0;
 
-  assert(cm->tile_cols > 0);
-  while (!td->xd.corrupted) {
-    TileJobsDec *cur_job_info = get_dec_job_info(&pbi->tile_mt_info);
-
-    if (cur_job_info != NULL) {
-      const TileBufferDec *const tile_buffer = cur_job_info->tile_buffer;
-      TileDataDec *const tile_data = cur_job_info->tile_data;
-      tile_worker_hook_init(pbi, thread_data, tile_buffer, tile_data,
-                            allow_update_cdf);
-      // decode tile
-      int tile_row = tile_data->tile_info.tile_row;
-      int tile_col = tile_data->tile_info.tile_col;
-      decode_tile(pbi, td, tile_row, tile_col);
-    } else {
-      break;
-    }
+  if (pbi->stage_timing_enabled) {
+    aom_usec_timer_mark(&timer);
+    thread_data->busy_time_us += aom_usec_timer_elapsed(&timer);
+    thread_data->cpu_time_us += aom_thread_cpu_time_us() - cpu_start_us;
   }
-  thread_data->error_info.setjmp = 0;
   return !td->xd.corrupted;
 }
 
+// Marks the end of the tiles of a tile row.
+static int tile_row_done_hook(void *arg1, void *arg2, int thread_id) {
+  (void)arg1;
+  (void)arg2;
+  (void)thread_id;
+  return 1;
+}
+
 static INLINE int get_max_row_mt_workers_per_tile(AV1_COMMON *cm,
                                                   TileInfo tile) {
   // NOTE: Currently value of max workers is calculated based
@@ -3727,27 +3769,61 @@ static void alloc_dec_jobs(AV1DecTileMT *tile_mt_info, AV1_COMMON *cm,
 }
 
 void av1_free_mc_tmp_buf(ThreadData *thread_data) {
-  int ref;
-  for (ref = 0; ref < 2; ref++) {
-    if (thread_data->mc_buf_use_highbd)
-      aom_free(CONVERT_TO_SHORTPTR(thread_data->mc_buf[ref]));
-    else
-      aom_free(thread_data->mc_buf[ref]);
-    thread_data->mc_buf[ref] = NULL;
+  if (thread_data->scratch) {
+    av1_scratch_pool_put(thread_data->scratch);
+    thread_data->scratch = NULL;
+  } else {
+    for (int ref = 0; ref < 2; ref++) {
+      if (thread_data->mc_buf_use_highbd)
+        aom_free(CONVERT_TO_SHORTPTR(thread_data->mc_buf[ref]));
+      else
+        aom_free(thread_data->mc_buf[ref]);
+    }
+    aom_free(thread_data->tmp_conv_dst);
+    for (int i = 0; i < 2; ++i) aom_free(thread_data->tmp_obmc_bufs[i]);
   }
+  thread_data->mc_buf[0] = thread_data->mc_buf[1] = NULL;
   thread_data->mc_buf_size = 0;
   thread_data->mc_buf_use_highbd = 0;
-
-  aom_free(thread_data->tmp_conv_dst);
   thread_data->tmp_conv_dst = NULL;
+  thread_data->tmp_obmc_bufs[0] = thread_data->tmp_obmc_bufs[1] = NULL;
+}
+
+// Carves the buffers of allocate_mc_tmp_buf() out of one buffer from the
+// scratch pool.
+static void get_pooled_mc_tmp_buf(AV1_COMMON *const cm,
+                                  ThreadData *thread_data, int buf_size,
+                                  int use_highbd) {
+  const size_t conv_size =
+      MAX_SB_SIZE * MAX_SB_SIZE * sizeof(*thread_data->tmp_conv_dst);
+  const size_t obmc_size = 2 * MAX_MB_PLANE * MAX_SB_SQUARE *
+                           sizeof(*thread_data->tmp_obmc_bufs[0]);
+  uint8_t *buf;
+  CHECK_MEM_ERROR(
+      cm, buf,
+      av1_scratch_pool_get(2 * (size_t)buf_size + conv_size + 2 * obmc_size));
+  thread_data->scratch = buf;
+  for (int ref = 0; ref < 2; ref++) {
+    thread_data->mc_buf[ref] =
+        use_highbd ? CONVERT_TO_BYTEPTR((uint16_t *)buf) : buf;
+    buf += buf_size;
+  }
+  thread_data->mc_buf_size = buf_size;
+  thread_data->mc_buf_use_highbd = use_highbd;
+  thread_data->tmp_conv_dst = (CONV_BUF_TYPE *)buf;
+  buf += conv_size;
   for (int i = 0; i < 2; ++i) {
-    aom_free(thread_data->tmp_obmc_bufs[i]);
-    thread_data->tmp_obmc_bufs[i] = NULL;
+    thread_data->tmp_obmc_bufs[i] = buf;
+    buf += obmc_size;
   }
 }
 
 static void allocate_mc_tmp_buf(AV1_COMMON *const cm, ThreadData *thread_data,
-                                int buf_size, int use_highbd) {
+                                int buf_size, int use_highbd, int low_memory) {
+  if (low_memory) {
+    get_pooled_mc_tmp_buf(cm, thread_data, buf_size, use_highbd);
+    return;
+  }
   for (int ref = 0; ref < 2; ref++) {
     if (use_highbd) {
       uint16_t *hbd_mc_buf;
@@ -3772,6 +3848,21 @@ static void allocate_mc_tmp_buf(AV1_COMMON *const cm, ThreadData *thread_data,
   }
 }
 
+// Runs the tile decoding hook of a worker and adds its run time to the busy
+// and CPU time of the worker.
+static int timed_dec_worker_hook(void *arg1, void *arg2) {
+  DecWorkerData *const thread_data = (DecWorkerData *)arg1;
+  struct aom_usec_timer timer;
+  aom_usec_timer_start(&timer);
+  const int64_t cpu_start_us = aom_thread_cpu_time_us();
+  const int ret = thread_data->worker_hook(arg1, arg2);
+  aom_usec_timer_mark(&timer);
+  thread_data->busy_time_us += aom_usec_timer_elapsed(&timer);
+  thread_data->cpu_time_us += aom_thread_cpu_time_us() - cpu_start_us;
+  return ret;
+}
+
+// A NULL 'worker_hook' leaves the hooks to aom_task_graph_run().
 static void reset_dec_workers(AV1Decoder *pbi, AVxWorkerHook worker_hook,
                               int num_workers) {
   const AVxWorkerInterface *const winterface = aom_get_worker_interface();
@@ -3789,11 +3880,19 @@ static void reset_dec_workers(AV1Decoder *pbi, AVxWorkerHook worker_hook,
       thread_data->td->xd.tmp_obmc_bufs[j] = thread_data->td->tmp_obmc_bufs[j];
     }
     winterface->sync(worker);
+    if (worker_hook == NULL) continue;
 
-    worker->hook = worker_hook;
+    if (pbi->stage_timing_enabled) {
+      thread_data->worker_hook = worker_hook;
+      worker->hook = timed_dec_worker_hook;
+    } else {
+      worker->hook = worker_hook;
+    }
     worker->data1 = thread_data;
     worker->data2 = pbi;
   }
+  pbi->stage_timing.num_workers =
+      AOMMAX(pbi->stage_timing.num_workers, num_workers);
 #if CONFIG_ACCOUNTING
   if (pbi->acct_enabled) {
     aom_accounting_reset(&pbi->accounting);
@@ -3843,7 +3942,10 @@ static void decode_mt_init(AV1Decoder *pbi) {
     CHECK_MEM_ERROR(cm, pbi->tile_workers,
                     aom_malloc(num_threads * sizeof(*pbi->tile_workers)));
     CHECK_MEM_ERROR(cm, pbi->thread_data,
-                    aom_malloc(num_threads * sizeof(*pbi->thread_data)));
+                    aom_calloc(num_threads, sizeof(*pbi->thread_data)));
+    // The main thread works too, so the instance keeps its level of
+    // parallelism on the shared pool.
+    pbi->worker_group = aom_worker_group_create(num_threads - 1);
 
     for (worker_idx = 0; worker_idx < num_threads; ++worker_idx) {
       AVxWorker *const worker = &pbi->tile_workers[worker_idx];
@@ -3852,6 +3954,7 @@ static void decode_mt_init(AV1Decoder *pbi) {
 
       winterface->init(worker);
       worker->thread_name = "aom tile worker";
+      if (worker_idx < num_threads - 1) worker->group = pbi->worker_group;
       if (worker_idx < num_threads - 1 && !winterface->reset(worker)) {
         aom_internal_error(&cm->error, AOM_CODEC_ERROR,
                            "Tile decoder thread creation failed");
@@ -3876,7 +3979,8 @@ static void decode_mt_init(AV1Decoder *pbi) {
     DecWorkerData *const thread_data = pbi->thread_data + worker_idx;
     if (thread_data->td->mc_buf_size != buf_size) {
       av1_free_mc_tmp_buf(thread_data->td);
-      allocate_mc_tmp_buf(cm, thread_data->td, buf_size, use_highbd);
+      allocate_mc_tmp_buf(cm, thread_data->td, buf_size, use_highbd,
+                          pbi->low_memory);
     }
   }
 }
@@ -3897,9 +4001,53 @@ static void tile_mt_queue(AV1Decoder *pbi, int tile_cols, int tile_rows,
         sizeof(pbi->tile_mt_info.job_queue[0]), compare_tile_buffers);
 }
 
+// Decodes the tiles of the tile group on the tile workers. With 'loop_filter'
+// set, the tile group holds the whole frame and each tile row is loop
+// filtered as soon as it is decoded.
+static void run_tile_tasks(AV1Decoder *pbi, int num_workers,
+                           int loop_filter) {
+  AV1_COMMON *const cm = &pbi->common;
+  AomTaskGraph *const graph = &pbi->task_graph;
+  const int num_jobs = pbi->tile_mt_info.jobs_enqueued;
+  int max_tasks = num_jobs;
+  int max_deps = num_jobs;
+
+  if (loop_filter) {
+    max_tasks += cm->tile_rows + av1_loop_filter_max_tasks(cm);
+    max_deps += av1_loop_filter_max_task_deps(cm);
+  }
+  if (!aom_task_graph_alloc(graph, max_tasks, max_deps, num_workers)) {
+    aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                       "Failed to allocate pbi->task_graph");
+  }
+  // The jobs are sorted by tile size, so that the largest tiles start first.
+  for (int i = 0; i < num_jobs; ++i) {
+    aom_task_graph_add(graph, tile_task_hook, &pbi->tile_mt_info.job_queue[i],
+                       pbi);
+  }
+  if (loop_filter) {
+    int tile_row_tasks[MAX_TILE_ROWS];
+    for (int tile_row = 0; tile_row < cm->tile_rows; ++tile_row) {
+      tile_row_tasks[tile_row] =
+          aom_task_graph_add(graph, tile_row_done_hook, NULL, NULL);
+    }
+    for (int i = 0; i < num_jobs; ++i) {
+      const TileDataDec *const tile_data =
+          pbi->tile_mt_info.job_queue[i].tile_data;
+      aom_task_graph_add_dependency(
+          graph, i, tile_row_tasks[tile_data->tile_info.tile_row]);
+    }
+    av1_loop_filter_add_tasks(graph, &cm->cur_frame->buf, cm, &pbi->mb, 0,
+                              av1_num_planes(cm), tile_row_tasks, num_workers,
+                              &pbi->lf_row_sync);
+  }
+  pbi->mb.corrupted = !aom_task_graph_run(graph, pbi->tile_workers,
+                                          num_workers, num_workers - 1);
+}
+
 static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
                                       const uint8_t *data_end, int start_tile,
-                                      int end_tile) {
+                                      int end_tile, int loop_filter) {
   AV1_COMMON *const cm = &pbi->common;
   const int tile_cols = cm->tile_cols;
   const int tile_rows = cm->tile_rows;
@@ -3929,7 +4077,8 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
     tile_cols_end = tile_cols;
   }
   tile_count_tg = end_tile - start_tile + 1;
-  num_workers = AOMMIN(pbi->max_threads, tile_count_tg);
+  num_workers = loop_filter ? pbi->max_threads
+                            : AOMMIN(pbi->max_threads, tile_count_tg);
 
   // No tiles to decode.
   if (tile_rows_end <= tile_rows_start || tile_cols_end <= tile_cols_start ||
@@ -3971,9 +4120,11 @@ static const uint8_t *decode_tiles_mt(AV1Decoder *pbi, const uint8_t *data,
   tile_mt_queue(pbi, tile_cols, tile_rows, tile_rows_start, tile_rows_end,
                 tile_cols_start, tile_cols_end, start_tile, end_tile);
 
-  reset_dec_workers(pbi, tile_worker_hook, num_workers);
-  launch_dec_workers(pbi, data_end, num_workers);
-  sync_dec_workers(pbi, num_workers);
+  reset_dec_workers(pbi, NULL, num_workers);
+  for (int worker_idx = 0; worker_idx < num_workers; ++worker_idx) {
+    pbi->thread_data[worker_idx].data_end = data_end;
+  }
+  run_tile_tasks(pbi, num_workers, loop_filter);
 
   if (pbi->mb.corrupted)
     aom_internal_error(&cm->error, AOM_CODEC_CORRUPT_FRAME,
@@ -5154,7 +5305,7 @@ static int read_uncompressed_header(AV1Decoder *pbi,
   }
 
   if (current_frame->frame_type == KEY_FRAME) {
-    setup_frame_size(cm, frame_size_override_flag, rb);
+    setup_frame_size(pbi, frame_size_override_flag, rb);
 
     if (cm->allow_screen_content_tools && !av1_superres_scaled(cm))
       cm->allow_intrabc = aom_rb_read_bit(rb);
@@ -5166,7 +5317,7 @@ static int read_uncompressed_header(AV1Decoder *pbi,
     if (current_frame->frame_type == INTRA_ONLY_FRAME) {
       cm->cur_frame->film_grain_params_present =
           seq_params->film_grain_params_present;
-      setup_frame_size(cm, frame_size_override_flag, rb);
+      setup_frame_size(pbi, frame_size_override_flag, rb);
       if (cm->allow_screen_content_tools && !av1_superres_scaled(cm))
         cm->allow_intrabc = aom_rb_read_bit(rb);
 
@@ -5240,9 +5391,9 @@ static int read_uncompressed_header(AV1Decoder *pbi,
       }
 
       if (!cm->error_resilient_mode && frame_size_override_flag) {
-        setup_frame_size_with_refs(cm, rb);
+        setup_frame_size_with_refs(pbi, rb);
       } else {
-        setup_frame_size(cm, frame_size_override_flag, rb);
+        setup_frame_size(pbi, frame_size_override_flag, rb);
       }
 
       if (cm->cur_frame_force_integer_mv) {
@@ -5544,6 +5695,8 @@ uint32_t av1_decode_frame_headers_and_setup(AV1Decoder *pbi,
 
   cm->setup_mi(cm);
 
+  if (pbi->low_memory && (cm->allow_ref_frame_mvs || cm->tpl_mvs))
+    ensure_tpl_mvs(cm);
   av1_setup_motion_field(cm);
 
   av1_setup_block_planes(xd, cm->seq_params.subsampling_x,
@@ -5571,11 +5724,17 @@ static void setup_frame_info(AV1Decoder *pbi) {
       cm->rst_info[2].frame_restoration_type != RESTORE_NONE) {
     av1_alloc_restoration_buffers(cm);
   }
+}
+
+// In low memory mode the buffers are returned to the scratch pool after each
+// av1_receive_compressed_data() call, which may end within a frame.
+static void setup_mc_tmp_buf(AV1Decoder *pbi) {
+  AV1_COMMON *const cm = &pbi->common;
   const int use_highbd = cm->seq_params.use_highbitdepth;
   const int buf_size = MC_TEMP_BUF_PELS << use_highbd;
   if (pbi->td.mc_buf_size != buf_size) {
     av1_free_mc_tmp_buf(&pbi->td);
-    allocate_mc_tmp_buf(cm, &pbi->td, buf_size, use_highbd);
+    allocate_mc_tmp_buf(cm, &pbi->td, buf_size, use_highbd, pbi->low_memory);
   }
 }
 
@@ -5588,20 +5747,44 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
   const int tile_count_tg = end_tile - start_tile + 1;
 
   if (initialize_flag) setup_frame_info(pbi);
+  setup_mc_tmp_buf(pbi);
   const int num_planes = av1_num_planes(cm);
 #if LOOP_FILTER_BITMASK
   av1_loop_filter_frame_init(cm, 0, num_planes);
 #endif
 
+  // Errors of frames that no later frame references do not drift, so the fast
+  // preview skips their filters first.
+  const int is_reference = cm->current_frame.refresh_frame_flags != 0;
+  const int skip_all_filters =
+      pbi->fast_preview >= FAST_PREVIEW_NO_FILTERS ||
+      (pbi->fast_preview >= FAST_PREVIEW_NON_REF_FRAMES && !is_reference);
+  const int skip_cdef_lr =
+      skip_all_filters || pbi->fast_preview >= FAST_PREVIEW_NO_CDEF_LR;
+  const int do_loop_filter =
+      !cm->allow_intrabc && !cm->single_tile_decoding &&
+      (cm->lf.filter_level[0] || cm->lf.filter_level[1]) && !skip_all_filters;
+  int loop_filter_done = 0;
+
+  start_dec_stage_timing(pbi, AOM_DEC_STAGE_TILES);
   if (pbi->max_threads > 1 && !(cm->large_scale_tile && !pbi->ext_tile_debug) &&
-      pbi->row_mt)
+      pbi->row_mt && !pbi->low_memory) {
     *p_data_end =
         decode_tiles_row_mt(pbi, data, data_end, start_tile, end_tile);
-  else if (pbi->max_threads > 1 && tile_count_tg > 1 &&
-           !(cm->large_scale_tile && !pbi->ext_tile_debug))
-    *p_data_end = decode_tiles_mt(pbi, data, data_end, start_tile, end_tile);
-  else
+  } else if (pbi->max_threads > 1 && tile_count_tg > 1 &&
+             !(cm->large_scale_tile && !pbi->ext_tile_debug)) {
+    // The loop filter of a tile row only needs the pixels of the tile row and
+    // of the row above it, so it runs with the tiles when the tile group holds
+    // the whole frame.
+    loop_filter_done = do_loop_filter && !LOOP_FILTER_BITMASK &&
+                       start_tile == 0 &&
+                       end_tile == cm->tile_rows * cm->tile_cols - 1;
+    *p_data_end = decode_tiles_mt(pbi, data, data_end, start_tile, end_tile,
+                                  loop_filter_done);
+  } else {
     *p_data_end = decode_tiles(pbi, data, data_end, start_tile, end_tile);
+  }
+  end_dec_stage_timing(pbi, AOM_DEC_STAGE_TILES);
 
   // If the bit stream is monochrome, set the U and V buffers to a constant.
   if (num_planes < 3) {
@@ -5613,7 +5796,8 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
   }
 
   if (!cm->allow_intrabc && !cm->single_tile_decoding) {
-    if (cm->lf.filter_level[0] || cm->lf.filter_level[1]) {
+    if (do_loop_filter && !loop_filter_done) {
+      start_dec_stage_timing(pbi, AOM_DEC_STAGE_LOOP_FILTER);
       if (pbi->num_workers > 1) {
         av1_loop_filter_frame_mt(
             &cm->cur_frame->buf, cm, &pbi->mb, 0, num_planes, 0,
@@ -5628,26 +5812,41 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
 #endif
                               0, num_planes, 0);
       }
+      end_dec_stage_timing(pbi, AOM_DEC_STAGE_LOOP_FILTER);
     }
 
     const int do_loop_restoration =
-        cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
-        cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
-        cm->rst_info[2].frame_restoration_type != RESTORE_NONE;
+        !skip_cdef_lr &&
+        (cm->rst_info[0].frame_restoration_type != RESTORE_NONE ||
+         cm->rst_info[1].frame_restoration_type != RESTORE_NONE ||
+         cm->rst_info[2].frame_restoration_type != RESTORE_NONE);
     const int do_cdef =
-        !cm->skip_loop_filter && !cm->coded_lossless &&
+        !cm->skip_loop_filter && !cm->coded_lossless && !skip_cdef_lr &&
         (cm->cdef_info.cdef_bits || cm->cdef_info.cdef_strengths[0] ||
          cm->cdef_info.cdef_uv_strengths[0]);
     const int do_superres = av1_superres_scaled(cm);
     const int optimized_loop_restoration = !do_cdef && !do_superres;
 
     if (!optimized_loop_restoration) {
+      start_dec_stage_timing(pbi, AOM_DEC_STAGE_LOOP_RESTORATION);
       if (do_loop_restoration)
         av1_loop_restoration_save_boundary_lines(&pbi->common.cur_frame->buf,
                                                  cm, 0);
+      end_dec_stage_timing(pbi, AOM_DEC_STAGE_LOOP_RESTORATION);
 
-      if (do_cdef) av1_cdef_frame(&pbi->common.cur_frame->buf, cm, &pbi->mb);
+      if (do_cdef) {
+        start_dec_stage_timing(pbi, AOM_DEC_STAGE_CDEF);
+        if (pbi->num_workers > 1) {
+          av1_cdef_frame_mt(&pbi->common.cur_frame->buf, cm, &pbi->mb,
+                            pbi->tile_workers, pbi->num_workers,
+                            &pbi->cdef_sync);
+        } else {
+          av1_cdef_frame(&pbi->common.cur_frame->buf, cm, &pbi->mb);
+        }
+        end_dec_stage_timing(pbi, AOM_DEC_STAGE_CDEF);
+      }
 
+      start_dec_stage_timing(pbi, AOM_DEC_STAGE_LOOP_RESTORATION);
       superres_post_decode(pbi);
 
       if (do_loop_restoration) {
@@ -5664,10 +5863,12 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
                                             &pbi->lr_ctxt);
         }
       }
+      end_dec_stage_timing(pbi, AOM_DEC_STAGE_LOOP_RESTORATION);
     } else {
       // In no cdef and no superres case. Provide an optimized version of
       // loop_restoration_filter.
       if (do_loop_restoration) {
+        start_dec_stage_timing(pbi, AOM_DEC_STAGE_LOOP_RESTORATION);
         if (pbi->num_workers > 1) {
           av1_loop_restoration_filter_frame_mt(
               (YV12_BUFFER_CONFIG *)xd->cur_buf, cm, optimized_loop_restoration,
@@ -5678,6 +5879,7 @@ void av1_decode_tg_tiles_and_wrapup(AV1Decoder *pbi, const uint8_t *data,
                                             cm, optimized_loop_restoration,
                                             &pbi->lr_ctxt);
         }
+        end_dec_stage_timing(pbi, AOM_DEC_STAGE_LOOP_RESTORATION);
       }
     }
   }
@@ -36,6 +36,7 @@
 #include "av1/decoder/decoder.h"
 #include "av1/decoder/detokenize.h"
 #include "av1/decoder/obu.h"
+#include "av1/decoder/scratch_pool.h"
 
 static void initialize_dec(void) {
   av1_rtcd();
@@ -177,6 +178,7 @@ void av1_decoder_remove(AV1Decoder *pbi) {
     AVxWorker *const worker = &pbi->tile_workers[i];
     aom_get_worker_interface()->end(worker);
   }
+  aom_worker_group_destroy(pbi->worker_group);
 #if CONFIG_MULTITHREAD
   if (pbi->row_mt_mutex_ != NULL) {
     pthread_mutex_destroy(pbi->row_mt_mutex_);
@@ -196,8 +198,10 @@ void av1_decoder_remove(AV1Decoder *pbi) {
 
   if (pbi->num_workers > 0) {
     av1_loop_filter_dealloc(&pbi->lf_row_sync);
+    av1_cdef_dealloc(&pbi->cdef_sync);
     av1_loop_restoration_dealloc(&pbi->lr_row_sync, pbi->num_workers);
     av1_dealloc_dec_jobs(&pbi->tile_mt_info);
+    aom_task_graph_free(&pbi->task_graph);
   }
 
   av1_dec_free_cb_buf(pbi);
@@ -209,6 +213,66 @@ void av1_decoder_remove(AV1Decoder *pbi) {
   aom_free(pbi);
 }
 
+static size_t mc_tmp_buf_usage(const ThreadData *td) {
+  if (td->scratch) return av1_scratch_pool_buf_size(td->scratch);
+  if (td->mc_buf_size == 0) return 0;
+  return 2 * (size_t)td->mc_buf_size +
+         MAX_SB_SIZE * MAX_SB_SIZE * sizeof(*td->tmp_conv_dst) +
+         2 * 2 * MAX_MB_PLANE * MAX_SB_SQUARE * sizeof(*td->tmp_obmc_bufs[0]);
+}
+
+size_t av1_dec_memory_usage(const AV1Decoder *pbi) {
+  const AV1_COMMON *const cm = &pbi->common;
+  size_t usage = 0;
+
+  const BufferPool *const pool = cm->buffer_pool;
+  for (int i = 0; i < FRAME_BUFFERS; ++i) {
+    const RefCntBuffer *const buf = &pool->frame_bufs[i];
+    usage += buf->buf.buffer_alloc_sz;
+    if (buf->mvs) {
+      usage += ((buf->mi_rows + 1) >> 1) * ((buf->mi_cols + 1) >> 1) *
+               sizeof(*buf->mvs);
+    }
+    if (buf->seg_map) usage += buf->mi_rows * buf->mi_cols;
+  }
+
+  usage += cm->mi_alloc_size * (sizeof(*cm->mip) + sizeof(*cm->mi_grid_base));
+  if (cm->tpl_mvs) usage += cm->tpl_mvs_mem_size * sizeof(*cm->tpl_mvs);
+
+  if (cm->rst_tmpbuf) usage += RESTORATION_TMPBUF_SIZE;
+  if (cm->rlbs) usage += sizeof(*cm->rlbs);
+  for (int p = 0; p < MAX_MB_PLANE; ++p) {
+    const RestorationInfo *const rsi = &cm->rst_info[p];
+    if (rsi->unit_info)
+      usage += rsi->units_per_tile * sizeof(*rsi->unit_info);
+    if (rsi->boundaries.stripe_boundary_above)
+      usage += 2 * (size_t)rsi->boundaries.stripe_boundary_size;
+  }
+
+  usage += pbi->allocated_tiles * sizeof(*pbi->tile_data);
+  usage += pbi->cb_buffer_alloc_size * sizeof(*pbi->cb_buffer_base);
+
+  usage += mc_tmp_buf_usage(&pbi->td);
+  if (pbi->thread_data) {
+    for (int worker_idx = 0; worker_idx < pbi->max_threads - 1; worker_idx++) {
+      const ThreadData *const td = pbi->thread_data[worker_idx].td;
+      usage += sizeof(*td) + mc_tmp_buf_usage(td);
+    }
+  }
+  return usage;
+}
+
+// In low memory mode, returns the scratch buffers to the pool between
+// av1_receive_compressed_data() calls.
+static void release_scratch_buffers(AV1Decoder *pbi) {
+  if (!pbi->low_memory) return;
+  av1_free_mc_tmp_buf(&pbi->td);
+  if (pbi->thread_data) {
+    for (int worker_idx = 0; worker_idx < pbi->max_threads - 1; worker_idx++)
+      av1_free_mc_tmp_buf(pbi->thread_data[worker_idx].td);
+  }
+}
+
 void av1_visit_palette(AV1Decoder *const pbi, MACROBLOCKD *const xd, int mi_row,
                        int mi_col, aom_reader *r, BLOCK_SIZE bsize,
                        palette_visitor_fn_t visit) {
@@ -476,6 +540,7 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
     }
 
     release_frame_buffers(pbi);
+    release_scratch_buffers(pbi);
     aom_clear_system_state();
     return -1;
   }
@@ -485,6 +550,10 @@ int av1_receive_compressed_data(AV1Decoder *pbi, size_t size,
   int frame_decoded =
       aom_decode_frame_from_obus(pbi, source, source + size, psource);
 
+  pbi->peak_memory_usage =
+      AOMMAX(pbi->peak_memory_usage, av1_dec_memory_usage(pbi));
+  release_scratch_buffers(pbi);
+
   if (frame_decoded < 0) {
     assert(cm->error.error_code != AOM_CODEC_OK);
     release_frame_buffers(pbi);
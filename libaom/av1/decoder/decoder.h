@@ -15,8 +15,11 @@
 #include "config/aom_config.h"
 
 #include "aom/aom_codec.h"
+#include "aom/aomdx.h"
 #include "aom_dsp/bitreader.h"
+#include "aom_ports/aom_timer.h"
 #include "aom_scale/yv12config.h"
+#include "aom_util/aom_task.h"
 #include "aom_util/aom_thread.h"
 
 #include "av1/common/thread_common.h"
@@ -58,6 +61,9 @@ typedef struct ThreadData {
 
   CONV_BUF_TYPE *tmp_conv_dst;
   uint8_t *tmp_obmc_bufs[2];
+  // In low memory mode, a single buffer from the scratch pool holds mc_buf,
+  // tmp_conv_dst and tmp_obmc_bufs.
+  void *scratch;
 
   decode_block_visitor_fn_t read_coeffs_tx_intra_block_visit;
   decode_block_visitor_fn_t predict_and_recon_intra_block_visit;
@@ -156,6 +162,17 @@ typedef struct AV1DecTileMTData {
   int alloc_tile_cols;
 } AV1DecTileMT;
 
+// Levels of AV1D_SET_FAST_PREVIEW.
+enum {
+  FAST_PREVIEW_OFF,
+  // Skip the in-loop filters of frames that are not references.
+  FAST_PREVIEW_NON_REF_FRAMES,
+  // Also skip CDEF and loop restoration of reference frames.
+  FAST_PREVIEW_NO_CDEF_LR,
+  // Skip all in-loop filters.
+  FAST_PREVIEW_NO_FILTERS,
+};
+
 typedef struct AV1Decoder {
   DECLARE_ALIGNED(32, MACROBLOCKD, mb);
 
@@ -163,10 +180,14 @@ typedef struct AV1Decoder {
 
   AVxWorker lf_worker;
   AV1LfSync lf_row_sync;
+  AV1CdefSync cdef_sync;
   AV1LrSync lr_row_sync;
   AV1LrStruct lr_ctxt;
   AVxWorker *tile_workers;
   int num_workers;
+  // Set when the tile workers run on the shared thread pool, see
+  // aom_codec_set_shared_thread_pool().
+  AVxWorkerGroup *worker_group;
   DecWorkerData *thread_data;
   ThreadData td;
   TileDataDec *tile_data;
@@ -174,6 +195,9 @@ typedef struct AV1Decoder {
 
   TileBufferDec tile_buffers[MAX_TILE_ROWS][MAX_TILE_COLS];
   AV1DecTileMT tile_mt_info;
+  // The tile jobs of the tile worker threads, followed by the loop filter jobs
+  // when the loop filter runs with the tiles.
+  AomTaskGraph task_graph;
 
   // Each time the decoder is called, we expect to receive a full temporal unit.
   // This can contain up to one shown frame per spatial layer in the current
@@ -233,6 +257,22 @@ typedef struct AV1Decoder {
   uint32_t coded_tile_data_size;
   unsigned int ext_tile_debug;  // for ext-tile software debug & testing
   unsigned int row_mt;
+  // Which in-loop filters to skip, see AV1D_SET_FAST_PREVIEW.
+  int fast_preview;
+  // Skip all frames other than key frames and intra-only frames, see
+  // AV1D_SET_KEY_FRAMES_ONLY.
+  int key_frames_only;
+  // Stage times since the last aom_codec_decode() call, see
+  // AV1D_SET_STAGE_TIMING.
+  int stage_timing_enabled;
+  aom_dec_stage_timing_t stage_timing;
+  struct aom_usec_timer stage_timer[AOM_DEC_STAGES];
+  int64_t stage_cpu_start_us[AOM_DEC_STAGES];
+  // Size stream buffers by the tools the stream uses and take the scratch
+  // buffers from the process-wide pool per frame, see AV1D_SET_LOW_MEMORY.
+  int low_memory;
+  // Largest av1_dec_memory_usage() after decoding a frame.
+  size_t peak_memory_usage;
   EXTERNAL_REFERENCES ext_refs;
   YV12_BUFFER_CONFIG tile_list_outbuf;
 
@@ -273,12 +313,35 @@ aom_codec_err_t av1_copy_new_frame_dec(AV1_COMMON *cm,
 struct AV1Decoder *av1_decoder_create(BufferPool *const pool);
 
 void av1_decoder_remove(struct AV1Decoder *pbi);
+
+// Returns the number of bytes held by the decoder for the current stream: the
+// frame buffers and their motion vectors and segmentation maps, the mode info,
+// motion field, loop restoration and coefficient buffers, the tile data and the
+// per-thread scratch buffers.
+size_t av1_dec_memory_usage(const struct AV1Decoder *pbi);
 void av1_dealloc_dec_jobs(struct AV1DecTileMTData *tile_mt_info);
 
 void av1_dec_row_mt_dealloc(AV1DecRowMTSync *dec_row_mt_sync);
 
 void av1_dec_free_cb_buf(AV1Decoder *pbi);
 
+static INLINE void start_dec_stage_timing(AV1Decoder *pbi,
+                                          aom_dec_stage_t stage) {
+  if (!pbi->stage_timing_enabled) return;
+  aom_usec_timer_start(&pbi->stage_timer[stage]);
+  pbi->stage_cpu_start_us[stage] = aom_thread_cpu_time_us();
+}
+
+static INLINE void end_dec_stage_timing(AV1Decoder *pbi,
+                                        aom_dec_stage_t stage) {
+  if (!pbi->stage_timing_enabled) return;
+  aom_usec_timer_mark(&pbi->stage_timer[stage]);
+  pbi->stage_timing.time_us[stage] +=
+      aom_usec_timer_elapsed(&pbi->stage_timer[stage]);
+  pbi->stage_timing.cpu_time_us[stage] +=
+      aom_thread_cpu_time_us() - pbi->stage_cpu_start_us[stage];
+}
+
 static INLINE void decrease_ref_count(RefCntBuffer *const buf,
                                       BufferPool *const pool) {
   if (buf != NULL) {
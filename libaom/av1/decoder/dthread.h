@@ -29,6 +29,12 @@ typedef struct DecWorkerData {
   struct ThreadData *td;
   const uint8_t *data_end;
   struct aom_internal_error_info error_info;
+  // The tile decoding hook run by timed_dec_worker_hook() and the wall clock
+  // and CPU time it ran since the last aom_codec_decode() call, when stage
+  // timing is enabled.
+  AVxWorkerHook worker_hook;
+  uint64_t busy_time_us;
+  uint64_t cpu_time_us;
 } DecWorkerData;
 
 // WorkerData for the FrameWorker thread. It contains all the information of
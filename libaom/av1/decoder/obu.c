@@ -286,8 +286,31 @@ static uint32_t read_frame_header_obu(AV1Decoder *pbi,
                                       const uint8_t *data,
                                       const uint8_t **p_data_end,
                                       int trailing_bits_present) {
-  return av1_decode_frame_headers_and_setup(pbi, rb, data, p_data_end,
-                                            trailing_bits_present);
+  start_dec_stage_timing(pbi, AOM_DEC_STAGE_HEADER);
+  const uint32_t frame_header_size = av1_decode_frame_headers_and_setup(
+      pbi, rb, data, p_data_end, trailing_bits_present);
+  end_dec_stage_timing(pbi, AOM_DEC_STAGE_HEADER);
+  return frame_header_size;
+}
+
+// Peeks at the start of the uncompressed header in rb. Returns 1 if the frame
+// is decoded when only key frames and intra-only frames are wanted: a key
+// frame, an intra-only frame, or a show_existing_frame of a key frame that
+// has not been shown yet.
+static int is_intra_frame_header(const AV1Decoder *pbi,
+                                 const struct aom_read_bit_buffer *rb) {
+  const AV1_COMMON *const cm = &pbi->common;
+  if (cm->seq_params.reduced_still_picture_hdr) return 1;
+
+  struct aom_read_bit_buffer peek_rb = *rb;
+  if (aom_rb_read_bit(&peek_rb)) {  // show_existing_frame
+    const RefCntBuffer *const frame_to_show =
+        cm->ref_frame_map[aom_rb_read_literal(&peek_rb, 3)];
+    return frame_to_show != NULL && frame_to_show->frame_type == KEY_FRAME &&
+           frame_to_show->showable_frame;
+  }
+  const FRAME_TYPE frame_type = (FRAME_TYPE)aom_rb_read_literal(&peek_rb, 2);
+  return frame_type == KEY_FRAME || frame_type == INTRA_ONLY_FRAME;
 }
 
 // On success, returns the tile group header size. On failure, calls
@@ -687,6 +710,8 @@ int aom_decode_frame_from_obus(struct AV1Decoder *pbi, const uint8_t *data,
   AV1_COMMON *const cm = &pbi->common;
   int frame_decoding_finished = 0;
   int is_first_tg_obu_received = 1;
+  // Set while the OBUs of a frame skipped by pbi->key_frames_only are read.
+  int skip_frame = 0;
   uint32_t frame_header_size = 0;
   ObuHeader obu_header;
   memset(&obu_header, 0, sizeof(obu_header));
@@ -756,6 +781,7 @@ int aom_decode_frame_from_obus(struct AV1Decoder *pbi, const uint8_t *data,
       case OBU_TEMPORAL_DELIMITER:
         decoded_payload_size = read_temporal_delimiter_obu();
         pbi->seen_frame_header = 0;
+        skip_frame = 0;
         break;
       case OBU_SEQUENCE_HEADER:
         decoded_payload_size = read_sequence_header_obu(pbi, &rb);
@@ -764,6 +790,17 @@ int aom_decode_frame_from_obus(struct AV1Decoder *pbi, const uint8_t *data,
       case OBU_FRAME_HEADER:
       case OBU_REDUNDANT_FRAME_HEADER:
       case OBU_FRAME:
+        // A frame header or frame OBU that is not redundant starts a new
+        // frame.
+        if (pbi->key_frames_only && !pbi->seen_frame_header &&
+            obu_header.type != OBU_REDUNDANT_FRAME_HEADER &&
+            pbi->sequence_header_ready) {
+          skip_frame = !is_intra_frame_header(pbi, &rb);
+        }
+        if (skip_frame) {
+          decoded_payload_size = payload_size;
+          break;
+        }
         // Only decode first frame header received
         if (!pbi->seen_frame_header ||
             (cm->large_scale_tile && !pbi->camera_frame_header_ready)) {
@@ -815,6 +852,10 @@ int aom_decode_frame_from_obus(struct AV1Decoder *pbi, const uint8_t *data,
         if (byte_alignment(cm, &rb)) return -1;
         AOM_FALLTHROUGH_INTENDED;  // fall through to read tile group.
       case OBU_TILE_GROUP:
+        if (skip_frame) {
+          decoded_payload_size = payload_size;
+          break;
+        }
         if (!pbi->seen_frame_header) {
           cm->error.error_code = AOM_CODEC_CORRUPT_FRAME;
           return -1;
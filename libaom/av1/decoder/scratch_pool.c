@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "config/aom_config.h"
+
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_mem/aom_mem.h"
+#include "aom_ports/aom_once.h"
+#include "aom_util/aom_thread.h"
+#include "av1/decoder/scratch_pool.h"
+
+// The header precedes the data of each buffer. Its size keeps the data
+// aligned to 32 bytes.
+#define HEADER_SIZE 32
+
+typedef struct scratch_buf {
+  struct scratch_buf *next;
+  size_t size;
+} scratch_buf_t;
+
+// The free buffers, most recently returned first.
+static scratch_buf_t *free_bufs;
+static int num_free;
+static int num_users;
+// The number of buffers handed out, and the most handed out at once since the
+// pool was last idle.
+static int num_in_use;
+static int peak_in_use;
+
+#if CONFIG_MULTITHREAD
+static pthread_mutex_t pool_mutex;
+
+static void init_pool_mutex(void) { pthread_mutex_init(&pool_mutex, NULL); }
+
+static void pool_lock(void) {
+  aom_once(init_pool_mutex);
+  pthread_mutex_lock(&pool_mutex);
+}
+
+static void pool_unlock(void) { pthread_mutex_unlock(&pool_mutex); }
+#else
+static void pool_lock(void) {}
+static void pool_unlock(void) {}
+#endif  // CONFIG_MULTITHREAD
+
+static scratch_buf_t *get_header(const void *buf) {
+  return (scratch_buf_t *)((uint8_t *)buf - HEADER_SIZE);
+}
+
+void av1_scratch_pool_add_user(void) {
+  pool_lock();
+  ++num_users;
+  pool_unlock();
+}
+
+void av1_scratch_pool_remove_user(void) {
+  pool_lock();
+  assert(num_users > 0);
+  if (--num_users == 0) {
+    while (free_bufs) {
+      scratch_buf_t *const next = free_bufs->next;
+      aom_free(free_bufs);
+      free_bufs = next;
+    }
+    num_free = 0;
+  }
+  pool_unlock();
+}
+
+void *av1_scratch_pool_get(size_t size) {
+  scratch_buf_t *buf = NULL;
+  pool_lock();
+  // Take the smallest free buffer that fits, but do not tie up a buffer more
+  // than twice the requested size.
+  scratch_buf_t **best = NULL;
+  for (scratch_buf_t **p = &free_bufs; *p; p = &(*p)->next) {
+    const size_t buf_size = (*p)->size;
+    if (buf_size >= size && buf_size / 2 <= size &&
+        (best == NULL || buf_size < (*best)->size)) {
+      best = p;
+    }
+  }
+  if (best) {
+    buf = *best;
+    *best = buf->next;
+    --num_free;
+  }
+  ++num_in_use;
+  peak_in_use = AOMMAX(peak_in_use, num_in_use);
+  pool_unlock();
+
+  if (buf == NULL) {
+    buf = (scratch_buf_t *)aom_memalign(32, HEADER_SIZE + size);
+    if (buf == NULL) {
+      pool_lock();
+      --num_in_use;
+      pool_unlock();
+      return NULL;
+    }
+    memset((uint8_t *)buf + HEADER_SIZE, 0, size);
+    buf->size = size;
+  }
+  buf->next = NULL;
+  return (uint8_t *)buf + HEADER_SIZE;
+}
+
+void av1_scratch_pool_put(void *buf) {
+  if (buf == NULL) return;
+  scratch_buf_t *const header = get_header(buf);
+  pool_lock();
+  header->next = free_bufs;
+  free_bufs = header;
+  ++num_free;
+  --num_in_use;
+  // Keep no more free buffers than were in use at once, dropping the ones
+  // that waited longest. Those are left over from frames that needed more or
+  // larger buffers than the frames decoded since.
+  if (num_free > peak_in_use) {
+    scratch_buf_t **p = &free_bufs;
+    for (int i = 0; i < peak_in_use; ++i) p = &(*p)->next;
+    while (*p) {
+      scratch_buf_t *const next = (*p)->next;
+      aom_free(*p);
+      *p = next;
+    }
+    num_free = peak_in_use;
+  }
+  if (num_in_use == 0) peak_in_use = 0;
+  pool_unlock();
+}
+
+size_t av1_scratch_pool_free_size(void) {
+  size_t size = 0;
+  pool_lock();
+  for (const scratch_buf_t *p = free_bufs; p; p = p->next) size += p->size;
+  pool_unlock();
+  return size;
+}
+
+size_t av1_scratch_pool_buf_size(const void *buf) {
+  return get_header(buf)->size;
+}
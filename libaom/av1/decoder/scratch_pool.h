@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_AV1_DECODER_SCRATCH_POOL_H_
+#define AOM_AV1_DECODER_SCRATCH_POOL_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Process-wide pool of the scratch buffers that decoders in low memory mode
+// only hold while they decode a frame (see AV1D_SET_LOW_MEMORY). The memory
+// used by many idle decoders is then bounded by the number of frames decoded
+// at the same time instead of the number of decoders.
+
+// Registers a user of the pool. The free buffers are released when the last
+// user is removed. Until then the pool keeps as many free buffers as were in
+// use at once since it was last idle, so the memory of a large frame is
+// released once smaller frames are decoded.
+void av1_scratch_pool_add_user(void);
+void av1_scratch_pool_remove_user(void);
+
+// Returns a buffer of at least 'size' bytes aligned to 32 bytes, or NULL if
+// the allocation failed. A new buffer is zeroed, a reused one holds the data
+// of its previous user.
+void *av1_scratch_pool_get(size_t size);
+
+// Returns a buffer obtained from av1_scratch_pool_get() to the pool.
+void av1_scratch_pool_put(void *buf);
+
+// Returns the size of a buffer obtained from av1_scratch_pool_get().
+size_t av1_scratch_pool_buf_size(const void *buf);
+
+// Returns the total size of the free buffers kept by the pool.
+size_t av1_scratch_pool_free_size(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AV1_DECODER_SCRATCH_POOL_H_
@@ -0,0 +1,413 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "av1/encoder/analysis_cache.h"
+#include "av1/encoder/encoder.h"
+
+static const char kFileMagic[8] = { 'A', 'V', '1', 'C', 'A', 'C', 'H', 'E' };
+
+typedef struct {
+  char magic[8];
+  int32_t version;
+  int32_t stats_size;
+  // Dimensions of the TPL stats buffers.
+  int32_t width;
+  int32_t height;
+  int32_t mi_rows;
+  int32_t mi_cols;
+} FileHeader;
+
+// A record is a RecordHeader followed by payload_size bytes. The payload of a
+// TPL record is num_frames FrameHeaders and the stats of num_frames frames.
+typedef struct {
+  int32_t type;
+  int32_t num_frames;
+  ANALYSIS_CACHE_KEY key;
+  uint64_t payload_size;
+} RecordHeader;
+
+typedef struct {
+  int32_t is_valid;
+  int32_t reserved;
+} FrameHeader;
+
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+static uint32_t hash_bytes(uint32_t hash, const uint8_t *buf, size_t len) {
+  for (size_t i = 0; i < len; ++i) hash = (hash ^ buf[i]) * FNV_PRIME;
+  return hash;
+}
+
+static uint32_t hash_int(uint32_t hash, int value) {
+  const uint32_t v = (uint32_t)value;
+  const uint8_t bytes[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16),
+                             (uint8_t)(v >> 24) };
+  return hash_bytes(hash, bytes, sizeof(bytes));
+}
+
+static uint32_t hash_luma(uint32_t hash, const YV12_BUFFER_CONFIG *buf) {
+  const int hbd = (buf->flags & YV12_FLAG_HIGHBITDEPTH) != 0;
+  for (int row = 0; row < buf->y_crop_height; ++row) {
+    if (hbd) {
+      const uint16_t *const src =
+          CONVERT_TO_SHORTPTR(buf->y_buffer) + row * buf->y_stride;
+      hash = hash_bytes(hash, (const uint8_t *)src,
+                        buf->y_crop_width * sizeof(*src));
+    } else {
+      hash = hash_bytes(hash, buf->y_buffer + row * buf->y_stride,
+                        buf->y_crop_width);
+    }
+  }
+  return hash;
+}
+
+// Hashes the settings that change the analysis. The rate control settings
+// are left out on purpose.
+static uint32_t hash_settings(const AV1_COMP *cpi) {
+  const AV1EncoderConfig *const oxcf = &cpi->oxcf;
+  const int settings[] = { cpi->common.width,
+                           cpi->common.height,
+                           cpi->common.seq_params.bit_depth,
+                           oxcf->input_bit_depth,
+                           oxcf->speed,
+                           oxcf->lag_in_frames,
+                           oxcf->gf_max_pyr_height,
+                           oxcf->min_gf_interval,
+                           oxcf->max_gf_interval,
+                           oxcf->key_freq,
+                           oxcf->auto_key,
+                           oxcf->fwd_kf_enabled,
+                           oxcf->enable_tpl_model,
+                           oxcf->superblock_size,
+                           oxcf->resize_mode,
+                           oxcf->superres_mode,
+                           oxcf->enable_order_hint,
+                           oxcf->enable_ref_frame_mvs,
+                           oxcf->max_reference_frames,
+                           oxcf->arnr_max_frames,
+                           oxcf->arnr_strength,
+                           oxcf->large_scale_tile };
+  uint32_t hash = FNV_OFFSET_BASIS;
+  for (size_t i = 0; i < sizeof(settings) / sizeof(settings[0]); ++i)
+    hash = hash_int(hash, settings[i]);
+  return hash;
+}
+
+static const ANALYSIS_CACHE_ENTRY *find_entry(const ANALYSIS_CACHE *cache,
+                                              ANALYSIS_RECORD_TYPE type,
+                                              const ANALYSIS_CACHE_KEY *key) {
+  for (int i = 0; i < cache->num_entries; ++i) {
+    const ANALYSIS_CACHE_ENTRY *const entry = &cache->entries[i];
+    if (entry->type == type && !memcmp(&entry->key, key, sizeof(*key)))
+      return entry;
+  }
+  return NULL;
+}
+
+static int add_entry(ANALYSIS_CACHE *cache, const RecordHeader *header,
+                     long offset) {
+  if (cache->num_entries == cache->max_entries) {
+    const int max_entries = AOMMAX(2 * cache->max_entries, 64);
+    ANALYSIS_CACHE_ENTRY *const entries =
+        (ANALYSIS_CACHE_ENTRY *)aom_malloc(max_entries * sizeof(*entries));
+    if (entries == NULL) return -1;
+    if (cache->num_entries > 0)
+      memcpy(entries, cache->entries, cache->num_entries * sizeof(*entries));
+    aom_free(cache->entries);
+    cache->entries = entries;
+    cache->max_entries = max_entries;
+  }
+  ANALYSIS_CACHE_ENTRY *const entry = &cache->entries[cache->num_entries++];
+  entry->type = (ANALYSIS_RECORD_TYPE)header->type;
+  entry->key = header->key;
+  entry->num_frames = header->num_frames;
+  entry->offset = offset;
+  return 0;
+}
+
+static size_t payload_size(const ANALYSIS_CACHE *cache,
+                           const RecordHeader *header) {
+  switch (header->type) {
+    case ANALYSIS_RECORD_FIRST_PASS: return sizeof(FIRSTPASS_STATS);
+    case ANALYSIS_RECORD_GF_GROUP: return sizeof(ANALYSIS_GF_DECISION);
+    case ANALYSIS_RECORD_TPL:
+      if (header->num_frames <= 0 || header->num_frames > MAX_LAG_BUFFERS)
+        return 0;
+      return header->num_frames *
+             (sizeof(FrameHeader) + cache->frame_size * sizeof(TplDepStats));
+    default: return 0;
+  }
+}
+
+// Indexes the records of the file. A record that is cut short or unknown
+// ends the index and is written over by the next record stored.
+static void index_records(ANALYSIS_CACHE *cache) {
+  long file_size = 0;
+  if (!fseek(cache->file, 0, SEEK_END)) file_size = ftell(cache->file);
+  cache->end = (long)sizeof(FileHeader);
+  RecordHeader header;
+  while (!fseek(cache->file, cache->end, SEEK_SET) &&
+         fread(&header, sizeof(header), 1, cache->file) == 1) {
+    const size_t size = payload_size(cache, &header);
+    const long offset = cache->end + (long)sizeof(header);
+    if (size == 0 || header.payload_size != size ||
+        offset + (long)size > file_size || add_entry(cache, &header, offset)) {
+      break;
+    }
+    cache->end = offset + (long)size;
+  }
+}
+
+// Appends a record made of the 'num_parts' buffers 'parts' of 'sizes' bytes.
+static void write_record(ANALYSIS_CACHE *cache, ANALYSIS_RECORD_TYPE type,
+                         int num_frames, const void *const *parts,
+                         const size_t *sizes, int num_parts) {
+  RecordHeader header;
+  memset(&header, 0, sizeof(header));
+  header.type = type;
+  header.num_frames = num_frames;
+  header.key = cache->key[type];
+  for (int i = 0; i < num_parts; ++i) header.payload_size += sizes[i];
+
+  const long offset = cache->end + (long)sizeof(header);
+  int ok = !fseek(cache->file, cache->end, SEEK_SET) &&
+           fwrite(&header, sizeof(header), 1, cache->file) == 1;
+  for (int i = 0; i < num_parts && ok; ++i)
+    ok = fwrite(parts[i], 1, sizes[i], cache->file) == sizes[i];
+  ok = ok && !fflush(cache->file);
+  // Stop using the cache on errors, the records written so far stay usable.
+  if (!ok || add_entry(cache, &header, offset)) {
+    av1_close_analysis_cache(cache);
+    return;
+  }
+  cache->end = offset + (long)header.payload_size;
+}
+
+// Looks up the record of 'type' under the key in cache->key[type]. Returns
+// the entry, or NULL after marking the key as pending a store.
+static const ANALYSIS_CACHE_ENTRY *lookup(ANALYSIS_CACHE *cache,
+                                          ANALYSIS_RECORD_TYPE type) {
+  const ANALYSIS_CACHE_ENTRY *const entry =
+      find_entry(cache, type, &cache->key[type]);
+  cache->pending[type] = entry == NULL;
+  if (entry && fseek(cache->file, entry->offset, SEEK_SET)) return NULL;
+  return entry;
+}
+
+int av1_open_analysis_cache(AV1_COMP *cpi, const char *filename) {
+  ANALYSIS_CACHE *const cache = &cpi->analysis_cache;
+  const TplDepFrame *const tpl_frame = &cpi->tpl_stats[0];
+
+  av1_close_analysis_cache(cache);
+  if (filename == NULL) return 0;
+
+  FileHeader expected;
+  memset(&expected, 0, sizeof(expected));
+  memcpy(expected.magic, kFileMagic, sizeof(kFileMagic));
+  expected.version = ANALYSIS_CACHE_VERSION;
+  expected.stats_size = (int32_t)sizeof(TplDepStats);
+  expected.width = tpl_frame->width;
+  expected.height = tpl_frame->height;
+  expected.mi_rows = tpl_frame->mi_rows;
+  expected.mi_cols = tpl_frame->mi_cols;
+  cache->frame_size = (size_t)tpl_frame->width * tpl_frame->height;
+
+  FILE *file = fopen(filename, "r+b");
+  if (file) {
+    FileHeader header;
+    if (fread(&header, sizeof(header), 1, file) == 1) {
+      if (memcmp(&header, &expected, sizeof(header))) {
+        fclose(file);
+        return -1;
+      }
+      cache->file = file;
+      index_records(cache);
+      return 0;
+    }
+    // An empty file is written over, any other file is not a cache.
+    const int empty = feof(file) && ftell(file) == 0;
+    fclose(file);
+    if (!empty) return -1;
+  }
+
+  file = fopen(filename, "w+b");
+  if (!file) return -1;
+  if (fwrite(&expected, sizeof(expected), 1, file) != 1) {
+    fclose(file);
+    return -1;
+  }
+  cache->file = file;
+  cache->end = (long)sizeof(expected);
+  return 0;
+}
+
+void av1_close_analysis_cache(ANALYSIS_CACHE *cache) {
+  if (cache->file) fclose(cache->file);
+  aom_free(cache->entries);
+  memset(cache, 0, sizeof(*cache));
+}
+
+int av1_analysis_cache_load_first_pass(AV1_COMP *cpi,
+                                       FIRSTPASS_STATS *stats) {
+  ANALYSIS_CACHE *const cache = &cpi->analysis_cache;
+  if (cache->file == NULL) return 0;
+  const unsigned int frame_number =
+      cpi->common.current_frame.frame_number;
+  // The stats of a frame depend on the frames before it.
+  if (frame_number == 0) cache->first_pass_hash = FNV_OFFSET_BASIS;
+  cache->first_pass_hash = hash_luma(cache->first_pass_hash, cpi->source);
+
+  ANALYSIS_CACHE_KEY *const key = &cache->key[ANALYSIS_RECORD_FIRST_PASS];
+  memset(key, 0, sizeof(*key));
+  key->position = frame_number;
+  key->content_hash = cache->first_pass_hash;
+  key->settings_hash = hash_settings(cpi);
+  if (!lookup(cache, ANALYSIS_RECORD_FIRST_PASS)) return 0;
+  if (fread(stats, sizeof(*stats), 1, cache->file) != 1) {
+    cache->pending[ANALYSIS_RECORD_FIRST_PASS] = 0;
+    return 0;
+  }
+  return 1;
+}
+
+void av1_analysis_cache_store_first_pass(AV1_COMP *cpi,
+                                         const FIRSTPASS_STATS *stats) {
+  ANALYSIS_CACHE *const cache = &cpi->analysis_cache;
+  if (cache->file == NULL || !cache->pending[ANALYSIS_RECORD_FIRST_PASS])
+    return;
+  cache->pending[ANALYSIS_RECORD_FIRST_PASS] = 0;
+  const void *const parts[] = { stats };
+  const size_t sizes[] = { sizeof(*stats) };
+  write_record(cache, ANALYSIS_RECORD_FIRST_PASS, 1, parts, sizes, 1);
+}
+
+int av1_analysis_cache_load_gf_group(AV1_COMP *cpi,
+                                     ANALYSIS_GF_DECISION *decision) {
+  ANALYSIS_CACHE *const cache = &cpi->analysis_cache;
+  if (cache->file == NULL) return 0;
+  const TWO_PASS *const twopass = &cpi->twopass;
+  const RATE_CONTROL *const rc = &cpi->rc;
+  // The decision looks at most static_scene_max_gf_interval + 1 frames ahead.
+  const ptrdiff_t num_stats =
+      AOMMIN(twopass->stats_in_end - twopass->stats_in,
+             (ptrdiff_t)rc->static_scene_max_gf_interval + 1);
+  uint32_t hash = hash_bytes(FNV_OFFSET_BASIS,
+                             (const uint8_t *)twopass->stats_in,
+                             AOMMAX(num_stats, 0) * sizeof(FIRSTPASS_STATS));
+  hash = hash_int(hash, rc->frames_to_key);
+  hash = hash_int(hash, rc->frames_since_key);
+  hash = hash_int(hash, rc->static_scene_max_gf_interval);
+  hash = hash_int(hash, rc->min_gf_interval);
+  hash = hash_int(hash, rc->max_gf_interval);
+  hash = hash_int(hash, twopass->kf_zeromotion_pct);
+
+  ANALYSIS_CACHE_KEY *const key = &cache->key[ANALYSIS_RECORD_GF_GROUP];
+  memset(key, 0, sizeof(*key));
+  key->position = twopass->stats_in - twopass->stats_in_start;
+  key->content_hash = hash;
+  key->settings_hash = hash_settings(cpi);
+  if (!lookup(cache, ANALYSIS_RECORD_GF_GROUP)) return 0;
+  if (fread(decision, sizeof(*decision), 1, cache->file) != 1) {
+    cache->pending[ANALYSIS_RECORD_GF_GROUP] = 0;
+    return 0;
+  }
+  return 1;
+}
+
+void av1_analysis_cache_store_gf_group(AV1_COMP *cpi,
+                                       const ANALYSIS_GF_DECISION *decision) {
+  ANALYSIS_CACHE *const cache = &cpi->analysis_cache;
+  if (cache->file == NULL || !cache->pending[ANALYSIS_RECORD_GF_GROUP])
+    return;
+  cache->pending[ANALYSIS_RECORD_GF_GROUP] = 0;
+  const void *const parts[] = { decision };
+  const size_t sizes[] = { sizeof(*decision) };
+  write_record(cache, ANALYSIS_RECORD_GF_GROUP, 1, parts, sizes, 1);
+}
+
+int av1_analysis_cache_load_tpl(AV1_COMP *cpi,
+                                const struct lookahead_entry *source) {
+  ANALYSIS_CACHE *const cache = &cpi->analysis_cache;
+  if (cache->file == NULL) return 0;
+  const GF_GROUP *const gf_group = &cpi->twopass.gf_group;
+  uint32_t gf_hash = hash_int(FNV_OFFSET_BASIS, cpi->rc.baseline_gf_interval);
+  gf_hash = hash_int(gf_hash, gf_group->size);
+  for (int i = 0; i <= gf_group->size; ++i) {
+    gf_hash = hash_int(gf_hash, gf_group->update_type[i]);
+    gf_hash = hash_int(gf_hash, gf_group->arf_src_offset[i]);
+  }
+
+  ANALYSIS_CACHE_KEY *const key = &cache->key[ANALYSIS_RECORD_TPL];
+  memset(key, 0, sizeof(*key));
+  key->position = source->ts_start;
+  key->content_hash = hash_luma(FNV_OFFSET_BASIS, &source->img);
+  key->settings_hash = hash_settings(cpi);
+  key->structure_hash = gf_hash;
+  const ANALYSIS_CACHE_ENTRY *const entry =
+      lookup(cache, ANALYSIS_RECORD_TPL);
+  if (entry == NULL) return 0;
+
+  const int num_frames = entry->num_frames;
+  FrameHeader headers[MAX_LAG_BUFFERS];
+  int ok = fread(headers, sizeof(*headers), num_frames, cache->file) ==
+           (size_t)num_frames;
+  for (int frame_idx = 0; frame_idx < num_frames && ok; ++frame_idx) {
+    ok = fread(cpi->tpl_stats[frame_idx].tpl_stats_ptr, sizeof(TplDepStats),
+               cache->frame_size, cache->file) == cache->frame_size;
+  }
+  if (!ok) {
+    // The stats may be partly overwritten, so analyse the group again.
+    cache->pending[ANALYSIS_RECORD_TPL] = 0;
+    return 0;
+  }
+
+  for (int frame_idx = 0; frame_idx < MAX_LAG_BUFFERS; ++frame_idx) {
+    TplDepFrame *const tpl_frame = &cpi->tpl_stats[frame_idx];
+    if (frame_idx < num_frames) {
+      tpl_frame->is_valid = headers[frame_idx].is_valid;
+    } else {
+      memset(tpl_frame->tpl_stats_ptr, 0,
+             cache->frame_size * sizeof(*tpl_frame->tpl_stats_ptr));
+      tpl_frame->is_valid = 0;
+    }
+  }
+  return 1;
+}
+
+void av1_analysis_cache_store_tpl(AV1_COMP *cpi) {
+  ANALYSIS_CACHE *const cache = &cpi->analysis_cache;
+  if (cache->file == NULL || !cache->pending[ANALYSIS_RECORD_TPL]) return;
+  cache->pending[ANALYSIS_RECORD_TPL] = 0;
+
+  // The stats propagate from each analysed frame to the frames before it, so
+  // the last analysed frame ends the record.
+  int num_frames = MAX_LAG_BUFFERS;
+  while (num_frames > 1 && !cpi->tpl_stats[num_frames - 1].is_valid)
+    --num_frames;
+
+  FrameHeader headers[MAX_LAG_BUFFERS];
+  const void *parts[MAX_LAG_BUFFERS + 1];
+  size_t sizes[MAX_LAG_BUFFERS + 1];
+  memset(headers, 0, sizeof(headers));
+  for (int frame_idx = 0; frame_idx < num_frames; ++frame_idx) {
+    headers[frame_idx].is_valid = cpi->tpl_stats[frame_idx].is_valid;
+    parts[frame_idx + 1] = cpi->tpl_stats[frame_idx].tpl_stats_ptr;
+    sizes[frame_idx + 1] = cache->frame_size * sizeof(TplDepStats);
+  }
+  parts[0] = headers;
+  sizes[0] = num_frames * sizeof(*headers);
+  write_record(cache, ANALYSIS_RECORD_TPL, num_frames, parts, sizes,
+               num_frames + 1);
+}
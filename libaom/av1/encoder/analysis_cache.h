@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+/*!\file
+ * \brief A file of encoder analysis shared by encodes of the same source.
+ *
+ * Repeated encodes of one source, typically at several rate targets, repeat
+ * the same first pass, gf group structure and temporal dependency (TPL)
+ * analysis. The cache keeps the first pass statistics of every frame, the gf
+ * group length and ARF decisions, and the TPL stats of every gf group. Each
+ * record is keyed by the content it was computed from and by a hash of the
+ * encoder settings that change the analysis, such as the speed, the lag and
+ * the enabled tools, but not by the rate targets, so encodes at another
+ * bitrate or cq level reuse the analysis. The gf group decisions of the
+ * encode that wrote the cache are reused as they are, including the length
+ * adjustments that depend on the rate target. The temporally filtered ARF
+ * sources are not cached.
+ *
+ * The file is a header followed by records in the order they were written.
+ * A record is a fixed size header followed by its payload, stored as in
+ * memory. All fields are in native byte order and 8 byte aligned. The record
+ * headers are indexed when the file is opened; records missing from the
+ * index are computed and appended.
+ */
+#ifndef AOM_AV1_ENCODER_ANALYSIS_CACHE_H_
+#define AOM_AV1_ENCODER_ANALYSIS_CACHE_H_
+
+#include <stdio.h>
+
+#include "aom/aom_integer.h"
+#include "av1/encoder/firstpass.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ANALYSIS_CACHE_VERSION 3
+
+typedef enum {
+  ANALYSIS_RECORD_FIRST_PASS,
+  ANALYSIS_RECORD_GF_GROUP,
+  ANALYSIS_RECORD_TPL,
+  ANALYSIS_RECORD_TYPES
+} ANALYSIS_RECORD_TYPE;
+
+// Identifies the analysis a record holds.
+typedef struct {
+  // Frame number of a first pass record, position in the first pass stats of
+  // a gf group record, time stamp of the first source of a TPL record.
+  int64_t position;
+  // Hash of the content analysed: the luma of the sources up to this one for
+  // a first pass record, the first pass stats the decision is based on for a
+  // gf group record and the luma of the first source for a TPL record.
+  uint32_t content_hash;
+  // Hash of the encoder settings that change the analysis.
+  uint32_t settings_hash;
+  // Hash of the gf group structure of a TPL record, 0 otherwise.
+  uint32_t structure_hash;
+  uint32_t reserved;
+} ANALYSIS_CACHE_KEY;
+
+// The gf group decisions of define_gf_group() that depend on the rate target.
+typedef struct {
+  // Length of the group before it is adjusted for the rate target.
+  int32_t max_length;
+  // Adjustment of the length and of the ARF position, 0 or negative.
+  int32_t alt_offset;
+  int32_t use_alt_ref;
+  int32_t internal_altref_allowed;
+} ANALYSIS_GF_DECISION;
+
+typedef struct {
+  ANALYSIS_RECORD_TYPE type;
+  ANALYSIS_CACHE_KEY key;
+  int num_frames;
+  // File offset of the payload.
+  long offset;
+} ANALYSIS_CACHE_ENTRY;
+
+typedef struct {
+  FILE *file;
+  // Number of TplDepStats per frame.
+  size_t frame_size;
+  // Headers of the records in the file.
+  ANALYSIS_CACHE_ENTRY *entries;
+  int num_entries;
+  int max_entries;
+  // File offset the next record is written at.
+  long end;
+  // Key of the last lookup of each record type and whether it missed, in
+  // which case the analysis computed next is stored under it.
+  ANALYSIS_CACHE_KEY key[ANALYSIS_RECORD_TYPES];
+  int pending[ANALYSIS_RECORD_TYPES];
+  // Hash of the luma of the first pass sources since the last key frame.
+  uint32_t first_pass_hash;
+} ANALYSIS_CACHE;
+
+struct AV1_COMP;
+struct lookahead_entry;
+
+// Opens the cache file 'filename' for the encoder, creating it if it does not
+// exist. Returns -1 if the file cannot be created or belongs to an encode of
+// another frame size.
+int av1_open_analysis_cache(struct AV1_COMP *cpi, const char *filename);
+
+void av1_close_analysis_cache(ANALYSIS_CACHE *cache);
+
+// Loads the first pass stats of the current source into 'stats'. Returns 0 if
+// the cache has no record of the frame.
+int av1_analysis_cache_load_first_pass(struct AV1_COMP *cpi,
+                                       FIRSTPASS_STATS *stats);
+
+// Stores the first pass stats computed after a failed load.
+void av1_analysis_cache_store_first_pass(struct AV1_COMP *cpi,
+                                         const FIRSTPASS_STATS *stats);
+
+// Loads the decisions of the gf group starting at the current position of the
+// first pass stats. Returns 0 if the cache has no record of the group.
+int av1_analysis_cache_load_gf_group(struct AV1_COMP *cpi,
+                                     ANALYSIS_GF_DECISION *decision);
+
+// Stores the gf group decisions made after a failed load.
+void av1_analysis_cache_store_gf_group(struct AV1_COMP *cpi,
+                                       const ANALYSIS_GF_DECISION *decision);
+
+// Loads the TPL stats of the gf group starting with 'source' into
+// cpi->tpl_stats. Returns 0 if the cache has no record of the group. Must be
+// called before the group is analysed, as the key depends on the gf group
+// structure.
+int av1_analysis_cache_load_tpl(struct AV1_COMP *cpi,
+                                const struct lookahead_entry *source);
+
+// Stores the TPL stats computed after a failed load.
+void av1_analysis_cache_store_tpl(struct AV1_COMP *cpi);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AV1_ENCODER_ANALYSIS_CACHE_H_
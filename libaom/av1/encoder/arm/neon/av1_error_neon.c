@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <arm_neon.h>
+#include <assert.h>
+
+#include "config/av1_rtcd.h"
+
+#include "aom/aom_integer.h"
+
+int64_t av1_block_error_neon(const tran_low_t *coeff, const tran_low_t *dqcoeff,
+                             intptr_t block_size, int64_t *ssz) {
+  int64x2_t error = vdupq_n_s64(0);
+  int64x2_t sqcoeff = vdupq_n_s64(0);
+  intptr_t i;
+
+  assert(block_size >= 4 && block_size % 4 == 0);
+
+  for (i = 0; i < block_size; i += 4) {
+    const int32x4_t c = vld1q_s32(coeff + i);
+    const int32x4_t d = vld1q_s32(dqcoeff + i);
+    const int32x4_t diff = vsubq_s32(c, d);
+
+    error = vmlal_s32(error, vget_low_s32(diff), vget_low_s32(diff));
+    error = vmlal_s32(error, vget_high_s32(diff), vget_high_s32(diff));
+    sqcoeff = vmlal_s32(sqcoeff, vget_low_s32(c), vget_low_s32(c));
+    sqcoeff = vmlal_s32(sqcoeff, vget_high_s32(c), vget_high_s32(c));
+  }
+
+  *ssz = vgetq_lane_s64(sqcoeff, 0) + vgetq_lane_s64(sqcoeff, 1);
+  return vgetq_lane_s64(error, 0) + vgetq_lane_s64(error, 1);
+}
@@ -0,0 +1,1825 @@
+/*
+ * Copyright (c) 2020, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <arm_neon.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config/aom_config.h"
+#include "config/av1_rtcd.h"
+
+#include "av1/common/av1_txfm.h"
+#include "av1/common/enums.h"
+#include "av1/common/arm/transpose_neon.h"
+
+// The 1-D kernels below are the av1_fwd_txfm1d.c transforms applied to four
+// columns (or rows) at once, one int32 lane each. They keep the 32-bit
+// intermediates of the C code, so the output is bit-exact with
+// av1_lowbd_fwd_txfm_c().
+typedef void (*fwd_transform_1d_neon)(const int32x4_t *input,
+                                      int32x4_t *output, int8_t cos_bit);
+
+static INLINE int32x4_t half_btf_neon(int32_t w0, int32x4_t in0, int32_t w1,
+                                      int32x4_t in1, int32x4_t v_bit) {
+  int32x4_t x = vmulq_n_s32(in0, w0);
+  x = vmlaq_n_s32(x, in1, w1);
+  return vrshlq_s32(x, v_bit);
+}
+
+// round_shift((int64_t)in * mult, NewSqrt2Bits)
+static INLINE int32x4_t mul_round_shift_sqrt2_neon(int32x4_t in,
+                                                   int32_t mult) {
+  const int64x2_t lo = vmull_n_s32(vget_low_s32(in), mult);
+  const int64x2_t hi = vmull_n_s32(vget_high_s32(in), mult);
+  return vcombine_s32(vrshrn_n_s64(lo, NewSqrt2Bits),
+                      vrshrn_n_s64(hi, NewSqrt2Bits));
+}
+
+static void fdct4_new_neon(const int32x4_t *input, int32x4_t *output,
+                           int8_t cos_bit) {
+  const int32x4_t v_bit = vdupq_n_s32(-cos_bit);
+  const int32_t *cospi = cospi_arr(cos_bit);
+  int32x4_t *bf0, *bf1;
+  int32x4_t step[4];
+
+  // stage 1
+  bf1 = output;
+  bf1[0] = vaddq_s32(input[0], input[3]);
+  bf1[1] = vaddq_s32(input[1], input[2]);
+  bf1[2] = vsubq_s32(input[1], input[2]);
+  bf1[3] = vsubq_s32(input[0], input[3]);
+
+  // stage 2
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = half_btf_neon(cospi[32], bf0[0], cospi[32], bf0[1], v_bit);
+  bf1[1] = half_btf_neon(-cospi[32], bf0[1], cospi[32], bf0[0], v_bit);
+  bf1[2] = half_btf_neon(cospi[48], bf0[2], cospi[16], bf0[3], v_bit);
+  bf1[3] = half_btf_neon(cospi[48], bf0[3], -cospi[16], bf0[2], v_bit);
+
+  // stage 3
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[2];
+  bf1[2] = bf0[1];
+  bf1[3] = bf0[3];
+}
+
+static void fdct8_new_neon(const int32x4_t *input, int32x4_t *output,
+                           int8_t cos_bit) {
+  const int32x4_t v_bit = vdupq_n_s32(-cos_bit);
+  const int32_t *cospi = cospi_arr(cos_bit);
+  int32x4_t *bf0, *bf1;
+  int32x4_t step[8];
+
+  // stage 1
+  bf1 = output;
+  bf1[0] = vaddq_s32(input[0], input[7]);
+  bf1[1] = vaddq_s32(input[1], input[6]);
+  bf1[2] = vaddq_s32(input[2], input[5]);
+  bf1[3] = vaddq_s32(input[3], input[4]);
+  bf1[4] = vsubq_s32(input[3], input[4]);
+  bf1[5] = vsubq_s32(input[2], input[5]);
+  bf1[6] = vsubq_s32(input[1], input[6]);
+  bf1[7] = vsubq_s32(input[0], input[7]);
+
+  // stage 2
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = vaddq_s32(bf0[0], bf0[3]);
+  bf1[1] = vaddq_s32(bf0[1], bf0[2]);
+  bf1[2] = vsubq_s32(bf0[1], bf0[2]);
+  bf1[3] = vsubq_s32(bf0[0], bf0[3]);
+  bf1[4] = bf0[4];
+  bf1[5] = half_btf_neon(-cospi[32], bf0[5], cospi[32], bf0[6], v_bit);
+  bf1[6] = half_btf_neon(cospi[32], bf0[6], cospi[32], bf0[5], v_bit);
+  bf1[7] = bf0[7];
+
+  // stage 3
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = half_btf_neon(cospi[32], bf0[0], cospi[32], bf0[1], v_bit);
+  bf1[1] = half_btf_neon(-cospi[32], bf0[1], cospi[32], bf0[0], v_bit);
+  bf1[2] = half_btf_neon(cospi[48], bf0[2], cospi[16], bf0[3], v_bit);
+  bf1[3] = half_btf_neon(cospi[48], bf0[3], -cospi[16], bf0[2], v_bit);
+  bf1[4] = vaddq_s32(bf0[4], bf0[5]);
+  bf1[5] = vsubq_s32(bf0[4], bf0[5]);
+  bf1[6] = vsubq_s32(bf0[7], bf0[6]);
+  bf1[7] = vaddq_s32(bf0[7], bf0[6]);
+
+  // stage 4
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[1];
+  bf1[2] = bf0[2];
+  bf1[3] = bf0[3];
+  bf1[4] = half_btf_neon(cospi[56], bf0[4], cospi[8], bf0[7], v_bit);
+  bf1[5] = half_btf_neon(cospi[24], bf0[5], cospi[40], bf0[6], v_bit);
+  bf1[6] = half_btf_neon(cospi[24], bf0[6], -cospi[40], bf0[5], v_bit);
+  bf1[7] = half_btf_neon(cospi[56], bf0[7], -cospi[8], bf0[4], v_bit);
+
+  // stage 5
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[4];
+  bf1[2] = bf0[2];
+  bf1[3] = bf0[6];
+  bf1[4] = bf0[1];
+  bf1[5] = bf0[5];
+  bf1[6] = bf0[3];
+  bf1[7] = bf0[7];
+}
+
+static void fdct16_new_neon(const int32x4_t *input, int32x4_t *output,
+                            int8_t cos_bit) {
+  const int32x4_t v_bit = vdupq_n_s32(-cos_bit);
+  const int32_t *cospi = cospi_arr(cos_bit);
+  int32x4_t *bf0, *bf1;
+  int32x4_t step[16];
+
+  // stage 1
+  bf1 = output;
+  bf1[0] = vaddq_s32(input[0], input[15]);
+  bf1[1] = vaddq_s32(input[1], input[14]);
+  bf1[2] = vaddq_s32(input[2], input[13]);
+  bf1[3] = vaddq_s32(input[3], input[12]);
+  bf1[4] = vaddq_s32(input[4], input[11]);
+  bf1[5] = vaddq_s32(input[5], input[10]);
+  bf1[6] = vaddq_s32(input[6], input[9]);
+  bf1[7] = vaddq_s32(input[7], input[8]);
+  bf1[8] = vsubq_s32(input[7], input[8]);
+  bf1[9] = vsubq_s32(input[6], input[9]);
+  bf1[10] = vsubq_s32(input[5], input[10]);
+  bf1[11] = vsubq_s32(input[4], input[11]);
+  bf1[12] = vsubq_s32(input[3], input[12]);
+  bf1[13] = vsubq_s32(input[2], input[13]);
+  bf1[14] = vsubq_s32(input[1], input[14]);
+  bf1[15] = vsubq_s32(input[0], input[15]);
+
+  // stage 2
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = vaddq_s32(bf0[0], bf0[7]);
+  bf1[1] = vaddq_s32(bf0[1], bf0[6]);
+  bf1[2] = vaddq_s32(bf0[2], bf0[5]);
+  bf1[3] = vaddq_s32(bf0[3], bf0[4]);
+  bf1[4] = vsubq_s32(bf0[3], bf0[4]);
+  bf1[5] = vsubq_s32(bf0[2], bf0[5]);
+  bf1[6] = vsubq_s32(bf0[1], bf0[6]);
+  bf1[7] = vsubq_s32(bf0[0], bf0[7]);
+  bf1[8] = bf0[8];
+  bf1[9] = bf0[9];
+  bf1[10] = half_btf_neon(-cospi[32], bf0[10], cospi[32], bf0[13], v_bit);
+  bf1[11] = half_btf_neon(-cospi[32], bf0[11], cospi[32], bf0[12], v_bit);
+  bf1[12] = half_btf_neon(cospi[32], bf0[12], cospi[32], bf0[11], v_bit);
+  bf1[13] = half_btf_neon(cospi[32], bf0[13], cospi[32], bf0[10], v_bit);
+  bf1[14] = bf0[14];
+  bf1[15] = bf0[15];
+
+  // stage 3
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = vaddq_s32(bf0[0], bf0[3]);
+  bf1[1] = vaddq_s32(bf0[1], bf0[2]);
+  bf1[2] = vsubq_s32(bf0[1], bf0[2]);
+  bf1[3] = vsubq_s32(bf0[0], bf0[3]);
+  bf1[4] = bf0[4];
+  bf1[5] = half_btf_neon(-cospi[32], bf0[5], cospi[32], bf0[6], v_bit);
+  bf1[6] = half_btf_neon(cospi[32], bf0[6], cospi[32], bf0[5], v_bit);
+  bf1[7] = bf0[7];
+  bf1[8] = vaddq_s32(bf0[8], bf0[11]);
+  bf1[9] = vaddq_s32(bf0[9], bf0[10]);
+  bf1[10] = vsubq_s32(bf0[9], bf0[10]);
+  bf1[11] = vsubq_s32(bf0[8], bf0[11]);
+  bf1[12] = vsubq_s32(bf0[15], bf0[12]);
+  bf1[13] = vsubq_s32(bf0[14], bf0[13]);
+  bf1[14] = vaddq_s32(bf0[14], bf0[13]);
+  bf1[15] = vaddq_s32(bf0[15], bf0[12]);
+
+  // stage 4
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = half_btf_neon(cospi[32], bf0[0], cospi[32], bf0[1], v_bit);
+  bf1[1] = half_btf_neon(-cospi[32], bf0[1], cospi[32], bf0[0], v_bit);
+  bf1[2] = half_btf_neon(cospi[48], bf0[2], cospi[16], bf0[3], v_bit);
+  bf1[3] = half_btf_neon(cospi[48], bf0[3], -cospi[16], bf0[2], v_bit);
+  bf1[4] = vaddq_s32(bf0[4], bf0[5]);
+  bf1[5] = vsubq_s32(bf0[4], bf0[5]);
+  bf1[6] = vsubq_s32(bf0[7], bf0[6]);
+  bf1[7] = vaddq_s32(bf0[7], bf0[6]);
+  bf1[8] = bf0[8];
+  bf1[9] = half_btf_neon(-cospi[16], bf0[9], cospi[48], bf0[14], v_bit);
+  bf1[10] = half_btf_neon(-cospi[48], bf0[10], -cospi[16], bf0[13], v_bit);
+  bf1[11] = bf0[11];
+  bf1[12] = bf0[12];
+  bf1[13] = half_btf_neon(cospi[48], bf0[13], -cospi[16], bf0[10], v_bit);
+  bf1[14] = half_btf_neon(cospi[16], bf0[14], cospi[48], bf0[9], v_bit);
+  bf1[15] = bf0[15];
+
+  // stage 5
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[1];
+  bf1[2] = bf0[2];
+  bf1[3] = bf0[3];
+  bf1[4] = half_btf_neon(cospi[56], bf0[4], cospi[8], bf0[7], v_bit);
+  bf1[5] = half_btf_neon(cospi[24], bf0[5], cospi[40], bf0[6], v_bit);
+  bf1[6] = half_btf_neon(cospi[24], bf0[6], -cospi[40], bf0[5], v_bit);
+  bf1[7] = half_btf_neon(cospi[56], bf0[7], -cospi[8], bf0[4], v_bit);
+  bf1[8] = vaddq_s32(bf0[8], bf0[9]);
+  bf1[9] = vsubq_s32(bf0[8], bf0[9]);
+  bf1[10] = vsubq_s32(bf0[11], bf0[10]);
+  bf1[11] = vaddq_s32(bf0[11], bf0[10]);
+  bf1[12] = vaddq_s32(bf0[12], bf0[13]);
+  bf1[13] = vsubq_s32(bf0[12], bf0[13]);
+  bf1[14] = vsubq_s32(bf0[15], bf0[14]);
+  bf1[15] = vaddq_s32(bf0[15], bf0[14]);
+
+  // stage 6
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[1];
+  bf1[2] = bf0[2];
+  bf1[3] = bf0[3];
+  bf1[4] = bf0[4];
+  bf1[5] = bf0[5];
+  bf1[6] = bf0[6];
+  bf1[7] = bf0[7];
+  bf1[8] = half_btf_neon(cospi[60], bf0[8], cospi[4], bf0[15], v_bit);
+  bf1[9] = half_btf_neon(cospi[28], bf0[9], cospi[36], bf0[14], v_bit);
+  bf1[10] = half_btf_neon(cospi[44], bf0[10], cospi[20], bf0[13], v_bit);
+  bf1[11] = half_btf_neon(cospi[12], bf0[11], cospi[52], bf0[12], v_bit);
+  bf1[12] = half_btf_neon(cospi[12], bf0[12], -cospi[52], bf0[11], v_bit);
+  bf1[13] = half_btf_neon(cospi[44], bf0[13], -cospi[20], bf0[10], v_bit);
+  bf1[14] = half_btf_neon(cospi[28], bf0[14], -cospi[36], bf0[9], v_bit);
+  bf1[15] = half_btf_neon(cospi[60], bf0[15], -cospi[4], bf0[8], v_bit);
+
+  // stage 7
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[8];
+  bf1[2] = bf0[4];
+  bf1[3] = bf0[12];
+  bf1[4] = bf0[2];
+  bf1[5] = bf0[10];
+  bf1[6] = bf0[6];
+  bf1[7] = bf0[14];
+  bf1[8] = bf0[1];
+  bf1[9] = bf0[9];
+  bf1[10] = bf0[5];
+  bf1[11] = bf0[13];
+  bf1[12] = bf0[3];
+  bf1[13] = bf0[11];
+  bf1[14] = bf0[7];
+  bf1[15] = bf0[15];
+}
+
+static void fdct32_new_neon(const int32x4_t *input, int32x4_t *output,
+                            int8_t cos_bit) {
+  const int32x4_t v_bit = vdupq_n_s32(-cos_bit);
+  const int32_t *cospi = cospi_arr(cos_bit);
+  int32x4_t *bf0, *bf1;
+  int32x4_t step[32];
+
+  // stage 1
+  bf1 = output;
+  bf1[0] = vaddq_s32(input[0], input[31]);
+  bf1[1] = vaddq_s32(input[1], input[30]);
+  bf1[2] = vaddq_s32(input[2], input[29]);
+  bf1[3] = vaddq_s32(input[3], input[28]);
+  bf1[4] = vaddq_s32(input[4], input[27]);
+  bf1[5] = vaddq_s32(input[5], input[26]);
+  bf1[6] = vaddq_s32(input[6], input[25]);
+  bf1[7] = vaddq_s32(input[7], input[24]);
+  bf1[8] = vaddq_s32(input[8], input[23]);
+  bf1[9] = vaddq_s32(input[9], input[22]);
+  bf1[10] = vaddq_s32(input[10], input[21]);
+  bf1[11] = vaddq_s32(input[11], input[20]);
+  bf1[12] = vaddq_s32(input[12], input[19]);
+  bf1[13] = vaddq_s32(input[13], input[18]);
+  bf1[14] = vaddq_s32(input[14], input[17]);
+  bf1[15] = vaddq_s32(input[15], input[16]);
+  bf1[16] = vsubq_s32(input[15], input[16]);
+  bf1[17] = vsubq_s32(input[14], input[17]);
+  bf1[18] = vsubq_s32(input[13], input[18]);
+  bf1[19] = vsubq_s32(input[12], input[19]);
+  bf1[20] = vsubq_s32(input[11], input[20]);
+  bf1[21] = vsubq_s32(input[10], input[21]);
+  bf1[22] = vsubq_s32(input[9], input[22]);
+  bf1[23] = vsubq_s32(input[8], input[23]);
+  bf1[24] = vsubq_s32(input[7], input[24]);
+  bf1[25] = vsubq_s32(input[6], input[25]);
+  bf1[26] = vsubq_s32(input[5], input[26]);
+  bf1[27] = vsubq_s32(input[4], input[27]);
+  bf1[28] = vsubq_s32(input[3], input[28]);
+  bf1[29] = vsubq_s32(input[2], input[29]);
+  bf1[30] = vsubq_s32(input[1], input[30]);
+  bf1[31] = vsubq_s32(input[0], input[31]);
+
+  // stage 2
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = vaddq_s32(bf0[0], bf0[15]);
+  bf1[1] = vaddq_s32(bf0[1], bf0[14]);
+  bf1[2] = vaddq_s32(bf0[2], bf0[13]);
+  bf1[3] = vaddq_s32(bf0[3], bf0[12]);
+  bf1[4] = vaddq_s32(bf0[4], bf0[11]);
+  bf1[5] = vaddq_s32(bf0[5], bf0[10]);
+  bf1[6] = vaddq_s32(bf0[6], bf0[9]);
+  bf1[7] = vaddq_s32(bf0[7], bf0[8]);
+  bf1[8] = vsubq_s32(bf0[7], bf0[8]);
+  bf1[9] = vsubq_s32(bf0[6], bf0[9]);
+  bf1[10] = vsubq_s32(bf0[5], bf0[10]);
+  bf1[11] = vsubq_s32(bf0[4], bf0[11]);
+  bf1[12] = vsubq_s32(bf0[3], bf0[12]);
+  bf1[13] = vsubq_s32(bf0[2], bf0[13]);
+  bf1[14] = vsubq_s32(bf0[1], bf0[14]);
+  bf1[15] = vsubq_s32(bf0[0], bf0[15]);
+  bf1[16] = bf0[16];
+  bf1[17] = bf0[17];
+  bf1[18] = bf0[18];
+  bf1[19] = bf0[19];
+  bf1[20] = half_btf_neon(-cospi[32], bf0[20], cospi[32], bf0[27], v_bit);
+  bf1[21] = half_btf_neon(-cospi[32], bf0[21], cospi[32], bf0[26], v_bit);
+  bf1[22] = half_btf_neon(-cospi[32], bf0[22], cospi[32], bf0[25], v_bit);
+  bf1[23] = half_btf_neon(-cospi[32], bf0[23], cospi[32], bf0[24], v_bit);
+  bf1[24] = half_btf_neon(cospi[32], bf0[24], cospi[32], bf0[23], v_bit);
+  bf1[25] = half_btf_neon(cospi[32], bf0[25], cospi[32], bf0[22], v_bit);
+  bf1[26] = half_btf_neon(cospi[32], bf0[26], cospi[32], bf0[21], v_bit);
+  bf1[27] = half_btf_neon(cospi[32], bf0[27], cospi[32], bf0[20], v_bit);
+  bf1[28] = bf0[28];
+  bf1[29] = bf0[29];
+  bf1[30] = bf0[30];
+  bf1[31] = bf0[31];
+
+  // stage 3
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = vaddq_s32(bf0[0], bf0[7]);
+  bf1[1] = vaddq_s32(bf0[1], bf0[6]);
+  bf1[2] = vaddq_s32(bf0[2], bf0[5]);
+  bf1[3] = vaddq_s32(bf0[3], bf0[4]);
+  bf1[4] = vsubq_s32(bf0[3], bf0[4]);
+  bf1[5] = vsubq_s32(bf0[2], bf0[5]);
+  bf1[6] = vsubq_s32(bf0[1], bf0[6]);
+  bf1[7] = vsubq_s32(bf0[0], bf0[7]);
+  bf1[8] = bf0[8];
+  bf1[9] = bf0[9];
+  bf1[10] = half_btf_neon(-cospi[32], bf0[10], cospi[32], bf0[13], v_bit);
+  bf1[11] = half_btf_neon(-cospi[32], bf0[11], cospi[32], bf0[12], v_bit);
+  bf1[12] = half_btf_neon(cospi[32], bf0[12], cospi[32], bf0[11], v_bit);
+  bf1[13] = half_btf_neon(cospi[32], bf0[13], cospi[32], bf0[10], v_bit);
+  bf1[14] = bf0[14];
+  bf1[15] = bf0[15];
+  bf1[16] = vaddq_s32(bf0[16], bf0[23]);
+  bf1[17] = vaddq_s32(bf0[17], bf0[22]);
+  bf1[18] = vaddq_s32(bf0[18], bf0[21]);
+  bf1[19] = vaddq_s32(bf0[19], bf0[20]);
+  bf1[20] = vsubq_s32(bf0[19], bf0[20]);
+  bf1[21] = vsubq_s32(bf0[18], bf0[21]);
+  bf1[22] = vsubq_s32(bf0[17], bf0[22]);
+  bf1[23] = vsubq_s32(bf0[16], bf0[23]);
+  bf1[24] = vsubq_s32(bf0[31], bf0[24]);
+  bf1[25] = vsubq_s32(bf0[30], bf0[25]);
+  bf1[26] = vsubq_s32(bf0[29], bf0[26]);
+  bf1[27] = vsubq_s32(bf0[28], bf0[27]);
+  bf1[28] = vaddq_s32(bf0[28], bf0[27]);
+  bf1[29] = vaddq_s32(bf0[29], bf0[26]);
+  bf1[30] = vaddq_s32(bf0[30], bf0[25]);
+  bf1[31] = vaddq_s32(bf0[31], bf0[24]);
+
+  // stage 4
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = vaddq_s32(bf0[0], bf0[3]);
+  bf1[1] = vaddq_s32(bf0[1], bf0[2]);
+  bf1[2] = vsubq_s32(bf0[1], bf0[2]);
+  bf1[3] = vsubq_s32(bf0[0], bf0[3]);
+  bf1[4] = bf0[4];
+  bf1[5] = half_btf_neon(-cospi[32], bf0[5], cospi[32], bf0[6], v_bit);
+  bf1[6] = half_btf_neon(cospi[32], bf0[6], cospi[32], bf0[5], v_bit);
+  bf1[7] = bf0[7];
+  bf1[8] = vaddq_s32(bf0[8], bf0[11]);
+  bf1[9] = vaddq_s32(bf0[9], bf0[10]);
+  bf1[10] = vsubq_s32(bf0[9], bf0[10]);
+  bf1[11] = vsubq_s32(bf0[8], bf0[11]);
+  bf1[12] = vsubq_s32(bf0[15], bf0[12]);
+  bf1[13] = vsubq_s32(bf0[14], bf0[13]);
+  bf1[14] = vaddq_s32(bf0[14], bf0[13]);
+  bf1[15] = vaddq_s32(bf0[15], bf0[12]);
+  bf1[16] = bf0[16];
+  bf1[17] = bf0[17];
+  bf1[18] = half_btf_neon(-cospi[16], bf0[18], cospi[48], bf0[29], v_bit);
+  bf1[19] = half_btf_neon(-cospi[16], bf0[19], cospi[48], bf0[28], v_bit);
+  bf1[20] = half_btf_neon(-cospi[48], bf0[20], -cospi[16], bf0[27], v_bit);
+  bf1[21] = half_btf_neon(-cospi[48], bf0[21], -cospi[16], bf0[26], v_bit);
+  bf1[22] = bf0[22];
+  bf1[23] = bf0[23];
+  bf1[24] = bf0[24];
+  bf1[25] = bf0[25];
+  bf1[26] = half_btf_neon(cospi[48], bf0[26], -cospi[16], bf0[21], v_bit);
+  bf1[27] = half_btf_neon(cospi[48], bf0[27], -cospi[16], bf0[20], v_bit);
+  bf1[28] = half_btf_neon(cospi[16], bf0[28], cospi[48], bf0[19], v_bit);
+  bf1[29] = half_btf_neon(cospi[16], bf0[29], cospi[48], bf0[18], v_bit);
+  bf1[30] = bf0[30];
+  bf1[31] = bf0[31];
+
+  // stage 5
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = half_btf_neon(cospi[32], bf0[0], cospi[32], bf0[1], v_bit);
+  bf1[1] = half_btf_neon(-cospi[32], bf0[1], cospi[32], bf0[0], v_bit);
+  bf1[2] = half_btf_neon(cospi[48], bf0[2], cospi[16], bf0[3], v_bit);
+  bf1[3] = half_btf_neon(cospi[48], bf0[3], -cospi[16], bf0[2], v_bit);
+  bf1[4] = vaddq_s32(bf0[4], bf0[5]);
+  bf1[5] = vsubq_s32(bf0[4], bf0[5]);
+  bf1[6] = vsubq_s32(bf0[7], bf0[6]);
+  bf1[7] = vaddq_s32(bf0[7], bf0[6]);
+  bf1[8] = bf0[8];
+  bf1[9] = half_btf_neon(-cospi[16], bf0[9], cospi[48], bf0[14], v_bit);
+  bf1[10] = half_btf_neon(-cospi[48], bf0[10], -cospi[16], bf0[13], v_bit);
+  bf1[11] = bf0[11];
+  bf1[12] = bf0[12];
+  bf1[13] = half_btf_neon(cospi[48], bf0[13], -cospi[16], bf0[10], v_bit);
+  bf1[14] = half_btf_neon(cospi[16], bf0[14], cospi[48], bf0[9], v_bit);
+  bf1[15] = bf0[15];
+  bf1[16] = vaddq_s32(bf0[16], bf0[19]);
+  bf1[17] = vaddq_s32(bf0[17], bf0[18]);
+  bf1[18] = vsubq_s32(bf0[17], bf0[18]);
+  bf1[19] = vsubq_s32(bf0[16], bf0[19]);
+  bf1[20] = vsubq_s32(bf0[23], bf0[20]);
+  bf1[21] = vsubq_s32(bf0[22], bf0[21]);
+  bf1[22] = vaddq_s32(bf0[22], bf0[21]);
+  bf1[23] = vaddq_s32(bf0[23], bf0[20]);
+  bf1[24] = vaddq_s32(bf0[24], bf0[27]);
+  bf1[25] = vaddq_s32(bf0[25], bf0[26]);
+  bf1[26] = vsubq_s32(bf0[25], bf0[26]);
+  bf1[27] = vsubq_s32(bf0[24], bf0[27]);
+  bf1[28] = vsubq_s32(bf0[31], bf0[28]);
+  bf1[29] = vsubq_s32(bf0[30], bf0[29]);
+  bf1[30] = vaddq_s32(bf0[30], bf0[29]);
+  bf1[31] = vaddq_s32(bf0[31], bf0[28]);
+
+  // stage 6
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[1];
+  bf1[2] = bf0[2];
+  bf1[3] = bf0[3];
+  bf1[4] = half_btf_neon(cospi[56], bf0[4], cospi[8], bf0[7], v_bit);
+  bf1[5] = half_btf_neon(cospi[24], bf0[5], cospi[40], bf0[6], v_bit);
+  bf1[6] = half_btf_neon(cospi[24], bf0[6], -cospi[40], bf0[5], v_bit);
+  bf1[7] = half_btf_neon(cospi[56], bf0[7], -cospi[8], bf0[4], v_bit);
+  bf1[8] = vaddq_s32(bf0[8], bf0[9]);
+  bf1[9] = vsubq_s32(bf0[8], bf0[9]);
+  bf1[10] = vsubq_s32(bf0[11], bf0[10]);
+  bf1[11] = vaddq_s32(bf0[11], bf0[10]);
+  bf1[12] = vaddq_s32(bf0[12], bf0[13]);
+  bf1[13] = vsubq_s32(bf0[12], bf0[13]);
+  bf1[14] = vsubq_s32(bf0[15], bf0[14]);
+  bf1[15] = vaddq_s32(bf0[15], bf0[14]);
+  bf1[16] = bf0[16];
+  bf1[17] = half_btf_neon(-cospi[8], bf0[17], cospi[56], bf0[30], v_bit);
+  bf1[18] = half_btf_neon(-cospi[56], bf0[18], -cospi[8], bf0[29], v_bit);
+  bf1[19] = bf0[19];
+  bf1[20] = bf0[20];
+  bf1[21] = half_btf_neon(-cospi[40], bf0[21], cospi[24], bf0[26], v_bit);
+  bf1[22] = half_btf_neon(-cospi[24], bf0[22], -cospi[40], bf0[25], v_bit);
+  bf1[23] = bf0[23];
+  bf1[24] = bf0[24];
+  bf1[25] = half_btf_neon(cospi[24], bf0[25], -cospi[40], bf0[22], v_bit);
+  bf1[26] = half_btf_neon(cospi[40], bf0[26], cospi[24], bf0[21], v_bit);
+  bf1[27] = bf0[27];
+  bf1[28] = bf0[28];
+  bf1[29] = half_btf_neon(cospi[56], bf0[29], -cospi[8], bf0[18], v_bit);
+  bf1[30] = half_btf_neon(cospi[8], bf0[30], cospi[56], bf0[17], v_bit);
+  bf1[31] = bf0[31];
+
+  // stage 7
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[1];
+  bf1[2] = bf0[2];
+  bf1[3] = bf0[3];
+  bf1[4] = bf0[4];
+  bf1[5] = bf0[5];
+  bf1[6] = bf0[6];
+  bf1[7] = bf0[7];
+  bf1[8] = half_btf_neon(cospi[60], bf0[8], cospi[4], bf0[15], v_bit);
+  bf1[9] = half_btf_neon(cospi[28], bf0[9], cospi[36], bf0[14], v_bit);
+  bf1[10] = half_btf_neon(cospi[44], bf0[10], cospi[20], bf0[13], v_bit);
+  bf1[11] = half_btf_neon(cospi[12], bf0[11], cospi[52], bf0[12], v_bit);
+  bf1[12] = half_btf_neon(cospi[12], bf0[12], -cospi[52], bf0[11], v_bit);
+  bf1[13] = half_btf_neon(cospi[44], bf0[13], -cospi[20], bf0[10], v_bit);
+  bf1[14] = half_btf_neon(cospi[28], bf0[14], -cospi[36], bf0[9], v_bit);
+  bf1[15] = half_btf_neon(cospi[60], bf0[15], -cospi[4], bf0[8], v_bit);
+  bf1[16] = vaddq_s32(bf0[16], bf0[17]);
+  bf1[17] = vsubq_s32(bf0[16], bf0[17]);
+  bf1[18] = vsubq_s32(bf0[19], bf0[18]);
+  bf1[19] = vaddq_s32(bf0[19], bf0[18]);
+  bf1[20] = vaddq_s32(bf0[20], bf0[21]);
+  bf1[21] = vsubq_s32(bf0[20], bf0[21]);
+  bf1[22] = vsubq_s32(bf0[23], bf0[22]);
+  bf1[23] = vaddq_s32(bf0[23], bf0[22]);
+  bf1[24] = vaddq_s32(bf0[24], bf0[25]);
+  bf1[25] = vsubq_s32(bf0[24], bf0[25]);
+  bf1[26] = vsubq_s32(bf0[27], bf0[26]);
+  bf1[27] = vaddq_s32(bf0[27], bf0[26]);
+  bf1[28] = vaddq_s32(bf0[28], bf0[29]);
+  bf1[29] = vsubq_s32(bf0[28], bf0[29]);
+  bf1[30] = vsubq_s32(bf0[31], bf0[30]);
+  bf1[31] = vaddq_s32(bf0[31], bf0[30]);
+
+  // stage 8
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[1];
+  bf1[2] = bf0[2];
+  bf1[3] = bf0[3];
+  bf1[4] = bf0[4];
+  bf1[5] = bf0[5];
+  bf1[6] = bf0[6];
+  bf1[7] = bf0[7];
+  bf1[8] = bf0[8];
+  bf1[9] = bf0[9];
+  bf1[10] = bf0[10];
+  bf1[11] = bf0[11];
+  bf1[12] = bf0[12];
+  bf1[13] = bf0[13];
+  bf1[14] = bf0[14];
+  bf1[15] = bf0[15];
+  bf1[16] = half_btf_neon(cospi[62], bf0[16], cospi[2], bf0[31], v_bit);
+  bf1[17] = half_btf_neon(cospi[30], bf0[17], cospi[34], bf0[30], v_bit);
+  bf1[18] = half_btf_neon(cospi[46], bf0[18], cospi[18], bf0[29], v_bit);
+  bf1[19] = half_btf_neon(cospi[14], bf0[19], cospi[50], bf0[28], v_bit);
+  bf1[20] = half_btf_neon(cospi[54], bf0[20], cospi[10], bf0[27], v_bit);
+  bf1[21] = half_btf_neon(cospi[22], bf0[21], cospi[42], bf0[26], v_bit);
+  bf1[22] = half_btf_neon(cospi[38], bf0[22], cospi[26], bf0[25], v_bit);
+  bf1[23] = half_btf_neon(cospi[6], bf0[23], cospi[58], bf0[24], v_bit);
+  bf1[24] = half_btf_neon(cospi[6], bf0[24], -cospi[58], bf0[23], v_bit);
+  bf1[25] = half_btf_neon(cospi[38], bf0[25], -cospi[26], bf0[22], v_bit);
+  bf1[26] = half_btf_neon(cospi[22], bf0[26], -cospi[42], bf0[21], v_bit);
+  bf1[27] = half_btf_neon(cospi[54], bf0[27], -cospi[10], bf0[20], v_bit);
+  bf1[28] = half_btf_neon(cospi[14], bf0[28], -cospi[50], bf0[19], v_bit);
+  bf1[29] = half_btf_neon(cospi[46], bf0[29], -cospi[18], bf0[18], v_bit);
+  bf1[30] = half_btf_neon(cospi[30], bf0[30], -cospi[34], bf0[17], v_bit);
+  bf1[31] = half_btf_neon(cospi[62], bf0[31], -cospi[2], bf0[16], v_bit);
+
+  // stage 9
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[16];
+  bf1[2] = bf0[8];
+  bf1[3] = bf0[24];
+  bf1[4] = bf0[4];
+  bf1[5] = bf0[20];
+  bf1[6] = bf0[12];
+  bf1[7] = bf0[28];
+  bf1[8] = bf0[2];
+  bf1[9] = bf0[18];
+  bf1[10] = bf0[10];
+  bf1[11] = bf0[26];
+  bf1[12] = bf0[6];
+  bf1[13] = bf0[22];
+  bf1[14] = bf0[14];
+  bf1[15] = bf0[30];
+  bf1[16] = bf0[1];
+  bf1[17] = bf0[17];
+  bf1[18] = bf0[9];
+  bf1[19] = bf0[25];
+  bf1[20] = bf0[5];
+  bf1[21] = bf0[21];
+  bf1[22] = bf0[13];
+  bf1[23] = bf0[29];
+  bf1[24] = bf0[3];
+  bf1[25] = bf0[19];
+  bf1[26] = bf0[11];
+  bf1[27] = bf0[27];
+  bf1[28] = bf0[7];
+  bf1[29] = bf0[23];
+  bf1[30] = bf0[15];
+  bf1[31] = bf0[31];
+}
+
+static void fdct64_new_neon(const int32x4_t *input, int32x4_t *output,
+                            int8_t cos_bit) {
+  const int32x4_t v_bit = vdupq_n_s32(-cos_bit);
+  const int32_t *cospi = cospi_arr(cos_bit);
+  int32x4_t *bf0, *bf1;
+  int32x4_t step[64];
+
+  // stage 1
+  bf1 = output;
+  bf1[0] = vaddq_s32(input[0], input[63]);
+  bf1[1] = vaddq_s32(input[1], input[62]);
+  bf1[2] = vaddq_s32(input[2], input[61]);
+  bf1[3] = vaddq_s32(input[3], input[60]);
+  bf1[4] = vaddq_s32(input[4], input[59]);
+  bf1[5] = vaddq_s32(input[5], input[58]);
+  bf1[6] = vaddq_s32(input[6], input[57]);
+  bf1[7] = vaddq_s32(input[7], input[56]);
+  bf1[8] = vaddq_s32(input[8], input[55]);
+  bf1[9] = vaddq_s32(input[9], input[54]);
+  bf1[10] = vaddq_s32(input[10], input[53]);
+  bf1[11] = vaddq_s32(input[11], input[52]);
+  bf1[12] = vaddq_s32(input[12], input[51]);
+  bf1[13] = vaddq_s32(input[13], input[50]);
+  bf1[14] = vaddq_s32(input[14], input[49]);
+  bf1[15] = vaddq_s32(input[15], input[48]);
+  bf1[16] = vaddq_s32(input[16], input[47]);
+  bf1[17] = vaddq_s32(input[17], input[46]);
+  bf1[18] = vaddq_s32(input[18], input[45]);
+  bf1[19] = vaddq_s32(input[19], input[44]);
+  bf1[20] = vaddq_s32(input[20], input[43]);
+  bf1[21] = vaddq_s32(input[21], input[42]);
+  bf1[22] = vaddq_s32(input[22], input[41]);
+  bf1[23] = vaddq_s32(input[23], input[40]);
+  bf1[24] = vaddq_s32(input[24], input[39]);
+  bf1[25] = vaddq_s32(input[25], input[38]);
+  bf1[26] = vaddq_s32(input[26], input[37]);
+  bf1[27] = vaddq_s32(input[27], input[36]);
+  bf1[28] = vaddq_s32(input[28], input[35]);
+  bf1[29] = vaddq_s32(input[29], input[34]);
+  bf1[30] = vaddq_s32(input[30], input[33]);
+  bf1[31] = vaddq_s32(input[31], input[32]);
+  bf1[32] = vsubq_s32(input[31], input[32]);
+  bf1[33] = vsubq_s32(input[30], input[33]);
+  bf1[34] = vsubq_s32(input[29], input[34]);
+  bf1[35] = vsubq_s32(input[28], input[35]);
+  bf1[36] = vsubq_s32(input[27], input[36]);
+  bf1[37] = vsubq_s32(input[26], input[37]);
+  bf1[38] = vsubq_s32(input[25], input[38]);
+  bf1[39] = vsubq_s32(input[24], input[39]);
+  bf1[40] = vsubq_s32(input[23], input[40]);
+  bf1[41] = vsubq_s32(input[22], input[41]);
+  bf1[42] = vsubq_s32(input[21], input[42]);
+  bf1[43] = vsubq_s32(input[20], input[43]);
+  bf1[44] = vsubq_s32(input[19], input[44]);
+  bf1[45] = vsubq_s32(input[18], input[45]);
+  bf1[46] = vsubq_s32(input[17], input[46]);
+  bf1[47] = vsubq_s32(input[16], input[47]);
+  bf1[48] = vsubq_s32(input[15], input[48]);
+  bf1[49] = vsubq_s32(input[14], input[49]);
+  bf1[50] = vsubq_s32(input[13], input[50]);
+  bf1[51] = vsubq_s32(input[12], input[51]);
+  bf1[52] = vsubq_s32(input[11], input[52]);
+  bf1[53] = vsubq_s32(input[10], input[53]);
+  bf1[54] = vsubq_s32(input[9], input[54]);
+  bf1[55] = vsubq_s32(input[8], input[55]);
+  bf1[56] = vsubq_s32(input[7], input[56]);
+  bf1[57] = vsubq_s32(input[6], input[57]);
+  bf1[58] = vsubq_s32(input[5], input[58]);
+  bf1[59] = vsubq_s32(input[4], input[59]);
+  bf1[60] = vsubq_s32(input[3], input[60]);
+  bf1[61] = vsubq_s32(input[2], input[61]);
+  bf1[62] = vsubq_s32(input[1], input[62]);
+  bf1[63] = vsubq_s32(input[0], input[63]);
+
+  // stage 2
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = vaddq_s32(bf0[0], bf0[31]);
+  bf1[1] = vaddq_s32(bf0[1], bf0[30]);
+  bf1[2] = vaddq_s32(bf0[2], bf0[29]);
+  bf1[3] = vaddq_s32(bf0[3], bf0[28]);
+  bf1[4] = vaddq_s32(bf0[4], bf0[27]);
+  bf1[5] = vaddq_s32(bf0[5], bf0[26]);
+  bf1[6] = vaddq_s32(bf0[6], bf0[25]);
+  bf1[7] = vaddq_s32(bf0[7], bf0[24]);
+  bf1[8] = vaddq_s32(bf0[8], bf0[23]);
+  bf1[9] = vaddq_s32(bf0[9], bf0[22]);
+  bf1[10] = vaddq_s32(bf0[10], bf0[21]);
+  bf1[11] = vaddq_s32(bf0[11], bf0[20]);
+  bf1[12] = vaddq_s32(bf0[12], bf0[19]);
+  bf1[13] = vaddq_s32(bf0[13], bf0[18]);
+  bf1[14] = vaddq_s32(bf0[14], bf0[17]);
+  bf1[15] = vaddq_s32(bf0[15], bf0[16]);
+  bf1[16] = vsubq_s32(bf0[15], bf0[16]);
+  bf1[17] = vsubq_s32(bf0[14], bf0[17]);
+  bf1[18] = vsubq_s32(bf0[13], bf0[18]);
+  bf1[19] = vsubq_s32(bf0[12], bf0[19]);
+  bf1[20] = vsubq_s32(bf0[11], bf0[20]);
+  bf1[21] = vsubq_s32(bf0[10], bf0[21]);
+  bf1[22] = vsubq_s32(bf0[9], bf0[22]);
+  bf1[23] = vsubq_s32(bf0[8], bf0[23]);
+  bf1[24] = vsubq_s32(bf0[7], bf0[24]);
+  bf1[25] = vsubq_s32(bf0[6], bf0[25]);
+  bf1[26] = vsubq_s32(bf0[5], bf0[26]);
+  bf1[27] = vsubq_s32(bf0[4], bf0[27]);
+  bf1[28] = vsubq_s32(bf0[3], bf0[28]);
+  bf1[29] = vsubq_s32(bf0[2], bf0[29]);
+  bf1[30] = vsubq_s32(bf0[1], bf0[30]);
+  bf1[31] = vsubq_s32(bf0[0], bf0[31]);
+  bf1[32] = bf0[32];
+  bf1[33] = bf0[33];
+  bf1[34] = bf0[34];
+  bf1[35] = bf0[35];
+  bf1[36] = bf0[36];
+  bf1[37] = bf0[37];
+  bf1[38] = bf0[38];
+  bf1[39] = bf0[39];
+  bf1[40] = half_btf_neon(-cospi[32], bf0[40], cospi[32], bf0[55], v_bit);
+  bf1[41] = half_btf_neon(-cospi[32], bf0[41], cospi[32], bf0[54], v_bit);
+  bf1[42] = half_btf_neon(-cospi[32], bf0[42], cospi[32], bf0[53], v_bit);
+  bf1[43] = half_btf_neon(-cospi[32], bf0[43], cospi[32], bf0[52], v_bit);
+  bf1[44] = half_btf_neon(-cospi[32], bf0[44], cospi[32], bf0[51], v_bit);
+  bf1[45] = half_btf_neon(-cospi[32], bf0[45], cospi[32], bf0[50], v_bit);
+  bf1[46] = half_btf_neon(-cospi[32], bf0[46], cospi[32], bf0[49], v_bit);
+  bf1[47] = half_btf_neon(-cospi[32], bf0[47], cospi[32], bf0[48], v_bit);
+  bf1[48] = half_btf_neon(cospi[32], bf0[48], cospi[32], bf0[47], v_bit);
+  bf1[49] = half_btf_neon(cospi[32], bf0[49], cospi[32], bf0[46], v_bit);
+  bf1[50] = half_btf_neon(cospi[32], bf0[50], cospi[32], bf0[45], v_bit);
+  bf1[51] = half_btf_neon(cospi[32], bf0[51], cospi[32], bf0[44], v_bit);
+  bf1[52] = half_btf_neon(cospi[32], bf0[52], cospi[32], bf0[43], v_bit);
+  bf1[53] = half_btf_neon(cospi[32], bf0[53], cospi[32], bf0[42], v_bit);
+  bf1[54] = half_btf_neon(cospi[32], bf0[54], cospi[32], bf0[41], v_bit);
+  bf1[55] = half_btf_neon(cospi[32], bf0[55], cospi[32], bf0[40], v_bit);
+  bf1[56] = bf0[56];
+  bf1[57] = bf0[57];
+  bf1[58] = bf0[58];
+  bf1[59] = bf0[59];
+  bf1[60] = bf0[60];
+  bf1[61] = bf0[61];
+  bf1[62] = bf0[62];
+  bf1[63] = bf0[63];
+
+  // stage 3
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = vaddq_s32(bf0[0], bf0[15]);
+  bf1[1] = vaddq_s32(bf0[1], bf0[14]);
+  bf1[2] = vaddq_s32(bf0[2], bf0[13]);
+  bf1[3] = vaddq_s32(bf0[3], bf0[12]);
+  bf1[4] = vaddq_s32(bf0[4], bf0[11]);
+  bf1[5] = vaddq_s32(bf0[5], bf0[10]);
+  bf1[6] = vaddq_s32(bf0[6], bf0[9]);
+  bf1[7] = vaddq_s32(bf0[7], bf0[8]);
+  bf1[8] = vsubq_s32(bf0[7], bf0[8]);
+  bf1[9] = vsubq_s32(bf0[6], bf0[9]);
+  bf1[10] = vsubq_s32(bf0[5], bf0[10]);
+  bf1[11] = vsubq_s32(bf0[4], bf0[11]);
+  bf1[12] = vsubq_s32(bf0[3], bf0[12]);
+  bf1[13] = vsubq_s32(bf0[2], bf0[13]);
+  bf1[14] = vsubq_s32(bf0[1], bf0[14]);
+  bf1[15] = vsubq_s32(bf0[0], bf0[15]);
+  bf1[16] = bf0[16];
+  bf1[17] = bf0[17];
+  bf1[18] = bf0[18];
+  bf1[19] = bf0[19];
+  bf1[20] = half_btf_neon(-cospi[32], bf0[20], cospi[32], bf0[27], v_bit);
+  bf1[21] = half_btf_neon(-cospi[32], bf0[21], cospi[32], bf0[26], v_bit);
+  bf1[22] = half_btf_neon(-cospi[32], bf0[22], cospi[32], bf0[25], v_bit);
+  bf1[23] = half_btf_neon(-cospi[32], bf0[23], cospi[32], bf0[24], v_bit);
+  bf1[24] = half_btf_neon(cospi[32], bf0[24], cospi[32], bf0[23], v_bit);
+  bf1[25] = half_btf_neon(cospi[32], bf0[25], cospi[32], bf0[22], v_bit);
+  bf1[26] = half_btf_neon(cospi[32], bf0[26], cospi[32], bf0[21], v_bit);
+  bf1[27] = half_btf_neon(cospi[32], bf0[27], cospi[32], bf0[20], v_bit);
+  bf1[28] = bf0[28];
+  bf1[29] = bf0[29];
+  bf1[30] = bf0[30];
+  bf1[31] = bf0[31];
+  bf1[32] = vaddq_s32(bf0[32], bf0[47]);
+  bf1[33] = vaddq_s32(bf0[33], bf0[46]);
+  bf1[34] = vaddq_s32(bf0[34], bf0[45]);
+  bf1[35] = vaddq_s32(bf0[35], bf0[44]);
+  bf1[36] = vaddq_s32(bf0[36], bf0[43]);
+  bf1[37] = vaddq_s32(bf0[37], bf0[42]);
+  bf1[38] = vaddq_s32(bf0[38], bf0[41]);
+  bf1[39] = vaddq_s32(bf0[39], bf0[40]);
+  bf1[40] = vsubq_s32(bf0[39], bf0[40]);
+  bf1[41] = vsubq_s32(bf0[38], bf0[41]);
+  bf1[42] = vsubq_s32(bf0[37], bf0[42]);
+  bf1[43] = vsubq_s32(bf0[36], bf0[43]);
+  bf1[44] = vsubq_s32(bf0[35], bf0[44]);
+  bf1[45] = vsubq_s32(bf0[34], bf0[45]);
+  bf1[46] = vsubq_s32(bf0[33], bf0[46]);
+  bf1[47] = vsubq_s32(bf0[32], bf0[47]);
+  bf1[48] = vsubq_s32(bf0[63], bf0[48]);
+  bf1[49] = vsubq_s32(bf0[62], bf0[49]);
+  bf1[50] = vsubq_s32(bf0[61], bf0[50]);
+  bf1[51] = vsubq_s32(bf0[60], bf0[51]);
+  bf1[52] = vsubq_s32(bf0[59], bf0[52]);
+  bf1[53] = vsubq_s32(bf0[58], bf0[53]);
+  bf1[54] = vsubq_s32(bf0[57], bf0[54]);
+  bf1[55] = vsubq_s32(bf0[56], bf0[55]);
+  bf1[56] = vaddq_s32(bf0[56], bf0[55]);
+  bf1[57] = vaddq_s32(bf0[57], bf0[54]);
+  bf1[58] = vaddq_s32(bf0[58], bf0[53]);
+  bf1[59] = vaddq_s32(bf0[59], bf0[52]);
+  bf1[60] = vaddq_s32(bf0[60], bf0[51]);
+  bf1[61] = vaddq_s32(bf0[61], bf0[50]);
+  bf1[62] = vaddq_s32(bf0[62], bf0[49]);
+  bf1[63] = vaddq_s32(bf0[63], bf0[48]);
+
+  // stage 4
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = vaddq_s32(bf0[0], bf0[7]);
+  bf1[1] = vaddq_s32(bf0[1], bf0[6]);
+  bf1[2] = vaddq_s32(bf0[2], bf0[5]);
+  bf1[3] = vaddq_s32(bf0[3], bf0[4]);
+  bf1[4] = vsubq_s32(bf0[3], bf0[4]);
+  bf1[5] = vsubq_s32(bf0[2], bf0[5]);
+  bf1[6] = vsubq_s32(bf0[1], bf0[6]);
+  bf1[7] = vsubq_s32(bf0[0], bf0[7]);
+  bf1[8] = bf0[8];
+  bf1[9] = bf0[9];
+  bf1[10] = half_btf_neon(-cospi[32], bf0[10], cospi[32], bf0[13], v_bit);
+  bf1[11] = half_btf_neon(-cospi[32], bf0[11], cospi[32], bf0[12], v_bit);
+  bf1[12] = half_btf_neon(cospi[32], bf0[12], cospi[32], bf0[11], v_bit);
+  bf1[13] = half_btf_neon(cospi[32], bf0[13], cospi[32], bf0[10], v_bit);
+  bf1[14] = bf0[14];
+  bf1[15] = bf0[15];
+  bf1[16] = vaddq_s32(bf0[16], bf0[23]);
+  bf1[17] = vaddq_s32(bf0[17], bf0[22]);
+  bf1[18] = vaddq_s32(bf0[18], bf0[21]);
+  bf1[19] = vaddq_s32(bf0[19], bf0[20]);
+  bf1[20] = vsubq_s32(bf0[19], bf0[20]);
+  bf1[21] = vsubq_s32(bf0[18], bf0[21]);
+  bf1[22] = vsubq_s32(bf0[17], bf0[22]);
+  bf1[23] = vsubq_s32(bf0[16], bf0[23]);
+  bf1[24] = vsubq_s32(bf0[31], bf0[24]);
+  bf1[25] = vsubq_s32(bf0[30], bf0[25]);
+  bf1[26] = vsubq_s32(bf0[29], bf0[26]);
+  bf1[27] = vsubq_s32(bf0[28], bf0[27]);
+  bf1[28] = vaddq_s32(bf0[28], bf0[27]);
+  bf1[29] = vaddq_s32(bf0[29], bf0[26]);
+  bf1[30] = vaddq_s32(bf0[30], bf0[25]);
+  bf1[31] = vaddq_s32(bf0[31], bf0[24]);
+  bf1[32] = bf0[32];
+  bf1[33] = bf0[33];
+  bf1[34] = bf0[34];
+  bf1[35] = bf0[35];
+  bf1[36] = half_btf_neon(-cospi[16], bf0[36], cospi[48], bf0[59], v_bit);
+  bf1[37] = half_btf_neon(-cospi[16], bf0[37], cospi[48], bf0[58], v_bit);
+  bf1[38] = half_btf_neon(-cospi[16], bf0[38], cospi[48], bf0[57], v_bit);
+  bf1[39] = half_btf_neon(-cospi[16], bf0[39], cospi[48], bf0[56], v_bit);
+  bf1[40] = half_btf_neon(-cospi[48], bf0[40], -cospi[16], bf0[55], v_bit);
+  bf1[41] = half_btf_neon(-cospi[48], bf0[41], -cospi[16], bf0[54], v_bit);
+  bf1[42] = half_btf_neon(-cospi[48], bf0[42], -cospi[16], bf0[53], v_bit);
+  bf1[43] = half_btf_neon(-cospi[48], bf0[43], -cospi[16], bf0[52], v_bit);
+  bf1[44] = bf0[44];
+  bf1[45] = bf0[45];
+  bf1[46] = bf0[46];
+  bf1[47] = bf0[47];
+  bf1[48] = bf0[48];
+  bf1[49] = bf0[49];
+  bf1[50] = bf0[50];
+  bf1[51] = bf0[51];
+  bf1[52] = half_btf_neon(cospi[48], bf0[52], -cospi[16], bf0[43], v_bit);
+  bf1[53] = half_btf_neon(cospi[48], bf0[53], -cospi[16], bf0[42], v_bit);
+  bf1[54] = half_btf_neon(cospi[48], bf0[54], -cospi[16], bf0[41], v_bit);
+  bf1[55] = half_btf_neon(cospi[48], bf0[55], -cospi[16], bf0[40], v_bit);
+  bf1[56] = half_btf_neon(cospi[16], bf0[56], cospi[48], bf0[39], v_bit);
+  bf1[57] = half_btf_neon(cospi[16], bf0[57], cospi[48], bf0[38], v_bit);
+  bf1[58] = half_btf_neon(cospi[16], bf0[58], cospi[48], bf0[37], v_bit);
+  bf1[59] = half_btf_neon(cospi[16], bf0[59], cospi[48], bf0[36], v_bit);
+  bf1[60] = bf0[60];
+  bf1[61] = bf0[61];
+  bf1[62] = bf0[62];
+  bf1[63] = bf0[63];
+
+  // stage 5
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = vaddq_s32(bf0[0], bf0[3]);
+  bf1[1] = vaddq_s32(bf0[1], bf0[2]);
+  bf1[2] = vsubq_s32(bf0[1], bf0[2]);
+  bf1[3] = vsubq_s32(bf0[0], bf0[3]);
+  bf1[4] = bf0[4];
+  bf1[5] = half_btf_neon(-cospi[32], bf0[5], cospi[32], bf0[6], v_bit);
+  bf1[6] = half_btf_neon(cospi[32], bf0[6], cospi[32], bf0[5], v_bit);
+  bf1[7] = bf0[7];
+  bf1[8] = vaddq_s32(bf0[8], bf0[11]);
+  bf1[9] = vaddq_s32(bf0[9], bf0[10]);
+  bf1[10] = vsubq_s32(bf0[9], bf0[10]);
+  bf1[11] = vsubq_s32(bf0[8], bf0[11]);
+  bf1[12] = vsubq_s32(bf0[15], bf0[12]);
+  bf1[13] = vsubq_s32(bf0[14], bf0[13]);
+  bf1[14] = vaddq_s32(bf0[14], bf0[13]);
+  bf1[15] = vaddq_s32(bf0[15], bf0[12]);
+  bf1[16] = bf0[16];
+  bf1[17] = bf0[17];
+  bf1[18] = half_btf_neon(-cospi[16], bf0[18], cospi[48], bf0[29], v_bit);
+  bf1[19] = half_btf_neon(-cospi[16], bf0[19], cospi[48], bf0[28], v_bit);
+  bf1[20] = half_btf_neon(-cospi[48], bf0[20], -cospi[16], bf0[27], v_bit);
+  bf1[21] = half_btf_neon(-cospi[48], bf0[21], -cospi[16], bf0[26], v_bit);
+  bf1[22] = bf0[22];
+  bf1[23] = bf0[23];
+  bf1[24] = bf0[24];
+  bf1[25] = bf0[25];
+  bf1[26] = half_btf_neon(cospi[48], bf0[26], -cospi[16], bf0[21], v_bit);
+  bf1[27] = half_btf_neon(cospi[48], bf0[27], -cospi[16], bf0[20], v_bit);
+  bf1[28] = half_btf_neon(cospi[16], bf0[28], cospi[48], bf0[19], v_bit);
+  bf1[29] = half_btf_neon(cospi[16], bf0[29], cospi[48], bf0[18], v_bit);
+  bf1[30] = bf0[30];
+  bf1[31] = bf0[31];
+  bf1[32] = vaddq_s32(bf0[32], bf0[39]);
+  bf1[33] = vaddq_s32(bf0[33], bf0[38]);
+  bf1[34] = vaddq_s32(bf0[34], bf0[37]);
+  bf1[35] = vaddq_s32(bf0[35], bf0[36]);
+  bf1[36] = vsubq_s32(bf0[35], bf0[36]);
+  bf1[37] = vsubq_s32(bf0[34], bf0[37]);
+  bf1[38] = vsubq_s32(bf0[33], bf0[38]);
+  bf1[39] = vsubq_s32(bf0[32], bf0[39]);
+  bf1[40] = vsubq_s32(bf0[47], bf0[40]);
+  bf1[41] = vsubq_s32(bf0[46], bf0[41]);
+  bf1[42] = vsubq_s32(bf0[45], bf0[42]);
+  bf1[43] = vsubq_s32(bf0[44], bf0[43]);
+  bf1[44] = vaddq_s32(bf0[44], bf0[43]);
+  bf1[45] = vaddq_s32(bf0[45], bf0[42]);
+  bf1[46] = vaddq_s32(bf0[46], bf0[41]);
+  bf1[47] = vaddq_s32(bf0[47], bf0[40]);
+  bf1[48] = vaddq_s32(bf0[48], bf0[55]);
+  bf1[49] = vaddq_s32(bf0[49], bf0[54]);
+  bf1[50] = vaddq_s32(bf0[50], bf0[53]);
+  bf1[51] = vaddq_s32(bf0[51], bf0[52]);
+  bf1[52] = vsubq_s32(bf0[51], bf0[52]);
+  bf1[53] = vsubq_s32(bf0[50], bf0[53]);
+  bf1[54] = vsubq_s32(bf0[49], bf0[54]);
+  bf1[55] = vsubq_s32(bf0[48], bf0[55]);
+  bf1[56] = vsubq_s32(bf0[63], bf0[56]);
+  bf1[57] = vsubq_s32(bf0[62], bf0[57]);
+  bf1[58] = vsubq_s32(bf0[61], bf0[58]);
+  bf1[59] = vsubq_s32(bf0[60], bf0[59]);
+  bf1[60] = vaddq_s32(bf0[60], bf0[59]);
+  bf1[61] = vaddq_s32(bf0[61], bf0[58]);
+  bf1[62] = vaddq_s32(bf0[62], bf0[57]);
+  bf1[63] = vaddq_s32(bf0[63], bf0[56]);
+
+  // stage 6
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = half_btf_neon(cospi[32], bf0[0], cospi[32], bf0[1], v_bit);
+  bf1[1] = half_btf_neon(-cospi[32], bf0[1], cospi[32], bf0[0], v_bit);
+  bf1[2] = half_btf_neon(cospi[48], bf0[2], cospi[16], bf0[3], v_bit);
+  bf1[3] = half_btf_neon(cospi[48], bf0[3], -cospi[16], bf0[2], v_bit);
+  bf1[4] = vaddq_s32(bf0[4], bf0[5]);
+  bf1[5] = vsubq_s32(bf0[4], bf0[5]);
+  bf1[6] = vsubq_s32(bf0[7], bf0[6]);
+  bf1[7] = vaddq_s32(bf0[7], bf0[6]);
+  bf1[8] = bf0[8];
+  bf1[9] = half_btf_neon(-cospi[16], bf0[9], cospi[48], bf0[14], v_bit);
+  bf1[10] = half_btf_neon(-cospi[48], bf0[10], -cospi[16], bf0[13], v_bit);
+  bf1[11] = bf0[11];
+  bf1[12] = bf0[12];
+  bf1[13] = half_btf_neon(cospi[48], bf0[13], -cospi[16], bf0[10], v_bit);
+  bf1[14] = half_btf_neon(cospi[16], bf0[14], cospi[48], bf0[9], v_bit);
+  bf1[15] = bf0[15];
+  bf1[16] = vaddq_s32(bf0[16], bf0[19]);
+  bf1[17] = vaddq_s32(bf0[17], bf0[18]);
+  bf1[18] = vsubq_s32(bf0[17], bf0[18]);
+  bf1[19] = vsubq_s32(bf0[16], bf0[19]);
+  bf1[20] = vsubq_s32(bf0[23], bf0[20]);
+  bf1[21] = vsubq_s32(bf0[22], bf0[21]);
+  bf1[22] = vaddq_s32(bf0[22], bf0[21]);
+  bf1[23] = vaddq_s32(bf0[23], bf0[20]);
+  bf1[24] = vaddq_s32(bf0[24], bf0[27]);
+  bf1[25] = vaddq_s32(bf0[25], bf0[26]);
+  bf1[26] = vsubq_s32(bf0[25], bf0[26]);
+  bf1[27] = vsubq_s32(bf0[24], bf0[27]);
+  bf1[28] = vsubq_s32(bf0[31], bf0[28]);
+  bf1[29] = vsubq_s32(bf0[30], bf0[29]);
+  bf1[30] = vaddq_s32(bf0[30], bf0[29]);
+  bf1[31] = vaddq_s32(bf0[31], bf0[28]);
+  bf1[32] = bf0[32];
+  bf1[33] = bf0[33];
+  bf1[34] = half_btf_neon(-cospi[8], bf0[34], cospi[56], bf0[61], v_bit);
+  bf1[35] = half_btf_neon(-cospi[8], bf0[35], cospi[56], bf0[60], v_bit);
+  bf1[36] = half_btf_neon(-cospi[56], bf0[36], -cospi[8], bf0[59], v_bit);
+  bf1[37] = half_btf_neon(-cospi[56], bf0[37], -cospi[8], bf0[58], v_bit);
+  bf1[38] = bf0[38];
+  bf1[39] = bf0[39];
+  bf1[40] = bf0[40];
+  bf1[41] = bf0[41];
+  bf1[42] = half_btf_neon(-cospi[40], bf0[42], cospi[24], bf0[53], v_bit);
+  bf1[43] = half_btf_neon(-cospi[40], bf0[43], cospi[24], bf0[52], v_bit);
+  bf1[44] = half_btf_neon(-cospi[24], bf0[44], -cospi[40], bf0[51], v_bit);
+  bf1[45] = half_btf_neon(-cospi[24], bf0[45], -cospi[40], bf0[50], v_bit);
+  bf1[46] = bf0[46];
+  bf1[47] = bf0[47];
+  bf1[48] = bf0[48];
+  bf1[49] = bf0[49];
+  bf1[50] = half_btf_neon(cospi[24], bf0[50], -cospi[40], bf0[45], v_bit);
+  bf1[51] = half_btf_neon(cospi[24], bf0[51], -cospi[40], bf0[44], v_bit);
+  bf1[52] = half_btf_neon(cospi[40], bf0[52], cospi[24], bf0[43], v_bit);
+  bf1[53] = half_btf_neon(cospi[40], bf0[53], cospi[24], bf0[42], v_bit);
+  bf1[54] = bf0[54];
+  bf1[55] = bf0[55];
+  bf1[56] = bf0[56];
+  bf1[57] = bf0[57];
+  bf1[58] = half_btf_neon(cospi[56], bf0[58], -cospi[8], bf0[37], v_bit);
+  bf1[59] = half_btf_neon(cospi[56], bf0[59], -cospi[8], bf0[36], v_bit);
+  bf1[60] = half_btf_neon(cospi[8], bf0[60], cospi[56], bf0[35], v_bit);
+  bf1[61] = half_btf_neon(cospi[8], bf0[61], cospi[56], bf0[34], v_bit);
+  bf1[62] = bf0[62];
+  bf1[63] = bf0[63];
+
+  // stage 7
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[1];
+  bf1[2] = bf0[2];
+  bf1[3] = bf0[3];
+  bf1[4] = half_btf_neon(cospi[56], bf0[4], cospi[8], bf0[7], v_bit);
+  bf1[5] = half_btf_neon(cospi[24], bf0[5], cospi[40], bf0[6], v_bit);
+  bf1[6] = half_btf_neon(cospi[24], bf0[6], -cospi[40], bf0[5], v_bit);
+  bf1[7] = half_btf_neon(cospi[56], bf0[7], -cospi[8], bf0[4], v_bit);
+  bf1[8] = vaddq_s32(bf0[8], bf0[9]);
+  bf1[9] = vsubq_s32(bf0[8], bf0[9]);
+  bf1[10] = vsubq_s32(bf0[11], bf0[10]);
+  bf1[11] = vaddq_s32(bf0[11], bf0[10]);
+  bf1[12] = vaddq_s32(bf0[12], bf0[13]);
+  bf1[13] = vsubq_s32(bf0[12], bf0[13]);
+  bf1[14] = vsubq_s32(bf0[15], bf0[14]);
+  bf1[15] = vaddq_s32(bf0[15], bf0[14]);
+  bf1[16] = bf0[16];
+  bf1[17] = half_btf_neon(-cospi[8], bf0[17], cospi[56], bf0[30], v_bit);
+  bf1[18] = half_btf_neon(-cospi[56], bf0[18], -cospi[8], bf0[29], v_bit);
+  bf1[19] = bf0[19];
+  bf1[20] = bf0[20];
+  bf1[21] = half_btf_neon(-cospi[40], bf0[21], cospi[24], bf0[26], v_bit);
+  bf1[22] = half_btf_neon(-cospi[24], bf0[22], -cospi[40], bf0[25], v_bit);
+  bf1[23] = bf0[23];
+  bf1[24] = bf0[24];
+  bf1[25] = half_btf_neon(cospi[24], bf0[25], -cospi[40], bf0[22], v_bit);
+  bf1[26] = half_btf_neon(cospi[40], bf0[26], cospi[24], bf0[21], v_bit);
+  bf1[27] = bf0[27];
+  bf1[28] = bf0[28];
+  bf1[29] = half_btf_neon(cospi[56], bf0[29], -cospi[8], bf0[18], v_bit);
+  bf1[30] = half_btf_neon(cospi[8], bf0[30], cospi[56], bf0[17], v_bit);
+  bf1[31] = bf0[31];
+  bf1[32] = vaddq_s32(bf0[32], bf0[35]);
+  bf1[33] = vaddq_s32(bf0[33], bf0[34]);
+  bf1[34] = vsubq_s32(bf0[33], bf0[34]);
+  bf1[35] = vsubq_s32(bf0[32], bf0[35]);
+  bf1[36] = vsubq_s32(bf0[39], bf0[36]);
+  bf1[37] = vsubq_s32(bf0[38], bf0[37]);
+  bf1[38] = vaddq_s32(bf0[38], bf0[37]);
+  bf1[39] = vaddq_s32(bf0[39], bf0[36]);
+  bf1[40] = vaddq_s32(bf0[40], bf0[43]);
+  bf1[41] = vaddq_s32(bf0[41], bf0[42]);
+  bf1[42] = vsubq_s32(bf0[41], bf0[42]);
+  bf1[43] = vsubq_s32(bf0[40], bf0[43]);
+  bf1[44] = vsubq_s32(bf0[47], bf0[44]);
+  bf1[45] = vsubq_s32(bf0[46], bf0[45]);
+  bf1[46] = vaddq_s32(bf0[46], bf0[45]);
+  bf1[47] = vaddq_s32(bf0[47], bf0[44]);
+  bf1[48] = vaddq_s32(bf0[48], bf0[51]);
+  bf1[49] = vaddq_s32(bf0[49], bf0[50]);
+  bf1[50] = vsubq_s32(bf0[49], bf0[50]);
+  bf1[51] = vsubq_s32(bf0[48], bf0[51]);
+  bf1[52] = vsubq_s32(bf0[55], bf0[52]);
+  bf1[53] = vsubq_s32(bf0[54], bf0[53]);
+  bf1[54] = vaddq_s32(bf0[54], bf0[53]);
+  bf1[55] = vaddq_s32(bf0[55], bf0[52]);
+  bf1[56] = vaddq_s32(bf0[56], bf0[59]);
+  bf1[57] = vaddq_s32(bf0[57], bf0[58]);
+  bf1[58] = vsubq_s32(bf0[57], bf0[58]);
+  bf1[59] = vsubq_s32(bf0[56], bf0[59]);
+  bf1[60] = vsubq_s32(bf0[63], bf0[60]);
+  bf1[61] = vsubq_s32(bf0[62], bf0[61]);
+  bf1[62] = vaddq_s32(bf0[62], bf0[61]);
+  bf1[63] = vaddq_s32(bf0[63], bf0[60]);
+
+  // stage 8
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[1];
+  bf1[2] = bf0[2];
+  bf1[3] = bf0[3];
+  bf1[4] = bf0[4];
+  bf1[5] = bf0[5];
+  bf1[6] = bf0[6];
+  bf1[7] = bf0[7];
+  bf1[8] = half_btf_neon(cospi[60], bf0[8], cospi[4], bf0[15], v_bit);
+  bf1[9] = half_btf_neon(cospi[28], bf0[9], cospi[36], bf0[14], v_bit);
+  bf1[10] = half_btf_neon(cospi[44], bf0[10], cospi[20], bf0[13], v_bit);
+  bf1[11] = half_btf_neon(cospi[12], bf0[11], cospi[52], bf0[12], v_bit);
+  bf1[12] = half_btf_neon(cospi[12], bf0[12], -cospi[52], bf0[11], v_bit);
+  bf1[13] = half_btf_neon(cospi[44], bf0[13], -cospi[20], bf0[10], v_bit);
+  bf1[14] = half_btf_neon(cospi[28], bf0[14], -cospi[36], bf0[9], v_bit);
+  bf1[15] = half_btf_neon(cospi[60], bf0[15], -cospi[4], bf0[8], v_bit);
+  bf1[16] = vaddq_s32(bf0[16], bf0[17]);
+  bf1[17] = vsubq_s32(bf0[16], bf0[17]);
+  bf1[18] = vsubq_s32(bf0[19], bf0[18]);
+  bf1[19] = vaddq_s32(bf0[19], bf0[18]);
+  bf1[20] = vaddq_s32(bf0[20], bf0[21]);
+  bf1[21] = vsubq_s32(bf0[20], bf0[21]);
+  bf1[22] = vsubq_s32(bf0[23], bf0[22]);
+  bf1[23] = vaddq_s32(bf0[23], bf0[22]);
+  bf1[24] = vaddq_s32(bf0[24], bf0[25]);
+  bf1[25] = vsubq_s32(bf0[24], bf0[25]);
+  bf1[26] = vsubq_s32(bf0[27], bf0[26]);
+  bf1[27] = vaddq_s32(bf0[27], bf0[26]);
+  bf1[28] = vaddq_s32(bf0[28], bf0[29]);
+  bf1[29] = vsubq_s32(bf0[28], bf0[29]);
+  bf1[30] = vsubq_s32(bf0[31], bf0[30]);
+  bf1[31] = vaddq_s32(bf0[31], bf0[30]);
+  bf1[32] = bf0[32];
+  bf1[33] = half_btf_neon(-cospi[4], bf0[33], cospi[60], bf0[62], v_bit);
+  bf1[34] = half_btf_neon(-cospi[60], bf0[34], -cospi[4], bf0[61], v_bit);
+  bf1[35] = bf0[35];
+  bf1[36] = bf0[36];
+  bf1[37] = half_btf_neon(-cospi[36], bf0[37], cospi[28], bf0[58], v_bit);
+  bf1[38] = half_btf_neon(-cospi[28], bf0[38], -cospi[36], bf0[57], v_bit);
+  bf1[39] = bf0[39];
+  bf1[40] = bf0[40];
+  bf1[41] = half_btf_neon(-cospi[20], bf0[41], cospi[44], bf0[54], v_bit);
+  bf1[42] = half_btf_neon(-cospi[44], bf0[42], -cospi[20], bf0[53], v_bit);
+  bf1[43] = bf0[43];
+  bf1[44] = bf0[44];
+  bf1[45] = half_btf_neon(-cospi[52], bf0[45], cospi[12], bf0[50], v_bit);
+  bf1[46] = half_btf_neon(-cospi[12], bf0[46], -cospi[52], bf0[49], v_bit);
+  bf1[47] = bf0[47];
+  bf1[48] = bf0[48];
+  bf1[49] = half_btf_neon(cospi[12], bf0[49], -cospi[52], bf0[46], v_bit);
+  bf1[50] = half_btf_neon(cospi[52], bf0[50], cospi[12], bf0[45], v_bit);
+  bf1[51] = bf0[51];
+  bf1[52] = bf0[52];
+  bf1[53] = half_btf_neon(cospi[44], bf0[53], -cospi[20], bf0[42], v_bit);
+  bf1[54] = half_btf_neon(cospi[20], bf0[54], cospi[44], bf0[41], v_bit);
+  bf1[55] = bf0[55];
+  bf1[56] = bf0[56];
+  bf1[57] = half_btf_neon(cospi[28], bf0[57], -cospi[36], bf0[38], v_bit);
+  bf1[58] = half_btf_neon(cospi[36], bf0[58], cospi[28], bf0[37], v_bit);
+  bf1[59] = bf0[59];
+  bf1[60] = bf0[60];
+  bf1[61] = half_btf_neon(cospi[60], bf0[61], -cospi[4], bf0[34], v_bit);
+  bf1[62] = half_btf_neon(cospi[4], bf0[62], cospi[60], bf0[33], v_bit);
+  bf1[63] = bf0[63];
+
+  // stage 9
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[1];
+  bf1[2] = bf0[2];
+  bf1[3] = bf0[3];
+  bf1[4] = bf0[4];
+  bf1[5] = bf0[5];
+  bf1[6] = bf0[6];
+  bf1[7] = bf0[7];
+  bf1[8] = bf0[8];
+  bf1[9] = bf0[9];
+  bf1[10] = bf0[10];
+  bf1[11] = bf0[11];
+  bf1[12] = bf0[12];
+  bf1[13] = bf0[13];
+  bf1[14] = bf0[14];
+  bf1[15] = bf0[15];
+  bf1[16] = half_btf_neon(cospi[62], bf0[16], cospi[2], bf0[31], v_bit);
+  bf1[17] = half_btf_neon(cospi[30], bf0[17], cospi[34], bf0[30], v_bit);
+  bf1[18] = half_btf_neon(cospi[46], bf0[18], cospi[18], bf0[29], v_bit);
+  bf1[19] = half_btf_neon(cospi[14], bf0[19], cospi[50], bf0[28], v_bit);
+  bf1[20] = half_btf_neon(cospi[54], bf0[20], cospi[10], bf0[27], v_bit);
+  bf1[21] = half_btf_neon(cospi[22], bf0[21], cospi[42], bf0[26], v_bit);
+  bf1[22] = half_btf_neon(cospi[38], bf0[22], cospi[26], bf0[25], v_bit);
+  bf1[23] = half_btf_neon(cospi[6], bf0[23], cospi[58], bf0[24], v_bit);
+  bf1[24] = half_btf_neon(cospi[6], bf0[24], -cospi[58], bf0[23], v_bit);
+  bf1[25] = half_btf_neon(cospi[38], bf0[25], -cospi[26], bf0[22], v_bit);
+  bf1[26] = half_btf_neon(cospi[22], bf0[26], -cospi[42], bf0[21], v_bit);
+  bf1[27] = half_btf_neon(cospi[54], bf0[27], -cospi[10], bf0[20], v_bit);
+  bf1[28] = half_btf_neon(cospi[14], bf0[28], -cospi[50], bf0[19], v_bit);
+  bf1[29] = half_btf_neon(cospi[46], bf0[29], -cospi[18], bf0[18], v_bit);
+  bf1[30] = half_btf_neon(cospi[30], bf0[30], -cospi[34], bf0[17], v_bit);
+  bf1[31] = half_btf_neon(cospi[62], bf0[31], -cospi[2], bf0[16], v_bit);
+  bf1[32] = vaddq_s32(bf0[32], bf0[33]);
+  bf1[33] = vsubq_s32(bf0[32], bf0[33]);
+  bf1[34] = vsubq_s32(bf0[35], bf0[34]);
+  bf1[35] = vaddq_s32(bf0[35], bf0[34]);
+  bf1[36] = vaddq_s32(bf0[36], bf0[37]);
+  bf1[37] = vsubq_s32(bf0[36], bf0[37]);
+  bf1[38] = vsubq_s32(bf0[39], bf0[38]);
+  bf1[39] = vaddq_s32(bf0[39], bf0[38]);
+  bf1[40] = vaddq_s32(bf0[40], bf0[41]);
+  bf1[41] = vsubq_s32(bf0[40], bf0[41]);
+  bf1[42] = vsubq_s32(bf0[43], bf0[42]);
+  bf1[43] = vaddq_s32(bf0[43], bf0[42]);
+  bf1[44] = vaddq_s32(bf0[44], bf0[45]);
+  bf1[45] = vsubq_s32(bf0[44], bf0[45]);
+  bf1[46] = vsubq_s32(bf0[47], bf0[46]);
+  bf1[47] = vaddq_s32(bf0[47], bf0[46]);
+  bf1[48] = vaddq_s32(bf0[48], bf0[49]);
+  bf1[49] = vsubq_s32(bf0[48], bf0[49]);
+  bf1[50] = vsubq_s32(bf0[51], bf0[50]);
+  bf1[51] = vaddq_s32(bf0[51], bf0[50]);
+  bf1[52] = vaddq_s32(bf0[52], bf0[53]);
+  bf1[53] = vsubq_s32(bf0[52], bf0[53]);
+  bf1[54] = vsubq_s32(bf0[55], bf0[54]);
+  bf1[55] = vaddq_s32(bf0[55], bf0[54]);
+  bf1[56] = vaddq_s32(bf0[56], bf0[57]);
+  bf1[57] = vsubq_s32(bf0[56], bf0[57]);
+  bf1[58] = vsubq_s32(bf0[59], bf0[58]);
+  bf1[59] = vaddq_s32(bf0[59], bf0[58]);
+  bf1[60] = vaddq_s32(bf0[60], bf0[61]);
+  bf1[61] = vsubq_s32(bf0[60], bf0[61]);
+  bf1[62] = vsubq_s32(bf0[63], bf0[62]);
+  bf1[63] = vaddq_s32(bf0[63], bf0[62]);
+
+  // stage 10
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[1];
+  bf1[2] = bf0[2];
+  bf1[3] = bf0[3];
+  bf1[4] = bf0[4];
+  bf1[5] = bf0[5];
+  bf1[6] = bf0[6];
+  bf1[7] = bf0[7];
+  bf1[8] = bf0[8];
+  bf1[9] = bf0[9];
+  bf1[10] = bf0[10];
+  bf1[11] = bf0[11];
+  bf1[12] = bf0[12];
+  bf1[13] = bf0[13];
+  bf1[14] = bf0[14];
+  bf1[15] = bf0[15];
+  bf1[16] = bf0[16];
+  bf1[17] = bf0[17];
+  bf1[18] = bf0[18];
+  bf1[19] = bf0[19];
+  bf1[20] = bf0[20];
+  bf1[21] = bf0[21];
+  bf1[22] = bf0[22];
+  bf1[23] = bf0[23];
+  bf1[24] = bf0[24];
+  bf1[25] = bf0[25];
+  bf1[26] = bf0[26];
+  bf1[27] = bf0[27];
+  bf1[28] = bf0[28];
+  bf1[29] = bf0[29];
+  bf1[30] = bf0[30];
+  bf1[31] = bf0[31];
+  bf1[32] = half_btf_neon(cospi[63], bf0[32], cospi[1], bf0[63], v_bit);
+  bf1[33] = half_btf_neon(cospi[31], bf0[33], cospi[33], bf0[62], v_bit);
+  bf1[34] = half_btf_neon(cospi[47], bf0[34], cospi[17], bf0[61], v_bit);
+  bf1[35] = half_btf_neon(cospi[15], bf0[35], cospi[49], bf0[60], v_bit);
+  bf1[36] = half_btf_neon(cospi[55], bf0[36], cospi[9], bf0[59], v_bit);
+  bf1[37] = half_btf_neon(cospi[23], bf0[37], cospi[41], bf0[58], v_bit);
+  bf1[38] = half_btf_neon(cospi[39], bf0[38], cospi[25], bf0[57], v_bit);
+  bf1[39] = half_btf_neon(cospi[7], bf0[39], cospi[57], bf0[56], v_bit);
+  bf1[40] = half_btf_neon(cospi[59], bf0[40], cospi[5], bf0[55], v_bit);
+  bf1[41] = half_btf_neon(cospi[27], bf0[41], cospi[37], bf0[54], v_bit);
+  bf1[42] = half_btf_neon(cospi[43], bf0[42], cospi[21], bf0[53], v_bit);
+  bf1[43] = half_btf_neon(cospi[11], bf0[43], cospi[53], bf0[52], v_bit);
+  bf1[44] = half_btf_neon(cospi[51], bf0[44], cospi[13], bf0[51], v_bit);
+  bf1[45] = half_btf_neon(cospi[19], bf0[45], cospi[45], bf0[50], v_bit);
+  bf1[46] = half_btf_neon(cospi[35], bf0[46], cospi[29], bf0[49], v_bit);
+  bf1[47] = half_btf_neon(cospi[3], bf0[47], cospi[61], bf0[48], v_bit);
+  bf1[48] = half_btf_neon(cospi[3], bf0[48], -cospi[61], bf0[47], v_bit);
+  bf1[49] = half_btf_neon(cospi[35], bf0[49], -cospi[29], bf0[46], v_bit);
+  bf1[50] = half_btf_neon(cospi[19], bf0[50], -cospi[45], bf0[45], v_bit);
+  bf1[51] = half_btf_neon(cospi[51], bf0[51], -cospi[13], bf0[44], v_bit);
+  bf1[52] = half_btf_neon(cospi[11], bf0[52], -cospi[53], bf0[43], v_bit);
+  bf1[53] = half_btf_neon(cospi[43], bf0[53], -cospi[21], bf0[42], v_bit);
+  bf1[54] = half_btf_neon(cospi[27], bf0[54], -cospi[37], bf0[41], v_bit);
+  bf1[55] = half_btf_neon(cospi[59], bf0[55], -cospi[5], bf0[40], v_bit);
+  bf1[56] = half_btf_neon(cospi[7], bf0[56], -cospi[57], bf0[39], v_bit);
+  bf1[57] = half_btf_neon(cospi[39], bf0[57], -cospi[25], bf0[38], v_bit);
+  bf1[58] = half_btf_neon(cospi[23], bf0[58], -cospi[41], bf0[37], v_bit);
+  bf1[59] = half_btf_neon(cospi[55], bf0[59], -cospi[9], bf0[36], v_bit);
+  bf1[60] = half_btf_neon(cospi[15], bf0[60], -cospi[49], bf0[35], v_bit);
+  bf1[61] = half_btf_neon(cospi[47], bf0[61], -cospi[17], bf0[34], v_bit);
+  bf1[62] = half_btf_neon(cospi[31], bf0[62], -cospi[33], bf0[33], v_bit);
+  bf1[63] = half_btf_neon(cospi[63], bf0[63], -cospi[1], bf0[32], v_bit);
+
+  // stage 11
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[32];
+  bf1[2] = bf0[16];
+  bf1[3] = bf0[48];
+  bf1[4] = bf0[8];
+  bf1[5] = bf0[40];
+  bf1[6] = bf0[24];
+  bf1[7] = bf0[56];
+  bf1[8] = bf0[4];
+  bf1[9] = bf0[36];
+  bf1[10] = bf0[20];
+  bf1[11] = bf0[52];
+  bf1[12] = bf0[12];
+  bf1[13] = bf0[44];
+  bf1[14] = bf0[28];
+  bf1[15] = bf0[60];
+  bf1[16] = bf0[2];
+  bf1[17] = bf0[34];
+  bf1[18] = bf0[18];
+  bf1[19] = bf0[50];
+  bf1[20] = bf0[10];
+  bf1[21] = bf0[42];
+  bf1[22] = bf0[26];
+  bf1[23] = bf0[58];
+  bf1[24] = bf0[6];
+  bf1[25] = bf0[38];
+  bf1[26] = bf0[22];
+  bf1[27] = bf0[54];
+  bf1[28] = bf0[14];
+  bf1[29] = bf0[46];
+  bf1[30] = bf0[30];
+  bf1[31] = bf0[62];
+  bf1[32] = bf0[1];
+  bf1[33] = bf0[33];
+  bf1[34] = bf0[17];
+  bf1[35] = bf0[49];
+  bf1[36] = bf0[9];
+  bf1[37] = bf0[41];
+  bf1[38] = bf0[25];
+  bf1[39] = bf0[57];
+  bf1[40] = bf0[5];
+  bf1[41] = bf0[37];
+  bf1[42] = bf0[21];
+  bf1[43] = bf0[53];
+  bf1[44] = bf0[13];
+  bf1[45] = bf0[45];
+  bf1[46] = bf0[29];
+  bf1[47] = bf0[61];
+  bf1[48] = bf0[3];
+  bf1[49] = bf0[35];
+  bf1[50] = bf0[19];
+  bf1[51] = bf0[51];
+  bf1[52] = bf0[11];
+  bf1[53] = bf0[43];
+  bf1[54] = bf0[27];
+  bf1[55] = bf0[59];
+  bf1[56] = bf0[7];
+  bf1[57] = bf0[39];
+  bf1[58] = bf0[23];
+  bf1[59] = bf0[55];
+  bf1[60] = bf0[15];
+  bf1[61] = bf0[47];
+  bf1[62] = bf0[31];
+  bf1[63] = bf0[63];
+}
+
+static void fadst8_new_neon(const int32x4_t *input, int32x4_t *output,
+                            int8_t cos_bit) {
+  const int32x4_t v_bit = vdupq_n_s32(-cos_bit);
+  const int32_t *cospi = cospi_arr(cos_bit);
+  int32x4_t *bf0, *bf1;
+  int32x4_t step[8];
+
+  // stage 1
+  bf1 = output;
+  bf1[0] = input[0];
+  bf1[1] = vnegq_s32(input[7]);
+  bf1[2] = vnegq_s32(input[3]);
+  bf1[3] = input[4];
+  bf1[4] = vnegq_s32(input[1]);
+  bf1[5] = input[6];
+  bf1[6] = input[2];
+  bf1[7] = vnegq_s32(input[5]);
+
+  // stage 2
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[1];
+  bf1[2] = half_btf_neon(cospi[32], bf0[2], cospi[32], bf0[3], v_bit);
+  bf1[3] = half_btf_neon(cospi[32], bf0[2], -cospi[32], bf0[3], v_bit);
+  bf1[4] = bf0[4];
+  bf1[5] = bf0[5];
+  bf1[6] = half_btf_neon(cospi[32], bf0[6], cospi[32], bf0[7], v_bit);
+  bf1[7] = half_btf_neon(cospi[32], bf0[6], -cospi[32], bf0[7], v_bit);
+
+  // stage 3
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = vaddq_s32(bf0[0], bf0[2]);
+  bf1[1] = vaddq_s32(bf0[1], bf0[3]);
+  bf1[2] = vsubq_s32(bf0[0], bf0[2]);
+  bf1[3] = vsubq_s32(bf0[1], bf0[3]);
+  bf1[4] = vaddq_s32(bf0[4], bf0[6]);
+  bf1[5] = vaddq_s32(bf0[5], bf0[7]);
+  bf1[6] = vsubq_s32(bf0[4], bf0[6]);
+  bf1[7] = vsubq_s32(bf0[5], bf0[7]);
+
+  // stage 4
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[1];
+  bf1[2] = bf0[2];
+  bf1[3] = bf0[3];
+  bf1[4] = half_btf_neon(cospi[16], bf0[4], cospi[48], bf0[5], v_bit);
+  bf1[5] = half_btf_neon(cospi[48], bf0[4], -cospi[16], bf0[5], v_bit);
+  bf1[6] = half_btf_neon(-cospi[48], bf0[6], cospi[16], bf0[7], v_bit);
+  bf1[7] = half_btf_neon(cospi[16], bf0[6], cospi[48], bf0[7], v_bit);
+
+  // stage 5
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = vaddq_s32(bf0[0], bf0[4]);
+  bf1[1] = vaddq_s32(bf0[1], bf0[5]);
+  bf1[2] = vaddq_s32(bf0[2], bf0[6]);
+  bf1[3] = vaddq_s32(bf0[3], bf0[7]);
+  bf1[4] = vsubq_s32(bf0[0], bf0[4]);
+  bf1[5] = vsubq_s32(bf0[1], bf0[5]);
+  bf1[6] = vsubq_s32(bf0[2], bf0[6]);
+  bf1[7] = vsubq_s32(bf0[3], bf0[7]);
+
+  // stage 6
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = half_btf_neon(cospi[4], bf0[0], cospi[60], bf0[1], v_bit);
+  bf1[1] = half_btf_neon(cospi[60], bf0[0], -cospi[4], bf0[1], v_bit);
+  bf1[2] = half_btf_neon(cospi[20], bf0[2], cospi[44], bf0[3], v_bit);
+  bf1[3] = half_btf_neon(cospi[44], bf0[2], -cospi[20], bf0[3], v_bit);
+  bf1[4] = half_btf_neon(cospi[36], bf0[4], cospi[28], bf0[5], v_bit);
+  bf1[5] = half_btf_neon(cospi[28], bf0[4], -cospi[36], bf0[5], v_bit);
+  bf1[6] = half_btf_neon(cospi[52], bf0[6], cospi[12], bf0[7], v_bit);
+  bf1[7] = half_btf_neon(cospi[12], bf0[6], -cospi[52], bf0[7], v_bit);
+
+  // stage 7
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = bf0[1];
+  bf1[1] = bf0[6];
+  bf1[2] = bf0[3];
+  bf1[3] = bf0[4];
+  bf1[4] = bf0[5];
+  bf1[5] = bf0[2];
+  bf1[6] = bf0[7];
+  bf1[7] = bf0[0];
+}
+
+static void fadst16_new_neon(const int32x4_t *input, int32x4_t *output,
+                             int8_t cos_bit) {
+  const int32x4_t v_bit = vdupq_n_s32(-cos_bit);
+  const int32_t *cospi = cospi_arr(cos_bit);
+  int32x4_t *bf0, *bf1;
+  int32x4_t step[16];
+
+  // stage 1
+  bf1 = output;
+  bf1[0] = input[0];
+  bf1[1] = vnegq_s32(input[15]);
+  bf1[2] = vnegq_s32(input[7]);
+  bf1[3] = input[8];
+  bf1[4] = vnegq_s32(input[3]);
+  bf1[5] = input[12];
+  bf1[6] = input[4];
+  bf1[7] = vnegq_s32(input[11]);
+  bf1[8] = vnegq_s32(input[1]);
+  bf1[9] = input[14];
+  bf1[10] = input[6];
+  bf1[11] = vnegq_s32(input[9]);
+  bf1[12] = input[2];
+  bf1[13] = vnegq_s32(input[13]);
+  bf1[14] = vnegq_s32(input[5]);
+  bf1[15] = input[10];
+
+  // stage 2
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[1];
+  bf1[2] = half_btf_neon(cospi[32], bf0[2], cospi[32], bf0[3], v_bit);
+  bf1[3] = half_btf_neon(cospi[32], bf0[2], -cospi[32], bf0[3], v_bit);
+  bf1[4] = bf0[4];
+  bf1[5] = bf0[5];
+  bf1[6] = half_btf_neon(cospi[32], bf0[6], cospi[32], bf0[7], v_bit);
+  bf1[7] = half_btf_neon(cospi[32], bf0[6], -cospi[32], bf0[7], v_bit);
+  bf1[8] = bf0[8];
+  bf1[9] = bf0[9];
+  bf1[10] = half_btf_neon(cospi[32], bf0[10], cospi[32], bf0[11], v_bit);
+  bf1[11] = half_btf_neon(cospi[32], bf0[10], -cospi[32], bf0[11], v_bit);
+  bf1[12] = bf0[12];
+  bf1[13] = bf0[13];
+  bf1[14] = half_btf_neon(cospi[32], bf0[14], cospi[32], bf0[15], v_bit);
+  bf1[15] = half_btf_neon(cospi[32], bf0[14], -cospi[32], bf0[15], v_bit);
+
+  // stage 3
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = vaddq_s32(bf0[0], bf0[2]);
+  bf1[1] = vaddq_s32(bf0[1], bf0[3]);
+  bf1[2] = vsubq_s32(bf0[0], bf0[2]);
+  bf1[3] = vsubq_s32(bf0[1], bf0[3]);
+  bf1[4] = vaddq_s32(bf0[4], bf0[6]);
+  bf1[5] = vaddq_s32(bf0[5], bf0[7]);
+  bf1[6] = vsubq_s32(bf0[4], bf0[6]);
+  bf1[7] = vsubq_s32(bf0[5], bf0[7]);
+  bf1[8] = vaddq_s32(bf0[8], bf0[10]);
+  bf1[9] = vaddq_s32(bf0[9], bf0[11]);
+  bf1[10] = vsubq_s32(bf0[8], bf0[10]);
+  bf1[11] = vsubq_s32(bf0[9], bf0[11]);
+  bf1[12] = vaddq_s32(bf0[12], bf0[14]);
+  bf1[13] = vaddq_s32(bf0[13], bf0[15]);
+  bf1[14] = vsubq_s32(bf0[12], bf0[14]);
+  bf1[15] = vsubq_s32(bf0[13], bf0[15]);
+
+  // stage 4
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[1];
+  bf1[2] = bf0[2];
+  bf1[3] = bf0[3];
+  bf1[4] = half_btf_neon(cospi[16], bf0[4], cospi[48], bf0[5], v_bit);
+  bf1[5] = half_btf_neon(cospi[48], bf0[4], -cospi[16], bf0[5], v_bit);
+  bf1[6] = half_btf_neon(-cospi[48], bf0[6], cospi[16], bf0[7], v_bit);
+  bf1[7] = half_btf_neon(cospi[16], bf0[6], cospi[48], bf0[7], v_bit);
+  bf1[8] = bf0[8];
+  bf1[9] = bf0[9];
+  bf1[10] = bf0[10];
+  bf1[11] = bf0[11];
+  bf1[12] = half_btf_neon(cospi[16], bf0[12], cospi[48], bf0[13], v_bit);
+  bf1[13] = half_btf_neon(cospi[48], bf0[12], -cospi[16], bf0[13], v_bit);
+  bf1[14] = half_btf_neon(-cospi[48], bf0[14], cospi[16], bf0[15], v_bit);
+  bf1[15] = half_btf_neon(cospi[16], bf0[14], cospi[48], bf0[15], v_bit);
+
+  // stage 5
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = vaddq_s32(bf0[0], bf0[4]);
+  bf1[1] = vaddq_s32(bf0[1], bf0[5]);
+  bf1[2] = vaddq_s32(bf0[2], bf0[6]);
+  bf1[3] = vaddq_s32(bf0[3], bf0[7]);
+  bf1[4] = vsubq_s32(bf0[0], bf0[4]);
+  bf1[5] = vsubq_s32(bf0[1], bf0[5]);
+  bf1[6] = vsubq_s32(bf0[2], bf0[6]);
+  bf1[7] = vsubq_s32(bf0[3], bf0[7]);
+  bf1[8] = vaddq_s32(bf0[8], bf0[12]);
+  bf1[9] = vaddq_s32(bf0[9], bf0[13]);
+  bf1[10] = vaddq_s32(bf0[10], bf0[14]);
+  bf1[11] = vaddq_s32(bf0[11], bf0[15]);
+  bf1[12] = vsubq_s32(bf0[8], bf0[12]);
+  bf1[13] = vsubq_s32(bf0[9], bf0[13]);
+  bf1[14] = vsubq_s32(bf0[10], bf0[14]);
+  bf1[15] = vsubq_s32(bf0[11], bf0[15]);
+
+  // stage 6
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = bf0[0];
+  bf1[1] = bf0[1];
+  bf1[2] = bf0[2];
+  bf1[3] = bf0[3];
+  bf1[4] = bf0[4];
+  bf1[5] = bf0[5];
+  bf1[6] = bf0[6];
+  bf1[7] = bf0[7];
+  bf1[8] = half_btf_neon(cospi[8], bf0[8], cospi[56], bf0[9], v_bit);
+  bf1[9] = half_btf_neon(cospi[56], bf0[8], -cospi[8], bf0[9], v_bit);
+  bf1[10] = half_btf_neon(cospi[40], bf0[10], cospi[24], bf0[11], v_bit);
+  bf1[11] = half_btf_neon(cospi[24], bf0[10], -cospi[40], bf0[11], v_bit);
+  bf1[12] = half_btf_neon(-cospi[56], bf0[12], cospi[8], bf0[13], v_bit);
+  bf1[13] = half_btf_neon(cospi[8], bf0[12], cospi[56], bf0[13], v_bit);
+  bf1[14] = half_btf_neon(-cospi[24], bf0[14], cospi[40], bf0[15], v_bit);
+  bf1[15] = half_btf_neon(cospi[40], bf0[14], cospi[24], bf0[15], v_bit);
+
+  // stage 7
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = vaddq_s32(bf0[0], bf0[8]);
+  bf1[1] = vaddq_s32(bf0[1], bf0[9]);
+  bf1[2] = vaddq_s32(bf0[2], bf0[10]);
+  bf1[3] = vaddq_s32(bf0[3], bf0[11]);
+  bf1[4] = vaddq_s32(bf0[4], bf0[12]);
+  bf1[5] = vaddq_s32(bf0[5], bf0[13]);
+  bf1[6] = vaddq_s32(bf0[6], bf0[14]);
+  bf1[7] = vaddq_s32(bf0[7], bf0[15]);
+  bf1[8] = vsubq_s32(bf0[0], bf0[8]);
+  bf1[9] = vsubq_s32(bf0[1], bf0[9]);
+  bf1[10] = vsubq_s32(bf0[2], bf0[10]);
+  bf1[11] = vsubq_s32(bf0[3], bf0[11]);
+  bf1[12] = vsubq_s32(bf0[4], bf0[12]);
+  bf1[13] = vsubq_s32(bf0[5], bf0[13]);
+  bf1[14] = vsubq_s32(bf0[6], bf0[14]);
+  bf1[15] = vsubq_s32(bf0[7], bf0[15]);
+
+  // stage 8
+  bf0 = output;
+  bf1 = step;
+  bf1[0] = half_btf_neon(cospi[2], bf0[0], cospi[62], bf0[1], v_bit);
+  bf1[1] = half_btf_neon(cospi[62], bf0[0], -cospi[2], bf0[1], v_bit);
+  bf1[2] = half_btf_neon(cospi[10], bf0[2], cospi[54], bf0[3], v_bit);
+  bf1[3] = half_btf_neon(cospi[54], bf0[2], -cospi[10], bf0[3], v_bit);
+  bf1[4] = half_btf_neon(cospi[18], bf0[4], cospi[46], bf0[5], v_bit);
+  bf1[5] = half_btf_neon(cospi[46], bf0[4], -cospi[18], bf0[5], v_bit);
+  bf1[6] = half_btf_neon(cospi[26], bf0[6], cospi[38], bf0[7], v_bit);
+  bf1[7] = half_btf_neon(cospi[38], bf0[6], -cospi[26], bf0[7], v_bit);
+  bf1[8] = half_btf_neon(cospi[34], bf0[8], cospi[30], bf0[9], v_bit);
+  bf1[9] = half_btf_neon(cospi[30], bf0[8], -cospi[34], bf0[9], v_bit);
+  bf1[10] = half_btf_neon(cospi[42], bf0[10], cospi[22], bf0[11], v_bit);
+  bf1[11] = half_btf_neon(cospi[22], bf0[10], -cospi[42], bf0[11], v_bit);
+  bf1[12] = half_btf_neon(cospi[50], bf0[12], cospi[14], bf0[13], v_bit);
+  bf1[13] = half_btf_neon(cospi[14], bf0[12], -cospi[50], bf0[13], v_bit);
+  bf1[14] = half_btf_neon(cospi[58], bf0[14], cospi[6], bf0[15], v_bit);
+  bf1[15] = half_btf_neon(cospi[6], bf0[14], -cospi[58], bf0[15], v_bit);
+
+  // stage 9
+  bf0 = step;
+  bf1 = output;
+  bf1[0] = bf0[1];
+  bf1[1] = bf0[14];
+  bf1[2] = bf0[3];
+  bf1[3] = bf0[12];
+  bf1[4] = bf0[5];
+  bf1[5] = bf0[10];
+  bf1[6] = bf0[7];
+  bf1[7] = bf0[8];
+  bf1[8] = bf0[9];
+  bf1[9] = bf0[6];
+  bf1[10] = bf0[11];
+  bf1[11] = bf0[4];
+  bf1[12] = bf0[13];
+  bf1[13] = bf0[2];
+  bf1[14] = bf0[15];
+  bf1[15] = bf0[0];
+}
+
+static void fadst4_new_neon(const int32x4_t *input, int32x4_t *output,
+                            int8_t cos_bit) {
+  const int32x4_t v_bit = vdupq_n_s32(-cos_bit);
+  const int32_t *sinpi = sinpi_arr(cos_bit);
+  int32x4_t x0, x1, x2, x3;
+  int32x4_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+  // stage 0
+  x0 = input[0];
+  x1 = input[1];
+  x2 = input[2];
+  x3 = input[3];
+
+  // stage 1
+  s0 = vmulq_n_s32(x0, sinpi[1]);
+  s1 = vmulq_n_s32(x0, sinpi[4]);
+  s2 = vmulq_n_s32(x1, sinpi[2]);
+  s3 = vmulq_n_s32(x1, sinpi[1]);
+  s4 = vmulq_n_s32(x2, sinpi[3]);
+  s5 = vmulq_n_s32(x3, sinpi[4]);
+  s6 = vmulq_n_s32(x3, sinpi[2]);
+  s7 = vaddq_s32(x0, x1);
+
+  // stage 2
+  s7 = vsubq_s32(s7, x3);
+
+  // stage 3
+  x0 = vaddq_s32(s0, s2);
+  x1 = vmulq_n_s32(s7, sinpi[3]);
+  x2 = vsubq_s32(s1, s3);
+  x3 = s4;
+
+  // stage 4
+  x0 = vaddq_s32(x0, s5);
+  x2 = vaddq_s32(x2, s6);
+
+  // stage 5
+  s0 = vaddq_s32(x0, x3);
+  s1 = x1;
+  s2 = vsubq_s32(x2, x3);
+  s3 = vsubq_s32(x2, x0);
+
+  // stage 6
+  s3 = vaddq_s32(s3, x3);
+
+  output[0] = vrshlq_s32(s0, v_bit);
+  output[1] = vrshlq_s32(s1, v_bit);
+  output[2] = vrshlq_s32(s2, v_bit);
+  output[3] = vrshlq_s32(s3, v_bit);
+}
+
+static void fidentity4_neon(const int32x4_t *input, int32x4_t *output,
+                            int8_t cos_bit) {
+  (void)cos_bit;
+  for (int i = 0; i < 4; ++i)
+    output[i] = mul_round_shift_sqrt2_neon(input[i], NewSqrt2);
+}
+
+static void fidentity8_neon(const int32x4_t *input, int32x4_t *output,
+                            int8_t cos_bit) {
+  (void)cos_bit;
+  for (int i = 0; i < 8; ++i) output[i] = vshlq_n_s32(input[i], 1);
+}
+
+static void fidentity16_neon(const int32x4_t *input, int32x4_t *output,
+                             int8_t cos_bit) {
+  (void)cos_bit;
+  for (int i = 0; i < 16; ++i)
+    output[i] = mul_round_shift_sqrt2_neon(input[i], 2 * NewSqrt2);
+}
+
+static void fidentity32_neon(const int32x4_t *input, int32x4_t *output,
+                             int8_t cos_bit) {
+  (void)cos_bit;
+  for (int i = 0; i < 32; ++i) output[i] = vshlq_n_s32(input[i], 2);
+}
+
+static const fwd_transform_1d_neon fwd_txfm_type_to_func_neon[TXFM_TYPES] = {
+  fdct4_new_neon,   fdct8_new_neon,   fdct16_new_neon,  fdct32_new_neon,
+  fdct64_new_neon,  fadst4_new_neon,  fadst8_new_neon,  fadst16_new_neon,
+  fidentity4_neon,  fidentity8_neon,  fidentity16_neon, fidentity32_neon,
+};
+
+// Same steps as fwd_txfm2d_c(). Columns are transformed four at a time and
+// stored transposed, so the row pass can read four rows of one column as a
+// single vector. Only the top-left 32x32 coefficients of a 64-point
+// transform are kept, packed with a stride of min(width, 32) like the
+// av1_fwd_txfm2d_*_c() wrappers.
+static void fwd_txfm2d_neon(const int16_t *input, int32_t *output,
+                            const int stride, TX_TYPE tx_type,
+                            TX_SIZE tx_size) {
+  TXFM_2D_FLIP_CFG cfg;
+  av1_get_fwd_txfm_cfg(tx_type, tx_size, &cfg);
+  const int txfm_size_col = tx_size_wide[tx_size];
+  const int txfm_size_row = tx_size_high[tx_size];
+  const int out_size_col = AOMMIN(txfm_size_col, 32);
+  const int out_size_row = AOMMIN(txfm_size_row, 32);
+  const int row_blocks = out_size_row >> 2;
+  const int8_t *shift = cfg.shift;
+  const int rect_type = get_rect_tx_log_ratio(txfm_size_col, txfm_size_row);
+  const fwd_transform_1d_neon txfm_func_col =
+      fwd_txfm_type_to_func_neon[cfg.txfm_type_col];
+  const fwd_transform_1d_neon txfm_func_row =
+      fwd_txfm_type_to_func_neon[cfg.txfm_type_row];
+  const int32x4_t v_shift0 = vdupq_n_s32(shift[0]);
+  const int32x4_t v_shift1 = vdupq_n_s32(shift[1]);
+  const int32x4_t v_shift2 = vdupq_n_s32(shift[2]);
+  int32x4_t buf[64 * 32 / 4];
+  int32x4_t in[64], out[64];
+
+  // Columns
+  for (int c = 0; c < txfm_size_col; c += 4) {
+    for (int r = 0; r < txfm_size_row; ++r) {
+      const int in_r = cfg.ud_flip ? txfm_size_row - r - 1 : r;
+      // av1_round_shift_array() by -shift[0]: saturating left shift.
+      in[r] = vqrshlq_s32(vmovl_s16(vld1_s16(input + in_r * stride + c)),
+                          v_shift0);
+    }
+    txfm_func_col(in, out, cfg.cos_bit_col);
+    for (int r = 0; r < out_size_row; r += 4) {
+      int32x4_t *const o = out + r;
+      o[0] = vqrshlq_s32(o[0], v_shift1);
+      o[1] = vqrshlq_s32(o[1], v_shift1);
+      o[2] = vqrshlq_s32(o[2], v_shift1);
+      o[3] = vqrshlq_s32(o[3], v_shift1);
+      transpose_s32_4x4(&o[0], &o[1], &o[2], &o[3]);
+      for (int i = 0; i < 4; ++i) {
+        const int buf_c =
+            cfg.lr_flip ? txfm_size_col - (c + i) - 1 : c + i;
+        buf[buf_c * row_blocks + (r >> 2)] = o[i];
+      }
+    }
+  }
+
+  // Rows
+  for (int r = 0; r < out_size_row; r += 4) {
+    for (int c = 0; c < txfm_size_col; ++c)
+      in[c] = buf[c * row_blocks + (r >> 2)];
+    txfm_func_row(in, out, cfg.cos_bit_row);
+    for (int c = 0; c < out_size_col; c += 4) {
+      int32x4_t *const o = out + c;
+      for (int i = 0; i < 4; ++i) {
+        o[i] = vqrshlq_s32(o[i], v_shift2);
+        // Multiply everything by Sqrt2 if the transform is rectangular and
+        // the size difference is a factor of 2.
+        if (abs(rect_type) == 1)
+          o[i] = mul_round_shift_sqrt2_neon(o[i], NewSqrt2);
+      }
+      transpose_s32_4x4(&o[0], &o[1], &o[2], &o[3]);
+      for (int i = 0; i < 4; ++i)
+        vst1q_s32(output + (r + i) * out_size_col + c, o[i]);
+    }
+  }
+
+  // Zero the coefficients a 64-point transform drops.
+  if (out_size_col * out_size_row < txfm_size_col * txfm_size_row) {
+    memset(output + out_size_col * out_size_row, 0,
+           (txfm_size_col * txfm_size_row - out_size_col * out_size_row) *
+               sizeof(*output));
+  }
+}
+
+void av1_lowbd_fwd_txfm_neon(const int16_t *src_diff, tran_low_t *coeff,
+                             int diff_stride, TxfmParam *txfm_param) {
+  if (txfm_param->lossless && txfm_param->tx_size == TX_4X4) {
+    av1_lowbd_fwd_txfm_c(src_diff, coeff, diff_stride, txfm_param);
+    return;
+  }
+  fwd_txfm2d_neon(src_diff, coeff, diff_stride, txfm_param->tx_type,
+                  txfm_param->tx_size);
+}
@@ -0,0 +1,509 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <arm_neon.h>
+#include <assert.h>
+#include <string.h>
+
+#include "config/av1_rtcd.h"
+
+#include "aom/aom_integer.h"
+#include "av1/common/onyxc_int.h"
+#include "av1/common/txb_common.h"
+
+// Convert 4 coefficients to levels: clamp(abs(coeff), 0, INT8_MAX).
+static INLINE int16x4_t get_levels_4(const tran_low_t *cf) {
+  return vqabs_s16(vqmovn_s32(vld1q_s32(cf)));
+}
+
+void av1_txb_init_levels_neon(const tran_low_t *const coeff, const int width,
+                              const int height, uint8_t *const levels) {
+  const int stride = width + TX_PAD_HOR;
+  const int16x4_t zeros = vdup_n_s16(0);
+  uint8_t *ls = levels;
+  const tran_low_t *cf = coeff;
+  int i, j;
+
+  memset(levels + stride * height, 0,
+         sizeof(*levels) * (TX_PAD_BOTTOM * stride + TX_PAD_END));
+
+  if (width == 4) {
+    // Each row of 4 levels and 4 padding bytes fills one 8 byte vector.
+    for (i = 0; i < height; ++i) {
+      const int8x8_t row = vqmovn_s16(vcombine_s16(get_levels_4(cf), zeros));
+      vst1_s8((int8_t *)ls, row);
+      cf += width;
+      ls += stride;
+    }
+    return;
+  }
+
+  assert(width % 8 == 0);
+  for (i = 0; i < height; ++i) {
+    for (j = 0; j < width; j += 8) {
+      const int16x8_t lvl =
+          vcombine_s16(get_levels_4(cf + j), get_levels_4(cf + j + 4));
+      vst1_s8((int8_t *)(ls + j), vqmovn_s16(lvl));
+    }
+    memset(ls + width, 0, TX_PAD_HOR);
+    cf += width;
+    ls += stride;
+  }
+}
+
+static INLINE uint8x16_t load_levels_4x4(const uint8_t *src, int stride) {
+  uint32_t rows[4];
+  for (int i = 0; i < 4; ++i) memcpy(&rows[i], src + i * stride, 4);
+  return vreinterpretq_u8_u32(vld1q_u32(rows));
+}
+
+static INLINE uint8x16_t load_levels_8x2(const uint8_t *src, int stride) {
+  return vcombine_u8(vld1_u8(src), vld1_u8(src + stride));
+}
+
+static INLINE void load_levels_4x4x5(const uint8_t *const src, const int stride,
+                                     const ptrdiff_t *const offsets,
+                                     uint8x16_t *const level) {
+  level[0] = load_levels_4x4(src + 1, stride);
+  level[1] = load_levels_4x4(src + stride, stride);
+  level[2] = load_levels_4x4(src + offsets[0], stride);
+  level[3] = load_levels_4x4(src + offsets[1], stride);
+  level[4] = load_levels_4x4(src + offsets[2], stride);
+}
+
+static INLINE void load_levels_8x2x5(const uint8_t *const src, const int stride,
+                                     const ptrdiff_t *const offsets,
+                                     uint8x16_t *const level) {
+  level[0] = load_levels_8x2(src + 1, stride);
+  level[1] = load_levels_8x2(src + stride, stride);
+  level[2] = load_levels_8x2(src + offsets[0], stride);
+  level[3] = load_levels_8x2(src + offsets[1], stride);
+  level[4] = load_levels_8x2(src + offsets[2], stride);
+}
+
+static INLINE void load_levels_16x1x5(const uint8_t *const src,
+                                      const int stride,
+                                      const ptrdiff_t *const offsets,
+                                      uint8x16_t *const level) {
+  level[0] = vld1q_u8(src + 1);
+  level[1] = vld1q_u8(src + stride);
+  level[2] = vld1q_u8(src + offsets[0]);
+  level[3] = vld1q_u8(src + offsets[1]);
+  level[4] = vld1q_u8(src + offsets[2]);
+}
+
+// Returns min((sum of min(level, 3) + 1) >> 1, 4) for 16 positions, and adds
+// the per-position context offset.
+static INLINE uint8x16_t get_coeff_contexts_kernel(
+    const uint8x16_t *const level, const uint8x16_t pos_to_offset) {
+  const uint8x16_t const_3 = vdupq_n_u8(3);
+  uint8x16_t count = vminq_u8(level[0], const_3);
+  count = vaddq_u8(count, vminq_u8(level[1], const_3));
+  count = vaddq_u8(count, vminq_u8(level[2], const_3));
+  count = vaddq_u8(count, vminq_u8(level[3], const_3));
+  count = vaddq_u8(count, vminq_u8(level[4], const_3));
+  count = vrhaddq_u8(count, vdupq_n_u8(0));
+  count = vminq_u8(count, vdupq_n_u8(4));
+  return vaddq_u8(count, pos_to_offset);
+}
+
+static INLINE void store_coeff_contexts(int8_t *const cc,
+                                        const uint8x16_t count) {
+  vst1q_s8(cc, vreinterpretq_s8_u8(count));
+}
+
+// Loads a 16 entry context offset table, adding 'base' to every entry.
+static INLINE uint8x16_t load_pos_to_offset(const uint8_t *const table,
+                                            const int base) {
+  return vaddq_u8(vld1q_u8(table), vdupq_n_u8(base));
+}
+
+static INLINE void get_4_nz_map_contexts_2d(const uint8_t *levels,
+                                            const int height,
+                                            const ptrdiff_t *const offsets,
+                                            int8_t *const coeff_contexts) {
+  static const uint8_t kPosToOffset4x4[16] = { 0, 1,  6,  6,  1,  6,  6,  21,
+                                               6, 6,  21, 21, 6,  21, 21, 21 };
+  static const uint8_t kPosToOffset4xN[16] = { 0, 11, 11, 11, 11, 11, 11, 11,
+                                               6, 6,  21, 21, 6,  21, 21, 21 };
+  const int stride = 4 + TX_PAD_HOR;
+  uint8x16_t pos_to_offset =
+      vld1q_u8(height == 4 ? kPosToOffset4x4 : kPosToOffset4xN);
+  uint8x16_t level[5];
+  int8_t *cc = coeff_contexts;
+  int row = height;
+
+  assert(!(height % 4));
+
+  do {
+    load_levels_4x4x5(levels, stride, offsets, level);
+    store_coeff_contexts(cc, get_coeff_contexts_kernel(level, pos_to_offset));
+    pos_to_offset = vdupq_n_u8(21);
+    levels += 4 * stride;
+    cc += 16;
+    row -= 4;
+  } while (row);
+
+  coeff_contexts[0] = 0;
+}
+
+static INLINE void get_4_nz_map_contexts_hor(const uint8_t *levels,
+                                             const int height,
+                                             const ptrdiff_t *const offsets,
+                                             int8_t *coeff_contexts) {
+  static const uint8_t kPosToOffset[16] = { 0, 5, 10, 10, 0, 5, 10, 10,
+                                            0, 5, 10, 10, 0, 5, 10, 10 };
+  const int stride = 4 + TX_PAD_HOR;
+  const uint8x16_t pos_to_offset =
+      load_pos_to_offset(kPosToOffset, SIG_COEF_CONTEXTS_2D);
+  uint8x16_t level[5];
+  int row = height;
+
+  assert(!(height % 4));
+
+  do {
+    load_levels_4x4x5(levels, stride, offsets, level);
+    store_coeff_contexts(coeff_contexts,
+                         get_coeff_contexts_kernel(level, pos_to_offset));
+    levels += 4 * stride;
+    coeff_contexts += 16;
+    row -= 4;
+  } while (row);
+}
+
+static INLINE void get_4_nz_map_contexts_ver(const uint8_t *levels,
+                                             const int height,
+                                             const ptrdiff_t *const offsets,
+                                             int8_t *coeff_contexts) {
+  static const uint8_t kPosToOffset[16] = { 0, 0,  0,  0,  5,  5,  5,  5,
+                                            10, 10, 10, 10, 10, 10, 10, 10 };
+  const int stride = 4 + TX_PAD_HOR;
+  uint8x16_t pos_to_offset =
+      load_pos_to_offset(kPosToOffset, SIG_COEF_CONTEXTS_2D);
+  uint8x16_t level[5];
+  int row = height;
+
+  assert(!(height % 4));
+
+  do {
+    load_levels_4x4x5(levels, stride, offsets, level);
+    store_coeff_contexts(coeff_contexts,
+                         get_coeff_contexts_kernel(level, pos_to_offset));
+    pos_to_offset = vdupq_n_u8(SIG_COEF_CONTEXTS_2D + 10);
+    levels += 4 * stride;
+    coeff_contexts += 16;
+    row -= 4;
+  } while (row);
+}
+
+static INLINE void get_8_coeff_contexts_2d(const uint8_t *levels,
+                                           const int height,
+                                           const ptrdiff_t *const offsets,
+                                           int8_t *coeff_contexts) {
+  static const uint8_t kPosToOffset8x8[2][16] = {
+    { 0, 1, 6, 6, 21, 21, 21, 21, 1, 6, 6, 21, 21, 21, 21, 21 },
+    { 6, 6, 21, 21, 21, 21, 21, 21, 6, 21, 21, 21, 21, 21, 21, 21 }
+  };
+  static const uint8_t kPosToOffset8xSmall[2][16] = {
+    { 0, 16, 6, 6, 21, 21, 21, 21, 16, 16, 6, 21, 21, 21, 21, 21 },
+    { 16, 16, 21, 21, 21, 21, 21, 21, 16, 16, 21, 21, 21, 21, 21, 21 }
+  };
+  static const uint8_t kPosToOffset8xLarge[2][16] = {
+    { 0, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11 },
+    { 6, 6, 21, 21, 21, 21, 21, 21, 6, 21, 21, 21, 21, 21, 21, 21 }
+  };
+  const int stride = 8 + TX_PAD_HOR;
+  const uint8_t(*table)[16] =
+      (height == 8) ? kPosToOffset8x8
+                    : (height < 8) ? kPosToOffset8xSmall : kPosToOffset8xLarge;
+  int8_t *cc = coeff_contexts;
+  int row = height;
+  uint8x16_t level[5];
+  uint8x16_t pos_to_offset[3];
+
+  assert(!(height % 2));
+
+  pos_to_offset[0] = vld1q_u8(table[0]);
+  pos_to_offset[1] = vld1q_u8(table[1]);
+  pos_to_offset[2] = vdupq_n_u8(21);
+
+  do {
+    load_levels_8x2x5(levels, stride, offsets, level);
+    store_coeff_contexts(cc,
+                         get_coeff_contexts_kernel(level, pos_to_offset[0]));
+    pos_to_offset[0] = pos_to_offset[1];
+    pos_to_offset[1] = pos_to_offset[2];
+    levels += 2 * stride;
+    cc += 16;
+    row -= 2;
+  } while (row);
+
+  coeff_contexts[0] = 0;
+}
+
+static INLINE void get_8_coeff_contexts_hor(const uint8_t *levels,
+                                            const int height,
+                                            const ptrdiff_t *const offsets,
+                                            int8_t *coeff_contexts) {
+  static const uint8_t kPosToOffset[16] = { 0, 5, 10, 10, 10, 10, 10, 10,
+                                            0, 5, 10, 10, 10, 10, 10, 10 };
+  const int stride = 8 + TX_PAD_HOR;
+  const uint8x16_t pos_to_offset =
+      load_pos_to_offset(kPosToOffset, SIG_COEF_CONTEXTS_2D);
+  int row = height;
+  uint8x16_t level[5];
+
+  assert(!(height % 2));
+
+  do {
+    load_levels_8x2x5(levels, stride, offsets, level);
+    store_coeff_contexts(coeff_contexts,
+                         get_coeff_contexts_kernel(level, pos_to_offset));
+    levels += 2 * stride;
+    coeff_contexts += 16;
+    row -= 2;
+  } while (row);
+}
+
+static INLINE void get_8_coeff_contexts_ver(const uint8_t *levels,
+                                            const int height,
+                                            const ptrdiff_t *const offsets,
+                                            int8_t *coeff_contexts) {
+  static const uint8_t kPosToOffset[16] = { 0, 0, 0, 0, 0, 0, 0, 0,
+                                            5, 5, 5, 5, 5, 5, 5, 5 };
+  const int stride = 8 + TX_PAD_HOR;
+  uint8x16_t pos_to_offset =
+      load_pos_to_offset(kPosToOffset, SIG_COEF_CONTEXTS_2D);
+  int row = height;
+  uint8x16_t level[5];
+
+  assert(!(height % 2));
+
+  do {
+    load_levels_8x2x5(levels, stride, offsets, level);
+    store_coeff_contexts(coeff_contexts,
+                         get_coeff_contexts_kernel(level, pos_to_offset));
+    pos_to_offset = vdupq_n_u8(SIG_COEF_CONTEXTS_2D + 10);
+    levels += 2 * stride;
+    coeff_contexts += 16;
+    row -= 2;
+  } while (row);
+}
+
+static INLINE void get_16n_coeff_contexts_2d(const uint8_t *levels,
+                                             const int real_width,
+                                             const int real_height,
+                                             const int width, const int height,
+                                             const ptrdiff_t *const offsets,
+                                             int8_t *coeff_contexts) {
+  static const uint8_t kPosToOffsetSquare[4][16] = {
+    { 0, 1, 6, 6, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21 },
+    { 1, 6, 6, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21 },
+    { 6, 6, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21 },
+    { 6, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21 }
+  };
+  static const uint8_t kPosToOffsetWide[4][16] = {
+    { 0, 16, 6, 6, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21 },
+    { 16, 16, 6, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21 },
+    { 16, 16, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21 },
+    { 16, 16, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21 }
+  };
+  static const uint8_t kPosToOffsetTall[4][16] = {
+    { 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11 },
+    { 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11, 11 },
+    { 6, 6, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21 },
+    { 6, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21, 21 }
+  };
+  const int stride = width + TX_PAD_HOR;
+  const uint8_t(*table)[16];
+  int8_t *cc = coeff_contexts;
+  int row = height;
+  uint8x16_t pos_to_offset[5];
+  uint8x16_t pos_to_offset_large[3];
+  uint8x16_t level[5];
+
+  assert(!(width % 16));
+
+  if (real_width == real_height) {
+    table = kPosToOffsetSquare;
+  } else if (real_width > real_height) {
+    table = kPosToOffsetWide;
+  } else {  // real_width < real_height
+    table = kPosToOffsetTall;
+  }
+  for (int i = 0; i < 4; ++i) pos_to_offset[i] = vld1q_u8(table[i]);
+  // Wide blocks keep the offsets of row 3 for all further rows.
+  pos_to_offset[4] =
+      (real_width > real_height) ? pos_to_offset[3] : vdupq_n_u8(21);
+  pos_to_offset_large[0] = pos_to_offset_large[1] =
+      vdupq_n_u8(real_width < real_height ? 11 : 21);
+  pos_to_offset_large[2] = vdupq_n_u8(21);
+
+  do {
+    int w = width;
+
+    do {
+      load_levels_16x1x5(levels, stride, offsets, level);
+      store_coeff_contexts(cc,
+                           get_coeff_contexts_kernel(level, pos_to_offset[0]));
+      levels += 16;
+      cc += 16;
+      w -= 16;
+      pos_to_offset[0] = pos_to_offset_large[0];
+    } while (w);
+
+    pos_to_offset[0] = pos_to_offset[1];
+    pos_to_offset[1] = pos_to_offset[2];
+    pos_to_offset[2] = pos_to_offset[3];
+    pos_to_offset[3] = pos_to_offset[4];
+    pos_to_offset_large[0] = pos_to_offset_large[1];
+    pos_to_offset_large[1] = pos_to_offset_large[2];
+    levels += TX_PAD_HOR;
+  } while (--row);
+
+  coeff_contexts[0] = 0;
+}
+
+static INLINE void get_16n_coeff_contexts_hor(const uint8_t *levels,
+                                              const int width, const int height,
+                                              const ptrdiff_t *const offsets,
+                                              int8_t *coeff_contexts) {
+  static const uint8_t kPosToOffset[16] = { 0,  5,  10, 10, 10, 10, 10, 10,
+                                            10, 10, 10, 10, 10, 10, 10, 10 };
+  const int stride = width + TX_PAD_HOR;
+  const uint8x16_t pos_to_offset_first =
+      load_pos_to_offset(kPosToOffset, SIG_COEF_CONTEXTS_2D);
+  const uint8x16_t pos_to_offset_large =
+      vdupq_n_u8(SIG_COEF_CONTEXTS_2D + 10);
+  uint8x16_t level[5];
+  int row = height;
+
+  assert(!(width % 16));
+
+  do {
+    uint8x16_t pos_to_offset = pos_to_offset_first;
+    int w = width;
+
+    do {
+      load_levels_16x1x5(levels, stride, offsets, level);
+      store_coeff_contexts(coeff_contexts,
+                           get_coeff_contexts_kernel(level, pos_to_offset));
+      pos_to_offset = pos_to_offset_large;
+      levels += 16;
+      coeff_contexts += 16;
+      w -= 16;
+    } while (w);
+
+    levels += TX_PAD_HOR;
+  } while (--row);
+}
+
+static INLINE void get_16n_coeff_contexts_ver(const uint8_t *levels,
+                                              const int width, const int height,
+                                              const ptrdiff_t *const offsets,
+                                              int8_t *coeff_contexts) {
+  const int stride = width + TX_PAD_HOR;
+  uint8x16_t pos_to_offset[3];
+  uint8x16_t level[5];
+  int row = height;
+
+  assert(!(width % 16));
+
+  pos_to_offset[0] = vdupq_n_u8(SIG_COEF_CONTEXTS_2D + 0);
+  pos_to_offset[1] = vdupq_n_u8(SIG_COEF_CONTEXTS_2D + 5);
+  pos_to_offset[2] = vdupq_n_u8(SIG_COEF_CONTEXTS_2D + 10);
+
+  do {
+    int w = width;
+
+    do {
+      load_levels_16x1x5(levels, stride, offsets, level);
+      store_coeff_contexts(coeff_contexts,
+                           get_coeff_contexts_kernel(level, pos_to_offset[0]));
+      levels += 16;
+      coeff_contexts += 16;
+      w -= 16;
+    } while (w);
+
+    pos_to_offset[0] = pos_to_offset[1];
+    pos_to_offset[1] = pos_to_offset[2];
+    levels += TX_PAD_HOR;
+  } while (--row);
+}
+
+// Port of av1_get_nz_map_contexts_sse2(). levels[] must be in the range
+// [0, 127], inclusive.
+void av1_get_nz_map_contexts_neon(const uint8_t *const levels,
+                                  const int16_t *const scan, const uint16_t eob,
+                                  const TX_SIZE tx_size,
+                                  const TX_CLASS tx_class,
+                                  int8_t *const coeff_contexts) {
+  const int last_idx = eob - 1;
+  if (!last_idx) {
+    coeff_contexts[0] = 0;
+    return;
+  }
+
+  const int real_width = tx_size_wide[tx_size];
+  const int real_height = tx_size_high[tx_size];
+  const int width = get_txb_wide(tx_size);
+  const int height = get_txb_high(tx_size);
+  const int stride = width + TX_PAD_HOR;
+  ptrdiff_t offsets[3];
+
+  if (tx_class == TX_CLASS_2D) {
+    offsets[0] = 0 * stride + 2;
+    offsets[1] = 1 * stride + 1;
+    offsets[2] = 2 * stride + 0;
+
+    if (width == 4) {
+      get_4_nz_map_contexts_2d(levels, height, offsets, coeff_contexts);
+    } else if (width == 8) {
+      get_8_coeff_contexts_2d(levels, height, offsets, coeff_contexts);
+    } else {
+      get_16n_coeff_contexts_2d(levels, real_width, real_height, width, height,
+                                offsets, coeff_contexts);
+    }
+  } else if (tx_class == TX_CLASS_HORIZ) {
+    offsets[0] = 2;
+    offsets[1] = 3;
+    offsets[2] = 4;
+    if (width == 4) {
+      get_4_nz_map_contexts_hor(levels, height, offsets, coeff_contexts);
+    } else if (width == 8) {
+      get_8_coeff_contexts_hor(levels, height, offsets, coeff_contexts);
+    } else {
+      get_16n_coeff_contexts_hor(levels, width, height, offsets,
+                                 coeff_contexts);
+    }
+  } else {  // TX_CLASS_VERT
+    offsets[0] = 2 * stride;
+    offsets[1] = 3 * stride;
+    offsets[2] = 4 * stride;
+    if (width == 4) {
+      get_4_nz_map_contexts_ver(levels, height, offsets, coeff_contexts);
+    } else if (width == 8) {
+      get_8_coeff_contexts_ver(levels, height, offsets, coeff_contexts);
+    } else {
+      get_16n_coeff_contexts_ver(levels, width, height, offsets,
+                                 coeff_contexts);
+    }
+  }
+
+  const int bwl = get_txb_bwl(tx_size);
+  const int pos = scan[last_idx];
+  if (last_idx <= (height << bwl) / 8)
+    coeff_contexts[pos] = 1;
+  else if (last_idx <= (height << bwl) / 4)
+    coeff_contexts[pos] = 2;
+  else
+    coeff_contexts[pos] = 3;
+}
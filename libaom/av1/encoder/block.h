@@ -284,6 +284,9 @@ struct macroblock {
   int *nmvcost[2];
   int *nmvcost_hp[2];
   int **mv_cost_stack;
+  // The MV CDFs and precision the MV costs were last built from.
+  nmv_context nmv_cost_cdfs;
+  MvSubpelPrecision nmv_cost_precision;
 
   int32_t *wsrc_buf;
   int32_t *mask_buf;
@@ -311,7 +314,8 @@ struct macroblock {
   // [two buffers used ping-pong]
   uint32_t *hash_value_buffer[2][2];
 
-  CRC_CALCULATOR crc_calculator1;
+  // CRC-32C of the first hash value and 24-bit CRC of the second one.
+  CRC32C crc_calculator1;
   CRC_CALCULATOR crc_calculator2;
   int g_crc_initialized;
 
@@ -416,6 +420,10 @@ struct macroblock {
 #endif  // CONFIG_DIST_8X8
   int comp_idx_cost[COMP_INDEX_CONTEXTS][2];
   int comp_group_idx_cost[COMP_GROUP_IDX_CONTEXTS][2];
+  // The CDFs the mode and coefficient costs were last computed from.
+  // av1_fill_mode_rates() and av1_fill_coeff_costs() only recompute the costs
+  // of the CDFs that changed since; zero it to recompute all of them.
+  FRAME_CONTEXT cost_cdfs;
   // Bit flags for pruning tx type search, tx split, etc.
   int tx_search_prune[EXT_TX_SET_TYPES];
   int must_find_valid_partition;
@@ -14,24 +14,177 @@
 #include <memory.h>
 #include <math.h>
 #include <assert.h>
+#include <limits.h>
 
-#include "third_party/fastfeat/fast.h"
+#include "config/av1_rtcd.h"
+
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_mem/aom_mem.h"
 
 #include "av1/encoder/corner_detect.h"
 
-// Fast_9 wrapper
+// Offsets of the 16 pixels of the Bresenham circle of radius 3, in the same
+// order as make_offsets() in third_party/fastfeat/fast_9.c.
+static const int fast9_circle[16][2] = {
+  { 0, 3 },  { 1, 3 },   { 2, 2 },   { 3, 1 },   { 3, 0 },  { 3, -1 },
+  { 2, -2 }, { 1, -3 },  { 0, -3 },  { -1, -3 }, { -2, -2 }, { -3, -1 },
+  { -3, 0 }, { -3, 1 },  { -2, 2 },  { -1, 3 }
+};
+
+static void fast9_make_offsets(int *pixel, int stride) {
+  for (int i = 0; i < 16; ++i) {
+    pixel[i] = fast9_circle[i][0] + fast9_circle[i][1] * stride;
+  }
+}
+
+// Returns 1 if the 16 bit circular mask has a run of at least 9 set bits.
+static INLINE int has_arc9(unsigned int mask) {
+  unsigned int m = mask | (mask << 16);
+  m &= m >> 1;
+  m &= m >> 2;
+  m &= m >> 4;
+  m &= (mask | (mask << 16)) >> 8;
+  return (m & 0xffff) != 0;
+}
+
+// Corner score: the largest threshold for which p is still a corner. This is
+// the value fast9_corner_score() finds by binary search, computed directly as
+// the best over all arcs of 9 pixels of the smallest difference to p, minus 1.
+static int fast9_score(const unsigned char *p, const int *pixel) {
+  int d[16], m2[16], m4[16];
+  int best_bright = INT_MIN, best_dark = INT_MIN;
+  int i;
+
+  for (i = 0; i < 16; ++i) d[i] = p[pixel[i]] - *p;
+  // Brighter arcs: min(d) over the arc.
+  for (i = 0; i < 16; ++i) m2[i] = AOMMIN(d[i], d[(i + 1) & 15]);
+  for (i = 0; i < 16; ++i) m4[i] = AOMMIN(m2[i], m2[(i + 2) & 15]);
+  for (i = 0; i < 16; ++i) {
+    const int m9 = AOMMIN(AOMMIN(m4[i], m4[(i + 4) & 15]), d[(i + 8) & 15]);
+    best_bright = AOMMAX(best_bright, m9);
+  }
+  // Darker arcs: min(-d) = -max(d) over the arc.
+  for (i = 0; i < 16; ++i) m2[i] = AOMMAX(d[i], d[(i + 1) & 15]);
+  for (i = 0; i < 16; ++i) m4[i] = AOMMAX(m2[i], m2[(i + 2) & 15]);
+  for (i = 0; i < 16; ++i) {
+    const int m9 = AOMMAX(AOMMAX(m4[i], m4[(i + 4) & 15]), d[(i + 8) & 15]);
+    best_dark = AOMMAX(best_dark, -m9);
+  }
+  return AOMMAX(best_bright, best_dark) - 1;
+}
+
+// Segment test of FAST-9: (x, y) is a corner if 9 contiguous pixels of the
+// circle are all brighter than p + threshold or all darker than p - threshold.
+// This gives the same answer as the decision tree in fast9_detect(). Writes
+// the x position and the score of each corner of the row to xs and scores.
+int av1_fast9_detect_row_c(const unsigned char *row, int stride, int width,
+                           int threshold, int *xs, int *scores) {
+  int pixel[16];
+  int num = 0;
+
+  fast9_make_offsets(pixel, stride);
+  for (int x = 3; x < width - 3; ++x) {
+    const unsigned char *const p = row + x;
+    const int cb = *p + threshold;
+    const int c_b = *p - threshold;
+    unsigned int bright = 0, dark = 0;
+
+    // Any arc of 9 pixels covers 2 adjacent compass points.
+    for (int i = 0; i < 16; i += 4) {
+      bright |= (p[pixel[i]] > cb) << i;
+      dark |= (p[pixel[i]] < c_b) << i;
+    }
+    if (!(bright & ((bright >> 4) | (bright << 12))) &&
+        !(dark & ((dark >> 4) | (dark << 12))))
+      continue;
+
+    for (int i = 0; i < 16; ++i) {
+      bright |= (p[pixel[i]] > cb) << i;
+      dark |= (p[pixel[i]] < c_b) << i;
+    }
+    if (has_arc9(bright) || has_arc9(dark)) {
+      xs[num] = x;
+      scores[num++] = fast9_score(p, pixel);
+    }
+  }
+  return num;
+}
+
+// Non-maximum suppression over 3 consecutive rows of scores, where a negative
+// score means there is no corner. A corner is kept if every corner among its
+// 8 neighbours has a lower score, as in nonmax_suppression().
+static INLINE int fast9_is_local_max(const int *above, const int *cur,
+                                     const int *below, int x) {
+  const int score = cur[x];
+  if (cur[x - 1] >= score || cur[x + 1] >= score) return 0;
+  if (above[x - 1] >= score || above[x] >= score || above[x + 1] >= score)
+    return 0;
+  if (below[x - 1] >= score || below[x] >= score || below[x + 1] >= score)
+    return 0;
+  return 1;
+}
+
+// Detect, score and suppress one row at a time, keeping only the scores of the
+// last 3 rows. Corners come out in raster order, so the detection stops as
+// soon as max_points corners have been kept.
 #define FAST_BARRIER 18
 int fast_corner_detect(unsigned char *buf, int width, int height, int stride,
-                       int *points, int max_points) {
-  int num_points;
-  xy *const frm_corners_xy = fast9_detect_nonmax(buf, width, height, stride,
-                                                 FAST_BARRIER, &num_points);
-  num_points = (num_points <= max_points ? num_points : max_points);
-  if (num_points > 0 && frm_corners_xy) {
-    memcpy(points, frm_corners_xy, sizeof(*frm_corners_xy) * num_points);
-    free(frm_corners_xy);
-    return num_points;
+                       int *points, int max_points,
+                       CornerDetectBuffer *scratch) {
+  int *xs, *scores, *rows[3];
+  int num_points = 0;
+
+  if (width < 7 || height < 7 || max_points <= 0) return 0;
+
+  // The score rows have one extra column on each side so that the neighbours
+  // of the first and last pixel of a row can be read unconditionally.
+  if (width > scratch->width) {
+    aom_free(scratch->buf);
+    scratch->width = 0;
+    scratch->buf = (int *)aom_malloc(sizeof(*scratch->buf) *
+                                     (2 * width + 3 * (width + 2)));
+    if (!scratch->buf) return 0;
+    scratch->width = width;
+  }
+  xs = scratch->buf;
+  scores = scratch->buf + width;
+  for (int i = 0; i < 3; ++i) {
+    rows[i] = scratch->buf + 2 * width + i * (width + 2) + 1;
+    for (int x = -1; x <= width; ++x) rows[i][x] = -1;
   }
-  free(frm_corners_xy);
-  return 0;
+
+  // rows[0], rows[1] and rows[2] hold the scores of rows y - 1, y and y + 1.
+  for (int y = 2; y < height - 3 && num_points < max_points; ++y) {
+    int *const next = rows[0];
+    const int next_y = y + 1;
+    rows[0] = rows[1];
+    rows[1] = rows[2];
+    rows[2] = next;
+
+    for (int x = 0; x < width; ++x) next[x] = -1;
+    if (next_y < height - 3) {
+      const unsigned char *const row = buf + next_y * stride;
+      const int num =
+          av1_fast9_detect_row(row, stride, width, FAST_BARRIER, xs, scores);
+      for (int i = 0; i < num; ++i) next[xs[i]] = scores[i];
+    }
+
+    if (y < 3) continue;
+    for (int x = 3; x < width - 3; ++x) {
+      if (rows[1][x] < 0) continue;
+      if (fast9_is_local_max(rows[0], rows[1], rows[2], x)) {
+        points[2 * num_points] = x;
+        points[2 * num_points + 1] = y;
+        if (++num_points == max_points) break;
+      }
+    }
+  }
+
+  return num_points;
+}
+
+void av1_free_corner_detect_buffer(CornerDetectBuffer *scratch) {
+  aom_free(scratch->buf);
+  scratch->buf = NULL;
+  scratch->width = 0;
 }
@@ -16,7 +16,25 @@
 #include <stdlib.h>
 #include <memory.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Scratch memory of fast_corner_detect(). It is kept across calls, so that
+// only a frame wider than all the previous ones allocates.
+typedef struct {
+  int *buf;
+  int width;
+} CornerDetectBuffer;
+
+void av1_free_corner_detect_buffer(CornerDetectBuffer *scratch);
+
 int fast_corner_detect(unsigned char *buf, int width, int height, int stride,
-                       int *points, int max_points);
+                       int *points, int max_points,
+                       CornerDetectBuffer *scratch);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
 
 #endif  // AOM_AV1_ENCODER_CORNER_DETECT_H_
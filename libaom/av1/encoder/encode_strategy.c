@@ -518,7 +518,9 @@ static struct lookahead_entry *setup_arf_or_arf2(
     } else {
       if (oxcf->arnr_max_frames > 0) {
         // Produce the filtered ARF frame.
+        start_stage_timing(cpi, AOM_ENC_STAGE_TEMPORAL_FILTER);
         av1_temporal_filter(cpi, arf_src_index);
+        end_stage_timing(cpi, AOM_ENC_STAGE_TEMPORAL_FILTER);
         aom_extend_frame_borders(&cpi->alt_ref_buffer, av1_num_planes(cm));
         *temporal_filtered = 1;
       }
@@ -944,6 +946,75 @@ static int get_refresh_frame_flags(const AV1_COMP *const cpi,
   return refresh_mask;
 }
 
+// Reference buffer slots of the SVC patterns. Each spatial layer keeps its
+// temporal layer 0 frame, its temporal layer 1 frame and, when a higher
+// spatial layer predicts from it, its top temporal layer frame.
+static INLINE int svc_base_slot(const SVC *svc, int sl) {
+  (void)svc;
+  return sl;
+}
+
+static INLINE int svc_tl1_slot(const SVC *svc, int sl) {
+  return svc->number_spatial_layers + sl;
+}
+
+static INLINE int svc_top_slot(const SVC *svc, int sl) {
+  return 2 * svc->number_spatial_layers + sl;
+}
+
+// Returns the slot refreshed by the given layer of the current superframe, or
+// -1 if its frames are not used for reference.
+static int svc_refreshed_slot(const SVC *svc, int sl, int tl) {
+  if (tl == 0) return svc_base_slot(svc, sl);
+  if (tl < svc->number_temporal_layers - 1) return svc_tl1_slot(svc, sl);
+  if (sl < svc->number_spatial_layers - 1) return svc_top_slot(svc, sl);
+  return -1;
+}
+
+// Sets up the references and refreshes of a layer frame: LAST is the closest
+// lower temporal layer frame of the same spatial layer and GOLDEN is the frame
+// of the spatial layer below in the same superframe.
+static void set_svc_ref_frame_config(AV1_COMP *const cpi,
+                                     EncodeFrameParams *const frame_params) {
+  const SVC *const svc = &cpi->svc;
+  const int sl = svc->spatial_layer_id;
+  const int tl = svc->temporal_layer_id;
+  if (frame_params->frame_type == KEY_FRAME) return;
+
+  int ref_flags = 0;
+  int last_slot = svc_base_slot(svc, sl);
+  if (svc->number_temporal_layers == 3 && (svc->superframe_index & 3) == 3)
+    last_slot = svc_tl1_slot(svc, sl);
+  int gld_slot = last_slot;
+  if (!svc->key_superframe) ref_flags |= AOM_LAST_FLAG;
+  if (sl > 0) {
+    gld_slot = svc_refreshed_slot(svc, sl - 1, tl);
+    ref_flags |= AOM_GOLD_FLAG;
+  }
+  const int primary_slot =
+      (ref_flags & AOM_LAST_FLAG) ? last_slot : gld_slot;
+  for (int i = 0; i < INTER_REFS_PER_FRAME; ++i)
+    frame_params->remapped_ref_idx[i] = primary_slot;
+  frame_params->remapped_ref_idx[LAST_FRAME - LAST_FRAME] = last_slot;
+  frame_params->remapped_ref_idx[GOLDEN_FRAME - LAST_FRAME] = gld_slot;
+
+  frame_params->ref_frame_flags = ref_flags & cpi->ext_ref_frame_flags;
+  if (!frame_params->error_resilient_mode) {
+    frame_params->primary_ref_frame = (ref_flags & AOM_LAST_FLAG)
+                                          ? LAST_FRAME - LAST_FRAME
+                                          : GOLDEN_FRAME - LAST_FRAME;
+  }
+
+  const int refresh_slot = svc_refreshed_slot(svc, sl, tl);
+  frame_params->refresh_frame_flags =
+      refresh_slot >= 0 ? 1 << refresh_slot : 0;
+  frame_params->refresh_last_frame = refresh_slot >= 0;
+  frame_params->refresh_golden_frame = 0;
+  frame_params->refresh_bwd_ref_frame = 0;
+  frame_params->refresh_alt2_ref_frame = 0;
+  frame_params->refresh_alt_ref_frame = 0;
+}
+
 int av1_encode_strategy(AV1_COMP *const cpi, size_t *const size,
                         uint8_t *const dest, unsigned int *frame_flags,
                         int64_t *const time_stamp, int64_t *const time_end,
@@ -1006,14 +1077,27 @@ int av1_encode_strategy(AV1_COMP *const cpi, size_t *const size,
   if (!frame_params.show_existing_frame)
     *frame_flags = (source->flags & AOM_EFLAG_FORCE_KF) ? FRAMEFLAGS_KEY : 0;
 
+  if (cpi->use_svc) {
+    av1_svc_start_frame(cpi, cm->current_frame.frame_number == 0 ||
+                                 (source->flags & AOM_EFLAG_FORCE_KF) ||
+                                 cpi->rc.frames_to_key == 0);
+  }
+
   const int is_overlay = frame_params.show_existing_frame &&
                          (frame_update_type == OVERLAY_UPDATE ||
                           frame_update_type == INTNL_OVERLAY_UPDATE);
-  if (frame_params.show_frame || is_overlay) {
-    // Shown frames and arf-overlay frames need frame-rate considering
+  if ((frame_params.show_frame || is_overlay) &&
+      (!cpi->use_svc || cpi->svc.spatial_layer_id == 0)) {
+    // Shown frames and arf-overlay frames need frame-rate considering. The
+    // spatial layers of a superframe share the timestamp of the first one.
     adjust_frame_rate(cpi, source);
   }
 
+  if (cpi->use_svc) {
+    av1_update_temporal_layer_framerate(cpi);
+    av1_restore_layer_context(cpi);
+  }
+
   if (frame_params.show_existing_frame) {
     // show_existing_frame implies this frame is shown!
     frame_params.show_frame = 1;
@@ -1063,7 +1147,12 @@ int av1_encode_strategy(AV1_COMP *const cpi, size_t *const size,
     if (cpi->twopass.gf_group.index == 1 && cpi->oxcf.enable_tpl_model) {
       av1_configure_buffer_updates(cpi, &frame_params, frame_update_type, 0);
       av1_set_frame_size(cpi, cm->width, cm->height);
-      av1_tpl_setup_stats(cpi, &frame_input);
+      if (!av1_analysis_cache_load_tpl(cpi, source)) {
+        start_stage_timing(cpi, AOM_ENC_STAGE_TPL);
+        av1_tpl_setup_stats(cpi, &frame_input);
+        end_stage_timing(cpi, AOM_ENC_STAGE_TPL);
+        av1_analysis_cache_store_tpl(cpi);
+      }
     }
   }
 
@@ -1130,6 +1219,7 @@ int av1_encode_strategy(AV1_COMP *const cpi, size_t *const size,
   // cm->remapped_ref_idx then update_ref_frame_map() will have no effect.
   memcpy(frame_params.remapped_ref_idx, cm->remapped_ref_idx,
          REF_FRAMES * sizeof(*cm->remapped_ref_idx));
+  if (cpi->use_svc) set_svc_ref_frame_config(cpi, &frame_params);
 
   if (av1_encode(cpi, dest, &frame_input, &frame_params, &frame_results) !=
       AOM_CODEC_OK) {
@@ -1140,7 +1230,7 @@ int av1_encode_strategy(AV1_COMP *const cpi, size_t *const size,
     // First pass doesn't modify reference buffer assignment or produce frame
     // flags
     update_frame_flags(cpi, frame_flags);
-    update_ref_frame_map(cpi, frame_update_type);
+    if (!cpi->use_svc) update_ref_frame_map(cpi, frame_update_type);
   }
 
   if (oxcf->pass == 2) {
@@ -1158,7 +1248,11 @@ int av1_encode_strategy(AV1_COMP *const cpi, size_t *const size,
   if (oxcf->pass == 0 || oxcf->pass == 2) {
     update_fb_of_context_type(cpi, &frame_params, cpi->fb_of_context_type);
     set_additional_frame_flags(cm, frame_flags);
-    update_rc_counts(cpi);
+    // The key frame counters advance once per superframe.
+    if (!cpi->use_svc ||
+        cpi->svc.spatial_layer_id == cpi->svc.number_spatial_layers - 1)
+      update_rc_counts(cpi);
+    if (cpi->use_svc) av1_save_layer_context(cpi);
   }
 
   // Unpack frame_results:
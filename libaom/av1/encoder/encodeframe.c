@@ -228,12 +228,8 @@ static void set_offsets_without_segment_id(const AV1_COMP *const cpi,
                        num_planes);
 
   // Set up limit values for MV components.
-  // Mv beyond the range do not produce new/different prediction block.
-  x->mv_limits.row_min =
-      -(((mi_row + mi_height) * MI_SIZE) + AOM_INTERP_EXTEND);
-  x->mv_limits.col_min = -(((mi_col + mi_width) * MI_SIZE) + AOM_INTERP_EXTEND);
-  x->mv_limits.row_max = (cm->mi_rows - mi_row) * MI_SIZE + AOM_INTERP_EXTEND;
-  x->mv_limits.col_max = (cm->mi_cols - mi_col) * MI_SIZE + AOM_INTERP_EXTEND;
+  av1_set_mv_limits(cm, &x->mv_limits, mi_row, mi_col, mi_height, mi_width,
+                    cpi->oxcf.border_in_pixels);
 
   set_plane_n4(xd, mi_width, mi_height, num_planes);
 
@@ -655,7 +651,10 @@ static void pick_sb_modes(AV1_COMP *const cpi, TileDataEnc *tile_data,
     } else {
       // TODO(kyslov): do the same for pick_intra_mode and
       //               pick_inter_mode_sb_seg_skip
-      if (use_nonrd_pick_mode) {
+      if (use_nonrd_pick_mode && cpi->sf.use_fast_nonrd_pick_mode) {
+        av1_fast_nonrd_pick_inter_mode_sb(cpi, tile_data, x, mi_row, mi_col,
+                                          rd_cost, bsize, ctx, best_rd);
+      } else if (use_nonrd_pick_mode) {
         av1_nonrd_pick_inter_mode_sb(cpi, tile_data, x, mi_row, mi_col, rd_cost,
                                      bsize, ctx, best_rd);
       } else {
@@ -3322,6 +3321,9 @@ static void rd_pick_partition(AV1_COMP *const cpi, ThreadData *td,
         &simple_motion_features_are_valid);
   }
 
+  av1_motion_hints_prune_partition(&cpi->motion_hints, mi_row, mi_col, bsize,
+                                   &partition_none_allowed, &do_square_split);
+
   // Max and min square partition levels are defined as the partition nodes that
   // the recursive function rd_pick_partition() can reach. To implement this:
   // only PARTITION_NONE is allowed if the current node equals min_sq_part,
@@ -5293,6 +5295,43 @@ static void set_default_interp_skip_flags(AV1_COMP *cpi) {
                                        : DEFAULT_INTERP_SKIP_FLAG;
 }
 
+// Gets the luma rows of source that differ from the source the last hash table
+// was built from, and updates the copy of its luma plane. Returns that table
+// when it can be updated to source, and NULL otherwise.
+static const hash_table *get_changed_hash_source_rows(
+    AV1_COMP *cpi, const YV12_BUFFER_CONFIG *source, int *changed_row_start,
+    int *changed_row_end) {
+  AV1_COMMON *const cm = &cpi->common;
+  const int use_hbd = (source->flags & YV12_FLAG_HIGHBITDEPTH) != 0;
+  const uint8_t *const src =
+      use_hbd ? (const uint8_t *)CONVERT_TO_SHORTPTR(source->y_buffer)
+              : source->y_buffer;
+  const int src_stride = source->y_stride << use_hbd;
+  const int row_bytes = source->y_crop_width << use_hbd;
+  const size_t size = (size_t)row_bytes * source->y_crop_height;
+  const hash_table *prev_hash_table = cpi->hash_source_table;
+
+  *changed_row_start = source->y_crop_height;
+  *changed_row_end = 0;
+  if (cpi->hash_source_size != size) {
+    aom_free(cpi->hash_source_y);
+    cpi->hash_source_size = 0;
+    CHECK_MEM_ERROR(cm, cpi->hash_source_y, aom_malloc(size));
+    cpi->hash_source_size = size;
+    prev_hash_table = NULL;
+  }
+  for (int row = 0; row < source->y_crop_height; ++row) {
+    uint8_t *const copy = cpi->hash_source_y + row * row_bytes;
+    const uint8_t *const src_row = src + row * src_stride;
+    if (prev_hash_table == NULL || memcmp(copy, src_row, row_bytes)) {
+      if (*changed_row_start > row) *changed_row_start = row;
+      *changed_row_end = row + 1;
+      memcpy(copy, src_row, row_bytes);
+    }
+  }
+  return prev_hash_table;
+}
+
 static void encode_frame_internal(AV1_COMP *cpi) {
   ThreadData *const td = &cpi->td;
   MACROBLOCK *const x = &td->mb;
@@ -5328,75 +5367,17 @@ static void encode_frame_internal(AV1_COMP *cpi) {
   cm->allow_intrabc &= (cpi->oxcf.enable_intrabc);
 
   if (cpi->oxcf.pass != 1 && av1_use_hash_me(cm)) {
-    // add to hash table
-    const int pic_width = cpi->source->y_crop_width;
-    const int pic_height = cpi->source->y_crop_height;
-    uint32_t *block_hash_values[2][2];
-    int8_t *is_block_same[2][3];
-    int k, j;
-
-    for (k = 0; k < 2; k++) {
-      for (j = 0; j < 2; j++) {
-        CHECK_MEM_ERROR(cm, block_hash_values[k][j],
-                        aom_malloc(sizeof(uint32_t) * pic_width * pic_height));
-      }
-
-      for (j = 0; j < 3; j++) {
-        CHECK_MEM_ERROR(cm, is_block_same[k][j],
-                        aom_malloc(sizeof(int8_t) * pic_width * pic_height));
-      }
-    }
-
-    av1_hash_table_create(&cm->cur_frame->hash_table);
-    av1_generate_block_2x2_hash_value(cpi->source, block_hash_values[0],
-                                      is_block_same[0], &cpi->td.mb);
-    av1_generate_block_hash_value(cpi->source, 4, block_hash_values[0],
-                                  block_hash_values[1], is_block_same[0],
-                                  is_block_same[1], &cpi->td.mb);
-    av1_add_to_hash_map_by_row_with_precal_data(
-        &cm->cur_frame->hash_table, block_hash_values[1], is_block_same[1][2],
-        pic_width, pic_height, 4);
-    av1_generate_block_hash_value(cpi->source, 8, block_hash_values[1],
-                                  block_hash_values[0], is_block_same[1],
-                                  is_block_same[0], &cpi->td.mb);
-    av1_add_to_hash_map_by_row_with_precal_data(
-        &cm->cur_frame->hash_table, block_hash_values[0], is_block_same[0][2],
-        pic_width, pic_height, 8);
-    av1_generate_block_hash_value(cpi->source, 16, block_hash_values[0],
-                                  block_hash_values[1], is_block_same[0],
-                                  is_block_same[1], &cpi->td.mb);
-    av1_add_to_hash_map_by_row_with_precal_data(
-        &cm->cur_frame->hash_table, block_hash_values[1], is_block_same[1][2],
-        pic_width, pic_height, 16);
-    av1_generate_block_hash_value(cpi->source, 32, block_hash_values[1],
-                                  block_hash_values[0], is_block_same[1],
-                                  is_block_same[0], &cpi->td.mb);
-    av1_add_to_hash_map_by_row_with_precal_data(
-        &cm->cur_frame->hash_table, block_hash_values[0], is_block_same[0][2],
-        pic_width, pic_height, 32);
-    av1_generate_block_hash_value(cpi->source, 64, block_hash_values[0],
-                                  block_hash_values[1], is_block_same[0],
-                                  is_block_same[1], &cpi->td.mb);
-    av1_add_to_hash_map_by_row_with_precal_data(
-        &cm->cur_frame->hash_table, block_hash_values[1], is_block_same[1][2],
-        pic_width, pic_height, 64);
-
-    av1_generate_block_hash_value(cpi->source, 128, block_hash_values[1],
-                                  block_hash_values[0], is_block_same[1],
-                                  is_block_same[0], &cpi->td.mb);
-    av1_add_to_hash_map_by_row_with_precal_data(
-        &cm->cur_frame->hash_table, block_hash_values[0], is_block_same[0][2],
-        pic_width, pic_height, 128);
-
-    for (k = 0; k < 2; k++) {
-      for (j = 0; j < 2; j++) {
-        aom_free(block_hash_values[k][j]);
-      }
-
-      for (j = 0; j < 3; j++) {
-        aom_free(is_block_same[k][j]);
-      }
+    int changed_row_start, changed_row_end;
+    const hash_table *const prev_hash_table = get_changed_hash_source_rows(
+        cpi, cpi->source, &changed_row_start, &changed_row_end);
+    cpi->hash_source_table = NULL;
+    if (av1_hash_table_build(&cm->cur_frame->hash_table, prev_hash_table,
+                             cpi->source, changed_row_start, changed_row_end,
+                             &cpi->td.mb, cpi->workers, cpi->num_workers)) {
+      aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                         "Failed to allocate hash table");
     }
+    cpi->hash_source_table = &cm->cur_frame->hash_table;
   }
 
   for (i = 0; i < MAX_SEGMENTS; ++i) {
@@ -5558,7 +5539,8 @@ static void encode_frame_internal(AV1_COMP *cpi) {
           av1_compute_global_motion(model, cpi->source, ref_buf[frame],
                                     cpi->common.seq_params.bit_depth,
                                     gm_estimation_type, inliers_by_motion,
-                                    params_by_motion, RANSAC_NUM_MOTIONS);
+                                    params_by_motion, RANSAC_NUM_MOTIONS,
+                                    &cpi->corner_buffer);
 
           for (i = 0; i < RANSAC_NUM_MOTIONS; ++i) {
             if (inliers_by_motion[i] == 0) continue;
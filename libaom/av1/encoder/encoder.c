@@ -542,6 +542,10 @@ static void dealloc_compressor_data(AV1_COMP *cpi) {
   aom_free(cpi->active_map.map);
   cpi->active_map.map = NULL;
 
+  av1_free_motion_hints(&cpi->motion_hints);
+  av1_free_corner_detect_buffer(&cpi->corner_buffer);
+  av1_lookahead_analysis_free(&cpi->lookahead_analysis);
+
   aom_free(cpi->td.mb.above_pred_buf);
   cpi->td.mb.above_pred_buf = NULL;
 
@@ -590,6 +594,7 @@ static void dealloc_compressor_data(AV1_COMP *cpi) {
   aom_free(cpi->td.mb.tmp_conv_dst);
   for (int j = 0; j < 2; ++j) {
     aom_free(cpi->td.mb.tmp_obmc_bufs[j]);
+    aom_free(cpi->td.mc_buf[j]);
   }
 
 #if CONFIG_DENOISE
@@ -615,6 +620,8 @@ static void save_coding_context(AV1_COMP *cpi) {
   av1_copy(cc->nmv_vec_cost, cpi->td.mb.nmv_vec_cost);
   av1_copy(cc->nmv_costs, cpi->nmv_costs);
   av1_copy(cc->nmv_costs_hp, cpi->nmv_costs_hp);
+  cc->nmv_cost_cdfs = cpi->td.mb.nmv_cost_cdfs;
+  cc->nmv_cost_precision = cpi->td.mb.nmv_cost_precision;
 
   cc->fc = *cm->fc;
 }
@@ -628,6 +635,8 @@ static void restore_coding_context(AV1_COMP *cpi) {
   av1_copy(cpi->td.mb.nmv_vec_cost, cc->nmv_vec_cost);
   av1_copy(cpi->nmv_costs, cc->nmv_costs);
   av1_copy(cpi->nmv_costs_hp, cc->nmv_costs_hp);
+  cpi->td.mb.nmv_cost_cdfs = cc->nmv_cost_cdfs;
+  cpi->td.mb.nmv_cost_precision = cc->nmv_cost_precision;
 
   *cm->fc = cc->fc;
 }
@@ -1085,12 +1094,19 @@ static void init_seq_coding_tools(SequenceHeader *seq, AV1_COMMON *cm,
     seq->operating_point_idc[0] = 0;
   } else {
     // Set operating_point_idc[] such that for the i-th operating point the
-    // first (operating_points_cnt-i) spatial layers and the first temporal
-    // layer are decoded Note that highest quality operating point should come
-    // first
-    for (int i = 0; i < seq->operating_points_cnt_minus_1 + 1; i++)
+    // first (number_spatial_layers - i / number_temporal_layers) spatial
+    // layers and the first (number_temporal_layers - i %
+    // number_temporal_layers) temporal layers are decoded. Note that highest
+    // quality operating point should come first
+    const int num_temporal = AOMMAX((int)cm->number_temporal_layers, 1);
+    const int num_spatial = (seq->operating_points_cnt_minus_1 + 1) /
+                            num_temporal;
+    for (int i = 0; i < seq->operating_points_cnt_minus_1 + 1; i++) {
+      const int sl = i / num_temporal;
+      const int tl = i % num_temporal;
       seq->operating_point_idc[i] =
-          (~(~0u << (seq->operating_points_cnt_minus_1 + 1 - i)) << 8) | 1;
+          (~(~0u << (num_spatial - sl)) << 8) | ~(~0u << (num_temporal - tl));
+    }
   }
 }
 
@@ -1486,6 +1502,9 @@ MAKE_OBFP_SAD_WRAPPER(aom_highbd_obmc_sad64x16)
 static void highbd_set_var_fns(AV1_COMP *const cpi) {
   AV1_COMMON *const cm = &cpi->common;
   if (cm->seq_params.use_highbitdepth) {
+    // There are no high bitdepth batched sub-pixel variance functions; the
+    // motion search falls back to svf for each candidate.
+    for (int i = 0; i < BLOCK_SIZES_ALL; ++i) cpi->fn_ptr[i].svfx4d = NULL;
     switch (cm->seq_params.bit_depth) {
       case AOM_BITS_8:
         HIGHBD_BFP(BLOCK_64X16, aom_highbd_sad64x16_bits8,
@@ -2478,6 +2497,14 @@ void av1_change_config(struct AV1_COMP *cpi, const AV1EncoderConfig *oxcf) {
       x->e_mbd.tmp_obmc_bufs[i] = x->tmp_obmc_bufs[i];
     }
   }
+  if (has_small_border(&cpi->oxcf)) {
+    for (int i = 0; i < 2; ++i) {
+      if (cpi->td.mc_buf[i] == NULL) {
+        CHECK_MEM_ERROR(cm, cpi->td.mc_buf[i], aom_memalign(32, MC_BUF_SIZE));
+        x->e_mbd.mc_buf[i] = cpi->td.mc_buf[i];
+      }
+    }
+  }
 
   av1_reset_segment_features(cm);
   set_high_precision_mv(cpi, 1, 0);
@@ -2496,6 +2523,8 @@ void av1_change_config(struct AV1_COMP *cpi, const AV1EncoderConfig *oxcf) {
   rc->worst_quality = cpi->oxcf.worst_allowed_q;
   rc->best_quality = cpi->oxcf.best_allowed_q;
 
+  if (cpi->use_svc) av1_update_layer_context_change_config(cpi);
+
   cm->interp_filter = oxcf->large_scale_tile ? EIGHTTAP_REGULAR : SWITCHABLE;
   cm->switchable_motion_mode = 1;
 
@@ -2542,8 +2571,13 @@ void av1_change_config(struct AV1_COMP *cpi, const AV1EncoderConfig *oxcf) {
   // Init sequence level coding tools
   // This should not be called after the first key frame.
   if (!cpi->seq_params_locked) {
-    seq_params->operating_points_cnt_minus_1 =
-        cm->number_spatial_layers > 1 ? cm->number_spatial_layers - 1 : 0;
+    if (cpi->use_svc) {
+      seq_params->operating_points_cnt_minus_1 =
+          cm->number_spatial_layers * cm->number_temporal_layers - 1;
+    } else {
+      seq_params->operating_points_cnt_minus_1 =
+          cm->number_spatial_layers > 1 ? cm->number_spatial_layers - 1 : 0;
+    }
     init_seq_coding_tools(&cm->seq_params, cm, oxcf);
   }
 }
@@ -2946,6 +2980,31 @@ AV1_COMP *av1_create_compressor(AV1EncoderConfig *oxcf,
 
   MBFP(BLOCK_64X16, aom_masked_sad64x16, aom_masked_sub_pixel_variance64x16)
 
+#define SVFX4D(BT, SVFX4DF) cpi->fn_ptr[BT].svfx4d = SVFX4DF;
+
+  SVFX4D(BLOCK_128X128, aom_sub_pixel_variance128x128x4d)
+  SVFX4D(BLOCK_128X64, aom_sub_pixel_variance128x64x4d)
+  SVFX4D(BLOCK_64X128, aom_sub_pixel_variance64x128x4d)
+  SVFX4D(BLOCK_64X64, aom_sub_pixel_variance64x64x4d)
+  SVFX4D(BLOCK_64X32, aom_sub_pixel_variance64x32x4d)
+  SVFX4D(BLOCK_32X64, aom_sub_pixel_variance32x64x4d)
+  SVFX4D(BLOCK_32X32, aom_sub_pixel_variance32x32x4d)
+  SVFX4D(BLOCK_32X16, aom_sub_pixel_variance32x16x4d)
+  SVFX4D(BLOCK_16X32, aom_sub_pixel_variance16x32x4d)
+  SVFX4D(BLOCK_16X16, aom_sub_pixel_variance16x16x4d)
+  SVFX4D(BLOCK_16X8, aom_sub_pixel_variance16x8x4d)
+  SVFX4D(BLOCK_8X16, aom_sub_pixel_variance8x16x4d)
+  SVFX4D(BLOCK_8X8, aom_sub_pixel_variance8x8x4d)
+  SVFX4D(BLOCK_4X8, aom_sub_pixel_variance4x8x4d)
+  SVFX4D(BLOCK_8X4, aom_sub_pixel_variance8x4x4d)
+  SVFX4D(BLOCK_4X4, aom_sub_pixel_variance4x4x4d)
+  SVFX4D(BLOCK_4X16, aom_sub_pixel_variance4x16x4d)
+  SVFX4D(BLOCK_16X4, aom_sub_pixel_variance16x4x4d)
+  SVFX4D(BLOCK_8X32, aom_sub_pixel_variance8x32x4d)
+  SVFX4D(BLOCK_32X8, aom_sub_pixel_variance32x8x4d)
+  SVFX4D(BLOCK_16X64, aom_sub_pixel_variance16x64x4d)
+  SVFX4D(BLOCK_64X16, aom_sub_pixel_variance64x16x4d)
+
   highbd_set_var_fns(cpi);
 
   /* av1_init_quantizer() is first called here. Add check in
@@ -3071,6 +3130,7 @@ void av1_remove_compressor(AV1_COMP *cpi) {
 #endif
   }
 
+  av1_close_analysis_cache(&cpi->analysis_cache);
   for (int frame = 0; frame < MAX_LAG_BUFFERS; ++frame) {
     aom_free(cpi->tpl_stats[frame].tpl_stats_ptr);
     cpi->tpl_stats[frame].is_valid = 0;
@@ -3090,6 +3150,7 @@ void av1_remove_compressor(AV1_COMP *cpi) {
       aom_free(thread_data->td->tmp_conv_dst);
       for (int j = 0; j < 2; ++j) {
         aom_free(thread_data->td->tmp_obmc_bufs[j]);
+        aom_free(thread_data->td->mc_buf[j]);
       }
       aom_free(thread_data->td->above_pred_buf);
       aom_free(thread_data->td->left_pred_buf);
@@ -3119,9 +3180,12 @@ void av1_remove_compressor(AV1_COMP *cpi) {
   av1_row_mt_mem_dealloc(cpi);
   aom_free(cpi->tile_thr_data);
   aom_free(cpi->workers);
+  aom_worker_group_destroy(cpi->worker_group);
+  aom_task_graph_free(&cpi->task_graph);
 
   if (cpi->num_workers > 1) {
     av1_loop_filter_dealloc(&cpi->lf_row_sync);
+    av1_cdef_dealloc(&cpi->cdef_sync);
     av1_loop_restoration_dealloc(&cpi->lr_row_sync, cpi->num_workers);
   }
 
@@ -3141,6 +3205,7 @@ void av1_remove_compressor(AV1_COMP *cpi) {
   for (i = 0; i < FRAME_BUFFERS; ++i) {
     av1_hash_table_destroy(&cm->buffer_pool->frame_bufs[i].hash_table);
   }
+  aom_free(cpi->hash_source_y);
   if (cpi->sf.use_hash_based_trellis) hbt_destroy();
   av1_free_ref_frame_buffers(cm->buffer_pool);
   aom_free(cpi);
@@ -3934,6 +3999,16 @@ static size_params_type calculate_next_size_params(AV1_COMP *cpi) {
   size_params_type rsz = { oxcf->width, oxcf->height, SCALE_NUMERATOR };
   int resize_denom;
   if (oxcf->pass == 1) return rsz;
+  if (cpi->use_svc) {
+    // Spatial layers are coded at a fixed fraction of the input size.
+    const SVC *const svc = &cpi->svc;
+    const LAYER_CONTEXT *const lc = &svc->layer_context[av1_svc_layer_index(
+        svc, svc->spatial_layer_id, svc->temporal_layer_id)];
+    av1_get_layer_resolution(oxcf->width, oxcf->height, lc->scaling_factor_num,
+                             lc->scaling_factor_den, &rsz.resize_width,
+                             &rsz.resize_height);
+    return rsz;
+  }
   if (cpi->resize_pending_width && cpi->resize_pending_height) {
     rsz.resize_width = cpi->resize_pending_width;
     rsz.resize_height = cpi->resize_pending_height;
@@ -4033,6 +4108,7 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
 #if CONFIG_COLLECT_COMPONENT_TIMING
   start_timing(cpi, loop_filter_time);
 #endif
+  start_stage_timing(cpi, AOM_ENC_STAGE_LOOP_FILTER);
   if (use_loopfilter) {
     aom_clear_system_state();
     av1_pick_filter_level(cpi->source, cpi, cpi->sf.lpf_pick);
@@ -4056,6 +4132,7 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
 #endif
                             0, num_planes, 0);
   }
+  end_stage_timing(cpi, AOM_ENC_STAGE_LOOP_FILTER);
 #if CONFIG_COLLECT_COMPONENT_TIMING
   end_timing(cpi, loop_filter_time);
 #endif
@@ -4067,12 +4144,18 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
 #if CONFIG_COLLECT_COMPONENT_TIMING
     start_timing(cpi, cdef_time);
 #endif
+    start_stage_timing(cpi, AOM_ENC_STAGE_CDEF);
     // Find CDEF parameters
     av1_cdef_search(&cm->cur_frame->buf, cpi->source, cm, xd,
                     cpi->sf.fast_cdef_search);
 
     // Apply the filter
-    av1_cdef_frame(&cm->cur_frame->buf, cm, xd);
+    if (cpi->num_workers > 1)
+      av1_cdef_frame_mt(&cm->cur_frame->buf, cm, xd, cpi->workers,
+                        cpi->num_workers, &cpi->cdef_sync);
+    else
+      av1_cdef_frame(&cm->cur_frame->buf, cm, xd);
+    end_stage_timing(cpi, AOM_ENC_STAGE_CDEF);
 #if CONFIG_COLLECT_COMPONENT_TIMING
     end_timing(cpi, cdef_time);
 #endif
@@ -4088,6 +4171,7 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
 #if CONFIG_COLLECT_COMPONENT_TIMING
   start_timing(cpi, loop_restoration_time);
 #endif
+  start_stage_timing(cpi, AOM_ENC_STAGE_LOOP_RESTORATION);
   if (use_restoration) {
     av1_loop_restoration_save_boundary_lines(&cm->cur_frame->buf, cm, 1);
     av1_pick_filter_restoration(cpi->source, cpi);
@@ -4107,6 +4191,7 @@ static void loopfilter_frame(AV1_COMP *cpi, AV1_COMMON *cm) {
     cm->rst_info[1].frame_restoration_type = RESTORE_NONE;
     cm->rst_info[2].frame_restoration_type = RESTORE_NONE;
   }
+  end_stage_timing(cpi, AOM_ENC_STAGE_LOOP_RESTORATION);
 #if CONFIG_COLLECT_COMPONENT_TIMING
   end_timing(cpi, loop_restoration_time);
 #endif
@@ -4463,7 +4548,9 @@ static int encode_with_recode_loop(AV1_COMP *cpi, size_t *size, uint8_t *dest) {
     start_timing(cpi, av1_encode_frame_time);
 #endif
     // transform / motion compensation build reconstruction frame
+    start_stage_timing(cpi, AOM_ENC_STAGE_MODE_SEARCH);
     av1_encode_frame(cpi);
+    end_stage_timing(cpi, AOM_ENC_STAGE_MODE_SEARCH);
 #if CONFIG_COLLECT_COMPONENT_TIMING
     end_timing(cpi, av1_encode_frame_time);
 #endif
@@ -4478,8 +4565,10 @@ static int encode_with_recode_loop(AV1_COMP *cpi, size_t *size, uint8_t *dest) {
 
       finalize_encoded_frame(cpi);
       int largest_tile_id = 0;  // Output from bitstream: unused here
+      start_stage_timing(cpi, AOM_ENC_STAGE_PACK_BITSTREAM);
       if (av1_pack_bitstream(cpi, dest, size, &largest_tile_id) != AOM_CODEC_OK)
         return AOM_CODEC_ERROR;
+      end_stage_timing(cpi, AOM_ENC_STAGE_PACK_BITSTREAM);
 
       rc->projected_frame_size = (int)(*size) << 3;
       restore_coding_context(cpi);
@@ -4841,8 +4930,10 @@ static int encode_frame_to_data_rate(AV1_COMP *cpi, size_t *size,
     finalize_encoded_frame(cpi);
     // Build the bitstream
     int largest_tile_id = 0;  // Output from bitstream: unused here
+    start_stage_timing(cpi, AOM_ENC_STAGE_PACK_BITSTREAM);
     if (av1_pack_bitstream(cpi, dest, size, &largest_tile_id) != AOM_CODEC_OK)
       return AOM_CODEC_ERROR;
+    end_stage_timing(cpi, AOM_ENC_STAGE_PACK_BITSTREAM);
 
     if (seq_params->frame_id_numbers_present_flag &&
         current_frame->frame_type == KEY_FRAME) {
@@ -5057,8 +5148,10 @@ static int encode_frame_to_data_rate(AV1_COMP *cpi, size_t *size,
 #if CONFIG_COLLECT_COMPONENT_TIMING
   start_timing(cpi, av1_pack_bitstream_final_time);
 #endif
+  start_stage_timing(cpi, AOM_ENC_STAGE_PACK_BITSTREAM);
   if (av1_pack_bitstream(cpi, dest, size, &largest_tile_id) != AOM_CODEC_OK)
     return AOM_CODEC_ERROR;
+  end_stage_timing(cpi, AOM_ENC_STAGE_PACK_BITSTREAM);
 #if CONFIG_COLLECT_COMPONENT_TIMING
   end_timing(cpi, av1_pack_bitstream_final_time);
 #endif
@@ -5285,9 +5378,16 @@ int av1_receive_raw_frame(AV1_COMP *cpi, aom_enc_frame_flags_t frame_flags,
       res = -1;
 #endif  //  CONFIG_DENOISE
 
+  start_stage_timing(cpi, AOM_ENC_STAGE_LOOKAHEAD);
   if (av1_lookahead_push(cpi->lookahead, sd, time_stamp, end_time,
-                         use_highbitdepth, frame_flags))
+                         use_highbitdepth, frame_flags)) {
     res = -1;
+  } else if (av1_lookahead_analysis_enabled(cpi)) {
+    struct lookahead_entry *const entry = av1_lookahead_peek(
+        cpi->lookahead, av1_lookahead_depth(cpi->lookahead) - 1);
+    av1_lookahead_analyze_frame(cpi, sd, &entry->stats);
+  }
+  end_stage_timing(cpi, AOM_ENC_STAGE_LOOKAHEAD);
 #if CONFIG_INTERNAL_STATS
   aom_usec_timer_mark(&timer);
   cpi->time_receive_data += aom_usec_timer_elapsed(&timer);
@@ -5468,6 +5568,8 @@ int av1_get_compressed_data(AV1_COMP *cpi, unsigned int *frame_flags,
     // Returning -1 indicates no frame encoded; more input is required
     return -1;
   }
+  // Motion hints only apply to the frame they were set for.
+  cpi->motion_hints.enabled = 0;
 #if CONFIG_INTERNAL_STATS
   aom_usec_timer_mark(&cmptimer);
   cpi->time_compress_data += aom_usec_timer_elapsed(&cmptimer);
@@ -27,18 +27,23 @@
 #include "av1/common/timing.h"
 #include "av1/common/blockd.h"
 #include "av1/common/enums.h"
+#include "av1/encoder/analysis_cache.h"
 #include "av1/encoder/aq_cyclicrefresh.h"
 #include "av1/encoder/av1_quantize.h"
 #include "av1/encoder/context_tree.h"
+#include "av1/encoder/corner_detect.h"
 #include "av1/encoder/encodemb.h"
 #include "av1/encoder/firstpass.h"
 #include "av1/encoder/level.h"
 #include "av1/encoder/lookahead.h"
+#include "av1/encoder/lookahead_analysis.h"
 #include "av1/encoder/mbgraph.h"
 #include "av1/encoder/mcomp.h"
+#include "av1/encoder/motion_hints.h"
 #include "av1/encoder/ratectrl.h"
 #include "av1/encoder/rd.h"
 #include "av1/encoder/speed_features.h"
+#include "av1/encoder/svc_layercontext.h"
 #include "av1/encoder/tokenize.h"
 #include "av1/encoder/block.h"
 
@@ -50,6 +55,7 @@
 #include "aom_dsp/noise_model.h"
 #endif
 #include "aom/internal/aom_codec_internal.h"
+#include "aom_ports/aom_timer.h"
 #include "aom_util/aom_thread.h"
 
 #ifdef __cplusplus
@@ -60,6 +66,8 @@ typedef struct {
   int nmv_vec_cost[MV_JOINTS];
   int nmv_costs[2][MV_VALS];
   int nmv_costs_hp[2][MV_VALS];
+  nmv_context nmv_cost_cdfs;
+  MvSubpelPrecision nmv_cost_precision;
 
   FRAME_CONTEXT fc;
 } CODING_CONTEXT;
@@ -302,6 +310,8 @@ typedef struct AV1EncoderConfig {
   int gf_max_pyr_height;
 
   int row_mt;
+  // Pin the worker threads to CPUs, see AV1E_SET_THREAD_AFFINITY.
+  int thread_affinity;
   int tile_columns;
   int tile_rows;
   int tile_width_count;
@@ -403,6 +413,19 @@ static INLINE int is_lossless_requested(const AV1EncoderConfig *cfg) {
   return cfg->best_allowed_q == 0 && cfg->worst_allowed_q == 0;
 }
 
+// Whether the border of the reference frames is too small for the
+// predictions of blocks at the frame edge, which then use copies of the
+// reference with emulated edges.
+static INLINE int has_small_border(const AV1EncoderConfig *cfg) {
+  return cfg->border_in_pixels < AOM_ENC_NO_SCALE_BORDER;
+}
+
+// Size in bytes of a reference block with emulated edges. A reference scaled
+// down by 2 spans twice the block size, as in the decoder.
+#define MC_BUF_SIZE                             \
+  ((2 * MAX_SB_SIZE + 2 * AOM_INTERP_EXTEND) * \
+   (2 * MAX_SB_SIZE + 2 * AOM_INTERP_EXTEND) * sizeof(uint16_t))
+
 typedef struct FRAME_COUNTS {
 // Note: This structure should only contain 'unsigned int' fields, or
 // aggregates built solely from 'unsigned int' fields/elements
@@ -544,6 +567,9 @@ typedef struct AV1RowMTSyncData {
 typedef struct AV1RowMTInfo {
   int current_mi_row;
   int num_threads_working;
+  // Node of the workers that take the rows of the tile first, or -1 for any
+  // worker.
+  int node;
 } AV1RowMTInfo;
 
 // TODO(jingning) All spatially adaptive variables should go to TileDataEnc.
@@ -600,6 +626,8 @@ typedef struct ThreadData {
   PALETTE_BUFFER *palette_buffer;
   CONV_BUF_TYPE *tmp_conv_dst;
   uint8_t *tmp_obmc_bufs[2];
+  // Reference blocks with emulated edges, NULL without a small border.
+  uint8_t *mc_buf[2];
   int intrabc_used;
   FRAME_CONTEXT *tctx;
 } ThreadData;
@@ -644,7 +672,6 @@ typedef struct PartitionStats {
 #endif
 
 #if CONFIG_COLLECT_COMPONENT_TIMING
-#include "aom_ports/aom_timer.h"
 // Adjust the following to add new components.
 enum {
   encode_frame_to_data_rate_time,
@@ -746,6 +773,11 @@ typedef struct AV1_COMP {
   int rate_size;
   int rate_index;
   hash_table *previous_hash_table;
+  // Luma plane of the source the last hash table was built from, and that
+  // table. Used to update the table of the next frame rather than rebuild it.
+  uint8_t *hash_source_y;
+  size_t hash_source_size;
+  const hash_table *hash_source_table;
   int previous_index;
 
   unsigned int row_mt;
@@ -835,6 +867,16 @@ typedef struct AV1_COMP {
 
   CYCLIC_REFRESH *cyclic_refresh;
   ActiveMap active_map;
+  MOTION_HINTS motion_hints;
+  LOOKAHEAD_ANALYSIS lookahead_analysis;
+  ANALYSIS_CACHE analysis_cache;
+
+  // Set by AV1E_SET_STAGE_TIMING. The stage times are cleared at the start of
+  // each aom_codec_encode() call.
+  int stage_timing_enabled;
+  aom_enc_stage_timing_t stage_timing;
+  struct aom_usec_timer stage_timer[AOM_ENC_STAGES];
+  int64_t stage_cpu_start_us[AOM_ENC_STAGES];
 
   fractional_mv_step_fp *find_fractional_mv_step;
   av1_diamond_search_fn_t diamond_search_sad;
@@ -935,10 +977,17 @@ typedef struct AV1_COMP {
   // Multi-threading
   int num_workers;
   AVxWorker *workers;
+  // Set when the workers run on the shared thread pool, see
+  // aom_codec_set_shared_thread_pool().
+  AVxWorkerGroup *worker_group;
   struct EncWorkerData *tile_thr_data;
+  // The tile jobs of av1_encode_tiles_mt().
+  AomTaskGraph task_graph;
   int existing_fb_idx_to_show;
   int is_arf_filter_off[MAX_INTERNAL_ARFS + 1];
   int global_motion_search_done;
+  // Scratch memory of the corner detection of the global motion search.
+  CornerDetectBuffer corner_buffer;
   int internal_altref_allowed;
   // A flag to indicate if intrabc is ever used in current frame.
   int intrabc_used;
@@ -959,6 +1008,7 @@ typedef struct AV1_COMP {
   unsigned int coeff_opt_dist_threshold;
 
   AV1LfSync lf_row_sync;
+  AV1CdefSync cdef_sync;
   AV1LrSync lr_row_sync;
   AV1LrStruct lr_ctxt;
 
@@ -997,6 +1047,11 @@ typedef struct AV1_COMP {
   // Count the number of OBU_FRAME and OBU_FRAME_HEADER for level calculation.
   int frame_header_count;
   FrameWindowBuffer frame_window_buffer;
+
+  // Set when the stream is coded with several spatial or temporal layers
+  // through AV1E_SET_SVC_PARAMS.
+  int use_svc;
+  SVC svc;
 } AV1_COMP;
 
 typedef struct {
@@ -1351,6 +1406,21 @@ static INLINE int av1_get_bsize_idx_for_part_stats(BLOCK_SIZE bsize) {
 }
 #endif
 
+static INLINE void start_stage_timing(AV1_COMP *cpi, aom_enc_stage_t stage) {
+  if (!cpi->stage_timing_enabled) return;
+  aom_usec_timer_start(&cpi->stage_timer[stage]);
+  cpi->stage_cpu_start_us[stage] = aom_thread_cpu_time_us();
+}
+
+static INLINE void end_stage_timing(AV1_COMP *cpi, aom_enc_stage_t stage) {
+  if (!cpi->stage_timing_enabled) return;
+  aom_usec_timer_mark(&cpi->stage_timer[stage]);
+  cpi->stage_timing.time_us[stage] +=
+      aom_usec_timer_elapsed(&cpi->stage_timer[stage]);
+  cpi->stage_timing.cpu_time_us[stage] +=
+      aom_thread_cpu_time_us() - cpi->stage_cpu_start_us[stage];
+}
+
 #if CONFIG_COLLECT_COMPONENT_TIMING
 static INLINE void start_timing(AV1_COMP *cpi, int component) {
   aom_usec_timer_start(&cpi->component_timer[component]);
@@ -15,6 +15,7 @@
 #include "av1/encoder/ethread.h"
 #include "av1/encoder/rdopt.h"
 #include "aom_dsp/aom_dsp_common.h"
+#include "aom_util/aom_cpu_topology.h"
 
 static void accumulate_rd_opt(ThreadData *td, ThreadData *td_t) {
   for (int i = 0; i < REFERENCE_MODES; i++)
@@ -194,8 +195,9 @@ void av1_row_mt_sync_mem_dealloc(AV1RowMTSync *row_mt_sync) {
   }
 }
 
-static void assign_tile_to_thread(MultiThreadHandle *multi_thread_ctxt,
-                                  int num_tiles, int num_workers) {
+static void assign_tile_to_thread(AV1_COMP *cpi, int num_tiles,
+                                  int num_workers) {
+  MultiThreadHandle *multi_thread_ctxt = &cpi->multi_thread_ctxt;
   int tile_id = 0;
   int i;
 
@@ -203,6 +205,41 @@ static void assign_tile_to_thread(MultiThreadHandle *multi_thread_ctxt,
     multi_thread_ctxt->thread_id_to_tile_id[i] = tile_id++;
     if (tile_id == num_tiles) tile_id = 0;
   }
+
+  // A pinned worker starts on the tiles of its node, in turn with the other
+  // workers of the node.
+  for (i = 0; i < num_workers; i++) {
+    const int node = cpi->tile_thr_data[i].node;
+    int rank = 0;
+    int num_node_tiles = 0;
+    if (node < 0) continue;
+    for (int j = 0; j < i; j++) rank += cpi->tile_thr_data[j].node == node;
+    for (tile_id = 0; tile_id < num_tiles; tile_id++)
+      num_node_tiles += cpi->tile_data[tile_id].row_mt_info.node == node;
+    if (num_node_tiles == 0) continue;
+    rank %= num_node_tiles;
+    for (tile_id = 0; tile_id < num_tiles; tile_id++) {
+      if (cpi->tile_data[tile_id].row_mt_info.node == node && rank-- == 0)
+        break;
+    }
+    multi_thread_ctxt->thread_id_to_tile_id[i] = tile_id;
+  }
+}
+
+// Splits the tiles into contiguous ranges, one per node in proportion to the
+// pinned workers of the node. The same node then writes the reconstruction
+// and the above context of a tile frame after frame, which keeps the pages
+// that it first touched, or that the kernel moved to it, local.
+static void assign_tiles_to_nodes(AV1_COMP *cpi, int num_tiles,
+                                  int num_workers) {
+  for (int tile_id = 0; tile_id < num_tiles; tile_id++) {
+    int node = -1;
+    // Worker 0 is the main thread, which is not pinned.
+    if (num_workers > 1)
+      node = cpi->tile_thr_data[1 + tile_id * (num_workers - 1) / num_tiles]
+                 .node;
+    cpi->tile_data[tile_id].row_mt_info.node = node;
+  }
 }
 
 static int get_next_job(AV1_COMP *const cpi, int *current_mi_row,
@@ -220,9 +257,9 @@ static int get_next_job(AV1_COMP *const cpi, int *current_mi_row,
   return 0;
 }
 
-static void switch_tile_and_get_next_job(AV1_COMP *const cpi, int *cur_tile_id,
-                                         int *current_mi_row,
-                                         int *end_of_frame) {
+// Returns the tile with jobs left that the fewest threads work on, or -1 if
+// there is none. With 'node' not negative, only the tiles of the node count.
+static int get_least_processed_tile(AV1_COMP *const cpi, int node) {
   AV1_COMMON *const cm = &cpi->common;
   const int tile_cols = cm->tile_cols;
   const int tile_rows = cm->tile_rows;
@@ -236,6 +273,7 @@ static void switch_tile_and_get_next_job(AV1_COMP *const cpi, int *cur_tile_id,
       int tile_index = tile_row * tile_cols + tile_col;
       TileDataEnc *this_tile = &cpi->tile_data[tile_index];
       AV1RowMTInfo *row_mt_info = &this_tile->row_mt_info;
+      if (node >= 0 && row_mt_info->node != node) continue;
       int num_sb_rows_in_tile =
           av1_get_sb_rows_in_tile(cm, this_tile->tile_info);
       int num_sb_cols_in_tile =
@@ -268,6 +306,16 @@ static void switch_tile_and_get_next_job(AV1_COMP *const cpi, int *cur_tile_id,
       }
     }
   }
+  return tile_id;
+}
+
+static void switch_tile_and_get_next_job(AV1_COMP *const cpi, int node,
+                                         int *cur_tile_id, int *current_mi_row,
+                                         int *end_of_frame) {
+  // A pinned worker takes the jobs of the tiles of its node first.
+  int tile_id = node >= 0 ? get_least_processed_tile(cpi, node) : -1;
+  if (tile_id == -1) tile_id = get_least_processed_tile(cpi, -1);
+
   if (tile_id == -1) {
     *end_of_frame = 1;
   } else {
@@ -299,8 +347,8 @@ static int enc_row_mt_worker_hook(void *arg1, void *unused) {
     if (!get_next_job(cpi, &current_mi_row, cur_tile_id)) {
       // No jobs are available for the current tile. Query for the status of
       // other tiles and get the next job if available
-      switch_tile_and_get_next_job(cpi, &cur_tile_id, &current_mi_row,
-                                   &end_of_frame);
+      switch_tile_and_get_next_job(cpi, thread_data->node, &cur_tile_id,
+                                   &current_mi_row, &end_of_frame);
     }
 #if CONFIG_MULTITHREAD
     pthread_mutex_unlock(cpi->row_mt_mutex_);
@@ -349,28 +397,16 @@ static int enc_row_mt_worker_hook(void *arg1, void *unused) {
   return 1;
 }
 
-static int enc_worker_hook(void *arg1, void *unused) {
-  EncWorkerData *const thread_data = (EncWorkerData *)arg1;
-  AV1_COMP *const cpi = thread_data->cpi;
-  const AV1_COMMON *const cm = &cpi->common;
-  const int tile_cols = cm->tile_cols;
-  const int tile_rows = cm->tile_rows;
-  int t;
-
-  (void)unused;
-
-  for (t = thread_data->start; t < tile_rows * tile_cols;
-       t += cpi->num_workers) {
-    int tile_row = t / tile_cols;
-    int tile_col = t % tile_cols;
-
-    TileDataEnc *const this_tile =
-        &cpi->tile_data[tile_row * cm->tile_cols + tile_col];
-    thread_data->td->mb.e_mbd.tile_ctx = &this_tile->tctx;
-    thread_data->td->mb.tile_pb_ctx = &this_tile->tctx;
-    av1_encode_tile(cpi, thread_data->td, tile_row, tile_col);
-  }
+// Encodes the tile of 'arg1'.
+static int enc_tile_task_hook(void *arg1, void *arg2, int thread_id) {
+  TileDataEnc *const this_tile = (TileDataEnc *)arg1;
+  AV1_COMP *const cpi = (AV1_COMP *)arg2;
+  ThreadData *const td = cpi->tile_thr_data[thread_id].td;
 
+  td->mb.e_mbd.tile_ctx = &this_tile->tctx;
+  td->mb.tile_pb_ctx = &this_tile->tctx;
+  av1_encode_tile(cpi, td, this_tile->tile_info.tile_row,
+                  this_tile->tile_info.tile_col);
   return 1;
 }
 
@@ -394,6 +430,20 @@ static void create_enc_workers(AV1_COMP *cpi, int num_workers) {
   }
 #endif
 
+  // The main thread works too, so the instance keeps its level of parallelism
+  // on the shared pool.
+  cpi->worker_group = aom_worker_group_create(num_workers - 1);
+
+  // The threads of the pool are not pinned. The other threads take the CPUs
+  // next to the one of the main thread, one each, so they fill the node of
+  // the main thread first and then the other nodes.
+  AomCpuTopology topology;
+  int cpu_order[AOM_MAX_CPUS];
+  const int pin_workers = cpi->oxcf.thread_affinity &&
+                          cpi->worker_group == NULL &&
+                          aom_get_cpu_topology(&topology);
+  if (pin_workers) aom_get_cpu_order(&topology, cpu_order);
+
   for (int i = num_workers - 1; i >= 0; i--) {
     AVxWorker *const worker = &cpi->workers[i];
     EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
@@ -404,6 +454,12 @@ static void create_enc_workers(AV1_COMP *cpi, int num_workers) {
 
     thread_data->cpi = cpi;
     thread_data->thread_id = i;
+    thread_data->node = -1;
+    if (pin_workers && i > 0) {
+      const int cpu_index = cpu_order[i % topology.num_cpus];
+      worker->cpu = topology.cpu[cpu_index];
+      thread_data->node = topology.node[cpu_index];
+    }
 
     if (i > 0) {
       // Allocate thread data.
@@ -463,9 +519,14 @@ static void create_enc_workers(AV1_COMP *cpi, int num_workers) {
             cm, thread_data->td->tmp_obmc_bufs[j],
             aom_memalign(32, 2 * MAX_MB_PLANE * MAX_SB_SQUARE *
                                  sizeof(*thread_data->td->tmp_obmc_bufs[j])));
+        if (has_small_border(&cpi->oxcf)) {
+          CHECK_MEM_ERROR(cm, thread_data->td->mc_buf[j],
+                          aom_memalign(32, MC_BUF_SIZE));
+        }
       }
 
       // Create threads
+      worker->group = cpi->worker_group;
       if (!winterface->reset(worker))
         aom_internal_error(&cm->error, AOM_CODEC_ERROR,
                            "Tile encoder thread creation failed");
@@ -515,8 +576,7 @@ static void sync_enc_workers(AV1_COMP *cpi, int num_workers) {
 
 static void accumulate_counters_enc_workers(AV1_COMP *cpi, int num_workers) {
   for (int i = num_workers - 1; i >= 0; i--) {
-    AVxWorker *const worker = &cpi->workers[i];
-    EncWorkerData *const thread_data = (EncWorkerData *)worker->data1;
+    EncWorkerData *const thread_data = &cpi->tile_thr_data[i];
     cpi->intrabc_used |= thread_data->td->intrabc_used;
     // Accumulate counters.
     if (i > 0) {
@@ -579,6 +639,7 @@ static void prepare_enc_workers(AV1_COMP *cpi, AVxWorkerHook hook,
       for (int j = 0; j < 2; ++j) {
         thread_data->td->mb.e_mbd.tmp_obmc_bufs[j] =
             thread_data->td->mb.tmp_obmc_bufs[j];
+        thread_data->td->mb.e_mbd.mc_buf[j] = thread_data->td->mc_buf[j];
       }
     }
   }
@@ -600,9 +661,21 @@ void av1_encode_tiles_mt(AV1_COMP *cpi) {
   } else {
     num_workers = AOMMIN(num_workers, cpi->num_workers);
   }
-  prepare_enc_workers(cpi, enc_worker_hook, num_workers);
-  launch_enc_workers(cpi, num_workers);
-  sync_enc_workers(cpi, num_workers);
+  prepare_enc_workers(cpi, NULL, num_workers);
+
+  // The tiles go to the workers as they become free, in raster order.
+  if (!aom_task_graph_alloc(&cpi->task_graph, tile_cols * tile_rows, 0,
+                            num_workers)) {
+    aom_internal_error(&cm->error, AOM_CODEC_MEM_ERROR,
+                       "Failed to allocate cpi->task_graph");
+  }
+  for (int i = 0; i < tile_cols * tile_rows; ++i) {
+    aom_task_graph_add(&cpi->task_graph, enc_tile_task_hook,
+                       &cpi->tile_data[i], cpi);
+  }
+  if (!aom_task_graph_run(&cpi->task_graph, cpi->workers, num_workers, 0))
+    aom_internal_error(&cm->error, AOM_CODEC_ERROR,
+                       "Failed to encode tile data");
   accumulate_counters_enc_workers(cpi, num_workers);
 }
 
@@ -689,7 +762,8 @@ void av1_encode_tiles_row_mt(AV1_COMP *cpi) {
   } else {
     num_workers = AOMMIN(num_workers, cpi->num_workers);
   }
-  assign_tile_to_thread(multi_thread_ctxt, tile_cols * tile_rows, num_workers);
+  assign_tiles_to_nodes(cpi, tile_cols * tile_rows, num_workers);
+  assign_tile_to_thread(cpi, tile_cols * tile_rows, num_workers);
   prepare_enc_workers(cpi, enc_row_mt_worker_hook, num_workers);
   launch_enc_workers(cpi, num_workers);
   sync_enc_workers(cpi, num_workers);
@@ -25,6 +25,8 @@ typedef struct EncWorkerData {
   struct ThreadData *td;
   int start;
   int thread_id;
+  // Index of the NUMA node of the CPU the worker is pinned to, or -1.
+  int node;
 } EncWorkerData;
 
 void av1_row_mt_sync_read(AV1RowMTSync *const row_mt_sync, int r, int c);
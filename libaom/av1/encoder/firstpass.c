@@ -316,6 +316,95 @@ static double raw_motion_error_stdev(int *raw_motion_err_list,
   return raw_err_stdev;
 }
 
+// Updates the first pass references once the stats of the frame are out.
+static void end_first_pass_frame(AV1_COMP *cpi) {
+  AV1_COMMON *const cm = &cpi->common;
+  CurrentFrame *const current_frame = &cm->current_frame;
+  TWO_PASS *const twopass = &cpi->twopass;
+  const YV12_BUFFER_CONFIG *const lst_yv12 =
+      get_ref_frame_yv12_buf(cm, LAST_FRAME);
+  const YV12_BUFFER_CONFIG *const gld_yv12 =
+      get_ref_frame_yv12_buf(cm, GOLDEN_FRAME);
+  YV12_BUFFER_CONFIG *const new_yv12 = &cm->cur_frame->buf;
+  const int num_planes = av1_num_planes(cm);
+
+  // Copy the previous Last Frame back into gf and and arf buffers if
+  // the prediction is good enough... but also don't allow it to lag too far.
+  if ((twopass->sr_update_lag > 3) ||
+      ((current_frame->frame_number > 0) &&
+       (twopass->this_frame_stats.pcnt_inter > 0.20) &&
+       ((twopass->this_frame_stats.intra_error /
+         DOUBLE_DIVIDE_CHECK(twopass->this_frame_stats.coded_error)) > 2.0))) {
+    if (gld_yv12 != NULL) {
+      assign_frame_buffer_p(
+          &cm->ref_frame_map[get_ref_frame_map_idx(cm, GOLDEN_FRAME)],
+          cm->ref_frame_map[get_ref_frame_map_idx(cm, LAST_FRAME)]);
+    }
+    twopass->sr_update_lag = 1;
+  } else {
+    ++twopass->sr_update_lag;
+  }
+
+  aom_extend_frame_borders(new_yv12, num_planes);
+
+  // The frame we just compressed now becomes the last frame.
+  assign_frame_buffer_p(
+      &cm->ref_frame_map[get_ref_frame_map_idx(cm, LAST_FRAME)], cm->cur_frame);
+
+  // Special case for the first frame. Copy into the GF buffer as a second
+  // reference.
+  if (current_frame->frame_number == 0 &&
+      get_ref_frame_map_idx(cm, GOLDEN_FRAME) != INVALID_IDX) {
+    assign_frame_buffer_p(
+        &cm->ref_frame_map[get_ref_frame_map_idx(cm, GOLDEN_FRAME)],
+        cm->ref_frame_map[get_ref_frame_map_idx(cm, LAST_FRAME)]);
+  }
+
+  // Use this to see what the first pass reconstruction looks like.
+  if (0) {
+    char filename[512];
+    FILE *recon_file;
+    snprintf(filename, sizeof(filename), "enc%04d.yuv",
+             (int)current_frame->frame_number);
+
+    if (current_frame->frame_number == 0)
+      recon_file = fopen(filename, "wb");
+    else
+      recon_file = fopen(filename, "ab");
+
+    (void)fwrite(lst_yv12->buffer_alloc, lst_yv12->frame_size, 1, recon_file);
+    fclose(recon_file);
+  }
+
+  ++current_frame->frame_number;
+}
+
+// Uses the first pass stats of the frame found in the analysis cache. The
+// source stands in for the reconstruction as the reference of the next frame.
+static void use_cached_first_pass(AV1_COMP *cpi, FIRSTPASS_STATS *stats,
+                                  const int64_t ts_duration) {
+  AV1_COMMON *const cm = &cpi->common;
+  TWO_PASS *const twopass = &cpi->twopass;
+  YV12_BUFFER_CONFIG *const new_yv12 = &cm->cur_frame->buf;
+
+  av1_setup_frame_size(cpi);
+  cpi->rc.frames_to_key = INT_MAX;
+  if (new_yv12->y_crop_width == cpi->source->y_crop_width &&
+      new_yv12->y_crop_height == cpi->source->y_crop_height &&
+      (new_yv12->flags & YV12_FLAG_HIGHBITDEPTH) ==
+          (cpi->source->flags & YV12_FLAG_HIGHBITDEPTH)) {
+    aom_yv12_copy_frame(cpi->source, new_yv12, av1_num_planes(cm));
+  }
+
+  stats->frame = cm->current_frame.frame_number;
+  stats->duration = (double)ts_duration;
+  twopass->this_frame_stats = *stats;
+  output_stats(&twopass->this_frame_stats, cpi->output_pkt_list);
+  accumulate_stats(&twopass->total_stats, stats);
+
+  end_first_pass_frame(cpi);
+}
+
 #define UL_INTRA_THRESH 50
 #define INVALID_ROW -1
 void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
@@ -365,6 +454,13 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
   const int qindex = find_fp_qindex(seq_params->bit_depth);
   const int mb_scale = mi_size_wide[BLOCK_16X16];
 
+  FIRSTPASS_STATS cached_stats;
+  if (av1_analysis_cache_load_first_pass(cpi, &cached_stats)) {
+    use_cached_first_pass(cpi, &cached_stats, ts_duration);
+    return;
+  }
+  start_stage_timing(cpi, AOM_ENC_STAGE_FIRST_PASS);
+
   int *raw_motion_err_list;
   int raw_motion_err_counts = 0;
   CHECK_MEM_ERROR(
@@ -806,55 +902,10 @@ void av1_first_pass(AV1_COMP *cpi, const int64_t ts_duration) {
     twopass->this_frame_stats = fps;
     output_stats(&twopass->this_frame_stats, cpi->output_pkt_list);
     accumulate_stats(&twopass->total_stats, &fps);
+    av1_analysis_cache_store_first_pass(cpi, &fps);
   }
 
-  // Copy the previous Last Frame back into gf and and arf buffers if
-  // the prediction is good enough... but also don't allow it to lag too far.
-  if ((twopass->sr_update_lag > 3) ||
-      ((current_frame->frame_number > 0) &&
-       (twopass->this_frame_stats.pcnt_inter > 0.20) &&
-       ((twopass->this_frame_stats.intra_error /
-         DOUBLE_DIVIDE_CHECK(twopass->this_frame_stats.coded_error)) > 2.0))) {
-    if (gld_yv12 != NULL) {
-      assign_frame_buffer_p(
-          &cm->ref_frame_map[get_ref_frame_map_idx(cm, GOLDEN_FRAME)],
-          cm->ref_frame_map[get_ref_frame_map_idx(cm, LAST_FRAME)]);
-    }
-    twopass->sr_update_lag = 1;
-  } else {
-    ++twopass->sr_update_lag;
-  }
-
-  aom_extend_frame_borders(new_yv12, num_planes);
+  end_stage_timing(cpi, AOM_ENC_STAGE_FIRST_PASS);
 
-  // The frame we just compressed now becomes the last frame.
-  assign_frame_buffer_p(
-      &cm->ref_frame_map[get_ref_frame_map_idx(cm, LAST_FRAME)], cm->cur_frame);
-
-  // Special case for the first frame. Copy into the GF buffer as a second
-  // reference.
-  if (current_frame->frame_number == 0 &&
-      get_ref_frame_map_idx(cm, GOLDEN_FRAME) != INVALID_IDX) {
-    assign_frame_buffer_p(
-        &cm->ref_frame_map[get_ref_frame_map_idx(cm, GOLDEN_FRAME)],
-        cm->ref_frame_map[get_ref_frame_map_idx(cm, LAST_FRAME)]);
-  }
-
-  // Use this to see what the first pass reconstruction looks like.
-  if (0) {
-    char filename[512];
-    FILE *recon_file;
-    snprintf(filename, sizeof(filename), "enc%04d.yuv",
-             (int)current_frame->frame_number);
-
-    if (current_frame->frame_number == 0)
-      recon_file = fopen(filename, "wb");
-    else
-      recon_file = fopen(filename, "ab");
-
-    (void)fwrite(lst_yv12->buffer_alloc, lst_yv12->frame_size, 1, recon_file);
-    fclose(recon_file);
-  }
-
-  ++current_frame->frame_number;
+  end_first_pass_frame(cpi);
 }
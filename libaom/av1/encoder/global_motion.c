@@ -278,7 +278,7 @@ static unsigned char *downconvert_frame(YV12_BUFFER_CONFIG *frm,
 static int compute_global_motion_feature_based(
     TransformationType type, YV12_BUFFER_CONFIG *frm, YV12_BUFFER_CONFIG *ref,
     int bit_depth, int *num_inliers_by_motion, double *params_by_motion,
-    int num_motions) {
+    int num_motions, CornerDetectBuffer *corner_buffer) {
   int i;
   int num_frm_corners, num_ref_corners;
   int num_correspondences;
@@ -299,9 +299,11 @@ static int compute_global_motion_feature_based(
 
   // compute interest points in images using FAST features
   num_frm_corners = fast_corner_detect(frm_buffer, frm->y_width, frm->y_height,
-                                       frm->y_stride, frm_corners, MAX_CORNERS);
+                                       frm->y_stride, frm_corners, MAX_CORNERS,
+                                       corner_buffer);
   num_ref_corners = fast_corner_detect(ref_buffer, ref->y_width, ref->y_height,
-                                       ref->y_stride, ref_corners, MAX_CORNERS);
+                                       ref->y_stride, ref_corners, MAX_CORNERS,
+                                       corner_buffer);
 
   // find correspondences between the two images
   correspondences =
@@ -779,7 +781,7 @@ static void compute_flow_field(ImagePyramid *frm_pyr, ImagePyramid *ref_pyr,
 static int compute_global_motion_disflow_based(
     TransformationType type, YV12_BUFFER_CONFIG *frm, YV12_BUFFER_CONFIG *ref,
     int bit_depth, int *num_inliers_by_motion, double *params_by_motion,
-    int num_motions) {
+    int num_motions, CornerDetectBuffer *corner_buffer) {
   unsigned char *frm_buffer = frm->y_buffer;
   unsigned char *ref_buffer = ref->y_buffer;
   const int frm_width = frm->y_width;
@@ -842,7 +844,8 @@ static int compute_global_motion_disflow_based(
 
   // compute interest points in images using FAST features
   num_frm_corners = fast_corner_detect(frm_buffer, frm_width, frm_height,
-                                       frm->y_stride, frm_corners, MAX_CORNERS);
+                                       frm->y_stride, frm_corners, MAX_CORNERS,
+                                       corner_buffer);
   // find correspondences between the two images using the flow field
   correspondences = aom_malloc(num_frm_corners * 4 * sizeof(*correspondences));
   num_correspondences = determine_disflow_correspondence(
@@ -874,16 +877,17 @@ int av1_compute_global_motion(TransformationType type, YV12_BUFFER_CONFIG *frm,
                               YV12_BUFFER_CONFIG *ref, int bit_depth,
                               GlobalMotionEstimationType gm_estimation_type,
                               int *num_inliers_by_motion,
-                              double *params_by_motion, int num_motions) {
+                              double *params_by_motion, int num_motions,
+                              CornerDetectBuffer *corner_buffer) {
   switch (gm_estimation_type) {
     case GLOBAL_MOTION_FEATURE_BASED:
-      return compute_global_motion_feature_based(type, frm, ref, bit_depth,
-                                                 num_inliers_by_motion,
-                                                 params_by_motion, num_motions);
+      return compute_global_motion_feature_based(
+          type, frm, ref, bit_depth, num_inliers_by_motion, params_by_motion,
+          num_motions, corner_buffer);
     case GLOBAL_MOTION_DISFLOW_BASED:
-      return compute_global_motion_disflow_based(type, frm, ref, bit_depth,
-                                                 num_inliers_by_motion,
-                                                 params_by_motion, num_motions);
+      return compute_global_motion_disflow_based(
+          type, frm, ref, bit_depth, num_inliers_by_motion, params_by_motion,
+          num_motions, corner_buffer);
     default: assert(0 && "Unknown global motion estimation type");
   }
   return 0;
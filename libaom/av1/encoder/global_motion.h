@@ -15,6 +15,7 @@
 #include "aom/aom_integer.h"
 #include "aom_scale/yv12config.h"
 #include "av1/common/mv.h"
+#include "av1/encoder/corner_detect.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -63,7 +64,8 @@ int av1_compute_global_motion(TransformationType type, YV12_BUFFER_CONFIG *frm,
                               YV12_BUFFER_CONFIG *ref, int bit_depth,
                               GlobalMotionEstimationType gm_estimation_type,
                               int *num_inliers_by_motion,
-                              double *params_by_motion, int num_motions);
+                              double *params_by_motion, int num_motions,
+                              CornerDetectBuffer *corner_buffer);
 #ifdef __cplusplus
 }  // extern "C"
 #endif
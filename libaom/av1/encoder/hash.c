@@ -11,25 +11,6 @@
 
 #include "av1/encoder/hash.h"
 
-static void crc_calculator_process_data(CRC_CALCULATOR *p_crc_calculator,
-                                        uint8_t *pData, uint32_t dataLength) {
-  for (uint32_t i = 0; i < dataLength; i++) {
-    const uint8_t index =
-        (p_crc_calculator->remainder >> (p_crc_calculator->bits - 8)) ^
-        pData[i];
-    p_crc_calculator->remainder <<= 8;
-    p_crc_calculator->remainder ^= p_crc_calculator->table[index];
-  }
-}
-
-static void crc_calculator_reset(CRC_CALCULATOR *p_crc_calculator) {
-  p_crc_calculator->remainder = 0;
-}
-
-static uint32_t crc_calculator_get_crc(CRC_CALCULATOR *p_crc_calculator) {
-  return p_crc_calculator->remainder & p_crc_calculator->final_result_mask;
-}
-
 static void crc_calculator_init_table(CRC_CALCULATOR *p_crc_calculator) {
   const uint32_t high_bit = 1 << (p_crc_calculator->bits - 1);
   const uint32_t byte_high_bit = 1 << (8 - 1);
@@ -54,7 +35,6 @@ static void crc_calculator_init_table(CRC_CALCULATOR *p_crc_calculator) {
 
 void av1_crc_calculator_init(CRC_CALCULATOR *p_crc_calculator, uint32_t bits,
                              uint32_t truncPoly) {
-  p_crc_calculator->remainder = 0;
   p_crc_calculator->bits = bits;
   p_crc_calculator->trunc_poly = truncPoly;
   p_crc_calculator->final_result_mask = (1 << bits) - 1;
@@ -62,10 +42,15 @@ void av1_crc_calculator_init(CRC_CALCULATOR *p_crc_calculator, uint32_t bits,
 }
 
 uint32_t av1_get_crc_value(void *crc_calculator, uint8_t *p, int length) {
-  CRC_CALCULATOR *p_crc_calculator = (CRC_CALCULATOR *)crc_calculator;
-  crc_calculator_reset(p_crc_calculator);
-  crc_calculator_process_data(p_crc_calculator, p, length);
-  return crc_calculator_get_crc(p_crc_calculator);
+  const CRC_CALCULATOR *p_crc_calculator = (CRC_CALCULATOR *)crc_calculator;
+  // The remainder is kept local so that a calculator can be shared by threads.
+  uint32_t remainder = 0;
+  for (int i = 0; i < length; i++) {
+    const uint8_t index = (remainder >> (p_crc_calculator->bits - 8)) ^ p[i];
+    remainder <<= 8;
+    remainder ^= p_crc_calculator->table[index];
+  }
+  return remainder & p_crc_calculator->final_result_mask;
 }
 
 /* CRC-32C (iSCSI) polynomial in reversed bit order. */
@@ -21,7 +21,6 @@ extern "C" {
 #endif
 
 typedef struct _crc_calculator {
-  uint32_t remainder;
   uint32_t trunc_poly;
   uint32_t bits;
   uint32_t table[256];
@@ -29,7 +28,7 @@ typedef struct _crc_calculator {
 } CRC_CALCULATOR;
 
 // Initialize the crc calculator. It must be executed at least once before
-// calling av1_get_crc_value().
+// calling av1_get_crc_value(), which does not modify the calculator.
 void av1_crc_calculator_init(CRC_CALCULATOR *p_crc_calculator, uint32_t bits,
                              uint32_t truncPoly);
 uint32_t av1_get_crc_value(void *crc_calculator, uint8_t *p, int length);
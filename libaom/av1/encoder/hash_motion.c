@@ -10,9 +10,11 @@
  */
 
 #include <assert.h>
+#include <string.h>
 
 #include "config/av1_rtcd.h"
 
+#include "aom_mem/aom_mem.h"
 #include "av1/encoder/block.h"
 #include "av1/encoder/hash.h"
 #include "av1/encoder/hash_motion.h"
@@ -20,20 +22,6 @@
 static const int crc_bits = 16;
 static const int block_size_bits = 3;
 
-static void hash_table_clear_all(hash_table *p_hash_table) {
-  if (p_hash_table->p_lookup_table == NULL) {
-    return;
-  }
-  int max_addr = 1 << (crc_bits + block_size_bits);
-  for (int i = 0; i < max_addr; i++) {
-    if (p_hash_table->p_lookup_table[i] != NULL) {
-      aom_vector_destroy(p_hash_table->p_lookup_table[i]);
-      aom_free(p_hash_table->p_lookup_table[i]);
-      p_hash_table->p_lookup_table[i] = NULL;
-    }
-  }
-}
-
 // TODO(youzhou@microsoft.com): is higher than 8 bits screen content supported?
 // If yes, fix this function
 static void get_pixels_in_1D_char_array_by_block_2x2(uint8_t *y_src, int stride,
@@ -106,92 +94,76 @@ static int hash_block_size_to_index(int block_size) {
 
 void av1_hash_table_init(hash_table *p_hash_table, MACROBLOCK *x) {
   if (x->g_crc_initialized == 0) {
-    av1_crc_calculator_init(&x->crc_calculator1, 24, 0x5D6DCB);
+    av1_crc32c_calculator_init(&x->crc_calculator1);
     av1_crc_calculator_init(&x->crc_calculator2, 24, 0x864CFB);
     x->g_crc_initialized = 1;
   }
-  p_hash_table->p_lookup_table = NULL;
+  memset(p_hash_table, 0, sizeof(*p_hash_table));
 }
 
 void av1_hash_table_destroy(hash_table *p_hash_table) {
-  hash_table_clear_all(p_hash_table);
-  aom_free(p_hash_table->p_lookup_table);
-  p_hash_table->p_lookup_table = NULL;
-}
-
-void av1_hash_table_create(hash_table *p_hash_table) {
-  if (p_hash_table->p_lookup_table != NULL) {
-    hash_table_clear_all(p_hash_table);
-    return;
-  }
-  const int max_addr = 1 << (crc_bits + block_size_bits);
-  p_hash_table->p_lookup_table =
-      (Vector **)aom_malloc(sizeof(p_hash_table->p_lookup_table[0]) * max_addr);
-  memset(p_hash_table->p_lookup_table, 0,
-         sizeof(p_hash_table->p_lookup_table[0]) * max_addr);
-}
-
-static void hash_table_add_to_table(hash_table *p_hash_table,
-                                    uint32_t hash_value,
-                                    block_hash *curr_block_hash) {
-  if (p_hash_table->p_lookup_table[hash_value] == NULL) {
-    p_hash_table->p_lookup_table[hash_value] =
-        aom_malloc(sizeof(p_hash_table->p_lookup_table[0][0]));
-    aom_vector_setup(p_hash_table->p_lookup_table[hash_value], 10,
-                     sizeof(curr_block_hash[0]));
-    aom_vector_push_back(p_hash_table->p_lookup_table[hash_value],
-                         curr_block_hash);
-  } else {
-    aom_vector_push_back(p_hash_table->p_lookup_table[hash_value],
-                         curr_block_hash);
-  }
+  aom_free(p_hash_table->p_entries);
+  aom_free(p_hash_table->p_bucket_start);
+  memset(p_hash_table, 0, sizeof(*p_hash_table));
 }
 
 int32_t av1_hash_table_count(const hash_table *p_hash_table,
                              uint32_t hash_value) {
-  if (p_hash_table->p_lookup_table[hash_value] == NULL) {
+  if (p_hash_table->p_bucket_start == NULL) {
     return 0;
-  } else {
-    return (int32_t)(p_hash_table->p_lookup_table[hash_value]->size);
   }
+  return (int32_t)(p_hash_table->p_bucket_start[hash_value + 1] -
+                   p_hash_table->p_bucket_start[hash_value]);
 }
 
-Iterator av1_hash_get_first_iterator(hash_table *p_hash_table,
-                                     uint32_t hash_value) {
+const block_hash *av1_hash_get_first_block(const hash_table *p_hash_table,
+                                           uint32_t hash_value) {
   assert(av1_hash_table_count(p_hash_table, hash_value) > 0);
-  return aom_vector_begin(p_hash_table->p_lookup_table[hash_value]);
+  return &p_hash_table->p_entries[p_hash_table->p_bucket_start[hash_value]];
 }
 
-int32_t av1_has_exact_match(hash_table *p_hash_table, uint32_t hash_value1,
-                            uint32_t hash_value2) {
-  if (p_hash_table->p_lookup_table[hash_value1] == NULL) {
+int32_t av1_has_exact_match(const hash_table *p_hash_table,
+                            uint32_t hash_value1, uint32_t hash_value2) {
+  const int32_t count = av1_hash_table_count(p_hash_table, hash_value1);
+  if (count == 0) {
     return 0;
   }
-  Iterator iterator =
-      aom_vector_begin(p_hash_table->p_lookup_table[hash_value1]);
-  Iterator last = aom_vector_end(p_hash_table->p_lookup_table[hash_value1]);
-  for (; !iterator_equals(&iterator, &last); iterator_increment(&iterator)) {
-    if ((*(block_hash *)iterator_get(&iterator)).hash_value2 == hash_value2) {
+  const block_hash *block = av1_hash_get_first_block(p_hash_table, hash_value1);
+  for (int32_t i = 0; i < count; i++) {
+    if (block[i].hash_value2 == hash_value2) {
       return 1;
     }
   }
   return 0;
 }
 
-void av1_generate_block_2x2_hash_value(const YV12_BUFFER_CONFIG *picture,
-                                       uint32_t *pic_block_hash[2],
-                                       int8_t *pic_block_same_info[3],
-                                       MACROBLOCK *x) {
-  const int width = 2;
-  const int height = 2;
-  const int x_end = picture->y_crop_width - width + 1;
-  const int y_end = picture->y_crop_height - height + 1;
+// The hash values of the blocks of size block_size whose top row is in
+// [row_start, row_end), computed from the ones of the blocks of half that
+// size, or from the pixels when block_size is 2.
+typedef struct {
+  const YV12_BUFFER_CONFIG *picture;
+  int block_size;
+  uint32_t **src_pic_block_hash;
+  uint32_t **dst_pic_block_hash;
+  int8_t **src_pic_block_same_info;
+  int8_t **dst_pic_block_same_info;
+  int row_start;
+  int row_end;
+  MACROBLOCK *x;
+} HashRowsJob;
+
+static void generate_block_2x2_hash_value(const HashRowsJob *job) {
+  const YV12_BUFFER_CONFIG *picture = job->picture;
+  uint32_t **pic_block_hash = job->dst_pic_block_hash;
+  int8_t **pic_block_same_info = job->dst_pic_block_same_info;
+  MACROBLOCK *x = job->x;
+  const int pic_width = picture->y_crop_width;
+  const int x_end = pic_width - 2 + 1;
 
-  const int length = width * 2;
   if (picture->flags & YV12_FLAG_HIGHBITDEPTH) {
     uint16_t p[4];
-    int pos = 0;
-    for (int y_pos = 0; y_pos < y_end; y_pos++) {
+    for (int y_pos = job->row_start; y_pos < job->row_end; y_pos++) {
+      int pos = y_pos * pic_width;
       for (int x_pos = 0; x_pos < x_end; x_pos++) {
         get_pixels_in_1D_short_array_by_block_2x2(
             CONVERT_TO_SHORTPTR(picture->y_buffer) + y_pos * picture->y_stride +
@@ -200,18 +172,17 @@ void av1_generate_block_2x2_hash_value(const YV12_BUFFER_CONFIG *picture,
         pic_block_same_info[0][pos] = is_block16_2x2_row_same_value(p);
         pic_block_same_info[1][pos] = is_block16_2x2_col_same_value(p);
 
-        pic_block_hash[0][pos] = av1_get_crc_value(
-            &x->crc_calculator1, (uint8_t *)p, length * sizeof(p[0]));
-        pic_block_hash[1][pos] = av1_get_crc_value(
-            &x->crc_calculator2, (uint8_t *)p, length * sizeof(p[0]));
+        pic_block_hash[0][pos] =
+            av1_get_crc32c_value(&x->crc_calculator1, (uint8_t *)p, sizeof(p));
+        pic_block_hash[1][pos] =
+            av1_get_crc_value(&x->crc_calculator2, (uint8_t *)p, sizeof(p));
         pos++;
       }
-      pos += width - 1;
     }
   } else {
     uint8_t p[4];
-    int pos = 0;
-    for (int y_pos = 0; y_pos < y_end; y_pos++) {
+    for (int y_pos = job->row_start; y_pos < job->row_end; y_pos++) {
+      int pos = y_pos * pic_width;
       for (int x_pos = 0; x_pos < x_end; x_pos++) {
         get_pixels_in_1D_char_array_by_block_2x2(
             picture->y_buffer + y_pos * picture->y_stride + x_pos,
@@ -220,42 +191,41 @@ void av1_generate_block_2x2_hash_value(const YV12_BUFFER_CONFIG *picture,
         pic_block_same_info[1][pos] = is_block_2x2_col_same_value(p);
 
         pic_block_hash[0][pos] =
-            av1_get_crc_value(&x->crc_calculator1, p, length * sizeof(p[0]));
+            av1_get_crc32c_value(&x->crc_calculator1, p, sizeof(p));
         pic_block_hash[1][pos] =
-            av1_get_crc_value(&x->crc_calculator2, p, length * sizeof(p[0]));
+            av1_get_crc_value(&x->crc_calculator2, p, sizeof(p));
         pos++;
       }
-      pos += width - 1;
     }
   }
 }
 
-void av1_generate_block_hash_value(const YV12_BUFFER_CONFIG *picture,
-                                   int block_size,
-                                   uint32_t *src_pic_block_hash[2],
-                                   uint32_t *dst_pic_block_hash[2],
-                                   int8_t *src_pic_block_same_info[3],
-                                   int8_t *dst_pic_block_same_info[3],
-                                   MACROBLOCK *x) {
-  const int pic_width = picture->y_crop_width;
-  const int x_end = picture->y_crop_width - block_size + 1;
-  const int y_end = picture->y_crop_height - block_size + 1;
+static void generate_block_hash_value(const HashRowsJob *job) {
+  const int block_size = job->block_size;
+  uint32_t **src_pic_block_hash = job->src_pic_block_hash;
+  uint32_t **dst_pic_block_hash = job->dst_pic_block_hash;
+  int8_t **src_pic_block_same_info = job->src_pic_block_same_info;
+  int8_t **dst_pic_block_same_info = job->dst_pic_block_same_info;
+  MACROBLOCK *x = job->x;
+  const int pic_width = job->picture->y_crop_width;
+  const int x_end = pic_width - block_size + 1;
 
   const int src_size = block_size >> 1;
   const int quad_size = block_size >> 2;
+  const int size_minus_1 = block_size - 1;
 
   uint32_t p[4];
   const int length = sizeof(p);
 
-  int pos = 0;
-  for (int y_pos = 0; y_pos < y_end; y_pos++) {
+  for (int y_pos = job->row_start; y_pos < job->row_end; y_pos++) {
+    int pos = y_pos * pic_width;
     for (int x_pos = 0; x_pos < x_end; x_pos++) {
       p[0] = src_pic_block_hash[0][pos];
       p[1] = src_pic_block_hash[0][pos + src_size];
       p[2] = src_pic_block_hash[0][pos + src_size * pic_width];
       p[3] = src_pic_block_hash[0][pos + src_size * pic_width + src_size];
       dst_pic_block_hash[0][pos] =
-          av1_get_crc_value(&x->crc_calculator1, (uint8_t *)p, length);
+          av1_get_crc32c_value(&x->crc_calculator1, (uint8_t *)p, length);
 
       p[0] = src_pic_block_hash[1][pos];
       p[1] = src_pic_block_hash[1][pos + src_size];
@@ -279,59 +249,366 @@ void av1_generate_block_hash_value(const YV12_BUFFER_CONFIG *picture,
           src_pic_block_same_info[1][pos + quad_size * pic_width + src_size] &&
           src_pic_block_same_info[1][pos + src_size * pic_width] &&
           src_pic_block_same_info[1][pos + src_size * pic_width + src_size];
+
+      dst_pic_block_same_info[2][pos] =
+          (!dst_pic_block_same_info[0][pos] &&
+           !dst_pic_block_same_info[1][pos]) ||
+          (((x_pos & size_minus_1) == 0) && ((y_pos & size_minus_1) == 0));
       pos++;
     }
-    pos += block_size - 1;
   }
+}
 
-  if (block_size >= 4) {
-    const int size_minus_1 = block_size - 1;
-    pos = 0;
-    for (int y_pos = 0; y_pos < y_end; y_pos++) {
-      for (int x_pos = 0; x_pos < x_end; x_pos++) {
-        dst_pic_block_same_info[2][pos] =
-            (!dst_pic_block_same_info[0][pos] &&
-             !dst_pic_block_same_info[1][pos]) ||
-            (((x_pos & size_minus_1) == 0) && ((y_pos & size_minus_1) == 0));
-        pos++;
+static int hash_rows_worker_hook(void *arg1, void *unused) {
+  const HashRowsJob *const job = (const HashRowsJob *)arg1;
+  (void)unused;
+  if (job->block_size == 2) {
+    generate_block_2x2_hash_value(job);
+  } else {
+    generate_block_hash_value(job);
+  }
+  return 1;
+}
+
+// Splits the rows of job in bands that are hashed by the workers.
+static void hash_rows_mt(const HashRowsJob *job, AVxWorker *workers,
+                         int num_workers) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  const int num_rows = job->row_end - job->row_start;
+  HashRowsJob jobs[MAX_NUM_THREADS];
+
+  if (num_rows <= 0) return;
+  num_workers = AOMMIN(AOMMIN(num_workers, MAX_NUM_THREADS), num_rows);
+  if (num_workers <= 1) {
+    hash_rows_worker_hook((void *)job, NULL);
+    return;
+  }
+
+  for (int i = num_workers - 1; i >= 0; i--) {
+    AVxWorker *const worker = &workers[i];
+    jobs[i] = *job;
+    jobs[i].row_start = job->row_start + num_rows * i / num_workers;
+    jobs[i].row_end = job->row_start + num_rows * (i + 1) / num_workers;
+
+    worker->hook = hash_rows_worker_hook;
+    worker->data1 = &jobs[i];
+    worker->data2 = NULL;
+
+    // Start hashing
+    if (i == 0) {
+      winterface->execute(worker);
+    } else {
+      winterface->launch(worker);
+    }
+  }
+
+  // Wait till all rows are hashed
+  for (int i = num_workers - 1; i >= 0; i--) {
+    winterface->sync(&workers[i]);
+  }
+}
+
+// Work buffers of av1_hash_table_build().
+typedef struct {
+  // Write position of each bucket of a block size.
+  uint32_t *cursor;
+  // Hashed blocks and their bucket starts, when they are merged with the
+  // blocks of the previous table.
+  block_hash *new_entries;
+  int max_new_entries;
+  uint32_t *new_bucket_start;
+} HashBuildBuffers;
+
+static int reserve_entries(block_hash **p_entries, int *max_entries,
+                           int num_entries, int size) {
+  if (size <= *max_entries) return 0;
+  const int new_max_entries = AOMMAX(size, 2 * *max_entries);
+  block_hash *const entries =
+      (block_hash *)aom_malloc(sizeof(*entries) * new_max_entries);
+  if (entries == NULL) return -1;
+  if (num_entries > 0) {
+    memcpy(entries, *p_entries, sizeof(*entries) * num_entries);
+  }
+  aom_free(*p_entries);
+  *p_entries = entries;
+  *max_entries = new_max_entries;
+  return 0;
+}
+
+// Writes the flagged blocks of rows [row_start, row_end) at the cursor of
+// their bucket, in column order.
+static void scatter_blocks(block_hash *entries, uint32_t *cursor,
+                           uint32_t *pic_hash[2], const int8_t *pic_is_added,
+                           int pic_width, int x_end, int row_start,
+                           int row_end) {
+  const uint32_t crc_mask = (1 << crc_bits) - 1;
+  for (int x_pos = 0; x_pos < x_end; x_pos++) {
+    for (int y_pos = row_start; y_pos < row_end; y_pos++) {
+      const int pos = y_pos * pic_width + x_pos;
+      if (pic_is_added[pos]) {
+        block_hash *const curr_block_hash =
+            &entries[cursor[pic_hash[0][pos] & crc_mask]++];
+        curr_block_hash->x = x_pos;
+        curr_block_hash->y = y_pos;
+        curr_block_hash->hash_value2 = pic_hash[1][pos];
       }
-      pos += block_size - 1;
     }
   }
 }
 
-void av1_add_to_hash_map_by_row_with_precal_data(hash_table *p_hash_table,
-                                                 uint32_t *pic_hash[2],
-                                                 int8_t *pic_is_same,
-                                                 int pic_width, int pic_height,
-                                                 int block_size) {
+// Appends the blocks of size block_size to the table: the flagged ones of rows
+// [row_start, row_end), and the other ones from prev_hash_table when it is not
+// NULL. The blocks of each bucket are kept in column order.
+static int add_blocks(hash_table *p_hash_table,
+                      const hash_table *prev_hash_table, uint32_t *pic_hash[2],
+                      const int8_t *pic_is_added, int pic_width,
+                      int block_size, int row_start, int row_end,
+                      HashBuildBuffers *bufs) {
+  const int num_buckets = 1 << crc_bits;
+  const uint32_t crc_mask = num_buckets - 1;
+  const int first_bucket = hash_block_size_to_index(block_size) << crc_bits;
   const int x_end = pic_width - block_size + 1;
-  const int y_end = pic_height - block_size + 1;
+  uint32_t *const bucket_start = p_hash_table->p_bucket_start + first_bucket;
+  uint32_t *const cursor = bufs->cursor;
+  int num_new_entries = 0;
+
+  memset(cursor, 0, sizeof(*cursor) * num_buckets);
+  for (int y_pos = row_start; y_pos < row_end; y_pos++) {
+    const int8_t *const is_added = pic_is_added + y_pos * pic_width;
+    const uint32_t *const hash = pic_hash[0] + y_pos * pic_width;
+    for (int x_pos = 0; x_pos < x_end; x_pos++) {
+      if (is_added[x_pos]) {
+        cursor[hash[x_pos] & crc_mask]++;
+        num_new_entries++;
+      }
+    }
+  }
 
-  const int8_t *src_is_added = pic_is_same;
-  const uint32_t *src_hash[2] = { pic_hash[0], pic_hash[1] };
+  if (prev_hash_table == NULL) {
+    uint32_t offset = p_hash_table->num_entries;
+    for (int i = 0; i < num_buckets; i++) {
+      const uint32_t count = cursor[i];
+      bucket_start[i] = cursor[i] = offset;
+      offset += count;
+    }
+    if (reserve_entries(&p_hash_table->p_entries, &p_hash_table->max_entries,
+                        p_hash_table->num_entries, offset)) {
+      return -1;
+    }
+    scatter_blocks(p_hash_table->p_entries, cursor, pic_hash, pic_is_added,
+                   pic_width, x_end, row_start, row_end);
+    p_hash_table->num_entries = offset;
+    return 0;
+  }
 
-  int add_value = hash_block_size_to_index(block_size);
-  assert(add_value >= 0);
-  add_value <<= crc_bits;
-  const int crc_mask = (1 << crc_bits) - 1;
+  uint32_t *const new_bucket_start = bufs->new_bucket_start;
+  uint32_t offset = 0;
+  for (int i = 0; i < num_buckets; i++) {
+    const uint32_t count = cursor[i];
+    new_bucket_start[i] = cursor[i] = offset;
+    offset += count;
+  }
+  new_bucket_start[num_buckets] = offset;
+  if (reserve_entries(&bufs->new_entries, &bufs->max_new_entries, 0,
+                      num_new_entries)) {
+    return -1;
+  }
+  scatter_blocks(bufs->new_entries, cursor, pic_hash, pic_is_added, pic_width,
+                 x_end, row_start, row_end);
+
+  // Count the blocks kept from the previous table.
+  const uint32_t *const prev_bucket_start =
+      prev_hash_table->p_bucket_start + first_bucket;
+  offset = p_hash_table->num_entries;
+  for (int i = 0; i < num_buckets; i++) {
+    bucket_start[i] = offset;
+    offset += new_bucket_start[i + 1] - new_bucket_start[i];
+    for (uint32_t j = prev_bucket_start[i]; j < prev_bucket_start[i + 1]; j++) {
+      const int y_pos = prev_hash_table->p_entries[j].y;
+      offset += y_pos < row_start || y_pos >= row_end;
+    }
+  }
+  if (reserve_entries(&p_hash_table->p_entries, &p_hash_table->max_entries,
+                      p_hash_table->num_entries, offset)) {
+    return -1;
+  }
 
-  for (int x_pos = 0; x_pos < x_end; x_pos++) {
-    for (int y_pos = 0; y_pos < y_end; y_pos++) {
-      const int pos = y_pos * pic_width + x_pos;
-      // valid data
-      if (src_is_added[pos]) {
-        block_hash curr_block_hash;
-        curr_block_hash.x = x_pos;
-        curr_block_hash.y = y_pos;
+  // Merge them with the hashed blocks.
+  for (int i = 0; i < num_buckets; i++) {
+    block_hash *dst = p_hash_table->p_entries + bucket_start[i];
+    const block_hash *src = bufs->new_entries + new_bucket_start[i];
+    const block_hash *const src_end =
+        bufs->new_entries + new_bucket_start[i + 1];
+    const block_hash *prev = prev_hash_table->p_entries + prev_bucket_start[i];
+    const block_hash *const prev_end =
+        prev_hash_table->p_entries + prev_bucket_start[i + 1];
+    for (; prev < prev_end; prev++) {
+      if (prev->y >= row_start && prev->y < row_end) continue;
+      while (src < src_end &&
+             (src->x < prev->x || (src->x == prev->x && src->y < prev->y))) {
+        *dst++ = *src++;
+      }
+      *dst++ = *prev;
+    }
+    while (src < src_end) *dst++ = *src++;
+  }
+  p_hash_table->num_entries = offset;
+  return 0;
+}
+
+// Gets the rows of the blocks of size block_size that overlap rows
+// [row_start, row_end) of the picture.
+static void get_overlapping_rows(int block_size, int pic_height, int row_start,
+                                 int row_end, int *start, int *end) {
+  *start = AOMMAX(row_start - block_size + 1, 0);
+  *end = AOMMIN(row_end, pic_height - block_size + 1);
+  if (*end < *start) *end = *start;
+}
+
+int av1_hash_table_build(hash_table *p_hash_table,
+                         const hash_table *prev_hash_table,
+                         const YV12_BUFFER_CONFIG *picture,
+                         int changed_row_start, int changed_row_end,
+                         MACROBLOCK *x, AVxWorker *workers, int num_workers) {
+  const int pic_width = picture->y_crop_width;
+  const int pic_height = picture->y_crop_height;
+  const int num_pixels = pic_width * pic_height;
+  const int num_buckets = 1 << (crc_bits + block_size_bits);
+  // Levels of 2x2 to 128x128 blocks.
+  const int num_levels = 7;
+  int add_start[7], add_end[7], hash_start[7], hash_end[7];
+  uint32_t *block_hash_values[2][2] = { { NULL } };
+  int8_t *is_block_same[2][3] = { { NULL } };
+  HashBuildBuffers bufs = { NULL, NULL, 0, NULL };
+  hash_table old_hash_table;
+  int ret = 0;
+
+  if (prev_hash_table != NULL &&
+      (prev_hash_table->p_bucket_start == NULL ||
+       prev_hash_table->pic_width != pic_width ||
+       prev_hash_table->pic_height != pic_height)) {
+    prev_hash_table = NULL;
+  }
+  if (prev_hash_table == NULL) {
+    changed_row_start = 0;
+    changed_row_end = pic_height;
+  } else if (prev_hash_table == p_hash_table) {
+    // Build the table in new arrays.
+    old_hash_table = *p_hash_table;
+    prev_hash_table = &old_hash_table;
+    p_hash_table->p_entries = NULL;
+    p_hash_table->p_bucket_start = NULL;
+    p_hash_table->max_entries = 0;
+  }
+  p_hash_table->num_entries = 0;
+  p_hash_table->pic_width = pic_width;
+  p_hash_table->pic_height = pic_height;
 
-        const uint32_t hash_value1 = (src_hash[0][pos] & crc_mask) + add_value;
-        curr_block_hash.hash_value2 = src_hash[1][pos];
+  if (p_hash_table->p_bucket_start == NULL) {
+    p_hash_table->p_bucket_start = (uint32_t *)aom_malloc(
+        sizeof(*p_hash_table->p_bucket_start) * (num_buckets + 1));
+  }
+  for (int k = 0; k < 2; k++) {
+    for (int j = 0; j < 2; j++) {
+      block_hash_values[k][j] =
+          (uint32_t *)aom_malloc(sizeof(uint32_t) * num_pixels);
+      if (block_hash_values[k][j] == NULL) ret = -1;
+    }
+    for (int j = 0; j < 3; j++) {
+      is_block_same[k][j] = (int8_t *)aom_malloc(sizeof(int8_t) * num_pixels);
+      if (is_block_same[k][j] == NULL) ret = -1;
+    }
+  }
+  bufs.cursor = (uint32_t *)aom_malloc(sizeof(*bufs.cursor) << crc_bits);
+  if (prev_hash_table != NULL) {
+    bufs.new_bucket_start = (uint32_t *)aom_malloc(
+        sizeof(*bufs.new_bucket_start) * ((1 << crc_bits) + 1));
+    if (bufs.new_bucket_start == NULL) ret = -1;
+  }
+  if (p_hash_table->p_bucket_start == NULL || bufs.cursor == NULL) ret = -1;
 
-        hash_table_add_to_table(p_hash_table, hash_value1, &curr_block_hash);
+  // A block is hashed when it overlaps the changed rows, or when a block of
+  // twice its size that is hashed contains it.
+  for (int i = 0; i < num_levels; i++) {
+    get_overlapping_rows(2 << i, pic_height, changed_row_start,
+                         changed_row_end, &add_start[i], &add_end[i]);
+  }
+  hash_start[num_levels - 1] = add_start[num_levels - 1];
+  hash_end[num_levels - 1] = add_end[num_levels - 1];
+  for (int i = num_levels - 1; i > 0; i--) {
+    const int src_size = 1 << i;
+    hash_start[i - 1] = add_start[i - 1];
+    hash_end[i - 1] = add_end[i - 1];
+    if (hash_start[i] < hash_end[i]) {
+      if (hash_start[i - 1] < hash_end[i - 1]) {
+        hash_start[i - 1] = AOMMIN(hash_start[i - 1], hash_start[i]);
+        hash_end[i - 1] = AOMMAX(hash_end[i - 1], hash_end[i] + src_size);
+      } else {
+        hash_start[i - 1] = hash_start[i];
+        hash_end[i - 1] = hash_end[i] + src_size;
       }
+      hash_end[i - 1] = AOMMIN(hash_end[i - 1], pic_height - src_size + 1);
+    }
+  }
+
+  if (ret == 0) {
+    HashRowsJob job;
+    job.picture = picture;
+    job.block_size = 2;
+    job.src_pic_block_hash = NULL;
+    job.dst_pic_block_hash = block_hash_values[0];
+    job.src_pic_block_same_info = NULL;
+    job.dst_pic_block_same_info = is_block_same[0];
+    job.row_start = hash_start[0];
+    job.row_end = hash_end[0];
+    job.x = x;
+    hash_rows_mt(&job, workers, num_workers);
+    for (int i = 1; i < num_levels && ret == 0; i++) {
+      const int src_idx = (i - 1) & 1;
+      const int dst_idx = i & 1;
+      job.block_size = 2 << i;
+      job.src_pic_block_hash = block_hash_values[src_idx];
+      job.dst_pic_block_hash = block_hash_values[dst_idx];
+      job.src_pic_block_same_info = is_block_same[src_idx];
+      job.dst_pic_block_same_info = is_block_same[dst_idx];
+      job.row_start = hash_start[i];
+      job.row_end = hash_end[i];
+      hash_rows_mt(&job, workers, num_workers);
+      ret = add_blocks(p_hash_table, prev_hash_table,
+                       block_hash_values[dst_idx], is_block_same[dst_idx][2],
+                       pic_width, 2 << i, add_start[i], add_end[i], &bufs);
     }
   }
+
+  if (ret == 0) {
+    // No blocks of the unused block size indices.
+    for (int i = (hash_block_size_to_index(128) + 1) << crc_bits;
+         i <= num_buckets; i++) {
+      p_hash_table->p_bucket_start[i] = p_hash_table->num_entries;
+    }
+  } else {
+    p_hash_table->num_entries = 0;
+    if (p_hash_table->p_bucket_start != NULL) {
+      memset(p_hash_table->p_bucket_start, 0,
+             sizeof(*p_hash_table->p_bucket_start) * (num_buckets + 1));
+    }
+  }
+
+  for (int k = 0; k < 2; k++) {
+    for (int j = 0; j < 2; j++) {
+      aom_free(block_hash_values[k][j]);
+    }
+    for (int j = 0; j < 3; j++) {
+      aom_free(is_block_same[k][j]);
+    }
+  }
+  aom_free(bufs.cursor);
+  aom_free(bufs.new_entries);
+  aom_free(bufs.new_bucket_start);
+  if (prev_hash_table == &old_hash_table) {
+    av1_hash_table_destroy(&old_hash_table);
+  }
+  return ret;
 }
 
 int av1_hash_is_horizontal_perfect(const YV12_BUFFER_CONFIG *picture,
@@ -410,8 +687,8 @@ void av1_get_block_hash_value(uint8_t *y_src, int stride, int block_size,
             y16_src + y_pos * stride + x_pos, stride, pixel_to_hash);
         assert(pos < AOM_BUFFER_SIZE_FOR_BLOCK_HASH);
         x->hash_value_buffer[0][0][pos] =
-            av1_get_crc_value(&x->crc_calculator1, (uint8_t *)pixel_to_hash,
-                              sizeof(pixel_to_hash));
+            av1_get_crc32c_value(&x->crc_calculator1, (uint8_t *)pixel_to_hash,
+                                 sizeof(pixel_to_hash));
         x->hash_value_buffer[1][0][pos] =
             av1_get_crc_value(&x->crc_calculator2, (uint8_t *)pixel_to_hash,
                               sizeof(pixel_to_hash));
@@ -425,7 +702,7 @@ void av1_get_block_hash_value(uint8_t *y_src, int stride, int block_size,
         get_pixels_in_1D_char_array_by_block_2x2(y_src + y_pos * stride + x_pos,
                                                  stride, pixel_to_hash);
         assert(pos < AOM_BUFFER_SIZE_FOR_BLOCK_HASH);
-        x->hash_value_buffer[0][0][pos] = av1_get_crc_value(
+        x->hash_value_buffer[0][0][pos] = av1_get_crc32c_value(
             &x->crc_calculator1, pixel_to_hash, sizeof(pixel_to_hash));
         x->hash_value_buffer[1][0][pos] = av1_get_crc_value(
             &x->crc_calculator2, pixel_to_hash, sizeof(pixel_to_hash));
@@ -460,7 +737,7 @@ void av1_get_block_hash_value(uint8_t *y_src, int stride, int block_size,
         to_hash[3] = x->hash_value_buffer[0][src_idx]
                                          [srcPos + src_sub_block_in_width + 1];
 
-        x->hash_value_buffer[0][dst_idx][dst_pos] = av1_get_crc_value(
+        x->hash_value_buffer[0][dst_idx][dst_pos] = av1_get_crc32c_value(
             &x->crc_calculator1, (uint8_t *)to_hash, sizeof(to_hash));
 
         to_hash[0] = x->hash_value_buffer[1][src_idx][srcPos];
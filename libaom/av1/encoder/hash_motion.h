@@ -16,7 +16,8 @@
 
 #include "aom/aom_integer.h"
 #include "aom_scale/yv12config.h"
-#include "third_party/vector/vector.h"
+#include "aom_util/aom_thread.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -30,35 +31,41 @@ typedef struct _block_hash {
   uint32_t hash_value2;
 } block_hash;
 
+// The blocks are stored in a single array, grouped by their first hash value
+// and in column order within a group. The blocks whose first hash value is h
+// are p_entries[p_bucket_start[h]] to p_entries[p_bucket_start[h + 1] - 1].
 typedef struct _hash_table {
-  Vector **p_lookup_table;
+  block_hash *p_entries;
+  uint32_t *p_bucket_start;
+  int num_entries;
+  int max_entries;
+  // Size of the picture the table was built from.
+  int pic_width;
+  int pic_height;
 } hash_table;
 
 void av1_hash_table_init(hash_table *p_hash_table, struct macroblock *x);
 void av1_hash_table_destroy(hash_table *p_hash_table);
-void av1_hash_table_create(hash_table *p_hash_table);
 int32_t av1_hash_table_count(const hash_table *p_hash_table,
                              uint32_t hash_value);
-Iterator av1_hash_get_first_iterator(hash_table *p_hash_table,
-                                     uint32_t hash_value);
-int32_t av1_has_exact_match(hash_table *p_hash_table, uint32_t hash_value1,
-                            uint32_t hash_value2);
-void av1_generate_block_2x2_hash_value(const YV12_BUFFER_CONFIG *picture,
-                                       uint32_t *pic_block_hash[2],
-                                       int8_t *pic_block_same_info[3],
-                                       struct macroblock *x);
-void av1_generate_block_hash_value(const YV12_BUFFER_CONFIG *picture,
-                                   int block_size,
-                                   uint32_t *src_pic_block_hash[2],
-                                   uint32_t *dst_pic_block_hash[2],
-                                   int8_t *src_pic_block_same_info[3],
-                                   int8_t *dst_pic_block_same_info[3],
-                                   struct macroblock *x);
-void av1_add_to_hash_map_by_row_with_precal_data(hash_table *p_hash_table,
-                                                 uint32_t *pic_hash[2],
-                                                 int8_t *pic_is_same,
-                                                 int pic_width, int pic_height,
-                                                 int block_size);
+const block_hash *av1_hash_get_first_block(const hash_table *p_hash_table,
+                                           uint32_t hash_value);
+int32_t av1_has_exact_match(const hash_table *p_hash_table,
+                            uint32_t hash_value1, uint32_t hash_value2);
+
+// Builds p_hash_table from all the square blocks of 4x4 to 128x128 of
+// picture. The rows are hashed in parallel when num_workers > 1.
+// prev_hash_table, when not NULL, must have been built from a picture that
+// only differs from picture in rows changed_row_start to changed_row_end - 1.
+// The blocks that do not overlap those rows are then copied from it rather
+// than hashed again. prev_hash_table may be p_hash_table. Returns -1 if memory
+// allocation fails, in which case p_hash_table is left empty.
+int av1_hash_table_build(hash_table *p_hash_table,
+                         const hash_table *prev_hash_table,
+                         const YV12_BUFFER_CONFIG *picture,
+                         int changed_row_start, int changed_row_end,
+                         struct macroblock *x, AVxWorker *workers,
+                         int num_workers);
 
 // check whether the block starts from (x_start, y_start) with the size of
 // block_size x block_size has the same color in all rows
@@ -21,11 +21,23 @@ extern "C" {
 
 #define MAX_LAG_BUFFERS 25
 
+// Costs of a frame from the one-pass lookahead analysis, measured on a 1/4
+// scale luma plane in 8x8 blocks (see lookahead_analysis.h).
+struct lookahead_frame_stats {
+  int valid;
+  int64_t intra_cost;  // Sad of each block against its mean.
+  int64_t inter_cost;  // Motion searched sad against the previous frame.
+  // Motion searched sad against the frame before the previous one, which is
+  // low for the frame after a flash.
+  int64_t inter_cost2;
+};
+
 struct lookahead_entry {
   YV12_BUFFER_CONFIG img;
   int64_t ts_start;
   int64_t ts_end;
   aom_enc_frame_flags_t flags;
+  struct lookahead_frame_stats stats;
 };
 
 // The max of past frames we want to keep in the queue.
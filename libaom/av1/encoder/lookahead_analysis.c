@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <limits.h>
+
+#include "config/aom_dsp_rtcd.h"
+
+#include "aom_mem/aom_mem.h"
+
+#include "av1/encoder/encoder.h"
+#include "av1/encoder/lookahead_analysis.h"
+
+#define ANALYSIS_SCALE_LOG2 2
+#define ANALYSIS_BLOCK 8
+// Motion search range in downscaled pixels.
+#define ANALYSIS_SEARCH_RANGE 2
+
+// A frame is a scene cut candidate when its inter cost is a large part of
+// its intra cost and jumps against the inter cost of the frame before it.
+static const double kCutInterIntraRatio = 0.6;
+static const double kCutInterJump = 3.0;
+// The frame after a flash predicts from the frame before the flash at well
+// below the cost of predicting from the flash.
+static const double kFlashInter2Ratio = 0.5;
+// A gf group ends once the summed inter to intra cost ratios exceed this.
+static const double kGfDecayBudget = 1.5;
+
+int av1_lookahead_analysis_enabled(const AV1_COMP *cpi) {
+  return cpi->oxcf.pass == 0 && cpi->oxcf.lag_in_frames > 0 && !cpi->use_svc;
+}
+
+void av1_lookahead_analysis_free(LOOKAHEAD_ANALYSIS *la) {
+  aom_free(la->prev[0]);
+  aom_free(la->prev[1]);
+  aom_free(la->cur);
+  la->prev[0] = la->prev[1] = la->cur = NULL;
+  la->width = la->height = 0;
+  la->num_prev = 0;
+}
+
+static int alloc_analysis(LOOKAHEAD_ANALYSIS *la, int width, int height) {
+  if (la->width == width && la->height == height && la->cur != NULL) return 0;
+  av1_lookahead_analysis_free(la);
+  const size_t size = (size_t)width * height;
+  la->prev[0] = (uint8_t *)aom_malloc(size);
+  la->prev[1] = (uint8_t *)aom_malloc(size);
+  la->cur = (uint8_t *)aom_malloc(size);
+  if (!la->prev[0] || !la->prev[1] || !la->cur) {
+    av1_lookahead_analysis_free(la);
+    return -1;
+  }
+  la->width = width;
+  la->height = height;
+  return 0;
+}
+
+// Box filters the luma plane of 'src' down by 1 << ANALYSIS_SCALE_LOG2 into
+// an 8-bit plane.
+static void downscale_luma(const YV12_BUFFER_CONFIG *src, int bit_depth,
+                           uint8_t *dst, int width, int height) {
+  const int scale = 1 << ANALYSIS_SCALE_LOG2;
+  const int shift = 2 * ANALYSIS_SCALE_LOG2 + bit_depth - 8;
+  const int stride = src->y_stride;
+  const int use_hbd = (src->flags & YV12_FLAG_HIGHBITDEPTH) != 0;
+  for (int r = 0; r < height; ++r) {
+    for (int c = 0; c < width; ++c) {
+      const int offset = r * scale * stride + c * scale;
+      int sum = 0;
+      if (use_hbd) {
+        const uint16_t *p = CONVERT_TO_SHORTPTR(src->y_buffer) + offset;
+        for (int i = 0; i < scale; ++i, p += stride)
+          for (int j = 0; j < scale; ++j) sum += p[j];
+      } else {
+        const uint8_t *p = src->y_buffer + offset;
+        for (int i = 0; i < scale; ++i, p += stride)
+          for (int j = 0; j < scale; ++j) sum += p[j];
+      }
+      dst[r * width + c] = (uint8_t)ROUND_POWER_OF_TWO(sum, shift);
+    }
+  }
+}
+
+static unsigned int block_intra_cost(const uint8_t *src, int stride) {
+  int sum = 0;
+  for (int i = 0; i < ANALYSIS_BLOCK; ++i)
+    for (int j = 0; j < ANALYSIS_BLOCK; ++j) sum += src[i * stride + j];
+  const int mean = ROUND_POWER_OF_TWO(sum, 6);
+  unsigned int cost = 0;
+  for (int i = 0; i < ANALYSIS_BLOCK; ++i)
+    for (int j = 0; j < ANALYSIS_BLOCK; ++j)
+      cost += abs(src[i * stride + j] - mean);
+  return cost;
+}
+
+static unsigned int block_inter_cost(const uint8_t *src, const uint8_t *ref,
+                                     int stride, int row, int col, int rows,
+                                     int cols) {
+  unsigned int best = UINT_MAX;
+  for (int dr = -ANALYSIS_SEARCH_RANGE; dr <= ANALYSIS_SEARCH_RANGE; ++dr) {
+    if (row + dr < 0 || row + dr + ANALYSIS_BLOCK > rows) continue;
+    for (int dc = -ANALYSIS_SEARCH_RANGE; dc <= ANALYSIS_SEARCH_RANGE; ++dc) {
+      if (col + dc < 0 || col + dc + ANALYSIS_BLOCK > cols) continue;
+      const unsigned int sad =
+          aom_sad8x8(src, stride, ref + dr * stride + dc, stride);
+      best = AOMMIN(best, sad);
+    }
+  }
+  return best;
+}
+
+void av1_lookahead_analyze_frame(AV1_COMP *cpi, const YV12_BUFFER_CONFIG *src,
+                                 struct lookahead_frame_stats *stats) {
+  LOOKAHEAD_ANALYSIS *const la = &cpi->lookahead_analysis;
+  const int width = src->y_crop_width >> ANALYSIS_SCALE_LOG2;
+  const int height = src->y_crop_height >> ANALYSIS_SCALE_LOG2;
+
+  stats->valid = 0;
+  if (width < ANALYSIS_BLOCK || height < ANALYSIS_BLOCK) return;
+  if (la->width != width || la->height != height) la->num_prev = 0;
+  if (alloc_analysis(la, width, height)) return;
+
+  downscale_luma(src, cpi->common.seq_params.bit_depth, la->cur, width,
+                 height);
+  if (la->num_prev > 0) {
+    stats->intra_cost = stats->inter_cost = stats->inter_cost2 = 0;
+    for (int r = 0; r + ANALYSIS_BLOCK <= height; r += ANALYSIS_BLOCK) {
+      for (int c = 0; c + ANALYSIS_BLOCK <= width; c += ANALYSIS_BLOCK) {
+        const int offset = r * width + c;
+        const unsigned int intra = block_intra_cost(la->cur + offset, width);
+        const unsigned int inter =
+            block_inter_cost(la->cur + offset, la->prev[0] + offset, width, r,
+                             c, height, width);
+        stats->intra_cost += intra;
+        stats->inter_cost += AOMMIN(inter, intra);
+        if (la->num_prev > 1) {
+          const unsigned int inter2 =
+              block_inter_cost(la->cur + offset, la->prev[1] + offset, width,
+                               r, c, height, width);
+          stats->inter_cost2 += AOMMIN(inter2, intra);
+        }
+      }
+    }
+    if (la->num_prev < 2) stats->inter_cost2 = INT64_MAX;
+    stats->valid = 1;
+  }
+
+  // Rotate the planes: cur becomes the most recent previous frame.
+  uint8_t *const oldest = la->prev[1];
+  la->prev[1] = la->prev[0];
+  la->prev[0] = la->cur;
+  la->cur = oldest;
+  la->num_prev = AOMMIN(la->num_prev + 1, 2);
+}
+
+static const struct lookahead_frame_stats *get_stats(struct lookahead_ctx *ctx,
+                                                     int distance) {
+  // Distance 0 is the frame being coded, which has already been popped.
+  const struct lookahead_entry *const e = av1_lookahead_peek(ctx, distance - 1);
+  return e != NULL && e->stats.valid ? &e->stats : NULL;
+}
+
+static int is_flash(struct lookahead_ctx *ctx, int distance) {
+  const struct lookahead_frame_stats *const stats = get_stats(ctx, distance);
+  const struct lookahead_frame_stats *const next =
+      get_stats(ctx, distance + 1);
+  return stats != NULL && next != NULL &&
+         next->inter_cost2 < kFlashInter2Ratio * next->inter_cost;
+}
+
+int av1_lookahead_find_scene_cut(struct lookahead_ctx *ctx,
+                                 int max_distance) {
+  for (int i = 1; i <= max_distance; ++i) {
+    const struct lookahead_frame_stats *const stats = get_stats(ctx, i);
+    const struct lookahead_frame_stats *const prev = get_stats(ctx, i - 1);
+    if (stats == NULL) break;
+    if (prev == NULL) continue;
+    if (stats->inter_cost > kCutInterIntraRatio * stats->intra_cost &&
+        stats->inter_cost > kCutInterJump * AOMMAX(prev->inter_cost, 1) &&
+        !is_flash(ctx, i))
+      return i;
+  }
+  return 0;
+}
+
+int av1_lookahead_gf_interval(struct lookahead_ctx *ctx, int min_interval,
+                              int max_interval, int key_distance,
+                              double *inter_ratio) {
+  // The group can run up to the frame before the key frame.
+  const int limit =
+      key_distance > 0 ? AOMMIN(max_interval, key_distance) : max_interval;
+  double decay = 0.0;
+  int frames = 0;
+  int interval = 1;
+
+  for (; interval <= limit; ++interval) {
+    const struct lookahead_frame_stats *const stats =
+        get_stats(ctx, interval);
+    if (stats == NULL) break;
+    // A flash says nothing about how well the group predicts, and the frame
+    // after it predicts from the frame before it.
+    if (is_flash(ctx, interval)) continue;
+    const int64_t inter_cost = interval > 1 && is_flash(ctx, interval - 1)
+                                   ? stats->inter_cost2
+                                   : stats->inter_cost;
+    decay += (double)inter_cost / AOMMAX(stats->intra_cost, 1);
+    ++frames;
+    if (interval >= min_interval && decay > kGfDecayBudget) break;
+  }
+  interval = AOMMIN(interval, limit);
+  // Rather than leave a group shorter than the minimum before the key frame,
+  // extend this one up to it.
+  if (key_distance > 0 && key_distance <= max_interval &&
+      key_distance - interval < min_interval)
+    interval = key_distance;
+  *inter_ratio = frames ? decay / frames : 0.0;
+  return AOMMAX(interval, 1);
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_AV1_ENCODER_LOOKAHEAD_ANALYSIS_H_
+#define AOM_AV1_ENCODER_LOOKAHEAD_ANALYSIS_H_
+
+#include "aom/aom_integer.h"
+#include "aom_scale/yv12config.h"
+
+#include "av1/encoder/lookahead.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// One-pass replacement for the first pass statistics used by the key frame
+// and gf group decisions. Every frame pushed into the lookahead is reduced to
+// a 1/4 scale luma plane and compared against the two frames pushed before
+// it, which costs a small fraction of coding the frame. The costs are kept
+// with the lookahead entry until the rate control looks at them.
+typedef struct {
+  int width;
+  int height;
+  // Downscaled luma of the two previously pushed frames, most recent first.
+  uint8_t *prev[2];
+  uint8_t *cur;
+  int num_prev;
+} LOOKAHEAD_ANALYSIS;
+
+struct AV1_COMP;
+
+// Returns 1 if the lookahead analysis drives the key frame and gf group
+// decisions, i.e. in one-pass mode with a lookahead.
+int av1_lookahead_analysis_enabled(const struct AV1_COMP *cpi);
+
+// Measures the costs of 'src', the frame just pushed into the lookahead.
+void av1_lookahead_analyze_frame(struct AV1_COMP *cpi,
+                                 const YV12_BUFFER_CONFIG *src,
+                                 struct lookahead_frame_stats *stats);
+
+void av1_lookahead_analysis_free(LOOKAHEAD_ANALYSIS *la);
+
+// Returns the distance from the frame being coded to the next scene cut in
+// the lookahead, or 0 if there is none within 'max_distance' frames.
+int av1_lookahead_find_scene_cut(struct lookahead_ctx *ctx, int max_distance);
+
+// Picks the length of the gf group starting at the frame being coded from
+// how fast the prediction from it decays over the lookahead, stopping before
+// the key frame 'key_distance' frames away. 'inter_ratio' returns the average
+// ratio of inter to intra cost over the group, low for static content.
+int av1_lookahead_gf_interval(struct lookahead_ctx *ctx, int min_interval,
+                              int max_interval, int key_distance,
+                              double *inter_ratio);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AV1_ENCODER_LOOKAHEAD_ANALYSIS_H_
@@ -59,6 +59,30 @@ void av1_set_mv_search_range(MvLimits *mv_limits, const MV *mv) {
   if (mv_limits->row_max > row_max) mv_limits->row_max = row_max;
 }
 
+void av1_set_mv_limits(const AV1_COMMON *cm, MvLimits *mv_limits, int mi_row,
+                       int mi_col, int mi_height, int mi_width, int border) {
+  // Motion vectors further outside the frame do not produce new prediction
+  // blocks.
+  mv_limits->row_min = -(((mi_row + mi_height) * MI_SIZE) + AOM_INTERP_EXTEND);
+  mv_limits->col_min = -(((mi_col + mi_width) * MI_SIZE) + AOM_INTERP_EXTEND);
+  mv_limits->row_max = (cm->mi_rows - mi_row) * MI_SIZE + AOM_INTERP_EXTEND;
+  mv_limits->col_max = (cm->mi_cols - mi_col) * MI_SIZE + AOM_INTERP_EXTEND;
+
+  // A border smaller than the block does not cover all of them.
+  const int margin = border - 2 * AOM_INTERP_EXTEND;
+  mv_limits->row_min = AOMMAX(mv_limits->row_min, -(mi_row * MI_SIZE + margin));
+  mv_limits->col_min = AOMMAX(mv_limits->col_min, -(mi_col * MI_SIZE + margin));
+  mv_limits->row_max =
+      AOMMIN(mv_limits->row_max,
+             (cm->mi_rows - mi_row - mi_height) * MI_SIZE + margin);
+  mv_limits->col_max =
+      AOMMIN(mv_limits->col_max,
+             (cm->mi_cols - mi_col - mi_width) * MI_SIZE + margin);
+  // Frames much smaller than the block leave no such motion vector.
+  mv_limits->row_max = AOMMAX(mv_limits->row_max, mv_limits->row_min);
+  mv_limits->col_max = AOMMAX(mv_limits->col_max, mv_limits->col_min);
+}
+
 static void set_subpel_mv_search_range(const MvLimits *mv_limits, int *col_min,
                                        int *col_max, int *row_min, int *row_max,
                                        const MV *ref_mv) {
@@ -231,20 +255,78 @@ static INLINE const uint8_t *pre(const uint8_t *buf, int stride, int r, int c) {
     v = INT_MAX;                                                           \
   }
 
-#define FIRST_LEVEL_CHECKS                                       \
-  {                                                              \
-    unsigned int left, right, up, down, diag;                    \
-    CHECK_BETTER(left, tr, tc - hstep);                          \
-    CHECK_BETTER(right, tr, tc + hstep);                         \
-    CHECK_BETTER(up, tr - hstep, tc);                            \
-    CHECK_BETTER(down, tr + hstep, tc);                          \
-    whichdir = (left < right ? 0 : 1) + (up < down ? 0 : 2);     \
-    switch (whichdir) {                                          \
-      case 0: CHECK_BETTER(diag, tr - hstep, tc - hstep); break; \
-      case 1: CHECK_BETTER(diag, tr - hstep, tc + hstep); break; \
-      case 2: CHECK_BETTER(diag, tr + hstep, tc - hstep); break; \
-      case 3: CHECK_BETTER(diag, tr + hstep, tc + hstep); break; \
-    }                                                            \
+/* checks if mv k of a batch evaluated by subpel_variance_x4d() has better
+ * score than previous best */
+#define CHECK_BETTER_X4D(v, mvs, k)                                   \
+  {                                                                   \
+    v = mv_err_cost(&mvs[k], ref_mv, mvjcost, mvcost, error_per_bit); \
+    thismse = x4d_var[k];                                             \
+    sse = x4d_sse[k];                                                 \
+    v += thismse;                                                     \
+    if (v < besterr) {                                                \
+      besterr = v;                                                    \
+      br = mvs[k].row;                                                \
+      bc = mvs[k].col;                                                \
+      *distortion = thismse;                                          \
+      *sse1 = sse;                                                    \
+    }                                                                 \
+  }
+
+// Computes the sub-pixel variance of the 4 candidates in mvs with a single
+// call to vfp->svfx4d(). Returns 0, without evaluating anything, if there is
+// no batched function for this block size or a candidate is out of range; the
+// caller then has to check the candidates one at a time.
+static INLINE int subpel_variance_x4d(const aom_variance_fn_ptr_t *vfp,
+                                      const uint8_t *y, int y_stride,
+                                      const MV *mvs, int minr, int maxr,
+                                      int minc, int maxc, const uint8_t *src,
+                                      int src_stride, unsigned int *var,
+                                      unsigned int *sse) {
+  const uint8_t *ref[4];
+  int xoffset[4], yoffset[4];
+  int k;
+
+  if (vfp->svfx4d == NULL) return 0;
+  for (k = 0; k < 4; ++k) {
+    const int r = mvs[k].row, c = mvs[k].col;
+    if (c < minc || c > maxc || r < minr || r > maxr) return 0;
+    ref[k] = pre(y, y_stride, r, c);
+    xoffset[k] = sp(c);
+    yoffset[k] = sp(r);
+  }
+  vfp->svfx4d(ref, y_stride, xoffset, yoffset, src, src_stride, var, sse);
+  return 1;
+}
+
+#define FIRST_LEVEL_CHECKS                                               \
+  {                                                                      \
+    unsigned int left, right, up, down, diag;                            \
+    const MV x4d_mvs[4] = { { tr, tc - hstep },                          \
+                            { tr, tc + hstep },                          \
+                            { tr - hstep, tc },                          \
+                            { tr + hstep, tc } };                        \
+    unsigned int x4d_var[4], x4d_sse[4];                                 \
+    if (second_pred == NULL &&                                           \
+        subpel_variance_x4d(vfp, y, y_stride, x4d_mvs, minr, maxr, minc, \
+                            maxc, src_address, src_stride, x4d_var,      \
+                            x4d_sse)) {                                  \
+      CHECK_BETTER_X4D(left, x4d_mvs, 0);                                \
+      CHECK_BETTER_X4D(right, x4d_mvs, 1);                               \
+      CHECK_BETTER_X4D(up, x4d_mvs, 2);                                  \
+      CHECK_BETTER_X4D(down, x4d_mvs, 3);                                \
+    } else {                                                             \
+      CHECK_BETTER(left, tr, tc - hstep);                                \
+      CHECK_BETTER(right, tr, tc + hstep);                               \
+      CHECK_BETTER(up, tr - hstep, tc);                                  \
+      CHECK_BETTER(down, tr + hstep, tc);                                \
+    }                                                                    \
+    whichdir = (left < right ? 0 : 1) + (up < down ? 0 : 2);             \
+    switch (whichdir) {                                                  \
+      case 0: CHECK_BETTER(diag, tr - hstep, tc - hstep); break;         \
+      case 1: CHECK_BETTER(diag, tr - hstep, tc + hstep); break;         \
+      case 2: CHECK_BETTER(diag, tr + hstep, tc - hstep); break;         \
+      case 3: CHECK_BETTER(diag, tr + hstep, tc + hstep); break;         \
+    }                                                                    \
   }
 
 #define SECOND_LEVEL_CHECKS                                       \
@@ -748,7 +830,9 @@ int av1_find_best_sub_pixel_tree(
   int tc = bc;
   const MV *search_step = search_step_table;
   int idx, best_idx = -1;
+  int use_x4d = 0;
   unsigned int cost_array[5];
+  unsigned int x4d_var[4], x4d_sse[4];
   int kr, kc;
   int minc, maxc, minr, maxr;
 
@@ -784,6 +868,19 @@ int av1_find_best_sub_pixel_tree(
       return INT_MAX;
     x->fractional_best_mv[iter].as_mv.row = br;
     x->fractional_best_mv[iter].as_mv.col = bc;
+    // The 4 vertical and horizontal positions are independent of each other,
+    // so evaluate them with one batched call when possible.
+    use_x4d = 0;
+    if (!use_accurate_subpel_search && second_pred == NULL) {
+      MV x4d_mvs[4];
+      for (idx = 0; idx < 4; ++idx) {
+        x4d_mvs[idx].row = br + search_step[idx].row;
+        x4d_mvs[idx].col = bc + search_step[idx].col;
+      }
+      use_x4d = subpel_variance_x4d(vfp, y, y_stride, x4d_mvs, minr, maxr,
+                                    minc, maxc, src_address, src_stride,
+                                    x4d_var, x4d_sse);
+    }
     // Check vertical and horizontal sub-pixel positions.
     for (idx = 0; idx < 4; ++idx) {
       tr = br + search_step[idx].row;
@@ -797,6 +894,9 @@ int av1_find_best_sub_pixel_tree(
               pre(y, y_stride, tr, tc), y_stride, sp(tc), sp(tr), second_pred,
               mask, mask_stride, invert_mask, w, h, &sse,
               use_accurate_subpel_search);
+        } else if (use_x4d) {
+          thismse = x4d_var[idx];
+          sse = x4d_sse[idx];
         } else {
           thismse = estimate_upsampled_pref_error(
               vfp, src_address, src_stride, pre(y, y_stride, tr, tc), y_stride,
@@ -2307,6 +2407,35 @@ unsigned int av1_int_pro_motion_estimation(const AV1_COMP *cpi, MACROBLOCK *x,
   return best_sad;
 }
 
+int av1_pick_hinted_start_mv(const MACROBLOCK *x,
+                             const aom_variance_fn_ptr_t *fn_ptr,
+                             const MV *hint_mv, const MV *ref_mv,
+                             int sad_per_bit, MV *mvp_full) {
+  const struct buf_2d *const what = &x->plane[0].src;
+  const struct buf_2d *const in_what = &x->e_mbd.plane[0].pre[0];
+  const MV ref_full = { ref_mv->row >> 3, ref_mv->col >> 3 };
+  MV hint_full = { hint_mv->row >> 3, hint_mv->col >> 3 };
+  MV start = *mvp_full;
+
+  clamp_mv(&hint_full, x->mv_limits.col_min, x->mv_limits.col_max,
+           x->mv_limits.row_min, x->mv_limits.row_max);
+  clamp_mv(&start, x->mv_limits.col_min, x->mv_limits.col_max,
+           x->mv_limits.row_min, x->mv_limits.row_max);
+  if (hint_full.row == start.row && hint_full.col == start.col) return 0;
+
+  const unsigned int start_sad =
+      fn_ptr->sdf(what->buf, what->stride, get_buf_from_mv(in_what, &start),
+                  in_what->stride) +
+      mvsad_err_cost(x, &start, &ref_full, sad_per_bit);
+  const unsigned int hint_sad =
+      fn_ptr->sdf(what->buf, what->stride,
+                  get_buf_from_mv(in_what, &hint_full), in_what->stride) +
+      mvsad_err_cost(x, &hint_full, &ref_full, sad_per_bit);
+  if (hint_sad >= start_sad) return 0;
+  *mvp_full = hint_full;
+  return 1;
+}
+
 int av1_full_pixel_search(const AV1_COMP *cpi, MACROBLOCK *x, BLOCK_SIZE bsize,
                           MV *mvp_full, int step_param, int method,
                           int run_mesh_search, int error_per_bit,
@@ -2422,7 +2551,7 @@ int av1_full_pixel_search(const AV1_COMP *cpi, MACROBLOCK *x, BLOCK_SIZE bsize,
         int best_hash_cost = INT_MAX;
 
         // for the hashMap
-        hash_table *ref_frame_hash =
+        const hash_table *ref_frame_hash =
             intra ? &cpi->common.cur_frame->hash_table
                   : av1_get_ref_frame_hash_map(&cpi->common,
                                                x->e_mbd.mi[0]->ref_frame[0]);
@@ -2436,10 +2565,10 @@ int av1_full_pixel_search(const AV1_COMP *cpi, MACROBLOCK *x, BLOCK_SIZE bsize,
           break;
         }
 
-        Iterator iterator =
-            av1_hash_get_first_iterator(ref_frame_hash, hash_value1);
-        for (int i = 0; i < count; i++, iterator_increment(&iterator)) {
-          block_hash ref_block_hash = *(block_hash *)(iterator_get(&iterator));
+        const block_hash *ref_block_hashes =
+            av1_hash_get_first_block(ref_frame_hash, hash_value1);
+        for (int i = 0; i < count; i++) {
+          const block_hash ref_block_hash = ref_block_hashes[i];
           if (hash_value2 == ref_block_hash.hash_value2) {
             // For intra, make sure the prediction is from valid area.
             if (intra) {
@@ -3153,6 +3282,14 @@ void av1_simple_motion_search(AV1_COMP *const cpi, MACROBLOCK *x, int mi_row,
 
   mbmi->mv[0].as_mv = x->best_mv.as_mv;
 
+  // With a small border the prediction of a superblock at the bottom or right
+  // edge of the frame can reach past the border into the next plane, so it is
+  // built in the reference block buffer compound predictions use instead.
+  if (xd->mc_buf[1] != NULL) {
+    xd->plane[AOM_PLANE_Y].dst.buf = get_buf_by_bd(xd, xd->mc_buf[1]);
+    xd->plane[AOM_PLANE_Y].dst.stride = block_size_wide[bsize];
+  }
+
   // Get a copy of the prediction output
   av1_enc_build_inter_predictor(cm, xd, mi_row, mi_col, NULL, bsize,
                                 AOM_PLANE_Y, AOM_PLANE_Y);
@@ -59,6 +59,14 @@ void av1_init3smotion_compensation(search_site_config *cfg, int stride);
 
 void av1_set_mv_search_range(MvLimits *mv_limits, const MV *mv);
 
+struct AV1Common;
+
+// Sets the full pel motion vector limits of a block so that the motion search
+// and its subpel filter taps stay within 'border' pixels of the reference.
+void av1_set_mv_limits(const struct AV1Common *cm, MvLimits *mv_limits,
+                       int mi_row, int mi_col, int mi_height, int mi_width,
+                       int border);
+
 int av1_mv_bit_cost(const MV *mv, const MV *ref, const int *mvjcost,
                     int *mvcost[2], int weight);
 
@@ -78,6 +86,14 @@ int av1_get_mvpred_mask_var(const MACROBLOCK *x, const MV *best_mv,
 struct AV1_COMP;
 struct SPEED_FEATURES;
 
+// Replaces the full pixel start point 'mvp_full' of a motion search by the
+// full pixel position of 'hint_mv' (in 1/8 pel) when the sad plus mv cost is
+// lower there. Returns 1 if the hint was taken.
+int av1_pick_hinted_start_mv(const MACROBLOCK *x,
+                             const aom_variance_fn_ptr_t *fn_ptr,
+                             const MV *hint_mv, const MV *ref_mv,
+                             int sad_per_bit, MV *mvp_full);
+
 int av1_init_search_range(int size);
 
 int av1_refining_search_sad(struct macroblock *x, MV *ref_mv, int sad_per_bit,
@@ -281,6 +281,6 @@ void av1_temporal_filter_apply_msa(uint8_t *frame1_ptr, uint32_t stride,
                                      filt_wgt, accu, cnt);
   } else {
     av1_temporal_filter_apply_c(frame1_ptr, stride, frame2_ptr, blk_w, blk_h,
-                                strength, filt_wgt, accu, cnt);
+                                strength, &filt_wgt, 1, accu, cnt);
   }
 }
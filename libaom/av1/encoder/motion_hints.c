@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string.h>
+
+#include "aom_mem/aom_mem.h"
+
+#include "av1/encoder/encoder.h"
+#include "av1/encoder/motion_hints.h"
+
+// Log2 of the size of a hint block in mi units.
+#define HINT_MI_SIZE_LOG2 (4 - MI_SIZE_LOG2)
+
+static int alloc_motion_hints(MOTION_HINTS *hints, int mb_rows, int mb_cols) {
+  const size_t num_mbs = (size_t)mb_rows * mb_cols;
+  if (hints->mb_rows == mb_rows && hints->mb_cols == mb_cols &&
+      hints->block_size_log2 != NULL)
+    return 0;
+
+  av1_free_motion_hints(hints);
+  for (int i = 0; i < INTER_REFS_PER_FRAME; ++i) {
+    hints->mvs[i] = (int_mv *)aom_malloc(num_mbs * sizeof(*hints->mvs[i]));
+    if (!hints->mvs[i]) return -1;
+  }
+  hints->block_size_log2 = (uint8_t *)aom_calloc(num_mbs, 1);
+  if (!hints->block_size_log2) return -1;
+  hints->mb_rows = mb_rows;
+  hints->mb_cols = mb_cols;
+  return 0;
+}
+
+int av1_set_motion_hints(AV1_COMP *cpi, const aom_motion_hints_t *hints) {
+  const AV1_COMMON *const cm = &cpi->common;
+  MOTION_HINTS *const mh = &cpi->motion_hints;
+
+  mh->enabled = 0;
+  if (!hints) return 0;
+  if ((int)hints->rows != cm->mb_rows || (int)hints->cols != cm->mb_cols)
+    return -1;
+  if (alloc_motion_hints(mh, cm->mb_rows, cm->mb_cols)) {
+    av1_free_motion_hints(mh);
+    return -1;
+  }
+
+  const int num_mbs = cm->mb_rows * cm->mb_cols;
+  for (int i = 0; i < INTER_REFS_PER_FRAME; ++i) {
+    const aom_mv_hint_t *const src = hints->mvs[i];
+    mh->has_mvs[i] = src != NULL;
+    if (!src) continue;
+    for (int j = 0; j < num_mbs; ++j) {
+      if (src[j].valid) {
+        mh->mvs[i][j].as_mv.row = src[j].row;
+        mh->mvs[i][j].as_mv.col = src[j].col;
+      } else {
+        mh->mvs[i][j].as_int = INVALID_MV;
+      }
+    }
+  }
+
+  mh->has_block_sizes = hints->block_size_log2 != NULL;
+  if (mh->has_block_sizes) {
+    for (int j = 0; j < num_mbs; ++j) {
+      const int size_log2 = hints->block_size_log2[j];
+      mh->block_size_log2[j] = size_log2 < 3 || size_log2 > 7 ? 0 : size_log2;
+    }
+  }
+  mh->enabled = 1;
+  return 0;
+}
+
+void av1_free_motion_hints(MOTION_HINTS *hints) {
+  for (int i = 0; i < INTER_REFS_PER_FRAME; ++i) {
+    aom_free(hints->mvs[i]);
+    hints->mvs[i] = NULL;
+    hints->has_mvs[i] = 0;
+  }
+  aom_free(hints->block_size_log2);
+  hints->block_size_log2 = NULL;
+  hints->has_block_sizes = 0;
+  hints->mb_rows = hints->mb_cols = 0;
+  hints->enabled = 0;
+}
+
+int av1_get_motion_hint(const MOTION_HINTS *hints,
+                        MV_REFERENCE_FRAME ref_frame, int mi_row, int mi_col,
+                        BLOCK_SIZE bsize, MV *mv) {
+  if (!hints->enabled || ref_frame < LAST_FRAME || ref_frame > ALTREF_FRAME)
+    return 0;
+  const int ref_idx = ref_frame - LAST_FRAME;
+  if (!hints->has_mvs[ref_idx]) return 0;
+
+  const int mb_row = AOMMIN((mi_row + mi_size_high[bsize] / 2) >>
+                                HINT_MI_SIZE_LOG2,
+                            hints->mb_rows - 1);
+  const int mb_col = AOMMIN((mi_col + mi_size_wide[bsize] / 2) >>
+                                HINT_MI_SIZE_LOG2,
+                            hints->mb_cols - 1);
+  const int_mv hint = hints->mvs[ref_idx][mb_row * hints->mb_cols + mb_col];
+  if (hint.as_int == INVALID_MV) return 0;
+  *mv = hint.as_mv;
+  return 1;
+}
+
+void av1_motion_hints_prune_partition(const MOTION_HINTS *hints, int mi_row,
+                                      int mi_col, BLOCK_SIZE bsize,
+                                      int *partition_none_allowed,
+                                      int *do_square_split) {
+  if (!hints->enabled || !hints->has_block_sizes) return;
+
+  const int mb_row_start = mi_row >> HINT_MI_SIZE_LOG2;
+  const int mb_col_start = mi_col >> HINT_MI_SIZE_LOG2;
+  const int mb_row_end =
+      AOMMIN((mi_row + mi_size_high[bsize] - 1) >> HINT_MI_SIZE_LOG2,
+             hints->mb_rows - 1);
+  const int mb_col_end =
+      AOMMIN((mi_col + mi_size_wide[bsize] - 1) >> HINT_MI_SIZE_LOG2,
+             hints->mb_cols - 1);
+  int min_size_log2 = INT_MAX;
+  int max_size_log2 = 0;
+  for (int r = mb_row_start; r <= mb_row_end; ++r) {
+    for (int c = mb_col_start; c <= mb_col_end; ++c) {
+      const int size_log2 = hints->block_size_log2[r * hints->mb_cols + c];
+      if (!size_log2) continue;
+      min_size_log2 = AOMMIN(min_size_log2, size_log2);
+      max_size_log2 = AOMMAX(max_size_log2, size_log2);
+    }
+  }
+  if (!max_size_log2) return;
+
+  // Keep at least one of the two square partitions.
+  const int bsize_log2 = mi_size_wide_log2[bsize] + MI_SIZE_LOG2;
+  if (max_size_log2 < bsize_log2 && *do_square_split)
+    *partition_none_allowed = 0;
+  if (min_size_log2 >= bsize_log2 && *partition_none_allowed)
+    *do_square_split = 0;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_AV1_ENCODER_MOTION_HINTS_H_
+#define AOM_AV1_ENCODER_MOTION_HINTS_H_
+
+#include "aom/aomcx.h"
+
+#include "av1/common/enums.h"
+#include "av1/common/mv.h"
+#include "av1/encoder/mcomp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Step parameter of full pixel searches started from a hinted mv, i.e. a
+// search range of a few pixels around the hint.
+#define MOTION_HINT_STEP_PARAM (MAX_MVSEARCH_STEPS - 3)
+
+// Externally supplied motion and partition hints of the next coded frame, on
+// the 16x16 grid of the frame.
+typedef struct {
+  int enabled;
+  int mb_rows;
+  int mb_cols;
+  // Hinted mv into each reference in 1/8 pel, INVALID_MV if there is none.
+  int_mv *mvs[INTER_REFS_PER_FRAME];
+  int has_mvs[INTER_REFS_PER_FRAME];
+  // Hinted block width as log2 of the width in pixels, 0 if there is none.
+  uint8_t *block_size_log2;
+  int has_block_sizes;
+} MOTION_HINTS;
+
+struct AV1_COMP;
+
+// Copies the hints for the next coded frame. NULL clears them. Returns -1 if
+// the hint grid does not match the frame size.
+int av1_set_motion_hints(struct AV1_COMP *cpi,
+                         const aom_motion_hints_t *hints);
+
+void av1_free_motion_hints(MOTION_HINTS *hints);
+
+// Gets the hinted mv of the block at (mi_row, mi_col) into 'ref_frame', taken
+// from the 16x16 block at its center. Returns 0 if there is no hint.
+int av1_get_motion_hint(const MOTION_HINTS *hints,
+                        MV_REFERENCE_FRAME ref_frame, int mi_row, int mi_col,
+                        BLOCK_SIZE bsize, MV *mv);
+
+// Prunes the square partitions of the block at (mi_row, mi_col) against the
+// hinted block sizes it covers: PARTITION_NONE when all of them are smaller
+// than the block, PARTITION_SPLIT when none of them is.
+void av1_motion_hints_prune_partition(const MOTION_HINTS *hints, int mi_row,
+                                      int mi_col, BLOCK_SIZE bsize,
+                                      int *partition_none_allowed,
+                                      int *do_square_split);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AV1_ENCODER_MOTION_HINTS_H_
@@ -0,0 +1,490 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <limits.h>
+#include <string.h>
+
+#include "config/aom_dsp_rtcd.h"
+#include "config/av1_rtcd.h"
+
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_ports/system_state.h"
+
+#include "av1/common/cfl.h"
+#include "av1/common/mvref_common.h"
+#include "av1/common/pred_common.h"
+#include "av1/common/reconinter.h"
+#include "av1/common/reconintra.h"
+#include "av1/common/seg_common.h"
+
+#include "av1/encoder/encodemv.h"
+#include "av1/encoder/encoder.h"
+#include "av1/encoder/mcomp.h"
+#include "av1/encoder/rd.h"
+#include "av1/encoder/rdopt.h"
+#include "av1/encoder/reconinter_enc.h"
+
+// The modes checked by the real-time mode decision, in the order they are
+// evaluated.
+typedef struct {
+  PREDICTION_MODE mode;
+  MV_REFERENCE_FRAME ref_frame;
+  THR_MODES mode_index;
+} REF_MODE;
+
+static const REF_MODE ref_mode_set[] = {
+  { NEARESTMV, LAST_FRAME, THR_NEARESTMV },
+  { NEARMV, LAST_FRAME, THR_NEARMV },
+  { GLOBALMV, LAST_FRAME, THR_GLOBALMV },
+  { NEWMV, LAST_FRAME, THR_NEWMV },
+  { NEARESTMV, GOLDEN_FRAME, THR_NEARESTG },
+  { NEARMV, GOLDEN_FRAME, THR_NEARG },
+  { GLOBALMV, GOLDEN_FRAME, THR_GLOBALG },
+  { NEWMV, GOLDEN_FRAME, THR_NEWG },
+  { NEARESTMV, ALTREF_FRAME, THR_NEARESTA },
+  { NEARMV, ALTREF_FRAME, THR_NEARA },
+  { GLOBALMV, ALTREF_FRAME, THR_GLOBALA },
+  { NEWMV, ALTREF_FRAME, THR_NEWA },
+};
+
+typedef struct {
+  MB_MODE_INFO mbmi;
+  int mode_index;
+  int skip;
+  RD_STATS rd_stats;
+} BEST_PICKMODE;
+
+static void init_mbmi(MB_MODE_INFO *mbmi, PREDICTION_MODE mode,
+                      MV_REFERENCE_FRAME ref_frame, const AV1_COMMON *cm) {
+  PALETTE_MODE_INFO *const pmi = &mbmi->palette_mode_info;
+  mbmi->mode = mode;
+  mbmi->uv_mode = UV_DC_PRED;
+  mbmi->ref_frame[0] = ref_frame;
+  mbmi->ref_frame[1] = NONE_FRAME;
+  mbmi->ref_mv_idx = 0;
+  mbmi->mv[0].as_int = mbmi->mv[1].as_int = 0;
+  mbmi->motion_mode = SIMPLE_TRANSLATION;
+  mbmi->interintra_mode = (INTERINTRA_MODE)(II_DC_PRED - 1);
+  mbmi->interinter_comp.type = COMPOUND_AVERAGE;
+  mbmi->comp_group_idx = 0;
+  mbmi->compound_idx = 1;
+  mbmi->angle_delta[PLANE_TYPE_Y] = 0;
+  mbmi->angle_delta[PLANE_TYPE_UV] = 0;
+  mbmi->use_intrabc = 0;
+  mbmi->filter_intra_mode_info.use_filter_intra = 0;
+  pmi->palette_size[0] = 0;
+  pmi->palette_size[1] = 0;
+  set_default_interp_filters(mbmi, cm->interp_filter);
+}
+
+// Sets the transform size the block will be coded with. There is no transform
+// search, so this is the largest one the frame transform mode allows.
+static void set_tx_size(const AV1_COMMON *cm, const MACROBLOCKD *xd,
+                        MB_MODE_INFO *mbmi, BLOCK_SIZE bsize) {
+  if (xd->lossless[mbmi->segment_id])
+    mbmi->tx_size = TX_4X4;
+  else
+    mbmi->tx_size = tx_size_from_tx_mode(bsize, cm->tx_mode);
+  memset(mbmi->inter_tx_size, mbmi->tx_size, sizeof(mbmi->inter_tx_size));
+  memset(mbmi->txk_type, DCT_DCT, sizeof(mbmi->txk_type[0]) * TXK_TYPE_BUF_LEN);
+}
+
+// Estimates the rate and distortion of coding the residual of one plane from
+// its variance, with separate models for the DC and AC coefficients. skip is
+// set when the model predicts that no coefficient survives quantization.
+static void model_rd_for_plane(const AV1_COMP *cpi, const MACROBLOCK *x,
+                               BLOCK_SIZE bsize, int plane, int *rate,
+                               int64_t *dist, int *skip, unsigned int *sse) {
+  const MACROBLOCKD *const xd = &x->e_mbd;
+  const struct macroblock_plane *const p = &x->plane[plane];
+  const struct macroblockd_plane *const pd = &xd->plane[plane];
+  const BLOCK_SIZE plane_bsize =
+      get_plane_block_size(bsize, pd->subsampling_x, pd->subsampling_y);
+  const int dequant_shift = is_cur_buf_hbd(xd) ? xd->bd - 5 : 3;
+  const int num_pels_log2 = num_pels_log2_lookup[plane_bsize];
+  int dc_rate, ac_rate;
+  int64_t dc_dist, ac_dist;
+
+  const unsigned int var = cpi->fn_ptr[plane_bsize].vf(
+      p->src.buf, p->src.stride, pd->dst.buf, pd->dst.stride, sse);
+  av1_model_rd_from_var_lapndz(*sse - var, num_pels_log2,
+                               pd->dequant_Q3[0] >> dequant_shift, &dc_rate,
+                               &dc_dist);
+  av1_model_rd_from_var_lapndz(var, num_pels_log2,
+                               pd->dequant_Q3[1] >> dequant_shift, &ac_rate,
+                               &ac_dist);
+  *rate = dc_rate + ac_rate;
+  *dist = (dc_dist + ac_dist) << 4;
+  *skip = *rate == 0;
+}
+
+// Returns 1 when the source block barely changed since the previous source
+// frame, in which case only zero motion on LAST_FRAME is worth checking.
+static int is_static_block(const AV1_COMP *cpi, const MACROBLOCK *x,
+                           BLOCK_SIZE bsize, int mi_row, int mi_col) {
+  const AV1_COMMON *const cm = &cpi->common;
+  const MACROBLOCKD *const xd = &x->e_mbd;
+  const YV12_BUFFER_CONFIG *const last_source = cpi->last_source;
+  const int dequant_shift = is_cur_buf_hbd(xd) ? xd->bd - 5 : 3;
+
+  // With spatial layers the previous source may belong to the same
+  // superframe, so it says nothing about the motion since the reference.
+  if (cpi->use_svc || last_source == NULL ||
+      last_source->y_crop_width != cm->width ||
+      last_source->y_crop_height != cm->height ||
+      !(cpi->ref_frame_flags & av1_ref_frame_flag_list[LAST_FRAME]) ||
+      cm->global_motion[LAST_FRAME].wmtype != IDENTITY) {
+    return 0;
+  }
+  const uint8_t *const last_src =
+      last_source->y_buffer + mi_row * MI_SIZE * last_source->y_stride +
+      mi_col * MI_SIZE;
+  const unsigned int sad =
+      cpi->fn_ptr[bsize].sdf(x->plane[0].src.buf, x->plane[0].src.stride,
+                             last_src, last_source->y_stride);
+  const int qstep = xd->plane[0].dequant_Q3[1] >> dequant_shift;
+  // Static when the mean absolute difference is below 1/64 of the step.
+  return ((int64_t)sad << 6) < ((int64_t)qstep << num_pels_log2_lookup[bsize]);
+}
+
+static void setup_ref_mvs(const AV1_COMP *cpi, MACROBLOCK *x,
+                          MV_REFERENCE_FRAME ref_frame, int mi_row,
+                          int mi_col,
+                          struct buf_2d yv12_mb[MAX_MB_PLANE],
+                          int_mv frame_mv[MB_MODE_COUNT]) {
+  const AV1_COMMON *const cm = &cpi->common;
+  MACROBLOCKD *const xd = &x->e_mbd;
+  MB_MODE_INFO *const mbmi = xd->mi[0];
+  MB_MODE_INFO_EXT *const mbmi_ext = x->mbmi_ext;
+  const YV12_BUFFER_CONFIG *yv12 = get_ref_frame_yv12_buf(cm, ref_frame);
+  const struct scale_factors *const sf =
+      get_ref_scale_factors_const(cm, ref_frame);
+
+  assert(yv12 != NULL);
+  av1_setup_pred_block(xd, yv12_mb, yv12, mi_row, mi_col, sf, sf,
+                       av1_num_planes(cm));
+  mbmi->ref_frame[0] = ref_frame;
+  mbmi->ref_frame[1] = NONE_FRAME;
+  av1_find_mv_refs(cm, xd, mbmi, ref_frame, mbmi_ext->ref_mv_count,
+                   mbmi_ext->ref_mv_stack, NULL, mbmi_ext->global_mvs, mi_row,
+                   mi_col, mbmi_ext->mode_context);
+  av1_find_best_ref_mvs_from_stack(cm->allow_high_precision_mv, mbmi_ext,
+                                   ref_frame, &frame_mv[NEARESTMV],
+                                   &frame_mv[NEARMV],
+                                   cm->cur_frame_force_integer_mv);
+  frame_mv[GLOBALMV] = mbmi_ext->global_mvs[ref_frame];
+  frame_mv[NEWMV].as_int = INVALID_MV;
+}
+
+// Full pixel search around the first reference mv followed by sub-pixel
+// refinement. Returns 0 when no mv could be found.
+static int search_new_mv(const AV1_COMP *cpi, MACROBLOCK *x, BLOCK_SIZE bsize,
+                         int mi_row, int mi_col, int_mv *new_mv,
+                         int *rate_mv) {
+  const AV1_COMMON *const cm = &cpi->common;
+  MACROBLOCKD *const xd = &x->e_mbd;
+  const MV_REFERENCE_FRAME ref = xd->mi[0]->ref_frame[0];
+  const MV ref_mv = av1_get_ref_mv(x, 0).as_mv;
+  const MvLimits tmp_mv_limits = x->mv_limits;
+  MV mvp_full = ref_mv;
+  int step_param = cpi->mv_step_param;
+  int cost_list[5];
+  MV hint_mv;
+
+  av1_set_mv_search_range(&x->mv_limits, &ref_mv);
+  mvp_full.col >>= 3;
+  mvp_full.row >>= 3;
+  if (av1_get_motion_hint(&cpi->motion_hints, ref, mi_row, mi_col, bsize,
+                          &hint_mv) &&
+      av1_pick_hinted_start_mv(x, &cpi->fn_ptr[bsize], &hint_mv, &ref_mv,
+                               x->sadperbit16, &mvp_full))
+    step_param = AOMMAX(step_param, MOTION_HINT_STEP_PARAM);
+  x->best_mv.as_int = x->second_best_mv.as_int = INVALID_MV;
+  const int bestsme = av1_full_pixel_search(
+      cpi, x, bsize, &mvp_full, step_param, cpi->sf.mv.search_method, 0,
+      x->sadperbit16, cond_cost_list(cpi, cost_list), &ref_mv, INT_MAX, 1,
+      MI_SIZE * mi_col, MI_SIZE * mi_row, 0, &cpi->ss_cfg[SS_CFG_SRC]);
+  x->mv_limits = tmp_mv_limits;
+  if (bestsme == INT_MAX) return 0;
+
+  if (cm->cur_frame_force_integer_mv) {
+    x->best_mv.as_mv.row *= 8;
+    x->best_mv.as_mv.col *= 8;
+  } else {
+    int dis;
+    cpi->find_fractional_mv_step(
+        x, cm, mi_row, mi_col, &ref_mv, cm->allow_high_precision_mv,
+        x->errorperbit, &cpi->fn_ptr[bsize], cpi->sf.mv.subpel_force_stop,
+        cpi->sf.mv.subpel_iters_per_step, cond_cost_list(cpi, cost_list),
+        x->nmv_vec_cost, x->mv_cost_stack, &dis, &x->pred_sse[ref], NULL, NULL,
+        0, 0, 0, 0, 0, 1);
+  }
+  *new_mv = x->best_mv;
+  *rate_mv = av1_mv_bit_cost(&new_mv->as_mv, &ref_mv, x->nmv_vec_cost,
+                             x->mv_cost_stack, MV_COST_WEIGHT);
+  return 1;
+}
+
+static int get_drl_cost(const MACROBLOCK *x, PREDICTION_MODE mode,
+                        MV_REFERENCE_FRAME ref_frame) {
+  const MB_MODE_INFO_EXT *const mbmi_ext = x->mbmi_ext;
+  // With ref_mv_idx 0, NEWMV signals the first drl index and NEARMV the second.
+  const int idx = mode == NEARMV;
+  if (mbmi_ext->ref_mv_count[ref_frame] <= idx + 1) return 0;
+  const uint8_t drl_ctx = av1_drl_ctx(mbmi_ext->ref_mv_stack[ref_frame], idx);
+  return x->drl_mode_cost0[drl_ctx][0];
+}
+
+// Estimates the cost of DC_PRED. The prediction of each transform block is
+// built from the reconstruction around it, which inside the block is not
+// available yet, so this is only an approximation of the final prediction.
+static void estimate_intra_dc(const AV1_COMP *cpi, MACROBLOCK *x,
+                              BLOCK_SIZE bsize, int ref_frame_cost,
+                              RD_STATS *rd_stats) {
+  const AV1_COMMON *const cm = &cpi->common;
+  MACROBLOCKD *const xd = &x->e_mbd;
+  struct macroblockd_plane *const pd = &xd->plane[0];
+  const TX_SIZE tx_size = max_txsize_rect_lookup[bsize];
+  const int max_blocks_wide = max_block_wide(xd, bsize, 0);
+  const int max_blocks_high = max_block_high(xd, bsize, 0);
+  unsigned int sse;
+  int skip;
+
+  for (int row = 0; row < max_blocks_high; row += tx_size_high_unit[tx_size]) {
+    for (int col = 0; col < max_blocks_wide;
+         col += tx_size_wide_unit[tx_size]) {
+      uint8_t *const dst =
+          &pd->dst.buf[(row * pd->dst.stride + col) << tx_size_wide_log2[0]];
+      av1_predict_intra_block(cm, xd, pd->width, pd->height, tx_size, DC_PRED,
+                              0, 0, FILTER_INTRA_MODES, dst, pd->dst.stride,
+                              dst, pd->dst.stride, col, row, 0);
+    }
+  }
+  model_rd_for_plane(cpi, x, bsize, 0, &rd_stats->rate, &rd_stats->dist, &skip,
+                     &sse);
+  rd_stats->rate += ref_frame_cost +
+                    x->mbmode_cost[size_group_lookup[bsize]][DC_PRED] +
+                    x->skip_cost[av1_get_skip_context(xd)][0];
+  if (!x->skip_chroma_rd) {
+    rd_stats->rate +=
+        x->intra_uv_mode_cost[is_cfl_allowed(xd)][DC_PRED][UV_DC_PRED];
+  }
+  rd_stats->sse = sse;
+  rd_stats->rdcost = RDCOST(x->rdmult, rd_stats->rate, rd_stats->dist);
+}
+
+// Checks whether the chroma residual of the inter prediction is also expected
+// to quantize to zero, and adds its modeled cost to rd_stats otherwise.
+static int chroma_skippable(const AV1_COMP *cpi, MACROBLOCK *x,
+                            BLOCK_SIZE bsize, int mi_row, int mi_col,
+                            RD_STATS *rd_stats) {
+  const AV1_COMMON *const cm = &cpi->common;
+  const int num_planes = av1_num_planes(cm);
+  MACROBLOCKD *const xd = &x->e_mbd;
+  int rate_uv = 0;
+  int64_t dist_uv = 0;
+  int skip = 1;
+
+  if (num_planes == 1 || x->skip_chroma_rd) return 1;
+  av1_enc_build_inter_predictor(cm, xd, mi_row, mi_col, NULL, bsize,
+                                AOM_PLANE_U, num_planes - 1);
+  for (int plane = AOM_PLANE_U; plane < num_planes; ++plane) {
+    int rate, plane_skip;
+    int64_t dist;
+    unsigned int sse;
+    model_rd_for_plane(cpi, x, bsize, plane, &rate, &dist, &plane_skip, &sse);
+    rate_uv += rate;
+    dist_uv += dist;
+    skip &= plane_skip;
+  }
+  if (!skip) {
+    const int skip_ctx = av1_get_skip_context(xd);
+    rd_stats->rate +=
+        rate_uv + x->skip_cost[skip_ctx][0] - x->skip_cost[skip_ctx][1];
+    rd_stats->dist += dist_uv;
+    rd_stats->rdcost = RDCOST(x->rdmult, rd_stats->rate, rd_stats->dist);
+  }
+  return skip;
+}
+
+void av1_fast_nonrd_pick_inter_mode_sb(AV1_COMP *cpi, TileDataEnc *tile_data,
+                                       MACROBLOCK *x, int mi_row, int mi_col,
+                                       RD_STATS *rd_cost, BLOCK_SIZE bsize,
+                                       PICK_MODE_CONTEXT *ctx,
+                                       int64_t best_rd_so_far) {
+  AV1_COMMON *const cm = &cpi->common;
+  const int num_planes = av1_num_planes(cm);
+  MACROBLOCKD *const xd = &x->e_mbd;
+  MB_MODE_INFO *const mbmi = xd->mi[0];
+  const struct segmentation *const seg = &cm->seg;
+  const int segment_id = mbmi->segment_id;
+  const int seg_ref_active =
+      segfeature_active(seg, segment_id, SEG_LVL_REF_FRAME);
+  const int seg_ref =
+      seg_ref_active ? get_segdata(seg, segment_id, SEG_LVL_REF_FRAME) : 0;
+  struct buf_2d yv12_mb[REF_FRAMES][MAX_MB_PLANE];
+  int_mv frame_mv[REF_FRAMES][MB_MODE_COUNT];
+  unsigned int ref_costs_single[REF_FRAMES];
+  unsigned int ref_costs_comp[REF_FRAMES][REF_FRAMES];
+  int ref_available[REF_FRAMES] = { 0 };
+  BEST_PICKMODE best;
+  const int comp_inter_cost =
+      cm->current_frame.reference_mode == REFERENCE_MODE_SELECT
+          ? x->comp_inter_cost[av1_get_reference_mode_context(xd)][0]
+          : 0;
+  const int skip_ctx = av1_get_skip_context(xd);
+  const int is_static = is_static_block(cpi, x, bsize, mi_row, mi_col);
+  (void)tile_data;
+
+  aom_clear_system_state();
+  av1_invalid_rd_stats(rd_cost);
+  av1_invalid_rd_stats(&best.rd_stats);
+  best.mode_index = -1;
+  best.skip = 0;
+
+  av1_collect_neighbors_ref_counts(xd);
+  av1_estimate_ref_frame_costs(cm, xd, x, segment_id, ref_costs_single,
+                               ref_costs_comp);
+  av1_count_overlappable_neighbors(cm, xd, mi_row, mi_col);
+
+  for (MV_REFERENCE_FRAME ref_frame = LAST_FRAME; ref_frame <= ALTREF_FRAME;
+       ++ref_frame) {
+    x->pred_sse[ref_frame] = INT_MAX;
+    if (ref_frame != LAST_FRAME && ref_frame != GOLDEN_FRAME &&
+        ref_frame != ALTREF_FRAME) {
+      continue;
+    }
+    if (!(cpi->ref_frame_flags & av1_ref_frame_flag_list[ref_frame])) continue;
+    if (seg_ref_active && seg_ref != ref_frame) continue;
+    if (is_static && ref_frame != LAST_FRAME) continue;
+    setup_ref_mvs(cpi, x, ref_frame, mi_row, mi_col, yv12_mb[ref_frame],
+                  frame_mv[ref_frame]);
+    ref_available[ref_frame] = 1;
+  }
+
+  for (int idx = 0; idx < (int)(sizeof(ref_mode_set) / sizeof(*ref_mode_set));
+       ++idx) {
+    const PREDICTION_MODE this_mode = ref_mode_set[idx].mode;
+    const MV_REFERENCE_FRAME ref_frame = ref_mode_set[idx].ref_frame;
+    int_mv *const mode_mv = frame_mv[ref_frame];
+    RD_STATS this_rdc;
+    int this_skip;
+    int rate_mv = 0;
+    unsigned int sse;
+
+    if (!ref_available[ref_frame]) continue;
+    // Static blocks only check zero motion.
+    if (is_static && (this_mode == NEWMV || mode_mv[this_mode].as_int != 0))
+      continue;
+    if (this_mode == NEARMV &&
+        mode_mv[NEARMV].as_int == mode_mv[NEARESTMV].as_int) {
+      continue;
+    }
+
+    init_mbmi(mbmi, this_mode, ref_frame, cm);
+    set_ref_ptrs(cm, xd, ref_frame, NONE_FRAME);
+    for (int i = 0; i < num_planes; ++i)
+      xd->plane[i].pre[0] = yv12_mb[ref_frame][i];
+
+    if (this_mode == NEWMV) {
+      // The motion search does not support scaled references.
+      if (av1_get_scaled_ref_frame(cpi, ref_frame) != NULL) continue;
+      if (!search_new_mv(cpi, x, bsize, mi_row, mi_col, &mode_mv[NEWMV],
+                         &rate_mv)) {
+        continue;
+      }
+      if (mode_mv[NEWMV].as_int == mode_mv[NEARESTMV].as_int) continue;
+    }
+    mbmi->mv[0].as_int = mode_mv[this_mode].as_int;
+
+    av1_enc_build_inter_predictor(cm, xd, mi_row, mi_col, NULL, bsize,
+                                  AOM_PLANE_Y, AOM_PLANE_Y);
+    model_rd_for_plane(cpi, x, bsize, AOM_PLANE_Y, &this_rdc.rate,
+                       &this_rdc.dist, &this_skip, &sse);
+    x->pred_sse[ref_frame] = AOMMIN(x->pred_sse[ref_frame], sse);
+
+    const int16_t mode_ctx =
+        av1_mode_context_analyzer(x->mbmi_ext->mode_context, mbmi->ref_frame);
+    this_rdc.rate += rate_mv + av1_cost_mv_ref(x, this_mode, mode_ctx) +
+                     get_drl_cost(x, this_mode, ref_frame) +
+                     ref_costs_single[ref_frame] + comp_inter_cost +
+                     av1_get_switchable_rate(cm, x, xd) +
+                     x->skip_cost[skip_ctx][this_skip];
+    this_rdc.sse = sse;
+    this_rdc.rdcost = RDCOST(x->rdmult, this_rdc.rate, this_rdc.dist);
+
+    if (this_rdc.rdcost < best.rd_stats.rdcost) {
+      best.rd_stats = this_rdc;
+      best.mbmi = *mbmi;
+      best.mode_index = ref_mode_set[idx].mode_index;
+      best.skip = this_skip;
+      // No residual is left to code, a later mode can not do much better.
+      if (this_skip) break;
+    }
+  }
+
+  // Intra is only worth checking when the inter prediction error is larger
+  // than the variance of the source block.
+  if ((!seg_ref_active || seg_ref == INTRA_FRAME) && !is_static &&
+      (best.mode_index < 0 ||
+       (!best.skip && (best.rd_stats.sse >> num_pels_log2_lookup[bsize]) >
+                          x->source_variance))) {
+    RD_STATS this_rdc;
+    init_mbmi(mbmi, DC_PRED, INTRA_FRAME, cm);
+    set_ref_ptrs(cm, xd, INTRA_FRAME, NONE_FRAME);
+    estimate_intra_dc(cpi, x, bsize, ref_costs_single[INTRA_FRAME], &this_rdc);
+    if (this_rdc.rdcost < best.rd_stats.rdcost) {
+      best.rd_stats = this_rdc;
+      best.mbmi = *mbmi;
+      best.mode_index = THR_DC;
+      best.skip = 0;
+    }
+  }
+
+  if (best.mode_index < 0 || best.rd_stats.rdcost >= best_rd_so_far) {
+    rd_cost->rate = INT_MAX;
+    rd_cost->rdcost = INT64_MAX;
+    return;
+  }
+
+  *mbmi = best.mbmi;
+  set_tx_size(cm, xd, mbmi, bsize);
+  if (is_inter_block(mbmi)) {
+    set_ref_ptrs(cm, xd, mbmi->ref_frame[0], NONE_FRAME);
+    for (int i = 0; i < num_planes; ++i)
+      xd->plane[i].pre[0] = yv12_mb[mbmi->ref_frame[0]][i];
+    if (is_motion_variation_allowed_bsize(bsize)) {
+      int pts[SAMPLES_ARRAY_SIZE], pts_inref[SAMPLES_ARRAY_SIZE];
+      mbmi->num_proj_ref = findSamples(cm, xd, mi_row, mi_col, pts, pts_inref);
+    }
+    // The residual is only dropped without coding it where the source did not
+    // change. Elsewhere the quantizer decides, as the model is not exact.
+    if (best.skip && is_static)
+      best.skip = chroma_skippable(cpi, x, bsize, mi_row, mi_col,
+                                   &best.rd_stats);
+    else
+      best.skip = 0;
+  }
+
+  x->skip = best.skip;
+  memset(x->blk_skip, 0, sizeof(x->blk_skip[0]) * ctx->num_4x4_blk);
+  memset(ctx->blk_skip, 0, sizeof(ctx->blk_skip[0]) * ctx->num_4x4_blk);
+  ctx->skip = x->skip;
+  ctx->skippable = x->skip;
+  ctx->best_mode_index = best.mode_index;
+  ctx->mic = *mbmi;
+  ctx->mbmi_ext = *x->mbmi_ext;
+  ctx->single_pred_diff = 0;
+  ctx->comp_pred_diff = 0;
+  ctx->hybrid_pred_diff = 0;
+  *rd_cost = best.rd_stats;
+}
@@ -772,6 +772,9 @@ static void define_gf_group(AV1_COMP *cpi, FIRSTPASS_STATS *this_frame,
   const int is_intra_only = frame_params->frame_type == KEY_FRAME ||
                             frame_params->frame_type == INTRA_ONLY_FRAME;
   const int arf_active_or_kf = is_intra_only || rc->source_alt_ref_active;
+  ANALYSIS_GF_DECISION cached_decision;
+  const int have_cached_decision =
+      av1_analysis_cache_load_gf_group(cpi, &cached_decision);
 
   cpi->internal_altref_allowed = (oxcf->gf_max_pyr_height > 1);
 
@@ -911,7 +914,7 @@ static void define_gf_group(AV1_COMP *cpi, FIRSTPASS_STATS *this_frame,
     cpi->internal_altref_allowed = 0;
   }
 
-  const int use_alt_ref =
+  int use_alt_ref =
       !is_almost_static(zero_motion_accumulator, twopass->kf_zeromotion_pct) &&
       allow_alt_ref && (i < cpi->oxcf.lag_in_frames) &&
       (i >= rc->min_gf_interval) &&
@@ -928,7 +931,20 @@ static void define_gf_group(AV1_COMP *cpi, FIRSTPASS_STATS *this_frame,
        !cpi->internal_altref_allowed) &&
       !is_lossless_requested(&cpi->oxcf);
 
-  if (allow_gf_length_reduction && use_alt_ref) {
+  // The rate target dependent decisions of the encode that wrote the
+  // analysis cache replace those of this encode, so that both code the same
+  // gf group structure.
+  const int use_cached_decision =
+      have_cached_decision && cached_decision.max_length == i;
+  ANALYSIS_GF_DECISION decision;
+  decision.max_length = i;
+
+  if (use_cached_decision) {
+    use_alt_ref = cached_decision.use_alt_ref;
+    cpi->internal_altref_allowed = cached_decision.internal_altref_allowed;
+    alt_offset = cached_decision.alt_offset;
+    i += alt_offset;
+  } else if (allow_gf_length_reduction && use_alt_ref) {
     // adjust length of this gf group if one of the following condition met
     // 1: only one overlay frame left and this gf is too long
     // 2: next gf group is too short to have arf compared to the current gf
@@ -954,6 +970,13 @@ static void define_gf_group(AV1_COMP *cpi, FIRSTPASS_STATS *this_frame,
     }
   }
 
+  if (!use_cached_decision) {
+    decision.alt_offset = alt_offset;
+    decision.use_alt_ref = use_alt_ref;
+    decision.internal_altref_allowed = cpi->internal_altref_allowed;
+    av1_analysis_cache_store_gf_group(cpi, &decision);
+  }
+
   // Should we use the alternate reference frame.
   if (use_alt_ref) {
     // Calculate the boost for alt ref.
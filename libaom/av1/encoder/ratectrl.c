@@ -31,6 +31,7 @@
 #include "av1/encoder/encodemv.h"
 #include "av1/encoder/encode_strategy.h"
 #include "av1/encoder/gop_structure.h"
+#include "av1/encoder/lookahead_analysis.h"
 #include "av1/encoder/random.h"
 #include "av1/encoder/ratectrl.h"
 
@@ -89,6 +90,8 @@ static int kf_low = 400;
 // How many times less pixels there are to encode given the current scaling.
 // Temporary replacement for rcf_mult and rate_thresh_mult.
 static double resize_rate_factor(const AV1_COMP *cpi, int width, int height) {
+  // Spatial layers are rate controlled at their own resolution.
+  if (cpi->use_svc) return 1.0;
   return (double)(cpi->oxcf.width * cpi->oxcf.height) / (width * height);
 }
 
@@ -226,6 +229,8 @@ static void update_buffer_level(AV1_COMP *cpi, int encoded_frame_size) {
   // Clip the buffer level to the maximum specified buffer size.
   rc->bits_off_target = AOMMIN(rc->bits_off_target, rc->maximum_buffer_size);
   rc->buffer_level = rc->bits_off_target;
+
+  if (cpi->use_svc) av1_update_layer_buffer_level(cpi, encoded_frame_size);
 }
 
 int av1_rc_get_default_min_gf_interval(int width, int height,
@@ -285,6 +290,7 @@ void av1_rc_init(const AV1EncoderConfig *oxcf, int pass, RATE_CONTROL *rc) {
   rc->frames_since_key = 8;  // Sensible default for first frame.
   rc->this_key_frame_forced = 0;
   rc->next_key_frame_forced = 0;
+  rc->lookahead_scene_cut = 0;
   rc->source_alt_ref_pending = 0;
   rc->source_alt_ref_active = 0;
 
@@ -1472,6 +1478,41 @@ void av1_rc_postencode_update_drop_frame(AV1_COMP *cpi) {
 // Use this macro to turn on/off use of alt-refs in one-pass mode.
 #define USE_ALTREF_FOR_ONE_PASS 1
 
+// Average inter to intra cost ratios of the lookahead analysis that map to
+// the gf_high and gf_low boosts.
+#define LOW_MOTION_INTER_RATIO 0.1
+#define HIGH_MOTION_INTER_RATIO 0.5
+
+// Sets the gf group length and boost of a group starting at this frame from
+// the lookahead analysis and moves the next key frame to a scene cut found in
+// the group. Returns 0 if there is no lookahead analysis.
+static int set_gf_interval_from_lookahead(AV1_COMP *cpi) {
+  RATE_CONTROL *const rc = &cpi->rc;
+  if (!av1_lookahead_analysis_enabled(cpi)) return 0;
+
+  if (cpi->oxcf.auto_key) {
+    const int scene_cut = av1_lookahead_find_scene_cut(
+        cpi->lookahead, AOMMIN(rc->frames_to_key - 1, rc->max_gf_interval));
+    if (scene_cut) {
+      rc->frames_to_key = scene_cut;
+      rc->lookahead_scene_cut = 1;
+    }
+  }
+
+  // The group stops at the next key frame, which may be a scene cut found
+  // while setting up an earlier group.
+  double inter_ratio;
+  rc->baseline_gf_interval = av1_lookahead_gf_interval(
+      cpi->lookahead, rc->min_gf_interval, rc->max_gf_interval,
+      rc->frames_to_key, &inter_ratio);
+  const double motion =
+      (inter_ratio - LOW_MOTION_INTER_RATIO) /
+      (HIGH_MOTION_INTER_RATIO - LOW_MOTION_INTER_RATIO);
+  rc->gfu_boost =
+      gf_high - (int)(fclamp(motion, 0.0, 1.0) * (gf_high - gf_low));
+  return 1;
+}
+
 static int calc_pframe_target_size_one_pass_vbr(
     const AV1_COMP *const cpi, FRAME_UPDATE_TYPE frame_update_type) {
   static const int af_ratio = 10;
@@ -1511,13 +1552,15 @@ void av1_rc_get_one_pass_vbr_params(AV1_COMP *cpi,
   int sframe_dist = cpi->oxcf.sframe_dist;
   int sframe_mode = cpi->oxcf.sframe_mode;
   int sframe_enabled = cpi->oxcf.sframe_enabled;
-  // TODO(yaowu): replace the "auto_key && 0" below with proper decision logic.
+  // Scene cuts found by the lookahead analysis arrive through frames_to_key.
   if (*frame_update_type != ARF_UPDATE &&
       (current_frame->frame_number == 0 || (frame_flags & FRAMEFLAGS_KEY) ||
-       rc->frames_to_key == 0 || (cpi->oxcf.auto_key && 0))) {
+       rc->frames_to_key == 0)) {
     frame_params->frame_type = KEY_FRAME;
-    rc->this_key_frame_forced =
-        current_frame->frame_number != 0 && rc->frames_to_key == 0;
+    rc->this_key_frame_forced = current_frame->frame_number != 0 &&
+                                rc->frames_to_key == 0 &&
+                                !rc->lookahead_scene_cut;
+    rc->lookahead_scene_cut = 0;
     rc->frames_to_key = cpi->oxcf.key_freq;
     rc->kf_boost = DEFAULT_KF_BOOST;
     rc->source_alt_ref_active = 0;
@@ -1556,7 +1599,10 @@ void av1_rc_get_one_pass_vbr_params(AV1_COMP *cpi,
     }
   }
   if (rc->frames_till_gf_update_due == 0) {
-    rc->baseline_gf_interval = (rc->min_gf_interval + rc->max_gf_interval) / 2;
+    rc->gfu_boost = DEFAULT_GF_BOOST;
+    if (!set_gf_interval_from_lookahead(cpi))
+      rc->baseline_gf_interval =
+          (rc->min_gf_interval + rc->max_gf_interval) / 2;
     rc->frames_till_gf_update_due = rc->baseline_gf_interval;
     // NOTE: frames_till_gf_update_due must be <= frames_to_key.
     if (rc->frames_till_gf_update_due > rc->frames_to_key) {
@@ -1567,7 +1613,6 @@ void av1_rc_get_one_pass_vbr_params(AV1_COMP *cpi,
     }
     if (*frame_update_type == LF_UPDATE) *frame_update_type = GF_UPDATE;
     rc->source_alt_ref_pending = USE_ALTREF_FOR_ONE_PASS;
-    rc->gfu_boost = DEFAULT_GF_BOOST;
   }
 
   if (cpi->oxcf.aq_mode == CYCLIC_REFRESH_AQ)
@@ -1603,6 +1648,15 @@ static int calc_pframe_target_size_one_pass_cbr(
   } else {
     target = rc->avg_frame_bandwidth;
   }
+  if (cpi->use_svc) {
+    // The layer avg_frame_bandwidth includes the frames of the lower temporal
+    // layers, so size the frame from the bandwidth of this layer alone.
+    const SVC *const svc = &cpi->svc;
+    const LAYER_CONTEXT *const lc = &svc->layer_context[av1_svc_layer_index(
+        svc, svc->spatial_layer_id, svc->temporal_layer_id)];
+    target = lc->avg_frame_size;
+    min_frame_target = AOMMAX(lc->avg_frame_size >> 4, FRAME_OVERHEAD_BITS);
+  }
 
   if (diff > 0) {
     // Lower the target bandwidth for this frame.
@@ -1650,22 +1704,36 @@ void av1_rc_get_one_pass_cbr_params(AV1_COMP *cpi,
   RATE_CONTROL *const rc = &cpi->rc;
   CurrentFrame *const current_frame = &cm->current_frame;
   int target;
-  // TODO(yaowu): replace the "auto_key && 0" below with proper decision logic.
-  if ((current_frame->frame_number == 0 || (frame_flags & FRAMEFLAGS_KEY) ||
-       rc->frames_to_key == 0 || (cpi->oxcf.auto_key && 0))) {
+  int key_frame;
+  if (cpi->use_svc) {
+    // Only the base spatial layer of a key superframe is intra coded; the
+    // layers above it predict from the layer below.
+    key_frame = cpi->svc.spatial_layer_id == 0 && cpi->svc.key_superframe;
+  } else {
+    // Scene cuts found by the lookahead analysis arrive through
+    // frames_to_key.
+    key_frame = current_frame->frame_number == 0 ||
+                (frame_flags & FRAMEFLAGS_KEY) || rc->frames_to_key == 0;
+  }
+  if (key_frame) {
     frame_params->frame_type = KEY_FRAME;
-    rc->this_key_frame_forced =
-        current_frame->frame_number != 0 && rc->frames_to_key == 0;
+    rc->this_key_frame_forced = current_frame->frame_number != 0 &&
+                                rc->frames_to_key == 0 &&
+                                !rc->lookahead_scene_cut;
+    rc->lookahead_scene_cut = 0;
     rc->frames_to_key = cpi->oxcf.key_freq;
     rc->kf_boost = DEFAULT_KF_BOOST;
     rc->source_alt_ref_active = 0;
   } else {
     frame_params->frame_type = INTER_FRAME;
   }
-  if (rc->frames_till_gf_update_due == 0) {
+  // With spatial layers the golden reference holds the layer below, so there
+  // are no golden frame updates.
+  if (!cpi->use_svc && rc->frames_till_gf_update_due == 0) {
+    rc->gfu_boost = DEFAULT_GF_BOOST;
     if (cpi->oxcf.aq_mode == CYCLIC_REFRESH_AQ)
       av1_cyclic_refresh_set_golden_update(cpi);
-    else
+    else if (!set_gf_interval_from_lookahead(cpi))
       rc->baseline_gf_interval =
           (rc->min_gf_interval + rc->max_gf_interval) / 2;
     rc->frames_till_gf_update_due = rc->baseline_gf_interval;
@@ -1673,7 +1741,6 @@ void av1_rc_get_one_pass_cbr_params(AV1_COMP *cpi,
     if (rc->frames_till_gf_update_due > rc->frames_to_key)
       rc->frames_till_gf_update_due = rc->frames_to_key;
     if (*frame_update_type == LF_UPDATE) *frame_update_type = GF_UPDATE;
-    rc->gfu_boost = DEFAULT_GF_BOOST;
   }
 
   // Any update/change of global cyclic refresh parameters (amount/delta-qp)
@@ -1686,7 +1753,18 @@ void av1_rc_get_one_pass_cbr_params(AV1_COMP *cpi,
   else
     target = calc_pframe_target_size_one_pass_cbr(cpi, *frame_update_type);
 
-  rc_set_frame_target(cpi, target, cm->width, cm->height);
+  int width = cm->width;
+  int height = cm->height;
+  if (cpi->use_svc) {
+    // The frame size of the layer is only applied when the frame is coded.
+    const SVC *const svc = &cpi->svc;
+    const LAYER_CONTEXT *const lc = &svc->layer_context[av1_svc_layer_index(
+        svc, svc->spatial_layer_id, svc->temporal_layer_id)];
+    av1_get_layer_resolution(cpi->oxcf.width, cpi->oxcf.height,
+                             lc->scaling_factor_num, lc->scaling_factor_den,
+                             &width, &height);
+  }
+  rc_set_frame_target(cpi, target, width, height);
   // TODO(afergs): Decide whether to scale up, down, or not at all
 }
 
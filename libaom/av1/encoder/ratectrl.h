@@ -86,6 +86,9 @@ typedef struct {
   int frames_since_key;
   int this_key_frame_forced;
   int next_key_frame_forced;
+  // Set while frames_to_key counts down to a scene cut found by the one-pass
+  // lookahead analysis, so that key frame is not treated as forced.
+  int lookahead_scene_cut;
   int source_alt_ref_pending;
   int source_alt_ref_active;
   int is_src_frame_alt_ref;
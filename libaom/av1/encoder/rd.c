@@ -84,229 +84,261 @@ static const int av1_ext_tx_set_idx_to_type[2][AOMMAX(EXT_TX_SETS_INTRA,
   },
 };
 
+// Returns 1 if 'cdf', of 'size' bytes within 'fc', differs from the copy of
+// it in x->cost_cdfs that the costs of 'x' were last computed from, and
+// updates that copy. A zeroed copy never matches a CDF, whose first entry is
+// always non-zero.
+static int cdf_changed(MACROBLOCK *x, const FRAME_CONTEXT *fc,
+                       const aom_cdf_prob *cdf, size_t size) {
+  const ptrdiff_t offset = (const uint8_t *)cdf - (const uint8_t *)fc;
+  uint8_t *const last = (uint8_t *)&x->cost_cdfs + offset;
+  assert(offset >= 0 && offset + size <= sizeof(*fc));
+  if (!memcmp(last, cdf, size)) return 0;
+  memcpy(last, cdf, size);
+  return 1;
+}
+
+static void update_cdf_costs(MACROBLOCK *x, const FRAME_CONTEXT *fc,
+                             int *costs, const aom_cdf_prob *cdf, size_t size,
+                             const int *inv_map) {
+  if (cdf_changed(x, fc, cdf, size))
+    av1_cost_tokens_from_cdf(costs, cdf, inv_map);
+}
+
+// 'cdf' must be an array within 'fc' rather than a pointer.
+#define CDF_CHANGED(x, fc, cdf) \
+  cdf_changed((x), (fc), (const aom_cdf_prob *)(cdf), sizeof(cdf))
+#define UPDATE_CDF_COSTS(x, fc, costs, cdf, inv_map) \
+  update_cdf_costs((x), (fc), (costs), (cdf), sizeof(cdf), (inv_map))
+
 void av1_fill_mode_rates(AV1_COMMON *const cm, MACROBLOCK *x,
                          FRAME_CONTEXT *fc) {
   int i, j;
 
   for (i = 0; i < PARTITION_CONTEXTS; ++i)
-    av1_cost_tokens_from_cdf(x->partition_cost[i], fc->partition_cdf[i], NULL);
+    UPDATE_CDF_COSTS(x, fc, x->partition_cost[i], fc->partition_cdf[i], NULL);
 
   if (cm->current_frame.skip_mode_info.skip_mode_flag) {
     for (i = 0; i < SKIP_CONTEXTS; ++i) {
-      av1_cost_tokens_from_cdf(x->skip_mode_cost[i], fc->skip_mode_cdfs[i],
-                               NULL);
+      UPDATE_CDF_COSTS(x, fc, x->skip_mode_cost[i], fc->skip_mode_cdfs[i],
+                       NULL);
     }
   }
 
   for (i = 0; i < SKIP_CONTEXTS; ++i) {
-    av1_cost_tokens_from_cdf(x->skip_cost[i], fc->skip_cdfs[i], NULL);
+    UPDATE_CDF_COSTS(x, fc, x->skip_cost[i], fc->skip_cdfs[i], NULL);
   }
 
   for (i = 0; i < KF_MODE_CONTEXTS; ++i)
     for (j = 0; j < KF_MODE_CONTEXTS; ++j)
-      av1_cost_tokens_from_cdf(x->y_mode_costs[i][j], fc->kf_y_cdf[i][j], NULL);
+      UPDATE_CDF_COSTS(x, fc, x->y_mode_costs[i][j], fc->kf_y_cdf[i][j], NULL);
 
   for (i = 0; i < BLOCK_SIZE_GROUPS; ++i)
-    av1_cost_tokens_from_cdf(x->mbmode_cost[i], fc->y_mode_cdf[i], NULL);
+    UPDATE_CDF_COSTS(x, fc, x->mbmode_cost[i], fc->y_mode_cdf[i], NULL);
   for (i = 0; i < CFL_ALLOWED_TYPES; ++i)
     for (j = 0; j < INTRA_MODES; ++j)
-      av1_cost_tokens_from_cdf(x->intra_uv_mode_cost[i][j],
-                               fc->uv_mode_cdf[i][j], NULL);
+      UPDATE_CDF_COSTS(x, fc, x->intra_uv_mode_cost[i][j],
+                       fc->uv_mode_cdf[i][j], NULL);
 
-  av1_cost_tokens_from_cdf(x->filter_intra_mode_cost, fc->filter_intra_mode_cdf,
-                           NULL);
+  UPDATE_CDF_COSTS(x, fc, x->filter_intra_mode_cost, fc->filter_intra_mode_cdf,
+                   NULL);
   for (i = 0; i < BLOCK_SIZES_ALL; ++i) {
     if (av1_filter_intra_allowed_bsize(cm, i))
-      av1_cost_tokens_from_cdf(x->filter_intra_cost[i],
-                               fc->filter_intra_cdfs[i], NULL);
+      UPDATE_CDF_COSTS(x, fc, x->filter_intra_cost[i], fc->filter_intra_cdfs[i],
+                       NULL);
   }
 
   for (i = 0; i < SWITCHABLE_FILTER_CONTEXTS; ++i)
-    av1_cost_tokens_from_cdf(x->switchable_interp_costs[i],
-                             fc->switchable_interp_cdf[i], NULL);
+    UPDATE_CDF_COSTS(x, fc, x->switchable_interp_costs[i],
+                     fc->switchable_interp_cdf[i], NULL);
 
   for (i = 0; i < PALATTE_BSIZE_CTXS; ++i) {
-    av1_cost_tokens_from_cdf(x->palette_y_size_cost[i],
-                             fc->palette_y_size_cdf[i], NULL);
-    av1_cost_tokens_from_cdf(x->palette_uv_size_cost[i],
-                             fc->palette_uv_size_cdf[i], NULL);
+    UPDATE_CDF_COSTS(x, fc, x->palette_y_size_cost[i],
+                     fc->palette_y_size_cdf[i], NULL);
+    UPDATE_CDF_COSTS(x, fc, x->palette_uv_size_cost[i],
+                     fc->palette_uv_size_cdf[i], NULL);
     for (j = 0; j < PALETTE_Y_MODE_CONTEXTS; ++j) {
-      av1_cost_tokens_from_cdf(x->palette_y_mode_cost[i][j],
-                               fc->palette_y_mode_cdf[i][j], NULL);
+      UPDATE_CDF_COSTS(x, fc, x->palette_y_mode_cost[i][j],
+                       fc->palette_y_mode_cdf[i][j], NULL);
     }
   }
 
   for (i = 0; i < PALETTE_UV_MODE_CONTEXTS; ++i) {
-    av1_cost_tokens_from_cdf(x->palette_uv_mode_cost[i],
-                             fc->palette_uv_mode_cdf[i], NULL);
+    UPDATE_CDF_COSTS(x, fc, x->palette_uv_mode_cost[i],
+                     fc->palette_uv_mode_cdf[i], NULL);
   }
 
   for (i = 0; i < PALETTE_SIZES; ++i) {
     for (j = 0; j < PALETTE_COLOR_INDEX_CONTEXTS; ++j) {
-      av1_cost_tokens_from_cdf(x->palette_y_color_cost[i][j],
-                               fc->palette_y_color_index_cdf[i][j], NULL);
-      av1_cost_tokens_from_cdf(x->palette_uv_color_cost[i][j],
-                               fc->palette_uv_color_index_cdf[i][j], NULL);
+      UPDATE_CDF_COSTS(x, fc, x->palette_y_color_cost[i][j],
+                       fc->palette_y_color_index_cdf[i][j], NULL);
+      UPDATE_CDF_COSTS(x, fc, x->palette_uv_color_cost[i][j],
+                       fc->palette_uv_color_index_cdf[i][j], NULL);
     }
   }
 
-  int sign_cost[CFL_JOINT_SIGNS];
-  av1_cost_tokens_from_cdf(sign_cost, fc->cfl_sign_cdf, NULL);
-  for (int joint_sign = 0; joint_sign < CFL_JOINT_SIGNS; joint_sign++) {
-    int *cost_u = x->cfl_cost[joint_sign][CFL_PRED_U];
-    int *cost_v = x->cfl_cost[joint_sign][CFL_PRED_V];
-    if (CFL_SIGN_U(joint_sign) == CFL_SIGN_ZERO) {
-      memset(cost_u, 0, CFL_ALPHABET_SIZE * sizeof(*cost_u));
-    } else {
-      const aom_cdf_prob *cdf_u = fc->cfl_alpha_cdf[CFL_CONTEXT_U(joint_sign)];
-      av1_cost_tokens_from_cdf(cost_u, cdf_u, NULL);
-    }
-    if (CFL_SIGN_V(joint_sign) == CFL_SIGN_ZERO) {
-      memset(cost_v, 0, CFL_ALPHABET_SIZE * sizeof(*cost_v));
-    } else {
-      const aom_cdf_prob *cdf_v = fc->cfl_alpha_cdf[CFL_CONTEXT_V(joint_sign)];
-      av1_cost_tokens_from_cdf(cost_v, cdf_v, NULL);
+  // The CfL costs combine the sign and alpha CDFs.
+  const int cfl_sign_changed = CDF_CHANGED(x, fc, fc->cfl_sign_cdf);
+  if (CDF_CHANGED(x, fc, fc->cfl_alpha_cdf) || cfl_sign_changed) {
+    int sign_cost[CFL_JOINT_SIGNS];
+    av1_cost_tokens_from_cdf(sign_cost, fc->cfl_sign_cdf, NULL);
+    for (int joint_sign = 0; joint_sign < CFL_JOINT_SIGNS; joint_sign++) {
+      int *cost_u = x->cfl_cost[joint_sign][CFL_PRED_U];
+      int *cost_v = x->cfl_cost[joint_sign][CFL_PRED_V];
+      if (CFL_SIGN_U(joint_sign) == CFL_SIGN_ZERO) {
+        memset(cost_u, 0, CFL_ALPHABET_SIZE * sizeof(*cost_u));
+      } else {
+        const aom_cdf_prob *cdf_u =
+            fc->cfl_alpha_cdf[CFL_CONTEXT_U(joint_sign)];
+        av1_cost_tokens_from_cdf(cost_u, cdf_u, NULL);
+      }
+      if (CFL_SIGN_V(joint_sign) == CFL_SIGN_ZERO) {
+        memset(cost_v, 0, CFL_ALPHABET_SIZE * sizeof(*cost_v));
+      } else {
+        const aom_cdf_prob *cdf_v =
+            fc->cfl_alpha_cdf[CFL_CONTEXT_V(joint_sign)];
+        av1_cost_tokens_from_cdf(cost_v, cdf_v, NULL);
+      }
+      for (int u = 0; u < CFL_ALPHABET_SIZE; u++)
+        cost_u[u] += sign_cost[joint_sign];
     }
-    for (int u = 0; u < CFL_ALPHABET_SIZE; u++)
-      cost_u[u] += sign_cost[joint_sign];
   }
 
   for (i = 0; i < MAX_TX_CATS; ++i)
     for (j = 0; j < TX_SIZE_CONTEXTS; ++j)
-      av1_cost_tokens_from_cdf(x->tx_size_cost[i][j], fc->tx_size_cdf[i][j],
-                               NULL);
+      UPDATE_CDF_COSTS(x, fc, x->tx_size_cost[i][j], fc->tx_size_cdf[i][j],
+                       NULL);
 
   for (i = 0; i < TXFM_PARTITION_CONTEXTS; ++i) {
-    av1_cost_tokens_from_cdf(x->txfm_partition_cost[i],
-                             fc->txfm_partition_cdf[i], NULL);
+    UPDATE_CDF_COSTS(x, fc, x->txfm_partition_cost[i],
+                     fc->txfm_partition_cdf[i], NULL);
   }
 
   for (i = TX_4X4; i < EXT_TX_SIZES; ++i) {
     int s;
     for (s = 1; s < EXT_TX_SETS_INTER; ++s) {
       if (use_inter_ext_tx_for_txsize[s][i]) {
-        av1_cost_tokens_from_cdf(
-            x->inter_tx_type_costs[s][i], fc->inter_ext_tx_cdf[s][i],
-            av1_ext_tx_inv[av1_ext_tx_set_idx_to_type[1][s]]);
+        UPDATE_CDF_COSTS(x, fc, x->inter_tx_type_costs[s][i],
+                         fc->inter_ext_tx_cdf[s][i],
+                         av1_ext_tx_inv[av1_ext_tx_set_idx_to_type[1][s]]);
       }
     }
     for (s = 1; s < EXT_TX_SETS_INTRA; ++s) {
       if (use_intra_ext_tx_for_txsize[s][i]) {
         for (j = 0; j < INTRA_MODES; ++j) {
-          av1_cost_tokens_from_cdf(
-              x->intra_tx_type_costs[s][i][j], fc->intra_ext_tx_cdf[s][i][j],
-              av1_ext_tx_inv[av1_ext_tx_set_idx_to_type[0][s]]);
+          UPDATE_CDF_COSTS(x, fc, x->intra_tx_type_costs[s][i][j],
+                           fc->intra_ext_tx_cdf[s][i][j],
+                           av1_ext_tx_inv[av1_ext_tx_set_idx_to_type[0][s]]);
         }
       }
     }
   }
   for (i = 0; i < DIRECTIONAL_MODES; ++i) {
-    av1_cost_tokens_from_cdf(x->angle_delta_cost[i], fc->angle_delta_cdf[i],
-                             NULL);
+    UPDATE_CDF_COSTS(x, fc, x->angle_delta_cost[i], fc->angle_delta_cdf[i],
+                     NULL);
   }
-  av1_cost_tokens_from_cdf(x->switchable_restore_cost,
-                           fc->switchable_restore_cdf, NULL);
-  av1_cost_tokens_from_cdf(x->wiener_restore_cost, fc->wiener_restore_cdf,
-                           NULL);
-  av1_cost_tokens_from_cdf(x->sgrproj_restore_cost, fc->sgrproj_restore_cdf,
-                           NULL);
-  av1_cost_tokens_from_cdf(x->intrabc_cost, fc->intrabc_cdf, NULL);
+  UPDATE_CDF_COSTS(x, fc, x->switchable_restore_cost,
+                   fc->switchable_restore_cdf, NULL);
+  UPDATE_CDF_COSTS(x, fc, x->wiener_restore_cost, fc->wiener_restore_cdf, NULL);
+  UPDATE_CDF_COSTS(x, fc, x->sgrproj_restore_cost, fc->sgrproj_restore_cdf,
+                   NULL);
+  UPDATE_CDF_COSTS(x, fc, x->intrabc_cost, fc->intrabc_cdf, NULL);
 
   if (!frame_is_intra_only(cm)) {
     for (i = 0; i < COMP_INTER_CONTEXTS; ++i) {
-      av1_cost_tokens_from_cdf(x->comp_inter_cost[i], fc->comp_inter_cdf[i],
-                               NULL);
+      UPDATE_CDF_COSTS(x, fc, x->comp_inter_cost[i], fc->comp_inter_cdf[i],
+                       NULL);
     }
 
     for (i = 0; i < REF_CONTEXTS; ++i) {
       for (j = 0; j < SINGLE_REFS - 1; ++j) {
-        av1_cost_tokens_from_cdf(x->single_ref_cost[i][j],
-                                 fc->single_ref_cdf[i][j], NULL);
+        UPDATE_CDF_COSTS(x, fc, x->single_ref_cost[i][j],
+                         fc->single_ref_cdf[i][j], NULL);
       }
     }
 
     for (i = 0; i < COMP_REF_TYPE_CONTEXTS; ++i) {
-      av1_cost_tokens_from_cdf(x->comp_ref_type_cost[i],
-                               fc->comp_ref_type_cdf[i], NULL);
+      UPDATE_CDF_COSTS(x, fc, x->comp_ref_type_cost[i],
+                       fc->comp_ref_type_cdf[i], NULL);
     }
 
     for (i = 0; i < UNI_COMP_REF_CONTEXTS; ++i) {
       for (j = 0; j < UNIDIR_COMP_REFS - 1; ++j) {
-        av1_cost_tokens_from_cdf(x->uni_comp_ref_cost[i][j],
-                                 fc->uni_comp_ref_cdf[i][j], NULL);
+        UPDATE_CDF_COSTS(x, fc, x->uni_comp_ref_cost[i][j],
+                         fc->uni_comp_ref_cdf[i][j], NULL);
       }
     }
 
     for (i = 0; i < REF_CONTEXTS; ++i) {
       for (j = 0; j < FWD_REFS - 1; ++j) {
-        av1_cost_tokens_from_cdf(x->comp_ref_cost[i][j], fc->comp_ref_cdf[i][j],
-                                 NULL);
+        UPDATE_CDF_COSTS(x, fc, x->comp_ref_cost[i][j], fc->comp_ref_cdf[i][j],
+                         NULL);
       }
     }
 
     for (i = 0; i < REF_CONTEXTS; ++i) {
       for (j = 0; j < BWD_REFS - 1; ++j) {
-        av1_cost_tokens_from_cdf(x->comp_bwdref_cost[i][j],
-                                 fc->comp_bwdref_cdf[i][j], NULL);
+        UPDATE_CDF_COSTS(x, fc, x->comp_bwdref_cost[i][j],
+                         fc->comp_bwdref_cdf[i][j], NULL);
       }
     }
 
     for (i = 0; i < INTRA_INTER_CONTEXTS; ++i) {
-      av1_cost_tokens_from_cdf(x->intra_inter_cost[i], fc->intra_inter_cdf[i],
-                               NULL);
+      UPDATE_CDF_COSTS(x, fc, x->intra_inter_cost[i], fc->intra_inter_cdf[i],
+                       NULL);
     }
 
     for (i = 0; i < NEWMV_MODE_CONTEXTS; ++i) {
-      av1_cost_tokens_from_cdf(x->newmv_mode_cost[i], fc->newmv_cdf[i], NULL);
+      UPDATE_CDF_COSTS(x, fc, x->newmv_mode_cost[i], fc->newmv_cdf[i], NULL);
     }
 
     for (i = 0; i < GLOBALMV_MODE_CONTEXTS; ++i) {
-      av1_cost_tokens_from_cdf(x->zeromv_mode_cost[i], fc->zeromv_cdf[i], NULL);
+      UPDATE_CDF_COSTS(x, fc, x->zeromv_mode_cost[i], fc->zeromv_cdf[i], NULL);
     }
 
     for (i = 0; i < REFMV_MODE_CONTEXTS; ++i) {
-      av1_cost_tokens_from_cdf(x->refmv_mode_cost[i], fc->refmv_cdf[i], NULL);
+      UPDATE_CDF_COSTS(x, fc, x->refmv_mode_cost[i], fc->refmv_cdf[i], NULL);
     }
 
     for (i = 0; i < DRL_MODE_CONTEXTS; ++i) {
-      av1_cost_tokens_from_cdf(x->drl_mode_cost0[i], fc->drl_cdf[i], NULL);
+      UPDATE_CDF_COSTS(x, fc, x->drl_mode_cost0[i], fc->drl_cdf[i], NULL);
     }
     for (i = 0; i < INTER_MODE_CONTEXTS; ++i)
-      av1_cost_tokens_from_cdf(x->inter_compound_mode_cost[i],
-                               fc->inter_compound_mode_cdf[i], NULL);
+      UPDATE_CDF_COSTS(x, fc, x->inter_compound_mode_cost[i],
+                       fc->inter_compound_mode_cdf[i], NULL);
     for (i = 0; i < BLOCK_SIZES_ALL; ++i)
-      av1_cost_tokens_from_cdf(x->compound_type_cost[i],
-                               fc->compound_type_cdf[i], NULL);
+      UPDATE_CDF_COSTS(x, fc, x->compound_type_cost[i],
+                       fc->compound_type_cdf[i], NULL);
     for (i = 0; i < BLOCK_SIZES_ALL; ++i) {
       if (get_interinter_wedge_bits(i)) {
-        av1_cost_tokens_from_cdf(x->wedge_idx_cost[i], fc->wedge_idx_cdf[i],
-                                 NULL);
+        UPDATE_CDF_COSTS(x, fc, x->wedge_idx_cost[i], fc->wedge_idx_cdf[i],
+                         NULL);
       }
     }
     for (i = 0; i < BLOCK_SIZE_GROUPS; ++i) {
-      av1_cost_tokens_from_cdf(x->interintra_cost[i], fc->interintra_cdf[i],
-                               NULL);
-      av1_cost_tokens_from_cdf(x->interintra_mode_cost[i],
-                               fc->interintra_mode_cdf[i], NULL);
+      UPDATE_CDF_COSTS(x, fc, x->interintra_cost[i], fc->interintra_cdf[i],
+                       NULL);
+      UPDATE_CDF_COSTS(x, fc, x->interintra_mode_cost[i],
+                       fc->interintra_mode_cdf[i], NULL);
     }
     for (i = 0; i < BLOCK_SIZES_ALL; ++i) {
-      av1_cost_tokens_from_cdf(x->wedge_interintra_cost[i],
-                               fc->wedge_interintra_cdf[i], NULL);
+      UPDATE_CDF_COSTS(x, fc, x->wedge_interintra_cost[i],
+                       fc->wedge_interintra_cdf[i], NULL);
     }
     for (i = BLOCK_8X8; i < BLOCK_SIZES_ALL; i++) {
-      av1_cost_tokens_from_cdf(x->motion_mode_cost[i], fc->motion_mode_cdf[i],
-                               NULL);
+      UPDATE_CDF_COSTS(x, fc, x->motion_mode_cost[i], fc->motion_mode_cdf[i],
+                       NULL);
     }
     for (i = BLOCK_8X8; i < BLOCK_SIZES_ALL; i++) {
-      av1_cost_tokens_from_cdf(x->motion_mode_cost1[i], fc->obmc_cdf[i], NULL);
+      UPDATE_CDF_COSTS(x, fc, x->motion_mode_cost1[i], fc->obmc_cdf[i], NULL);
     }
     for (i = 0; i < COMP_INDEX_CONTEXTS; ++i) {
-      av1_cost_tokens_from_cdf(x->comp_idx_cost[i], fc->compound_index_cdf[i],
-                               NULL);
+      UPDATE_CDF_COSTS(x, fc, x->comp_idx_cost[i], fc->compound_index_cdf[i],
+                       NULL);
     }
     for (i = 0; i < COMP_GROUP_IDX_CONTEXTS; ++i) {
-      av1_cost_tokens_from_cdf(x->comp_group_idx_cost[i],
-                               fc->comp_group_idx_cdf[i], NULL);
+      UPDATE_CDF_COSTS(x, fc, x->comp_group_idx_cost[i],
+                       fc->comp_group_idx_cdf[i], NULL);
     }
   }
 }
@@ -482,7 +514,8 @@ void av1_fill_coeff_costs(MACROBLOCK *x, FRAME_CONTEXT *fc,
           case 6:
           default: pcdf = fc->eob_flag_cdf1024[plane][ctx]; break;
         }
-        av1_cost_tokens_from_cdf(pcost->eob_cost[ctx], pcdf, NULL);
+        update_cdf_costs(x, fc, pcost->eob_cost[ctx], pcdf,
+                         CDF_SIZE(eob_multi_size + 5) * sizeof(*pcdf), NULL);
       }
     }
   }
@@ -490,19 +523,25 @@ void av1_fill_coeff_costs(MACROBLOCK *x, FRAME_CONTEXT *fc,
     for (int plane = 0; plane < nplanes; ++plane) {
       LV_MAP_COEFF_COST *pcost = &x->coeff_costs[tx_size][plane];
 
-      for (int ctx = 0; ctx < TXB_SKIP_CONTEXTS; ++ctx)
-        av1_cost_tokens_from_cdf(pcost->txb_skip_cost[ctx],
-                                 fc->txb_skip_cdf[tx_size][ctx], NULL);
+      // The skip CDFs are shared by the planes.
+      if (plane == 0) {
+        for (int ctx = 0; ctx < TXB_SKIP_CONTEXTS; ++ctx)
+          UPDATE_CDF_COSTS(x, fc, pcost->txb_skip_cost[ctx],
+                           fc->txb_skip_cdf[tx_size][ctx], NULL);
+      } else {
+        memcpy(pcost->txb_skip_cost, x->coeff_costs[tx_size][0].txb_skip_cost,
+               sizeof(pcost->txb_skip_cost));
+      }
 
       for (int ctx = 0; ctx < SIG_COEF_CONTEXTS_EOB; ++ctx)
-        av1_cost_tokens_from_cdf(pcost->base_eob_cost[ctx],
-                                 fc->coeff_base_eob_cdf[tx_size][plane][ctx],
-                                 NULL);
-      for (int ctx = 0; ctx < SIG_COEF_CONTEXTS; ++ctx)
-        av1_cost_tokens_from_cdf(pcost->base_cost[ctx],
-                                 fc->coeff_base_cdf[tx_size][plane][ctx], NULL);
+        UPDATE_CDF_COSTS(x, fc, pcost->base_eob_cost[ctx],
+                         fc->coeff_base_eob_cdf[tx_size][plane][ctx], NULL);
 
       for (int ctx = 0; ctx < SIG_COEF_CONTEXTS; ++ctx) {
+        if (!CDF_CHANGED(x, fc, fc->coeff_base_cdf[tx_size][plane][ctx]))
+          continue;
+        av1_cost_tokens_from_cdf(pcost->base_cost[ctx],
+                                 fc->coeff_base_cdf[tx_size][plane][ctx], NULL);
         pcost->base_cost[ctx][4] = 0;
         pcost->base_cost[ctx][5] = pcost->base_cost[ctx][1] +
                                    av1_cost_literal(1) -
@@ -514,23 +553,27 @@ void av1_fill_coeff_costs(MACROBLOCK *x, FRAME_CONTEXT *fc,
       }
 
       for (int ctx = 0; ctx < EOB_COEF_CONTEXTS; ++ctx)
-        av1_cost_tokens_from_cdf(pcost->eob_extra_cost[ctx],
-                                 fc->eob_extra_cdf[tx_size][plane][ctx], NULL);
-
-      for (int ctx = 0; ctx < DC_SIGN_CONTEXTS; ++ctx)
-        av1_cost_tokens_from_cdf(pcost->dc_sign_cost[ctx],
-                                 fc->dc_sign_cdf[plane][ctx], NULL);
+        UPDATE_CDF_COSTS(x, fc, pcost->eob_extra_cost[ctx],
+                         fc->eob_extra_cdf[tx_size][plane][ctx], NULL);
+
+      // The DC sign CDFs are shared by the transform sizes.
+      if (tx_size == 0) {
+        for (int ctx = 0; ctx < DC_SIGN_CONTEXTS; ++ctx)
+          UPDATE_CDF_COSTS(x, fc, pcost->dc_sign_cost[ctx],
+                           fc->dc_sign_cdf[plane][ctx], NULL);
+      } else {
+        memcpy(pcost->dc_sign_cost, x->coeff_costs[0][plane].dc_sign_cost,
+               sizeof(pcost->dc_sign_cost));
+      }
 
       for (int ctx = 0; ctx < LEVEL_CONTEXTS; ++ctx) {
+        if (!CDF_CHANGED(x, fc, fc->coeff_br_cdf[tx_size][plane][ctx]))
+          continue;
         int br_rate[BR_CDF_SIZE];
         int prev_cost = 0;
         int i, j;
         av1_cost_tokens_from_cdf(br_rate, fc->coeff_br_cdf[tx_size][plane][ctx],
                                  NULL);
-        // printf("br_rate: ");
-        // for(j = 0; j < BR_CDF_SIZE; j++)
-        //  printf("%4d ", br_rate[j]);
-        // printf("\n");
         for (i = 0; i < COEFF_BASE_RANGE; i += BR_CDF_SIZE - 1) {
           for (j = 0; j < BR_CDF_SIZE - 1; j++) {
             pcost->lps_cost[ctx][i + j] = prev_cost + br_rate[j];
@@ -538,15 +581,9 @@ void av1_fill_coeff_costs(MACROBLOCK *x, FRAME_CONTEXT *fc,
           prev_cost += br_rate[j];
         }
         pcost->lps_cost[ctx][i] = prev_cost;
-        // printf("lps_cost: %d %d %2d : ", tx_size, plane, ctx);
-        // for (i = 0; i <= COEFF_BASE_RANGE; i++)
-        //  printf("%5d ", pcost->lps_cost[ctx][i]);
-        // printf("\n");
-      }
-      for (int ctx = 0; ctx < LEVEL_CONTEXTS; ++ctx) {
         pcost->lps_cost[ctx][0 + COEFF_BASE_RANGE + 1] =
             pcost->lps_cost[ctx][0];
-        for (int i = 1; i <= COEFF_BASE_RANGE; ++i) {
+        for (i = 1; i <= COEFF_BASE_RANGE; ++i) {
           pcost->lps_cost[ctx][i + COEFF_BASE_RANGE + 1] =
               pcost->lps_cost[ctx][i] - pcost->lps_cost[ctx][i - 1];
         }
@@ -556,6 +593,16 @@ void av1_fill_coeff_costs(MACROBLOCK *x, FRAME_CONTEXT *fc,
 }
 
 void av1_initialize_cost_tables(const AV1_COMMON *const cm, MACROBLOCK *x) {
+  const MvSubpelPrecision precision = cm->cur_frame_force_integer_mv
+                                          ? MV_SUBPEL_NONE
+                                          : cm->allow_high_precision_mv;
+  // A zeroed nmv_cost_cdfs never matches the MV CDFs.
+  if (x->nmv_cost_precision == precision &&
+      !memcmp(&x->nmv_cost_cdfs, &cm->fc->nmvc, sizeof(x->nmv_cost_cdfs)))
+    return;
+  x->nmv_cost_cdfs = cm->fc->nmvc;
+  x->nmv_cost_precision = precision;
+
   if (cm->cur_frame_force_integer_mv) {
     av1_build_nmv_cost_table(x->nmv_vec_cost, x->nmvcost, &cm->fc->nmvc,
                              MV_SUBPEL_NONE);
@@ -979,6 +1026,10 @@ void av1_mv_pred(const AV1_COMP *cpi, MACROBLOCK *x, uint8_t *ref_y_buffer,
       av1_get_ref_mv_from_stack(0, ref_frames, 0, x->mbmi_ext);
   const int_mv ref_mv1 =
       av1_get_ref_mv_from_stack(0, ref_frames, 1, x->mbmi_ext);
+  // The candidates may point further outside the frame than a small border
+  // covers.
+  const MACROBLOCKD *const xd = &x->e_mbd;
+  const int border = cpi->oxcf.border_in_pixels;
 
   pred_mv[num_mv_refs++] = ref_mv.as_mv;
   if (ref_mv.as_int != ref_mv1.as_int) {
@@ -996,6 +1047,10 @@ void av1_mv_pred(const AV1_COMP *cpi, MACROBLOCK *x, uint8_t *ref_y_buffer,
     fp_row = (this_mv->row + 3 + (this_mv->row >= 0)) >> 3;
     fp_col = (this_mv->col + 3 + (this_mv->col >= 0)) >> 3;
     max_mv = AOMMAX(max_mv, AOMMAX(abs(this_mv->row), abs(this_mv->col)) >> 3);
+    fp_row = clamp(fp_row, (xd->mb_to_top_edge >> 3) - border,
+                   (xd->mb_to_bottom_edge >> 3) + border);
+    fp_col = clamp(fp_col, (xd->mb_to_left_edge >> 3) - border,
+                   (xd->mb_to_right_edge >> 3) + border);
 
     if (fp_row == 0 && fp_col == 0 && zero_seen) continue;
     zero_seen |= (fp_row == 0 && fp_col == 0);
@@ -6576,8 +6576,8 @@ static void choose_intra_uv_mode(const AV1_COMP *const cpi, MACROBLOCK *const x,
   *mode_uv = mbmi->uv_mode;
 }
 
-static int cost_mv_ref(const MACROBLOCK *const x, PREDICTION_MODE mode,
-                       int16_t mode_context) {
+int av1_cost_mv_ref(const MACROBLOCK *const x, PREDICTION_MODE mode,
+                    int16_t mode_context) {
   if (is_inter_compound_mode(mode)) {
     return x
         ->inter_compound_mode_cost[mode_context][INTER_COMPOUND_OFFSET(mode)];
@@ -6746,12 +6746,11 @@ static void joint_motion_search(const AV1_COMP *cpi, MACROBLOCK *x,
 
     // Since we have scaled the reference frames to match the size of the
     // current frame we must use a unit scaling factor during mode selection.
-    av1_build_inter_predictor(ref_yv12[!id].buf, ref_yv12[!id].stride,
-                              second_pred, pw, &cur_mv[!id].as_mv,
-                              &cm->sf_identity, pw, ph, &conv_params,
-                              interp_filters, &warp_types[!id], p_col, p_row,
-                              plane, !id, MV_PRECISION_Q3, mi_col * MI_SIZE,
-                              mi_row * MI_SIZE, xd, cm->allow_warped_motion);
+    av1_build_inter_predictor_from_buf(
+        &ref_yv12[!id], second_pred, pw, &cur_mv[!id].as_mv, &cm->sf_identity,
+        pw, ph, &conv_params, interp_filters, &warp_types[!id], p_col, p_row,
+        plane, !id, MV_PRECISION_Q3, mi_col * MI_SIZE, mi_row * MI_SIZE, xd,
+        cm->allow_warped_motion);
 
     const int order_idx = id != 0;
     av1_dist_wtd_comp_weight_assign(
@@ -6836,7 +6835,7 @@ static void joint_motion_search(const AV1_COMP *cpi, MACROBLOCK *x,
   }
 }
 
-static void estimate_ref_frame_costs(
+void av1_estimate_ref_frame_costs(
     const AV1_COMMON *cm, const MACROBLOCKD *xd, const MACROBLOCK *x,
     int segment_id, unsigned int *ref_costs_single,
     unsigned int (*ref_costs_comp)[REF_FRAMES]) {
@@ -7145,6 +7144,16 @@ static void single_motion_search(const AV1_COMP *const cpi, MACROBLOCK *x,
   mvp_full.col >>= 3;
   mvp_full.row >>= 3;
 
+  // Start from an external motion hint if it predicts better, and only
+  // refine around it.
+  MV hint_mv;
+  if (mbmi->motion_mode == SIMPLE_TRANSLATION && ref_idx == 0 &&
+      av1_get_motion_hint(&cpi->motion_hints, ref, mi_row, mi_col, bsize,
+                          &hint_mv) &&
+      av1_pick_hinted_start_mv(x, &cpi->fn_ptr[bsize], &hint_mv, &ref_mv,
+                               sadpb, &mvp_full))
+    step_param = AOMMAX(step_param, MOTION_HINT_STEP_PARAM);
+
   x->best_mv.as_int = x->second_best_mv.as_int = INVALID_MV;
 
   switch (mbmi->motion_mode) {
@@ -7294,11 +7303,11 @@ static void build_second_inter_pred(const AV1_COMP *cpi, MACROBLOCK *x,
   warp_types.local_warp_allowed = mbmi->motion_mode == WARPED_CAUSAL;
 
   // Get the prediction block from the 'other' reference frame.
-  av1_build_inter_predictor(ref_yv12.buf, ref_yv12.stride, second_pred, pw,
-                            other_mv, &sf, pw, ph, &conv_params,
-                            mbmi->interp_filters, &warp_types, p_col, p_row,
-                            plane, !ref_idx, MV_PRECISION_Q3, mi_col * MI_SIZE,
-                            mi_row * MI_SIZE, xd, cm->allow_warped_motion);
+  av1_build_inter_predictor_from_buf(
+      &ref_yv12, second_pred, pw, other_mv, &sf, pw, ph, &conv_params,
+      mbmi->interp_filters, &warp_types, p_col, p_row, plane, !ref_idx,
+      MV_PRECISION_Q3, mi_col * MI_SIZE, mi_row * MI_SIZE, xd,
+      cm->allow_warped_motion);
 
   av1_dist_wtd_comp_weight_assign(cm, mbmi, 0, &xd->jcp_param.fwd_offset,
                                   &xd->jcp_param.bck_offset,
@@ -7330,13 +7339,6 @@ static void compound_single_motion_search(const AV1_COMP *cpi, MACROBLOCK *x,
   // Check that this is either an interinter or an interintra block
   assert(has_second_ref(mbmi) || (ref_idx == 0 && is_interintra_mode(mbmi)));
 
-  // Store the first prediction buffer.
-  struct buf_2d orig_yv12;
-  if (ref_idx) {
-    orig_yv12 = pd->pre[0];
-    pd->pre[0] = pd->pre[ref_idx];
-  }
-
   if (scaled_ref_frame) {
     int i;
     // Swap out the reference frame for a version that's been scaled to
@@ -7348,6 +7350,14 @@ static void compound_single_motion_search(const AV1_COMP *cpi, MACROBLOCK *x,
                          num_planes);
   }
 
+  // Store the first prediction buffer. This follows the swap above, so that
+  // the search of the second reference reads its scaled copy.
+  struct buf_2d orig_yv12;
+  if (ref_idx) {
+    orig_yv12 = pd->pre[0];
+    pd->pre[0] = pd->pre[ref_idx];
+  }
+
   int bestsme = INT_MAX;
   int sadpb = x->sadperbit16;
   MV *const best_mv = &x->best_mv.as_mv;
@@ -7385,6 +7395,7 @@ static void compound_single_motion_search(const AV1_COMP *cpi, MACROBLOCK *x,
     for (int i = 0; i < num_planes; i++) {
       xd->plane[i].pre[ref_idx] = backup_yv12[i];
     }
+    if (ref_idx) pd->pre[0] = pd->pre[ref_idx];
   }
 
   if (cpi->common.cur_frame_force_integer_mv) {
@@ -8077,8 +8088,8 @@ static int skip_repeated_mv(const AV1_COMMON *const cm,
           INT64_MAX) {
         const int16_t mode_ctx =
             av1_mode_context_analyzer(mbmi_ext->mode_context, ref_frames);
-        const int compare_cost = cost_mv_ref(x, compare_mode, mode_ctx);
-        const int this_cost = cost_mv_ref(x, this_mode, mode_ctx);
+        const int compare_cost = av1_cost_mv_ref(x, compare_mode, mode_ctx);
+        const int this_cost = av1_cost_mv_ref(x, this_mode, mode_ctx);
 
         // Only skip if the mode cost is larger than compare mode cost
         if (this_cost > compare_cost) {
@@ -10399,7 +10410,7 @@ static int64_t handle_inter_mode(
       for (i = 0; i < is_comp_pred + 1; ++i) {
         mbmi->mv[i].as_int = cur_mv[i].as_int;
       }
-      const int ref_mv_cost = cost_mv_ref(x, this_mode, mode_ctx);
+      const int ref_mv_cost = av1_cost_mv_ref(x, this_mode, mode_ctx);
 #if USE_DISCOUNT_NEWMV_TEST
       // We don't include the cost of the second reference here, because there
       // are only three options: Last/Golden, ARF/Last or Golden/ARF, or in
@@ -10411,8 +10422,8 @@ static int64_t handle_inter_mode(
       if (discount_newmv_test(cpi, x, this_mode, mbmi->mv[0])) {
         // discount_newmv_test only applies discount on NEWMV mode.
         assert(this_mode == NEWMV);
-        rd_stats->rate += AOMMIN(cost_mv_ref(x, this_mode, mode_ctx),
-                                 cost_mv_ref(x, NEARESTMV, mode_ctx));
+        rd_stats->rate += AOMMIN(av1_cost_mv_ref(x, this_mode, mode_ctx),
+                                 av1_cost_mv_ref(x, NEARESTMV, mode_ctx));
       } else {
         rd_stats->rate += ref_mv_cost;
       }
@@ -11384,8 +11395,8 @@ static void set_params_rd_pick_inter_mode(
 
   av1_collect_neighbors_ref_counts(xd);
 
-  estimate_ref_frame_costs(cm, xd, x, segment_id, ref_costs_single,
-                           ref_costs_comp);
+  av1_estimate_ref_frame_costs(cm, xd, x, segment_id, ref_costs_single,
+                               ref_costs_comp);
 
   MV_REFERENCE_FRAME ref_frame;
   for (ref_frame = LAST_FRAME; ref_frame <= ALTREF_FRAME; ++ref_frame) {
@@ -11521,8 +11532,8 @@ static void set_params_nonrd_pick_inter_mode(
 
   av1_collect_neighbors_ref_counts(xd);
 
-  estimate_ref_frame_costs(cm, xd, x, segment_id, ref_costs_single,
-                           ref_costs_comp);
+  av1_estimate_ref_frame_costs(cm, xd, x, segment_id, ref_costs_single,
+                               ref_costs_comp);
 
   MV_REFERENCE_FRAME ref_frame;
   for (ref_frame = LAST_FRAME; ref_frame <= ALTREF_FRAME; ++ref_frame) {
@@ -13722,8 +13733,8 @@ void av1_rd_pick_inter_mode_sb_seg_skip(const AV1_COMP *cpi,
 
   av1_collect_neighbors_ref_counts(xd);
 
-  estimate_ref_frame_costs(cm, xd, x, segment_id, ref_costs_single,
-                           ref_costs_comp);
+  av1_estimate_ref_frame_costs(cm, xd, x, segment_id, ref_costs_single,
+                               ref_costs_comp);
 
   for (i = 0; i < REF_FRAMES; ++i) x->pred_sse[i] = INT_MAX;
   for (i = LAST_FRAME; i < REF_FRAMES; ++i) x->pred_mv_sad[i] = INT_MAX;
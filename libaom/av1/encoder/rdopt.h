@@ -130,6 +130,25 @@ void av1_nonrd_pick_inter_mode_sb(struct AV1_COMP *cpi,
                                   PICK_MODE_CONTEXT *ctx,
                                   int64_t best_rd_so_far);
 
+// Real-time mode decision that only checks NEARESTMV, NEARMV, GLOBALMV and
+// NEWMV on LAST, GOLDEN and ALTREF, plus DC_PRED, and estimates their rate
+// and distortion from the prediction error with a model instead of running
+// the transform search. Defined in nonrd_pickmode.c.
+void av1_fast_nonrd_pick_inter_mode_sb(struct AV1_COMP *cpi,
+                                       struct TileDataEnc *tile_data,
+                                       struct macroblock *x, int mi_row,
+                                       int mi_col, struct RD_STATS *rd_cost,
+                                       BLOCK_SIZE bsize, PICK_MODE_CONTEXT *ctx,
+                                       int64_t best_rd_so_far);
+
+int av1_cost_mv_ref(const MACROBLOCK *const x, PREDICTION_MODE mode,
+                    int16_t mode_context);
+
+void av1_estimate_ref_frame_costs(const AV1_COMMON *cm, const MACROBLOCKD *xd,
+                                  const MACROBLOCK *x, int segment_id,
+                                  unsigned int *ref_costs_single,
+                                  unsigned int (*ref_costs_comp)[REF_FRAMES]);
+
 void av1_rd_pick_inter_mode_sb_seg_skip(
     const struct AV1_COMP *cpi, struct TileDataEnc *tile_data,
     struct macroblock *x, int mi_row, int mi_col, struct RD_STATS *rd_cost,
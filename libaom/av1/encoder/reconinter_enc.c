@@ -28,13 +28,138 @@
 #include "av1/common/obmc.h"
 #include "av1/encoder/reconinter_enc.h"
 
+static void build_mc_border(const uint8_t *src, int src_stride, uint8_t *dst,
+                            int dst_stride, int x, int y, int b_w, int b_h,
+                            int w, int h) {
+  // Get a pointer to the start of the real data for this row.
+  const uint8_t *ref_row = src - x - y * src_stride;
+
+  if (y >= h)
+    ref_row += (h - 1) * src_stride;
+  else if (y > 0)
+    ref_row += y * src_stride;
+
+  do {
+    int right = 0, copy;
+    int left = x < 0 ? -x : 0;
+
+    if (left > b_w) left = b_w;
+
+    if (x + b_w > w) right = x + b_w - w;
+
+    if (right > b_w) right = b_w;
+
+    copy = b_w - left - right;
+
+    if (left) memset(dst, ref_row[0], left);
+
+    if (copy) memcpy(dst + left, ref_row + x + left, copy);
+
+    if (right) memset(dst + left + copy, ref_row[w - 1], right);
+
+    dst += dst_stride;
+    ++y;
+
+    if (y > 0 && y < h) ref_row += src_stride;
+  } while (--b_h);
+}
+
+static void highbd_build_mc_border(const uint8_t *src8, int src_stride,
+                                   uint8_t *dst8, int dst_stride, int x, int y,
+                                   int b_w, int b_h, int w, int h) {
+  // Get a pointer to the start of the real data for this row.
+  const uint16_t *src = CONVERT_TO_SHORTPTR(src8);
+  uint16_t *dst = CONVERT_TO_SHORTPTR(dst8);
+  const uint16_t *ref_row = src - x - y * src_stride;
+
+  if (y >= h)
+    ref_row += (h - 1) * src_stride;
+  else if (y > 0)
+    ref_row += y * src_stride;
+
+  do {
+    int right = 0, copy;
+    int left = x < 0 ? -x : 0;
+
+    if (left > b_w) left = b_w;
+
+    if (x + b_w > w) right = x + b_w - w;
+
+    if (right > b_w) right = b_w;
+
+    copy = b_w - left - right;
+
+    if (left) aom_memset16(dst, ref_row[0], left);
+
+    if (copy) memcpy(dst + left, ref_row + x + left, copy * sizeof(uint16_t));
+
+    if (right) aom_memset16(dst + left + copy, ref_row[w - 1], right);
+
+    dst += dst_stride;
+    ++y;
+
+    if (y > 0 && y < h) ref_row += src_stride;
+  } while (--b_h);
+}
+
+// The reference frames of an encoder with a small border do not cover the
+// predictions of all blocks at the frame edge. If the reference block of the
+// bw x bh prediction at (x0, y0), including the taps of the subpel filters,
+// is not inside the frame, copies it to mc_buf with emulated edges like the
+// border extension would have and points pre and src_stride at the copy.
+// With a scaled reference the block spans a different number of reference
+// pixels and the filters are always applied.
+static INLINE void extend_mc_border(const MACROBLOCKD *xd,
+                                    const struct buf_2d *pre_buf,
+                                    const SubpelParams *subpel_params, int x0,
+                                    int y0, int bw, int bh, uint8_t *mc_buf,
+                                    uint8_t **pre, int *src_stride) {
+  const int is_scaled = subpel_params->xs != SCALE_SUBPEL_SHIFTS ||
+                        subpel_params->ys != SCALE_SUBPEL_SHIFTS;
+  const int x_pad =
+      is_scaled || (subpel_params->subpel_x >> SCALE_EXTRA_BITS) != 0;
+  const int y_pad =
+      is_scaled || (subpel_params->subpel_y >> SCALE_EXTRA_BITS) != 0;
+  const int ref_w =
+      ((subpel_params->subpel_x + (bw - 1) * subpel_params->xs) >>
+       SCALE_SUBPEL_BITS) +
+      1;
+  const int ref_h =
+      ((subpel_params->subpel_y + (bh - 1) * subpel_params->ys) >>
+       SCALE_SUBPEL_BITS) +
+      1;
+  x0 -= x_pad * (AOM_INTERP_EXTEND - 1);
+  y0 -= y_pad * (AOM_INTERP_EXTEND - 1);
+  const int b_w = ref_w + x_pad * (2 * AOM_INTERP_EXTEND - 1);
+  const int b_h = ref_h + y_pad * (2 * AOM_INTERP_EXTEND - 1);
+  if (x0 >= 0 && y0 >= 0 && x0 + b_w <= pre_buf->width &&
+      y0 + b_h <= pre_buf->height)
+    return;
+
+  const uint8_t *const buf_ptr =
+      pre_buf->buf0 + y0 * pre_buf->stride + (ptrdiff_t)x0;
+  if (is_cur_buf_hbd(xd)) {
+    highbd_build_mc_border(buf_ptr, pre_buf->stride, mc_buf, b_w, x0, y0, b_w,
+                           b_h, pre_buf->width, pre_buf->height);
+  } else {
+    build_mc_border(buf_ptr, pre_buf->stride, mc_buf, b_w, x0, y0, b_w, b_h,
+                    pre_buf->width, pre_buf->height);
+  }
+  *src_stride = b_w;
+  *pre = mc_buf + y_pad * (AOM_INTERP_EXTEND - 1) * b_w +
+         x_pad * (AOM_INTERP_EXTEND - 1);
+}
+
+// mc_buf is NULL if the reference frames have a border large enough for all
+// predictions.
 static INLINE void calc_subpel_params(
     MACROBLOCKD *xd, const struct scale_factors *const sf, const MV mv,
     int plane, const int pre_x, const int pre_y, int x, int y,
-    struct buf_2d *const pre_buf, uint8_t **pre, SubpelParams *subpel_params,
-    int bw, int bh) {
+    struct buf_2d *const pre_buf, uint8_t *mc_buf, uint8_t **pre,
+    int *src_stride, SubpelParams *subpel_params, int bw, int bh) {
   struct macroblockd_plane *const pd = &xd->plane[plane];
   const int is_scaled = av1_is_scaled(sf);
+  *src_stride = pre_buf->stride;
   if (is_scaled) {
     int ssx = pd->subsampling_x;
     int ssy = pd->subsampling_y;
@@ -61,6 +186,11 @@ static INLINE void calc_subpel_params(
     subpel_params->subpel_y = pos_y & SCALE_SUBPEL_MASK;
     subpel_params->xs = sf->x_step_q4;
     subpel_params->ys = sf->y_step_q4;
+    if (mc_buf) {
+      extend_mc_border(xd, pre_buf, subpel_params,
+                       pos_x >> SCALE_SUBPEL_BITS, pos_y >> SCALE_SUBPEL_BITS,
+                       bw, bh, mc_buf, pre, src_stride);
+    }
   } else {
     const MV mv_q4 = clamp_mv_to_umv_border_sb(
         xd, &mv, bw, bh, pd->subsampling_x, pd->subsampling_y);
@@ -69,6 +199,17 @@ static INLINE void calc_subpel_params(
     subpel_params->subpel_y = (mv_q4.row & SUBPEL_MASK) << SCALE_EXTRA_BITS;
     *pre = pre_buf->buf + (y + (mv_q4.row >> SUBPEL_BITS)) * pre_buf->stride +
            (x + (mv_q4.col >> SUBPEL_BITS));
+    if (mc_buf) {
+      // The block is inside the frame, so the position of pre_buf->buf is
+      // its offset from buf0.
+      const ptrdiff_t offset = pre_buf->buf - pre_buf->buf0;
+      const int x0 = (int)(offset % pre_buf->stride) + x +
+                     (mv_q4.col >> SUBPEL_BITS);
+      const int y0 = (int)(offset / pre_buf->stride) + y +
+                     (mv_q4.row >> SUBPEL_BITS);
+      extend_mc_border(xd, pre_buf, subpel_params, x0, y0, bw, bh, mc_buf, pre,
+                       src_stride);
+    }
   }
 }
 
@@ -165,13 +306,15 @@ static INLINE void build_inter_predictors(const AV1_COMMON *cm, MACROBLOCKD *xd,
         const MV mv = this_mbmi->mv[ref].as_mv;
 
         uint8_t *pre;
+        int src_stride;
         SubpelParams subpel_params;
         WarpTypesAllowed warp_types;
         warp_types.global_warp_allowed = is_global[ref];
         warp_types.local_warp_allowed = this_mbmi->motion_mode == WARPED_CAUSAL;
 
-        calc_subpel_params(xd, sf, mv, plane, pre_x, pre_y, x, y, pre_buf, &pre,
-                           &subpel_params, bw, bh);
+        calc_subpel_params(xd, sf, mv, plane, pre_x, pre_y, x, y, pre_buf,
+                           get_buf_by_bd(xd, xd->mc_buf[ref]), &pre,
+                           &src_stride, &subpel_params, bw, bh);
         conv_params.do_average = ref;
         if (is_masked_compound_type(mi->interinter_comp.type)) {
           // masked compound type has its own average mechanism
@@ -179,8 +322,8 @@ static INLINE void build_inter_predictors(const AV1_COMMON *cm, MACROBLOCKD *xd,
         }
 
         av1_make_inter_predictor(
-            pre, pre_buf->stride, dst, dst_buf->stride, &subpel_params, sf,
-            b4_w, b4_h, &conv_params, this_mbmi->interp_filters, &warp_types,
+            pre, src_stride, dst, dst_buf->stride, &subpel_params, sf, b4_w,
+            b4_h, &conv_params, this_mbmi->interp_filters, &warp_types,
             (mi_x >> pd->subsampling_x) + x, (mi_y >> pd->subsampling_y) + y,
             plane, ref, mi, build_for_obmc, xd, cm->allow_warped_motion);
 
@@ -209,9 +352,11 @@ static INLINE void build_inter_predictors(const AV1_COMMON *cm, MACROBLOCKD *xd,
       const MV mv = mi->mv[ref].as_mv;
 
       uint8_t *pre;
+      int src_stride;
       SubpelParams subpel_params;
-      calc_subpel_params(xd, sf, mv, plane, pre_x, pre_y, 0, 0, pre_buf, &pre,
-                         &subpel_params, bw, bh);
+      calc_subpel_params(xd, sf, mv, plane, pre_x, pre_y, 0, 0, pre_buf,
+                         is_intrabc ? NULL : get_buf_by_bd(xd, xd->mc_buf[ref]),
+                         &pre, &src_stride, &subpel_params, bw, bh);
 
       WarpTypesAllowed warp_types;
       warp_types.global_warp_allowed = is_global[ref];
@@ -221,14 +366,14 @@ static INLINE void build_inter_predictors(const AV1_COMMON *cm, MACROBLOCKD *xd,
         // masked compound type has its own average mechanism
         conv_params.do_average = 0;
         av1_make_masked_inter_predictor(
-            pre, pre_buf->stride, dst, dst_buf->stride, &subpel_params, sf, bw,
+            pre, src_stride, dst, dst_buf->stride, &subpel_params, sf, bw,
             bh, &conv_params, mi->interp_filters, plane, &warp_types,
             mi_x >> pd->subsampling_x, mi_y >> pd->subsampling_y, ref, xd,
             cm->allow_warped_motion);
       } else {
         conv_params.do_average = ref;
         av1_make_inter_predictor(
-            pre, pre_buf->stride, dst, dst_buf->stride, &subpel_params, sf, bw,
+            pre, src_stride, dst, dst_buf->stride, &subpel_params, sf, bw,
             bh, &conv_params, mi->interp_filters, &warp_types,
             mi_x >> pd->subsampling_x, mi_y >> pd->subsampling_y, plane, ref,
             mi, build_for_obmc, xd, cm->allow_warped_motion);
@@ -277,15 +422,15 @@ void av1_enc_build_inter_predictor(const AV1_COMMON *cm, MACROBLOCKD *xd,
 // TODO(sarahparker):
 // av1_build_inter_predictor should be combined with
 // av1_make_inter_predictor
-void av1_build_inter_predictor(const uint8_t *src, int src_stride, uint8_t *dst,
-                               int dst_stride, const MV *src_mv,
-                               const struct scale_factors *sf, int w, int h,
-                               ConvolveParams *conv_params,
-                               InterpFilters interp_filters,
-                               const WarpTypesAllowed *warp_types, int p_col,
-                               int p_row, int plane, int ref,
-                               mv_precision precision, int x, int y,
-                               const MACROBLOCKD *xd, int can_use_previous) {
+// pre_buf is NULL if the reference at src has a border large enough for the
+// prediction.
+static void build_inter_predictor(
+    const uint8_t *src, int src_stride, const struct buf_2d *pre_buf,
+    uint8_t *dst, int dst_stride, const MV *src_mv,
+    const struct scale_factors *sf, int w, int h, ConvolveParams *conv_params,
+    InterpFilters interp_filters, const WarpTypesAllowed *warp_types, int p_col,
+    int p_row, int plane, int ref, mv_precision precision, int x, int y,
+    const MACROBLOCKD *xd, int can_use_previous) {
   const int is_q4 = precision == MV_PRECISION_Q4;
   const MV mv_q4 = { is_q4 ? src_mv->row : src_mv->row * 2,
                      is_q4 ? src_mv->col : src_mv->col * 2 };
@@ -296,15 +441,54 @@ void av1_build_inter_predictor(const uint8_t *src, int src_stride, uint8_t *dst,
   const SubpelParams subpel_params = { sf->x_step_q4, sf->y_step_q4,
                                        mv.col & SCALE_SUBPEL_MASK,
                                        mv.row & SCALE_SUBPEL_MASK };
-  src += (mv.row >> SCALE_SUBPEL_BITS) * src_stride +
-         (mv.col >> SCALE_SUBPEL_BITS);
+  uint8_t *pre = (uint8_t *)src + (mv.row >> SCALE_SUBPEL_BITS) * src_stride +
+                 (mv.col >> SCALE_SUBPEL_BITS);
+
+  uint8_t *const mc_buf = get_buf_by_bd(xd, xd->mc_buf[ref]);
+  if (pre_buf != NULL && mc_buf != NULL) {
+    const ptrdiff_t offset = pre_buf->buf - pre_buf->buf0;
+    const int x0 =
+        (int)(offset % pre_buf->stride) + (mv.col >> SCALE_SUBPEL_BITS);
+    const int y0 =
+        (int)(offset / pre_buf->stride) + (mv.row >> SCALE_SUBPEL_BITS);
+    extend_mc_border(xd, pre_buf, &subpel_params, x0, y0, w, h, mc_buf, &pre,
+                     &src_stride);
+  }
 
-  av1_make_inter_predictor(src, src_stride, dst, dst_stride, &subpel_params, sf,
+  av1_make_inter_predictor(pre, src_stride, dst, dst_stride, &subpel_params, sf,
                            w, h, conv_params, interp_filters, warp_types, p_col,
                            p_row, plane, ref, xd->mi[0], 0, xd,
                            can_use_previous);
 }
 
+void av1_build_inter_predictor(const uint8_t *src, int src_stride, uint8_t *dst,
+                               int dst_stride, const MV *src_mv,
+                               const struct scale_factors *sf, int w, int h,
+                               ConvolveParams *conv_params,
+                               InterpFilters interp_filters,
+                               const WarpTypesAllowed *warp_types, int p_col,
+                               int p_row, int plane, int ref,
+                               mv_precision precision, int x, int y,
+                               const MACROBLOCKD *xd, int can_use_previous) {
+  build_inter_predictor(src, src_stride, NULL, dst, dst_stride, src_mv, sf, w,
+                        h, conv_params, interp_filters, warp_types, p_col,
+                        p_row, plane, ref, precision, x, y, xd,
+                        can_use_previous);
+}
+
+void av1_build_inter_predictor_from_buf(
+    const struct buf_2d *pre_buf, uint8_t *dst, int dst_stride,
+    const MV *src_mv, const struct scale_factors *sf, int w, int h,
+    ConvolveParams *conv_params, InterpFilters interp_filters,
+    const WarpTypesAllowed *warp_types, int p_col, int p_row, int plane,
+    int ref, mv_precision precision, int x, int y, const MACROBLOCKD *xd,
+    int can_use_previous) {
+  build_inter_predictor(pre_buf->buf, pre_buf->stride, pre_buf, dst,
+                        dst_stride, src_mv, sf, w, h, conv_params,
+                        interp_filters, warp_types, p_col, p_row, plane, ref,
+                        precision, x, y, xd, can_use_previous);
+}
+
 static INLINE void build_prediction_by_above_pred(
     MACROBLOCKD *xd, int rel_mi_col, uint8_t above_mi_width,
     MB_MODE_INFO *above_mbmi, void *fun_ctxt, const int num_planes) {
@@ -481,11 +665,13 @@ static void build_inter_predictors_single_buf(MACROBLOCKD *xd, int plane,
   const int pre_x = (mi_x) >> pd->subsampling_x;
   const int pre_y = (mi_y) >> pd->subsampling_y;
   uint8_t *pre;
+  int src_stride;
   SubpelParams subpel_params;
-  calc_subpel_params(xd, sf, mv, plane, pre_x, pre_y, x, y, pre_buf, &pre,
+  calc_subpel_params(xd, sf, mv, plane, pre_x, pre_y, x, y, pre_buf,
+                     get_buf_by_bd(xd, xd->mc_buf[ref]), &pre, &src_stride,
                      &subpel_params, bw, bh);
 
-  av1_make_inter_predictor(pre, pre_buf->stride, dst, ext_dst_stride,
+  av1_make_inter_predictor(pre, src_stride, dst, ext_dst_stride,
                            &subpel_params, sf, w, h, &conv_params,
                            mi->interp_filters, &warp_types, pre_x + x,
                            pre_y + y, plane, ref, mi, 0, xd, can_use_previous);
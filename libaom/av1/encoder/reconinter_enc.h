@@ -38,6 +38,17 @@ void av1_build_inter_predictor(const uint8_t *src, int src_stride, uint8_t *dst,
                                mv_precision precision, int x, int y,
                                const MACROBLOCKD *xd, int can_use_previous);
 
+// Like av1_build_inter_predictor() from pre_buf->buf, but also emulates the
+// edges of the frame of pre_buf where the prediction reads outside of it, as
+// the encoder does with a small border.
+void av1_build_inter_predictor_from_buf(
+    const struct buf_2d *pre_buf, uint8_t *dst, int dst_stride,
+    const MV *src_mv, const struct scale_factors *sf, int w, int h,
+    ConvolveParams *conv_params, InterpFilters interp_filters,
+    const WarpTypesAllowed *warp_types, int p_col, int p_row, int plane,
+    int ref, mv_precision precision, int x, int y, const MACROBLOCKD *xd,
+    int can_use_previous);
+
 // Detect if the block have sub-pixel level motion vectors
 // per component.
 #define CHECK_SUBPEL 0
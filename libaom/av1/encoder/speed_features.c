@@ -226,6 +226,7 @@ static void set_good_speed_features_framesize_independent(
   sf->prune_motion_mode_level = 1;
   sf->cb_pred_filter_search = 0;
   sf->use_nonrd_pick_mode = 0;
+  sf->use_fast_nonrd_pick_mode = 0;
   sf->use_real_time_ref_set = 0;
 
   if (speed >= 1) {
@@ -454,6 +455,7 @@ static void set_rt_speed_features_framesize_independent(AV1_COMP *cpi,
   sf->prune_motion_mode_level = 1;
   sf->cb_pred_filter_search = 0;
   sf->use_nonrd_pick_mode = 0;
+  sf->use_fast_nonrd_pick_mode = 0;
   sf->use_real_time_ref_set = 0;
 
   if (speed >= 1) {
@@ -613,6 +615,7 @@ static void set_rt_speed_features_framesize_independent(AV1_COMP *cpi,
     // and disabled TX64
     if (!cpi->oxcf.enable_tx64) sf->tx_size_search_method = USE_FAST_RD;
     sf->use_nonrd_pick_mode = 1;
+    sf->use_fast_nonrd_pick_mode = 1;
     sf->inter_mode_rd_model_estimation = 2;
   }
 }
@@ -681,6 +681,11 @@ typedef struct SPEED_FEATURES {
   // This flag controls the use of non-RD mode decision.
   int use_nonrd_pick_mode;
 
+  // Use the lightweight non-RD mode decision of nonrd_pickmode.c, which
+  // models the rate and distortion of a fixed set of modes from the variance
+  // of the prediction error. Only used along with use_nonrd_pick_mode.
+  int use_fast_nonrd_pick_mode;
+
   // prune wedge and compound segment approximate rd evaluation based on
   // compound average modeled rd
   int prune_comp_type_by_model_rd;
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+
+#include "av1/encoder/encoder.h"
+#include "av1/encoder/svc_layercontext.h"
+
+static LAYER_CONTEXT *get_layer_context(AV1_COMP *const cpi) {
+  SVC *const svc = &cpi->svc;
+  return &svc->layer_context[av1_svc_layer_index(svc, svc->spatial_layer_id,
+                                                 svc->temporal_layer_id)];
+}
+
+void av1_init_layer_context(AV1_COMP *const cpi,
+                            const aom_svc_params_t *params) {
+  AV1_COMMON *const cm = &cpi->common;
+  SVC *const svc = &cpi->svc;
+
+  svc->number_spatial_layers = params->number_spatial_layers;
+  svc->number_temporal_layers = params->number_temporal_layers;
+  // The first frame then starts a new superframe.
+  svc->spatial_layer_id = svc->number_spatial_layers - 1;
+  svc->temporal_layer_id = 0;
+  svc->superframe_index = -1;
+  svc->key_superframe = 0;
+  cm->number_spatial_layers = svc->number_spatial_layers;
+  cm->number_temporal_layers = svc->number_temporal_layers;
+
+  for (int sl = 0; sl < svc->number_spatial_layers; ++sl) {
+    for (int tl = 0; tl < svc->number_temporal_layers; ++tl) {
+      const int layer = av1_svc_layer_index(svc, sl, tl);
+      LAYER_CONTEXT *const lc = &svc->layer_context[layer];
+      lc->target_bandwidth =
+          (int64_t)params->layer_target_bitrate[layer] * 1000;
+      lc->max_q = av1_quantizer_to_qindex(params->max_quantizers[layer]);
+      lc->min_q = av1_quantizer_to_qindex(params->min_quantizers[layer]);
+      lc->scaling_factor_num = AOMMAX(params->scaling_factor_num[sl], 1);
+      lc->scaling_factor_den = AOMMAX(params->scaling_factor_den[sl], 1);
+      lc->framerate_factor = 1 << (svc->number_temporal_layers - 1 - tl);
+      lc->rc = cpi->rc;
+    }
+  }
+  av1_update_layer_context_change_config(cpi);
+
+  for (int layer = 0;
+       layer < svc->number_spatial_layers * svc->number_temporal_layers;
+       ++layer) {
+    LAYER_CONTEXT *const lc = &svc->layer_context[layer];
+    RATE_CONTROL *const lrc = &lc->rc;
+    av1_rc_init(&cpi->oxcf, 0, lrc);
+    lrc->avg_frame_qindex[KEY_FRAME] = lc->max_q;
+    lrc->avg_frame_qindex[INTER_FRAME] = lc->max_q;
+    lrc->last_q[KEY_FRAME] = lc->min_q;
+    lrc->last_q[INTER_FRAME] = lc->max_q;
+    lrc->ni_av_qi = lc->max_q;
+    lrc->avg_q = av1_convert_qindex_to_q(lc->max_q, cm->seq_params.bit_depth);
+  }
+}
+
+void av1_update_layer_context_change_config(AV1_COMP *const cpi) {
+  const AV1EncoderConfig *const oxcf = &cpi->oxcf;
+  SVC *const svc = &cpi->svc;
+
+  for (int layer = 0;
+       layer < svc->number_spatial_layers * svc->number_temporal_layers;
+       ++layer) {
+    LAYER_CONTEXT *const lc = &svc->layer_context[layer];
+    RATE_CONTROL *const lrc = &lc->rc;
+    const int64_t bandwidth = lc->target_bandwidth;
+
+    lrc->starting_buffer_level =
+        oxcf->starting_buffer_level_ms * bandwidth / 1000;
+    lrc->optimal_buffer_level =
+        oxcf->optimal_buffer_level_ms == 0
+            ? bandwidth / 8
+            : oxcf->optimal_buffer_level_ms * bandwidth / 1000;
+    lrc->maximum_buffer_size =
+        oxcf->maximum_buffer_size_ms == 0
+            ? bandwidth / 8
+            : oxcf->maximum_buffer_size_ms * bandwidth / 1000;
+    lrc->bits_off_target =
+        AOMMIN(lrc->bits_off_target, lrc->maximum_buffer_size);
+    lrc->buffer_level = AOMMIN(lrc->buffer_level, lrc->maximum_buffer_size);
+    lrc->worst_quality = lc->max_q;
+    lrc->best_quality = lc->min_q;
+
+    lc->framerate = cpi->framerate / lc->framerate_factor;
+    lrc->avg_frame_bandwidth = (int)(bandwidth / lc->framerate);
+    lrc->max_frame_bandwidth = cpi->rc.max_frame_bandwidth;
+  }
+}
+
+void av1_svc_start_frame(AV1_COMP *const cpi, int key_frame) {
+  AV1_COMMON *const cm = &cpi->common;
+  SVC *const svc = &cpi->svc;
+
+  if (svc->spatial_layer_id == svc->number_spatial_layers - 1) {
+    svc->spatial_layer_id = 0;
+    svc->key_superframe = key_frame;
+    svc->superframe_index = key_frame ? 0 : svc->superframe_index + 1;
+    // Dyadic patterns: 0-1-0-1 for two temporal layers and 0-2-1-2 for three.
+    switch (svc->number_temporal_layers) {
+      case 3: {
+        static const int kPattern[4] = { 0, 2, 1, 2 };
+        svc->temporal_layer_id = kPattern[svc->superframe_index & 3];
+        break;
+      }
+      case 2: svc->temporal_layer_id = svc->superframe_index & 1; break;
+      default: svc->temporal_layer_id = 0; break;
+    }
+  } else {
+    ++svc->spatial_layer_id;
+  }
+  cm->spatial_layer_id = svc->spatial_layer_id;
+  cm->temporal_layer_id = svc->temporal_layer_id;
+}
+
+void av1_update_temporal_layer_framerate(AV1_COMP *const cpi) {
+  SVC *const svc = &cpi->svc;
+  const int tl = svc->temporal_layer_id;
+  LAYER_CONTEXT *const lc = get_layer_context(cpi);
+  RATE_CONTROL *const lrc = &lc->rc;
+
+  lc->framerate = cpi->framerate / lc->framerate_factor;
+  lrc->avg_frame_bandwidth = (int)(lc->target_bandwidth / lc->framerate);
+  lrc->max_frame_bandwidth = cpi->rc.max_frame_bandwidth;
+  if (tl == 0) {
+    lc->avg_frame_size = lrc->avg_frame_bandwidth;
+  } else {
+    const LAYER_CONTEXT *const lcprev = lc - 1;
+    const double prev_framerate = cpi->framerate / lcprev->framerate_factor;
+    const int64_t prev_bandwidth = lcprev->target_bandwidth;
+    lc->avg_frame_size = (int)((lc->target_bandwidth - prev_bandwidth) /
+                               (lc->framerate - prev_framerate));
+  }
+}
+
+void av1_restore_layer_context(AV1_COMP *const cpi) {
+  LAYER_CONTEXT *const lc = get_layer_context(cpi);
+  const int old_frames_since_key = cpi->rc.frames_since_key;
+  const int old_frames_to_key = cpi->rc.frames_to_key;
+
+  cpi->rc = lc->rc;
+  // The key frame counters belong to the stream, not to the layer.
+  cpi->rc.frames_since_key = old_frames_since_key;
+  cpi->rc.frames_to_key = old_frames_to_key;
+}
+
+void av1_save_layer_context(AV1_COMP *const cpi) {
+  get_layer_context(cpi)->rc = cpi->rc;
+}
+
+void av1_update_layer_buffer_level(AV1_COMP *const cpi,
+                                   int encoded_frame_size) {
+  SVC *const svc = &cpi->svc;
+  for (int tl = svc->temporal_layer_id + 1; tl < svc->number_temporal_layers;
+       ++tl) {
+    LAYER_CONTEXT *const lc = &svc->layer_context[av1_svc_layer_index(
+        svc, svc->spatial_layer_id, tl)];
+    RATE_CONTROL *const lrc = &lc->rc;
+    lrc->bits_off_target +=
+        (int)(lc->target_bandwidth / lc->framerate) - encoded_frame_size;
+    lrc->bits_off_target =
+        AOMMIN(lrc->bits_off_target, lrc->maximum_buffer_size);
+    lrc->buffer_level = lrc->bits_off_target;
+  }
+}
+
+void av1_get_layer_resolution(const int width_org, const int height_org,
+                              const int num, const int den, int *width_out,
+                              int *height_out) {
+  assert(num > 0 && den > 0);
+  int w = (int)((int64_t)width_org * num / den);
+  int h = (int)((int64_t)height_org * num / den);
+  // Keep the chroma planes of 4:2:0 layers aligned.
+  w += w & 1;
+  h += h & 1;
+  *width_out = AOMMIN(w, width_org);
+  *height_out = AOMMIN(h, height_org);
+}
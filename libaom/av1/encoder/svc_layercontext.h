@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#ifndef AOM_AV1_ENCODER_SVC_LAYERCONTEXT_H_
+#define AOM_AV1_ENCODER_SVC_LAYERCONTEXT_H_
+
+#include "aom/aomcx.h"
+
+#include "av1/encoder/ratectrl.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  // Rate control state of the layer, swapped into cpi->rc while one of its
+  // frames is coded.
+  RATE_CONTROL rc;
+  // Bitrate of the layer, including the lower temporal layers of the same
+  // spatial layer, in bits per second.
+  int64_t target_bandwidth;
+  double framerate;
+  // Average size of the frames of this temporal layer alone.
+  int avg_frame_size;
+  int max_q;
+  int min_q;
+  int scaling_factor_num;
+  int scaling_factor_den;
+  // Frames of this layer are coded at 1 / framerate_factor of the input rate.
+  int framerate_factor;
+} LAYER_CONTEXT;
+
+typedef struct SVC {
+  int number_spatial_layers;
+  int number_temporal_layers;
+  // Layer of the frame being coded.
+  int spatial_layer_id;
+  int temporal_layer_id;
+  // Position of the current superframe in the temporal pattern, restarted by
+  // key frames.
+  int superframe_index;
+  // Set when spatial layer 0 of the current superframe is a key frame, so
+  // the other spatial layers may only predict from the layer below.
+  int key_superframe;
+  LAYER_CONTEXT layer_context[AOM_MAX_LAYERS];
+} SVC;
+
+struct AV1_COMP;
+
+static INLINE int av1_svc_layer_index(const SVC *svc, int spatial_layer_id,
+                                      int temporal_layer_id) {
+  return spatial_layer_id * svc->number_temporal_layers + temporal_layer_id;
+}
+
+// Sets up the layer contexts from the layer parameters and resets their rate
+// control state. Must be called before the first frame.
+void av1_init_layer_context(struct AV1_COMP *const cpi,
+                            const aom_svc_params_t *params);
+
+// Updates the layer bitrates and buffer sizes after a configuration change.
+void av1_update_layer_context_change_config(struct AV1_COMP *const cpi);
+
+// Picks the spatial and temporal layer of the next frame. A new superframe
+// starts after the top spatial layer and 'key_frame' restarts the temporal
+// pattern; it is ignored for the other spatial layers.
+void av1_svc_start_frame(struct AV1_COMP *const cpi, int key_frame);
+
+// Updates the frame rate and frame size targets of the current layer from
+// cpi->framerate.
+void av1_update_temporal_layer_framerate(struct AV1_COMP *const cpi);
+
+// Swaps the rate control state of the current layer into cpi->rc, keeping the
+// key frame counters of the stream.
+void av1_restore_layer_context(struct AV1_COMP *const cpi);
+
+// Saves cpi->rc back into the current layer after the frame is coded.
+void av1_save_layer_context(struct AV1_COMP *const cpi);
+
+// Adds the bits of the coded frame to the buffers of the higher temporal
+// layers of the same spatial layer, whose bitrates include it.
+void av1_update_layer_buffer_level(struct AV1_COMP *const cpi,
+                                   int encoded_frame_size);
+
+// Returns the coded size of a spatial layer.
+void av1_get_layer_resolution(const int width_org, const int height_org,
+                              const int num, const int den, int *width_out,
+                              int *height_out);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif
+
+#endif  // AOM_AV1_ENCODER_SVC_LAYERCONTEXT_H_
@@ -967,9 +967,10 @@ static void temporal_filter_iterate_c(AV1_COMP *cpi,
             } else {
               if (num_planes <= 1) {
                 // Single plane case
-                av1_temporal_filter_apply_c(
-                    f->y_buffer + mb_y_src_offset, f->y_stride, predictor, BW,
-                    BH, strength, blk_fw, use_32x32, accumulator, count);
+                av1_temporal_filter_apply(f->y_buffer + mb_y_src_offset,
+                                          f->y_stride, predictor, BW, BH,
+                                          strength, blk_fw, use_32x32,
+                                          accumulator, count);
               } else {
                 // Process 3 planes together.
                 av1_apply_temporal_filter(
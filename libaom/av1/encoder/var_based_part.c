@@ -498,21 +498,31 @@ int av1_choose_var_based_partitioning(AV1_COMP *cpi, const TileInfo *const tile,
   force_split[0] = 0;
 
   if (!is_key_frame) {
-    // TODO(kyslov): we are assuming that the ref is LAST_FRAME! Check if it
-    // is!!
+    // Partition against LAST_FRAME, or GOLDEN_FRAME when LAST_FRAME is not
+    // available (the upper spatial layers of a key superframe).
     MB_MODE_INFO *mi = xd->mi[0];
-    const YV12_BUFFER_CONFIG *yv12 = get_ref_frame_yv12_buf(cm, LAST_FRAME);
+    const MV_REFERENCE_FRAME ref_frame =
+        (cpi->ref_frame_flags & av1_ref_frame_flag_list[LAST_FRAME])
+            ? LAST_FRAME
+            : GOLDEN_FRAME;
+    const YV12_BUFFER_CONFIG *yv12 = get_ref_frame_yv12_buf(cm, ref_frame);
+    const struct scale_factors *const sf =
+        get_ref_scale_factors_const(cm, ref_frame);
 
     assert(yv12 != NULL);
 
-    av1_setup_pre_planes(xd, 0, yv12, mi_row, mi_col,
-                         get_ref_scale_factors(cm, LAST_FRAME), num_planes);
-    mi->ref_frame[0] = LAST_FRAME;
+    av1_setup_pre_planes(xd, 0, yv12, mi_row, mi_col, sf, num_planes);
+    mi->ref_frame[0] = ref_frame;
     mi->ref_frame[1] = NONE_FRAME;
     mi->sb_type = cm->seq_params.sb_size;
     mi->mv[0].as_int = 0;
     mi->interp_filters = av1_make_interp_filters(BILINEAR, BILINEAR);
-    if (xd->mb_to_right_edge >= 0 && xd->mb_to_bottom_edge >= 0) {
+    // The projection search needs an unscaled reference with a border of
+    // half the superblock.
+    if (xd->mb_to_right_edge >= 0 && xd->mb_to_bottom_edge >= 0 &&
+        !av1_is_scaled(sf) &&
+        block_size_wide[cm->seq_params.sb_size] / 2 <
+            cpi->oxcf.border_in_pixels) {
       const MV dummy_mv = { 0, 0 };
       av1_int_pro_motion_estimation(cpi, x, cm->seq_params.sb_size, mi_row,
                                     mi_col, &dummy_mv);
@@ -524,7 +534,7 @@ int av1_choose_var_based_partitioning(AV1_COMP *cpi, const TileInfo *const tile,
                                    xd->plane[0].pre[0].buf,
                                    xd->plane[0].pre[0].stride);
 #endif
-    x->pred_mv[LAST_FRAME] = mi->mv[0].as_mv;
+    x->pred_mv[ref_frame] = mi->mv[0].as_mv;
 
     set_ref_ptrs(cm, xd, mi->ref_frame[0], mi->ref_frame[1]);
     av1_enc_build_inter_predictor(cm, xd, mi_row, mi_col, NULL,
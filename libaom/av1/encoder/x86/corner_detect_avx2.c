@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <immintrin.h>
+
+#include "config/av1_rtcd.h"
+
+#include "aom/aom_integer.h"
+#include "aom_ports/mem.h"
+
+// Offsets of the 16 pixels of the Bresenham circle of radius 3, in the same
+// order as in corner_detect.c.
+static const int circle_x[16] = { 0, 1, 2, 3,  3,  3,  2,  1,
+                                  0, -1, -2, -3, -3, -3, -2, -1 };
+static const int circle_y[16] = { 3,  3,  2,  1,  0,  -1, -2, -3,
+                                  -3, -3, -2, -1, 0,  1,  2,  3 };
+
+// Returns, for each of the 32 pixels, the largest value v such that 9
+// contiguous entries of d are all >= v.
+static INLINE __m256i arc9_min_avx2(const __m256i *d) {
+  __m256i m2[16], m4[16], res = _mm256_setzero_si256();
+  int i;
+  for (i = 0; i < 16; ++i) m2[i] = _mm256_min_epu8(d[i], d[(i + 1) & 15]);
+  for (i = 0; i < 16; ++i) m4[i] = _mm256_min_epu8(m2[i], m2[(i + 2) & 15]);
+  for (i = 0; i < 16; ++i) {
+    const __m256i m8 = _mm256_min_epu8(m4[i], m4[(i + 4) & 15]);
+    res = _mm256_max_epu8(res, _mm256_min_epu8(m8, d[(i + 8) & 15]));
+  }
+  return res;
+}
+
+// Segment test and score of 32 consecutive pixels starting at p. Returns one
+// bit per corner, and the scores plus 1 in score.
+//
+// With saturating differences, bright[k] = max(p[k] - c, 0) and
+// dark[k] = max(c - p[k], 0), a pixel is a corner if some arc of 9 has all its
+// differences > threshold in one direction, and its score is the best such
+// arc minimum, minus 1 (see fast9_score() in corner_detect.c).
+static INLINE uint32_t fast9_detect_32_avx2(const unsigned char *p,
+                                            const int *pixel, __m256i thresh,
+                                            __m256i *score) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i c = _mm256_loadu_si256((const __m256i *)p);
+  __m256i bright[16], dark[16];
+  __m256i any, best;
+  int i;
+
+  // Any arc of 9 pixels covers 2 adjacent compass points; skip the full test
+  // when none of the 32 pixels passes that.
+  for (i = 0; i < 16; i += 4) {
+    const __m256i v = _mm256_loadu_si256((const __m256i *)(p + pixel[i]));
+    bright[i] = _mm256_subs_epu8(v, c);
+    dark[i] = _mm256_subs_epu8(c, v);
+  }
+  any = zero;
+  for (i = 0; i < 16; i += 4) {
+    any = _mm256_max_epu8(
+        any, _mm256_min_epu8(bright[i], bright[(i + 4) & 15]));
+    any = _mm256_max_epu8(any, _mm256_min_epu8(dark[i], dark[(i + 4) & 15]));
+  }
+  any = _mm256_subs_epu8(any, thresh);
+  if (_mm256_testz_si256(any, any)) return 0;
+
+  for (i = 0; i < 16; ++i) {
+    if (i % 4 != 0) {
+      const __m256i v = _mm256_loadu_si256((const __m256i *)(p + pixel[i]));
+      bright[i] = _mm256_subs_epu8(v, c);
+      dark[i] = _mm256_subs_epu8(c, v);
+    }
+  }
+  best = _mm256_max_epu8(arc9_min_avx2(bright), arc9_min_avx2(dark));
+  *score = best;
+  // Corners are the pixels with best > threshold.
+  return ~(uint32_t)_mm256_movemask_epi8(
+      _mm256_cmpeq_epi8(_mm256_subs_epu8(best, thresh), zero));
+}
+
+int av1_fast9_detect_row_avx2(const unsigned char *row, int stride, int width,
+                              int threshold, int *xs, int *scores) {
+  const __m256i thresh = _mm256_set1_epi8((char)threshold);
+  const int x_end = width - 3;
+  DECLARE_ALIGNED(32, uint8_t, score[32]);
+  int pixel[16];
+  int num = 0;
+  int x, i;
+
+  if (x_end - 3 < 32 || threshold < 0 || threshold > 254) {
+    return av1_fast9_detect_row_c(row, stride, width, threshold, xs, scores);
+  }
+
+  for (i = 0; i < 16; ++i) pixel[i] = circle_x[i] + circle_y[i] * stride;
+
+  for (x = 3; x < x_end; x += 32) {
+    __m256i score_v;
+    uint32_t mask;
+    int x0 = x;
+    // The last block is moved back to end at x_end, and the pixels that were
+    // already tested are dropped.
+    if (x0 + 32 > x_end) x0 = x_end - 32;
+    mask = fast9_detect_32_avx2(row + x0, pixel, thresh, &score_v);
+    if (!mask) continue;
+    _mm256_store_si256((__m256i *)score, score_v);
+    for (i = x - x0, mask >>= i; mask; ++i, mask >>= 1) {
+      if (mask & 1) {
+        xs[num] = x0 + i;
+        scores[num++] = score[i] - 1;
+      }
+    }
+  }
+  return num;
+}
@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "config/av1_rtcd.h"
+#include "aom/aom_integer.h"
+#include "av1/encoder/encoder.h"
+#include "av1/encoder/temporal_filter.h"
+#include "av1/encoder/x86/temporal_filter_constants.h"
+
+// The distortion buffers hold one row of zeros above and below the block, and
+// one column of zeros to the left and right of it, so the out-of-block
+// neighbors contribute 0 to the 3x3 sums.
+#define DIST_ROWS ((BH) + 2)
+
+// Multipliers replicating "modifier * 3 / index" with a 32-bit down shift,
+// indexed by the number of summed values.
+static const uint32_t highbd_index_mult[14] = { 0U,
+                                                0U,
+                                                0U,
+                                                0U,
+                                                HIGHBD_NEIGHBOR_CONSTANT_4,
+                                                HIGHBD_NEIGHBOR_CONSTANT_5,
+                                                HIGHBD_NEIGHBOR_CONSTANT_6,
+                                                HIGHBD_NEIGHBOR_CONSTANT_7,
+                                                HIGHBD_NEIGHBOR_CONSTANT_8,
+                                                HIGHBD_NEIGHBOR_CONSTANT_9,
+                                                HIGHBD_NEIGHBOR_CONSTANT_10,
+                                                HIGHBD_NEIGHBOR_CONSTANT_11,
+                                                0U,
+                                                HIGHBD_NEIGHBOR_CONSTANT_13 };
+
+// Fill the per-column multipliers for the first and last rows ('edge') and
+// the other rows ('mid') of a plane. 'extra' is the number of values from the
+// other planes added to each modifier.
+static INLINE void highbd_get_index_mult(unsigned int width, int extra,
+                                         uint32_t *edge, uint32_t *mid) {
+  unsigned int col;
+  for (col = 0; col < width; ++col) {
+    const int num_cols = (col == 0 || col == width - 1) ? 2 : 3;
+    edge[col] = highbd_index_mult[2 * num_cols + extra];
+    mid[col] = highbd_index_mult[3 * num_cols + extra];
+  }
+}
+
+// Fill the per-column filter weights of the top and bottom halves of a plane.
+static INLINE void highbd_get_filter_weights(unsigned int width,
+                                             const int *blk_fw,
+                                             int use_whole_blk, int32_t *top,
+                                             int32_t *bottom) {
+  unsigned int col;
+  for (col = 0; col < width; ++col) {
+    const int right = !use_whole_blk && col >= width / 2;
+    top[col] = blk_fw[right];
+    bottom[col] = use_whole_blk ? blk_fw[0] : blk_fw[2 + right];
+  }
+}
+
+// Compute (a-b)**2 for 8 pixels with size 16-bit
+static INLINE void highbd_store_dist_8(const uint16_t *a, const uint16_t *b,
+                                       uint32_t *dst) {
+  const __m256i a_reg =
+      _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)a));
+  const __m256i b_reg =
+      _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)b));
+  const __m256i dist = _mm256_sub_epi32(a_reg, b_reg);
+
+  _mm256_storeu_si256((__m256i *)dst, _mm256_mullo_epi32(dist, dist));
+}
+
+static INLINE void highbd_store_dist_plane(const uint16_t *src, int src_stride,
+                                           const uint16_t *pre, int pre_stride,
+                                           unsigned int width,
+                                           unsigned int height,
+                                           uint32_t *dist) {
+  unsigned int row, col;
+  for (row = 0; row < height; ++row) {
+    for (col = 0; col < width; col += 8) {
+      highbd_store_dist_8(src + col, pre + col, dist + col);
+    }
+    src += src_stride;
+    pre += pre_stride;
+    dist += DIST_STRIDE;
+  }
+}
+
+// For each of the 8 values starting at dist, compute dist[i - 1] + dist[i] +
+// dist[i + 1].
+static INLINE __m256i highbd_get_sum_8(const uint32_t *dist) {
+  const __m256i left = _mm256_loadu_si256((const __m256i *)(dist - 1));
+  const __m256i center = _mm256_loadu_si256((const __m256i *)dist);
+  const __m256i right = _mm256_loadu_si256((const __m256i *)(dist + 1));
+
+  return _mm256_add_epi32(_mm256_add_epi32(left, center), right);
+}
+
+// Read the chroma distortion corresponding to 8 luma values.
+static INLINE __m256i highbd_read_chroma_dist_8(const uint32_t *dist,
+                                                int ss_x) {
+  if (!ss_x) return _mm256_loadu_si256((const __m256i *)dist);
+
+  // Duplicate each of the 4 chroma values.
+  const __m256i dist_u64 =
+      _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *)dist));
+  return _mm256_or_si256(dist_u64, _mm256_slli_epi64(dist_u64, 32));
+}
+
+// Sum the luma distortion corresponding to 8 chroma values.
+static INLINE __m256i highbd_read_luma_dist_8(const uint32_t *dist, int ss_x,
+                                              int ss_y) {
+  if (!ss_x) {
+    __m256i sum = _mm256_loadu_si256((const __m256i *)dist);
+    if (ss_y) {
+      sum = _mm256_add_epi32(
+          sum, _mm256_loadu_si256((const __m256i *)(dist + DIST_STRIDE)));
+    }
+    return sum;
+  }
+
+  __m256i first = _mm256_loadu_si256((const __m256i *)dist);
+  __m256i second = _mm256_loadu_si256((const __m256i *)(dist + 8));
+  if (ss_y) {
+    first = _mm256_add_epi32(
+        first, _mm256_loadu_si256((const __m256i *)(dist + DIST_STRIDE)));
+    second = _mm256_add_epi32(
+        second, _mm256_loadu_si256((const __m256i *)(dist + DIST_STRIDE + 8)));
+  }
+
+  // _mm256_hadd_epi32 works within 128-bit lanes; restore the column order.
+  return _mm256_permute4x64_epi64(_mm256_hadd_epi32(first, second), 0xd8);
+}
+
+// Compute (sum * mult) >> 32 for unsigned 32-bit values.
+static INLINE __m256i highbd_mulhi_epu32(const __m256i sum,
+                                         const __m256i mult) {
+  const __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(sum, mult), 32);
+  const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(sum, 32),
+                                       _mm256_srli_epi64(mult, 32));
+
+  return _mm256_blend_epi32(even, odd, 0xaa);
+}
+
+// Average the summed distortion, add in the rounding factor and shift, clamp
+// to 16, invert and multiply by the filter weight.
+static INLINE __m256i highbd_get_modifier_8(__m256i sum, const uint32_t *mult,
+                                            const int32_t *weight,
+                                            const __m128i strength,
+                                            const __m256i rounding) {
+  const __m256i sixteen = _mm256_set1_epi32(16);
+
+  sum = highbd_mulhi_epu32(sum, _mm256_loadu_si256((const __m256i *)mult));
+  sum = _mm256_add_epi32(sum, rounding);
+  sum = _mm256_srl_epi32(sum, strength);
+  sum = _mm256_min_epi32(sum, sixteen);
+  sum = _mm256_sub_epi32(sixteen, sum);
+
+  return _mm256_mullo_epi32(sum, _mm256_loadu_si256((const __m256i *)weight));
+}
+
+// Add 'mod' to 'count'. Multiply by 'pred' and add to 'accumulator'.
+static INLINE void highbd_accumulate_and_store_8(const __m256i mod,
+                                                 const uint16_t *pred,
+                                                 uint16_t *count,
+                                                 uint32_t *accumulator) {
+  const __m256i pred_u32 =
+      _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)pred));
+  const __m128i mod_u16 = _mm_packus_epi32(_mm256_castsi256_si128(mod),
+                                           _mm256_extracti128_si256(mod, 1));
+  const __m128i count_u16 = _mm_loadu_si128((const __m128i *)count);
+  const __m256i accum = _mm256_loadu_si256((const __m256i *)accumulator);
+
+  _mm_storeu_si128((__m128i *)count, _mm_add_epi16(count_u16, mod_u16));
+  _mm256_storeu_si256(
+      (__m256i *)accumulator,
+      _mm256_add_epi32(accum, _mm256_mullo_epi32(mod, pred_u32)));
+}
+
+// Apply temporal filter to the luma component.
+static void highbd_apply_temporal_filter_luma(
+    const uint16_t *y_pre, int y_pre_stride, unsigned int block_width,
+    unsigned int block_height, int ss_x, int ss_y, int strength,
+    const int *blk_fw, int use_whole_blk, uint32_t *y_accum, uint16_t *y_count,
+    const uint32_t *y_dist, const uint32_t *u_dist, const uint32_t *v_dist) {
+  const __m128i strength_u128 = _mm_cvtsi32_si128(strength);
+  const __m256i rounding = _mm256_set1_epi32((1 << strength) >> 1);
+  DECLARE_ALIGNED(32, uint32_t, mult_edge[BW]);
+  DECLARE_ALIGNED(32, uint32_t, mult_mid[BW]);
+  DECLARE_ALIGNED(32, int32_t, weight_top[BW]);
+  DECLARE_ALIGNED(32, int32_t, weight_bottom[BW]);
+  unsigned int row, col;
+
+  // Each luma modifier also sums one u and one v value.
+  highbd_get_index_mult(block_width, 2, mult_edge, mult_mid);
+  highbd_get_filter_weights(block_width, blk_fw, use_whole_blk, weight_top,
+                            weight_bottom);
+
+  for (col = 0; col < block_width; col += 8) {
+    const uint32_t *dist = y_dist + col;
+    __m256i sum_row_1 = highbd_get_sum_8(dist - DIST_STRIDE);
+    __m256i sum_row_2 = highbd_get_sum_8(dist);
+
+    for (row = 0; row < block_height; ++row) {
+      const __m256i sum_row_3 = highbd_get_sum_8(dist + DIST_STRIDE);
+      const int uv_offset = (row >> ss_y) * DIST_STRIDE + (col >> ss_x);
+      const uint32_t *mult =
+          (row == 0 || row == block_height - 1) ? mult_edge : mult_mid;
+      const int32_t *weight =
+          (row < block_height / 2) ? weight_top : weight_bottom;
+      __m256i sum;
+
+      sum = _mm256_add_epi32(sum_row_1, sum_row_2);
+      sum = _mm256_add_epi32(sum, sum_row_3);
+      sum = _mm256_add_epi32(
+          sum, highbd_read_chroma_dist_8(u_dist + uv_offset, ss_x));
+      sum = _mm256_add_epi32(
+          sum, highbd_read_chroma_dist_8(v_dist + uv_offset, ss_x));
+
+      highbd_accumulate_and_store_8(
+          highbd_get_modifier_8(sum, mult + col, weight + col, strength_u128,
+                                rounding),
+          y_pre + row * y_pre_stride + col, y_count + row * block_width + col,
+          y_accum + row * block_width + col);
+
+      sum_row_1 = sum_row_2;
+      sum_row_2 = sum_row_3;
+      dist += DIST_STRIDE;
+    }
+  }
+}
+
+// Apply temporal filter to the chroma components.
+static void highbd_apply_temporal_filter_chroma(
+    const uint16_t *u_pre, const uint16_t *v_pre, int uv_pre_stride,
+    unsigned int block_width, unsigned int block_height, int ss_x, int ss_y,
+    int strength, const int *blk_fw, int use_whole_blk, uint32_t *u_accum,
+    uint16_t *u_count, uint32_t *v_accum, uint16_t *v_count,
+    const uint32_t *y_dist, const uint32_t *u_dist, const uint32_t *v_dist) {
+  const unsigned int uv_width = block_width >> ss_x;
+  const unsigned int uv_height = block_height >> ss_y;
+  const __m128i strength_u128 = _mm_cvtsi32_si128(strength);
+  const __m256i rounding = _mm256_set1_epi32((1 << strength) >> 1);
+  DECLARE_ALIGNED(32, uint32_t, mult_edge[BW]);
+  DECLARE_ALIGNED(32, uint32_t, mult_mid[BW]);
+  DECLARE_ALIGNED(32, int32_t, weight_top[BW]);
+  DECLARE_ALIGNED(32, int32_t, weight_bottom[BW]);
+  unsigned int row, col;
+
+  // Each chroma modifier also sums all the co-located luma values.
+  highbd_get_index_mult(uv_width, (1 + ss_x) * (1 + ss_y), mult_edge,
+                        mult_mid);
+  highbd_get_filter_weights(uv_width, blk_fw, use_whole_blk, weight_top,
+                            weight_bottom);
+
+  for (col = 0; col < uv_width; col += 8) {
+    const uint32_t *u = u_dist + col;
+    const uint32_t *v = v_dist + col;
+    __m256i u_sum_row_1 = highbd_get_sum_8(u - DIST_STRIDE);
+    __m256i u_sum_row_2 = highbd_get_sum_8(u);
+    __m256i v_sum_row_1 = highbd_get_sum_8(v - DIST_STRIDE);
+    __m256i v_sum_row_2 = highbd_get_sum_8(v);
+
+    for (row = 0; row < uv_height; ++row) {
+      const __m256i u_sum_row_3 = highbd_get_sum_8(u + DIST_STRIDE);
+      const __m256i v_sum_row_3 = highbd_get_sum_8(v + DIST_STRIDE);
+      const __m256i y_sum = highbd_read_luma_dist_8(
+          y_dist + (row << ss_y) * DIST_STRIDE + (col << ss_x), ss_x, ss_y);
+      const uint32_t *mult =
+          (row == 0 || row == uv_height - 1) ? mult_edge : mult_mid;
+      const int32_t *weight =
+          (row < uv_height / 2) ? weight_top : weight_bottom;
+      const int pre_offset = row * uv_pre_stride + col;
+      const int out_offset = row * uv_width + col;
+      __m256i u_sum, v_sum;
+
+      u_sum = _mm256_add_epi32(u_sum_row_1, u_sum_row_2);
+      u_sum = _mm256_add_epi32(u_sum, u_sum_row_3);
+      u_sum = _mm256_add_epi32(u_sum, y_sum);
+      v_sum = _mm256_add_epi32(v_sum_row_1, v_sum_row_2);
+      v_sum = _mm256_add_epi32(v_sum, v_sum_row_3);
+      v_sum = _mm256_add_epi32(v_sum, y_sum);
+
+      highbd_accumulate_and_store_8(
+          highbd_get_modifier_8(u_sum, mult + col, weight + col, strength_u128,
+                                rounding),
+          u_pre + pre_offset, u_count + out_offset, u_accum + out_offset);
+      highbd_accumulate_and_store_8(
+          highbd_get_modifier_8(v_sum, mult + col, weight + col, strength_u128,
+                                rounding),
+          v_pre + pre_offset, v_count + out_offset, v_accum + out_offset);
+
+      u_sum_row_1 = u_sum_row_2;
+      u_sum_row_2 = u_sum_row_3;
+      v_sum_row_1 = v_sum_row_2;
+      v_sum_row_2 = v_sum_row_3;
+      u += DIST_STRIDE;
+      v += DIST_STRIDE;
+    }
+  }
+}
+
+void av1_highbd_apply_temporal_filter_avx2(
+    const uint8_t *yf, int y_src_stride, const uint8_t *yp, int y_pre_stride,
+    const uint8_t *uf, const uint8_t *vf, int uv_src_stride, const uint8_t *up,
+    const uint8_t *vp, int uv_pre_stride, unsigned int block_width,
+    unsigned int block_height, int ss_x, int ss_y, int strength,
+    const int *blk_fw, int use_whole_blk, uint32_t *y_accum, uint16_t *y_count,
+    uint32_t *u_accum, uint16_t *u_count, uint32_t *v_accum,
+    uint16_t *v_count) {
+  const unsigned int chroma_height = block_height >> ss_y,
+                     chroma_width = block_width >> ss_x;
+
+  DECLARE_ALIGNED(32, uint32_t, y_dist[DIST_ROWS * DIST_STRIDE]) = { 0 };
+  DECLARE_ALIGNED(32, uint32_t, u_dist[DIST_ROWS * DIST_STRIDE]) = { 0 };
+  DECLARE_ALIGNED(32, uint32_t, v_dist[DIST_ROWS * DIST_STRIDE]) = { 0 };
+
+  // Skip the top row and the left column of zeros.
+  uint32_t *y_dist_ptr = y_dist + DIST_STRIDE + 1,
+           *u_dist_ptr = u_dist + DIST_STRIDE + 1,
+           *v_dist_ptr = v_dist + DIST_STRIDE + 1;
+
+  const uint16_t *y_src = CONVERT_TO_SHORTPTR(yf),
+                 *u_src = CONVERT_TO_SHORTPTR(uf),
+                 *v_src = CONVERT_TO_SHORTPTR(vf);
+  const uint16_t *y_pre = CONVERT_TO_SHORTPTR(yp),
+                 *u_pre = CONVERT_TO_SHORTPTR(up),
+                 *v_pre = CONVERT_TO_SHORTPTR(vp);
+
+  assert(block_width <= BW && "block width too large");
+  assert(block_height <= BH && "block height too large");
+  assert(block_width % 16 == 0 && "block width must be multiple of 16");
+  assert(block_height % 2 == 0 && "block height must be even");
+  assert((ss_x == 0 || ss_x == 1) && (ss_y == 0 || ss_y == 1) &&
+         "invalid chroma subsampling");
+  assert(strength >= 0 && strength <= 14 &&
+         "invalid adjusted temporal filter strength");
+  assert(blk_fw[0] >= 0 && "filter weight must be positive");
+  assert(
+      (use_whole_blk || (blk_fw[1] >= 0 && blk_fw[2] >= 0 && blk_fw[3] >= 0)) &&
+      "subblock filter weight must be positive");
+  assert(blk_fw[0] <= 2 && "sublock filter weight must be less than 2");
+  assert(
+      (use_whole_blk || (blk_fw[1] <= 2 && blk_fw[2] <= 2 && blk_fw[3] <= 2)) &&
+      "subblock filter weight must be less than 2");
+
+  // Precompute the difference squared
+  highbd_store_dist_plane(y_src, y_src_stride, y_pre, y_pre_stride,
+                          block_width, block_height, y_dist_ptr);
+  highbd_store_dist_plane(u_src, uv_src_stride, u_pre, uv_pre_stride,
+                          chroma_width, chroma_height, u_dist_ptr);
+  highbd_store_dist_plane(v_src, uv_src_stride, v_pre, uv_pre_stride,
+                          chroma_width, chroma_height, v_dist_ptr);
+
+  highbd_apply_temporal_filter_luma(y_pre, y_pre_stride, block_width,
+                                    block_height, ss_x, ss_y, strength, blk_fw,
+                                    use_whole_blk, y_accum, y_count, y_dist_ptr,
+                                    u_dist_ptr, v_dist_ptr);
+
+  highbd_apply_temporal_filter_chroma(
+      u_pre, v_pre, uv_pre_stride, block_width, block_height, ss_x, ss_y,
+      strength, blk_fw, use_whole_blk, u_accum, u_count, v_accum, v_count,
+      y_dist_ptr, u_dist_ptr, v_dist_ptr);
+}
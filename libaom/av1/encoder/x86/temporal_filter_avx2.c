@@ -0,0 +1,500 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <assert.h>
+#include <immintrin.h>
+
+#include "config/av1_rtcd.h"
+#include "aom/aom_integer.h"
+#include "av1/encoder/encoder.h"
+#include "av1/encoder/temporal_filter.h"
+#include "av1/encoder/x86/temporal_filter_constants.h"
+
+// The distortion buffers hold one row of zeros above and below the block, and
+// one column of zeros to the left and right of it. That lets the 3x3
+// neighborhood sums be computed without any edge special cases: the
+// out-of-block neighbors simply contribute 0.
+#define DIST_ROWS ((BH) + 2)
+
+// Multipliers replicating "modifier * 3 / index", indexed by the number of
+// summed values. See temporal_filter_constants.h.
+static const uint16_t index_mult[14] = { 0,
+                                         0,
+                                         0,
+                                         0,
+                                         (uint16_t)NEIGHBOR_CONSTANT_4,
+                                         (uint16_t)NEIGHBOR_CONSTANT_5,
+                                         (uint16_t)NEIGHBOR_CONSTANT_6,
+                                         (uint16_t)NEIGHBOR_CONSTANT_7,
+                                         (uint16_t)NEIGHBOR_CONSTANT_8,
+                                         (uint16_t)NEIGHBOR_CONSTANT_9,
+                                         (uint16_t)NEIGHBOR_CONSTANT_10,
+                                         (uint16_t)NEIGHBOR_CONSTANT_11,
+                                         0,
+                                         (uint16_t)NEIGHBOR_CONSTANT_13 };
+
+// Fill the per-column multipliers for a plane of the given width. 'edge' is
+// used for the first and last rows (2 rows of neighbors), 'mid' for all the
+// others (3 rows of neighbors). 'extra' is the number of values from the other
+// planes added to each modifier.
+static INLINE void get_index_mult(unsigned int width, int extra,
+                                  uint16_t *edge, uint16_t *mid) {
+  unsigned int col;
+  for (col = 0; col < width; ++col) {
+    const int num_cols = (col == 0 || col == width - 1) ? 2 : 3;
+    edge[col] = index_mult[2 * num_cols + extra];
+    mid[col] = index_mult[3 * num_cols + extra];
+  }
+}
+
+// Fill the per-column filter weights of the top and bottom halves of a plane.
+static INLINE void get_filter_weights(unsigned int width, const int *blk_fw,
+                                      int use_whole_blk, uint16_t *top,
+                                      uint16_t *bottom) {
+  unsigned int col;
+  for (col = 0; col < width; ++col) {
+    const int right = !use_whole_blk && col >= width / 2;
+    top[col] = blk_fw[right];
+    bottom[col] = use_whole_blk ? blk_fw[0] : blk_fw[2 + right];
+  }
+}
+
+// Read in 16 pixels from a and b as 8-bit unsigned integers, compute the
+// difference squared, and store as unsigned 16-bit integer to dst.
+static INLINE void store_dist_16(const uint8_t *a, const uint8_t *b,
+                                 uint16_t *dst) {
+  const __m256i a_reg =
+      _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)a));
+  const __m256i b_reg =
+      _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)b));
+  const __m256i dist = _mm256_sub_epi16(a_reg, b_reg);
+
+  _mm256_storeu_si256((__m256i *)dst, _mm256_mullo_epi16(dist, dist));
+}
+
+static INLINE void store_dist_8(const uint8_t *a, const uint8_t *b,
+                                uint16_t *dst) {
+  const __m128i a_reg = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)a));
+  const __m128i b_reg = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)b));
+  const __m128i dist = _mm_sub_epi16(a_reg, b_reg);
+
+  _mm_storeu_si128((__m128i *)dst, _mm_mullo_epi16(dist, dist));
+}
+
+static INLINE void store_dist_plane(const uint8_t *src, int src_stride,
+                                    const uint8_t *pre, int pre_stride,
+                                    unsigned int width, unsigned int height,
+                                    uint16_t *dist) {
+  unsigned int row, col;
+  for (row = 0; row < height; ++row) {
+    if (width == 8) {
+      store_dist_8(src, pre, dist);
+    } else {
+      for (col = 0; col < width; col += 16) {
+        store_dist_16(src + col, pre + col, dist + col);
+      }
+    }
+    src += src_stride;
+    pre += pre_stride;
+    dist += DIST_STRIDE;
+  }
+}
+
+// For each of the 16 values starting at dist, compute dist[i - 1] + dist[i] +
+// dist[i + 1].
+static INLINE __m256i get_sum_16(const uint16_t *dist) {
+  const __m256i left = _mm256_loadu_si256((const __m256i *)(dist - 1));
+  const __m256i center = _mm256_loadu_si256((const __m256i *)dist);
+  const __m256i right = _mm256_loadu_si256((const __m256i *)(dist + 1));
+
+  return _mm256_adds_epu16(_mm256_adds_epu16(left, center), right);
+}
+
+// Read the chroma distortion corresponding to 16 luma values.
+static INLINE __m256i read_chroma_dist_16(const uint16_t *dist, int ss_x) {
+  if (!ss_x) return _mm256_loadu_si256((const __m256i *)dist);
+
+  // Duplicate each of the 8 chroma values.
+  const __m256i dist_u32 =
+      _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)dist));
+  return _mm256_or_si256(dist_u32, _mm256_slli_epi32(dist_u32, 16));
+}
+
+// Sum the luma distortion corresponding to 16 chroma values.
+static INLINE __m256i read_luma_dist_16(const uint16_t *dist, int ss_x,
+                                        int ss_y) {
+  if (!ss_x) {
+    __m256i sum = _mm256_loadu_si256((const __m256i *)dist);
+    if (ss_y) {
+      sum = _mm256_adds_epu16(
+          sum, _mm256_loadu_si256((const __m256i *)(dist + DIST_STRIDE)));
+    }
+    return sum;
+  }
+
+  const __m256i mask = _mm256_set1_epi32(0xffff);
+  __m256i first = _mm256_loadu_si256((const __m256i *)dist);
+  __m256i second = _mm256_loadu_si256((const __m256i *)(dist + 16));
+  if (ss_y) {
+    first = _mm256_adds_epu16(
+        first, _mm256_loadu_si256((const __m256i *)(dist + DIST_STRIDE)));
+    second = _mm256_adds_epu16(
+        second, _mm256_loadu_si256((const __m256i *)(dist + DIST_STRIDE + 16)));
+  }
+
+  // Horizontally add adjacent pairs as unsigned 32-bit values, then saturate
+  // back to 16 bits.
+  first = _mm256_add_epi32(_mm256_and_si256(first, mask),
+                           _mm256_srli_epi32(first, 16));
+  second = _mm256_add_epi32(_mm256_and_si256(second, mask),
+                            _mm256_srli_epi32(second, 16));
+
+  return _mm256_permute4x64_epi64(_mm256_packus_epi32(first, second), 0xd8);
+}
+
+// Average the summed distortion, add in the rounding factor and shift, clamp
+// to 16, invert and multiply by the filter weight.
+static INLINE __m256i get_modifier_16(__m256i sum, const uint16_t *mult,
+                                      const uint16_t *weight,
+                                      const __m128i strength,
+                                      const __m256i rounding) {
+  const __m256i sixteen = _mm256_set1_epi16(16);
+
+  sum = _mm256_mulhi_epu16(sum, _mm256_loadu_si256((const __m256i *)mult));
+  sum = _mm256_adds_epu16(sum, rounding);
+  sum = _mm256_srl_epi16(sum, strength);
+  sum = _mm256_min_epu16(sum, sixteen);
+  sum = _mm256_sub_epi16(sixteen, sum);
+
+  return _mm256_mullo_epi16(sum, _mm256_loadu_si256((const __m256i *)weight));
+}
+
+// Add 'mod' to 'count'. Multiply by 'pred' and add to 'accumulator'.
+static INLINE void accumulate_and_store_16(const __m256i mod,
+                                           const uint8_t *pred, uint16_t *count,
+                                           uint32_t *accumulator) {
+  const __m256i pred_u16 =
+      _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)pred));
+  const __m256i count_u16 = _mm256_loadu_si256((const __m256i *)count);
+  const __m256i weighted = _mm256_mullo_epi16(mod, pred_u16);
+  __m256i accum_0 = _mm256_loadu_si256((const __m256i *)accumulator);
+  __m256i accum_1 = _mm256_loadu_si256((const __m256i *)(accumulator + 8));
+
+  _mm256_storeu_si256((__m256i *)count, _mm256_add_epi16(count_u16, mod));
+
+  accum_0 = _mm256_add_epi32(
+      accum_0, _mm256_cvtepu16_epi32(_mm256_castsi256_si128(weighted)));
+  accum_1 = _mm256_add_epi32(
+      accum_1, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(weighted, 1)));
+
+  _mm256_storeu_si256((__m256i *)accumulator, accum_0);
+  _mm256_storeu_si256((__m256i *)(accumulator + 8), accum_1);
+}
+
+static INLINE void accumulate_and_store_8(const __m128i mod,
+                                          const uint8_t *pred, uint16_t *count,
+                                          uint32_t *accumulator) {
+  const __m128i pred_u16 =
+      _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)pred));
+  const __m128i count_u16 = _mm_loadu_si128((const __m128i *)count);
+  const __m128i weighted = _mm_mullo_epi16(mod, pred_u16);
+  __m256i accum = _mm256_loadu_si256((const __m256i *)accumulator);
+
+  _mm_storeu_si128((__m128i *)count, _mm_add_epi16(count_u16, mod));
+
+  accum = _mm256_add_epi32(accum, _mm256_cvtepu16_epi32(weighted));
+  _mm256_storeu_si256((__m256i *)accumulator, accum);
+}
+
+// Apply temporal filter to the luma component.
+static void apply_temporal_filter_luma(
+    const uint8_t *y_pre, int y_pre_stride, unsigned int block_width,
+    unsigned int block_height, int ss_x, int ss_y, int strength,
+    const int *blk_fw, int use_whole_blk, uint32_t *y_accum, uint16_t *y_count,
+    const uint16_t *y_dist, const uint16_t *u_dist, const uint16_t *v_dist) {
+  const __m128i strength_u128 = _mm_cvtsi32_si128(strength);
+  const __m256i rounding = _mm256_set1_epi16((1 << strength) >> 1);
+  DECLARE_ALIGNED(32, uint16_t, mult_edge[BW]);
+  DECLARE_ALIGNED(32, uint16_t, mult_mid[BW]);
+  DECLARE_ALIGNED(32, uint16_t, weight_top[BW]);
+  DECLARE_ALIGNED(32, uint16_t, weight_bottom[BW]);
+  unsigned int row, col;
+
+  // Each luma modifier also sums one u and one v value.
+  get_index_mult(block_width, 2, mult_edge, mult_mid);
+  get_filter_weights(block_width, blk_fw, use_whole_blk, weight_top,
+                     weight_bottom);
+
+  for (col = 0; col < block_width; col += 16) {
+    const uint16_t *dist = y_dist + col;
+    __m256i sum_row_1 = get_sum_16(dist - DIST_STRIDE);
+    __m256i sum_row_2 = get_sum_16(dist);
+
+    for (row = 0; row < block_height; ++row) {
+      const __m256i sum_row_3 = get_sum_16(dist + DIST_STRIDE);
+      const int uv_offset = (row >> ss_y) * DIST_STRIDE + (col >> ss_x);
+      const uint16_t *mult =
+          (row == 0 || row == block_height - 1) ? mult_edge : mult_mid;
+      const uint16_t *weight =
+          (row < block_height / 2) ? weight_top : weight_bottom;
+      __m256i sum;
+
+      sum = _mm256_adds_epu16(sum_row_1, sum_row_2);
+      sum = _mm256_adds_epu16(sum, sum_row_3);
+      sum = _mm256_adds_epu16(sum,
+                              read_chroma_dist_16(u_dist + uv_offset, ss_x));
+      sum = _mm256_adds_epu16(sum,
+                              read_chroma_dist_16(v_dist + uv_offset, ss_x));
+
+      accumulate_and_store_16(
+          get_modifier_16(sum, mult + col, weight + col, strength_u128,
+                          rounding),
+          y_pre + row * y_pre_stride + col, y_count + row * block_width + col,
+          y_accum + row * block_width + col);
+
+      sum_row_1 = sum_row_2;
+      sum_row_2 = sum_row_3;
+      dist += DIST_STRIDE;
+    }
+  }
+}
+
+// Apply temporal filter to the chroma components.
+static void apply_temporal_filter_chroma(
+    const uint8_t *u_pre, const uint8_t *v_pre, int uv_pre_stride,
+    unsigned int block_width, unsigned int block_height, int ss_x, int ss_y,
+    int strength, const int *blk_fw, int use_whole_blk, uint32_t *u_accum,
+    uint16_t *u_count, uint32_t *v_accum, uint16_t *v_count,
+    const uint16_t *y_dist, const uint16_t *u_dist, const uint16_t *v_dist) {
+  const unsigned int uv_width = block_width >> ss_x;
+  const unsigned int uv_height = block_height >> ss_y;
+  const __m128i strength_u128 = _mm_cvtsi32_si128(strength);
+  const __m256i rounding = _mm256_set1_epi16((1 << strength) >> 1);
+  DECLARE_ALIGNED(32, uint16_t, mult_edge[BW]);
+  DECLARE_ALIGNED(32, uint16_t, mult_mid[BW]);
+  DECLARE_ALIGNED(32, uint16_t, weight_top[BW]);
+  DECLARE_ALIGNED(32, uint16_t, weight_bottom[BW]);
+  unsigned int row, col;
+
+  // Each chroma modifier also sums all the co-located luma values.
+  get_index_mult(uv_width, (1 + ss_x) * (1 + ss_y), mult_edge, mult_mid);
+  get_filter_weights(uv_width, blk_fw, use_whole_blk, weight_top,
+                     weight_bottom);
+
+  for (col = 0; col < uv_width; col += 16) {
+    const uint16_t *u = u_dist + col;
+    const uint16_t *v = v_dist + col;
+    __m256i u_sum_row_1 = get_sum_16(u - DIST_STRIDE);
+    __m256i u_sum_row_2 = get_sum_16(u);
+    __m256i v_sum_row_1 = get_sum_16(v - DIST_STRIDE);
+    __m256i v_sum_row_2 = get_sum_16(v);
+
+    for (row = 0; row < uv_height; ++row) {
+      const __m256i u_sum_row_3 = get_sum_16(u + DIST_STRIDE);
+      const __m256i v_sum_row_3 = get_sum_16(v + DIST_STRIDE);
+      const __m256i y_sum = read_luma_dist_16(
+          y_dist + (row << ss_y) * DIST_STRIDE + (col << ss_x), ss_x, ss_y);
+      const uint16_t *mult =
+          (row == 0 || row == uv_height - 1) ? mult_edge : mult_mid;
+      const uint16_t *weight =
+          (row < uv_height / 2) ? weight_top : weight_bottom;
+      const int pre_offset = row * uv_pre_stride + col;
+      const int out_offset = row * uv_width + col;
+      __m256i u_sum, v_sum;
+
+      u_sum = _mm256_adds_epu16(u_sum_row_1, u_sum_row_2);
+      u_sum = _mm256_adds_epu16(u_sum, u_sum_row_3);
+      u_sum = _mm256_adds_epu16(u_sum, y_sum);
+      v_sum = _mm256_adds_epu16(v_sum_row_1, v_sum_row_2);
+      v_sum = _mm256_adds_epu16(v_sum, v_sum_row_3);
+      v_sum = _mm256_adds_epu16(v_sum, y_sum);
+
+      u_sum = get_modifier_16(u_sum, mult + col, weight + col, strength_u128,
+                              rounding);
+      v_sum = get_modifier_16(v_sum, mult + col, weight + col, strength_u128,
+                              rounding);
+
+      if (uv_width - col >= 16) {
+        accumulate_and_store_16(u_sum, u_pre + pre_offset, u_count + out_offset,
+                                u_accum + out_offset);
+        accumulate_and_store_16(v_sum, v_pre + pre_offset, v_count + out_offset,
+                                v_accum + out_offset);
+      } else {
+        accumulate_and_store_8(_mm256_castsi256_si128(u_sum),
+                               u_pre + pre_offset, u_count + out_offset,
+                               u_accum + out_offset);
+        accumulate_and_store_8(_mm256_castsi256_si128(v_sum),
+                               v_pre + pre_offset, v_count + out_offset,
+                               v_accum + out_offset);
+      }
+
+      u_sum_row_1 = u_sum_row_2;
+      u_sum_row_2 = u_sum_row_3;
+      v_sum_row_1 = v_sum_row_2;
+      v_sum_row_2 = v_sum_row_3;
+      u += DIST_STRIDE;
+      v += DIST_STRIDE;
+    }
+  }
+}
+
+void av1_apply_temporal_filter_avx2(
+    const uint8_t *y_src, int y_src_stride, const uint8_t *y_pre,
+    int y_pre_stride, const uint8_t *u_src, const uint8_t *v_src,
+    int uv_src_stride, const uint8_t *u_pre, const uint8_t *v_pre,
+    int uv_pre_stride, unsigned int block_width, unsigned int block_height,
+    int ss_x, int ss_y, int strength, const int *blk_fw, int use_whole_blk,
+    uint32_t *y_accum, uint16_t *y_count, uint32_t *u_accum, uint16_t *u_count,
+    uint32_t *v_accum, uint16_t *v_count) {
+  const unsigned int chroma_height = block_height >> ss_y,
+                     chroma_width = block_width >> ss_x;
+
+  DECLARE_ALIGNED(32, uint16_t, y_dist[DIST_ROWS * DIST_STRIDE]) = { 0 };
+  DECLARE_ALIGNED(32, uint16_t, u_dist[DIST_ROWS * DIST_STRIDE]) = { 0 };
+  DECLARE_ALIGNED(32, uint16_t, v_dist[DIST_ROWS * DIST_STRIDE]) = { 0 };
+
+  // Skip the top row and the left column of zeros.
+  uint16_t *y_dist_ptr = y_dist + DIST_STRIDE + 1,
+           *u_dist_ptr = u_dist + DIST_STRIDE + 1,
+           *v_dist_ptr = v_dist + DIST_STRIDE + 1;
+
+  assert(block_width <= BW && "block width too large");
+  assert(block_height <= BH && "block height too large");
+  assert(block_width % 16 == 0 && "block width must be multiple of 16");
+  assert(block_height % 2 == 0 && "block height must be even");
+  assert((ss_x == 0 || ss_x == 1) && (ss_y == 0 || ss_y == 1) &&
+         "invalid chroma subsampling");
+  assert(strength >= 0 && strength <= 6 && "invalid temporal filter strength");
+  assert(blk_fw[0] >= 0 && "filter weight must be positive");
+  assert(
+      (use_whole_blk || (blk_fw[1] >= 0 && blk_fw[2] >= 0 && blk_fw[3] >= 0)) &&
+      "subblock filter weight must be positive");
+  assert(blk_fw[0] <= 2 && "sublock filter weight must be less than 2");
+  assert(
+      (use_whole_blk || (blk_fw[1] <= 2 && blk_fw[2] <= 2 && blk_fw[3] <= 2)) &&
+      "subblock filter weight must be less than 2");
+
+  // Precompute the difference squared
+  store_dist_plane(y_src, y_src_stride, y_pre, y_pre_stride, block_width,
+                   block_height, y_dist_ptr);
+  store_dist_plane(u_src, uv_src_stride, u_pre, uv_pre_stride, chroma_width,
+                   chroma_height, u_dist_ptr);
+  store_dist_plane(v_src, uv_src_stride, v_pre, uv_pre_stride, chroma_width,
+                   chroma_height, v_dist_ptr);
+
+  apply_temporal_filter_luma(y_pre, y_pre_stride, block_width, block_height,
+                             ss_x, ss_y, strength, blk_fw, use_whole_blk,
+                             y_accum, y_count, y_dist_ptr, u_dist_ptr,
+                             v_dist_ptr);
+
+  apply_temporal_filter_chroma(u_pre, v_pre, uv_pre_stride, block_width,
+                               block_height, ss_x, ss_y, strength, blk_fw,
+                               use_whole_blk, u_accum, u_count, v_accum,
+                               v_count, y_dist_ptr, u_dist_ptr, v_dist_ptr);
+}
+
+// Only used in single plane case. Unlike the YUV filter above, the C version
+// divides the unclamped 32-bit sum exactly, so the division is done in single
+// precision float: the dividend stays below 2^24 and the truncated quotient is
+// exact.
+void av1_temporal_filter_apply_avx2(uint8_t *frame1, unsigned int stride,
+                                    uint8_t *frame2, unsigned int block_width,
+                                    unsigned int block_height, int strength,
+                                    const int *blk_fw, int use_32x32,
+                                    unsigned int *accumulator,
+                                    uint16_t *count) {
+  DECLARE_ALIGNED(32, uint16_t, dist[DIST_ROWS * DIST_STRIDE]) = { 0 };
+  DECLARE_ALIGNED(32, float, index_edge[BW]);
+  DECLARE_ALIGNED(32, float, index_mid[BW]);
+  DECLARE_ALIGNED(32, int32_t, weight_top[BW]);
+  DECLARE_ALIGNED(32, int32_t, weight_bottom[BW]);
+  uint16_t *const dist_ptr = dist + DIST_STRIDE + 1;
+  const __m128i strength_u128 = _mm_cvtsi32_si128(strength);
+  const __m256i rounding =
+      _mm256_set1_epi32(strength > 0 ? 1 << (strength - 1) : 0);
+  const __m256i three = _mm256_set1_epi32(3);
+  const __m256i sixteen = _mm256_set1_epi32(16);
+  unsigned int row, col;
+
+  assert(block_width <= BW && "block width too large");
+  assert(block_height <= BH && "block height too large");
+  assert(block_width % 8 == 0 && "block width must be multiple of 8");
+  assert(block_height >= 2 && "block height too small");
+
+  for (col = 0; col < block_width; ++col) {
+    const int num_cols = (col == 0 || col == block_width - 1) ? 2 : 3;
+    const int right = !use_32x32 && col >= block_width / 2;
+    index_edge[col] = (float)(2 * num_cols);
+    index_mid[col] = (float)(3 * num_cols);
+    weight_top[col] = blk_fw[right];
+    weight_bottom[col] = use_32x32 ? blk_fw[0] : blk_fw[2 + right];
+  }
+
+  for (row = 0; row < block_height; ++row) {
+    for (col = 0; col < block_width; col += 8) {
+      store_dist_8(frame1 + row * stride + col,
+                   frame2 + row * block_width + col,
+                   dist_ptr + row * DIST_STRIDE + col);
+    }
+  }
+
+  for (row = 0; row < block_height; ++row) {
+    const float *index =
+        (row == 0 || row == block_height - 1) ? index_edge : index_mid;
+    const int32_t *weight =
+        (row < block_height / 2) ? weight_top : weight_bottom;
+
+    for (col = 0; col < block_width; col += 8) {
+      const uint16_t *d = dist_ptr + row * DIST_STRIDE + col;
+      const int k = row * block_width + col;
+      __m256i sum = _mm256_setzero_si256();
+      __m256i mod;
+      int idy;
+
+      for (idy = -1; idy <= 1; ++idy) {
+        int idx;
+        for (idx = -1; idx <= 1; ++idx) {
+          const __m128i r = _mm_loadu_si128(
+              (const __m128i *)(d + idy * DIST_STRIDE + idx));
+          sum = _mm256_add_epi32(sum, _mm256_cvtepu16_epi32(r));
+        }
+      }
+
+      // modifier * 3 / index
+      sum = _mm256_mullo_epi32(sum, three);
+      mod = _mm256_cvttps_epi32(
+          _mm256_div_ps(_mm256_cvtepi32_ps(sum), _mm256_load_ps(index + col)));
+
+      mod = _mm256_add_epi32(mod, rounding);
+      mod = _mm256_srl_epi32(mod, strength_u128);
+      mod = _mm256_min_epi32(mod, sixteen);
+      mod = _mm256_sub_epi32(sixteen, mod);
+      mod = _mm256_mullo_epi32(
+          mod, _mm256_load_si256((const __m256i *)(weight + col)));
+
+      {
+        const __m128i mod_u16 = _mm_packus_epi32(
+            _mm256_castsi256_si128(mod), _mm256_extracti128_si256(mod, 1));
+        const __m128i count_u16 = _mm_loadu_si128((const __m128i *)(count + k));
+        const __m256i pred = _mm256_cvtepu8_epi32(
+            _mm_loadl_epi64((const __m128i *)(frame2 + k)));
+        const __m256i accum =
+            _mm256_loadu_si256((const __m256i *)(accumulator + k));
+
+        _mm_storeu_si128((__m128i *)(count + k),
+                         _mm_add_epi16(count_u16, mod_u16));
+        _mm256_storeu_si256(
+            (__m256i *)(accumulator + k),
+            _mm256_add_epi32(accum, _mm256_mullo_epi32(mod, pred)));
+      }
+    }
+  }
+}
@@ -206,6 +206,75 @@ sub set_function_pointers {
   }
 }
 
+# Emits the tables describing every function and its versions for
+# aom_rtcd_register(). The tiers are "c" followed by the extensions in order,
+# so a higher tier index means a more capable version.
+sub register_tables {
+  my $has_flags = shift;
+  my $sym = $opts{sym};
+  my @tiers = ("c", @ALL_ARCHS);
+  my @impls;
+  my @funcs;
+  foreach my $fn (sort keys %ALL_FUNCS) {
+    my $dfn = eval "\$${fn}_default";
+    $dfn = eval "\$${dfn}";
+    my $first = scalar @impls;
+    my @val = @{$ALL_FUNCS{$fn}};
+    my $args = pop @val;
+    my $proto = "@val($args)";
+    $proto =~ s/\s+/ /g;
+    # Every version is listed so that it can be benchmarked, but the binding
+    # never goes below the lowest one that set_function_pointers() may select.
+    my $min_impl;
+    foreach my $tier (0 .. $#tiers) {
+      my $ofn = eval "\$${fn}_$tiers[$tier]";
+      next if !$ofn;
+      my $link = eval "\$${fn}_$tiers[$tier]_link";
+      my $linked = "$ofn" eq "$dfn" || !$link || $link ne "false";
+      $min_impl = scalar @impls - $first if $linked && !defined $min_impl;
+      push @impls, "  { (aom_rtcd_fn_t)${ofn}, ${tier} },\n";
+    }
+    my $num = scalar @impls - $first;
+    my $ptr =
+        eval "\$${fn}_indirect" eq "true" ? "(aom_rtcd_fn_t *)&${fn}" : "NULL";
+    push @funcs,
+        "  { \"${fn}\", ${ptr}, ${first}, ${num}, ${min_impl},\n" .
+        "    \"${proto}\" },\n";
+  }
+  my $num_funcs = scalar @funcs;
+  my $num_tiers = scalar @tiers;
+  my $tier_names = join(", ", map { "\"$_\"" } @tiers);
+  my $tier_flags =
+      join(", ", "0", map { $has_flags ? "HAS_" . uc($_) : "0" } @ALL_ARCHS);
+
+  print <<EOF;
+#include "aom_ports/aom_rtcd.h"
+
+static const char *const ${sym}_tier_names[] = { ${tier_names} };
+static const int ${sym}_tier_flags[] = { ${tier_flags} };
+
+static const aom_rtcd_impl_t ${sym}_impls[] = {
+EOF
+  print @impls;
+  print <<EOF;
+};
+
+static const aom_rtcd_func_t ${sym}_funcs[] = {
+EOF
+  print @funcs;
+  print <<EOF;
+};
+
+static aom_rtcd_fn_t ${sym}_defaults[${num_funcs}];
+
+static aom_rtcd_table_t ${sym}_table = {
+  ${sym}_funcs, ${num_funcs}, ${sym}_impls, ${sym}_tier_names,
+  ${sym}_tier_flags, ${num_tiers}, ${sym}_defaults, 0, NULL
+};
+
+EOF
+}
+
 sub filter {
   my @filtered;
   foreach (@_) { push @filtered, $_ unless $disabled{$_}; }
@@ -270,6 +339,12 @@ sub x86() {
   print <<EOF;
 #ifdef RTCD_C
 #include "aom_ports/x86.h"
+
+EOF
+
+  register_tables(1);
+
+  print <<EOF;
 static void setup_rtcd_internal(void)
 {
     int flags = x86_simd_caps();
@@ -281,6 +356,8 @@ EOF
   set_function_pointers("c", @ALL_ARCHS);
 
   print <<EOF;
+
+    aom_rtcd_register(&$opts{sym}_table, flags);
 }
 #endif
 EOF
@@ -302,6 +379,12 @@ sub arm() {
 
 #ifdef RTCD_C
 #include "aom_ports/arm.h"
+
+EOF
+
+  register_tables(1);
+
+  print <<EOF;
 static void setup_rtcd_internal(void)
 {
     int flags = aom_arm_cpu_caps();
@@ -313,6 +396,8 @@ EOF
   set_function_pointers("c", @ALL_ARCHS);
 
   print <<EOF;
+
+    aom_rtcd_register(&$opts{sym}_table, flags);
 }
 #endif
 EOF
@@ -334,6 +419,11 @@ sub mips() {
 #include "config/aom_config.h"
 
 #ifdef RTCD_C
+EOF
+
+  register_tables(0);
+
+  print <<EOF;
 static void setup_rtcd_internal(void)
 {
 EOF
@@ -345,6 +435,8 @@ EOF
 void aom_dsputil_static_init();
 aom_dsputil_static_init();
 #endif
+
+aom_rtcd_register(&$opts{sym}_table, 0);
 }
 #endif
 EOF
@@ -367,6 +459,12 @@ sub ppc() {
 
 #ifdef RTCD_C
 #include "aom_ports/ppc.h"
+
+EOF
+
+  register_tables(1);
+
+  print <<EOF;
 static void setup_rtcd_internal(void)
 {
   int flags = ppc_simd_caps();
@@ -378,6 +476,8 @@ EOF
   set_function_pointers("c", @ALL_ARCHS);
 
   print <<EOF;
+
+  aom_rtcd_register(&$opts{sym}_table, flags);
 }
 #endif
 EOF
@@ -391,6 +491,11 @@ sub unoptimized() {
 #include "config/aom_config.h"
 
 #ifdef RTCD_C
+EOF
+
+  register_tables(0);
+
+  print <<EOF;
 static void setup_rtcd_internal(void)
 {
 EOF
@@ -398,6 +503,8 @@ EOF
   set_function_pointers "c";
 
   print <<EOF;
+
+  aom_rtcd_register(&$opts{sym}_table, 0);
 }
 #endif
 EOF
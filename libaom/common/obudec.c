@@ -33,6 +33,9 @@
 #define OBU_DETECTION_SIZE \
   (OBU_HEADER_SIZE + OBU_EXTENSION_SIZE + 4 * OBU_MAX_LENGTH_FIELD_SIZE)
 
+// The frame_type value of a key frame in the uncompressed header.
+#define OBU_KEY_FRAME_TYPE 0
+
 // Reads unsigned LEB128 integer and returns 0 upon successful read and decode.
 // Stores raw bytes in 'value_buffer', length of the number in 'value_length',
 // and decoded value in 'value'.
@@ -480,4 +483,167 @@ int obudec_read_temporal_unit(struct ObuDecInputContext *obu_ctx,
   return 0;
 }
 
+// Scans the OBUs in 'data', which holds a temporal unit in Section 5 format or
+// a frame unit in Annex B format. Updates 'reduced_still_picture_hdr' from
+// the sequence headers. Returns 1 if a shown key frame is found, 0 if not and
+// -1 on error.
+static int obudec_find_shown_key_frame(const uint8_t *data, size_t size,
+                                       int is_annexb,
+                                       int *reduced_still_picture_hdr) {
+  while (size > 0) {
+    ObuHeader obu_header;
+    size_t payload_size = 0;
+    size_t bytes_read = 0;
+    if (aom_read_obu_header_and_size(data, size, is_annexb, &obu_header,
+                                     &payload_size,
+                                     &bytes_read) != AOM_CODEC_OK ||
+        payload_size > size - bytes_read) {
+      fprintf(stderr, "obudec: Failure parsing OBU in key frame scan.\n");
+      return -1;
+    }
+    data += bytes_read;
+    size -= bytes_read;
+
+    if (payload_size > 0) {
+      if (obu_header.type == OBU_SEQUENCE_HEADER) {
+        // seq_profile (3 bits), still_picture (1 bit) and
+        // reduced_still_picture_header (1 bit).
+        *reduced_still_picture_hdr = (data[0] >> 3) & 1;
+      } else if (obu_header.type == OBU_FRAME_HEADER ||
+                 obu_header.type == OBU_FRAME) {
+        const int show_existing_frame = data[0] >> 7;
+        const int frame_type = (data[0] >> 5) & 3;
+        const int show_frame = (data[0] >> 4) & 1;
+        if (*reduced_still_picture_hdr ||
+            (!show_existing_frame && frame_type == OBU_KEY_FRAME_TYPE &&
+             show_frame)) {
+          return 1;
+        }
+      }
+    }
+    data += payload_size;
+    size -= payload_size;
+  }
+  return 0;
+}
+
+// Returns 1 if the temporal unit in 'data' contains a shown key frame, 0 if
+// not and -1 on error.
+static int obudec_has_shown_key_frame(const uint8_t *data, size_t size,
+                                      int is_annexb,
+                                      int *reduced_still_picture_hdr) {
+  if (!is_annexb) {
+    return obudec_find_shown_key_frame(data, size, 0,
+                                       reduced_still_picture_hdr);
+  }
+
+  uint64_t unit_size = 0;
+  size_t length_of_unit_size = 0;
+  if (aom_uleb_decode(data, size, &unit_size, &length_of_unit_size) != 0 ||
+      unit_size > size - length_of_unit_size) {
+    return -1;
+  }
+  data += length_of_unit_size;
+  size = (size_t)unit_size;
+  while (size > 0) {
+    if (aom_uleb_decode(data, size, &unit_size, &length_of_unit_size) != 0 ||
+        unit_size > size - length_of_unit_size) {
+      return -1;
+    }
+    data += length_of_unit_size;
+    size -= length_of_unit_size;
+    const int found = obudec_find_shown_key_frame(
+        data, (size_t)unit_size, 1, reduced_still_picture_hdr);
+    if (found != 0) return found;
+    data += unit_size;
+    size -= (size_t)unit_size;
+  }
+  return 0;
+}
+
+// Moves the read position to the temporal unit at 'offset' and restores the
+// buffered state obudec_read_temporal_unit() expects at the start of a
+// temporal unit.
+static int obudec_seek_to_temporal_unit(struct ObuDecInputContext *obu_ctx,
+                                        FileOffset offset) {
+  FILE *f = obu_ctx->avx_ctx->file;
+  if (fseeko(f, offset, SEEK_SET) != 0) {
+    fprintf(stderr, "obudec: Failure seeking to temporal unit.\n");
+    return -1;
+  }
+  obu_ctx->bytes_buffered = 0;
+  if (obu_ctx->is_annexb) return 0;
+
+  // In Section 5 format, the first OBU of the temporal unit has already been
+  // read.
+  ObuHeader obu_header;
+  size_t obu_size = 0;
+  if (obudec_read_one_obu(f, &obu_ctx->buffer, 0, &obu_ctx->buffer_capacity,
+                          &obu_size, &obu_header, 0) != 0) {
+    fprintf(stderr, "obudec: Failure reading temporal unit after seek.\n");
+    return -1;
+  }
+  obu_ctx->bytes_buffered = obu_size;
+  return 0;
+}
+
+int obudec_build_key_frame_index(struct ObuDecInputContext *obu_ctx,
+                                 struct ObuDecKeyFrameIndex *index) {
+  FILE *f = obu_ctx->avx_ctx->file;
+  if (!f) return -1;
+
+  const FileOffset start = ftello(f) - (FileOffset)obu_ctx->bytes_buffered;
+  uint8_t *tu = NULL;
+  size_t tu_size = 0;
+  size_t tu_capacity = 0;
+  size_t index_capacity = index->num_key_frames;
+  int reduced_still_picture_hdr = 0;
+  int status = 0;
+  for (int temporal_unit = 0;; ++temporal_unit) {
+    const FileOffset offset = ftello(f) - (FileOffset)obu_ctx->bytes_buffered;
+    status = obudec_read_temporal_unit(obu_ctx, &tu, &tu_size, &tu_capacity);
+    if (status != 0) break;
+    if (tu_size == 0) continue;
+
+    status = obudec_has_shown_key_frame(tu, tu_size, obu_ctx->is_annexb,
+                                        &reduced_still_picture_hdr);
+    if (status < 0) break;
+    if (status == 0) continue;
+
+    if (index->num_key_frames == index_capacity) {
+      index_capacity = AOMMAX(2 * index_capacity, 16);
+      struct ObuDecKeyFrame *const key_frames =
+          (struct ObuDecKeyFrame *)realloc(
+              index->key_frames, index_capacity * sizeof(*key_frames));
+      if (!key_frames) {
+        fprintf(stderr, "obudec: Out of memory.\n");
+        status = -1;
+        break;
+      }
+      index->key_frames = key_frames;
+    }
+    index->key_frames[index->num_key_frames].offset = offset;
+    index->key_frames[index->num_key_frames].temporal_unit = temporal_unit;
+    ++index->num_key_frames;
+  }
+  free(tu);
+  if (status < 0) return status;
+
+  return obudec_seek_to_temporal_unit(obu_ctx, start);
+}
+
+int obudec_seek_to_key_frame(struct ObuDecInputContext *obu_ctx,
+                             const struct ObuDecKeyFrameIndex *index,
+                             size_t key_frame) {
+  if (key_frame >= index->num_key_frames) return -1;
+  return obudec_seek_to_temporal_unit(obu_ctx,
+                                      index->key_frames[key_frame].offset);
+}
+
+void obudec_free_key_frame_index(struct ObuDecKeyFrameIndex *index) {
+  free(index->key_frames);
+  index->key_frames = NULL;
+  index->num_key_frames = 0;
+}
+
 void obudec_free(struct ObuDecInputContext *obu_ctx) { free(obu_ctx->buffer); }
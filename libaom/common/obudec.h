@@ -39,6 +39,35 @@ int obudec_read_temporal_unit(struct ObuDecInputContext *obu_ctx,
                               uint8_t **buffer, size_t *bytes_read,
                               size_t *buffer_size);
 
+// A temporal unit that starts with a shown key frame, from which decoding can
+// start.
+struct ObuDecKeyFrame {
+  FileOffset offset;  // File offset of the temporal unit.
+  int temporal_unit;  // Index of the temporal unit in the file.
+};
+
+struct ObuDecKeyFrameIndex {
+  struct ObuDecKeyFrame *key_frames;
+  size_t num_key_frames;
+};
+
+// Reads the temporal units from the current read position to the end of the
+// file and records the ones that contain a shown key frame in 'index', which
+// must be zero initialized. Only the OBU headers and the first byte of the
+// sequence and frame headers are parsed. Restores the read position before
+// returning. Returns 0 on success and less than 0 when an error occurs.
+int obudec_build_key_frame_index(struct ObuDecInputContext *obu_ctx,
+                                 struct ObuDecKeyFrameIndex *index);
+
+// Moves the read position so that the next obudec_read_temporal_unit() call
+// reads the temporal unit of key frame 'key_frame' in 'index'. Returns 0 on
+// success and less than 0 when an error occurs.
+int obudec_seek_to_key_frame(struct ObuDecInputContext *obu_ctx,
+                             const struct ObuDecKeyFrameIndex *index,
+                             size_t key_frame);
+
+void obudec_free_key_frame_index(struct ObuDecKeyFrameIndex *index);
+
 void obudec_free(struct ObuDecInputContext *obu_ctx);
 
 #ifdef __cplusplus
@@ -240,6 +240,13 @@ double sse_to_psnr(double samples, double peak, double sse) {
   }
 }
 
+void print_rtcd_bindings(FILE *file) {
+  const char *name, *tier;
+  for (int i = 0; aom_codec_get_rtcd_binding(i, &name, &tier); ++i) {
+    fprintf(file, "%-48s %s\n", name, tier);
+  }
+}
+
 // TODO(debargha): Consolidate the functions below into a separate file.
 static void highbd_img_upshift(aom_image_t *dst, const aom_image_t *src,
                                int input_shift) {
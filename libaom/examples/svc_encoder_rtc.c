@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+// Real-time SVC Encoder
+// =====================
+//
+// This is an example of a real-time scalable encoder. It reads an I420 file,
+// codes it with number_spatial_layers spatial and number_temporal_layers
+// temporal layers (L1T3, L3T3, ...) in one pass CBR mode and writes one IVF
+// file per layer. The file of layer (s, t) holds every frame needed to
+// decode that layer, i.e. the frames of spatial layers up to s and temporal
+// layers up to t, which is what an SFU forwards to a receiver of that layer.
+//
+// The layers are set up with the AV1E_SET_SVC_PARAMS control. Each spatial
+// layer is 1/2 the size of the one above it and takes a share of the bitrate
+// proportional to its width; the temporal layers of a spatial layer take 50%,
+// 70% and 100% (three layers) or 60% and 100% (two layers) of its bitrate.
+// Every superframe is coded as number_spatial_layers aom_codec_encode() calls
+// with the same image and pts, and the encoder reports the layer of each
+// frame through AV1E_GET_SVC_LAYER_ID.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "aom/aom_encoder.h"
+#include "aom/aomcx.h"
+#include "common/tools_common.h"
+#include "common/video_writer.h"
+
+static const char *exec_name;
+
+void usage_exit(void) {
+  fprintf(stderr,
+          "Usage: %s <width> <height> <infile> <outfile_prefix> "
+          "<number_spatial_layers> <number_temporal_layers> <bitrate_kbps> "
+          "<frames to encode>\n"
+          "See comments in svc_encoder_rtc.c for more information.\n",
+          exec_name);
+  exit(EXIT_FAILURE);
+}
+
+static void set_layer_params(aom_svc_params_t *params, int bitrate) {
+  static const int kTemporalPct[AOM_MAX_TS_LAYERS][AOM_MAX_TS_LAYERS] = {
+    { 100, 0, 0 }, { 60, 100, 0 }, { 50, 70, 100 }
+  };
+  const int ns = params->number_spatial_layers;
+  const int nt = params->number_temporal_layers;
+  const int total_share = (1 << ns) - 1;
+  for (int sl = 0; sl < ns; ++sl) {
+    const int spatial_bitrate = bitrate * (1 << sl) / total_share;
+    params->scaling_factor_num[sl] = 1;
+    params->scaling_factor_den[sl] = 1 << (ns - 1 - sl);
+    for (int tl = 0; tl < nt; ++tl) {
+      const int layer = sl * nt + tl;
+      params->max_quantizers[layer] = 56;
+      params->min_quantizers[layer] = 2;
+      params->layer_target_bitrate[layer] =
+          spatial_bitrate * kTemporalPct[nt - 1][tl] / 100;
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  FILE *infile = NULL;
+  aom_codec_ctx_t codec;
+  aom_codec_enc_cfg_t cfg;
+  aom_svc_params_t svc_params;
+  aom_image_t raw;
+  AvxVideoInfo info;
+  const AvxInterface *encoder = NULL;
+  AvxVideoWriter *writers[AOM_MAX_LAYERS];
+  size_t layer_bytes[AOM_MAX_LAYERS];
+  const int fps = 30;
+  int frames_encoded = 0;
+
+  exec_name = argv[0];
+
+  // Clear explicitly, as simply assigning "{ 0 }" generates
+  // "missing-field-initializers" warning in some compilers.
+  memset(&info, 0, sizeof(info));
+  memset(&svc_params, 0, sizeof(svc_params));
+  memset(writers, 0, sizeof(writers));
+  memset(layer_bytes, 0, sizeof(layer_bytes));
+
+  if (argc != 9) die("Invalid number of arguments");
+
+  encoder = get_aom_encoder_by_name("av1");
+  if (!encoder) die("Unsupported codec.");
+
+  info.codec_fourcc = encoder->fourcc;
+  info.frame_width = (int)strtol(argv[1], NULL, 0);
+  info.frame_height = (int)strtol(argv[2], NULL, 0);
+  info.time_base.numerator = 1;
+  info.time_base.denominator = fps;
+  const char *const outfile_prefix = argv[4];
+  svc_params.number_spatial_layers = (int)strtol(argv[5], NULL, 0);
+  svc_params.number_temporal_layers = (int)strtol(argv[6], NULL, 0);
+  const int bitrate = (int)strtol(argv[7], NULL, 0);
+  const int max_frames = (int)strtol(argv[8], NULL, 0);
+  const int ns = svc_params.number_spatial_layers;
+  const int nt = svc_params.number_temporal_layers;
+
+  if (info.frame_width <= 0 || info.frame_height <= 0 ||
+      (info.frame_width % 2) != 0 || (info.frame_height % 2) != 0) {
+    die("Invalid frame size: %dx%d", info.frame_width, info.frame_height);
+  }
+  if (ns < 1 || ns > AOM_MAX_SS_LAYERS || nt < 1 || nt > AOM_MAX_TS_LAYERS)
+    die("Invalid number of layers: %d spatial, %d temporal", ns, nt);
+  if (bitrate <= 0) die("Invalid bitrate: %d", bitrate);
+
+  if (!aom_img_alloc(&raw, AOM_IMG_FMT_I420, info.frame_width,
+                     info.frame_height, 1)) {
+    die("Failed to allocate image.");
+  }
+
+  printf("Using %s\n", aom_codec_iface_name(encoder->codec_interface()));
+
+  if (aom_codec_enc_config_default(encoder->codec_interface(), &cfg, 0))
+    die("Failed to get default codec config.");
+
+  cfg.g_w = info.frame_width;
+  cfg.g_h = info.frame_height;
+  cfg.g_timebase.num = info.time_base.numerator;
+  cfg.g_timebase.den = info.time_base.denominator;
+  cfg.rc_target_bitrate = bitrate;
+  cfg.g_error_resilient = 0;
+  cfg.g_lag_in_frames = 0;
+  cfg.rc_end_usage = AOM_CBR;
+  cfg.rc_dropframe_thresh = 0;
+  cfg.rc_buf_initial_sz = 600;
+  cfg.rc_buf_optimal_sz = 600;
+  cfg.rc_buf_sz = 1000;
+  cfg.kf_max_dist = 9999;
+  cfg.g_pass = AOM_RC_ONE_PASS;
+
+  if (!(infile = fopen(argv[3], "rb")))
+    die("Failed to open %s for reading.", argv[3]);
+
+  for (int sl = 0; sl < ns; ++sl) {
+    for (int tl = 0; tl < nt; ++tl) {
+      char file_name[512];
+      snprintf(file_name, sizeof(file_name), "%s_L%dT%d.ivf", outfile_prefix,
+               sl, tl);
+      writers[sl * nt + tl] =
+          aom_video_writer_open(file_name, kContainerIVF, &info);
+      if (!writers[sl * nt + tl])
+        die("Failed to open %s for writing.", file_name);
+    }
+  }
+
+  if (aom_codec_enc_init(&codec, encoder->codec_interface(), &cfg, 0))
+    die_codec(&codec, "Failed to initialize encoder");
+  if (aom_codec_control(&codec, AOME_SET_CPUUSED, 8))
+    die_codec(&codec, "Failed to set cpu to 8");
+  set_layer_params(&svc_params, bitrate);
+  if (aom_codec_control(&codec, AV1E_SET_SVC_PARAMS, &svc_params))
+    die_codec(&codec, "Failed to set SVC parameters");
+
+  // Encode frames.
+  while (aom_img_read(&raw, infile)) {
+    for (int sl = 0; sl < ns; ++sl) {
+      aom_codec_iter_t iter = NULL;
+      const aom_codec_cx_pkt_t *pkt = NULL;
+      aom_svc_layer_id_t layer_id;
+      if (aom_codec_encode(&codec, &raw, frames_encoded, 1, 0))
+        die_codec(&codec, "Failed to encode frame");
+      if (aom_codec_control(&codec, AV1E_GET_SVC_LAYER_ID, &layer_id))
+        die_codec(&codec, "Failed to get the layer id");
+
+      while ((pkt = aom_codec_get_cx_data(&codec, &iter)) != NULL) {
+        if (pkt->kind != AOM_CODEC_CX_FRAME_PKT) continue;
+        // Every layer at or above this one needs the frame.
+        for (int s = layer_id.spatial_layer_id; s < ns; ++s) {
+          for (int t = layer_id.temporal_layer_id; t < nt; ++t) {
+            if (!aom_video_writer_write_frame(writers[s * nt + t],
+                                              pkt->data.frame.buf,
+                                              pkt->data.frame.sz,
+                                              pkt->data.frame.pts))
+              die_codec(&codec, "Failed to write compressed frame");
+          }
+        }
+        layer_bytes[layer_id.spatial_layer_id * nt +
+                    layer_id.temporal_layer_id] += pkt->data.frame.sz;
+      }
+    }
+    frames_encoded++;
+    if (max_frames > 0 && frames_encoded >= max_frames) break;
+  }
+
+  fclose(infile);
+  printf("Processed %d frames.\n", frames_encoded);
+  if (frames_encoded > 0) {
+    const double duration = (double)frames_encoded / fps;
+    for (int sl = 0; sl < ns; ++sl) {
+      size_t bytes = 0;
+      for (int tl = 0; tl < nt; ++tl) {
+        bytes += layer_bytes[sl * nt + tl];
+        printf("Layer L%dT%d: %8.1f kbps (target %d kbps)\n", sl, tl,
+               bytes * 8 / 1000.0 / duration,
+               svc_params.layer_target_bitrate[sl * nt + tl]);
+      }
+    }
+  }
+
+  aom_img_free(&raw);
+  if (aom_codec_destroy(&codec)) die_codec(&codec, "Failed to destroy codec.");
+  for (int i = 0; i < ns * nt; ++i) aom_video_writer_close(writers[i]);
+
+  return EXIT_SUCCESS;
+}
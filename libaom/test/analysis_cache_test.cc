@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "aom/aom_encoder.h"
+#include "aom/aomcx.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+
+namespace {
+
+const int kNumFrames = 10;
+
+class AnalysisCacheTest
+    : public ::libaom_test::CodecTestWithParam<int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  AnalysisCacheTest() : EncoderTest(GET_PARAM(0)) {}
+  virtual ~AnalysisCacheTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kTwoPassGood);
+    cpu_used_ = GET_PARAM(1);
+    cfg_.rc_end_usage = AOM_VBR;
+    cfg_.rc_target_bitrate = 400;
+    cfg_.g_lag_in_frames = kNumFrames;
+    cache_file_name_ = NULL;
+  }
+
+  virtual void BeginPassHook(unsigned int pass) {
+    if (pass == 0) {
+      md5s_.clear();
+      tpl_us_ = 0;
+      first_pass_us_ = 0;
+    }
+    first_call_ = true;
+  }
+
+  // The stage times of the previous call are read before the next one, so
+  // frames and gf groups analysed rather than read from the cache show up in
+  // first_pass_us_ and tpl_us_.
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource * /*video*/,
+                                  ::libaom_test::Encoder *encoder) {
+    if (first_call_) {
+      encoder->Control(AOME_SET_CPUUSED, cpu_used_);
+      encoder->Control(AV1E_SET_ENABLE_TPL_MODEL, 1);
+      encoder->Control(AV1E_SET_STAGE_TIMING, 1);
+      if (cache_file_name_ != NULL)
+        encoder->Control(AV1E_SET_ANALYSIS_CACHE, cache_file_name_);
+      first_call_ = false;
+    } else {
+      aom_enc_stage_timing_t timing;
+      encoder->Control(AV1E_GET_STAGE_TIMING, &timing);
+      tpl_us_ += timing.time_us[AOM_ENC_STAGE_TPL];
+      first_pass_us_ += timing.time_us[AOM_ENC_STAGE_FIRST_PASS];
+    }
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    ::libaom_test::MD5 md5;
+    md5.Add(static_cast<const uint8_t *>(pkt->data.frame.buf),
+            pkt->data.frame.sz);
+    md5s_.push_back(md5.Get());
+  }
+
+  // Encodes the clip and returns the MD5 of each frame and whether the first
+  // pass or the TPL analysis ran for any frame.
+  void Encode(const char *cache_file_name, std::vector<std::string> *md5s,
+              bool *analysed) {
+    ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352,
+                                         288, 30, 1, 0, kNumFrames);
+    cache_file_name_ = cache_file_name;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    *md5s = md5s_;
+    *analysed = tpl_us_ > 0 || first_pass_us_ > 0;
+  }
+
+  int cpu_used_;
+  const char *cache_file_name_;
+  std::vector<std::string> md5s_;
+  uint64_t tpl_us_;
+  uint64_t first_pass_us_;
+  bool first_call_;
+};
+
+// Writing the cache and reading it back both code the same frames as an
+// encode without it, and the encode reading the cache does no analysis.
+TEST_P(AnalysisCacheTest, MatchesUncachedEncode) {
+  ::libaom_test::TempOutFile cache_file;
+  ASSERT_TRUE(cache_file.file() != NULL);
+  std::vector<std::string> reference, written, read;
+  bool analysed;
+  ASSERT_NO_FATAL_FAILURE(Encode(NULL, &reference, &analysed));
+  EXPECT_TRUE(analysed);
+  ASSERT_NO_FATAL_FAILURE(
+      Encode(cache_file.file_name().c_str(), &written, &analysed));
+  EXPECT_TRUE(analysed);
+
+  // The cache now holds more than its header.
+  fseek(cache_file.file(), 0, SEEK_END);
+  EXPECT_GT(ftell(cache_file.file()), 1024);
+
+  ASSERT_NO_FATAL_FAILURE(
+      Encode(cache_file.file_name().c_str(), &read, &analysed));
+  EXPECT_FALSE(analysed) << "The cached analysis was not used.";
+  ASSERT_EQ(reference.size(), written.size());
+  ASSERT_EQ(reference.size(), read.size());
+  for (size_t i = 0; i < reference.size(); ++i) {
+    EXPECT_EQ(reference[i], written[i]) << "frame " << i;
+    EXPECT_EQ(reference[i], read[i]) << "frame " << i;
+  }
+}
+
+// An encode at another rate target reuses the analysis, and codes the same
+// number of frames at about the new rate.
+TEST_P(AnalysisCacheTest, OtherRateTargetHits) {
+  ::libaom_test::TempOutFile cache_file;
+  ASSERT_TRUE(cache_file.file() != NULL);
+  std::vector<std::string> written, read;
+  bool analysed;
+  ASSERT_NO_FATAL_FAILURE(
+      Encode(cache_file.file_name().c_str(), &written, &analysed));
+  EXPECT_TRUE(analysed);
+
+  cfg_.rc_target_bitrate = 800;
+  ASSERT_NO_FATAL_FAILURE(
+      Encode(cache_file.file_name().c_str(), &read, &analysed));
+  EXPECT_FALSE(analysed) << "The cached analysis was not used.";
+  ASSERT_EQ(written.size(), read.size());
+  EXPECT_NE(written, read);
+}
+
+// An encode at another speed analyses every frame again and codes the same
+// frames as without the cache.
+TEST_P(AnalysisCacheTest, OtherSpeedMisses) {
+  ::libaom_test::TempOutFile cache_file;
+  ASSERT_TRUE(cache_file.file() != NULL);
+  std::vector<std::string> written, reference, read;
+  bool analysed;
+  ASSERT_NO_FATAL_FAILURE(
+      Encode(cache_file.file_name().c_str(), &written, &analysed));
+
+  cpu_used_ = GET_PARAM(1) - 1;
+  ASSERT_NO_FATAL_FAILURE(Encode(NULL, &reference, &analysed));
+  ASSERT_NO_FATAL_FAILURE(
+      Encode(cache_file.file_name().c_str(), &read, &analysed));
+  EXPECT_TRUE(analysed) << "The analysis of another speed was used.";
+  ASSERT_EQ(reference.size(), read.size());
+  for (size_t i = 0; i < reference.size(); ++i) {
+    EXPECT_EQ(reference[i], read[i]) << "frame " << i;
+  }
+}
+
+TEST(AnalysisCacheFileTest, RejectsOtherFiles) {
+  ::libaom_test::TempOutFile file;
+  ASSERT_TRUE(file.file() != NULL);
+  ASSERT_GT(fputs("not an analysis cache", file.file()), 0);
+  fflush(file.file());
+
+  aom_codec_iface_t *const iface = aom_codec_av1_cx();
+  aom_codec_enc_cfg_t cfg;
+  ASSERT_EQ(AOM_CODEC_OK, aom_codec_enc_config_default(iface, &cfg, 0));
+  cfg.g_w = 352;
+  cfg.g_h = 288;
+  aom_codec_ctx_t enc;
+  ASSERT_EQ(AOM_CODEC_OK, aom_codec_enc_init(&enc, iface, &cfg, 0));
+  EXPECT_EQ(AOM_CODEC_ERROR, aom_codec_control(&enc, AV1E_SET_ANALYSIS_CACHE,
+                                               file.file_name().c_str()));
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&enc));
+}
+
+AV1_INSTANTIATE_TEST_CASE(AnalysisCacheTest, ::testing::Values(6));
+}  // namespace
@@ -125,6 +125,58 @@ aomdec_av1_obu_section5() {
   fi
 }
 
+# Decodes $1 from the key frame of temporal unit 6 with --seek-key-frame and
+# checks that the MD5 of the output matches the one of a decode that reads and
+# drops the first 6 temporal units. $1 must have key frames in temporal units
+# 0, 3, 6 and 9 and one shown frame per temporal unit. The remaining
+# parameters are passed through to aomdec.
+aomdec_check_seek_key_frame() {
+  local file="$1"
+  local decoder="$(aom_tool_path aomdec)"
+  local md5_all
+  local md5_skip
+  local md5_seek
+  shift
+  md5_all=$(eval "${AOM_TEST_PREFIX}" "${decoder}" "${file}" --md5 "$@") \
+    || return 1
+  md5_skip=$(eval "${AOM_TEST_PREFIX}" "${decoder}" "${file}" --md5 --skip=6 \
+    "$@") || return 1
+  if [ "${md5_skip}" = "${md5_all}" ]; then
+    elog "Dropping the first temporal units did not change the output."
+    return 1
+  fi
+  # Temporal units 6 and 8 both start decoding at the key frame of 6.
+  for temporal_unit in 6 8; do
+    md5_seek=$(eval "${AOM_TEST_PREFIX}" "${decoder}" "${file}" --md5 \
+      --seek-key-frame=${temporal_unit} "$@") || return 1
+    if [ "${md5_seek}" != "${md5_skip}" ]; then
+      elog "Seeking to temporal unit ${temporal_unit} gave MD5 ${md5_seek}," \
+           "expected ${md5_skip}."
+      return 1
+    fi
+  done
+}
+
+aomdec_av1_obu_annexb_seek_key_frame() {
+  if [ "$(aomdec_can_decode_av1)" = "yes" ] && \
+     [ "$(av1_encode_available)" = "yes" ]; then
+    local file="${AOM_TEST_OUTPUT_DIR}/av1.seek_key_frame.annexb.obu"
+    encode_yuv_raw_input_av1 "${file}" --obu --annexb=1 --limit=10 \
+      --kf-min-dist=3 --kf-max-dist=3 || return 1
+    aomdec_check_seek_key_frame "${file}" --annexb
+  fi
+}
+
+aomdec_av1_obu_section5_seek_key_frame() {
+  if [ "$(aomdec_can_decode_av1)" = "yes" ] && \
+     [ "$(av1_encode_available)" = "yes" ]; then
+    local file="${AOM_TEST_OUTPUT_DIR}/av1.seek_key_frame.obu"
+    encode_yuv_raw_input_av1 "${file}" --obu --limit=10 \
+      --kf-min-dist=3 --kf-max-dist=3 || return 1
+    aomdec_check_seek_key_frame "${file}"
+  fi
+}
+
 aomdec_av1_webm() {
   if [ "$(aomdec_can_decode_av1)" = "yes" ] && \
      [ "$(webm_io_available)" = "yes" ]; then
@@ -142,6 +194,8 @@ aomdec_tests="aomdec_av1_ivf
               aomdec_aom_ivf_pipe_input
               aomdec_av1_obu_annexb
               aomdec_av1_obu_section5
+              aomdec_av1_obu_annexb_seek_key_frame
+              aomdec_av1_obu_section5_seek_key_frame
               aomdec_av1_webm"
 
 run_tests aomdec_verify_environment "${aomdec_tests}"
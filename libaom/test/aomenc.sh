@@ -255,6 +255,48 @@ aomenc_av1_webm_cdf_update_mode() {
   fi
 }
 
+# Encodes two streams at different rates from one input, with the second
+# pass of both reading the first pass stats of the first stream, and checks
+# that both outputs decode.
+aomenc_av1_ivf_shared_first_pass() {
+  if [ "$(aomenc_can_encode_av1)" = "yes" ]; then
+    local output_hi="${AOM_TEST_OUTPUT_DIR}/av1_shared_first_pass_hi.ivf"
+    local output_lo="${AOM_TEST_OUTPUT_DIR}/av1_shared_first_pass_lo.ivf"
+    aomenc $(yuv_raw_input) \
+      --passes=2 \
+      --shared-first-pass \
+      $(aomenc_encode_test_fast_params) \
+      --target-bitrate=400 \
+      --ivf \
+      --output="${output_hi}" \
+      -- \
+      --target-bitrate=200 \
+      --output="${output_lo}"
+
+    local output
+    for output in "${output_hi}" "${output_lo}"; do
+      if [ ! -e "${output}" ]; then
+        elog "Output file ${output} does not exist."
+        return 1
+      fi
+    done
+
+    if [ "$(av1_decode_available)" = "yes" ]; then
+      local decoder="$(aom_tool_path aomdec)"
+      local md5_hi
+      local md5_lo
+      md5_hi=$(eval "${AOM_TEST_PREFIX}" "${decoder}" "${output_hi}" --md5) \
+        || return 1
+      md5_lo=$(eval "${AOM_TEST_PREFIX}" "${decoder}" "${output_lo}" --md5) \
+        || return 1
+      if [ "${md5_hi}" = "${md5_lo}" ]; then
+        elog "The two streams of the shared first pass encode are identical."
+        return 1
+      fi
+    fi
+  fi
+}
+
 aomenc_tests="aomenc_av1_ivf
               aomenc_av1_obu_annexb
               aomenc_av1_obu_section5
@@ -264,6 +306,7 @@ aomenc_tests="aomenc_av1_ivf
               aomenc_av1_ivf_minq0_maxq0
               aomenc_av1_webm_lag5_frames10
               aomenc_av1_webm_non_square_par
-              aomenc_av1_webm_cdf_update_mode"
+              aomenc_av1_webm_cdf_update_mode
+              aomenc_av1_ivf_shared_first_pass"
 
 run_tests aomenc_verify_environment "${aomenc_tests}"
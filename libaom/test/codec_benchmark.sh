@@ -0,0 +1,64 @@
+#!/bin/sh
+## Copyright (c) 2019, Alliance for Open Media. All rights reserved
+##
+## This source code is subject to the terms of the BSD 2 Clause License and
+## the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+## was not distributed with this source code in the LICENSE file, you can
+## obtain it at www.aomedia.org/license/software. If the Alliance for Open
+## Media Patent License 1.0 was not distributed with this source code in the
+## PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+##
+## This file tests the libaom codec_benchmark tool. To add new tests to this
+## file, do the following:
+##   1. Write a shell function (this is your test).
+##   2. Add the function to codec_benchmark_tests (on a new line).
+##
+. $(dirname $0)/tools_common.sh
+
+readonly codec_benchmark_output="${AOM_TEST_OUTPUT_DIR}/codec_benchmark.json"
+
+codec_benchmark_verify_environment() {
+  if [ "$(codec_benchmark_available)" = "yes" ]; then
+    if [ -z "$(aom_tool_path codec_benchmark)" ]; then
+      elog "codec_benchmark not found in LIBAOM_BIN_PATH, its parent, or child"
+      elog "tools/."
+    fi
+  fi
+}
+
+codec_benchmark_available() {
+  if [ "$(av1_decode_available)" = "yes" ] && \
+     [ "$(av1_encode_available)" = "yes" ]; then
+    echo yes
+  fi
+}
+
+# Runs a small benchmark matrix and checks that every run is reported.
+codec_benchmark() {
+  if [ "$(codec_benchmark_available)" = "yes" ]; then
+    eval $(aom_tool_path codec_benchmark) \
+      --width=64 \
+      --height=64 \
+      --frames=3 \
+      --content=gradient,noise,text,pan \
+      --threads=1,2 \
+      --thread-affinity \
+      --output="${codec_benchmark_output}" \
+      ${devnull}
+
+    if [ ! -e "${codec_benchmark_output}" ]; then
+      elog "codec_benchmark output does not exist."
+      return 1
+    fi
+
+    local runs=$(grep -c '"encode_fps"' "${codec_benchmark_output}")
+    if [ "${runs}" -ne 8 ]; then
+      elog "codec_benchmark reported ${runs} runs, expected 8."
+      return 1
+    fi
+  fi
+}
+
+codec_benchmark_tests="codec_benchmark"
+
+run_tests codec_benchmark_verify_environment "${codec_benchmark_tests}"
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <stdlib.h>
+
+#include "config/av1_rtcd.h"
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/acm_random.h"
+#include "test/util.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_ports/aom_timer.h"
+#include "av1/encoder/corner_detect.h"
+
+extern "C" {
+#include "third_party/fastfeat/fast.h"
+}
+
+namespace test_libaom {
+
+namespace AV1CornerDetect {
+
+using libaom_test::ACMRandom;
+
+typedef int (*Fast9DetectRowFunc)(const unsigned char *row, int stride,
+                                  int width, int threshold, int *xs,
+                                  int *scores);
+
+const int kThreshold = 18;
+
+// Fill the image with either noise, or flat blocks plus a little noise. The
+// second kind has far fewer corners, and most of them sit on block edges.
+static void FillImage(ACMRandom *rnd, uint8_t *img, int w, int h, int stride,
+                      int mode) {
+  for (int i = 0; i < h; ++i) {
+    for (int j = 0; j < w; ++j) {
+      if (mode == 0) {
+        img[i * stride + j] = rnd->Rand8();
+      } else {
+        const int v = ((i / 5) * 37 + (j / 7) * 91) & 255;
+        img[i * stride + j] = clamp(v + rnd->PseudoUniform(9) - 4, 0, 255);
+      }
+    }
+  }
+}
+
+TEST(AV1CornerDetectTest, MatchesFastFeat) {
+  ACMRandom rnd(ACMRandom::DeterministicSeed());
+  const int kMaxPoints = 4096;
+  int *points = new int[2 * kMaxPoints];
+  // Shared by all the calls, which then run on frames both wider and narrower
+  // than the buffer.
+  CornerDetectBuffer scratch = { NULL, 0 };
+  for (int mode = 0; mode < 2; ++mode) {
+    for (int iter = 0; iter < 20; ++iter) {
+      const int w = 7 + rnd.PseudoUniform(200);
+      const int h = 7 + rnd.PseudoUniform(100);
+      const int stride = w + rnd.PseudoUniform(16);
+      const int max_points = iter % 2 ? kMaxPoints : 1 + rnd.PseudoUniform(50);
+      uint8_t *img = new uint8_t[stride * h];
+      FillImage(&rnd, img, w, h, stride, mode);
+
+      int num_ref;
+      xy *ref = fast9_detect_nonmax(img, w, h, stride, kThreshold, &num_ref);
+      if (num_ref > max_points) num_ref = max_points;
+      const int num =
+          fast_corner_detect(img, w, h, stride, points, max_points, &scratch);
+      ASSERT_EQ(num_ref, num) << w << "x" << h << " mode " << mode;
+      for (int i = 0; i < num; ++i) {
+        ASSERT_EQ(ref[i].x, points[2 * i]) << "corner " << i;
+        ASSERT_EQ(ref[i].y, points[2 * i + 1]) << "corner " << i;
+      }
+      free(ref);
+      delete[] img;
+    }
+  }
+  av1_free_corner_detect_buffer(&scratch);
+  delete[] points;
+}
+
+typedef ::testing::tuple<int, Fast9DetectRowFunc> Fast9DetectRowParam;
+
+class AV1Fast9DetectRowTest
+    : public ::testing::TestWithParam<Fast9DetectRowParam> {
+ public:
+  virtual ~AV1Fast9DetectRowTest() {}
+  virtual void SetUp() {
+    rnd_.Reset(ACMRandom::DeterministicSeed());
+    target_func_ = GET_PARAM(1);
+  }
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  void RunCheckOutput(int run_times);
+
+  ACMRandom rnd_;
+  Fast9DetectRowFunc target_func_;
+};
+
+void AV1Fast9DetectRowTest::RunCheckOutput(int run_times) {
+  const int kMaxWidth = 512, kHeight = 7, kStride = kMaxWidth + 32;
+  const int mode = GET_PARAM(0);
+  uint8_t *img = new uint8_t[kStride * kHeight];
+  int *xs_ref = new int[kMaxWidth];
+  int *xs = new int[kMaxWidth];
+  int *scores_ref = new int[kMaxWidth];
+  int *scores = new int[kMaxWidth];
+  const int num_iters = run_times > 1 ? 1 : 500;
+
+  for (int iter = 0; iter < num_iters; ++iter) {
+    const int w =
+        run_times > 1 ? kMaxWidth : 7 + rnd_.PseudoUniform(kMaxWidth - 6);
+    const int threshold = iter % 4 ? kThreshold : rnd_.PseudoUniform(256);
+    FillImage(&rnd_, img, w, kHeight, kStride, mode);
+    const uint8_t *const row = img + 3 * kStride;
+
+    const int num_ref = av1_fast9_detect_row_c(row, kStride, w, threshold,
+                                               xs_ref, scores_ref);
+    int num;
+    ASM_REGISTER_STATE_CHECK(
+        num = target_func_(row, kStride, w, threshold, xs, scores));
+    ASSERT_EQ(num_ref, num) << "width " << w << " threshold " << threshold;
+    for (int i = 0; i < num; ++i) {
+      ASSERT_EQ(xs_ref[i], xs[i]);
+      ASSERT_EQ(scores_ref[i], scores[i]) << "at x " << xs[i];
+    }
+
+    if (run_times > 1) {
+      aom_usec_timer timer;
+      aom_usec_timer_start(&timer);
+      for (int j = 0; j < run_times; ++j) {
+        av1_fast9_detect_row_c(row, kStride, w, threshold, xs_ref,
+                               scores_ref);
+      }
+      aom_usec_timer_mark(&timer);
+      const int elapsed_time_c =
+          static_cast<int>(aom_usec_timer_elapsed(&timer));
+      aom_usec_timer_start(&timer);
+      for (int j = 0; j < run_times; ++j) {
+        target_func_(row, kStride, w, threshold, xs, scores);
+      }
+      aom_usec_timer_mark(&timer);
+      const int elapsed_time_simd =
+          static_cast<int>(aom_usec_timer_elapsed(&timer));
+      printf("mode %d: c_time=%d \t simd_time=%d \t gain=%f\n", mode,
+             elapsed_time_c, elapsed_time_simd,
+             static_cast<double>(elapsed_time_c) / elapsed_time_simd);
+    }
+  }
+  delete[] img;
+  delete[] xs_ref;
+  delete[] xs;
+  delete[] scores_ref;
+  delete[] scores;
+}
+
+TEST_P(AV1Fast9DetectRowTest, CheckOutput) { RunCheckOutput(1); }
+TEST_P(AV1Fast9DetectRowTest, DISABLED_Speed) { RunCheckOutput(100000); }
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, AV1Fast9DetectRowTest,
+    ::testing::Values(::testing::make_tuple(0, av1_fast9_detect_row_avx2),
+                      ::testing::make_tuple(1, av1_fast9_detect_row_avx2)));
+#endif
+
+}  // namespace AV1CornerDetect
+
+}  // namespace test_libaom
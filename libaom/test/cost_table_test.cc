@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "aom_dsp/prob.h"
+#include "aom_mem/aom_mem.h"
+#include "aom_ports/aom_timer.h"
+#include "av1/common/entropymode.h"
+#include "av1/common/onyxc_int.h"
+#include "av1/encoder/block.h"
+#include "av1/encoder/cost.h"
+#include "av1/encoder/rd.h"
+#include "test/acm_random.h"
+
+namespace {
+using libaom_test::ACMRandom;
+
+struct AdaptedCdf {
+  aom_cdf_prob *cdf;
+  int nsymbs;
+};
+
+class CostTableTest : public ::testing::Test {
+ protected:
+  CostTableTest() : rnd_(ACMRandom::DeterministicSeed()) {}
+
+  virtual void SetUp() {
+    cm_ = static_cast<AV1_COMMON *>(aom_calloc(1, sizeof(*cm_)));
+    ASSERT_TRUE(cm_ != NULL);
+    cm_->fc = static_cast<FRAME_CONTEXT *>(aom_calloc(1, sizeof(*cm_->fc)));
+    cm_->default_frame_context =
+        static_cast<FRAME_CONTEXT *>(aom_calloc(1, sizeof(*cm_->fc)));
+    cm_->cur_frame =
+        static_cast<RefCntBuffer *>(aom_calloc(1, sizeof(*cm_->cur_frame)));
+    ASSERT_TRUE(cm_->fc != NULL && cm_->default_frame_context != NULL &&
+                cm_->cur_frame != NULL);
+    cm_->seq_params.enable_filter_intra = 1;
+    cm_->current_frame.frame_type = INTER_FRAME;
+    cm_->current_frame.skip_mode_info.skip_mode_flag = 1;
+    av1_setup_past_independence(cm_);
+
+    for (int i = 0; i < 2; ++i) {
+      x_[i] = static_cast<MACROBLOCK *>(aom_calloc(1, sizeof(*x_[i])));
+      ASSERT_TRUE(x_[i] != NULL);
+    }
+    InitAdaptedCdfs();
+  }
+
+  virtual void TearDown() {
+    aom_free(x_[0]);
+    aom_free(x_[1]);
+    aom_free(cm_->cur_frame);
+    aom_free(cm_->default_frame_context);
+    aom_free(cm_->fc);
+    aom_free(cm_);
+  }
+
+  // A sample of the CDFs an encoder adapts most, from all parts of the frame
+  // context the cost tables are built from.
+  void InitAdaptedCdfs() {
+    FRAME_CONTEXT *const fc = cm_->fc;
+    for (int i = 0; i < SKIP_CONTEXTS; ++i) Add(fc->skip_cdfs[i], 2);
+    for (int i = 0; i < BLOCK_SIZE_GROUPS; ++i)
+      Add(fc->y_mode_cdf[i], INTRA_MODES);
+    for (int i = 0; i < NEWMV_MODE_CONTEXTS; ++i) Add(fc->newmv_cdf[i], 2);
+    for (int i = 0; i < COMP_INTER_CONTEXTS; ++i)
+      Add(fc->comp_inter_cdf[i], 2);
+    Add(fc->cfl_sign_cdf, CFL_JOINT_SIGNS);
+    for (int tx_size = 0; tx_size < TX_SIZES; ++tx_size) {
+      for (int ctx = 0; ctx < TXB_SKIP_CONTEXTS; ++ctx)
+        Add(fc->txb_skip_cdf[tx_size][ctx], 2);
+      for (int plane = 0; plane < PLANE_TYPES; ++plane) {
+        for (int ctx = 0; ctx < SIG_COEF_CONTEXTS; ++ctx)
+          Add(fc->coeff_base_cdf[tx_size][plane][ctx], 4);
+        for (int ctx = 0; ctx < LEVEL_CONTEXTS; ++ctx)
+          Add(fc->coeff_br_cdf[tx_size][plane][ctx], BR_CDF_SIZE);
+      }
+    }
+    for (int plane = 0; plane < PLANE_TYPES; ++plane) {
+      for (int ctx = 0; ctx < DC_SIGN_CONTEXTS; ++ctx)
+        Add(fc->dc_sign_cdf[plane][ctx], 2);
+      for (int ctx = 0; ctx < 2; ++ctx)
+        Add(fc->eob_flag_cdf16[plane][ctx], 5);
+    }
+  }
+
+  void Add(aom_cdf_prob *cdf, int nsymbs) {
+    const AdaptedCdf adapted = { cdf, nsymbs };
+    adapted_.push_back(adapted);
+  }
+
+  // Adapts the CDFs as coding 'num_symbols' symbols would.
+  void CodeSymbols(int num_symbols) {
+    for (int i = 0; i < num_symbols; ++i) {
+      const int index = rnd_(static_cast<int>(adapted_.size()));
+      const AdaptedCdf &adapted = adapted_[index];
+      update_cdf(adapted.cdf, rnd_(adapted.nsymbs), adapted.nsymbs);
+    }
+  }
+
+  void Refresh(MACROBLOCK *x, int num_planes) {
+    av1_fill_mode_rates(cm_, x, cm_->fc);
+    av1_fill_coeff_costs(x, cm_->fc, num_planes);
+  }
+
+  void FullRefresh(MACROBLOCK *x, int num_planes) {
+    memset(&x->cost_cdfs, 0, sizeof(x->cost_cdfs));
+    Refresh(x, num_planes);
+  }
+
+  void ExpectSameCosts() {
+    const MACROBLOCK *const a = x_[0];
+    const MACROBLOCK *const b = x_[1];
+#define EXPECT_COSTS_EQ(field) \
+  EXPECT_EQ(0, memcmp(a->field, b->field, sizeof(a->field))) << #field
+    EXPECT_COSTS_EQ(partition_cost);
+    EXPECT_COSTS_EQ(skip_cost);
+    EXPECT_COSTS_EQ(skip_mode_cost);
+    EXPECT_COSTS_EQ(y_mode_costs);
+    EXPECT_COSTS_EQ(mbmode_cost);
+    EXPECT_COSTS_EQ(intra_uv_mode_cost);
+    EXPECT_COSTS_EQ(cfl_cost);
+    EXPECT_COSTS_EQ(inter_tx_type_costs);
+    EXPECT_COSTS_EQ(intra_tx_type_costs);
+    EXPECT_COSTS_EQ(newmv_mode_cost);
+    EXPECT_COSTS_EQ(comp_inter_cost);
+    EXPECT_COSTS_EQ(comp_group_idx_cost);
+    EXPECT_COSTS_EQ(coeff_costs);
+    EXPECT_COSTS_EQ(eob_costs);
+#undef EXPECT_COSTS_EQ
+    // The skip CDFs are shared by the planes and the DC sign CDFs by the
+    // transform sizes, so check those costs against the CDFs directly.
+    for (int tx_size = 0; tx_size < TX_SIZES; ++tx_size) {
+      for (int ctx = 0; ctx < TXB_SKIP_CONTEXTS; ++ctx) {
+        int costs[2];
+        av1_cost_tokens_from_cdf(costs, cm_->fc->txb_skip_cdf[tx_size][ctx],
+                                 NULL);
+        for (int plane = 0; plane < PLANE_TYPES; ++plane) {
+          const int *const txb_skip_cost =
+              a->coeff_costs[tx_size][plane].txb_skip_cost[ctx];
+          EXPECT_EQ(costs[0], txb_skip_cost[0]);
+          EXPECT_EQ(costs[1], txb_skip_cost[1]);
+        }
+      }
+      for (int plane = 0; plane < PLANE_TYPES; ++plane) {
+        for (int ctx = 0; ctx < DC_SIGN_CONTEXTS; ++ctx) {
+          int costs[2];
+          av1_cost_tokens_from_cdf(costs, cm_->fc->dc_sign_cdf[plane][ctx],
+                                   NULL);
+          const int *const dc_sign_cost =
+              a->coeff_costs[tx_size][plane].dc_sign_cost[ctx];
+          EXPECT_EQ(costs[0], dc_sign_cost[0]);
+          EXPECT_EQ(costs[1], dc_sign_cost[1]);
+        }
+      }
+    }
+  }
+
+  ACMRandom rnd_;
+  AV1_COMMON *cm_;
+  MACROBLOCK *x_[2];
+  std::vector<AdaptedCdf> adapted_;
+};
+
+TEST_F(CostTableTest, IncrementalMatchesFullRefresh) {
+  FullRefresh(x_[0], 3);
+  for (int i = 0; i < 100; ++i) {
+    CodeSymbols(rnd_(300));
+    // Also switch between monochrome and color, where the chroma costs are
+    // left alone for a while.
+    const int num_planes = (i / 10) % 3 == 2 ? 1 : 3;
+    Refresh(x_[0], num_planes);
+    FullRefresh(x_[1], num_planes);
+    if (num_planes == 1) continue;
+    ExpectSameCosts();
+    if (HasFailure()) break;
+  }
+}
+
+TEST_F(CostTableTest, DISABLED_Speed) {
+  // Roughly the symbols coded between refreshes at superblock, superblock row
+  // and tile update frequency.
+  static const int kSymbolsPerRefresh[] = { 16, 256, 4096 };
+  const int kNumRefreshes = 2000;
+  const FRAME_CONTEXT initial_fc = *cm_->fc;
+
+  for (size_t s = 0; s < sizeof(kSymbolsPerRefresh) / sizeof(int); ++s) {
+    const int symbols = kSymbolsPerRefresh[s];
+    int64_t elapsed[2];
+    for (int incremental = 0; incremental < 2; ++incremental) {
+      *cm_->fc = initial_fc;
+      FullRefresh(x_[0], 3);
+      aom_usec_timer timer;
+      int64_t coding_time = 0;
+      aom_usec_timer_start(&timer);
+      for (int i = 0; i < kNumRefreshes; ++i) {
+        aom_usec_timer coding_timer;
+        aom_usec_timer_start(&coding_timer);
+        CodeSymbols(symbols);
+        aom_usec_timer_mark(&coding_timer);
+        coding_time += aom_usec_timer_elapsed(&coding_timer);
+        if (incremental)
+          Refresh(x_[0], 3);
+        else
+          FullRefresh(x_[0], 3);
+      }
+      aom_usec_timer_mark(&timer);
+      elapsed[incremental] = aom_usec_timer_elapsed(&timer) - coding_time;
+    }
+    printf("%4d symbols per refresh: full %6.2f us, incremental %6.2f us\n",
+           symbols, static_cast<double>(elapsed[0]) / kNumRefreshes,
+           static_cast<double>(elapsed[1]) / kNumRefreshes);
+  }
+}
+
+}  // namespace
@@ -180,6 +180,10 @@ TEST_P(EncodeTxbTest, DISABLED_SpeedTestGetNzMapContexts) {
 INSTANTIATE_TEST_CASE_P(SSE2, EncodeTxbTest,
                         ::testing::Values(av1_get_nz_map_contexts_sse2));
 #endif
+#if HAVE_NEON
+INSTANTIATE_TEST_CASE_P(NEON, EncodeTxbTest,
+                        ::testing::Values(av1_get_nz_map_contexts_neon));
+#endif
 
 typedef void (*av1_txb_init_levels_func)(const tran_low_t *const coeff,
                                          const int width, const int height,
@@ -259,4 +263,10 @@ INSTANTIATE_TEST_CASE_P(
     ::testing::Combine(::testing::Values(&av1_txb_init_levels_avx2),
                        ::testing::Range(0, static_cast<int>(TX_SIZES_ALL), 1)));
 #endif
+#if HAVE_NEON
+INSTANTIATE_TEST_CASE_P(
+    NEON, EncodeTxbInitLevelTest,
+    ::testing::Combine(::testing::Values(&av1_txb_init_levels_neon),
+                       ::testing::Range(0, static_cast<int>(TX_SIZES_ALL), 1)));
+#endif
 }  // namespace
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "aom/aomcx.h"
+#include "aom/aomdx.h"
+#include "aom_ports/aom_timer.h"
+#include "test/codec_factory.h"
+#include "test/decode_test_driver.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+
+namespace {
+
+const int kNumFrames = 12;
+const unsigned int kNoUpdateFlags =
+    AOM_EFLAG_NO_UPD_LAST | AOM_EFLAG_NO_UPD_GF | AOM_EFLAG_NO_UPD_ARF;
+
+class FastPreviewTest : public ::libaom_test::CodecTestWithParam<int>,
+                        public ::libaom_test::EncoderTest {
+ protected:
+  FastPreviewTest() : EncoderTest(GET_PARAM(0)), cpu_used_(GET_PARAM(1)) {}
+  virtual ~FastPreviewTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = AOM_VBR;
+    cfg_.rc_target_bitrate = 300;
+  }
+
+  // Every other frame is not a reference.
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) encoder->Control(AOME_SET_CPUUSED, cpu_used_);
+    frame_flags_ &= ~kNoUpdateFlags;
+    if (video->frame() % 2) frame_flags_ |= kNoUpdateFlags;
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    const uint8_t *const buf =
+        static_cast<const uint8_t *>(pkt->data.frame.buf);
+    frames_.push_back(std::vector<uint8_t>(buf, buf + pkt->data.frame.sz));
+    is_reference_.push_back(!(pkt->data.frame.flags & AOM_FRAME_IS_DROPPABLE));
+  }
+
+  // The encoder's reconstruction only matches a decode without fast preview.
+  virtual bool DoDecode() const { return false; }
+
+  void Encode() {
+    ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352,
+                                         288, 30, 1, 0, kNumFrames);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    ASSERT_EQ(static_cast<size_t>(kNumFrames), frames_.size());
+  }
+
+  // Decodes the encoded frames with the given fast preview level and returns
+  // the MD5 of each output frame.
+  void Decode(int fast_preview, std::vector<std::string> *md5s) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    ::libaom_test::AV1Decoder decoder(cfg, 0);
+    decoder.Control(AV1D_SET_FAST_PREVIEW, fast_preview);
+    md5s->clear();
+    for (size_t i = 0; i < frames_.size(); ++i) {
+      ASSERT_EQ(AOM_CODEC_OK,
+                decoder.DecodeFrame(&frames_[i][0], frames_[i].size()))
+          << decoder.DecodeError();
+      ::libaom_test::DxDataIterator dec_iter = decoder.GetDxData();
+      const aom_image_t *img;
+      while ((img = dec_iter.Next()) != NULL) {
+        ::libaom_test::MD5 md5;
+        md5.Add(img);
+        md5s->push_back(md5.Get());
+      }
+    }
+  }
+
+  int cpu_used_;
+  std::vector<std::vector<uint8_t> > frames_;
+  std::vector<bool> is_reference_;
+};
+
+TEST_P(FastPreviewTest, DriftIsConfinedToLevel) {
+  ASSERT_NO_FATAL_FAILURE(Encode());
+  std::vector<std::string> exact, non_ref, no_cdef_lr, no_filters;
+  ASSERT_NO_FATAL_FAILURE(Decode(0, &exact));
+  ASSERT_NO_FATAL_FAILURE(Decode(1, &non_ref));
+  ASSERT_NO_FATAL_FAILURE(Decode(2, &no_cdef_lr));
+  ASSERT_NO_FATAL_FAILURE(Decode(3, &no_filters));
+  ASSERT_EQ(frames_.size(), exact.size());
+  ASSERT_EQ(exact.size(), non_ref.size());
+  ASSERT_EQ(exact.size(), no_cdef_lr.size());
+  ASSERT_EQ(exact.size(), no_filters.size());
+
+  // Level 1 only changes the frames that are not references.
+  int non_ref_changed = 0;
+  for (size_t i = 0; i < exact.size(); ++i) {
+    if (is_reference_[i]) {
+      EXPECT_EQ(exact[i], non_ref[i]) << "frame " << i;
+    } else {
+      non_ref_changed += exact[i] != non_ref[i];
+    }
+  }
+  EXPECT_GT(non_ref_changed, 0);
+
+  // The key frame is filtered at levels 2 and 3 too, so the other frames
+  // drift.
+  EXPECT_NE(exact[0], no_cdef_lr[0]);
+  EXPECT_NE(exact[0], no_filters[0]);
+  EXPECT_NE(no_cdef_lr[0], no_filters[0]);
+}
+
+TEST_P(FastPreviewTest, RejectsInvalidLevels) {
+  aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+  ::libaom_test::AV1Decoder decoder(cfg, 0);
+  decoder.Control(AV1D_SET_FAST_PREVIEW, -1, AOM_CODEC_INVALID_PARAM);
+  decoder.Control(AV1D_SET_FAST_PREVIEW, 4, AOM_CODEC_INVALID_PARAM);
+}
+
+// Decode throughput of each level.
+TEST_P(FastPreviewTest, DISABLED_Speed) {
+  const int kLoops = 20;
+  ASSERT_NO_FATAL_FAILURE(Encode());
+  std::vector<std::string> md5s;
+  for (int level = 0; level <= 3; ++level) {
+    aom_usec_timer timer;
+    aom_usec_timer_start(&timer);
+    for (int loop = 0; loop < kLoops; ++loop) {
+      ASSERT_NO_FATAL_FAILURE(Decode(level, &md5s));
+    }
+    aom_usec_timer_mark(&timer);
+    const double elapsed = static_cast<double>(aom_usec_timer_elapsed(&timer));
+    printf("fast preview %d: %7.1f fps\n", level,
+           kLoops * kNumFrames * 1000000.0 / elapsed);
+  }
+}
+
+AV1_INSTANTIATE_TEST_CASE(FastPreviewTest, ::testing::Values(6));
+}  // namespace
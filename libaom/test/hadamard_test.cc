@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <algorithm>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "config/aom_config.h"
+#include "config/aom_dsp_rtcd.h"
+
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+#include "aom_ports/mem.h"
+
+using libaom_test::ACMRandom;
+
+namespace {
+
+typedef void (*HadamardFunc)(const int16_t *src_diff, ptrdiff_t src_stride,
+                             tran_low_t *coeff);
+
+typedef ::testing::tuple<HadamardFunc, HadamardFunc, int> HadamardParam;
+
+class HadamardTest : public ::testing::TestWithParam<HadamardParam> {
+ public:
+  virtual ~HadamardTest() {}
+  virtual void SetUp() {
+    func_ = GET_PARAM(0);
+    ref_func_ = GET_PARAM(1);
+    bwh_ = GET_PARAM(2);
+    rnd_.Reset(ACMRandom::DeterministicSeed());
+  }
+
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  // The SIMD versions may store the coefficients in another order, which
+  // does not change the SATD computed from them, so the sorted outputs are
+  // compared.
+  void Compare(const int16_t *src_diff, int stride) {
+    DECLARE_ALIGNED(16, tran_low_t, coeff[32 * 32]);
+    DECLARE_ALIGNED(16, tran_low_t, ref_coeff[32 * 32]);
+    const int num_coeffs = bwh_ * bwh_;
+    ref_func_(src_diff, stride, ref_coeff);
+    ASM_REGISTER_STATE_CHECK(func_(src_diff, stride, coeff));
+    std::sort(coeff, coeff + num_coeffs);
+    std::sort(ref_coeff, ref_coeff + num_coeffs);
+    for (int i = 0; i < num_coeffs; ++i) {
+      ASSERT_EQ(ref_coeff[i], coeff[i]) << "at sorted index " << i;
+    }
+  }
+
+  void CompareReferenceRandom() {
+    DECLARE_ALIGNED(16, int16_t, src_diff[32 * 32]);
+    for (int iter = 0; iter < 100; ++iter) {
+      // The residuals of 8-bit pixels are 9 bit.
+      for (int i = 0; i < bwh_ * bwh_; ++i) {
+        src_diff[i] = rnd_.Rand9Signed();
+      }
+      Compare(src_diff, bwh_);
+    }
+  }
+
+  void VaryStride() {
+    DECLARE_ALIGNED(16, int16_t, src_diff[32 * 32 * 8]);
+    for (int i = 0; i < 32 * 32 * 8; ++i) src_diff[i] = rnd_.Rand9Signed();
+    for (int stride = bwh_; stride <= 8 * bwh_; stride += bwh_) {
+      Compare(src_diff, stride);
+    }
+  }
+
+  HadamardFunc func_;
+  HadamardFunc ref_func_;
+  int bwh_;
+  ACMRandom rnd_;
+};
+
+TEST_P(HadamardTest, CompareReferenceRandom) { CompareReferenceRandom(); }
+TEST_P(HadamardTest, VaryStride) { VaryStride(); }
+
+using ::testing::make_tuple;
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(
+    SSE2, HadamardTest,
+    ::testing::Values(
+        make_tuple(&aom_hadamard_8x8_sse2, &aom_hadamard_8x8_c, 8),
+        make_tuple(&aom_hadamard_16x16_sse2, &aom_hadamard_16x16_c, 16),
+        make_tuple(&aom_hadamard_32x32_sse2, &aom_hadamard_32x32_c, 32)));
+#endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(
+    AVX2, HadamardTest,
+    ::testing::Values(
+        make_tuple(&aom_hadamard_16x16_avx2, &aom_hadamard_16x16_c, 16),
+        make_tuple(&aom_hadamard_32x32_avx2, &aom_hadamard_32x32_c, 32)));
+#endif  // HAVE_AVX2
+
+#if HAVE_NEON
+INSTANTIATE_TEST_CASE_P(
+    NEON, HadamardTest,
+    ::testing::Values(
+        make_tuple(&aom_hadamard_8x8_neon, &aom_hadamard_8x8_c, 8),
+        make_tuple(&aom_hadamard_16x16_neon, &aom_hadamard_16x16_c, 16)));
+#endif  // HAVE_NEON
+
+typedef int (*SatdFunc)(const tran_low_t *coeff, int length);
+
+typedef ::testing::tuple<SatdFunc, int> SatdParam;
+
+class SatdTest : public ::testing::TestWithParam<SatdParam> {
+ public:
+  virtual ~SatdTest() {}
+  virtual void SetUp() {
+    func_ = GET_PARAM(0);
+    length_ = GET_PARAM(1);
+    rnd_.Reset(ACMRandom::DeterministicSeed());
+  }
+
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  void Check(const tran_low_t *coeff) {
+    const int ref = aom_satd_c(coeff, length_);
+    int satd;
+    ASM_REGISTER_STATE_CHECK(satd = func_(coeff, length_));
+    ASSERT_EQ(ref, satd) << "length " << length_;
+  }
+
+  SatdFunc func_;
+  int length_;
+  ACMRandom rnd_;
+};
+
+// The hadamard outputs are 16 bit, in [-32640, 32640].
+TEST_P(SatdTest, Random) {
+  DECLARE_ALIGNED(16, tran_low_t, coeff[1024]);
+  for (int iter = 0; iter < 100; ++iter) {
+    for (int i = 0; i < length_; ++i) {
+      coeff[i] = static_cast<int>(rnd_(2 * 32640 + 1)) - 32640;
+    }
+    Check(coeff);
+  }
+}
+
+TEST_P(SatdTest, Extreme) {
+  DECLARE_ALIGNED(16, tran_low_t, coeff[1024]);
+  for (int i = 0; i < length_; ++i) coeff[i] = 32640;
+  Check(coeff);
+  for (int i = 0; i < length_; ++i) coeff[i] = -32640;
+  Check(coeff);
+  for (int i = 0; i < length_; ++i) coeff[i] = 0;
+  Check(coeff);
+}
+
+INSTANTIATE_TEST_CASE_P(C, SatdTest,
+                        ::testing::Values(make_tuple(&aom_satd_c, 16),
+                                          make_tuple(&aom_satd_c, 64),
+                                          make_tuple(&aom_satd_c, 256),
+                                          make_tuple(&aom_satd_c, 1024)));
+
+#if HAVE_SSE2
+INSTANTIATE_TEST_CASE_P(SSE2, SatdTest,
+                        ::testing::Values(make_tuple(&aom_satd_sse2, 16),
+                                          make_tuple(&aom_satd_sse2, 64),
+                                          make_tuple(&aom_satd_sse2, 256),
+                                          make_tuple(&aom_satd_sse2, 1024)));
+#endif  // HAVE_SSE2
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, SatdTest,
+                        ::testing::Values(make_tuple(&aom_satd_avx2, 16),
+                                          make_tuple(&aom_satd_avx2, 64),
+                                          make_tuple(&aom_satd_avx2, 256),
+                                          make_tuple(&aom_satd_avx2, 1024)));
+#endif  // HAVE_AVX2
+
+#if HAVE_NEON
+INSTANTIATE_TEST_CASE_P(NEON, SatdTest,
+                        ::testing::Values(make_tuple(&aom_satd_neon, 16),
+                                          make_tuple(&aom_satd_neon, 64),
+                                          make_tuple(&aom_satd_neon, 256),
+                                          make_tuple(&aom_satd_neon, 1024)));
+#endif  // HAVE_NEON
+
+}  // namespace
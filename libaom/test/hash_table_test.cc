@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string.h>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "config/av1_rtcd.h"
+
+#include "aom_mem/aom_mem.h"
+#include "aom_scale/yv12config.h"
+#include "aom_util/aom_thread.h"
+#include "av1/encoder/block.h"
+#include "av1/encoder/hash_motion.h"
+#include "test/acm_random.h"
+
+namespace {
+
+const int kWidth = 200;
+const int kHeight = 150;
+const int kNumWorkers = 3;
+
+class HashTableTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    av1_rtcd();
+    rnd_.Reset(libaom_test::ACMRandom::DeterministicSeed());
+    memset(&picture_, 0, sizeof(picture_));
+    ASSERT_EQ(aom_alloc_frame_buffer(&picture_, kWidth, kHeight, 1, 1, 0, 32,
+                                     16),
+              0);
+    x_ = static_cast<MACROBLOCK *>(aom_calloc(1, sizeof(*x_)));
+    ASSERT_TRUE(x_ != NULL);
+    for (int i = 0; i < 2; ++i) {
+      for (int j = 0; j < 2; ++j) {
+        x_->hash_value_buffer[i][j] = static_cast<uint32_t *>(aom_malloc(
+            AOM_BUFFER_SIZE_FOR_BLOCK_HASH * sizeof(uint32_t)));
+        ASSERT_TRUE(x_->hash_value_buffer[i][j] != NULL);
+      }
+    }
+    av1_hash_table_init(&table_[0], x_);
+    av1_hash_table_init(&table_[1], x_);
+    FillPicture(0, kHeight);
+  }
+
+  virtual void TearDown() {
+    av1_hash_table_destroy(&table_[0]);
+    av1_hash_table_destroy(&table_[1]);
+    for (int i = 0; i < 2; ++i) {
+      for (int j = 0; j < 2; ++j) aom_free(x_->hash_value_buffer[i][j]);
+    }
+    aom_free(x_);
+    aom_free_frame_buffer(&picture_);
+  }
+
+  // Draws 8x8 tiles picked from a few patterns, some of them flat, so that
+  // many blocks have several matches.
+  void FillPicture(int row_start, int row_end) {
+    for (int r = row_start; r < row_end; ++r) {
+      for (int c = 0; c < kWidth; c += 8) {
+        const int pattern = (r / 8 * 7 + c / 8 * 3 + rnd_(2)) % 5;
+        for (int i = c; i < AOMMIN(c + 8, kWidth); ++i) {
+          picture_.y_buffer[r * picture_.y_stride + i] =
+              pattern < 2 ? 10 * pattern : ((r % 8) * 8 + i % 8) * pattern;
+        }
+      }
+    }
+  }
+
+  void Build(hash_table *table, const hash_table *prev_table, int row_start,
+             int row_end, AVxWorker *workers, int num_workers) {
+    ASSERT_EQ(av1_hash_table_build(table, prev_table, &picture_, row_start,
+                                   row_end, x_, workers, num_workers),
+              0);
+  }
+
+  void ExpectSameTables(const hash_table &a, const hash_table &b) {
+    ASSERT_EQ(a.num_entries, b.num_entries);
+    ASSERT_GT(a.num_entries, 0);
+    EXPECT_EQ(memcmp(a.p_bucket_start, b.p_bucket_start,
+                     sizeof(*a.p_bucket_start) * ((1 << 19) + 1)),
+              0);
+    for (int i = 0; i < a.num_entries; ++i) {
+      ASSERT_EQ(a.p_entries[i].x, b.p_entries[i].x) << i;
+      ASSERT_EQ(a.p_entries[i].y, b.p_entries[i].y) << i;
+      ASSERT_EQ(a.p_entries[i].hash_value2, b.p_entries[i].hash_value2) << i;
+    }
+  }
+
+  libaom_test::ACMRandom rnd_;
+  YV12_BUFFER_CONFIG picture_;
+  MACROBLOCK *x_;
+  hash_table table_[2];
+};
+
+TEST_F(HashTableTest, ExactMatch) {
+  Build(&table_[0], NULL, 0, 0, NULL, 0);
+  for (int block_size = 4; block_size <= 128; block_size *= 2) {
+    for (int i = 0; i < 20; ++i) {
+      const int x_pos = rnd_(kWidth - block_size + 1);
+      const int y_pos = rnd_(kHeight - block_size + 1);
+      uint32_t hash_value1, hash_value2;
+      av1_get_block_hash_value(
+          picture_.y_buffer + y_pos * picture_.y_stride + x_pos,
+          picture_.y_stride, block_size, &hash_value1, &hash_value2, 0, x_);
+      if (av1_hash_is_horizontal_perfect(&picture_, block_size, x_pos,
+                                         y_pos) ||
+          av1_hash_is_vertical_perfect(&picture_, block_size, x_pos, y_pos)) {
+        continue;
+      }
+      // The block itself is in the table.
+      const int count = av1_hash_table_count(&table_[0], hash_value1);
+      ASSERT_GT(count, 0);
+      const block_hash *blocks =
+          av1_hash_get_first_block(&table_[0], hash_value1);
+      int found = 0;
+      for (int j = 0; j < count; ++j) {
+        found |= blocks[j].x == x_pos && blocks[j].y == y_pos &&
+                 blocks[j].hash_value2 == hash_value2;
+      }
+      EXPECT_TRUE(found) << block_size << " " << x_pos << " " << y_pos;
+      EXPECT_TRUE(av1_has_exact_match(&table_[0], hash_value1, hash_value2));
+    }
+  }
+}
+
+TEST_F(HashTableTest, Update) {
+  const int kChanges[][2] = { { 60, 70 }, { 0, 1 },      { 149, 150 },
+                              { 0, 150 }, { 100, 100 } };
+  Build(&table_[0], NULL, 0, 0, NULL, 0);
+  for (const auto &change : kChanges) {
+    FillPicture(change[0], change[1]);
+    // Update the table in place, and compare it with a new one.
+    Build(&table_[0], &table_[0], change[0], change[1], NULL, 0);
+    Build(&table_[1], NULL, 0, 0, NULL, 0);
+    ExpectSameTables(table_[0], table_[1]);
+    if (HasFailure()) return;
+    // Update the other table from it.
+    FillPicture(change[0], change[1]);
+    Build(&table_[1], &table_[0], change[0], change[1], NULL, 0);
+    Build(&table_[0], NULL, 0, 0, NULL, 0);
+    ExpectSameTables(table_[0], table_[1]);
+    if (HasFailure()) return;
+  }
+}
+
+TEST_F(HashTableTest, MultiThreaded) {
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  AVxWorker workers[kNumWorkers];
+  for (int i = 0; i < kNumWorkers; ++i) {
+    winterface->init(&workers[i]);
+    if (i > 0) {
+      ASSERT_TRUE(winterface->reset(&workers[i]));
+    }
+  }
+  Build(&table_[0], NULL, 0, 0, NULL, 0);
+  Build(&table_[1], NULL, 0, 0, workers, kNumWorkers);
+  ExpectSameTables(table_[0], table_[1]);
+  FillPicture(20, 40);
+  Build(&table_[0], NULL, 0, 0, NULL, 0);
+  Build(&table_[1], &table_[1], 20, 40, workers, kNumWorkers);
+  ExpectSameTables(table_[0], table_[1]);
+  for (int i = 0; i < kNumWorkers; ++i) winterface->end(&workers[i]);
+}
+
+}  // namespace
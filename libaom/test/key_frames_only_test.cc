@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "aom/aomcx.h"
+#include "aom/aomdx.h"
+#include "aom_ports/aom_timer.h"
+#include "test/codec_factory.h"
+#include "test/decode_test_driver.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+
+namespace {
+
+const int kWidth = 352;
+const int kHeight = 288;
+const int kNumFrames = 16;
+const int kKeyFrameInterval = 5;
+
+// Returns a luma sample of a low or high bit depth image.
+int LumaSample(const aom_image_t *img, unsigned int row, unsigned int col) {
+  const uint8_t *const buf =
+      img->planes[AOM_PLANE_Y] + row * img->stride[AOM_PLANE_Y];
+  if (img->fmt & AOM_IMG_FMT_HIGHBITDEPTH) {
+    return reinterpret_cast<const uint16_t *>(buf)[col];
+  }
+  return buf[col];
+}
+
+class KeyFramesOnlyTest : public ::libaom_test::CodecTestWithParam<int>,
+                          public ::libaom_test::EncoderTest {
+ protected:
+  KeyFramesOnlyTest() : EncoderTest(GET_PARAM(0)), cpu_used_(GET_PARAM(1)) {}
+  virtual ~KeyFramesOnlyTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = AOM_VBR;
+    cfg_.rc_target_bitrate = 300;
+    cfg_.kf_min_dist = kKeyFrameInterval;
+    cfg_.kf_max_dist = kKeyFrameInterval;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) encoder->Control(AOME_SET_CPUUSED, cpu_used_);
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    const uint8_t *const buf =
+        static_cast<const uint8_t *>(pkt->data.frame.buf);
+    frames_.push_back(std::vector<uint8_t>(buf, buf + pkt->data.frame.sz));
+    is_key_frame_.push_back((pkt->data.frame.flags & AOM_FRAME_IS_KEY) != 0);
+  }
+
+  void Encode() {
+    ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", kWidth,
+                                         kHeight, 30, 1, 0, kNumFrames);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    ASSERT_EQ(static_cast<size_t>(kNumFrames), frames_.size());
+  }
+
+  // Decodes the encoded frames and calls 'on_frame' with each output frame.
+  template <typename Callback>
+  void Decode(int key_frames_only, int downscale, Callback on_frame) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    ::libaom_test::AV1Decoder decoder(cfg, 0);
+    decoder.Control(AV1D_SET_KEY_FRAMES_ONLY, key_frames_only);
+    decoder.Control(AV1D_SET_OUTPUT_DOWNSCALE, downscale);
+    for (size_t i = 0; i < frames_.size(); ++i) {
+      ASSERT_EQ(AOM_CODEC_OK,
+                decoder.DecodeFrame(&frames_[i][0], frames_[i].size()))
+          << decoder.DecodeError();
+      ::libaom_test::DxDataIterator dec_iter = decoder.GetDxData();
+      const aom_image_t *img;
+      while ((img = dec_iter.Next()) != NULL) on_frame(i, img);
+    }
+  }
+
+  void DecodeMd5(int key_frames_only, std::vector<std::string> *md5s,
+                 std::vector<size_t> *frame_indices) {
+    md5s->clear();
+    frame_indices->clear();
+    Decode(key_frames_only, 1, [&](size_t i, const aom_image_t *img) {
+      ::libaom_test::MD5 md5;
+      md5.Add(img);
+      md5s->push_back(md5.Get());
+      frame_indices->push_back(i);
+    });
+  }
+
+  int cpu_used_;
+  std::vector<std::vector<uint8_t> > frames_;
+  std::vector<bool> is_key_frame_;
+};
+
+// Only the key frames are output, and they match a full decode.
+TEST_P(KeyFramesOnlyTest, MatchesFullDecode) {
+  ASSERT_NO_FATAL_FAILURE(Encode());
+  std::vector<std::string> all_md5s, key_md5s;
+  std::vector<size_t> all_indices, key_indices;
+  ASSERT_NO_FATAL_FAILURE(DecodeMd5(0, &all_md5s, &all_indices));
+  ASSERT_NO_FATAL_FAILURE(DecodeMd5(1, &key_md5s, &key_indices));
+  ASSERT_EQ(frames_.size(), all_md5s.size());
+
+  std::vector<size_t> expected_indices;
+  for (size_t i = 0; i < frames_.size(); ++i) {
+    if (is_key_frame_[i]) expected_indices.push_back(i);
+  }
+  ASSERT_GT(expected_indices.size(), 1u);
+  ASSERT_EQ(expected_indices, key_indices);
+  for (size_t i = 0; i < key_indices.size(); ++i) {
+    EXPECT_EQ(all_md5s[key_indices[i]], key_md5s[i]) << "frame " << i;
+  }
+}
+
+// Each output sample is the rounded average of a factor x factor block of the
+// full size frame.
+TEST_P(KeyFramesOnlyTest, Downscale) {
+  ASSERT_NO_FATAL_FAILURE(Encode());
+  std::vector<std::vector<int> > full_frames;
+  ASSERT_NO_FATAL_FAILURE(Decode(1, 1, [&](size_t, const aom_image_t *img) {
+    std::vector<int> y;
+    for (int r = 0; r < kHeight; ++r) {
+      for (int c = 0; c < kWidth; ++c) y.push_back(LumaSample(img, r, c));
+    }
+    full_frames.push_back(y);
+  }));
+
+  for (int factor = 2; factor <= 4; factor *= 2) {
+    size_t num_frames = 0;
+    ASSERT_NO_FATAL_FAILURE(
+        Decode(1, factor, [&](size_t, const aom_image_t *img) {
+          const std::vector<int> &full = full_frames[num_frames++];
+          ASSERT_EQ(static_cast<unsigned int>(kWidth / factor), img->d_w);
+          ASSERT_EQ(static_cast<unsigned int>(kHeight / factor), img->d_h);
+          for (unsigned int r = 0; r < img->d_h; ++r) {
+            for (unsigned int c = 0; c < img->d_w; ++c) {
+              int sum = 0;
+              for (int i = 0; i < factor; ++i) {
+                for (int j = 0; j < factor; ++j) {
+                  sum += full[(r * factor + i) * kWidth + c * factor + j];
+                }
+              }
+              const int n = factor * factor;
+              ASSERT_EQ((sum + n / 2) / n, LumaSample(img, r, c));
+            }
+          }
+        }));
+    EXPECT_EQ(full_frames.size(), num_frames);
+  }
+}
+
+TEST_P(KeyFramesOnlyTest, RejectsInvalidDownscale) {
+  aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+  ::libaom_test::AV1Decoder decoder(cfg, 0);
+  decoder.Control(AV1D_SET_OUTPUT_DOWNSCALE, 0, AOM_CODEC_INVALID_PARAM);
+  decoder.Control(AV1D_SET_OUTPUT_DOWNSCALE, 3, AOM_CODEC_INVALID_PARAM);
+  decoder.Control(AV1D_SET_OUTPUT_DOWNSCALE, 8, AOM_CODEC_INVALID_PARAM);
+}
+
+// Time to make one thumbnail per key frame.
+TEST_P(KeyFramesOnlyTest, DISABLED_Speed) {
+  const int kLoops = 20;
+  ASSERT_NO_FATAL_FAILURE(Encode());
+  static const int kModes[][2] = { { 0, 1 }, { 1, 1 }, { 1, 4 } };
+  for (const auto &mode : kModes) {
+    int num_output = 0;
+    aom_usec_timer timer;
+    aom_usec_timer_start(&timer);
+    for (int loop = 0; loop < kLoops; ++loop) {
+      ASSERT_NO_FATAL_FAILURE(Decode(
+          mode[0], mode[1],
+          [&](size_t, const aom_image_t *) { ++num_output; }));
+    }
+    aom_usec_timer_mark(&timer);
+    const double elapsed = static_cast<double>(aom_usec_timer_elapsed(&timer));
+    printf("key frames only %d, downscale %d: %7.2f ms per stream, "
+           "%d frames out\n",
+           mode[0], mode[1], elapsed / 1000 / kLoops, num_output / kLoops);
+  }
+}
+
+AV1_INSTANTIATE_TEST_CASE(KeyFramesOnlyTest, ::testing::Values(6));
+}  // namespace
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "av1/common/obu_util.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/util.h"
+#include "test/video_source.h"
+
+namespace {
+
+const unsigned int kNumFrames = 40;
+const unsigned int kSceneCutFrame = 20;
+const unsigned int kFlashFrame = 14;
+const unsigned int kNone = kNumFrames;
+// The default minimum gf interval at 30 fps.
+const int kMinGfInterval = 4;
+
+// A slowly panning texture that switches to unrelated content at 'scene_cut'
+// and is much brighter for the single frame 'flash'.
+class SyntheticVideoSource : public ::libaom_test::DummyVideoSource {
+ public:
+  SyntheticVideoSource(unsigned int scene_cut, unsigned int flash)
+      : scene_cut_(scene_cut), flash_(flash) {}
+
+ protected:
+  virtual void FillFrame() {
+    if (!img_) return;
+    const int scene = frame_ >= scene_cut_;
+    const int brightness = frame_ == flash_ ? 96 : 0;
+    const int offset = frame_;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = plane ? (img_->d_w + 1) >> 1 : img_->d_w;
+      const int h = plane ? (img_->d_h + 1) >> 1 : img_->d_h;
+      for (int r = 0; r < h; ++r) {
+        uint8_t *const row = img_->planes[plane] + r * img_->stride[plane];
+        for (int c = 0; c < w; ++c) {
+          if (plane)
+            row[c] = scene ? 90 + 4 * plane : 128;
+          else if (scene)
+            row[c] = static_cast<uint8_t>(32 + ((r + offset) * 11 + c) % 160);
+          else
+            row[c] = static_cast<uint8_t>(brightness + 64 +
+                                          ((c + offset) * 7 + r * 3) % 96);
+        }
+      }
+    }
+  }
+
+  const unsigned int scene_cut_;
+  const unsigned int flash_;
+};
+
+class LookaheadAnalysisTest
+    : public ::libaom_test::CodecTestWithParam<int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  LookaheadAnalysisTest() : EncoderTest(GET_PARAM(0)) {}
+  virtual ~LookaheadAnalysisTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cpu_used_ = GET_PARAM(1);
+    cfg_.rc_end_usage = AOM_VBR;
+    cfg_.rc_target_bitrate = 300;
+    cfg_.g_lag_in_frames = 25;
+    cfg_.kf_mode = AOM_KF_AUTO;
+    cfg_.kf_min_dist = 0;
+    cfg_.kf_max_dist = 9999;
+    cfg_.g_threads = 0;
+  }
+
+  virtual void BeginPassHook(unsigned int) {
+    key_frames_.clear();
+    gf_groups_.clear();
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) encoder->Control(AOME_SET_CPUUSED, cpu_used_);
+  }
+
+  // Returns the number of frames coded in the temporal unit of 'pkt'.
+  static int GetNumFramesInPkt(const aom_codec_cx_pkt_t *pkt) {
+    const uint8_t *data = static_cast<const uint8_t *>(pkt->data.frame.buf);
+    size_t remaining = pkt->data.frame.sz;
+    int frames = 0;
+    while (remaining > 0) {
+      ObuHeader header;
+      size_t payload_size, header_size;
+      if (aom_read_obu_header_and_size(data, remaining, 0, &header,
+                                       &payload_size,
+                                       &header_size) != AOM_CODEC_OK)
+        break;
+      if (header.type == OBU_FRAME || header.type == OBU_FRAME_HEADER)
+        ++frames;
+      data += header_size + payload_size;
+      remaining -= header_size + payload_size;
+    }
+    return frames;
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    if (pkt->data.frame.flags & AOM_FRAME_IS_KEY)
+      key_frames_.push_back(pkt->data.frame.pts);
+    // The alt ref of a gf group is coded along with the group's first frame.
+    if (GetNumFramesInPkt(pkt) > 1) gf_groups_.push_back(pkt->data.frame.pts);
+  }
+
+  // Returns the first frame of the gf group, or key frame, that 'pts' is in.
+  aom_codec_pts_t GetGfGroup(aom_codec_pts_t pts) const {
+    aom_codec_pts_t start = 0;
+    for (size_t i = 0; i < gf_groups_.size(); ++i)
+      if (gf_groups_[i] <= pts && gf_groups_[i] > start) start = gf_groups_[i];
+    for (size_t i = 0; i < key_frames_.size(); ++i)
+      if (key_frames_[i] <= pts && key_frames_[i] > start)
+        start = key_frames_[i];
+    return start;
+  }
+
+  // Returns the length of the gf group that starts at 'pts', which ends at the
+  // next group or key frame.
+  int GetGfInterval(aom_codec_pts_t pts) const {
+    aom_codec_pts_t end = kNumFrames;
+    for (size_t i = 0; i < gf_groups_.size(); ++i)
+      if (gf_groups_[i] > pts && gf_groups_[i] < end) end = gf_groups_[i];
+    for (size_t i = 0; i < key_frames_.size(); ++i)
+      if (key_frames_[i] > pts && key_frames_[i] < end) end = key_frames_[i];
+    return static_cast<int>(end - pts);
+  }
+
+  int cpu_used_;
+  std::vector<aom_codec_pts_t> key_frames_;
+  std::vector<aom_codec_pts_t> gf_groups_;
+};
+
+// The lookahead analysis should place a key frame on the scene cut, and no
+// other key frame besides the first one. The gf groups should run up to the
+// scene cut rather than leave a short group before it.
+TEST_P(LookaheadAnalysisTest, KeyFrameOnSceneCut) {
+  SyntheticVideoSource video(kSceneCutFrame, kNone);
+  video.SetSize(176, 144);
+  video.set_limit(kNumFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  ASSERT_EQ(2u, key_frames_.size());
+  EXPECT_EQ(0, key_frames_[0]);
+  EXPECT_EQ(kSceneCutFrame, key_frames_[1]);
+  ASSERT_FALSE(gf_groups_.empty());
+  for (size_t i = 0; i < gf_groups_.size(); ++i) {
+    const int interval = GetGfInterval(gf_groups_[i]);
+    if (gf_groups_[i] + interval < kNumFrames) {
+      EXPECT_GE(interval, kMinGfInterval) << "gf group at " << gf_groups_[i];
+    }
+  }
+}
+
+// A single frame flash is no scene cut, and the gf group it falls in should be
+// no shorter than without the flash.
+TEST_P(LookaheadAnalysisTest, FlashInGfGroup) {
+  SyntheticVideoSource plain_video(kNone, kNone);
+  plain_video.SetSize(176, 144);
+  plain_video.set_limit(kNumFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&plain_video));
+  const aom_codec_pts_t plain_group = GetGfGroup(kFlashFrame);
+  const int plain_interval = GetGfInterval(plain_group);
+
+  SyntheticVideoSource video(kNone, kFlashFrame);
+  video.SetSize(176, 144);
+  video.set_limit(kNumFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  ASSERT_EQ(1u, key_frames_.size());
+  EXPECT_EQ(0, key_frames_[0]);
+  const aom_codec_pts_t group = GetGfGroup(kFlashFrame);
+  EXPECT_EQ(plain_group, group);
+  EXPECT_GE(GetGfInterval(group), plain_interval);
+}
+
+AV1_INSTANTIATE_TEST_CASE(LookaheadAnalysisTest, ::testing::Values(4, 6));
+}  // namespace
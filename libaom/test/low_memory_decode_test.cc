@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "aom/aomcx.h"
+#include "aom/aomdx.h"
+#include "av1/decoder/scratch_pool.h"
+#include "test/codec_factory.h"
+#include "test/decode_test_driver.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+
+namespace {
+
+const int kNumFrames = 10;
+const int kNumDecoders = 4;
+
+class LowMemoryDecodeTest
+    : public ::libaom_test::CodecTestWith2Params<int, int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  LowMemoryDecodeTest()
+      : EncoderTest(GET_PARAM(0)), enable_ref_frame_mvs_(GET_PARAM(1)),
+        aq_mode_(GET_PARAM(2)) {}
+  virtual ~LowMemoryDecodeTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = AOM_CBR;
+    cfg_.rc_target_bitrate = 300;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 6);
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 1);
+      encoder->Control(AV1E_SET_ENABLE_REF_FRAME_MVS, enable_ref_frame_mvs_);
+      encoder->Control(AV1E_SET_AQ_MODE, aq_mode_);
+    }
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    const uint8_t *const buf =
+        static_cast<const uint8_t *>(pkt->data.frame.buf);
+    frames_.push_back(std::vector<uint8_t>(buf, buf + pkt->data.frame.sz));
+  }
+
+  void Encode() {
+    ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352,
+                                         288, 30, 1, 0, kNumFrames);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    ASSERT_EQ(static_cast<size_t>(kNumFrames), frames_.size());
+  }
+
+  ::libaom_test::AV1Decoder *NewDecoder(int low_memory, int threads) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = threads;
+    ::libaom_test::AV1Decoder *const decoder =
+        new ::libaom_test::AV1Decoder(cfg, 0);
+    decoder->Control(AV1D_SET_LOW_MEMORY, low_memory);
+    return decoder;
+  }
+
+  // Decodes frame 'i' and appends the MD5 of the output to 'md5s'.
+  void DecodeFrame(::libaom_test::AV1Decoder *decoder, size_t i,
+                   std::vector<std::string> *md5s) {
+    ASSERT_EQ(AOM_CODEC_OK,
+              decoder->DecodeFrame(&frames_[i][0], frames_[i].size()))
+        << decoder->DecodeError();
+    ::libaom_test::DxDataIterator dec_iter = decoder->GetDxData();
+    const aom_image_t *img;
+    while ((img = dec_iter.Next()) != NULL) {
+      ::libaom_test::MD5 md5;
+      md5.Add(img);
+      md5s->push_back(md5.Get());
+    }
+  }
+
+  void Decode(int low_memory, int threads, std::vector<std::string> *md5s,
+              uint64_t *peak_memory) {
+    std::unique_ptr< ::libaom_test::AV1Decoder> decoder(
+        NewDecoder(low_memory, threads));
+    md5s->clear();
+    for (size_t i = 0; i < frames_.size(); ++i) {
+      ASSERT_NO_FATAL_FAILURE(DecodeFrame(decoder.get(), i, md5s));
+    }
+    ASSERT_EQ(frames_.size(), md5s->size());
+    decoder->Control(AV1D_GET_PEAK_MEMORY, peak_memory);
+  }
+
+  int enable_ref_frame_mvs_;
+  int aq_mode_;
+  std::vector<std::vector<uint8_t> > frames_;
+};
+
+// The output matches the default mode with less memory.
+TEST_P(LowMemoryDecodeTest, MatchesDefaultMode) {
+  ASSERT_NO_FATAL_FAILURE(Encode());
+  for (int threads = 1; threads <= 4; threads += 3) {
+    std::vector<std::string> md5s, low_memory_md5s;
+    uint64_t peak = 0, low_memory_peak = 0;
+    ASSERT_NO_FATAL_FAILURE(Decode(0, threads, &md5s, &peak));
+    ASSERT_NO_FATAL_FAILURE(
+        Decode(1, threads, &low_memory_md5s, &low_memory_peak));
+    EXPECT_EQ(md5s, low_memory_md5s) << "threads " << threads;
+    EXPECT_GT(low_memory_peak, 0u);
+    EXPECT_LT(low_memory_peak, peak) << "threads " << threads;
+  }
+}
+
+// Decoders that decode their frames in turn share the scratch buffers.
+TEST_P(LowMemoryDecodeTest, InterleavedDecoders) {
+  ASSERT_NO_FATAL_FAILURE(Encode());
+  std::vector<std::string> expected_md5s;
+  uint64_t peak = 0;
+  ASSERT_NO_FATAL_FAILURE(Decode(0, 1, &expected_md5s, &peak));
+
+  std::unique_ptr< ::libaom_test::AV1Decoder> decoders[kNumDecoders];
+  std::vector<std::string> md5s[kNumDecoders];
+  for (int d = 0; d < kNumDecoders; ++d) decoders[d].reset(NewDecoder(1, 1));
+  for (size_t i = 0; i < frames_.size(); ++i) {
+    for (int d = 0; d < kNumDecoders; ++d) {
+      ASSERT_NO_FATAL_FAILURE(DecodeFrame(decoders[d].get(), i, &md5s[d]));
+    }
+  }
+  for (int d = 0; d < kNumDecoders; ++d) {
+    EXPECT_EQ(expected_md5s, md5s[d]) << "decoder " << d;
+  }
+}
+
+TEST_P(LowMemoryDecodeTest, SetBeforeFirstFrame) {
+  ASSERT_NO_FATAL_FAILURE(Encode());
+  std::unique_ptr< ::libaom_test::AV1Decoder> decoder(NewDecoder(0, 1));
+  std::vector<std::string> md5s;
+  ASSERT_NO_FATAL_FAILURE(DecodeFrame(decoder.get(), 0, &md5s));
+  decoder->Control(AV1D_SET_LOW_MEMORY, 0);
+  decoder->Control(AV1D_SET_LOW_MEMORY, 1, AOM_CODEC_ERROR);
+}
+
+// The pool keeps as many free buffers as were in use at once, dropping the
+// buffers of earlier frames that are too large to be reused.
+TEST(ScratchPoolTest, TrimmedToCurrentNeed) {
+  const size_t kLargeSize = 1 << 20;
+  const size_t kSmallSize = 4096;
+  av1_scratch_pool_add_user();
+  ASSERT_EQ(0u, av1_scratch_pool_free_size());
+
+  void *bufs[4];
+  for (int i = 0; i < 4; ++i) {
+    bufs[i] = av1_scratch_pool_get(kLargeSize);
+    ASSERT_TRUE(bufs[i] != NULL);
+  }
+  for (int i = 0; i < 4; ++i) av1_scratch_pool_put(bufs[i]);
+  EXPECT_EQ(4 * kLargeSize, av1_scratch_pool_free_size());
+
+  // A frame that needs two large buffers reuses them.
+  bufs[0] = av1_scratch_pool_get(kLargeSize);
+  bufs[1] = av1_scratch_pool_get(kLargeSize);
+  av1_scratch_pool_put(bufs[0]);
+  av1_scratch_pool_put(bufs[1]);
+  EXPECT_EQ(2 * kLargeSize, av1_scratch_pool_free_size());
+
+  // A frame that needs one small buffer releases the large ones.
+  bufs[0] = av1_scratch_pool_get(kSmallSize);
+  ASSERT_TRUE(bufs[0] != NULL);
+  EXPECT_EQ(kSmallSize, av1_scratch_pool_buf_size(bufs[0]));
+  av1_scratch_pool_put(bufs[0]);
+  EXPECT_EQ(kSmallSize, av1_scratch_pool_free_size());
+
+  av1_scratch_pool_remove_user();
+  EXPECT_EQ(0u, av1_scratch_pool_free_size());
+}
+
+AV1_INSTANTIATE_TEST_CASE(LowMemoryDecodeTest, ::testing::Values(0, 1),
+                          ::testing::Values(0, 3));
+}  // namespace
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "aom/aom_encoder.h"
+#include "aom/aomcx.h"
+#include "aom_ports/aom_timer.h"
+
+namespace {
+
+const int kWidth = 352;
+const int kHeight = 288;
+const unsigned int kCols = (kWidth + 15) / 16;
+const unsigned int kRows = (kHeight + 15) / 16;
+
+TEST(MotionHintsApiTest, Validation) {
+  aom_codec_iface_t *iface = aom_codec_av1_cx();
+  aom_codec_enc_cfg_t cfg;
+  aom_codec_ctx_t enc;
+  ASSERT_EQ(AOM_CODEC_OK, aom_codec_enc_config_default(iface, &cfg, 0));
+  cfg.g_w = kWidth;
+  cfg.g_h = kHeight;
+  cfg.g_lag_in_frames = 0;
+  ASSERT_EQ(AOM_CODEC_OK, aom_codec_enc_init(&enc, iface, &cfg, 0));
+
+  std::vector<aom_mv_hint_t> mvs(kRows * kCols);
+  aom_motion_hints_t hints = aom_motion_hints_t();
+  hints.rows = kRows;
+  hints.cols = kCols + 1;
+  hints.mvs[0] = &mvs[0];
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&enc, AV1E_SET_MOTION_HINTS, &hints));
+  hints.cols = kCols;
+  EXPECT_EQ(AOM_CODEC_OK,
+            aom_codec_control(&enc, AV1E_SET_MOTION_HINTS, &hints));
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_control(&enc, AV1E_SET_MOTION_HINTS,
+                                            (aom_motion_hints_t *)NULL));
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&enc));
+
+  // With lookahead the hints could not be matched to the frame they were
+  // made for.
+  cfg.g_lag_in_frames = 10;
+  ASSERT_EQ(AOM_CODEC_OK, aom_codec_enc_init(&enc, iface, &cfg, 0));
+  EXPECT_EQ(AOM_CODEC_INCAPABLE,
+            aom_codec_control(&enc, AV1E_SET_MOTION_HINTS, &hints));
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&enc));
+}
+
+enum HintMode { kNoHints, kMvHints, kAllHints };
+
+class MotionHintsTest
+    : public ::libaom_test::CodecTestWith2Params<libaom_test::TestMode, int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  MotionHintsTest()
+      : EncoderTest(GET_PARAM(0)), mvs_(kRows * kCols),
+        block_size_log2_(kRows * kCols), prev_y_(kWidth * kHeight) {}
+  virtual ~MotionHintsTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(GET_PARAM(1));
+    cpu_used_ = GET_PARAM(2);
+    init_flags_ = AOM_CODEC_USE_PSNR;
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = AOM_Q;
+  }
+
+  virtual void BeginPassHook(unsigned int /*pass*/) {
+    psnr_ = 0.0;
+    nframes_ = 0;
+    bytes_ = 0;
+    hint_us_ = 0;
+    md5_ = ::libaom_test::MD5();
+  }
+
+  // Stands in for the motion of an upstream decoder: a full search of +-8
+  // pixels of each 16x16 luma block in the previous source frame, which is
+  // LAST without lookahead. Blocks that match well get 32x32 partition hints
+  // and the others 16x16 ones.
+  void ComputeHints(const aom_image_t *img) {
+    for (unsigned int r = 0; r < kRows; ++r) {
+      for (unsigned int c = 0; c < kCols; ++c) {
+        const int y0 = r * 16;
+        const int x0 = c * 16;
+        unsigned int best_sad = UINT_MAX;
+        int best_row = 0, best_col = 0;
+        for (int dy = -8; dy <= 8; ++dy) {
+          for (int dx = -8; dx <= 8; ++dx) {
+            if (y0 + dy < 0 || y0 + dy + 16 > kHeight || x0 + dx < 0 ||
+                x0 + dx + 16 > kWidth) {
+              continue;
+            }
+            unsigned int sad = 0;
+            for (int y = y0; y < y0 + 16; ++y) {
+              const uint8_t *const src = img->planes[0] + y * img->stride[0];
+              const uint8_t *const ref = &prev_y_[(y + dy) * kWidth + dx];
+              for (int x = x0; x < x0 + 16; ++x) {
+                sad += abs(src[x] - ref[x]);
+              }
+            }
+            if (sad < best_sad) {
+              best_sad = sad;
+              best_row = dy;
+              best_col = dx;
+            }
+          }
+        }
+        aom_mv_hint_t *const mv = &mvs_[r * kCols + c];
+        mv->row = best_row * 8;
+        mv->col = best_col * 8;
+        mv->valid = 1;
+        block_size_log2_[r * kCols + c] = best_sad < 16 * 16 * 2 ? 5 : 4;
+      }
+    }
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, cpu_used_);
+      encoder->Control(AOME_SET_CQ_LEVEL, 40);
+    }
+    const aom_image_t *const img = video->img();
+    if (img == NULL) return;
+    if (hint_mode_ != kNoHints && video->frame() > 0) {
+      aom_usec_timer timer;
+      aom_usec_timer_start(&timer);
+      ComputeHints(img);
+      aom_usec_timer_mark(&timer);
+      hint_us_ += aom_usec_timer_elapsed(&timer);
+      aom_motion_hints_t hints = aom_motion_hints_t();
+      hints.rows = kRows;
+      hints.cols = kCols;
+      hints.mvs[0] = &mvs_[0];
+      if (hint_mode_ == kAllHints) {
+        hints.block_size_log2 = &block_size_log2_[0];
+      }
+      encoder->Control(AV1E_SET_MOTION_HINTS, &hints);
+    }
+    for (int y = 0; y < kHeight; ++y) {
+      memcpy(&prev_y_[y * kWidth], img->planes[0] + y * img->stride[0],
+             kWidth);
+    }
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    bytes_ += pkt->data.frame.sz;
+    md5_.Add(static_cast<const uint8_t *>(pkt->data.frame.buf),
+             pkt->data.frame.sz);
+  }
+
+  virtual void PSNRPktHook(const aom_codec_cx_pkt_t *pkt) {
+    psnr_ += pkt->data.psnr.psnr[0];
+    ++nframes_;
+  }
+
+  // Returns the encode time without the time taken to compute the hints.
+  void RunEncode(HintMode hint_mode, double *psnr, size_t *bytes,
+                 std::string *md5, int64_t *encode_us) {
+    hint_mode_ = hint_mode;
+    ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv",
+                                         kWidth, kHeight, 30, 1, 0, 10);
+    aom_usec_timer timer;
+    aom_usec_timer_start(&timer);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    aom_usec_timer_mark(&timer);
+    ASSERT_GT(nframes_, 0);
+    *psnr = psnr_ / nframes_;
+    *bytes = bytes_;
+    *md5 = md5_.Get();
+    *encode_us = aom_usec_timer_elapsed(&timer) - hint_us_;
+  }
+
+  int cpu_used_;
+  HintMode hint_mode_;
+  double psnr_;
+  int nframes_;
+  size_t bytes_;
+  int64_t hint_us_;
+  ::libaom_test::MD5 md5_;
+  std::vector<aom_mv_hint_t> mvs_;
+  std::vector<uint8_t> block_size_log2_;
+  std::vector<uint8_t> prev_y_;
+};
+
+// The mv hints alone already steer the motion search to other vectors, which
+// changes the bitstream. Hints must not break the bitstream (checked by the
+// driver's decoder) or cost much quality.
+TEST_P(MotionHintsTest, HintsChangeSearchAndStayClose) {
+  double psnr, mv_psnr, hinted_psnr;
+  size_t bytes, mv_bytes, hinted_bytes;
+  std::string md5, mv_md5, hinted_md5;
+  int64_t encode_us, mv_encode_us, hinted_encode_us;
+  ASSERT_NO_FATAL_FAILURE(RunEncode(kNoHints, &psnr, &bytes, &md5,
+                                    &encode_us));
+  ASSERT_NO_FATAL_FAILURE(RunEncode(kMvHints, &mv_psnr, &mv_bytes, &mv_md5,
+                                    &mv_encode_us));
+  ASSERT_NO_FATAL_FAILURE(RunEncode(kAllHints, &hinted_psnr, &hinted_bytes,
+                                    &hinted_md5, &hinted_encode_us));
+  EXPECT_NE(md5, mv_md5);
+  EXPECT_GT(mv_psnr, psnr - 1.0);
+  EXPECT_LT(mv_bytes, bytes * 5 / 4);
+  EXPECT_GT(hinted_psnr, psnr - 1.0);
+  EXPECT_LT(hinted_bytes, bytes * 5 / 4);
+}
+
+// Encode time, size and quality without hints, with mv hints and with mv and
+// partition hints.
+TEST_P(MotionHintsTest, DISABLED_Speed) {
+  static const char *const kNames[] = { "none", "mv", "mv+partition" };
+  for (int mode = kNoHints; mode <= kAllHints; ++mode) {
+    double psnr;
+    size_t bytes;
+    std::string md5;
+    int64_t encode_us;
+    ASSERT_NO_FATAL_FAILURE(RunEncode(static_cast<HintMode>(mode), &psnr,
+                                      &bytes, &md5, &encode_us));
+    printf("hints %-12s: %8.2f ms per frame, %7d bytes, %6.3f dB\n",
+           kNames[mode], encode_us / 1000.0 / nframes_,
+           static_cast<int>(bytes), psnr);
+  }
+}
+
+AV1_INSTANTIATE_TEST_CASE(MotionHintsTest,
+                          ::testing::Values(::libaom_test::kOnePassGood,
+                                            ::libaom_test::kRealTime),
+                          ::testing::Values(6, 8));
+
+}  // namespace
@@ -456,4 +456,22 @@ INSTANTIATE_TEST_CASE_P(
                                  AOM_BITS_8)));
 
 #endif  // HAVE_AVX && ARCH_X86_64
+
+#if HAVE_NEON
+const QuantizeParam kQParamArrayNEON[] = {
+  make_tuple(&av1_quantize_fp_c, &av1_quantize_fp_neon, TX_16X16, TYPE_FP,
+             AOM_BITS_8),
+  make_tuple(&av1_quantize_fp_c, &av1_quantize_fp_neon, TX_4X16, TYPE_FP,
+             AOM_BITS_8),
+  make_tuple(&av1_quantize_fp_c, &av1_quantize_fp_neon, TX_16X4, TYPE_FP,
+             AOM_BITS_8),
+  make_tuple(&av1_quantize_fp_c, &av1_quantize_fp_neon, TX_8X32, TYPE_FP,
+             AOM_BITS_8),
+  make_tuple(&av1_quantize_fp_c, &av1_quantize_fp_neon, TX_32X8, TYPE_FP,
+             AOM_BITS_8)
+};
+
+INSTANTIATE_TEST_CASE_P(NEON, QuantizeTest,
+                        ::testing::ValuesIn(kQParamArrayNEON));
+#endif  // HAVE_NEON
 }  // namespace
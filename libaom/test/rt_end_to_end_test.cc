@@ -9,10 +9,12 @@
  * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
  */
 
+#include <cstdio>
 #include <memory>
 
 #include "third_party/googletest/src/googletest/include/gtest/gtest.h"
 
+#include "aom_ports/aom_timer.h"
 #include "test/codec_factory.h"
 #include "test/encode_test_driver.h"
 #include "test/util.h"
@@ -99,7 +101,7 @@ class RTEndToEndTest
 
   double GetPsnrThreshold() { return kPsnrThreshold[cpu_used_]; }
 
-  void DoTest() {
+  void SetUpConfig() {
     cfg_.rc_target_bitrate = kBitrate;
     cfg_.g_error_resilient = 0;
     cfg_.g_profile = test_video_param_.profile;
@@ -107,7 +109,10 @@ class RTEndToEndTest
     cfg_.g_bit_depth = test_video_param_.bit_depth;
     init_flags_ = AOM_CODEC_USE_PSNR;
     if (cfg_.g_bit_depth > 8) init_flags_ |= AOM_CODEC_USE_HIGHBITDEPTH;
+  }
 
+  void DoTest() {
+    SetUpConfig();
     std::unique_ptr<libaom_test::VideoSource> video;
     video.reset(new libaom_test::Y4mVideoSource(test_video_param_.filename, 0,
                                                 kFrames));
@@ -118,6 +123,29 @@ class RTEndToEndTest
     EXPECT_GT(psnr, GetPsnrThreshold()) << "cpu used = " << cpu_used_;
   }
 
+  // Encodes the clip kSpeedTestRuns times and reports the encoding speed
+  // together with the quality, so that changes to the real-time mode
+  // decision can be compared on both.
+  void DoSpeedTest() {
+    const int kSpeedTestRuns = 5;
+    SetUpConfig();
+    int64_t elapsed_us = 0;
+    double psnr = 0.0;
+    for (int i = 0; i < kSpeedTestRuns; ++i) {
+      libaom_test::Y4mVideoSource video(test_video_param_.filename, 0,
+                                        kFrames);
+      aom_usec_timer timer;
+      aom_usec_timer_start(&timer);
+      ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+      aom_usec_timer_mark(&timer);
+      elapsed_us += aom_usec_timer_elapsed(&timer);
+      psnr += GetAveragePsnr();
+    }
+    const double fps = 1e6 * kFrames * kSpeedTestRuns / elapsed_us;
+    printf("cpu-used %d: %.2f fps, %.3f dB\n", cpu_used_, fps,
+           psnr / kSpeedTestRuns);
+  }
+
   TestVideoParam test_video_param_;
   int cpu_used_;
 
@@ -132,6 +160,8 @@ TEST_P(RTEndToEndTestLarge, EndtoEndPSNRTest) { DoTest(); }
 
 TEST_P(RTEndToEndTest, EndtoEndPSNRTest) { DoTest(); }
 
+TEST_P(RTEndToEndTestLarge, DISABLED_Speed) { DoSpeedTest(); }
+
 AV1_INSTANTIATE_TEST_CASE(RTEndToEndTestLarge,
                           ::testing::ValuesIn(kTestVectors),
                           ::testing::ValuesIn(kCpuUsedVectors));
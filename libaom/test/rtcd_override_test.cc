@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <string.h>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "aom/aom_codec.h"
+#include "aom_ports/aom_rtcd.h"
+
+namespace {
+
+typedef int (*TestFunc)(void);
+
+int func_a_c() { return 0; }
+int func_a_sse2() { return 1; }
+int func_a_avx2() { return 2; }
+int func_b_c() { return 3; }
+int func_b_avx2() { return 4; }
+int func_c_c() { return 5; }
+int func_c_sse2() { return 6; }
+int func_s_c() { return 7; }
+int func_s_sse2() { return 8; }
+
+TestFunc test_rtcd_a;
+TestFunc test_rtcd_b;
+TestFunc test_rtcd_c;
+
+// A table laid out like the ones generated by rtcd.pl, for a CPU with SSE2
+// but no AVX2. test_rtcd_c requires SSE2, and test_rtcd_s is bound at build
+// time to its SSE2 version.
+const char *const kTierNames[] = { "c", "sse2", "avx2" };
+const int kTierFlags[] = { 0, 1, 2 };
+const int kCpuFlags = 1;
+
+const aom_rtcd_impl_t kImpls[] = {
+  { (aom_rtcd_fn_t)func_a_c, 0 }, { (aom_rtcd_fn_t)func_a_sse2, 1 },
+  { (aom_rtcd_fn_t)func_a_avx2, 2 }, { (aom_rtcd_fn_t)func_b_c, 0 },
+  { (aom_rtcd_fn_t)func_b_avx2, 2 }, { (aom_rtcd_fn_t)func_c_c, 0 },
+  { (aom_rtcd_fn_t)func_c_sse2, 1 }, { (aom_rtcd_fn_t)func_s_c, 0 },
+  { (aom_rtcd_fn_t)func_s_sse2, 1 },
+};
+
+const aom_rtcd_func_t kFuncs[] = {
+  { "test_rtcd_a", (aom_rtcd_fn_t *)&test_rtcd_a, 0, 3, 0, "int(void)" },
+  { "test_rtcd_b", (aom_rtcd_fn_t *)&test_rtcd_b, 3, 2, 0, "int(void)" },
+  { "test_rtcd_c", (aom_rtcd_fn_t *)&test_rtcd_c, 5, 2, 1, "int(void)" },
+  { "test_rtcd_s", NULL, 7, 2, 1, "int(void)" },
+};
+
+aom_rtcd_fn_t defaults[4];
+
+aom_rtcd_table_t table = {
+  kFuncs, 4, kImpls, kTierNames, kTierFlags, 3, defaults, 0, NULL
+};
+
+class RtcdOverrideTest : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() {
+    test_rtcd_a = func_a_sse2;
+    test_rtcd_b = func_b_c;
+    test_rtcd_c = func_c_sse2;
+    aom_rtcd_register(&table, kCpuFlags);
+  }
+
+  virtual void SetUp() {
+    ASSERT_EQ(aom_codec_set_rtcd_override(NULL), AOM_CODEC_OK);
+  }
+  virtual void TearDown() { aom_codec_set_rtcd_override(NULL); }
+
+  void ExpectOverride(const char *spec, TestFunc a, TestFunc b) {
+    ASSERT_EQ(aom_codec_set_rtcd_override(spec), AOM_CODEC_OK) << spec;
+    EXPECT_EQ(test_rtcd_a, a) << spec;
+    EXPECT_EQ(test_rtcd_b, b) << spec;
+  }
+
+  const char *GetTier(const char *name) {
+    const char *func_name, *tier;
+    for (int i = 0; aom_codec_get_rtcd_binding(i, &func_name, &tier); ++i) {
+      if (!strcmp(func_name, name)) return tier;
+    }
+    return NULL;
+  }
+};
+
+TEST_F(RtcdOverrideTest, Defaults) {
+  EXPECT_EQ(test_rtcd_a, &func_a_sse2);
+  EXPECT_EQ(test_rtcd_b, &func_b_c);
+  ExpectOverride("", func_a_sse2, func_b_c);
+  ExpectOverride("other_func=c", func_a_sse2, func_b_c);
+}
+
+TEST_F(RtcdOverrideTest, Override) {
+  ExpectOverride("test_rtcd_a=c", func_a_c, func_b_c);
+  ExpectOverride("test_rtcd_a=sse2", func_a_sse2, func_b_c);
+  // Missing tiers fall back to the best version below.
+  ExpectOverride("test_rtcd_b=sse2", func_a_sse2, func_b_c);
+  // Tiers the CPU does not support are never selected.
+  ExpectOverride("test_rtcd_a=avx2,test_rtcd_b=avx2", func_a_sse2, func_b_c);
+  // Tiers of other architectures are ignored.
+  ExpectOverride("test_rtcd_a=neon", func_a_sse2, func_b_c);
+  // Functions without a low enough version keep the lowest one, and never go
+  // below a required tier.
+  ExpectOverride("test_rtcd_c=c", func_a_sse2, func_b_c);
+  EXPECT_EQ(test_rtcd_c, &func_c_sse2);
+}
+
+TEST_F(RtcdOverrideTest, Prefix) {
+  ExpectOverride("test_rtcd_*=c", func_a_c, func_b_c);
+  ExpectOverride("test_*=c,test_rtcd_a=sse2", func_a_sse2, func_b_c);
+  ExpectOverride("test_rtcd_a=sse2,test_*=c", func_a_c, func_b_c);
+  ExpectOverride("*=c", func_a_c, func_b_c);
+}
+
+TEST_F(RtcdOverrideTest, Invalid) {
+  ExpectOverride("test_rtcd_a=c", func_a_c, func_b_c);
+  const char *const kInvalid[] = { "test_rtcd_a", "test_rtcd_a=",
+                                   "=c", "test_rtcd_a=avx512",
+                                   "test_rtcd_a=c,test_rtcd_b" };
+  for (const char *spec : kInvalid) {
+    EXPECT_EQ(aom_codec_set_rtcd_override(spec), AOM_CODEC_INVALID_PARAM)
+        << spec;
+    EXPECT_EQ(test_rtcd_a, &func_a_c) << spec;
+  }
+}
+
+TEST_F(RtcdOverrideTest, Bindings) {
+  ASSERT_STREQ(GetTier("test_rtcd_a"), "sse2");
+  ASSERT_STREQ(GetTier("test_rtcd_b"), "c");
+  ASSERT_STREQ(GetTier("test_rtcd_s"), "sse2");
+  ExpectOverride("test_rtcd_*=c", func_a_c, func_b_c);
+  ASSERT_STREQ(GetTier("test_rtcd_a"), "c");
+  ASSERT_STREQ(GetTier("test_rtcd_s"), "sse2");
+}
+
+}  // namespace
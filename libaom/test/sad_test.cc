@@ -1075,13 +1075,164 @@ const SadMxNParam neon_tests[] = {
   make_tuple(8, 16, &aom_sad8x16_neon, -1),
   make_tuple(8, 8, &aom_sad8x8_neon, -1),
   make_tuple(4, 4, &aom_sad4x4_neon, -1),
+  make_tuple(128, 128, &aom_highbd_sad128x128_neon, 8),
+  make_tuple(128, 64, &aom_highbd_sad128x64_neon, 8),
+  make_tuple(64, 128, &aom_highbd_sad64x128_neon, 8),
+  make_tuple(64, 64, &aom_highbd_sad64x64_neon, 8),
+  make_tuple(64, 32, &aom_highbd_sad64x32_neon, 8),
+  make_tuple(32, 64, &aom_highbd_sad32x64_neon, 8),
+  make_tuple(32, 32, &aom_highbd_sad32x32_neon, 8),
+  make_tuple(32, 16, &aom_highbd_sad32x16_neon, 8),
+  make_tuple(16, 32, &aom_highbd_sad16x32_neon, 8),
+  make_tuple(16, 16, &aom_highbd_sad16x16_neon, 8),
+  make_tuple(16, 8, &aom_highbd_sad16x8_neon, 8),
+  make_tuple(8, 16, &aom_highbd_sad8x16_neon, 8),
+  make_tuple(8, 8, &aom_highbd_sad8x8_neon, 8),
+  make_tuple(8, 4, &aom_highbd_sad8x4_neon, 8),
+  make_tuple(4, 8, &aom_highbd_sad4x8_neon, 8),
+  make_tuple(4, 4, &aom_highbd_sad4x4_neon, 8),
+  make_tuple(64, 16, &aom_highbd_sad64x16_neon, 8),
+  make_tuple(16, 64, &aom_highbd_sad16x64_neon, 8),
+  make_tuple(32, 8, &aom_highbd_sad32x8_neon, 8),
+  make_tuple(8, 32, &aom_highbd_sad8x32_neon, 8),
+  make_tuple(16, 4, &aom_highbd_sad16x4_neon, 8),
+  make_tuple(4, 16, &aom_highbd_sad4x16_neon, 8),
+  make_tuple(128, 128, &aom_highbd_sad128x128_neon, 10),
+  make_tuple(128, 64, &aom_highbd_sad128x64_neon, 10),
+  make_tuple(64, 128, &aom_highbd_sad64x128_neon, 10),
+  make_tuple(64, 64, &aom_highbd_sad64x64_neon, 10),
+  make_tuple(64, 32, &aom_highbd_sad64x32_neon, 10),
+  make_tuple(32, 64, &aom_highbd_sad32x64_neon, 10),
+  make_tuple(32, 32, &aom_highbd_sad32x32_neon, 10),
+  make_tuple(32, 16, &aom_highbd_sad32x16_neon, 10),
+  make_tuple(16, 32, &aom_highbd_sad16x32_neon, 10),
+  make_tuple(16, 16, &aom_highbd_sad16x16_neon, 10),
+  make_tuple(16, 8, &aom_highbd_sad16x8_neon, 10),
+  make_tuple(8, 16, &aom_highbd_sad8x16_neon, 10),
+  make_tuple(8, 8, &aom_highbd_sad8x8_neon, 10),
+  make_tuple(8, 4, &aom_highbd_sad8x4_neon, 10),
+  make_tuple(4, 8, &aom_highbd_sad4x8_neon, 10),
+  make_tuple(4, 4, &aom_highbd_sad4x4_neon, 10),
+  make_tuple(64, 16, &aom_highbd_sad64x16_neon, 10),
+  make_tuple(16, 64, &aom_highbd_sad16x64_neon, 10),
+  make_tuple(32, 8, &aom_highbd_sad32x8_neon, 10),
+  make_tuple(8, 32, &aom_highbd_sad8x32_neon, 10),
+  make_tuple(16, 4, &aom_highbd_sad16x4_neon, 10),
+  make_tuple(4, 16, &aom_highbd_sad4x16_neon, 10),
+  make_tuple(128, 128, &aom_highbd_sad128x128_neon, 12),
+  make_tuple(128, 64, &aom_highbd_sad128x64_neon, 12),
+  make_tuple(64, 128, &aom_highbd_sad64x128_neon, 12),
+  make_tuple(64, 64, &aom_highbd_sad64x64_neon, 12),
+  make_tuple(64, 32, &aom_highbd_sad64x32_neon, 12),
+  make_tuple(32, 64, &aom_highbd_sad32x64_neon, 12),
+  make_tuple(32, 32, &aom_highbd_sad32x32_neon, 12),
+  make_tuple(32, 16, &aom_highbd_sad32x16_neon, 12),
+  make_tuple(16, 32, &aom_highbd_sad16x32_neon, 12),
+  make_tuple(16, 16, &aom_highbd_sad16x16_neon, 12),
+  make_tuple(16, 8, &aom_highbd_sad16x8_neon, 12),
+  make_tuple(8, 16, &aom_highbd_sad8x16_neon, 12),
+  make_tuple(8, 8, &aom_highbd_sad8x8_neon, 12),
+  make_tuple(8, 4, &aom_highbd_sad8x4_neon, 12),
+  make_tuple(4, 8, &aom_highbd_sad4x8_neon, 12),
+  make_tuple(4, 4, &aom_highbd_sad4x4_neon, 12),
+  make_tuple(64, 16, &aom_highbd_sad64x16_neon, 12),
+  make_tuple(16, 64, &aom_highbd_sad16x64_neon, 12),
+  make_tuple(32, 8, &aom_highbd_sad32x8_neon, 12),
+  make_tuple(8, 32, &aom_highbd_sad8x32_neon, 12),
+  make_tuple(16, 4, &aom_highbd_sad16x4_neon, 12),
+  make_tuple(4, 16, &aom_highbd_sad4x16_neon, 12),
 };
 INSTANTIATE_TEST_CASE_P(NEON, SADTest, ::testing::ValuesIn(neon_tests));
 
 const SadMxNx4Param x4d_neon_tests[] = {
+  make_tuple(128, 128, &aom_sad128x128x4d_neon, -1),
+  make_tuple(128, 64, &aom_sad128x64x4d_neon, -1),
+  make_tuple(64, 128, &aom_sad64x128x4d_neon, -1),
   make_tuple(64, 64, &aom_sad64x64x4d_neon, -1),
+  make_tuple(64, 32, &aom_sad64x32x4d_neon, -1),
+  make_tuple(32, 64, &aom_sad32x64x4d_neon, -1),
   make_tuple(32, 32, &aom_sad32x32x4d_neon, -1),
+  make_tuple(32, 16, &aom_sad32x16x4d_neon, -1),
+  make_tuple(16, 32, &aom_sad16x32x4d_neon, -1),
   make_tuple(16, 16, &aom_sad16x16x4d_neon, -1),
+  make_tuple(16, 8, &aom_sad16x8x4d_neon, -1),
+  make_tuple(8, 16, &aom_sad8x16x4d_neon, -1),
+  make_tuple(8, 8, &aom_sad8x8x4d_neon, -1),
+  make_tuple(8, 4, &aom_sad8x4x4d_neon, -1),
+  make_tuple(4, 8, &aom_sad4x8x4d_neon, -1),
+  make_tuple(4, 4, &aom_sad4x4x4d_neon, -1),
+  make_tuple(64, 16, &aom_sad64x16x4d_neon, -1),
+  make_tuple(16, 64, &aom_sad16x64x4d_neon, -1),
+  make_tuple(32, 8, &aom_sad32x8x4d_neon, -1),
+  make_tuple(8, 32, &aom_sad8x32x4d_neon, -1),
+  make_tuple(16, 4, &aom_sad16x4x4d_neon, -1),
+  make_tuple(4, 16, &aom_sad4x16x4d_neon, -1),
+  make_tuple(128, 128, &aom_highbd_sad128x128x4d_neon, 8),
+  make_tuple(128, 64, &aom_highbd_sad128x64x4d_neon, 8),
+  make_tuple(64, 128, &aom_highbd_sad64x128x4d_neon, 8),
+  make_tuple(64, 64, &aom_highbd_sad64x64x4d_neon, 8),
+  make_tuple(64, 32, &aom_highbd_sad64x32x4d_neon, 8),
+  make_tuple(32, 64, &aom_highbd_sad32x64x4d_neon, 8),
+  make_tuple(32, 32, &aom_highbd_sad32x32x4d_neon, 8),
+  make_tuple(32, 16, &aom_highbd_sad32x16x4d_neon, 8),
+  make_tuple(16, 32, &aom_highbd_sad16x32x4d_neon, 8),
+  make_tuple(16, 16, &aom_highbd_sad16x16x4d_neon, 8),
+  make_tuple(16, 8, &aom_highbd_sad16x8x4d_neon, 8),
+  make_tuple(8, 16, &aom_highbd_sad8x16x4d_neon, 8),
+  make_tuple(8, 8, &aom_highbd_sad8x8x4d_neon, 8),
+  make_tuple(8, 4, &aom_highbd_sad8x4x4d_neon, 8),
+  make_tuple(4, 8, &aom_highbd_sad4x8x4d_neon, 8),
+  make_tuple(4, 4, &aom_highbd_sad4x4x4d_neon, 8),
+  make_tuple(64, 16, &aom_highbd_sad64x16x4d_neon, 8),
+  make_tuple(16, 64, &aom_highbd_sad16x64x4d_neon, 8),
+  make_tuple(32, 8, &aom_highbd_sad32x8x4d_neon, 8),
+  make_tuple(8, 32, &aom_highbd_sad8x32x4d_neon, 8),
+  make_tuple(16, 4, &aom_highbd_sad16x4x4d_neon, 8),
+  make_tuple(4, 16, &aom_highbd_sad4x16x4d_neon, 8),
+  make_tuple(128, 128, &aom_highbd_sad128x128x4d_neon, 10),
+  make_tuple(128, 64, &aom_highbd_sad128x64x4d_neon, 10),
+  make_tuple(64, 128, &aom_highbd_sad64x128x4d_neon, 10),
+  make_tuple(64, 64, &aom_highbd_sad64x64x4d_neon, 10),
+  make_tuple(64, 32, &aom_highbd_sad64x32x4d_neon, 10),
+  make_tuple(32, 64, &aom_highbd_sad32x64x4d_neon, 10),
+  make_tuple(32, 32, &aom_highbd_sad32x32x4d_neon, 10),
+  make_tuple(32, 16, &aom_highbd_sad32x16x4d_neon, 10),
+  make_tuple(16, 32, &aom_highbd_sad16x32x4d_neon, 10),
+  make_tuple(16, 16, &aom_highbd_sad16x16x4d_neon, 10),
+  make_tuple(16, 8, &aom_highbd_sad16x8x4d_neon, 10),
+  make_tuple(8, 16, &aom_highbd_sad8x16x4d_neon, 10),
+  make_tuple(8, 8, &aom_highbd_sad8x8x4d_neon, 10),
+  make_tuple(8, 4, &aom_highbd_sad8x4x4d_neon, 10),
+  make_tuple(4, 8, &aom_highbd_sad4x8x4d_neon, 10),
+  make_tuple(4, 4, &aom_highbd_sad4x4x4d_neon, 10),
+  make_tuple(64, 16, &aom_highbd_sad64x16x4d_neon, 10),
+  make_tuple(16, 64, &aom_highbd_sad16x64x4d_neon, 10),
+  make_tuple(32, 8, &aom_highbd_sad32x8x4d_neon, 10),
+  make_tuple(8, 32, &aom_highbd_sad8x32x4d_neon, 10),
+  make_tuple(16, 4, &aom_highbd_sad16x4x4d_neon, 10),
+  make_tuple(4, 16, &aom_highbd_sad4x16x4d_neon, 10),
+  make_tuple(128, 128, &aom_highbd_sad128x128x4d_neon, 12),
+  make_tuple(128, 64, &aom_highbd_sad128x64x4d_neon, 12),
+  make_tuple(64, 128, &aom_highbd_sad64x128x4d_neon, 12),
+  make_tuple(64, 64, &aom_highbd_sad64x64x4d_neon, 12),
+  make_tuple(64, 32, &aom_highbd_sad64x32x4d_neon, 12),
+  make_tuple(32, 64, &aom_highbd_sad32x64x4d_neon, 12),
+  make_tuple(32, 32, &aom_highbd_sad32x32x4d_neon, 12),
+  make_tuple(32, 16, &aom_highbd_sad32x16x4d_neon, 12),
+  make_tuple(16, 32, &aom_highbd_sad16x32x4d_neon, 12),
+  make_tuple(16, 16, &aom_highbd_sad16x16x4d_neon, 12),
+  make_tuple(16, 8, &aom_highbd_sad16x8x4d_neon, 12),
+  make_tuple(8, 16, &aom_highbd_sad8x16x4d_neon, 12),
+  make_tuple(8, 8, &aom_highbd_sad8x8x4d_neon, 12),
+  make_tuple(8, 4, &aom_highbd_sad8x4x4d_neon, 12),
+  make_tuple(4, 8, &aom_highbd_sad4x8x4d_neon, 12),
+  make_tuple(4, 4, &aom_highbd_sad4x4x4d_neon, 12),
+  make_tuple(64, 16, &aom_highbd_sad64x16x4d_neon, 12),
+  make_tuple(16, 64, &aom_highbd_sad16x64x4d_neon, 12),
+  make_tuple(32, 8, &aom_highbd_sad32x8x4d_neon, 12),
+  make_tuple(8, 32, &aom_highbd_sad8x32x4d_neon, 12),
+  make_tuple(16, 4, &aom_highbd_sad16x4x4d_neon, 12),
+  make_tuple(4, 16, &aom_highbd_sad4x16x4d_neon, 12),
 };
 INSTANTIATE_TEST_CASE_P(NEON, SADx4Test, ::testing::ValuesIn(x4d_neon_tests));
 #endif  // HAVE_NEON
@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "config/aom_config.h"
+#include "aom/aom_codec.h"
+#include "aom/aomcx.h"
+#include "aom/aomdx.h"
+#include "aom_util/aom_thread.h"
+#include "test/codec_factory.h"
+#include "test/decode_test_driver.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+
+namespace {
+
+#if CONFIG_MULTITHREAD
+
+const int kNumFrames = 8;
+const int kNumDecoders = 4;
+
+// Runs on the pool and keeps track of how many jobs run at once.
+struct Job {
+  std::atomic<int> *running;
+  std::atomic<int> *max_running;
+  std::atomic<bool> *release;
+};
+
+int JobHook(void *arg1, void *) {
+  Job *const job = static_cast<Job *>(arg1);
+  const int running = ++*job->running;
+  int max_running = job->max_running->load();
+  while (running > max_running &&
+         !job->max_running->compare_exchange_weak(max_running, running)) {
+  }
+  while (!job->release->load()) std::this_thread::yield();
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  --*job->running;
+  return 1;
+}
+
+class WorkerPoolTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() { ASSERT_TRUE(aom_worker_pool_set_threads(4)); }
+  virtual void TearDown() { ASSERT_TRUE(aom_worker_pool_set_threads(0)); }
+
+  void InitWorkers(AVxWorker *workers, int num_workers, AVxWorkerGroup *group,
+                   Job *job) {
+    const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+    for (int i = 0; i < num_workers; ++i) {
+      winterface->init(&workers[i]);
+      workers[i].group = group;
+      ASSERT_TRUE(winterface->reset(&workers[i]));
+      workers[i].hook = JobHook;
+      workers[i].data1 = job;
+    }
+  }
+
+  void EndWorkers(AVxWorker *workers, int num_workers) {
+    for (int i = 0; i < num_workers; ++i) {
+      aom_get_worker_interface()->end(&workers[i]);
+    }
+  }
+};
+
+TEST_F(WorkerPoolTest, LimitsActiveJobsOfGroup) {
+  const int kNumWorkers = 8;
+  AVxWorkerGroup *const group = aom_worker_group_create(2);
+  ASSERT_NE(group, nullptr);
+  std::atomic<int> running(0), max_running(0);
+  std::atomic<bool> release(true);
+  Job job = { &running, &max_running, &release };
+  AVxWorker workers[kNumWorkers];
+  ASSERT_NO_FATAL_FAILURE(InitWorkers(workers, kNumWorkers, group, &job));
+
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  for (int i = 0; i < kNumWorkers; ++i) winterface->launch(&workers[i]);
+  // Give the pool time to run the jobs before sync() takes the queued ones.
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_LE(max_running.load(), 2);
+  for (int i = 0; i < kNumWorkers; ++i) {
+    EXPECT_TRUE(winterface->sync(&workers[i]));
+  }
+  EXPECT_EQ(0, running.load());
+  EndWorkers(workers, kNumWorkers);
+  aom_worker_group_destroy(group);
+}
+
+// A group makes progress when the jobs of another group keep all the threads
+// of the pool busy.
+TEST_F(WorkerPoolTest, SyncRunsQueuedJob) {
+  AVxWorkerGroup *const busy_group = aom_worker_group_create(4);
+  AVxWorkerGroup *const group = aom_worker_group_create(4);
+  ASSERT_NE(busy_group, nullptr);
+  ASSERT_NE(group, nullptr);
+  std::atomic<int> running(0), max_running(0);
+  std::atomic<bool> release(false), released(true);
+  Job busy_job = { &running, &max_running, &release };
+  Job job = { &running, &max_running, &released };
+  AVxWorker busy_workers[4], worker;
+  ASSERT_NO_FATAL_FAILURE(InitWorkers(busy_workers, 4, busy_group, &busy_job));
+  ASSERT_NO_FATAL_FAILURE(InitWorkers(&worker, 1, group, &job));
+
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  for (int i = 0; i < 4; ++i) winterface->launch(&busy_workers[i]);
+  while (running.load() < 4) std::this_thread::yield();
+  winterface->launch(&worker);
+  EXPECT_TRUE(winterface->sync(&worker));
+  EXPECT_EQ(4, running.load());
+
+  release = true;
+  for (int i = 0; i < 4; ++i) EXPECT_TRUE(winterface->sync(&busy_workers[i]));
+  EndWorkers(busy_workers, 4);
+  EndWorkers(&worker, 1);
+  aom_worker_group_destroy(busy_group);
+  aom_worker_group_destroy(group);
+}
+
+TEST_F(WorkerPoolTest, SetThreadsFailsWithGroups) {
+  AVxWorkerGroup *const group = aom_worker_group_create(1);
+  ASSERT_NE(group, nullptr);
+  EXPECT_FALSE(aom_worker_pool_set_threads(2));
+  EXPECT_EQ(AOM_CODEC_ERROR, aom_codec_set_shared_thread_pool(2));
+  aom_worker_group_destroy(group);
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM, aom_codec_set_shared_thread_pool(-1));
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM, aom_codec_set_shared_thread_pool(65));
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_set_shared_thread_pool(2));
+}
+
+TEST(WorkerGroupTest, NullWhenPoolDisabled) {
+  EXPECT_EQ(nullptr, aom_worker_group_create(4));
+}
+
+class SharedThreadPoolTest : public ::libaom_test::CodecTestWithParam<int>,
+                             public ::libaom_test::EncoderTest {
+ protected:
+  SharedThreadPoolTest() : EncoderTest(GET_PARAM(0)), row_mt_(GET_PARAM(1)) {}
+  virtual ~SharedThreadPoolTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.g_threads = 4;
+    cfg_.rc_end_usage = AOM_CBR;
+    cfg_.rc_target_bitrate = 500;
+  }
+
+  virtual void TearDown() {
+    EXPECT_EQ(AOM_CODEC_OK, aom_codec_set_shared_thread_pool(0));
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 6);
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 2);
+      encoder->Control(AV1E_SET_ROW_MT, row_mt_);
+    }
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    const uint8_t *const buf =
+        static_cast<const uint8_t *>(pkt->data.frame.buf);
+    frames_.push_back(std::vector<uint8_t>(buf, buf + pkt->data.frame.sz));
+  }
+
+  void Encode() {
+    frames_.clear();
+    ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352,
+                                         288, 30, 1, 0, kNumFrames);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    ASSERT_EQ(static_cast<size_t>(kNumFrames), frames_.size());
+  }
+
+  ::libaom_test::AV1Decoder *NewDecoder() {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = 4;
+    ::libaom_test::AV1Decoder *const decoder =
+        new ::libaom_test::AV1Decoder(cfg, 0);
+    decoder->Control(AV1D_SET_ROW_MT, row_mt_);
+    return decoder;
+  }
+
+  // Decodes frame 'i' and appends the MD5 of the output to 'md5s'.
+  void DecodeFrame(::libaom_test::AV1Decoder *decoder, size_t i,
+                   std::vector<std::string> *md5s) {
+    ASSERT_EQ(AOM_CODEC_OK,
+              decoder->DecodeFrame(&frames_[i][0], frames_[i].size()))
+        << decoder->DecodeError();
+    ::libaom_test::DxDataIterator dec_iter = decoder->GetDxData();
+    const aom_image_t *img;
+    while ((img = dec_iter.Next()) != NULL) {
+      ::libaom_test::MD5 md5;
+      md5.Add(img);
+      md5s->push_back(md5.Get());
+    }
+  }
+
+  void Decode(std::vector<std::string> *md5s) {
+    std::unique_ptr< ::libaom_test::AV1Decoder> decoder(NewDecoder());
+    for (size_t i = 0; i < frames_.size(); ++i) {
+      ASSERT_NO_FATAL_FAILURE(DecodeFrame(decoder.get(), i, md5s));
+    }
+  }
+
+  int row_mt_;
+  std::vector<std::vector<uint8_t> > frames_;
+};
+
+// Decoders on the pool, used in turn from one thread and at the same time
+// from several threads, give the output of decoders with threads of their
+// own.
+TEST_P(SharedThreadPoolTest, Decode) {
+  ASSERT_NO_FATAL_FAILURE(Encode());
+  std::vector<std::string> expected_md5s;
+  ASSERT_NO_FATAL_FAILURE(Decode(&expected_md5s));
+  ASSERT_EQ(frames_.size(), expected_md5s.size());
+
+  ASSERT_EQ(AOM_CODEC_OK, aom_codec_set_shared_thread_pool(2));
+  {
+    std::unique_ptr< ::libaom_test::AV1Decoder> decoders[kNumDecoders];
+    std::vector<std::string> md5s[kNumDecoders];
+    for (int d = 0; d < kNumDecoders; ++d) decoders[d].reset(NewDecoder());
+    for (size_t i = 0; i < frames_.size(); ++i) {
+      for (int d = 0; d < kNumDecoders; ++d) {
+        ASSERT_NO_FATAL_FAILURE(DecodeFrame(decoders[d].get(), i, &md5s[d]));
+      }
+    }
+    EXPECT_EQ(AOM_CODEC_ERROR, aom_codec_set_shared_thread_pool(3));
+    for (int d = 0; d < kNumDecoders; ++d) {
+      EXPECT_EQ(expected_md5s, md5s[d]) << "decoder " << d;
+    }
+  }
+
+  std::vector<std::string> md5s[kNumDecoders];
+  std::vector<std::thread> threads;
+  for (int d = 0; d < kNumDecoders; ++d) {
+    threads.push_back(std::thread([this, &md5s, d]() { Decode(&md5s[d]); }));
+  }
+  for (auto &thread : threads) thread.join();
+  for (int d = 0; d < kNumDecoders; ++d) {
+    EXPECT_EQ(expected_md5s, md5s[d]) << "decoder " << d;
+  }
+}
+
+// The pool does not change the output of the encoder.
+TEST_P(SharedThreadPoolTest, Encode) {
+  ASSERT_NO_FATAL_FAILURE(Encode());
+  const std::vector<std::vector<uint8_t> > expected_frames = frames_;
+  ASSERT_EQ(AOM_CODEC_OK, aom_codec_set_shared_thread_pool(2));
+  ASSERT_NO_FATAL_FAILURE(Encode());
+  EXPECT_EQ(expected_frames, frames_);
+}
+
+AV1_INSTANTIATE_TEST_CASE(SharedThreadPoolTest, ::testing::Values(0, 1));
+
+#endif  // CONFIG_MULTITHREAD
+
+}  // namespace
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <stdio.h>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "aom/aomcx.h"
+#include "aom_ports/aom_timer.h"
+#include "aom_scale/yv12config.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/util.h"
+
+namespace {
+
+const int kWidth = 352;
+const int kHeight = 288;
+
+class SmallBorderTest : public ::libaom_test::CodecTestWithParam<int>,
+                        public ::libaom_test::EncoderTest {
+ protected:
+  SmallBorderTest()
+      : EncoderTest(GET_PARAM(0)), cpu_used_(GET_PARAM(1)), small_border_(1),
+        mv_test_mode_(0), scale_references_(false), decode_(true) {}
+  virtual ~SmallBorderTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 5;
+    cfg_.rc_end_usage = AOM_VBR;
+    cfg_.rc_target_bitrate = 500;
+    init_flags_ = AOM_CODEC_USE_PSNR;
+  }
+
+  virtual void BeginPassHook(unsigned int) {
+    frames_ = 0;
+    bits_ = 0;
+    psnr_ = 0.0;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, cpu_used_);
+      encoder->Control(AV1E_SET_ENABLE_SMALL_BORDER, small_border_);
+      encoder->Control(AV1E_ENABLE_MOTION_VECTOR_UNIT_TEST, mv_test_mode_);
+    }
+    if (scale_references_) {
+      // Step the frame size down and back up, so that the references of
+      // the frames after each step are scaled.
+      struct aom_scaling_mode mode = { AOME_NORMAL, AOME_NORMAL };
+      if (video->frame() >= 6) {
+        mode.h_scaling_mode = AOME_ONETWO;
+        mode.v_scaling_mode = AOME_ONETWO;
+      } else if (video->frame() >= 3) {
+        mode.h_scaling_mode = AOME_FOURFIVE;
+        mode.v_scaling_mode = AOME_THREEFIVE;
+      }
+      if (video->frame() >= 9) mode.h_scaling_mode = AOME_NORMAL;
+      encoder->Control(AOME_SET_SCALEMODE, &mode);
+    }
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    ++frames_;
+    bits_ += pkt->data.frame.sz * 8;
+  }
+
+  virtual void PSNRPktHook(const aom_codec_cx_pkt_t *pkt) {
+    psnr_ += pkt->data.psnr.psnr[0];
+  }
+
+  virtual bool DoDecode() const { return decode_; }
+
+  void Encode(int num_frames) {
+    ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", kWidth,
+                                         kHeight, 30, 1, 0, num_frames);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  }
+
+  int cpu_used_;
+  int small_border_;
+  int mv_test_mode_;
+  bool scale_references_;
+  bool decode_;
+  int frames_;
+  size_t bits_;
+  double psnr_;
+};
+
+// The encoder reconstruction matches the decoder, which checks the emulated
+// edges of the predictions at the frame edge.
+TEST_P(SmallBorderTest, MatchesDecoder) {
+  ASSERT_NO_FATAL_FAILURE(Encode(10));
+  EXPECT_EQ(10, frames_);
+}
+
+// Motion vectors that point as far outside the frame as allowed.
+TEST_P(SmallBorderTest, ExtremeMotionVectors) {
+  for (mv_test_mode_ = 1; mv_test_mode_ <= 2; ++mv_test_mode_) {
+    ASSERT_NO_FATAL_FAILURE(Encode(5));
+    EXPECT_EQ(5, frames_);
+  }
+}
+
+// Frame size changes within the stream, whose references are then scaled.
+// Their predictions at the frame edge use the emulated edges as well.
+TEST_P(SmallBorderTest, ScaledReferences) {
+  scale_references_ = true;
+  for (mv_test_mode_ = 0; mv_test_mode_ <= 2; ++mv_test_mode_) {
+    ASSERT_NO_FATAL_FAILURE(Encode(12));
+    EXPECT_EQ(12, frames_);
+  }
+}
+
+TEST_P(SmallBorderTest, DISABLED_Speed) {
+  const int kNumFrames = 30;
+  static const int kBorders[] = { AOM_ENC_NO_SCALE_BORDER,
+                                  AOM_ENC_SMALL_BORDER };
+  decode_ = false;
+  for (small_border_ = 0; small_border_ < 2; ++small_border_) {
+    YV12_BUFFER_CONFIG buf;
+    memset(&buf, 0, sizeof(buf));
+    ASSERT_EQ(0, aom_alloc_frame_buffer(&buf, kWidth, kHeight, 1, 1, 0,
+                                        kBorders[small_border_], 0));
+    const size_t frame_size = buf.frame_size;
+    aom_free_frame_buffer(&buf);
+
+    aom_usec_timer timer;
+    aom_usec_timer_start(&timer);
+    ASSERT_NO_FATAL_FAILURE(Encode(kNumFrames));
+    aom_usec_timer_mark(&timer);
+    const double elapsed = static_cast<double>(aom_usec_timer_elapsed(&timer));
+    printf("border %3d: %7d bytes per frame buffer, %8.2f ms per frame, "
+           "%7.2f kbps, %6.3f dB\n",
+           kBorders[small_border_], static_cast<int>(frame_size),
+           elapsed / 1000 / frames_, bits_ * 30.0 / 1000 / frames_,
+           psnr_ / frames_);
+  }
+}
+
+AV1_INSTANTIATE_TEST_CASE(SmallBorderTest, ::testing::Values(1, 4));
+}  // namespace
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "aom/aomcx.h"
+#include "aom/aomdx.h"
+#include "test/codec_factory.h"
+#include "test/decode_test_driver.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/util.h"
+
+namespace {
+
+const int kNumFrames = 6;
+// Allowed excess of a CPU time over the wall clock time it was measured
+// against, for the different resolutions of the two clocks.
+const uint64_t kClockSlackUs = 1000;
+
+class StageTimingTest
+    : public ::libaom_test::CodecTestWith2Params<int, unsigned int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  StageTimingTest()
+      : EncoderTest(GET_PARAM(0)), cpu_used_(GET_PARAM(1)),
+        num_threads_(GET_PARAM(2)) {}
+  virtual ~StageTimingTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = AOM_VBR;
+    cfg_.rc_target_bitrate = 300;
+  }
+
+  // The stage times of the previous frame are read before the next one is
+  // encoded.
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, cpu_used_);
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 1);
+      encoder->Control(AV1E_SET_STAGE_TIMING, stage_timing_);
+    } else {
+      aom_enc_stage_timing_t timing;
+      encoder->Control(AV1E_GET_STAGE_TIMING, &timing);
+      enc_timing_.push_back(timing);
+    }
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    const uint8_t *const buf =
+        static_cast<const uint8_t *>(pkt->data.frame.buf);
+    frames_.push_back(std::vector<uint8_t>(buf, buf + pkt->data.frame.sz));
+  }
+
+  void Encode(int stage_timing) {
+    stage_timing_ = stage_timing;
+    ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352,
+                                         288, 30, 1, 0, kNumFrames);
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    ASSERT_EQ(static_cast<size_t>(kNumFrames), frames_.size());
+  }
+
+  // Decodes the encoded frames and returns the stage times of each frame.
+  void Decode(int stage_timing, std::vector<aom_dec_stage_timing_t> *times) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = num_threads_;
+    ::libaom_test::AV1Decoder decoder(cfg, 0);
+    decoder.Control(AV1D_SET_STAGE_TIMING, stage_timing);
+    for (size_t i = 0; i < frames_.size(); ++i) {
+      ASSERT_EQ(AOM_CODEC_OK,
+                decoder.DecodeFrame(&frames_[i][0], frames_[i].size()))
+          << decoder.DecodeError();
+      ::libaom_test::DxDataIterator dec_iter = decoder.GetDxData();
+      while (dec_iter.Next() != NULL) {
+      }
+      aom_dec_stage_timing_t timing;
+      decoder.Control(AV1D_GET_STAGE_TIMING, &timing);
+      times->push_back(timing);
+    }
+  }
+
+  int cpu_used_;
+  unsigned int num_threads_;
+  int stage_timing_;
+  std::vector<std::vector<uint8_t> > frames_;
+  std::vector<aom_enc_stage_timing_t> enc_timing_;
+};
+
+TEST_P(StageTimingTest, Encoder) {
+  ASSERT_NO_FATAL_FAILURE(Encode(1));
+  ASSERT_FALSE(enc_timing_.empty());
+  uint64_t mode_search_us = 0, pack_us = 0, mode_search_cpu_us = 0;
+  for (const auto &timing : enc_timing_) {
+    mode_search_us += timing.time_us[AOM_ENC_STAGE_MODE_SEARCH];
+    pack_us += timing.time_us[AOM_ENC_STAGE_PACK_BITSTREAM];
+    mode_search_cpu_us += timing.cpu_time_us[AOM_ENC_STAGE_MODE_SEARCH];
+    // The calling thread cannot use more CPU time than the stage took.
+    for (int stage = 0; stage < AOM_ENC_STAGES; ++stage) {
+      EXPECT_LE(timing.cpu_time_us[stage],
+                timing.time_us[stage] + kClockSlackUs)
+          << "stage " << stage;
+    }
+  }
+  EXPECT_GT(mode_search_us, 0u);
+  EXPECT_GT(pack_us, 0u);
+  EXPECT_GT(mode_search_cpu_us, 0u);
+}
+
+TEST_P(StageTimingTest, EncoderDisabled) {
+  ASSERT_NO_FATAL_FAILURE(Encode(0));
+  for (const auto &timing : enc_timing_) {
+    for (int stage = 0; stage < AOM_ENC_STAGES; ++stage) {
+      EXPECT_EQ(0u, timing.time_us[stage]) << "stage " << stage;
+      EXPECT_EQ(0u, timing.cpu_time_us[stage]) << "stage " << stage;
+    }
+  }
+}
+
+TEST_P(StageTimingTest, Decoder) {
+  ASSERT_NO_FATAL_FAILURE(Encode(0));
+  std::vector<aom_dec_stage_timing_t> times;
+  ASSERT_NO_FATAL_FAILURE(Decode(1, &times));
+  uint64_t tiles_us = 0, tiles_cpu_us = 0;
+  for (size_t frame = 0; frame < times.size(); ++frame) {
+    const aom_dec_stage_timing_t &timing = times[frame];
+    const uint64_t frame_tiles_us = timing.time_us[AOM_DEC_STAGE_TILES];
+    tiles_us += frame_tiles_us;
+    tiles_cpu_us += timing.cpu_time_us[AOM_DEC_STAGE_TILES];
+    for (int stage = 0; stage < AOM_DEC_STAGES; ++stage) {
+      EXPECT_LE(timing.cpu_time_us[stage],
+                timing.time_us[stage] + kClockSlackUs)
+          << "frame " << frame << " stage " << stage;
+    }
+    if (num_threads_ > 1) {
+      ASSERT_GT(timing.num_workers, 1);
+      // The workers decode tiles only while the tiles stage runs, starting
+      // with the first frame, which creates them.
+      uint64_t busy_us = 0;
+      for (int i = 0; i < timing.num_workers; ++i) {
+        EXPECT_LE(timing.worker_busy_us[i], frame_tiles_us)
+            << "frame " << frame << " worker " << i;
+        EXPECT_LE(timing.worker_busy_us[i] + timing.worker_idle_us[i],
+                  frame_tiles_us)
+            << "frame " << frame << " worker " << i;
+        EXPECT_LE(timing.worker_cpu_us[i],
+                  timing.worker_busy_us[i] + kClockSlackUs)
+            << "frame " << frame << " worker " << i;
+        busy_us += timing.worker_busy_us[i];
+      }
+      EXPECT_LE(busy_us, frame_tiles_us * timing.num_workers)
+          << "frame " << frame;
+      EXPECT_GT(busy_us, 0u) << "frame " << frame;
+    } else {
+      EXPECT_EQ(0, timing.num_workers);
+    }
+  }
+  EXPECT_GT(tiles_us, 0u);
+  EXPECT_GT(tiles_cpu_us, 0u);
+}
+
+TEST_P(StageTimingTest, DecoderDisabled) {
+  ASSERT_NO_FATAL_FAILURE(Encode(0));
+  std::vector<aom_dec_stage_timing_t> times;
+  ASSERT_NO_FATAL_FAILURE(Decode(0, &times));
+  for (const auto &timing : times) {
+    EXPECT_EQ(0, timing.num_workers);
+    for (int stage = 0; stage < AOM_DEC_STAGES; ++stage) {
+      EXPECT_EQ(0u, timing.time_us[stage]) << "stage " << stage;
+      EXPECT_EQ(0u, timing.cpu_time_us[stage]) << "stage " << stage;
+    }
+  }
+}
+
+TEST(StageTimingControlTest, RejectsNull) {
+  aom_codec_ctx_t decoder;
+  ASSERT_EQ(AOM_CODEC_OK,
+            aom_codec_dec_init(&decoder, aom_codec_av1_dx(), NULL, 0));
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&decoder, AV1D_GET_STAGE_TIMING,
+                              static_cast<aom_dec_stage_timing_t *>(NULL)));
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&decoder));
+}
+
+AV1_INSTANTIATE_TEST_CASE(StageTimingTest, ::testing::Values(6),
+                          ::testing::Values(1u, 2u));
+}  // namespace
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <cstring>
+
+#include "config/aom_config.h"
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/util.h"
+#include "aom/aom_codec.h"
+#include "aom/aomcx.h"
+
+namespace {
+
+// Layer quantizers outside 0..63 or out of order and layer bitrates that are
+// not positive or that decrease across temporal layers are rejected.
+TEST(SvcParamsTest, Validation) {
+  aom_codec_iface_t *iface = aom_codec_av1_cx();
+  aom_codec_enc_cfg_t cfg;
+  aom_codec_ctx_t enc;
+  aom_svc_params_t params;
+  ASSERT_EQ(AOM_CODEC_OK, aom_codec_enc_config_default(iface, &cfg, 0));
+  cfg.g_w = 352;
+  cfg.g_h = 288;
+  cfg.rc_end_usage = AOM_CBR;
+  cfg.g_lag_in_frames = 0;
+  ASSERT_EQ(AOM_CODEC_OK, aom_codec_enc_init(&enc, iface, &cfg, 0));
+
+  memset(&params, 0, sizeof(params));
+  params.number_spatial_layers = 2;
+  params.number_temporal_layers = 2;
+  for (int sl = 0; sl < 2; ++sl) {
+    params.scaling_factor_num[sl] = 1;
+    params.scaling_factor_den[sl] = 2 - sl;
+    for (int tl = 0; tl < 2; ++tl) {
+      params.max_quantizers[sl * 2 + tl] = 56;
+      params.min_quantizers[sl * 2 + tl] = 2;
+      params.layer_target_bitrate[sl * 2 + tl] = 100 * (sl + 1) + 50 * tl;
+    }
+  }
+
+  aom_svc_params_t bad = params;
+  bad.max_quantizers[3] = 64;
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&enc, AV1E_SET_SVC_PARAMS, &bad));
+  bad = params;
+  bad.min_quantizers[1] = -1;
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&enc, AV1E_SET_SVC_PARAMS, &bad));
+  bad = params;
+  bad.min_quantizers[2] = 57;
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&enc, AV1E_SET_SVC_PARAMS, &bad));
+  bad = params;
+  bad.layer_target_bitrate[0] = 0;
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&enc, AV1E_SET_SVC_PARAMS, &bad));
+  bad = params;
+  bad.layer_target_bitrate[3] = 150;
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&enc, AV1E_SET_SVC_PARAMS, &bad));
+
+  EXPECT_EQ(AOM_CODEC_OK,
+            aom_codec_control(&enc, AV1E_SET_SVC_PARAMS, &params));
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&enc));
+}
+
+class DatarateTestSVC
+    : public ::libaom_test::CodecTestWithParam<int>,
+      public ::libaom_test::EncoderTest {
+ public:
+  DatarateTestSVC() : EncoderTest(GET_PARAM(0)) {}
+
+ protected:
+  virtual ~DatarateTestSVC() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kRealTime);
+    set_cpu_used_ = GET_PARAM(1);
+    ResetModel();
+  }
+
+  virtual void ResetModel() {
+    last_pts_ = 0;
+    layer_frame_cnt_ = 0;
+    encoder_ = NULL;
+    for (int i = 0; i < AOM_MAX_LAYERS; ++i) bits_in_layer_[i] = 0;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0 && layer_frame_cnt_ == 0) {
+      encoder->Control(AOME_SET_CPUUSED, set_cpu_used_);
+      encoder->Control(AV1E_SET_SVC_PARAMS, &svc_params_);
+    }
+    encoder_ = encoder;
+    const aom_rational_t tb = video->timebase();
+    timebase_ = static_cast<double>(tb.num) / tb.den;
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    aom_svc_layer_id_t layer_id;
+    encoder_->Control(AV1E_GET_SVC_LAYER_ID, &layer_id);
+    // The encoder walks the spatial layers of each superframe in order and
+    // cycles through the 0-2-1-2 temporal pattern between superframes.
+    const int superframe = layer_frame_cnt_ / number_spatial_layers_;
+    static const int kPattern[3][4] = { { 0, 0, 0, 0 },
+                                        { 0, 1, 0, 1 },
+                                        { 0, 2, 1, 2 } };
+    ASSERT_EQ(layer_frame_cnt_ % number_spatial_layers_,
+              layer_id.spatial_layer_id);
+    ASSERT_EQ(kPattern[svc_params_.number_temporal_layers - 1][superframe & 3],
+              layer_id.temporal_layer_id);
+
+    const int layer =
+        layer_id.spatial_layer_id * svc_params_.number_temporal_layers +
+        layer_id.temporal_layer_id;
+    bits_in_layer_[layer] += static_cast<int64_t>(pkt->data.frame.sz * 8);
+    last_pts_ = pkt->data.frame.pts;
+    ++layer_frame_cnt_;
+  }
+
+  virtual void EndPassHook(void) {
+    const double duration = (last_pts_ + 1) * timebase_;
+    const int num_temporal = svc_params_.number_temporal_layers;
+    for (int sl = 0; sl < svc_params_.number_spatial_layers; ++sl) {
+      // Temporal layer bitrates include the layers below them.
+      int64_t bits = 0;
+      for (int tl = 0; tl < num_temporal; ++tl) {
+        bits += bits_in_layer_[sl * num_temporal + tl];
+        effective_datarate_[sl * num_temporal + tl] = bits / 1000.0 / duration;
+      }
+    }
+  }
+
+  void SetSvcParams(int number_spatial_layers, int number_temporal_layers) {
+    memset(&svc_params_, 0, sizeof(svc_params_));
+    svc_params_.number_spatial_layers = number_spatial_layers;
+    svc_params_.number_temporal_layers = number_temporal_layers;
+    number_spatial_layers_ = number_spatial_layers;
+    // Spatial layers at 1/4, 1/2 and full resolution, each taking a share of
+    // the bitrate proportional to its width. Three temporal layers take 50%,
+    // 70% and 100% of the spatial layer bitrate.
+    static const int kTemporalPct[3][3] = { { 100, 0, 0 },
+                                            { 60, 100, 0 },
+                                            { 50, 70, 100 } };
+    const int total_share = (1 << number_spatial_layers) - 1;
+    for (int sl = 0; sl < number_spatial_layers; ++sl) {
+      const int share = 1 << sl;
+      svc_params_.scaling_factor_num[sl] = 1;
+      const int den = 1 << (number_spatial_layers - 1 - sl);
+      svc_params_.scaling_factor_den[sl] = den;
+      const int spatial_bitrate =
+          cfg_.rc_target_bitrate * share / total_share;
+      for (int tl = 0; tl < number_temporal_layers; ++tl) {
+        const int layer = sl * number_temporal_layers + tl;
+        svc_params_.max_quantizers[layer] = 56;
+        svc_params_.min_quantizers[layer] = 2;
+        svc_params_.layer_target_bitrate[layer] =
+            spatial_bitrate *
+            kTemporalPct[number_temporal_layers - 1][tl] / 100;
+      }
+    }
+  }
+
+  void BasicRateTargetingSVC(int number_spatial_layers,
+                             int number_temporal_layers) {
+    cfg_.rc_buf_initial_sz = 500;
+    cfg_.rc_buf_optimal_sz = 500;
+    cfg_.rc_buf_sz = 1000;
+    cfg_.rc_dropframe_thresh = 0;
+    cfg_.rc_min_quantizer = 0;
+    cfg_.rc_max_quantizer = 63;
+    cfg_.rc_end_usage = AOM_CBR;
+    cfg_.g_lag_in_frames = 0;
+    cfg_.g_error_resilient = 0;
+    cfg_.kf_max_dist = 9999;
+
+    ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352,
+                                         288, 30, 1, 0, 300);
+    for (int bitrate = 300; bitrate <= 600; bitrate += 300) {
+      cfg_.rc_target_bitrate = bitrate;
+      SetSvcParams(number_spatial_layers, number_temporal_layers);
+      ResetModel();
+      ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+      for (int i = 0; i < number_spatial_layers * number_temporal_layers;
+           ++i) {
+        ASSERT_GE(effective_datarate_[i],
+                  svc_params_.layer_target_bitrate[i] * 0.75)
+            << " The datarate for layer " << i
+            << " is lower than target by too much!";
+        ASSERT_LE(effective_datarate_[i],
+                  svc_params_.layer_target_bitrate[i] * 1.25)
+            << " The datarate for layer " << i
+            << " is greater than target by too much!";
+      }
+    }
+  }
+
+  int set_cpu_used_;
+  int layer_frame_cnt_;
+  double timebase_;
+  ::libaom_test::Encoder *encoder_;
+  aom_svc_params_t svc_params_;
+  int64_t bits_in_layer_[AOM_MAX_LAYERS];
+  double effective_datarate_[AOM_MAX_LAYERS];
+};
+
+// Check basic rate targeting for CBR with three temporal layers.
+TEST_P(DatarateTestSVC, BasicRateTargetingSVC1SL3TL) {
+  BasicRateTargetingSVC(1, 3);
+}
+
+// Check basic rate targeting for CBR with two spatial and two temporal
+// layers.
+TEST_P(DatarateTestSVC, BasicRateTargetingSVC2SL2TL) {
+  BasicRateTargetingSVC(2, 2);
+}
+
+// Check basic rate targeting for CBR with three spatial and three temporal
+// layers.
+TEST_P(DatarateTestSVC, BasicRateTargetingSVC3SL3TL) {
+  BasicRateTargetingSVC(3, 3);
+}
+
+AV1_INSTANTIATE_TEST_CASE(DatarateTestSVC, ::testing::Values(7, 8));
+}  // namespace
@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "config/aom_config.h"
+#include "aom/aomcx.h"
+#include "aom/aomdx.h"
+#include "aom_util/aom_task.h"
+#include "test/codec_factory.h"
+#include "test/decode_test_driver.h"
+#include "test/encode_test_driver.h"
+#include "test/md5_helper.h"
+#include "test/util.h"
+#include "test/video_source.h"
+
+namespace {
+
+const int kNumWorkers = 4;
+const int kNumFrames = 6;
+
+// Records the order in which the tasks start and end.
+struct Tracker {
+  std::atomic<int> clock;
+  std::vector<int> start;
+  std::vector<int> end;
+  std::vector<int> thread_id;
+  int fail_task;
+};
+
+struct TaskArg {
+  Tracker *tracker;
+  int index;
+};
+
+int TrackedTask(void *arg1, void *, int thread_id) {
+  const TaskArg *const arg = static_cast<const TaskArg *>(arg1);
+  Tracker *const tracker = arg->tracker;
+  tracker->start[arg->index] = tracker->clock++;
+  tracker->thread_id[arg->index] = thread_id;
+  // Leave time for the other workers to take tasks.
+  volatile int sum = 0;
+  for (int i = 0; i < 10000; ++i) sum = sum + i;
+  tracker->end[arg->index] = tracker->clock++;
+  return arg->index != tracker->fail_task;
+}
+
+class TaskGraphTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    graph_ = AomTaskGraph();
+    const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+    for (int i = 0; i < kNumWorkers; ++i) {
+      winterface->init(&workers_[i]);
+      if (i < kNumWorkers - 1) {
+        ASSERT_TRUE(winterface->reset(&workers_[i]));
+      }
+    }
+  }
+
+  virtual void TearDown() {
+    for (int i = 0; i < kNumWorkers; ++i) {
+      aom_get_worker_interface()->end(&workers_[i]);
+    }
+    aom_task_graph_free(&graph_);
+  }
+
+  // Adds 'num_tasks' tracked tasks to the graph.
+  void AddTasks(int num_tasks, int fail_task) {
+    tracker_.clock = 0;
+    tracker_.start.assign(num_tasks, -1);
+    tracker_.end.assign(num_tasks, -1);
+    tracker_.thread_id.assign(num_tasks, -1);
+    tracker_.fail_task = fail_task;
+    args_.resize(num_tasks);
+    for (int i = 0; i < num_tasks; ++i) {
+      args_[i].tracker = &tracker_;
+      args_[i].index = i;
+      EXPECT_EQ(i, aom_task_graph_add(&graph_, TrackedTask, &args_[i], NULL));
+    }
+  }
+
+  AomTaskGraph graph_;
+  AVxWorker workers_[kNumWorkers];
+  Tracker tracker_;
+  std::vector<TaskArg> args_;
+};
+
+// Each task of a grid starts after the task on its left and the task above
+// it.
+TEST_F(TaskGraphTest, RunsTasksAfterDependencies) {
+  const int kRows = 8;
+  const int kCols = 8;
+  const int kNumTasks = kRows * kCols;
+  ASSERT_TRUE(aom_task_graph_alloc(&graph_, kNumTasks, 2 * kNumTasks,
+                                   kNumWorkers));
+  AddTasks(kNumTasks, -1);
+  for (int r = 0; r < kRows; ++r) {
+    for (int c = 0; c < kCols; ++c) {
+      const int task = r * kCols + c;
+      if (c > 0) aom_task_graph_add_dependency(&graph_, task - 1, task);
+      if (r > 0) aom_task_graph_add_dependency(&graph_, task - kCols, task);
+    }
+  }
+  for (int run = 0; run < 2; ++run) {
+    for (int i = 0; i < kNumTasks; ++i) tracker_.end[i] = -1;
+    ASSERT_TRUE(aom_task_graph_run(&graph_, workers_, kNumWorkers,
+                                   kNumWorkers - 1));
+    for (int r = 0; r < kRows; ++r) {
+      for (int c = 0; c < kCols; ++c) {
+        const int task = r * kCols + c;
+        ASSERT_GE(tracker_.end[task], 0) << "task " << task;
+        if (c > 0) {
+          EXPECT_GT(tracker_.start[task], tracker_.end[task - 1]);
+        }
+        if (r > 0) {
+          EXPECT_GT(tracker_.start[task], tracker_.end[task - kCols]);
+        }
+      }
+    }
+  }
+}
+
+// Each task runs once on one of the workers, whichever worker runs in the
+// calling thread.
+TEST_F(TaskGraphTest, RunsTasksOnce) {
+  const int kNumTasks = 64;
+  ASSERT_TRUE(aom_task_graph_alloc(&graph_, kNumTasks, 0, kNumWorkers));
+  AddTasks(kNumTasks, -1);
+  for (int main_worker = 0; main_worker < kNumWorkers; ++main_worker) {
+    tracker_.clock = 0;
+    ASSERT_TRUE(
+        aom_task_graph_run(&graph_, workers_, kNumWorkers, main_worker));
+    EXPECT_EQ(2 * kNumTasks, tracker_.clock.load());
+    for (int i = 0; i < kNumTasks; ++i) {
+      ASSERT_GE(tracker_.thread_id[i], 0);
+      ASSERT_LT(tracker_.thread_id[i], kNumWorkers);
+    }
+  }
+}
+
+// The successors of a failed task do not run.
+TEST_F(TaskGraphTest, StopsOnError) {
+  const int kNumTasks = 16;
+  ASSERT_TRUE(aom_task_graph_alloc(&graph_, kNumTasks, kNumTasks - 1,
+                                   kNumWorkers));
+  AddTasks(kNumTasks, 5);
+  for (int i = 1; i < kNumTasks; ++i) {
+    aom_task_graph_add_dependency(&graph_, i - 1, i);
+  }
+  EXPECT_FALSE(aom_task_graph_run(&graph_, workers_, kNumWorkers, 0));
+  EXPECT_GE(tracker_.end[5], 0);
+  for (int i = 6; i < kNumTasks; ++i) EXPECT_EQ(-1, tracker_.start[i]);
+}
+
+// A panning texture with sharp edges and some noise, so the encoder turns on
+// CDEF and loop restoration. 352x288 leaves a partial last filter block row.
+class PanningVideoSource : public ::libaom_test::DummyVideoSource {
+ public:
+  PanningVideoSource() : rnd_(::libaom_test::ACMRandom::DeterministicSeed()) {
+    SetSize(352, 288);
+    set_limit(kNumFrames);
+  }
+
+ protected:
+  virtual void FillFrame() {
+    if (!img_) return;
+    for (int plane = 0; plane < 3; ++plane) {
+      const int w = plane ? (img_->d_w + 1) >> 1 : img_->d_w;
+      const int h = plane ? (img_->d_h + 1) >> 1 : img_->d_h;
+      for (int r = 0; r < h; ++r) {
+        uint8_t *const row = img_->planes[plane] + r * img_->stride[plane];
+        for (int c = 0; c < w; ++c) {
+          const int x = c + 3 * frame_;
+          const int edge = ((x >> 4) + (r >> 4)) & 1 ? 60 : 0;
+          row[c] = static_cast<uint8_t>(
+              (plane ? 100 : 60) + edge + (x * 3 + r * 5) % 40 + rnd_(8));
+        }
+      }
+    }
+  }
+
+  ::libaom_test::ACMRandom rnd_;
+};
+
+class TaskGraphCodecTest
+    : public ::libaom_test::CodecTestWithParam<unsigned int>,
+      public ::libaom_test::EncoderTest {
+ protected:
+  TaskGraphCodecTest() : EncoderTest(GET_PARAM(0)), sb_size_(GET_PARAM(1)) {}
+  virtual ~TaskGraphCodecTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.rc_end_usage = AOM_CBR;
+    cfg_.rc_target_bitrate = 500;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 6);
+      encoder->Control(AV1E_SET_SUPERBLOCK_SIZE, sb_size_);
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 1);
+      encoder->Control(AV1E_SET_TILE_ROWS, 1);
+      encoder->Control(AV1E_SET_ROW_MT, 0);
+      encoder->Control(AV1E_SET_ENABLE_CDEF, 1);
+      encoder->Control(AV1E_SET_ENABLE_RESTORATION, 1);
+    }
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *pkt) {
+    const uint8_t *const buf =
+        static_cast<const uint8_t *>(pkt->data.frame.buf);
+    frames_.push_back(std::vector<uint8_t>(buf, buf + pkt->data.frame.sz));
+  }
+
+  void Encode(unsigned int threads) {
+    frames_.clear();
+    cfg_.g_threads = threads;
+    PanningVideoSource video;
+    ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+    ASSERT_EQ(static_cast<size_t>(kNumFrames), frames_.size());
+  }
+
+  void Decode(unsigned int threads, std::vector<std::string> *md5s) {
+    aom_codec_dec_cfg_t cfg = aom_codec_dec_cfg_t();
+    cfg.threads = threads;
+    ::libaom_test::AV1Decoder decoder(cfg, 0);
+    decoder.Control(AV1D_SET_ROW_MT, 0);
+    for (size_t i = 0; i < frames_.size(); ++i) {
+      ASSERT_EQ(AOM_CODEC_OK,
+                decoder.DecodeFrame(&frames_[i][0], frames_[i].size()))
+          << decoder.DecodeError();
+      ::libaom_test::DxDataIterator dec_iter = decoder.GetDxData();
+      const aom_image_t *img;
+      while ((img = dec_iter.Next()) != NULL) {
+        ::libaom_test::MD5 md5;
+        md5.Add(img);
+        md5s->push_back(md5.Get());
+      }
+    }
+  }
+
+  unsigned int sb_size_;
+  std::vector<std::vector<uint8_t> > frames_;
+};
+
+// The tile encoder gives the same bitstream with one thread and with tile
+// jobs spread over several threads.
+TEST_P(TaskGraphCodecTest, EncodeTiles) {
+  ASSERT_NO_FATAL_FAILURE(Encode(1));
+  const std::vector<std::vector<uint8_t> > expected_frames = frames_;
+  ASSERT_NO_FATAL_FAILURE(Encode(kNumWorkers));
+  EXPECT_EQ(expected_frames, frames_);
+}
+
+// Loop filtering the tile rows while the next tile rows decode, and running
+// the CDEF and loop restoration rows as tasks, does not change the output.
+// With 64x64 superblocks the tile rows do not line up with the loop filter
+// rows.
+TEST_P(TaskGraphCodecTest, DecodeTilesWithLoopFilter) {
+  ASSERT_NO_FATAL_FAILURE(Encode(1));
+  std::vector<std::string> expected_md5s, md5s;
+  ASSERT_NO_FATAL_FAILURE(Decode(1, &expected_md5s));
+  ASSERT_EQ(frames_.size(), expected_md5s.size());
+  for (unsigned int threads = 2; threads <= 8; threads *= 2) {
+    md5s.clear();
+    ASSERT_NO_FATAL_FAILURE(Decode(threads, &md5s));
+    EXPECT_EQ(expected_md5s, md5s) << "threads " << threads;
+  }
+}
+
+AV1_INSTANTIATE_TEST_CASE(TaskGraphCodecTest,
+                          ::testing::Values(AOM_SUPERBLOCK_SIZE_64X64,
+                                            AOM_SUPERBLOCK_SIZE_128X128));
+
+}  // namespace
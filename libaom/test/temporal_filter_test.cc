@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+
+#include "config/av1_rtcd.h"
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "test/register_state_check.h"
+#include "test/util.h"
+#include "aom_ports/aom_timer.h"
+#include "aom_ports/mem.h"
+
+namespace {
+
+using libaom_test::ACMRandom;
+
+const int kMaxWidth = 32;
+const int kMaxHeight = 32;
+const int kStride = 48;
+
+typedef void (*TemporalFilterFunc)(uint8_t *frame1, unsigned int stride,
+                                   uint8_t *frame2, unsigned int block_width,
+                                   unsigned int block_height, int strength,
+                                   const int *blk_fw, int use_32x32,
+                                   unsigned int *accumulator, uint16_t *count);
+
+// Single plane temporal filter test, comparing against the C reference.
+class TemporalFilterTest : public ::testing::TestWithParam<TemporalFilterFunc> {
+ public:
+  virtual void SetUp() {
+    filter_func_ = GetParam();
+    rnd_.Reset(ACMRandom::DeterministicSeed());
+  }
+
+  virtual void TearDown() { libaom_test::ClearSystemState(); }
+
+ protected:
+  void FillRandom(int max_val) {
+    for (int i = 0; i < kMaxHeight * kStride; ++i) {
+      src_[i] = rnd_.Rand8() % (max_val + 1);
+    }
+    for (int i = 0; i < kMaxHeight * kMaxWidth; ++i) {
+      pred_[i] = rnd_.Rand8() % (max_val + 1);
+    }
+  }
+
+  void FillExtreme() {
+    for (int i = 0; i < kMaxHeight * kStride; ++i) src_[i] = 255;
+    for (int i = 0; i < kMaxHeight * kMaxWidth; ++i) pred_[i] = 0;
+  }
+
+  void RunCheckOutput(int width, int height, int strength, const int *blk_fw,
+                      int use_32x32) {
+    for (int i = 0; i < kMaxHeight * kMaxWidth; ++i) {
+      accum_ref_[i] = accum_tst_[i] = rnd_.Rand16();
+      count_ref_[i] = count_tst_[i] = rnd_.Rand8();
+    }
+
+    av1_temporal_filter_apply_c(src_, kStride, pred_, width, height, strength,
+                                blk_fw, use_32x32, accum_ref_, count_ref_);
+    ASM_REGISTER_STATE_CHECK(filter_func_(src_, kStride, pred_, width, height,
+                                          strength, blk_fw, use_32x32,
+                                          accum_tst_, count_tst_));
+
+    for (int i = 0; i < width * height; ++i) {
+      ASSERT_EQ(accum_ref_[i], accum_tst_[i])
+          << "accumulator mismatch at " << i << ", width " << width
+          << ", height " << height << ", strength " << strength;
+      ASSERT_EQ(count_ref_[i], count_tst_[i])
+          << "count mismatch at " << i << ", width " << width << ", height "
+          << height << ", strength " << strength;
+    }
+  }
+
+  TemporalFilterFunc filter_func_;
+  ACMRandom rnd_;
+  DECLARE_ALIGNED(32, uint8_t, src_[kMaxHeight * kStride]);
+  DECLARE_ALIGNED(32, uint8_t, pred_[kMaxHeight * kMaxWidth]);
+  DECLARE_ALIGNED(32, unsigned int, accum_ref_[kMaxHeight * kMaxWidth]);
+  DECLARE_ALIGNED(32, unsigned int, accum_tst_[kMaxHeight * kMaxWidth]);
+  DECLARE_ALIGNED(32, uint16_t, count_ref_[kMaxHeight * kMaxWidth]);
+  DECLARE_ALIGNED(32, uint16_t, count_tst_[kMaxHeight * kMaxWidth]);
+};
+
+TEST_P(TemporalFilterTest, CheckOutput) {
+  static const int kSizes[][2] = { { 32, 32 }, { 16, 16 }, { 32, 16 } };
+  for (int size = 0; size < 3; ++size) {
+    const int width = kSizes[size][0], height = kSizes[size][1];
+    for (int strength = 0; strength <= 6; ++strength) {
+      for (int filter_idx = 0; filter_idx < 3 * 3 * 3 * 3; ++filter_idx) {
+        int blk_fw[4];
+        int filter_idx_cp = filter_idx;
+        for (int idx = 0; idx < 4; ++idx) {
+          blk_fw[idx] = filter_idx_cp % 3;
+          filter_idx_cp /= 3;
+        }
+        // Small differences exercise the whole modifier range.
+        FillRandom(7);
+        RunCheckOutput(width, height, strength, blk_fw, 0);
+        if (filter_idx < 3) RunCheckOutput(width, height, strength, blk_fw, 1);
+        FillRandom(255);
+        RunCheckOutput(width, height, strength, blk_fw, 0);
+      }
+    }
+  }
+}
+
+TEST_P(TemporalFilterTest, ExtremeValues) {
+  const int blk_fw[4] = { 2, 2, 2, 2 };
+  FillExtreme();
+  for (int strength = 0; strength <= 6; ++strength) {
+    RunCheckOutput(kMaxWidth, kMaxHeight, strength, blk_fw, 1);
+  }
+}
+
+TEST_P(TemporalFilterTest, DISABLED_Speed) {
+  const int blk_fw[4] = { 2, 1, 1, 0 };
+  const int num_loops = 100000;
+  FillRandom(255);
+
+  aom_usec_timer ref_timer, test_timer;
+  aom_usec_timer_start(&ref_timer);
+  for (int i = 0; i < num_loops; ++i) {
+    av1_temporal_filter_apply_c(src_, kStride, pred_, kMaxWidth, kMaxHeight, 6,
+                                blk_fw, 0, accum_ref_, count_ref_);
+  }
+  aom_usec_timer_mark(&ref_timer);
+  const int elapsed_ref = static_cast<int>(aom_usec_timer_elapsed(&ref_timer));
+
+  aom_usec_timer_start(&test_timer);
+  for (int i = 0; i < num_loops; ++i) {
+    filter_func_(src_, kStride, pred_, kMaxWidth, kMaxHeight, 6, blk_fw, 0,
+                 accum_tst_, count_tst_);
+  }
+  aom_usec_timer_mark(&test_timer);
+  const int elapsed_tst =
+      static_cast<int>(aom_usec_timer_elapsed(&test_timer));
+
+  printf("c_time=%d \t simd_time=%d \t gain=%f\n", elapsed_ref, elapsed_tst,
+         static_cast<double>(elapsed_ref) / elapsed_tst);
+}
+
+INSTANTIATE_TEST_CASE_P(C, TemporalFilterTest,
+                        ::testing::Values(&av1_temporal_filter_apply_c));
+
+#if HAVE_AVX2
+INSTANTIATE_TEST_CASE_P(AVX2, TemporalFilterTest,
+                        ::testing::Values(&av1_temporal_filter_apply_avx2));
+#endif  // HAVE_AVX2
+
+}  // namespace
@@ -36,6 +36,7 @@ list(APPEND AOM_UNIT_TEST_COMMON_SOURCES
             "${AOM_ROOT}/test/log2_test.cc"
             "${AOM_ROOT}/test/md5_helper.h"
             "${AOM_ROOT}/test/register_state_check.h"
+            "${AOM_ROOT}/test/rtcd_override_test.cc"
             "${AOM_ROOT}/test/test_vectors.cc"
             "${AOM_ROOT}/test/test_vectors.h"
             "${AOM_ROOT}/test/transform_test_base.h"
@@ -56,14 +57,24 @@ list(APPEND AOM_UNIT_TEST_DECODER_SOURCES "${AOM_ROOT}/test/decode_api_test.cc"
 list(APPEND AOM_UNIT_TEST_ENCODER_SOURCES
             "${AOM_ROOT}/test/active_map_test.cc"
             "${AOM_ROOT}/test/altref_test.cc"
+            "${AOM_ROOT}/test/analysis_cache_test.cc"
             "${AOM_ROOT}/test/aq_segment_test.cc"
             "${AOM_ROOT}/test/borders_test.cc"
+            "${AOM_ROOT}/test/small_border_test.cc"
             "${AOM_ROOT}/test/cpu_speed_test.cc"
             "${AOM_ROOT}/test/datarate_test.cc"
+            "${AOM_ROOT}/test/svc_datarate_test.cc"
             "${AOM_ROOT}/test/encode_api_test.cc"
             "${AOM_ROOT}/test/encode_test_driver.cc"
             "${AOM_ROOT}/test/encode_test_driver.h"
             "${AOM_ROOT}/test/end_to_end_test.cc"
+            "${AOM_ROOT}/test/fast_preview_test.cc"
+            "${AOM_ROOT}/test/key_frames_only_test.cc"
+            "${AOM_ROOT}/test/low_memory_decode_test.cc"
+            "${AOM_ROOT}/test/shared_thread_pool_test.cc"
+            "${AOM_ROOT}/test/stage_timing_test.cc"
+            "${AOM_ROOT}/test/task_graph_test.cc"
+            "${AOM_ROOT}/test/thread_affinity_test.cc"
             "${AOM_ROOT}/test/fwd_kf_test.cc"
             "${AOM_ROOT}/test/gf_max_pyr_height_test.cc"
             "${AOM_ROOT}/test/rt_end_to_end_test.cc"
@@ -72,8 +83,10 @@ list(APPEND AOM_UNIT_TEST_ENCODER_SOURCES
             "${AOM_ROOT}/test/horz_superres_test.cc"
             "${AOM_ROOT}/test/i420_video_source.h"
             "${AOM_ROOT}/test/level_test.cc"
+            "${AOM_ROOT}/test/lookahead_analysis_test.cc"
             "${AOM_ROOT}/test/lossless_test.cc"
             "${AOM_ROOT}/test/monochrome_test.cc"
+            "${AOM_ROOT}/test/motion_hints_test.cc"
             "${AOM_ROOT}/test/qm_test.cc"
             "${AOM_ROOT}/test/resize_test.cc"
             "${AOM_ROOT}/test/scalability_test.cc"
@@ -86,6 +99,7 @@ list(APPEND AOM_ENCODE_PERF_TEST_SOURCES "${AOM_ROOT}/test/encode_perf_test.cc")
 list(APPEND AOM_UNIT_TEST_WEBM_SOURCES "${AOM_ROOT}/test/webm_video_source.h")
 list(APPEND AOM_TEST_INTRA_PRED_SPEED_SOURCES "${AOM_GEN_SRC_DIR}/usage_exit.c"
             "${AOM_ROOT}/test/test_intra_pred_speed.cc")
+list(APPEND AOM_TEST_RTCD_SPEED_SOURCES "${AOM_ROOT}/test/test_rtcd_speed.cc")
 
 if(NOT BUILD_SHARED_LIBS)
   list(APPEND AOM_UNIT_TEST_COMMON_SOURCES
@@ -124,6 +138,7 @@ if(NOT BUILD_SHARED_LIBS)
                 "${AOM_ROOT}/test/film_grain_table_test.cc"
                 "${AOM_ROOT}/test/segment_binarization_sync.cc"
                 "${AOM_ROOT}/test/superframe_test.cc"
+                "${AOM_ROOT}/test/temporal_filter_test.cc"
                 "${AOM_ROOT}/test/tile_independence_test.cc"
                 "${AOM_ROOT}/test/yuv_temporal_filter_test.cc")
   endif()
@@ -185,11 +200,15 @@ if(NOT BUILD_SHARED_LIBS)
               "${AOM_ROOT}/test/comp_avg_pred_test.cc"
               "${AOM_ROOT}/test/comp_avg_pred_test.h"
               "${AOM_ROOT}/test/comp_mask_variance_test.cc"
+              "${AOM_ROOT}/test/corner_detect_test.cc"
+              "${AOM_ROOT}/test/cost_table_test.cc"
               "${AOM_ROOT}/test/edge_detect_test.cc"
               "${AOM_ROOT}/test/encodetxb_test.cc"
               "${AOM_ROOT}/test/error_block_test.cc"
               "${AOM_ROOT}/test/fft_test.cc"
               "${AOM_ROOT}/test/fwht4x4_test.cc"
+              "${AOM_ROOT}/test/hadamard_test.cc"
+              "${AOM_ROOT}/test/hash_table_test.cc"
               "${AOM_ROOT}/test/horver_correlation_test.cc"
               "${AOM_ROOT}/test/masked_sad_test.cc"
               "${AOM_ROOT}/test/masked_variance_test.cc"
@@ -311,6 +330,12 @@ function(setup_aom_test_targets)
     endif()
   endif()
 
+  if(NOT BUILD_SHARED_LIBS)
+    add_executable(test_rtcd_speed ${AOM_TEST_RTCD_SPEED_SOURCES})
+    target_link_libraries(test_rtcd_speed ${AOM_LIB_LINK_TYPE} aom aom_gtest)
+    list(APPEND AOM_APP_TARGETS test_rtcd_speed)
+  endif()
+
   target_link_libraries(test_libaom ${AOM_LIB_LINK_TYPE} aom aom_gtest)
 
   if(CONFIG_LIBYUV)
@@ -0,0 +1,1935 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+//  Measures the speed of every version of the run time CPU detected (RTCD)
+//  functions that the CPU supports, and prints the results as JSON.
+//
+//  The functions are found by walking the tables registered by
+//  aom_dsp_rtcd(), av1_rtcd() and aom_scale_rtcd(), and are driven according
+//  to their prototype. The block size is taken from the function name, e.g.
+//  16x8 for aom_sad16x8. Each version runs for at least --min_time_ms, three
+//  times, and the fastest run is reported in nanoseconds and, on x86, in time
+//  stamp counter cycles per call, with its speedup over the first version,
+//  which is the C one when the function has one. Every version that is
+//  compiled is measured, whether or not the function pointer may be bound to
+//  it. The functions in kNotMeasured, and those whose prototype is not known
+//  here, are listed as skipped with the reason.
+//
+//  Usage: test_rtcd_speed [--filter=<name>] [--min_time_ms=<n>]
+//  where the name may end with '*' to match every function with that prefix.
+
+#include <ctype.h>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#include "config/aom_config.h"
+#include "config/aom_dsp_rtcd.h"
+#include "config/aom_scale_rtcd.h"
+#include "config/av1_rtcd.h"
+
+#include "test/acm_random.h"
+#include "test/clear_system_state.h"
+#include "aom_mem/aom_mem.h"
+#include "aom_ports/aom_rtcd.h"
+#include "aom_ports/aom_timer.h"
+#include "aom_ports/mem.h"
+#if ARCH_X86 || ARCH_X86_64
+#include "aom_ports/x86.h"
+#endif
+#include "aom_scale/yv12config.h"
+#include "av1/common/blockd.h"
+#include "av1/common/cdef_block.h"
+#include "av1/common/convolve.h"
+#include "av1/common/filter.h"
+#include "av1/common/resize.h"
+#include "av1/common/restoration.h"
+#include "av1/common/scan.h"
+#include "av1/encoder/hash.h"
+
+namespace {
+
+using libaom_test::ACMRandom;
+
+// The blocks are at (kBorder, kBorder) in planes large enough for the filter
+// taps and the over-reads of the SIMD versions around a 128x128 block.
+const int kStride = 320;
+const int kRows = 192;
+const int kBorder = 32;
+const int kMaxBlockSize = 128;
+const int kEdgeSize = 2 * kMaxBlockSize + 2 * kBorder;
+const int kRuns = 3;
+const int kDefaultMinTimeMs = 5;
+// The frame of the functions that work on a YV12_BUFFER_CONFIG.
+const int kFrameWidth = 352;
+const int kFrameHeight = 288;
+const int kFrameBorder = 64;
+
+DECLARE_ALIGNED(16, const int16_t, kFilter[8]) = { 0, 2, -14, 76,
+                                                   76, -14, 2, 0 };
+
+// Buffers and parameters handed to the function being measured.
+class Context {
+ public:
+  Context() : rnd_(ACMRandom::DeterministicSeed()) {
+    plane_ = Alloc<uint8_t>(3 * kStride * kRows);
+    plane16_ = Alloc<uint16_t>(3 * kStride * kRows);
+    pred_ = Alloc<uint8_t>(kMaxBlockSize * kMaxBlockSize);
+    pred16_ = Alloc<uint16_t>(kMaxBlockSize * kMaxBlockSize);
+    mask = Alloc<uint8_t>(kMaxBlockSize * kMaxBlockSize);
+    wsrc = Alloc<int32_t>(kMaxBlockSize * kMaxBlockSize);
+    obmc_mask = Alloc<int32_t>(kMaxBlockSize * kMaxBlockSize);
+    edge_ = Alloc<uint8_t>(2 * kEdgeSize);
+    edge16_ = Alloc<uint16_t>(2 * kEdgeSize);
+    residual = Alloc<int16_t>(2 * 64 * 64);
+    coeff = Alloc<int32_t>(64 * 64);
+    qcoeff = Alloc<int32_t>(64 * 64);
+    dqcoeff = Alloc<int32_t>(64 * 64);
+    scan = Alloc<int16_t>(64 * 64);
+    comp_pred_ = Alloc<uint8_t>(kMaxBlockSize * kMaxBlockSize);
+    comp_pred16_ = Alloc<uint16_t>(kMaxBlockSize * kMaxBlockSize);
+    conv_buf = Alloc<uint16_t>(kMaxBlockSize * kMaxBlockSize);
+    fft_buf = Alloc<float>(3 * 2 * 32 * 32);
+    levels = Alloc<uint8_t>(TX_PAD_2D);
+    coeff_contexts = Alloc<int8_t>(32 * 32);
+    cdef_in_ = Alloc<uint16_t>(CDEF_INBUF_SIZE);
+    flt0 = Alloc<int32_t>(64 * 64);
+    flt1 = Alloc<int32_t>(64 * 64);
+    sgr_tmpbuf = Alloc<int32_t>(RESTORATION_TMPBUF_SIZE);
+    stats_m = Alloc<int64_t>(WIENER_WIN2);
+    stats_h = Alloc<int64_t>(WIENER_WIN2 * WIENER_WIN2);
+    accum = Alloc<uint32_t>(3 * 32 * 32);
+    count = Alloc<uint16_t>(3 * 32 * 32);
+    xs = Alloc<int>(kStride);
+    scores = Alloc<int>(kStride);
+    for (int i = 0; i < 3 * kStride * kRows; ++i) plane_[i] = rnd_.Rand8();
+    for (int i = 0; i < kMaxBlockSize * kMaxBlockSize; ++i) {
+      pred_[i] = rnd_.Rand8();
+      mask[i] = rnd_(65);
+      obmc_mask[i] = rnd_(4097);
+      wsrc[i] = rnd_.Rand8() * obmc_mask[i];
+    }
+    for (int i = 0; i < 64 * 64; ++i) scan[i] = i;
+    for (int i = 0; i < TX_PAD_2D; ++i) levels[i] = rnd_(4);
+    for (int i = 0; i < 3 * 2 * 32 * 32; ++i) fft_buf[i] = rnd_.Rand8();
+    cdef_in = cdef_in_ + CDEF_VBORDER * CDEF_BSTRIDE + CDEF_HBORDER;
+    av1_crc32c_calculator_init(&crc);
+    memset(&frame, 0, sizeof(frame));
+    memset(&frame2, 0, sizeof(frame2));
+    if (aom_alloc_frame_buffer(&frame, kFrameWidth, kFrameHeight, 1, 1, 0,
+                               kFrameBorder, 0) ||
+        aom_alloc_frame_buffer(&frame2, kFrameWidth, kFrameHeight, 1, 1, 0,
+                               kFrameBorder, 0)) {
+      fprintf(stderr, "Failed to allocate the frames.\n");
+      exit(EXIT_FAILURE);
+    }
+    memset(frame.buffer_alloc, 128, frame.buffer_alloc_sz);
+    memset(frame2.buffer_alloc, 128, frame2.buffer_alloc_sz);
+    memset(blimit, 60, sizeof(blimit));
+    memset(limit, 10, sizeof(limit));
+    memset(thresh, 4, sizeof(thresh));
+    jcp.use_dist_wtd_comp_avg = 1;
+    jcp.fwd_offset = 9;
+    jcp.bck_offset = 7;
+  }
+
+  ~Context() {
+    aom_free(plane_);
+    aom_free(plane16_);
+    aom_free(pred_);
+    aom_free(pred16_);
+    aom_free(mask);
+    aom_free(wsrc);
+    aom_free(obmc_mask);
+    aom_free(edge_);
+    aom_free(edge16_);
+    aom_free(residual);
+    aom_free(coeff);
+    aom_free(qcoeff);
+    aom_free(dqcoeff);
+    aom_free(scan);
+    aom_free(comp_pred_);
+    aom_free(comp_pred16_);
+    aom_free(conv_buf);
+    aom_free(fft_buf);
+    aom_free(levels);
+    aom_free(coeff_contexts);
+    aom_free(cdef_in_);
+    aom_free(flt0);
+    aom_free(flt1);
+    aom_free(sgr_tmpbuf);
+    aom_free(stats_m);
+    aom_free(stats_h);
+    aom_free(accum);
+    aom_free(count);
+    aom_free(xs);
+    aom_free(scores);
+    aom_free_frame_buffer(&frame);
+    aom_free_frame_buffer(&frame2);
+  }
+
+  // Points the buffers at the data of the given depth. The high bit depth
+  // data is passed through CONVERT_TO_BYTEPTR() to the functions that take
+  // uint8_t pointers.
+  void SetUp(const char *func_name, int width, int height, int bit_depth,
+             bool is_highbd) {
+    const int max = (1 << bit_depth) - 1;
+    const int origin = kBorder * kStride + kBorder;
+    name = func_name;
+    w = width;
+    h = height;
+    bd = bit_depth;
+    highbd = is_highbd;
+    for (int i = 0; i < 3 * kStride * kRows; ++i) {
+      plane16_[i] = rnd_.Rand16() & max;
+    }
+    for (int i = 0; i < kMaxBlockSize * kMaxBlockSize; ++i) {
+      pred16_[i] = rnd_.Rand16() & max;
+    }
+    // Some functions work in place, so the edges and the coefficients are
+    // refreshed for each function.
+    for (int i = 0; i < 2 * kEdgeSize; ++i) {
+      edge_[i] = rnd_.Rand8();
+      edge16_[i] = rnd_.Rand16() & max;
+    }
+    for (int i = 0; i < 2 * 64 * 64; ++i) {
+      residual[i] = (rnd_.Rand16() & max) - (rnd_.Rand16() & max);
+    }
+    for (int i = 0; i < 64 * 64; ++i) coeff[i] = rnd_(513) - 256;
+    for (int i = 0; i < CDEF_INBUF_SIZE; ++i) cdef_in_[i] = rnd_.Rand16() & max;
+    src16 = plane16_ + origin;
+    ref16 = src16 + kStride * kRows;
+    dst16 = ref16 + kStride * kRows;
+    above16 = edge16_ + kBorder;
+    left16 = above16 + kEdgeSize;
+    if (highbd) {
+      src = CONVERT_TO_BYTEPTR(src16);
+      ref = CONVERT_TO_BYTEPTR(ref16);
+      dst = CONVERT_TO_BYTEPTR(dst16);
+      second_pred = CONVERT_TO_BYTEPTR(pred16_);
+      comp_pred = CONVERT_TO_BYTEPTR(comp_pred16_);
+    } else {
+      src = plane_ + origin;
+      ref = src + kStride * kRows;
+      dst = ref + kStride * kRows;
+      second_pred = pred_;
+      comp_pred = comp_pred_;
+    }
+    above = edge_ + kBorder;
+    left = above + kEdgeSize;
+    edge = edge_ + kBorder;
+    edge16 = edge16_ + kBorder;
+  }
+
+  // Returns p + offset, in pixels of the data depth, for pointers that may
+  // come from CONVERT_TO_BYTEPTR().
+  uint8_t *At(uint8_t *p, int offset) const {
+    return highbd ? CONVERT_TO_BYTEPTR(CONVERT_TO_SHORTPTR(p) + offset)
+                  : p + offset;
+  }
+
+  // The runners shared by functions of the same prototype tell them apart by
+  // name.
+  const char *name;
+  int w, h, bd;
+  bool highbd;
+  uint8_t *src, *ref, *dst, *second_pred, *comp_pred;
+  uint16_t *src16, *ref16, *dst16;
+  const uint8_t *above, *left;
+  const uint16_t *above16, *left16;
+  uint8_t *edge;
+  uint16_t *edge16;
+  uint8_t *mask;
+  int32_t *wsrc, *obmc_mask;
+  int16_t *residual, *scan;
+  int32_t *coeff, *qcoeff, *dqcoeff;
+  uint16_t *conv_buf;
+  float *fft_buf;
+  uint8_t *levels;
+  int8_t *coeff_contexts;
+  uint16_t *cdef_in;
+  int32_t *flt0, *flt1, *sgr_tmpbuf;
+  int64_t *stats_m, *stats_h;
+  uint32_t *accum;
+  uint16_t *count;
+  int *xs, *scores;
+  CRC32C crc;
+  YV12_BUFFER_CONFIG frame, frame2;
+  DECLARE_ALIGNED(16, uint8_t, blimit[16]);
+  DECLARE_ALIGNED(16, uint8_t, limit[16]);
+  DECLARE_ALIGNED(16, uint8_t, thresh[16]);
+  DIST_WTD_COMP_PARAMS jcp;
+
+ private:
+  template <typename T>
+  static T *Alloc(int n) {
+    T *const buf = static_cast<T *>(aom_memalign(32, n * sizeof(T)));
+    if (!buf) {
+      fprintf(stderr, "Failed to allocate the buffers.\n");
+      exit(EXIT_FAILURE);
+    }
+    memset(buf, 0, n * sizeof(T));
+    return buf;
+  }
+
+  ACMRandom rnd_;
+  uint8_t *plane_, *pred_, *edge_, *comp_pred_;
+  uint16_t *plane16_, *pred16_, *edge16_, *comp_pred16_, *cdef_in_;
+};
+
+// Calls the function n times. There is one runner per prototype.
+typedef void (*RunFunc)(aom_rtcd_fn_t fn, Context *c, int n);
+
+void RunIntra(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, ptrdiff_t, const uint8_t *, const uint8_t *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->dst, kStride, c->above, c->left);
+}
+
+void RunHighbdIntra(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint16_t *, ptrdiff_t, const uint16_t *, const uint16_t *,
+                     int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->dst16, kStride, c->above16, c->left16, c->bd);
+  }
+}
+
+void RunSad(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef unsigned int (*Fn)(const uint8_t *, int, const uint8_t *, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->src, kStride, c->ref, kStride);
+}
+
+void RunSadAvg(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef unsigned int (*Fn)(const uint8_t *, int, const uint8_t *, int,
+                             const uint8_t *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->src, kStride, c->ref, kStride, c->second_pred);
+  }
+}
+
+void RunDistWtdSadAvg(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef unsigned int (*Fn)(const uint8_t *, int, const uint8_t *, int,
+                             const uint8_t *, const DIST_WTD_COMP_PARAMS *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->src, kStride, c->ref, kStride, c->second_pred, &c->jcp);
+  }
+}
+
+void RunSadX4d(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const uint8_t *, int, const uint8_t *const *, int,
+                     uint32_t *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const uint8_t *const refs[4] = { c->ref, c->ref + 1, c->ref + kStride,
+                                   c->ref + kStride + 1 };
+  uint32_t sads[4];
+  for (int i = 0; i < n; ++i) f(c->src, kStride, refs, kStride, sads);
+}
+
+void RunVariance(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef unsigned int (*Fn)(const uint8_t *, int, const uint8_t *, int,
+                             unsigned int *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  unsigned int sse;
+  for (int i = 0; i < n; ++i) {
+    f(c->src, kStride, c->ref, kStride, &sse);
+  }
+}
+
+void RunSubpelVariance(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef unsigned int (*Fn)(const uint8_t *, int, int, int, const uint8_t *,
+                             int, unsigned int *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  unsigned int sse;
+  for (int i = 0; i < n; ++i) {
+    f(c->src, kStride, 4, 4, c->ref, kStride, &sse);
+  }
+}
+
+void RunSubpelAvgVariance(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef unsigned int (*Fn)(const uint8_t *, int, int, int, const uint8_t *,
+                             int, unsigned int *, const uint8_t *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  unsigned int sse;
+  for (int i = 0; i < n; ++i) {
+    f(c->src, kStride, 4, 4, c->ref, kStride, &sse, c->second_pred);
+  }
+}
+
+void RunDistWtdSubpelAvgVariance(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef unsigned int (*Fn)(const uint8_t *, int, int, int, const uint8_t *,
+                             int, unsigned int *, const uint8_t *,
+                             const DIST_WTD_COMP_PARAMS *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  unsigned int sse;
+  for (int i = 0; i < n; ++i) {
+    f(c->src, kStride, 4, 4, c->ref, kStride, &sse, c->second_pred,
+                 &c->jcp);
+  }
+}
+
+void RunObmcSad(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef unsigned int (*Fn)(const uint8_t *, int, const int32_t *,
+                             const int32_t *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->ref, kStride, c->wsrc, c->obmc_mask);
+  }
+}
+
+void RunObmcVariance(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef unsigned int (*Fn)(const uint8_t *, int, const int32_t *,
+                             const int32_t *, unsigned int *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  unsigned int sse;
+  for (int i = 0; i < n; ++i) {
+    f(c->ref, kStride, c->wsrc, c->obmc_mask, &sse);
+  }
+}
+
+void RunObmcSubpelVariance(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef unsigned int (*Fn)(const uint8_t *, int, int, int, const int32_t *,
+                             const int32_t *, unsigned int *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  unsigned int sse;
+  for (int i = 0; i < n; ++i) {
+    f(c->ref, kStride, 4, 4, c->wsrc, c->obmc_mask, &sse);
+  }
+}
+
+void RunMaskedSad(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef unsigned int (*Fn)(const uint8_t *, int, const uint8_t *, int,
+                             const uint8_t *, const uint8_t *, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->src, kStride, c->ref, kStride, c->second_pred, c->mask,
+                 c->w, 0);
+  }
+}
+
+void RunMaskedSubpelVariance(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef unsigned int (*Fn)(const uint8_t *, int, int, int, const uint8_t *,
+                             int, const uint8_t *, const uint8_t *, int, int,
+                             unsigned int *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  unsigned int sse;
+  for (int i = 0; i < n; ++i) {
+    f(c->src, kStride, 4, 4, c->ref, kStride, c->second_pred,
+                 c->mask, c->w, 0, &sse);
+  }
+}
+
+void RunLoopFilter(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, int, const uint8_t *, const uint8_t *,
+                     const uint8_t *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->dst, kStride, c->blimit, c->limit, c->thresh);
+  }
+}
+
+void RunLoopFilterDual(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, int, const uint8_t *, const uint8_t *,
+                     const uint8_t *, const uint8_t *, const uint8_t *,
+                     const uint8_t *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->dst, kStride, c->blimit, c->limit, c->thresh, c->blimit, c->limit,
+      c->thresh);
+  }
+}
+
+void RunHighbdLoopFilter(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint16_t *, int, const uint8_t *, const uint8_t *,
+                     const uint8_t *, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->dst16, kStride, c->blimit, c->limit, c->thresh, c->bd);
+  }
+}
+
+void RunHighbdLoopFilterDual(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint16_t *, int, const uint8_t *, const uint8_t *,
+                     const uint8_t *, const uint8_t *, const uint8_t *,
+                     const uint8_t *, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->dst16, kStride, c->blimit, c->limit, c->thresh, c->blimit, c->limit,
+      c->thresh, c->bd);
+  }
+}
+
+void RunFwdTxfm2d(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const int16_t *, int32_t *, int, TX_TYPE, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->residual, c->coeff, 64, DCT_DCT, c->bd);
+}
+
+void RunInvTxfm2dAdd(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const int32_t *, uint16_t *, int, TX_TYPE, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->coeff, c->dst16, kStride, DCT_DCT, c->bd);
+}
+
+void RunConvolve(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const uint8_t *, ptrdiff_t, uint8_t *, ptrdiff_t,
+                     const int16_t *, int, const int16_t *, int, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->src, kStride, c->dst, kStride, kFilter, 16, kFilter, 16, c->w, c->h);
+  }
+}
+
+void RunHighbdConvolve(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const uint8_t *, ptrdiff_t, uint8_t *, ptrdiff_t,
+                     const int16_t *, int, const int16_t *, int, int, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->src, kStride, c->dst, kStride, kFilter, 16, kFilter, 16, c->w, c->h,
+      c->bd);
+  }
+}
+
+void RunSubpelVarianceX4d(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const uint8_t *const *, int, const int *, const int *,
+                     const uint8_t *, int, unsigned int *, unsigned int *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const uint8_t *const refs[4] = { c->ref, c->ref + 1, c->ref + kStride,
+                                   c->ref + kStride + 1 };
+  const int xoffsets[4] = { 0, 4, 2, 6 };
+  const int yoffsets[4] = { 4, 0, 6, 2 };
+  unsigned int var[4], sse[4];
+  for (int i = 0; i < n; ++i) {
+    f(refs, kStride, xoffsets, yoffsets, c->src, kStride, var, sse);
+  }
+}
+
+void RunGetVar(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const uint8_t *, int, const uint8_t *, int,
+                     unsigned int *, int *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  unsigned int sse;
+  int sum;
+  for (int i = 0; i < n; ++i) f(c->src, kStride, c->ref, kStride, &sse, &sum);
+}
+
+void RunGet4x4SseCs(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef unsigned int (*Fn)(const unsigned char *, int,
+                             const unsigned char *, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->src, kStride, c->ref, kStride);
+}
+
+void RunSadWxH(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef unsigned int (*Fn)(const uint8_t *, int, const uint8_t *, int, int,
+                             int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->src, kStride, c->ref, kStride, c->w, c->h);
+}
+
+void RunSse(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef int64_t (*Fn)(const uint8_t *, int, const uint8_t *, int, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->src, kStride, c->ref, kStride, c->w, c->h);
+}
+
+void RunAvg(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef unsigned int (*Fn)(const uint8_t *, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->src, kStride);
+}
+
+void RunMinMax(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const uint8_t *, int, const uint8_t *, int, int *, int *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  int min, max;
+  for (int i = 0; i < n; ++i) f(c->src, kStride, c->ref, kStride, &min, &max);
+}
+
+void RunIntProRow(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(int16_t *, const uint8_t *, const int, const int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->residual, c->src, kStride, 32);
+}
+
+void RunIntProCol(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef int16_t (*Fn)(const uint8_t *, const int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->src, 64);
+}
+
+void RunVectorVar(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef int (*Fn)(const int16_t *, const int16_t *, const int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  // 64 values, as for a 64x64 block.
+  for (int i = 0; i < n; ++i) f(c->residual, c->residual + 64, 4);
+}
+
+void RunGetMbSs(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef unsigned int (*Fn)(const int16_t *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->residual);
+}
+
+void RunSumSquares(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef uint64_t (*Fn)(const int16_t *, uint32_t);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->residual, c->w * c->h);
+}
+
+void RunSumSquares2d(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef uint64_t (*Fn)(const int16_t *, int, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->residual, 64, c->w, c->h);
+}
+
+void RunSatd(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef int (*Fn)(const tran_low_t *, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->coeff, c->w * c->h);
+}
+
+void RunBlockError(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef int64_t (*Fn)(const tran_low_t *, const tran_low_t *, intptr_t,
+                        int64_t *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  int64_t ssz;
+  for (int i = 0; i < n; ++i) f(c->coeff, c->dqcoeff, c->w * c->h, &ssz);
+}
+
+void RunHighbdBlockError(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef int64_t (*Fn)(const tran_low_t *, const tran_low_t *, intptr_t,
+                        int64_t *, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  int64_t ssz;
+  for (int i = 0; i < n; ++i) {
+    f(c->coeff, c->dqcoeff, c->w * c->h, &ssz, c->bd);
+  }
+}
+
+void RunSubtractBlock(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(int, int, int16_t *, ptrdiff_t, const uint8_t *,
+                     ptrdiff_t, const uint8_t *, ptrdiff_t);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->h, c->w, c->residual, 64, c->src, kStride, c->ref, kStride);
+  }
+}
+
+void RunHighbdSubtractBlock(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(int, int, int16_t *, ptrdiff_t, const uint8_t *,
+                     ptrdiff_t, const uint8_t *, ptrdiff_t, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->h, c->w, c->residual, 64, c->src, kStride, c->ref, kStride, c->bd);
+  }
+}
+
+void RunCompAvgPred(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, const uint8_t *, int, int, const uint8_t *,
+                     int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->comp_pred, c->second_pred, c->w, c->h, c->ref, kStride);
+  }
+}
+
+void RunDistWtdCompAvgPred(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, const uint8_t *, int, int, const uint8_t *,
+                     int, const DIST_WTD_COMP_PARAMS *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->comp_pred, c->second_pred, c->w, c->h, c->ref, kStride, &c->jcp);
+  }
+}
+
+void RunCompMaskPred(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, const uint8_t *, int, int, const uint8_t *,
+                     int, const uint8_t *, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->comp_pred, c->second_pred, c->w, c->h, c->ref, kStride, c->mask, c->w,
+      0);
+  }
+}
+
+void RunBlendMask(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, uint32_t, const uint8_t *, uint32_t,
+                     const uint8_t *, uint32_t, const uint8_t *, uint32_t, int,
+                     int, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->dst, kStride, c->src, kStride, c->ref, kStride, c->mask, c->w, c->w,
+      c->h, 0, 0);
+  }
+}
+
+void RunHighbdBlendMask(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, uint32_t, const uint8_t *, uint32_t,
+                     const uint8_t *, uint32_t, const uint8_t *, uint32_t, int,
+                     int, int, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->dst, kStride, c->src, kStride, c->ref, kStride, c->mask, c->w, c->w,
+      c->h, 0, 0, c->bd);
+  }
+}
+
+void RunBlendMaskD16(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, uint32_t, const CONV_BUF_TYPE *, uint32_t,
+                     const CONV_BUF_TYPE *, uint32_t, const uint8_t *,
+                     uint32_t, int, int, int, int, ConvolveParams *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  ConvolveParams conv_params = get_conv_params_no_round(0, 0, NULL, 0, 1, 8);
+  for (int i = 0; i < n; ++i) {
+    f(c->dst, kStride, c->src16, kStride, c->ref16, kStride, c->mask, c->w,
+      c->w, c->h, 0, 0, &conv_params);
+  }
+}
+
+void RunHighbdBlendMaskD16(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, uint32_t, const CONV_BUF_TYPE *, uint32_t,
+                     const CONV_BUF_TYPE *, uint32_t, const uint8_t *,
+                     uint32_t, int, int, int, int, ConvolveParams *,
+                     const int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  ConvolveParams conv_params =
+      get_conv_params_no_round(0, 0, NULL, 0, 1, c->bd);
+  for (int i = 0; i < n; ++i) {
+    f(c->dst, kStride, c->src16, kStride, c->ref16, kStride, c->mask, c->w,
+      c->w, c->h, 0, 0, &conv_params, c->bd);
+  }
+}
+
+// The OBMC blends, with a one dimensional mask.
+void RunBlendMask1d(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, uint32_t, const uint8_t *, uint32_t,
+                     const uint8_t *, uint32_t, const uint8_t *, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->dst, kStride, c->src, kStride, c->ref, kStride, c->mask, c->w, c->h);
+  }
+}
+
+void RunHighbdBlendMask1d(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, uint32_t, const uint8_t *, uint32_t,
+                     const uint8_t *, uint32_t, const uint8_t *, int, int,
+                     int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->dst, kStride, c->src, kStride, c->ref, kStride, c->mask, c->w, c->h,
+      c->bd);
+  }
+}
+
+void RunDiffwtdMask(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, DIFFWTD_MASK_TYPE, const uint8_t *, int,
+                     const uint8_t *, int, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->mask, DIFFWTD_38, c->src, kStride, c->ref, kStride, c->h, c->w);
+  }
+}
+
+void RunHighbdDiffwtdMask(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, DIFFWTD_MASK_TYPE, const uint8_t *, int,
+                     const uint8_t *, int, int, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->mask, DIFFWTD_38, c->src, kStride, c->ref, kStride, c->h, c->w,
+      c->bd);
+  }
+}
+
+void RunDiffwtdMaskD16(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, DIFFWTD_MASK_TYPE, const CONV_BUF_TYPE *, int,
+                     const CONV_BUF_TYPE *, int, int, int, ConvolveParams *,
+                     int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  ConvolveParams conv_params =
+      get_conv_params_no_round(0, 0, NULL, 0, 1, c->bd);
+  for (int i = 0; i < n; ++i) {
+    f(c->mask, DIFFWTD_38, c->src16, kStride, c->ref16, kStride, c->h, c->w,
+      &conv_params, c->bd);
+  }
+}
+
+// Quantizes the coefficients of a w x h transform, with the identity scan.
+void RunQuantize(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const tran_low_t *, intptr_t, const int16_t *,
+                     const int16_t *, const int16_t *, const int16_t *,
+                     tran_low_t *, tran_low_t *, const int16_t *, uint16_t *,
+                     const int16_t *, const int16_t *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const int16_t zbin[2] = { 21, 25 };
+  const int16_t round[2] = { 16, 20 };
+  const int16_t quant[2] = { 23302, 19484 };
+  const int16_t quant_shift[2] = { 16384, 16384 };
+  const int16_t dequant[2] = { 32, 40 };
+  uint16_t eob;
+  for (int i = 0; i < n; ++i) {
+    f(c->coeff, c->w * c->h, zbin, round, quant, quant_shift, c->qcoeff,
+      c->dqcoeff, dequant, &eob, c->scan, c->scan);
+  }
+}
+
+void RunQuantizeLogScale(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const tran_low_t *, intptr_t, const int16_t *,
+                     const int16_t *, const int16_t *, const int16_t *,
+                     tran_low_t *, tran_low_t *, const int16_t *, uint16_t *,
+                     const int16_t *, const int16_t *, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const int16_t zbin[2] = { 21, 25 };
+  const int16_t round[2] = { 16, 20 };
+  const int16_t quant[2] = { 23302, 19484 };
+  const int16_t quant_shift[2] = { 16384, 16384 };
+  const int16_t dequant[2] = { 32, 40 };
+  const int log_scale = (c->w * c->h > 256) + (c->w * c->h > 1024);
+  uint16_t eob;
+  for (int i = 0; i < n; ++i) {
+    f(c->coeff, c->w * c->h, zbin, round, quant, quant_shift, c->qcoeff,
+      c->dqcoeff, dequant, &eob, c->scan, c->scan, log_scale);
+  }
+}
+
+void RunFdct(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const int16_t *, tran_low_t *, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->residual, c->coeff, 64);
+}
+
+void RunHadamard(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const int16_t *, ptrdiff_t, tran_low_t *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->residual, 64, c->coeff);
+}
+
+TX_SIZE TxSize(int w, int h) {
+  for (int tx_size = 0; tx_size < TX_SIZES_ALL; ++tx_size) {
+    if (tx_size_wide[tx_size] == w && tx_size_high[tx_size] == h) {
+      return static_cast<TX_SIZE>(tx_size);
+    }
+  }
+  return TX_32X32;
+}
+
+TxfmParam MakeTxfmParam(const Context *c) {
+  TxfmParam param;
+  param.tx_type = DCT_DCT;
+  param.tx_size = TxSize(c->w, c->h);
+  param.lossless = 0;
+  param.bd = c->bd;
+  param.is_hbd = c->highbd;
+  param.tx_set_type = EXT_TX_SET_DCTONLY;
+  param.eob = AOMMIN(c->w, 32) * AOMMIN(c->h, 32);
+  return param;
+}
+
+void RunFwdTxfm(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const int16_t *, tran_low_t *, int, TxfmParam *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  TxfmParam param = MakeTxfmParam(c);
+  for (int i = 0; i < n; ++i) f(c->residual, c->coeff, 64, &param);
+}
+
+void RunInvTxfmAdd(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const tran_low_t *, uint8_t *, int, const TxfmParam *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const TxfmParam param = MakeTxfmParam(c);
+  for (int i = 0; i < n; ++i) f(c->coeff, c->dst, kStride, &param);
+}
+
+void RunIwhtAdd(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const tran_low_t *, uint8_t *, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->coeff, c->dst, kStride, c->bd);
+}
+
+void RunRoundShiftArray(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(int32_t *, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->coeff, c->w * c->h, 1);
+}
+
+void RunTxbInitLevels(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const tran_low_t *const, const int, const int,
+                     uint8_t *const);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->coeff, c->w, c->h, c->levels);
+}
+
+void RunGetNzMapContexts(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const uint8_t *const, const int16_t *const,
+                     const uint16_t, const TX_SIZE, const TX_CLASS,
+                     int8_t *const);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const TX_SIZE tx_size = TxSize(c->w, c->h);
+  const int16_t *const scan = av1_scan_orders[tx_size][DCT_DCT].scan;
+  for (int i = 0; i < n; ++i) {
+    f(c->levels, scan, c->w * c->h, tx_size, TX_CLASS_2D, c->coeff_contexts);
+  }
+}
+
+void RunFft(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const float *, float *, float *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  float *const buf = c->fft_buf;
+  for (int i = 0; i < n; ++i) f(buf, buf + 2 * 32 * 32, buf + 4 * 32 * 32);
+}
+
+void RunHorverCorrelation(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const int16_t *, int, int, int, float *, float *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  float hcorr, vcorr;
+  for (int i = 0; i < n; ++i) f(c->residual, 64, c->w, c->h, &hcorr, &vcorr);
+}
+
+void RunWedgeSse(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef uint64_t (*Fn)(const int16_t *, const int16_t *, const uint8_t *,
+                         int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->residual, c->residual + 64 * 64, c->mask, c->w * c->h);
+  }
+}
+
+void RunWedgeSign(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef int (*Fn)(const int16_t *, const uint8_t *, int, int64_t);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->residual, c->mask, c->w * c->h, 0);
+}
+
+void RunWedgeDeltaSquares(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(int16_t *, const int16_t *, const int16_t *, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  int16_t *const d = c->residual + 64 * 64;
+  for (int i = 0; i < n; ++i) {
+    f(d, c->residual, c->residual + 32 * 32, c->w * c->h);
+  }
+}
+
+void RunFilterIntraEdge(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->edge, 64, 3);
+}
+
+void RunHighbdFilterIntraEdge(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint16_t *, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  // The strength for the filter, and the bit depth for the upsampling.
+  const bool upsample = strstr(c->name, "upsample") != NULL;
+  const int sz = upsample ? 16 : 64;
+  const int param = upsample ? c->bd : 3;
+  for (int i = 0; i < n; ++i) f(c->edge16, sz, param);
+}
+
+void RunUpsampleIntraEdge(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->edge, 16);
+}
+
+// The directional predictors, with the angles of D67 for z1, D135 for z2 and
+// D203 for z3.
+void RunDrPredictionZ13(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, ptrdiff_t, int, int, const uint8_t *,
+                     const uint8_t *, int, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const bool z1 = strstr(c->name, "z1") != NULL;
+  const int dx = z1 ? 27 : 1;
+  const int dy = z1 ? 1 : 151;
+  for (int i = 0; i < n; ++i) {
+    f(c->dst, kStride, c->w, c->h, c->above, c->left, 0, dx, dy);
+  }
+}
+
+void RunDrPredictionZ2(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, ptrdiff_t, int, int, const uint8_t *,
+                     const uint8_t *, int, int, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->dst, kStride, c->w, c->h, c->above, c->left, 0, 0, 64, 64);
+  }
+}
+
+void RunHighbdDrPredictionZ13(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint16_t *, ptrdiff_t, int, int, const uint16_t *,
+                     const uint16_t *, int, int, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const bool z1 = strstr(c->name, "z1") != NULL;
+  const int dx = z1 ? 27 : 1;
+  const int dy = z1 ? 1 : 151;
+  for (int i = 0; i < n; ++i) {
+    f(c->dst16, kStride, c->w, c->h, c->above16, c->left16, 0, dx, dy, c->bd);
+  }
+}
+
+void RunHighbdDrPredictionZ2(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint16_t *, ptrdiff_t, int, int, const uint16_t *,
+                     const uint16_t *, int, int, int, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->dst16, kStride, c->w, c->h, c->above16, c->left16, 0, 0, 64, 64,
+      c->bd);
+  }
+}
+
+void RunFilterIntraPredictor(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, ptrdiff_t, TX_SIZE, const uint8_t *,
+                     const uint8_t *, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const TX_SIZE tx_size = TxSize(c->w, c->h);
+  for (int i = 0; i < n; ++i) {
+    f(c->dst, kStride, tx_size, c->above, c->left, FILTER_DC_PRED);
+  }
+}
+
+void RunCdefFindDir(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef int (*Fn)(const uint16_t *, int, int32_t *, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  int32_t var;
+  for (int i = 0; i < n; ++i) f(c->src16, kStride, &var, c->bd - 8);
+}
+
+// Filters an 8x8 block of 8-bit pixels.
+void RunCdefFilterBlock(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, uint16_t *, int, const uint16_t *, int, int,
+                     int, int, int, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->dst, NULL, kStride, c->cdef_in, 4, 2, 2, 6, 6, BLOCK_8X8, 0);
+  }
+}
+
+void RunCopyRect8To16(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint16_t *, int, const uint8_t *, int, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->cdef_in, CDEF_BSTRIDE, c->src, kStride, c->h, c->w);
+  }
+}
+
+void RunCopyRect16To16(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint16_t *, int, const uint16_t *, int, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->cdef_in, CDEF_BSTRIDE, c->src16, kStride, c->h, c->w);
+  }
+}
+
+// The compound convolutions write to conv_buf, the others to dst.
+ConvolveParams MakeConvolveParams(Context *c) {
+  if (strstr(c->name, "dist_wtd")) {
+    return get_conv_params_no_round(0, 0, c->conv_buf, kMaxBlockSize, 1,
+                                    c->bd);
+  }
+  return get_conv_params(0, 0, c->bd);
+}
+
+void RunConvolve2d(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const uint8_t *, int, uint8_t *, int, int, int,
+                     const InterpFilterParams *, const InterpFilterParams *,
+                     const int, const int, ConvolveParams *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const InterpFilterParams *const filter_x =
+      av1_get_interp_filter_params_with_block_size(EIGHTTAP_REGULAR, c->w);
+  const InterpFilterParams *const filter_y =
+      av1_get_interp_filter_params_with_block_size(EIGHTTAP_REGULAR, c->h);
+  ConvolveParams conv_params = MakeConvolveParams(c);
+  for (int i = 0; i < n; ++i) {
+    f(c->src, kStride, c->dst, kStride, c->w, c->h, filter_x, filter_y, 8, 8,
+      &conv_params);
+  }
+}
+
+void RunHighbdConvolve2d(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const uint16_t *, int, uint16_t *, int, int, int,
+                     const InterpFilterParams *, const InterpFilterParams *,
+                     const int, const int, ConvolveParams *, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const InterpFilterParams *const filter_x =
+      av1_get_interp_filter_params_with_block_size(EIGHTTAP_REGULAR, c->w);
+  const InterpFilterParams *const filter_y =
+      av1_get_interp_filter_params_with_block_size(EIGHTTAP_REGULAR, c->h);
+  ConvolveParams conv_params = MakeConvolveParams(c);
+  for (int i = 0; i < n; ++i) {
+    f(c->src16, kStride, c->dst16, kStride, c->w, c->h, filter_x, filter_y, 8,
+      8, &conv_params, c->bd);
+  }
+}
+
+// Scales by 2:1 in both directions.
+void RunConvolve2dScale(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const uint8_t *, int, uint8_t *, int, int, int,
+                     const InterpFilterParams *, const InterpFilterParams *,
+                     const int, const int, const int, const int,
+                     ConvolveParams *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const InterpFilterParams *const filter_x =
+      av1_get_interp_filter_params_with_block_size(EIGHTTAP_REGULAR, c->w);
+  const InterpFilterParams *const filter_y =
+      av1_get_interp_filter_params_with_block_size(EIGHTTAP_REGULAR, c->h);
+  ConvolveParams conv_params = get_conv_params(0, 0, c->bd);
+  for (int i = 0; i < n; ++i) {
+    f(c->src, kStride, c->dst, kStride, c->w, c->h, filter_x, filter_y, 0,
+      2 * SCALE_SUBPEL_SHIFTS, 0, 2 * SCALE_SUBPEL_SHIFTS, &conv_params);
+  }
+}
+
+void RunHighbdConvolve2dScale(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const uint16_t *, int, uint16_t *, int, int, int,
+                     const InterpFilterParams *, const InterpFilterParams *,
+                     const int, const int, const int, const int,
+                     ConvolveParams *, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const InterpFilterParams *const filter_x =
+      av1_get_interp_filter_params_with_block_size(EIGHTTAP_REGULAR, c->w);
+  const InterpFilterParams *const filter_y =
+      av1_get_interp_filter_params_with_block_size(EIGHTTAP_REGULAR, c->h);
+  ConvolveParams conv_params = get_conv_params(0, 0, c->bd);
+  for (int i = 0; i < n; ++i) {
+    f(c->src16, kStride, c->dst16, kStride, c->w, c->h, filter_x, filter_y, 0,
+      2 * SCALE_SUBPEL_SHIFTS, 0, 2 * SCALE_SUBPEL_SHIFTS, &conv_params,
+      c->bd);
+  }
+}
+
+// Upscales by 4:3, as the super-resolution does.
+const int kSuperresStep = (1 << RS_SCALE_SUBPEL_BITS) * 3 / 4;
+
+void RunConvolveHorizRs(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const uint8_t *, int, uint8_t *, int, int, int,
+                     const int16_t *, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->src, kStride, c->dst, kStride, c->w, c->h,
+      &av1_resize_filter_normative[0][0], 0, kSuperresStep);
+  }
+}
+
+void RunHighbdConvolveHorizRs(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const uint16_t *, int, uint16_t *, int, int, int,
+                     const int16_t *, int, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->src16, kStride, c->dst16, kStride, c->w, c->h,
+      &av1_resize_filter_normative[0][0], 0, kSuperresStep, c->bd);
+  }
+}
+
+void RunWienerConvolve(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const uint8_t *, ptrdiff_t, uint8_t *, ptrdiff_t,
+                     const int16_t *, int, const int16_t *, int, int, int,
+                     const ConvolveParams *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const ConvolveParams conv_params = get_conv_params_wiener(c->bd);
+  for (int i = 0; i < n; ++i) {
+    f(c->src, kStride, c->dst, kStride, kFilter, 16, kFilter, 16, c->w, c->h,
+      &conv_params);
+  }
+}
+
+void RunHighbdWienerConvolve(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const uint8_t *, ptrdiff_t, uint8_t *, ptrdiff_t,
+                     const int16_t *, int, const int16_t *, int, int, int,
+                     const ConvolveParams *, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const ConvolveParams conv_params = get_conv_params_wiener(c->bd);
+  for (int i = 0; i < n; ++i) {
+    f(c->src, kStride, c->dst, kStride, kFilter, 16, kFilter, 16, c->w, c->h,
+      &conv_params, c->bd);
+  }
+}
+
+// Warps with the identity model, over a frame that starts at the block.
+const int32_t kIdentityWarp[6] = { 0, 0, 1 << WARPEDMODEL_PREC_BITS, 0, 0,
+                                   1 << WARPEDMODEL_PREC_BITS };
+
+void RunWarpAffine(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const int32_t *, const uint8_t *, int, int, int,
+                     uint8_t *, int, int, int, int, int, int, int,
+                     ConvolveParams *, int16_t, int16_t, int16_t, int16_t);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  ConvolveParams conv_params = get_conv_params(0, 0, c->bd);
+  for (int i = 0; i < n; ++i) {
+    f(kIdentityWarp, c->ref, kMaxBlockSize, kMaxBlockSize, kStride, c->dst, 0,
+      0, c->w, c->h, kStride, 0, 0, &conv_params, 0, 0, 0, 0);
+  }
+}
+
+void RunHighbdWarpAffine(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const int32_t *, const uint16_t *, int, int, int,
+                     uint16_t *, int, int, int, int, int, int, int, int,
+                     ConvolveParams *, int16_t, int16_t, int16_t, int16_t);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  ConvolveParams conv_params = get_conv_params(0, 0, c->bd);
+  for (int i = 0; i < n; ++i) {
+    f(kIdentityWarp, c->ref16, kMaxBlockSize, kMaxBlockSize, kStride, c->dst16,
+      0, 0, c->w, c->h, kStride, 0, 0, c->bd, &conv_params, 0, 0, 0, 0);
+  }
+}
+
+// Collects the Wiener filter statistics of a 64x64 area.
+void RunComputeStats(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(int, const uint8_t *, const uint8_t *, int, int, int,
+                     int, int, int, int64_t *, int64_t *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(WIENER_WIN, c->ref, c->src, 0, 64, 0, 64, kStride, kStride, c->stats_m,
+      c->stats_h);
+  }
+}
+
+void RunHighbdComputeStats(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(int, const uint8_t *, const uint8_t *, int, int, int,
+                     int, int, int, int64_t *, int64_t *, aom_bit_depth_t);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(WIENER_WIN, c->ref, c->src, 0, 64, 0, 64, kStride, kStride, c->stats_m,
+      c->stats_h, static_cast<aom_bit_depth_t>(c->bd));
+  }
+}
+
+void RunSelfguidedRestoration(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef int (*Fn)(const uint8_t *, int, int, int, int32_t *, int32_t *, int,
+                    int, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->src, c->w, c->h, kStride, c->flt0, c->flt1, c->w, 0, c->bd,
+      c->highbd);
+  }
+}
+
+void RunApplySelfguidedRestoration(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const uint8_t *, int, int, int, int, const int *,
+                     uint8_t *, int, int32_t *, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const int xqd[2] = { -32, 31 };
+  for (int i = 0; i < n; ++i) {
+    f(c->src, c->w, c->h, kStride, 0, xqd, c->dst, kStride, c->sgr_tmpbuf,
+      c->bd, c->highbd);
+  }
+}
+
+void RunPixelProjError(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef int64_t (*Fn)(const uint8_t *, int, int, int, const uint8_t *, int,
+                        int32_t *, int, int32_t *, int, int *,
+                        const sgr_params_type *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  int xq[2] = { -32, 31 };
+  for (int i = 0; i < n; ++i) {
+    f(c->src, c->w, c->h, kStride, c->ref, kStride, c->flt0, c->w, c->flt1,
+      c->w, xq, &sgr_params[0]);
+  }
+}
+
+// Filters a 32x32 block of 4:2:0 video.
+void RunApplyTemporalFilter(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const uint8_t *, int, const uint8_t *, int,
+                     const uint8_t *, const uint8_t *, int, const uint8_t *,
+                     const uint8_t *, int, unsigned int, unsigned int, int,
+                     int, int, const int *, int, unsigned int *, uint16_t *,
+                     unsigned int *, uint16_t *, unsigned int *, uint16_t *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const int blk_fw[4] = { 2, 2, 2, 2 };
+  uint8_t *const pred = c->second_pred;
+  for (int i = 0; i < n; ++i) {
+    f(c->src, kStride, pred, 32, c->At(c->src, 32), c->At(c->src, 48), kStride,
+      c->At(pred, 32 * 32), c->At(pred, 32 * 32 + 16 * 16), 16, 32, 32, 1, 1,
+      6, blk_fw, 0, c->accum, c->count, c->accum + 32 * 32,
+      c->count + 32 * 32, c->accum + 2 * 32 * 32, c->count + 2 * 32 * 32);
+  }
+}
+
+void RunTemporalFilterApply(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(uint8_t *, unsigned int, uint8_t *, unsigned int,
+                     unsigned int, int, const int *, int, unsigned int *,
+                     uint16_t *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const int blk_fw[4] = { 2, 2, 2, 2 };
+  for (int i = 0; i < n; ++i) {
+    f(c->src, kStride, c->second_pred, 32, 32, 6, blk_fw, 0, c->accum,
+      c->count);
+  }
+}
+
+void RunCrossCorrelation(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef double (*Fn)(unsigned char *, int, int, int, unsigned char *, int,
+                       int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) {
+    f(c->src, kStride, 16, 16, c->ref, kStride, 17, 15);
+  }
+}
+
+void RunFast9DetectRow(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef int (*Fn)(const unsigned char *, int, int, int, int *, int *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->src, kStride, 256, 20, c->xs, c->scores);
+}
+
+void RunCrc32c(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef uint32_t (*Fn)(void *, uint8_t *, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(&c->crc, c->src, c->w * c->h);
+}
+
+void RunScaleLine(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const unsigned char *, unsigned int, unsigned char *,
+                     unsigned int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->src, 240, c->dst, 120);
+}
+
+void RunScaleBand(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(unsigned char *, int, unsigned char *, int,
+                     unsigned int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(c->src, kStride, c->dst, kStride, 240);
+}
+
+void RunExtendFrameY(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(YV12_BUFFER_CONFIG *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(&c->frame);
+}
+
+void RunExtendFrame(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(YV12_BUFFER_CONFIG *, const int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(&c->frame, 3);
+}
+
+void RunCopyFrame(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const YV12_BUFFER_CONFIG *, YV12_BUFFER_CONFIG *,
+                     const int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(&c->frame, &c->frame2, 3);
+}
+
+void RunCopyPlane(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const YV12_BUFFER_CONFIG *, YV12_BUFFER_CONFIG *);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  for (int i = 0; i < n; ++i) f(&c->frame, &c->frame2);
+}
+
+// Copies the top left quarter of the plane named by the last letter.
+void RunPartialCopy(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const YV12_BUFFER_CONFIG *, int, int, int, int,
+                     YV12_BUFFER_CONFIG *, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const int ss = c->name[strlen(c->name) - 1] != 'y';
+  const int w = (kFrameWidth / 2) >> ss;
+  const int h = (kFrameHeight / 2) >> ss;
+  for (int i = 0; i < n; ++i) f(&c->frame, 0, w, 0, h, &c->frame2, 0, 0);
+}
+
+void RunPartialColocCopy(aom_rtcd_fn_t fn, Context *c, int n) {
+  typedef void (*Fn)(const YV12_BUFFER_CONFIG *, YV12_BUFFER_CONFIG *, int,
+                     int, int, int);
+  const Fn f = reinterpret_cast<Fn>(fn);
+  const int ss = c->name[strlen(c->name) - 1] != 'y';
+  const int w = (kFrameWidth / 2) >> ss;
+  const int h = (kFrameHeight / 2) >> ss;
+  for (int i = 0; i < n; ++i) f(&c->frame, &c->frame2, 0, w, 0, h);
+}
+
+enum SizeMode {
+  kSizeFromName,         // The name holds the block size, e.g. aom_sad16x8.
+  kSizeFromNameOr32x32,  // As kSizeFromName, or 32x32 when it does not.
+  kWidthFromName,        // The name holds the width, e.g. aom_sad16xh, and
+                         // the height is a parameter, 32 here.
+  kSize32x32,            // The block size is a parameter, and 32x32 is
+                         // measured.
+  kSizeNone,             // The function does not work on a block.
+};
+
+struct Prototype {
+  // Return and parameter types, as made by Signature().
+  const char *signature;
+  SizeMode size_mode;
+  RunFunc run;
+};
+
+const Prototype kPrototypes[] = {
+  { "void(uint8_t*,ptrdiff_t,const uint8_t*,const uint8_t*)", kSizeFromName,
+    RunIntra },
+  { "void(uint16_t*,ptrdiff_t,const uint16_t*,const uint16_t*,int)",
+    kSizeFromName, RunHighbdIntra },
+  { "unsigned int(const uint8_t*,int,const uint8_t*,int)", kSizeFromName,
+    RunSad },
+  { "unsigned int(const uint8_t*,int,const uint8_t*,int,const uint8_t*)",
+    kSizeFromName, RunSadAvg },
+  { "unsigned int(const uint8_t*,int,const uint8_t*,int,const uint8_t*,"
+    "const DIST_WTD_COMP_PARAMS*)",
+    kSizeFromName, RunDistWtdSadAvg },
+  { "void(const uint8_t*,int,const uint8_t*const*,int,unsigned int*)",
+    kSizeFromName, RunSadX4d },
+  { "unsigned int(const uint8_t*,int,const uint8_t*,int,unsigned int*)",
+    kSizeFromName, RunVariance },
+  { "unsigned int(const uint8_t*,int,int,int,const uint8_t*,int,"
+    "unsigned int*)",
+    kSizeFromName, RunSubpelVariance },
+  { "unsigned int(const uint8_t*,int,int,int,const uint8_t*,int,"
+    "unsigned int*,const uint8_t*)",
+    kSizeFromName, RunSubpelAvgVariance },
+  { "unsigned int(const uint8_t*,int,int,int,const uint8_t*,int,"
+    "unsigned int*,const uint8_t*,const DIST_WTD_COMP_PARAMS*)",
+    kSizeFromName, RunDistWtdSubpelAvgVariance },
+  { "unsigned int(const uint8_t*,int,const int32_t*,const int32_t*)",
+    kSizeFromName, RunObmcSad },
+  { "unsigned int(const uint8_t*,int,const int32_t*,const int32_t*,"
+    "unsigned int*)",
+    kSizeFromName, RunObmcVariance },
+  { "unsigned int(const uint8_t*,int,int,int,const int32_t*,const int32_t*,"
+    "unsigned int*)",
+    kSizeFromName, RunObmcSubpelVariance },
+  { "unsigned int(const uint8_t*,int,const uint8_t*,int,const uint8_t*,"
+    "const uint8_t*,int,int)",
+    kSizeFromName, RunMaskedSad },
+  { "unsigned int(const uint8_t*,int,int,int,const uint8_t*,int,"
+    "const uint8_t*,const uint8_t*,int,int,unsigned int*)",
+    kSizeFromName, RunMaskedSubpelVariance },
+  { "void(uint8_t*,int,const uint8_t*,const uint8_t*,const uint8_t*)",
+    kSizeNone, RunLoopFilter },
+  { "void(uint8_t*,int,const uint8_t*,const uint8_t*,const uint8_t*,"
+    "const uint8_t*,const uint8_t*,const uint8_t*)",
+    kSizeNone, RunLoopFilterDual },
+  { "void(uint16_t*,int,const uint8_t*,const uint8_t*,const uint8_t*,int)",
+    kSizeNone, RunHighbdLoopFilter },
+  { "void(uint16_t*,int,const uint8_t*,const uint8_t*,const uint8_t*,"
+    "const uint8_t*,const uint8_t*,const uint8_t*,int)",
+    kSizeNone, RunHighbdLoopFilterDual },
+  { "void(const int16_t*,int32_t*,int,TX_TYPE,int)", kSizeFromName,
+    RunFwdTxfm2d },
+  { "void(const int32_t*,uint16_t*,int,TX_TYPE,int)", kSizeFromName,
+    RunInvTxfm2dAdd },
+  { "void(const uint8_t*,ptrdiff_t,uint8_t*,ptrdiff_t,const int16_t*,int,"
+    "const int16_t*,int,int,int)",
+    kSize32x32, RunConvolve },
+  { "void(const uint8_t*,ptrdiff_t,uint8_t*,ptrdiff_t,const int16_t*,int,"
+    "const int16_t*,int,int,int,int)",
+    kSize32x32, RunHighbdConvolve },
+  { "void(const uint8_t*const*,int,const int*,const int*,const uint8_t*,int,"
+    "unsigned int*,unsigned int*)",
+    kSizeFromName, RunSubpelVarianceX4d },
+  { "void(const uint8_t*,int,const uint8_t*,int,unsigned int*,int*)",
+    kSizeFromName, RunGetVar },
+  { "unsigned int(const unsigned char*,int,const unsigned char*,int)",
+    kSizeFromName, RunGet4x4SseCs },
+  { "unsigned int(const uint8_t*,int,const uint8_t*,int,int,int)",
+    kWidthFromName, RunSadWxH },
+  { "int64_t(const uint8_t*,int,const uint8_t*,int,int,int)", kSize32x32,
+    RunSse },
+  { "unsigned int(const uint8_t*,int)", kSizeFromName, RunAvg },
+  { "void(const uint8_t*,int,const uint8_t*,int,int*,int*)", kSizeFromName,
+    RunMinMax },
+  { "void(int16_t*,const uint8_t*,const int,const int)", kSizeNone,
+    RunIntProRow },
+  { "int16_t(const uint8_t*,const int)", kSizeNone, RunIntProCol },
+  { "int(const int16_t*,const int16_t*,const int)", kSizeNone,
+    RunVectorVar },
+  { "unsigned int(const int16_t*)", kSizeNone, RunGetMbSs },
+  { "uint64_t(const int16_t*,unsigned int)", kSize32x32, RunSumSquares },
+  { "uint64_t(const int16_t*,int,int,int)", kSize32x32, RunSumSquares2d },
+  { "int(const tran_low_t*,int)", kSize32x32, RunSatd },
+  { "int64_t(const tran_low_t*,const tran_low_t*,intptr_t,int64_t*)",
+    kSize32x32, RunBlockError },
+  { "int64_t(const tran_low_t*,const tran_low_t*,intptr_t,int64_t*,int)",
+    kSize32x32, RunHighbdBlockError },
+  { "void(int,int,int16_t*,ptrdiff_t,const uint8_t*,ptrdiff_t,"
+    "const uint8_t*,ptrdiff_t)",
+    kSize32x32, RunSubtractBlock },
+  { "void(int,int,int16_t*,ptrdiff_t,const uint8_t*,ptrdiff_t,"
+    "const uint8_t*,ptrdiff_t,int)",
+    kSize32x32, RunHighbdSubtractBlock },
+  { "void(uint8_t*,const uint8_t*,int,int,const uint8_t*,int)", kSize32x32,
+    RunCompAvgPred },
+  { "void(uint8_t*,const uint8_t*,int,int,const uint8_t*,int,"
+    "const DIST_WTD_COMP_PARAMS*)",
+    kSize32x32, RunDistWtdCompAvgPred },
+  { "void(uint8_t*,const uint8_t*,int,int,const uint8_t*,int,"
+    "const uint8_t*,int,int)",
+    kSize32x32, RunCompMaskPred },
+  { "void(uint8_t*,unsigned int,const uint8_t*,unsigned int,const uint8_t*,"
+    "unsigned int,const uint8_t*,unsigned int,int,int,int,int)",
+    kSize32x32, RunBlendMask },
+  { "void(uint8_t*,unsigned int,const uint8_t*,unsigned int,const uint8_t*,"
+    "unsigned int,const uint8_t*,unsigned int,int,int,int,int,int)",
+    kSize32x32, RunHighbdBlendMask },
+  { "void(uint8_t*,unsigned int,const CONV_BUF_TYPE*,unsigned int,"
+    "const CONV_BUF_TYPE*,unsigned int,const uint8_t*,unsigned int,int,int,"
+    "int,int,ConvolveParams*)",
+    kSize32x32, RunBlendMaskD16 },
+  { "void(uint8_t*,unsigned int,const CONV_BUF_TYPE*,unsigned int,"
+    "const CONV_BUF_TYPE*,unsigned int,const uint8_t*,unsigned int,int,int,"
+    "int,int,ConvolveParams*,const int)",
+    kSize32x32, RunHighbdBlendMaskD16 },
+  { "void(uint8_t*,unsigned int,const uint8_t*,unsigned int,const uint8_t*,"
+    "unsigned int,const uint8_t*,int,int)",
+    kSize32x32, RunBlendMask1d },
+  { "void(uint8_t*,unsigned int,const uint8_t*,unsigned int,const uint8_t*,"
+    "unsigned int,const uint8_t*,int,int,int)",
+    kSize32x32, RunHighbdBlendMask1d },
+  { "void(uint8_t*,DIFFWTD_MASK_TYPE,const uint8_t*,int,const uint8_t*,int,"
+    "int,int)",
+    kSize32x32, RunDiffwtdMask },
+  { "void(uint8_t*,DIFFWTD_MASK_TYPE,const uint8_t*,int,const uint8_t*,int,"
+    "int,int,int)",
+    kSize32x32, RunHighbdDiffwtdMask },
+  { "void(uint8_t*,DIFFWTD_MASK_TYPE,const CONV_BUF_TYPE*,int,"
+    "const CONV_BUF_TYPE*,int,int,int,ConvolveParams*,int)",
+    kSize32x32, RunDiffwtdMaskD16 },
+  { "void(const tran_low_t*,intptr_t,const int16_t*,const int16_t*,"
+    "const int16_t*,const int16_t*,tran_low_t*,tran_low_t*,const int16_t*,"
+    "uint16_t*,const int16_t*,const int16_t*)",
+    kSizeFromNameOr32x32, RunQuantize },
+  { "void(const tran_low_t*,intptr_t,const int16_t*,const int16_t*,"
+    "const int16_t*,const int16_t*,tran_low_t*,tran_low_t*,const int16_t*,"
+    "uint16_t*,const int16_t*,const int16_t*,int)",
+    kSizeFromNameOr32x32, RunQuantizeLogScale },
+  { "void(const int16_t*,tran_low_t*,int)", kSizeFromName, RunFdct },
+  { "void(const int16_t*,ptrdiff_t,tran_low_t*)", kSizeFromName,
+    RunHadamard },
+  { "void(const int16_t*,tran_low_t*,int,TxfmParam*)", kSize32x32,
+    RunFwdTxfm },
+  { "void(const tran_low_t*,uint8_t*,int,const TxfmParam*)",
+    kSizeFromNameOr32x32, RunInvTxfmAdd },
+  { "void(const tran_low_t*,uint8_t*,int,int)", kSizeFromName, RunIwhtAdd },
+  { "void(int32_t*,int,int)", kSize32x32, RunRoundShiftArray },
+  { "void(const tran_low_t*const,const int,const int,uint8_t*const)",
+    kSize32x32, RunTxbInitLevels },
+  { "void(const uint8_t*const,const int16_t*const,const uint16_t,"
+    "const TX_SIZE,const TX_CLASS,int8_t*const)",
+    kSize32x32, RunGetNzMapContexts },
+  { "void(const float*,float*,float*)", kSizeFromName, RunFft },
+  { "void(const int16_t*,int,int,int,float*,float*)", kSize32x32,
+    RunHorverCorrelation },
+  { "uint64_t(const int16_t*,const int16_t*,const uint8_t*,int)",
+    kSize32x32, RunWedgeSse },
+  { "int(const int16_t*,const uint8_t*,int,int64_t)", kSize32x32,
+    RunWedgeSign },
+  { "void(int16_t*,const int16_t*,const int16_t*,int)", kSize32x32,
+    RunWedgeDeltaSquares },
+  { "void(uint8_t*,int,int)", kSizeNone, RunFilterIntraEdge },
+  { "void(uint16_t*,int,int)", kSizeNone, RunHighbdFilterIntraEdge },
+  { "void(uint8_t*,int)", kSizeNone, RunUpsampleIntraEdge },
+  { "void(uint8_t*,ptrdiff_t,int,int,const uint8_t*,const uint8_t*,int,int,"
+    "int)",
+    kSize32x32, RunDrPredictionZ13 },
+  { "void(uint8_t*,ptrdiff_t,int,int,const uint8_t*,const uint8_t*,int,int,"
+    "int,int)",
+    kSize32x32, RunDrPredictionZ2 },
+  { "void(uint16_t*,ptrdiff_t,int,int,const uint16_t*,const uint16_t*,int,"
+    "int,int,int)",
+    kSize32x32, RunHighbdDrPredictionZ13 },
+  { "void(uint16_t*,ptrdiff_t,int,int,const uint16_t*,const uint16_t*,int,"
+    "int,int,int,int)",
+    kSize32x32, RunHighbdDrPredictionZ2 },
+  { "void(uint8_t*,ptrdiff_t,TX_SIZE,const uint8_t*,const uint8_t*,int)",
+    kSize32x32, RunFilterIntraPredictor },
+  { "int(const uint16_t*,int,int32_t*,int)", kSizeNone, RunCdefFindDir },
+  { "void(uint8_t*,uint16_t*,int,const uint16_t*,int,int,int,int,int,int,"
+    "int)",
+    kSizeNone, RunCdefFilterBlock },
+  { "void(uint16_t*,int,const uint8_t*,int,int,int)", kSize32x32,
+    RunCopyRect8To16 },
+  { "void(uint16_t*,int,const uint16_t*,int,int,int)", kSize32x32,
+    RunCopyRect16To16 },
+  { "void(const uint8_t*,int,uint8_t*,int,int,int,const InterpFilterParams*,"
+    "const InterpFilterParams*,const int,const int,ConvolveParams*)",
+    kSize32x32, RunConvolve2d },
+  { "void(const uint16_t*,int,uint16_t*,int,int,int,"
+    "const InterpFilterParams*,const InterpFilterParams*,const int,"
+    "const int,ConvolveParams*,int)",
+    kSize32x32, RunHighbdConvolve2d },
+  { "void(const uint8_t*,int,uint8_t*,int,int,int,const InterpFilterParams*,"
+    "const InterpFilterParams*,const int,const int,const int,const int,"
+    "ConvolveParams*)",
+    kSize32x32, RunConvolve2dScale },
+  { "void(const uint16_t*,int,uint16_t*,int,int,int,"
+    "const InterpFilterParams*,const InterpFilterParams*,const int,"
+    "const int,const int,const int,ConvolveParams*,int)",
+    kSize32x32, RunHighbdConvolve2dScale },
+  { "void(const uint8_t*,int,uint8_t*,int,int,int,const int16_t*,int,int)",
+    kSize32x32, RunConvolveHorizRs },
+  { "void(const uint16_t*,int,uint16_t*,int,int,int,const int16_t*,int,int,"
+    "int)",
+    kSize32x32, RunHighbdConvolveHorizRs },
+  { "void(const uint8_t*,ptrdiff_t,uint8_t*,ptrdiff_t,const int16_t*,int,"
+    "const int16_t*,int,int,int,const ConvolveParams*)",
+    kSize32x32, RunWienerConvolve },
+  { "void(const uint8_t*,ptrdiff_t,uint8_t*,ptrdiff_t,const int16_t*,int,"
+    "const int16_t*,int,int,int,const ConvolveParams*,int)",
+    kSize32x32, RunHighbdWienerConvolve },
+  { "void(const int32_t*,const uint8_t*,int,int,int,uint8_t*,int,int,int,int,"
+    "int,int,int,ConvolveParams*,int16_t,int16_t,int16_t,int16_t)",
+    kSize32x32, RunWarpAffine },
+  { "void(const int32_t*,const uint16_t*,int,int,int,uint16_t*,int,int,int,"
+    "int,int,int,int,int,ConvolveParams*,int16_t,int16_t,int16_t,int16_t)",
+    kSize32x32, RunHighbdWarpAffine },
+  { "void(int,const uint8_t*,const uint8_t*,int,int,int,int,int,int,"
+    "int64_t*,int64_t*)",
+    kSizeNone, RunComputeStats },
+  { "void(int,const uint8_t*,const uint8_t*,int,int,int,int,int,int,"
+    "int64_t*,int64_t*,aom_bit_depth_t)",
+    kSizeNone, RunHighbdComputeStats },
+  { "int(const uint8_t*,int,int,int,int32_t*,int32_t*,int,int,int,int)",
+    kSize32x32, RunSelfguidedRestoration },
+  { "void(const uint8_t*,int,int,int,int,const int*,uint8_t*,int,int32_t*,"
+    "int,int)",
+    kSize32x32, RunApplySelfguidedRestoration },
+  { "int64_t(const uint8_t*,int,int,int,const uint8_t*,int,int32_t*,int,"
+    "int32_t*,int,int*,const sgr_params_type*)",
+    kSize32x32, RunPixelProjError },
+  { "void(const uint8_t*,int,const uint8_t*,int,const uint8_t*,"
+    "const uint8_t*,int,const uint8_t*,const uint8_t*,int,unsigned int,"
+    "unsigned int,int,int,int,const int*,int,unsigned int*,uint16_t*,"
+    "unsigned int*,uint16_t*,unsigned int*,uint16_t*)",
+    kSizeNone, RunApplyTemporalFilter },
+  { "void(uint8_t*,unsigned int,uint8_t*,unsigned int,unsigned int,int,"
+    "const int*,int,unsigned int*,uint16_t*)",
+    kSizeNone, RunTemporalFilterApply },
+  { "double(unsigned char*,int,int,int,unsigned char*,int,int,int)",
+    kSizeNone, RunCrossCorrelation },
+  { "int(const unsigned char*,int,int,int,int*,int*)", kSizeNone,
+    RunFast9DetectRow },
+  { "unsigned int(void*,uint8_t*,int)", kSize32x32, RunCrc32c },
+  { "void(const unsigned char*,unsigned int,unsigned char*,unsigned int)",
+    kSizeNone, RunScaleLine },
+  { "void(unsigned char*,int,unsigned char*,int,unsigned int)", kSizeNone,
+    RunScaleBand },
+  { "void(struct yv12_buffer_config*)", kSizeNone, RunExtendFrameY },
+  { "void(struct yv12_buffer_config*,const int)", kSizeNone,
+    RunExtendFrame },
+  { "void(const struct yv12_buffer_config*,struct yv12_buffer_config*,"
+    "const int)",
+    kSizeNone, RunCopyFrame },
+  { "void(const struct yv12_buffer_config*,struct yv12_buffer_config*)",
+    kSizeNone, RunCopyPlane },
+  { "void(const struct yv12_buffer_config*,int,int,int,int,"
+    "struct yv12_buffer_config*,int,int)",
+    kSizeNone, RunPartialCopy },
+  { "void(const struct yv12_buffer_config*,struct yv12_buffer_config*,int,"
+    "int,int,int)",
+    kSizeNone, RunPartialColocCopy },
+};
+
+// The functions that are not measured, with the reason. The names may end
+// with '*', as in --filter.
+struct NotMeasured {
+  const char *name;
+  const char *reason;
+};
+
+const char kNeedsEncoder[] =
+    "takes the MACROBLOCKD and AV1Common of a running encoder";
+const char kReturnsKernel[] =
+    "returns the kernel for a transform size instead of running it";
+
+const NotMeasured kNotMeasured[] = {
+  { "aom_upsampled_pred", kNeedsEncoder },
+  { "aom_comp_avg_upsampled_pred", kNeedsEncoder },
+  { "aom_comp_mask_upsampled_pred", kNeedsEncoder },
+  { "aom_dist_wtd_comp_avg_upsampled_pred", kNeedsEncoder },
+  { "aom_highbd_upsampled_pred", kNeedsEncoder },
+  { "aom_highbd_comp_avg_upsampled_pred", kNeedsEncoder },
+  { "aom_highbd_dist_wtd_comp_avg_upsampled_pred", kNeedsEncoder },
+  { "av1_diamond_search_sad",
+    "takes the macroblock and search sites of a running encoder" },
+  { "av1_nn_predict", "the cost depends on the layout of each trained model" },
+  { "cfl_get_luma_subsampling_*", kReturnsKernel },
+  { "get_predict_hbd_fn", kReturnsKernel },
+  { "get_predict_lbd_fn", kReturnsKernel },
+  { "get_subtract_average_fn", kReturnsKernel },
+  { "aom_yv12_realloc_with_new_border",
+    "reallocates the frame, so it would measure the allocator" },
+};
+
+std::string Trim(const std::string &s) {
+  const size_t begin = s.find_first_not_of(' ');
+  if (begin == std::string::npos) return "";
+  return s.substr(begin, s.find_last_not_of(' ') - begin + 1);
+}
+
+// Removes the spaces around '*', and spells uint32_t as unsigned int.
+std::string CanonicalType(const std::string &type) {
+  std::string t = Trim(type);
+  for (size_t pos; (pos = t.find("uint32_t")) != std::string::npos;) {
+    t.replace(pos, 8, "unsigned int");
+  }
+  std::string out;
+  for (size_t i = 0; i < t.size(); ++i) {
+    const char prev = out.empty() ? '*' : out[out.size() - 1];
+    if (t[i] == ' ' && (prev == '*' || t[i + 1] == '*' || t[i + 1] == ' ')) {
+      continue;
+    }
+    out += t[i];
+  }
+  return out;
+}
+
+// Strips the parameter names from a prototype, so that
+// "unsigned int(const uint8_t *src_ptr, int src_stride)" becomes
+// "unsigned int(const uint8_t*,int)".
+std::string Signature(const char *proto) {
+  const std::string p(proto);
+  const size_t open = p.find('(');
+  const size_t close = p.rfind(')');
+  if (open == std::string::npos || close == std::string::npos || close < open)
+    return p;
+  const std::string params = p.substr(open + 1, close - open - 1);
+  std::string sig = CanonicalType(p.substr(0, open)) + "(";
+  for (size_t start = 0;;) {
+    const size_t comma = params.find(',', start);
+    std::string param = Trim(params.substr(
+        start, comma == std::string::npos ? comma : comma - start));
+    const size_t bracket = param.find('[');
+    if (bracket != std::string::npos) param = param.substr(0, bracket);
+    size_t name = param.size();
+    while (name > 0 && (isalnum(static_cast<unsigned char>(param[name - 1])) ||
+                        param[name - 1] == '_')) {
+      --name;
+    }
+    const std::string type = Trim(param.substr(0, name));
+    if (!type.empty() && type != "const" && type != "unsigned" &&
+        type != "struct") {
+      param = type;
+    }
+    if (bracket != std::string::npos) param += "*";
+    if (start > 0) sig += ",";
+    sig += CanonicalType(param);
+    if (comma == std::string::npos) break;
+    start = comma + 1;
+  }
+  return sig + ")";
+}
+
+// Finds the first WxH block size in a function name.
+bool ParseBlockSize(const char *name, int *w, int *h) {
+  for (const char *p = name; *p; ++p) {
+    if (!isdigit(static_cast<unsigned char>(*p)) ||
+        (p > name && isdigit(static_cast<unsigned char>(p[-1])))) {
+      continue;
+    }
+    if (sscanf(p, "%dx%d", w, h) == 2 && *w > 0 && *w <= kMaxBlockSize &&
+        *h > 0 && *h <= kMaxBlockSize) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Finds the width in a function name of the form aom_sad16xh.
+bool ParseWidth(const char *name, int *w) {
+  for (const char *p = name; *p; ++p) {
+    if (!isdigit(static_cast<unsigned char>(*p)) ||
+        (p > name && isdigit(static_cast<unsigned char>(p[-1])))) {
+      continue;
+    }
+    char x, h;
+    if (sscanf(p, "%d%c%c", w, &x, &h) == 3 && x == 'x' && h == 'h' &&
+        *w > 0 && *w <= kMaxBlockSize) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns the bit depth of the data: the one in the name of the high bit
+// depth functions that have one, e.g. aom_highbd_12_variance16x16, and 10 for
+// the other high bit depth functions.
+int BitDepth(const char *name, bool highbd) {
+  if (!highbd) return 8;
+  if (strstr(name, "highbd_8_")) return 8;
+  if (strstr(name, "highbd_12_")) return 12;
+  return 10;
+}
+
+bool MatchesFilter(const char *name, const char *filter) {
+  if (!filter) return true;
+  const size_t len = strlen(filter);
+  if (len > 0 && filter[len - 1] == '*') return !strncmp(name, filter, len - 1);
+  return !strcmp(name, filter);
+}
+
+// Returns the time per call in nanoseconds of the fastest of kRuns runs that
+// each last at least min_time_us, and the matching time stamp counter cycles
+// in *cycles, or 0 when there is no such counter.
+double Measure(RunFunc run, aom_rtcd_fn_t fn, Context *c, int64_t min_time_us,
+               double *cycles) {
+  aom_usec_timer timer;
+  int64_t elapsed;
+  int n = 1;
+  double best = DBL_MAX;
+
+  // Also warms up the caches.
+  for (;;) {
+    aom_usec_timer_start(&timer);
+    run(fn, c, n);
+    aom_usec_timer_mark(&timer);
+    libaom_test::ClearSystemState();
+    elapsed = aom_usec_timer_elapsed(&timer);
+    if (elapsed >= min_time_us / 8 || n >= (1 << 24)) break;
+    n *= 2;
+  }
+  if (elapsed < min_time_us) {
+    const double scale = static_cast<double>(min_time_us) / AOMMAX(elapsed, 1);
+    n = static_cast<int>(AOMMIN(n * scale, 1 << 30));
+  }
+
+  *cycles = 0;
+  for (int i = 0; i < kRuns; ++i) {
+#if ARCH_X86 || ARCH_X86_64
+    const uint64_t start = x86_readtsc64();
+#endif
+    aom_usec_timer_start(&timer);
+    run(fn, c, n);
+    aom_usec_timer_mark(&timer);
+#if ARCH_X86 || ARCH_X86_64
+    const uint64_t ticks = x86_readtsc64() - start;
+#else
+    const uint64_t ticks = 0;
+#endif
+    libaom_test::ClearSystemState();
+    const double ns = aom_usec_timer_elapsed(&timer) * 1000.0 / n;
+    if (ns < best) {
+      best = ns;
+      *cycles = static_cast<double>(ticks) / n;
+    }
+  }
+  return best;
+}
+
+// Returns how to drive the function, and its block size in *w and *h, or
+// NULL and the reason in *reason when it is not measured.
+const Prototype *FindPrototype(const aom_rtcd_func_t *func, int *w, int *h,
+                               const char **reason) {
+  for (const NotMeasured &entry : kNotMeasured) {
+    if (MatchesFilter(func->name, entry.name)) {
+      *reason = entry.reason;
+      return NULL;
+    }
+  }
+  const std::string signature = Signature(func->proto);
+  for (const Prototype &proto : kPrototypes) {
+    if (signature != proto.signature) continue;
+    *w = *h = 32;
+    switch (proto.size_mode) {
+      case kSizeFromName:
+        if (!ParseBlockSize(func->name, w, h)) {
+          *reason = "no block size in the name";
+          return NULL;
+        }
+        break;
+      case kSizeFromNameOr32x32: ParseBlockSize(func->name, w, h); break;
+      case kWidthFromName:
+        if (!ParseWidth(func->name, w)) {
+          *reason = "no block width in the name";
+          return NULL;
+        }
+        break;
+      default: break;
+    }
+    return &proto;
+  }
+  *reason = "unsupported prototype";
+  return NULL;
+}
+
+void Usage(const char *prog) {
+  fprintf(stderr,
+          "Usage: %s [--filter=<name>] [--min_time_ms=<n>]\n"
+          "  --filter       Function to measure, or prefix followed by '*'.\n"
+          "  --min_time_ms  Minimum duration of each run, %d by default.\n",
+          prog, kDefaultMinTimeMs);
+  exit(EXIT_FAILURE);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const char *filter = NULL;
+  int min_time_ms = kDefaultMinTimeMs;
+
+  for (int i = 1; i < argc; ++i) {
+    if (!strncmp(argv[i], "--filter=", 9)) {
+      filter = argv[i] + 9;
+    } else if (!strncmp(argv[i], "--min_time_ms=", 14)) {
+      min_time_ms = atoi(argv[i] + 14);
+      if (min_time_ms <= 0) Usage(argv[0]);
+    } else {
+      Usage(argv[0]);
+    }
+  }
+
+  aom_dsp_rtcd();
+  av1_rtcd();
+  aom_scale_rtcd();
+
+  Context context;
+  std::string skipped;
+  bool first = true;
+  int func_index;
+  const aom_rtcd_table_t *table;
+
+  printf("{\n  \"functions\": [");
+  for (int index = 0; (table = aom_rtcd_get_function(index, &func_index));
+       ++index) {
+    const aom_rtcd_func_t *const func = &table->funcs[func_index];
+    const aom_rtcd_impl_t *const impls = &table->impls[func->first_impl];
+    const char *reason;
+    int w, h;
+    if (!MatchesFilter(func->name, filter)) continue;
+    const Prototype *const proto = FindPrototype(func, &w, &h, &reason);
+    if (!proto) {
+      skipped += std::string(skipped.empty() ? "" : ",") +
+                 "\n    { \"name\": \"" + func->name + "\", \"reason\": \"" +
+                 reason + "\" }";
+      continue;
+    }
+    const bool highbd = strstr(func->name, "highbd") != NULL;
+    context.SetUp(func->name, w, h, BitDepth(func->name, highbd), highbd);
+
+    printf("%s\n    { \"name\": \"%s\", ", first ? "" : ",", func->name);
+    if (proto->size_mode != kSizeNone) {
+      printf("\"block\": \"%dx%d\", ", w, h);
+    }
+    printf("\"versions\": [");
+    first = false;
+    double baseline = 0;
+    bool first_version = true;
+    for (int i = 0; i < func->num_impls; ++i) {
+      const int needed = table->tier_flags[impls[i].tier];
+      if ((table->flags & needed) != needed) continue;
+      double cycles;
+      const double ns = Measure(proto->run, impls[i].fn, &context,
+                                min_time_ms * 1000, &cycles);
+      if (first_version) baseline = ns;
+      printf("%s\n        { \"tier\": \"%s\", \"ns_per_call\": %.2f, ",
+             first_version ? "" : ",", table->tier_names[impls[i].tier], ns);
+      if (cycles > 0) printf("\"cycles_per_call\": %.1f, ", cycles);
+      printf("\"speedup\": %.2f }", baseline / AOMMAX(ns, 0.001));
+      first_version = false;
+    }
+    printf(" ] }");
+    fflush(stdout);
+  }
+  printf("\n  ],\n  \"skipped\": [%s\n  ]\n}\n", skipped.c_str());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <sched.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <set>
+#include <string>
+
+#include "third_party/googletest/src/googletest/include/gtest/gtest.h"
+#include "config/aom_config.h"
+#include "aom/aomcx.h"
+#include "aom_util/aom_cpu_topology.h"
+#include "aom_util/aom_thread.h"
+#include "test/codec_factory.h"
+#include "test/encode_test_driver.h"
+#include "test/i420_video_source.h"
+#include "test/util.h"
+
+namespace {
+
+const int kNumFrames = 6;
+
+// The CPUs are listed once each, node by node.
+TEST(CpuTopologyTest, ListsCpusByNode) {
+  AomCpuTopology topology;
+  if (!aom_get_cpu_topology(&topology)) {
+#if defined(__linux__)
+    FAIL() << "The CPUs of Linux systems are known.";
+#endif
+    return;
+  }
+  ASSERT_GT(topology.num_cpus, 0);
+  ASSERT_LE(topology.num_cpus, AOM_MAX_CPUS);
+  ASSERT_GT(topology.num_nodes, 0);
+  EXPECT_EQ(0, topology.node[0]);
+  EXPECT_EQ(topology.num_nodes - 1, topology.node[topology.num_cpus - 1]);
+  std::set<int> cpus;
+  for (int i = 0; i < topology.num_cpus; ++i) {
+    EXPECT_TRUE(cpus.insert(topology.cpu[i]).second) << topology.cpu[i];
+    if (i > 0) {
+      EXPECT_LE(topology.node[i] - topology.node[i - 1], 1);
+    }
+    if (i > 0 && topology.node[i] == topology.node[i - 1]) {
+      EXPECT_LT(topology.cpu[i - 1], topology.cpu[i]);
+    }
+  }
+  EXPECT_GE(topology.current_node, 0);
+  EXPECT_LT(topology.current_node, topology.num_nodes);
+}
+
+// Builds a topology of 'num_nodes' nodes of 4 CPUs each, numbered from 0,
+// with the current CPU at index 'current_cpu'.
+void MakeTopology(int num_nodes, int current_cpu, AomCpuTopology *topology) {
+  memset(topology, 0, sizeof(*topology));
+  topology->num_nodes = num_nodes;
+  topology->num_cpus = 4 * num_nodes;
+  for (int i = 0; i < topology->num_cpus; ++i) {
+    topology->cpu[i] = i;
+    topology->node[i] = i / 4;
+  }
+  topology->current_cpu = current_cpu;
+  topology->current_node = topology->node[current_cpu];
+}
+
+// The workers fill the node of the main thread before the other nodes, also
+// when the main thread runs in the middle of its node.
+TEST(CpuTopologyTest, OrdersCpusOfCurrentNodeFirst) {
+  AomCpuTopology topology;
+  int order[AOM_MAX_CPUS];
+
+  MakeTopology(2, 5, &topology);
+  aom_get_cpu_order(&topology, order);
+  const int expected_two_nodes[] = { 5, 6, 7, 4, 0, 1, 2, 3 };
+  for (int i = 0; i < topology.num_cpus; ++i) {
+    EXPECT_EQ(expected_two_nodes[i], order[i]) << "index " << i;
+  }
+
+  MakeTopology(2, 2, &topology);
+  aom_get_cpu_order(&topology, order);
+  const int expected_first_node[] = { 2, 3, 0, 1, 4, 5, 6, 7 };
+  for (int i = 0; i < topology.num_cpus; ++i) {
+    EXPECT_EQ(expected_first_node[i], order[i]) << "index " << i;
+  }
+
+  MakeTopology(3, 6, &topology);
+  aom_get_cpu_order(&topology, order);
+  const int expected_three_nodes[] = { 6, 7, 4, 5, 8, 9, 10, 11, 0, 1, 2, 3 };
+  for (int i = 0; i < topology.num_cpus; ++i) {
+    EXPECT_EQ(expected_three_nodes[i], order[i]) << "index " << i;
+  }
+}
+
+#if CONFIG_MULTITHREAD && defined(__linux__)
+int GetCpuHook(void *arg1, void *) {
+  *static_cast<int *>(arg1) = sched_getcpu();
+  return 1;
+}
+
+// The thread of a worker runs on the CPU it is pinned to.
+TEST(CpuTopologyTest, PinsWorkerThread) {
+  AomCpuTopology topology;
+  ASSERT_TRUE(aom_get_cpu_topology(&topology));
+  const AVxWorkerInterface *const winterface = aom_get_worker_interface();
+  for (int i = 0; i < topology.num_cpus && i < 4; ++i) {
+    const int cpu = topology.cpu[topology.num_cpus - 1 - i];
+    AVxWorker worker;
+    int ran_on = -1;
+    winterface->init(&worker);
+    EXPECT_EQ(-1, worker.cpu);
+    worker.cpu = cpu;
+    ASSERT_TRUE(winterface->reset(&worker));
+    worker.hook = GetCpuHook;
+    worker.data1 = &ran_on;
+    winterface->launch(&worker);
+    EXPECT_TRUE(winterface->sync(&worker));
+    EXPECT_EQ(cpu, ran_on);
+    winterface->end(&worker);
+  }
+}
+
+// Counts the encoder worker threads of the process and those of them that may
+// run on a single CPU only.
+void CountPinnedWorkers(int *num_workers, int *num_pinned) {
+  *num_workers = 0;
+  *num_pinned = 0;
+  DIR *const dir = opendir("/proc/self/task");
+  if (dir == NULL) return;
+  struct dirent *entry;
+  while ((entry = readdir(dir)) != NULL) {
+    if (entry->d_name[0] == '.') continue;
+    const std::string path =
+        std::string("/proc/self/task/") + entry->d_name + "/comm";
+    char name[32] = "";
+    FILE *const file = fopen(path.c_str(), "r");
+    if (file == NULL) continue;
+    const bool named = fgets(name, sizeof(name), file) != NULL;
+    fclose(file);
+    if (!named || strcmp(name, "aom enc worker\n") != 0) continue;
+    ++*num_workers;
+    cpu_set_t allowed;
+    if (sched_getaffinity(atoi(entry->d_name), sizeof(allowed), &allowed) ==
+            0 &&
+        CPU_COUNT(&allowed) == 1) {
+      ++*num_pinned;
+    }
+  }
+  closedir(dir);
+}
+#endif  // CONFIG_MULTITHREAD && defined(__linux__)
+
+// The worker threads are pinned when the first multi-threaded frame creates
+// them.
+TEST(ThreadAffinityApiTest, SetBeforeWorkers) {
+  aom_codec_iface_t *iface = aom_codec_av1_cx();
+  aom_codec_enc_cfg_t cfg;
+  aom_codec_ctx_t enc;
+  aom_image_t img;
+  ASSERT_EQ(AOM_CODEC_OK, aom_codec_enc_config_default(iface, &cfg, 0));
+  cfg.g_w = 128;
+  cfg.g_h = 128;
+  cfg.g_threads = 2;
+  cfg.g_lag_in_frames = 0;
+  ASSERT_EQ(AOM_CODEC_OK, aom_codec_enc_init(&enc, iface, &cfg, 0));
+  EXPECT_EQ(AOM_CODEC_INVALID_PARAM,
+            aom_codec_control(&enc, AV1E_SET_THREAD_AFFINITY, 2));
+  EXPECT_EQ(AOM_CODEC_OK,
+            aom_codec_control(&enc, AV1E_SET_THREAD_AFFINITY, 1));
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_control(&enc, AV1E_SET_TILE_COLUMNS, 1));
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_control(&enc, AOME_SET_CPUUSED, 6));
+
+  ASSERT_TRUE(aom_img_alloc(&img, AOM_IMG_FMT_I420, cfg.g_w, cfg.g_h, 32));
+  memset(img.img_data, 128, cfg.g_w * cfg.g_h * 3 / 2);
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_encode(&enc, &img, 0, 1, 0));
+  EXPECT_EQ(AOM_CODEC_INCAPABLE,
+            aom_codec_control(&enc, AV1E_SET_THREAD_AFFINITY, 0));
+  aom_img_free(&img);
+  EXPECT_EQ(AOM_CODEC_OK, aom_codec_destroy(&enc));
+}
+
+class ThreadAffinityTest : public ::libaom_test::CodecTestWithParam<int>,
+                           public ::libaom_test::EncoderTest {
+ protected:
+  ThreadAffinityTest()
+      : EncoderTest(GET_PARAM(0)), row_mt_(GET_PARAM(1)), num_frames_(0),
+        num_workers_(0), num_pinned_(0) {}
+  virtual ~ThreadAffinityTest() {}
+
+  virtual void SetUp() {
+    InitializeConfig();
+    SetMode(::libaom_test::kOnePassGood);
+    cfg_.g_lag_in_frames = 0;
+    cfg_.g_threads = 4;
+    cfg_.rc_end_usage = AOM_CBR;
+    cfg_.rc_target_bitrate = 500;
+  }
+
+  virtual void PreEncodeFrameHook(::libaom_test::VideoSource *video,
+                                  ::libaom_test::Encoder *encoder) {
+    if (video->frame() == 0) {
+      encoder->Control(AOME_SET_CPUUSED, 6);
+      encoder->Control(AV1E_SET_TILE_COLUMNS, 1);
+      encoder->Control(AV1E_SET_TILE_ROWS, 1);
+      encoder->Control(AV1E_SET_ROW_MT, row_mt_);
+      encoder->Control(AV1E_SET_THREAD_AFFINITY, 1);
+    }
+  }
+
+  virtual void FramePktHook(const aom_codec_cx_pkt_t *) {
+    ++num_frames_;
+#if CONFIG_MULTITHREAD && defined(__linux__)
+    // The workers live as long as the encoder.
+    CountPinnedWorkers(&num_workers_, &num_pinned_);
+#endif
+  }
+
+  int row_mt_;
+  int num_frames_;
+  int num_workers_;
+  int num_pinned_;
+};
+
+// The encoder with pinned workers decodes to its own reconstruction.
+TEST_P(ThreadAffinityTest, Encode) {
+  ::libaom_test::I420VideoSource video("hantro_collage_w352h288.yuv", 352, 288,
+                                       30, 1, 0, kNumFrames);
+  ASSERT_NO_FATAL_FAILURE(RunLoop(&video));
+  EXPECT_EQ(kNumFrames, num_frames_);
+#if CONFIG_MULTITHREAD && defined(__linux__)
+  EXPECT_EQ(cfg_.g_threads - 1, static_cast<unsigned int>(num_workers_));
+  EXPECT_EQ(num_workers_, num_pinned_);
+#endif
+}
+
+AV1_INSTANTIATE_TEST_CASE(ThreadAffinityTest, ::testing::Values(0, 1));
+
+}  // namespace
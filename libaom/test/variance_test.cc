@@ -47,6 +47,10 @@ typedef unsigned int (*DistWtdSubpixAvgVarMxNFunc)(
     const uint8_t *a, int a_stride, int xoffset, int yoffset, const uint8_t *b,
     int b_stride, uint32_t *sse, const uint8_t *second_pred,
     const DIST_WTD_COMP_PARAMS *jcp_param);
+typedef void (*SubpixVarX4DFunc)(const uint8_t *const a[4], int a_stride,
+                                 const int *xoffset, const int *yoffset,
+                                 const uint8_t *b, int b_stride,
+                                 uint32_t *var, uint32_t *sse);
 typedef uint32_t (*ObmcSubpelVarFunc)(const uint8_t *pre, int pre_stride,
                                       int xoffset, int yoffset,
                                       const int32_t *wsrc, const int32_t *mask,
@@ -896,6 +900,76 @@ void SubpelVarianceTest<DistWtdSubpixAvgVarMxNFunc>::RefTest() {
   }
 }
 
+template <>
+void SubpelVarianceTest<SubpixVarX4DFunc>::RefTest() {
+  const int ref_stride = width() + 1;
+  const int ref_size = block_size() + width() + height() + 1;
+  uint8_t *const ref4 = new uint8_t[4 * ref_size];
+  for (int x = 0; x < 8; ++x) {
+    for (int y = 0; y < 8; ++y) {
+      for (int j = 0; j < block_size(); j++) {
+        src_[j] = rnd_.Rand8();
+      }
+      for (int j = 0; j < 4 * ref_size; j++) {
+        ref4[j] = rnd_.Rand8();
+      }
+      // Each candidate has its own reference block and sub-pixel offset.
+      const uint8_t *const refs[4] = { ref4, ref4 + ref_size,
+                                       ref4 + 2 * ref_size,
+                                       ref4 + 3 * ref_size };
+      const int xoffset[4] = { x, 7 - x, y, (x + y) & 7 };
+      const int yoffset[4] = { y, x, 7 - y, (x * y) & 7 };
+      uint32_t var1[4], sse1[4];
+      ASM_REGISTER_STATE_CHECK(params_.func(refs, ref_stride, xoffset, yoffset,
+                                            src_, width(), var1, sse1));
+      for (int k = 0; k < 4; ++k) {
+        uint32_t sse2;
+        const uint32_t var2 = subpel_variance_ref(
+            refs[k], src_, params_.log2width, params_.log2height, xoffset[k],
+            yoffset[k], &sse2, false, AOM_BITS_8);
+        EXPECT_EQ(sse1[k], sse2) << "candidate " << k << " at position "
+                                 << xoffset[k] << ", " << yoffset[k];
+        EXPECT_EQ(var1[k], var2) << "candidate " << k << " at position "
+                                 << xoffset[k] << ", " << yoffset[k];
+      }
+    }
+  }
+  delete[] ref4;
+}
+
+// Times as many candidate evaluations as SubpelVarianceTest::SpeedTest().
+template <>
+void SubpelVarianceTest<SubpixVarX4DFunc>::SpeedTest() {
+  const int ref_stride = width() + 1;
+  const int ref_size = block_size() + width() + height() + 1;
+  uint8_t *const ref4 = new uint8_t[4 * ref_size];
+  for (int j = 0; j < block_size(); j++) {
+    src_[j] = rnd_.Rand8();
+  }
+  for (int j = 0; j < 4 * ref_size; j++) {
+    ref4[j] = rnd_.Rand8();
+  }
+  const uint8_t *const refs[4] = { ref4, ref4 + ref_size, ref4 + 2 * ref_size,
+                                   ref4 + 3 * ref_size };
+
+  uint32_t var[4], sse[4];
+  int run_time = 1000000000 / block_size() / 4;
+  aom_usec_timer timer;
+
+  aom_usec_timer_start(&timer);
+  for (int i = 0; i < run_time; ++i) {
+    const int xoffset[4] = { rnd_(8), rnd_(8), rnd_(8), rnd_(8) };
+    const int yoffset[4] = { rnd_(8), rnd_(8), rnd_(8), rnd_(8) };
+    params_.func(refs, ref_stride, xoffset, yoffset, src_, width(), var, sse);
+  }
+  aom_usec_timer_mark(&timer);
+
+  const int elapsed_time = static_cast<int>(aom_usec_timer_elapsed(&timer));
+  printf("sub_pixel_variance_%dx%dx4d: %d us\n", width(), height(),
+         elapsed_time);
+  delete[] ref4;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 static const int kMaskMax = 64;
@@ -1060,6 +1134,7 @@ typedef SubpelVarianceTest<SubpixVarMxNFunc> AvxSubpelVarianceTest;
 typedef SubpelVarianceTest<SubpixAvgVarMxNFunc> AvxSubpelAvgVarianceTest;
 typedef SubpelVarianceTest<DistWtdSubpixAvgVarMxNFunc>
     AvxDistWtdSubpelAvgVarianceTest;
+typedef SubpelVarianceTest<SubpixVarX4DFunc> AvxSubpelVarianceX4DTest;
 typedef ObmcVarianceTest<ObmcSubpelVarFunc> AvxObmcSubpelVarianceTest;
 
 TEST_P(AvxSseTest, RefSse) { RefTestSse(); }
@@ -1075,8 +1150,11 @@ TEST_P(SumOfSquaresTest, Const) { ConstTest(); }
 TEST_P(SumOfSquaresTest, Ref) { RefTest(); }
 TEST_P(AvxSubpelVarianceTest, Ref) { RefTest(); }
 TEST_P(AvxSubpelVarianceTest, ExtremeRef) { ExtremeRefTest(); }
+TEST_P(AvxSubpelVarianceTest, DISABLED_Speed) { SpeedTest(); }
 TEST_P(AvxSubpelAvgVarianceTest, Ref) { RefTest(); }
 TEST_P(AvxDistWtdSubpelAvgVarianceTest, Ref) { RefTest(); }
+TEST_P(AvxSubpelVarianceX4DTest, Ref) { RefTest(); }
+TEST_P(AvxSubpelVarianceX4DTest, DISABLED_Speed) { SpeedTest(); }
 TEST_P(AvxObmcSubpelVarianceTest, Ref) { RefTest(); }
 TEST_P(AvxObmcSubpelVarianceTest, ExtremeRef) { ExtremeRefTest(); }
 TEST_P(AvxObmcSubpelVarianceTest, DISABLED_Speed) { SpeedTest(); }
@@ -1188,6 +1266,33 @@ INSTANTIATE_TEST_CASE_P(
                       DistWtdSubpelAvgVarianceParams(
                           2, 2, &aom_dist_wtd_sub_pixel_avg_variance4x4_c, 0)));
 
+typedef TestParams<SubpixVarX4DFunc> SubpelVarianceX4DParams;
+INSTANTIATE_TEST_CASE_P(
+    C, AvxSubpelVarianceX4DTest,
+    ::testing::Values(
+        SubpelVarianceX4DParams(7, 7, &aom_sub_pixel_variance128x128x4d_c, 0),
+        SubpelVarianceX4DParams(7, 6, &aom_sub_pixel_variance128x64x4d_c, 0),
+        SubpelVarianceX4DParams(6, 7, &aom_sub_pixel_variance64x128x4d_c, 0),
+        SubpelVarianceX4DParams(6, 6, &aom_sub_pixel_variance64x64x4d_c, 0),
+        SubpelVarianceX4DParams(6, 5, &aom_sub_pixel_variance64x32x4d_c, 0),
+        SubpelVarianceX4DParams(5, 6, &aom_sub_pixel_variance32x64x4d_c, 0),
+        SubpelVarianceX4DParams(5, 5, &aom_sub_pixel_variance32x32x4d_c, 0),
+        SubpelVarianceX4DParams(5, 4, &aom_sub_pixel_variance32x16x4d_c, 0),
+        SubpelVarianceX4DParams(4, 5, &aom_sub_pixel_variance16x32x4d_c, 0),
+        SubpelVarianceX4DParams(4, 4, &aom_sub_pixel_variance16x16x4d_c, 0),
+        SubpelVarianceX4DParams(4, 3, &aom_sub_pixel_variance16x8x4d_c, 0),
+        SubpelVarianceX4DParams(3, 4, &aom_sub_pixel_variance8x16x4d_c, 0),
+        SubpelVarianceX4DParams(3, 3, &aom_sub_pixel_variance8x8x4d_c, 0),
+        SubpelVarianceX4DParams(3, 2, &aom_sub_pixel_variance8x4x4d_c, 0),
+        SubpelVarianceX4DParams(2, 3, &aom_sub_pixel_variance4x8x4d_c, 0),
+        SubpelVarianceX4DParams(2, 2, &aom_sub_pixel_variance4x4x4d_c, 0),
+        SubpelVarianceX4DParams(2, 4, &aom_sub_pixel_variance4x16x4d_c, 0),
+        SubpelVarianceX4DParams(4, 2, &aom_sub_pixel_variance16x4x4d_c, 0),
+        SubpelVarianceX4DParams(3, 5, &aom_sub_pixel_variance8x32x4d_c, 0),
+        SubpelVarianceX4DParams(5, 3, &aom_sub_pixel_variance32x8x4d_c, 0),
+        SubpelVarianceX4DParams(4, 6, &aom_sub_pixel_variance16x64x4d_c, 0),
+        SubpelVarianceX4DParams(6, 4, &aom_sub_pixel_variance64x16x4d_c, 0)));
+
 INSTANTIATE_TEST_CASE_P(
     C, AvxObmcSubpelVarianceTest,
     ::testing::Values(
@@ -1605,6 +1710,31 @@ INSTANTIATE_TEST_CASE_P(
         SubpelAvgVarianceParams(2, 3, &aom_sub_pixel_avg_variance4x8_sse2, 0),
         SubpelAvgVarianceParams(2, 2, &aom_sub_pixel_avg_variance4x4_sse2, 0)));
 
+INSTANTIATE_TEST_CASE_P(
+    SSE2, AvxSubpelVarianceX4DTest,
+    ::testing::Values(
+        SubpelVarianceX4DParams(7, 7, &aom_sub_pixel_variance128x128x4d_sse2,
+                                0),
+        SubpelVarianceX4DParams(7, 6, &aom_sub_pixel_variance128x64x4d_sse2, 0),
+        SubpelVarianceX4DParams(6, 7, &aom_sub_pixel_variance64x128x4d_sse2, 0),
+        SubpelVarianceX4DParams(6, 6, &aom_sub_pixel_variance64x64x4d_sse2, 0),
+        SubpelVarianceX4DParams(6, 5, &aom_sub_pixel_variance64x32x4d_sse2, 0),
+        SubpelVarianceX4DParams(5, 6, &aom_sub_pixel_variance32x64x4d_sse2, 0),
+        SubpelVarianceX4DParams(5, 5, &aom_sub_pixel_variance32x32x4d_sse2, 0),
+        SubpelVarianceX4DParams(5, 4, &aom_sub_pixel_variance32x16x4d_sse2, 0),
+        SubpelVarianceX4DParams(4, 5, &aom_sub_pixel_variance16x32x4d_sse2, 0),
+        SubpelVarianceX4DParams(4, 4, &aom_sub_pixel_variance16x16x4d_sse2, 0),
+        SubpelVarianceX4DParams(4, 3, &aom_sub_pixel_variance16x8x4d_sse2, 0),
+        SubpelVarianceX4DParams(3, 4, &aom_sub_pixel_variance8x16x4d_sse2, 0),
+        SubpelVarianceX4DParams(3, 3, &aom_sub_pixel_variance8x8x4d_sse2, 0),
+        SubpelVarianceX4DParams(3, 2, &aom_sub_pixel_variance8x4x4d_sse2, 0),
+        SubpelVarianceX4DParams(4, 2, &aom_sub_pixel_variance16x4x4d_sse2, 0),
+        SubpelVarianceX4DParams(3, 5, &aom_sub_pixel_variance8x32x4d_sse2, 0),
+        SubpelVarianceX4DParams(5, 3, &aom_sub_pixel_variance32x8x4d_sse2, 0),
+        SubpelVarianceX4DParams(4, 6, &aom_sub_pixel_variance16x64x4d_sse2, 0),
+        SubpelVarianceX4DParams(6, 4, &aom_sub_pixel_variance64x16x4d_sse2,
+                                0)));
+
 #if HAVE_SSE4_1
 INSTANTIATE_TEST_CASE_P(
     SSE4_1, AvxSubpelVarianceTest,
@@ -2014,22 +2144,198 @@ INSTANTIATE_TEST_CASE_P(NEON, AvxMseTest,
 
 INSTANTIATE_TEST_CASE_P(
     NEON, AvxVarianceTest,
-    ::testing::Values(VarianceParams(6, 6, &aom_variance64x64_neon),
+    ::testing::Values(VarianceParams(7, 7, &aom_variance128x128_neon),
+                      VarianceParams(7, 6, &aom_variance128x64_neon),
+                      VarianceParams(6, 7, &aom_variance64x128_neon),
+                      VarianceParams(6, 6, &aom_variance64x64_neon),
                       VarianceParams(6, 5, &aom_variance64x32_neon),
                       VarianceParams(5, 6, &aom_variance32x64_neon),
                       VarianceParams(5, 5, &aom_variance32x32_neon),
+                      VarianceParams(5, 4, &aom_variance32x16_neon),
+                      VarianceParams(4, 5, &aom_variance16x32_neon),
                       VarianceParams(4, 4, &aom_variance16x16_neon),
                       VarianceParams(4, 3, &aom_variance16x8_neon),
                       VarianceParams(3, 4, &aom_variance8x16_neon),
-                      VarianceParams(3, 3, &aom_variance8x8_neon)));
+                      VarianceParams(3, 3, &aom_variance8x8_neon),
+                      VarianceParams(3, 2, &aom_variance8x4_neon),
+                      VarianceParams(2, 3, &aom_variance4x8_neon),
+                      VarianceParams(2, 2, &aom_variance4x4_neon),
+                      VarianceParams(2, 4, &aom_variance4x16_neon),
+                      VarianceParams(4, 2, &aom_variance16x4_neon),
+                      VarianceParams(3, 5, &aom_variance8x32_neon),
+                      VarianceParams(5, 3, &aom_variance32x8_neon),
+                      VarianceParams(4, 6, &aom_variance16x64_neon),
+                      VarianceParams(6, 4, &aom_variance64x16_neon)));
 
 INSTANTIATE_TEST_CASE_P(
     NEON, AvxSubpelVarianceTest,
     ::testing::Values(
+        SubpelVarianceParams(7, 7, &aom_sub_pixel_variance128x128_neon, 0),
+        SubpelVarianceParams(7, 6, &aom_sub_pixel_variance128x64_neon, 0),
+        SubpelVarianceParams(6, 7, &aom_sub_pixel_variance64x128_neon, 0),
         SubpelVarianceParams(6, 6, &aom_sub_pixel_variance64x64_neon, 0),
+        SubpelVarianceParams(6, 5, &aom_sub_pixel_variance64x32_neon, 0),
+        SubpelVarianceParams(5, 6, &aom_sub_pixel_variance32x64_neon, 0),
         SubpelVarianceParams(5, 5, &aom_sub_pixel_variance32x32_neon, 0),
+        SubpelVarianceParams(5, 4, &aom_sub_pixel_variance32x16_neon, 0),
+        SubpelVarianceParams(4, 5, &aom_sub_pixel_variance16x32_neon, 0),
         SubpelVarianceParams(4, 4, &aom_sub_pixel_variance16x16_neon, 0),
-        SubpelVarianceParams(3, 3, &aom_sub_pixel_variance8x8_neon, 0)));
+        SubpelVarianceParams(4, 3, &aom_sub_pixel_variance16x8_neon, 0),
+        SubpelVarianceParams(3, 4, &aom_sub_pixel_variance8x16_neon, 0),
+        SubpelVarianceParams(3, 3, &aom_sub_pixel_variance8x8_neon, 0),
+        SubpelVarianceParams(3, 2, &aom_sub_pixel_variance8x4_neon, 0),
+        SubpelVarianceParams(2, 3, &aom_sub_pixel_variance4x8_neon, 0),
+        SubpelVarianceParams(2, 2, &aom_sub_pixel_variance4x4_neon, 0),
+        SubpelVarianceParams(2, 4, &aom_sub_pixel_variance4x16_neon, 0),
+        SubpelVarianceParams(4, 2, &aom_sub_pixel_variance16x4_neon, 0),
+        SubpelVarianceParams(3, 5, &aom_sub_pixel_variance8x32_neon, 0),
+        SubpelVarianceParams(5, 3, &aom_sub_pixel_variance32x8_neon, 0),
+        SubpelVarianceParams(4, 6, &aom_sub_pixel_variance16x64_neon, 0),
+        SubpelVarianceParams(6, 4, &aom_sub_pixel_variance64x16_neon, 0)));
+
+const VarianceParams kArrayHBDVariance_neon[] = {
+  VarianceParams(7, 7, &aom_highbd_12_variance128x128_neon, 12),
+  VarianceParams(7, 6, &aom_highbd_12_variance128x64_neon, 12),
+  VarianceParams(6, 7, &aom_highbd_12_variance64x128_neon, 12),
+  VarianceParams(6, 6, &aom_highbd_12_variance64x64_neon, 12),
+  VarianceParams(6, 5, &aom_highbd_12_variance64x32_neon, 12),
+  VarianceParams(5, 6, &aom_highbd_12_variance32x64_neon, 12),
+  VarianceParams(5, 5, &aom_highbd_12_variance32x32_neon, 12),
+  VarianceParams(5, 4, &aom_highbd_12_variance32x16_neon, 12),
+  VarianceParams(4, 5, &aom_highbd_12_variance16x32_neon, 12),
+  VarianceParams(4, 4, &aom_highbd_12_variance16x16_neon, 12),
+  VarianceParams(4, 3, &aom_highbd_12_variance16x8_neon, 12),
+  VarianceParams(3, 4, &aom_highbd_12_variance8x16_neon, 12),
+  VarianceParams(3, 3, &aom_highbd_12_variance8x8_neon, 12),
+  VarianceParams(3, 2, &aom_highbd_12_variance8x4_neon, 12),
+  VarianceParams(2, 3, &aom_highbd_12_variance4x8_neon, 12),
+  VarianceParams(2, 2, &aom_highbd_12_variance4x4_neon, 12),
+  VarianceParams(2, 4, &aom_highbd_12_variance4x16_neon, 12),
+  VarianceParams(4, 2, &aom_highbd_12_variance16x4_neon, 12),
+  VarianceParams(3, 5, &aom_highbd_12_variance8x32_neon, 12),
+  VarianceParams(5, 3, &aom_highbd_12_variance32x8_neon, 12),
+  VarianceParams(4, 6, &aom_highbd_12_variance16x64_neon, 12),
+  VarianceParams(6, 4, &aom_highbd_12_variance64x16_neon, 12),
+  VarianceParams(7, 7, &aom_highbd_10_variance128x128_neon, 10),
+  VarianceParams(7, 6, &aom_highbd_10_variance128x64_neon, 10),
+  VarianceParams(6, 7, &aom_highbd_10_variance64x128_neon, 10),
+  VarianceParams(6, 6, &aom_highbd_10_variance64x64_neon, 10),
+  VarianceParams(6, 5, &aom_highbd_10_variance64x32_neon, 10),
+  VarianceParams(5, 6, &aom_highbd_10_variance32x64_neon, 10),
+  VarianceParams(5, 5, &aom_highbd_10_variance32x32_neon, 10),
+  VarianceParams(5, 4, &aom_highbd_10_variance32x16_neon, 10),
+  VarianceParams(4, 5, &aom_highbd_10_variance16x32_neon, 10),
+  VarianceParams(4, 4, &aom_highbd_10_variance16x16_neon, 10),
+  VarianceParams(4, 3, &aom_highbd_10_variance16x8_neon, 10),
+  VarianceParams(3, 4, &aom_highbd_10_variance8x16_neon, 10),
+  VarianceParams(3, 3, &aom_highbd_10_variance8x8_neon, 10),
+  VarianceParams(3, 2, &aom_highbd_10_variance8x4_neon, 10),
+  VarianceParams(2, 3, &aom_highbd_10_variance4x8_neon, 10),
+  VarianceParams(2, 2, &aom_highbd_10_variance4x4_neon, 10),
+  VarianceParams(2, 4, &aom_highbd_10_variance4x16_neon, 10),
+  VarianceParams(4, 2, &aom_highbd_10_variance16x4_neon, 10),
+  VarianceParams(3, 5, &aom_highbd_10_variance8x32_neon, 10),
+  VarianceParams(5, 3, &aom_highbd_10_variance32x8_neon, 10),
+  VarianceParams(4, 6, &aom_highbd_10_variance16x64_neon, 10),
+  VarianceParams(6, 4, &aom_highbd_10_variance64x16_neon, 10),
+  VarianceParams(7, 7, &aom_highbd_8_variance128x128_neon, 8),
+  VarianceParams(7, 6, &aom_highbd_8_variance128x64_neon, 8),
+  VarianceParams(6, 7, &aom_highbd_8_variance64x128_neon, 8),
+  VarianceParams(6, 6, &aom_highbd_8_variance64x64_neon, 8),
+  VarianceParams(6, 5, &aom_highbd_8_variance64x32_neon, 8),
+  VarianceParams(5, 6, &aom_highbd_8_variance32x64_neon, 8),
+  VarianceParams(5, 5, &aom_highbd_8_variance32x32_neon, 8),
+  VarianceParams(5, 4, &aom_highbd_8_variance32x16_neon, 8),
+  VarianceParams(4, 5, &aom_highbd_8_variance16x32_neon, 8),
+  VarianceParams(4, 4, &aom_highbd_8_variance16x16_neon, 8),
+  VarianceParams(4, 3, &aom_highbd_8_variance16x8_neon, 8),
+  VarianceParams(3, 4, &aom_highbd_8_variance8x16_neon, 8),
+  VarianceParams(3, 3, &aom_highbd_8_variance8x8_neon, 8),
+  VarianceParams(3, 2, &aom_highbd_8_variance8x4_neon, 8),
+  VarianceParams(2, 3, &aom_highbd_8_variance4x8_neon, 8),
+  VarianceParams(2, 2, &aom_highbd_8_variance4x4_neon, 8),
+  VarianceParams(2, 4, &aom_highbd_8_variance4x16_neon, 8),
+  VarianceParams(4, 2, &aom_highbd_8_variance16x4_neon, 8),
+  VarianceParams(3, 5, &aom_highbd_8_variance8x32_neon, 8),
+  VarianceParams(5, 3, &aom_highbd_8_variance32x8_neon, 8),
+  VarianceParams(4, 6, &aom_highbd_8_variance16x64_neon, 8),
+  VarianceParams(6, 4, &aom_highbd_8_variance64x16_neon, 8)
+};
+
+INSTANTIATE_TEST_CASE_P(NEON, AvxHBDVarianceTest,
+                        ::testing::ValuesIn(kArrayHBDVariance_neon));
+
+const SubpelVarianceParams kArrayHBDSubpelVariance_neon[] = {
+  SubpelVarianceParams(7, 7, &aom_highbd_12_sub_pixel_variance128x128_neon, 12),
+  SubpelVarianceParams(7, 6, &aom_highbd_12_sub_pixel_variance128x64_neon, 12),
+  SubpelVarianceParams(6, 7, &aom_highbd_12_sub_pixel_variance64x128_neon, 12),
+  SubpelVarianceParams(6, 6, &aom_highbd_12_sub_pixel_variance64x64_neon, 12),
+  SubpelVarianceParams(6, 5, &aom_highbd_12_sub_pixel_variance64x32_neon, 12),
+  SubpelVarianceParams(5, 6, &aom_highbd_12_sub_pixel_variance32x64_neon, 12),
+  SubpelVarianceParams(5, 5, &aom_highbd_12_sub_pixel_variance32x32_neon, 12),
+  SubpelVarianceParams(5, 4, &aom_highbd_12_sub_pixel_variance32x16_neon, 12),
+  SubpelVarianceParams(4, 5, &aom_highbd_12_sub_pixel_variance16x32_neon, 12),
+  SubpelVarianceParams(4, 4, &aom_highbd_12_sub_pixel_variance16x16_neon, 12),
+  SubpelVarianceParams(4, 3, &aom_highbd_12_sub_pixel_variance16x8_neon, 12),
+  SubpelVarianceParams(3, 4, &aom_highbd_12_sub_pixel_variance8x16_neon, 12),
+  SubpelVarianceParams(3, 3, &aom_highbd_12_sub_pixel_variance8x8_neon, 12),
+  SubpelVarianceParams(3, 2, &aom_highbd_12_sub_pixel_variance8x4_neon, 12),
+  SubpelVarianceParams(2, 3, &aom_highbd_12_sub_pixel_variance4x8_neon, 12),
+  SubpelVarianceParams(2, 2, &aom_highbd_12_sub_pixel_variance4x4_neon, 12),
+  SubpelVarianceParams(2, 4, &aom_highbd_12_sub_pixel_variance4x16_neon, 12),
+  SubpelVarianceParams(4, 2, &aom_highbd_12_sub_pixel_variance16x4_neon, 12),
+  SubpelVarianceParams(3, 5, &aom_highbd_12_sub_pixel_variance8x32_neon, 12),
+  SubpelVarianceParams(5, 3, &aom_highbd_12_sub_pixel_variance32x8_neon, 12),
+  SubpelVarianceParams(4, 6, &aom_highbd_12_sub_pixel_variance16x64_neon, 12),
+  SubpelVarianceParams(6, 4, &aom_highbd_12_sub_pixel_variance64x16_neon, 12),
+  SubpelVarianceParams(7, 7, &aom_highbd_10_sub_pixel_variance128x128_neon, 10),
+  SubpelVarianceParams(7, 6, &aom_highbd_10_sub_pixel_variance128x64_neon, 10),
+  SubpelVarianceParams(6, 7, &aom_highbd_10_sub_pixel_variance64x128_neon, 10),
+  SubpelVarianceParams(6, 6, &aom_highbd_10_sub_pixel_variance64x64_neon, 10),
+  SubpelVarianceParams(6, 5, &aom_highbd_10_sub_pixel_variance64x32_neon, 10),
+  SubpelVarianceParams(5, 6, &aom_highbd_10_sub_pixel_variance32x64_neon, 10),
+  SubpelVarianceParams(5, 5, &aom_highbd_10_sub_pixel_variance32x32_neon, 10),
+  SubpelVarianceParams(5, 4, &aom_highbd_10_sub_pixel_variance32x16_neon, 10),
+  SubpelVarianceParams(4, 5, &aom_highbd_10_sub_pixel_variance16x32_neon, 10),
+  SubpelVarianceParams(4, 4, &aom_highbd_10_sub_pixel_variance16x16_neon, 10),
+  SubpelVarianceParams(4, 3, &aom_highbd_10_sub_pixel_variance16x8_neon, 10),
+  SubpelVarianceParams(3, 4, &aom_highbd_10_sub_pixel_variance8x16_neon, 10),
+  SubpelVarianceParams(3, 3, &aom_highbd_10_sub_pixel_variance8x8_neon, 10),
+  SubpelVarianceParams(3, 2, &aom_highbd_10_sub_pixel_variance8x4_neon, 10),
+  SubpelVarianceParams(2, 3, &aom_highbd_10_sub_pixel_variance4x8_neon, 10),
+  SubpelVarianceParams(2, 2, &aom_highbd_10_sub_pixel_variance4x4_neon, 10),
+  SubpelVarianceParams(2, 4, &aom_highbd_10_sub_pixel_variance4x16_neon, 10),
+  SubpelVarianceParams(4, 2, &aom_highbd_10_sub_pixel_variance16x4_neon, 10),
+  SubpelVarianceParams(3, 5, &aom_highbd_10_sub_pixel_variance8x32_neon, 10),
+  SubpelVarianceParams(5, 3, &aom_highbd_10_sub_pixel_variance32x8_neon, 10),
+  SubpelVarianceParams(4, 6, &aom_highbd_10_sub_pixel_variance16x64_neon, 10),
+  SubpelVarianceParams(6, 4, &aom_highbd_10_sub_pixel_variance64x16_neon, 10),
+  SubpelVarianceParams(7, 7, &aom_highbd_8_sub_pixel_variance128x128_neon, 8),
+  SubpelVarianceParams(7, 6, &aom_highbd_8_sub_pixel_variance128x64_neon, 8),
+  SubpelVarianceParams(6, 7, &aom_highbd_8_sub_pixel_variance64x128_neon, 8),
+  SubpelVarianceParams(6, 6, &aom_highbd_8_sub_pixel_variance64x64_neon, 8),
+  SubpelVarianceParams(6, 5, &aom_highbd_8_sub_pixel_variance64x32_neon, 8),
+  SubpelVarianceParams(5, 6, &aom_highbd_8_sub_pixel_variance32x64_neon, 8),
+  SubpelVarianceParams(5, 5, &aom_highbd_8_sub_pixel_variance32x32_neon, 8),
+  SubpelVarianceParams(5, 4, &aom_highbd_8_sub_pixel_variance32x16_neon, 8),
+  SubpelVarianceParams(4, 5, &aom_highbd_8_sub_pixel_variance16x32_neon, 8),
+  SubpelVarianceParams(4, 4, &aom_highbd_8_sub_pixel_variance16x16_neon, 8),
+  SubpelVarianceParams(4, 3, &aom_highbd_8_sub_pixel_variance16x8_neon, 8),
+  SubpelVarianceParams(3, 4, &aom_highbd_8_sub_pixel_variance8x16_neon, 8),
+  SubpelVarianceParams(3, 3, &aom_highbd_8_sub_pixel_variance8x8_neon, 8),
+  SubpelVarianceParams(3, 2, &aom_highbd_8_sub_pixel_variance8x4_neon, 8),
+  SubpelVarianceParams(2, 3, &aom_highbd_8_sub_pixel_variance4x8_neon, 8),
+  SubpelVarianceParams(2, 2, &aom_highbd_8_sub_pixel_variance4x4_neon, 8),
+  SubpelVarianceParams(2, 4, &aom_highbd_8_sub_pixel_variance4x16_neon, 8),
+  SubpelVarianceParams(4, 2, &aom_highbd_8_sub_pixel_variance16x4_neon, 8),
+  SubpelVarianceParams(3, 5, &aom_highbd_8_sub_pixel_variance8x32_neon, 8),
+  SubpelVarianceParams(5, 3, &aom_highbd_8_sub_pixel_variance32x8_neon, 8),
+  SubpelVarianceParams(4, 6, &aom_highbd_8_sub_pixel_variance16x64_neon, 8),
+  SubpelVarianceParams(6, 4, &aom_highbd_8_sub_pixel_variance64x16_neon, 8)
+};
+
+INSTANTIATE_TEST_CASE_P(NEON, AvxHBDSubpelVarianceTest,
+                        ::testing::ValuesIn(kArrayHBDSubpelVariance_neon));
 #endif  // HAVE_NEON
 
 #if HAVE_MSA
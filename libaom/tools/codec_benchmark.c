@@ -0,0 +1,605 @@
+/*
+ * Copyright (c) 2019, Alliance for Open Media. All rights reserved
+ *
+ * This source code is subject to the terms of the BSD 2 Clause License and
+ * the Alliance for Open Media Patent License 1.0. If the BSD 2 Clause License
+ * was not distributed with this source code in the LICENSE file, you can
+ * obtain it at www.aomedia.org/license/software. If the Alliance for Open
+ * Media Patent License 1.0 was not distributed with this source code in the
+ * PATENTS file, you can obtain it at www.aomedia.org/license/patent.
+ */
+
+// Codec Benchmark
+// ===============
+//
+// Measures the encoder and decoder speed on deterministic synthetic content,
+// so that speed regressions can be checked without test vectors or network
+// access. The content is generated frame by frame:
+//   gradient - diagonal gradients moving across the frame,
+//   noise    - uniform noise that changes every frame,
+//   text     - screen content, lines of glyphs scrolling up like a terminal,
+//   pan      - a textured canvas panned right and down.
+// Every combination of content, bit depth, speed, tile columns and threads is
+// encoded in memory, decoded back with the same number of threads, and
+// reported as one entry of a JSON document with the encode and decode frame
+// rates, the time of each codec stage (see AV1E_SET_STAGE_TIMING and
+// AV1D_SET_STAGE_TIMING) and the peak resident set size of the process so
+// far. Generating the content is not timed. --thread-affinity pins the encoder
+// worker threads (see AV1E_SET_THREAD_AFFINITY).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include "aom/aom_decoder.h"
+#include "aom/aom_encoder.h"
+#include "aom/aomcx.h"
+#include "aom/aomdx.h"
+#include "aom_dsp/aom_dsp_common.h"
+#include "aom_ports/aom_timer.h"
+#include "common/args.h"
+#include "common/tools_common.h"
+
+#define MAX_LIST_SIZE 16
+
+typedef enum {
+  CONTENT_GRADIENT,
+  CONTENT_NOISE,
+  CONTENT_TEXT,
+  CONTENT_PAN,
+  CONTENT_TYPES
+} CONTENT_TYPE;
+
+static const char *const content_names[CONTENT_TYPES] = { "gradient", "noise",
+                                                          "text", "pan" };
+
+static const char *const enc_stage_names[AOM_ENC_STAGES] = {
+  "lookahead",   "temporal_filter", "tpl",              "mode_search",
+  "loop_filter", "cdef",            "loop_restoration", "pack_bitstream",
+  "first_pass"
+};
+
+static const char *const dec_stage_names[AOM_DEC_STAGES] = {
+  "header", "tiles", "loop_filter", "cdef", "loop_restoration", "film_grain",
+  "output"
+};
+
+static const arg_def_t help_arg =
+    ARG_DEF(NULL, "help", 0, "Show usage options and exit");
+static const arg_def_t output_arg =
+    ARG_DEF("o", "output", 1, "Output JSON file name (default stdout)");
+static const arg_def_t width_arg =
+    ARG_DEF("w", "width", 1, "Frame width (default 640)");
+static const arg_def_t height_arg =
+    ARG_DEF("h", "height", 1, "Frame height (default 360)");
+static const arg_def_t frames_arg =
+    ARG_DEF("f", "frames", 1, "Frames to encode per run (default 30)");
+static const arg_def_t bitrate_arg =
+    ARG_DEF(NULL, "bitrate", 1, "Target bitrate in kbps (default 1000)");
+static const arg_def_t content_arg = ARG_DEF(
+    NULL, "content", 1,
+    "Comma separated list of gradient, noise, text and pan (default all)");
+static const arg_def_t bit_depths_arg =
+    ARG_DEF(NULL, "bit-depths", 1, "Comma separated bit depths (default 8)");
+static const arg_def_t speeds_arg =
+    ARG_DEF(NULL, "speeds", 1, "Comma separated encoder speeds (default 6)");
+static const arg_def_t tile_columns_arg = ARG_DEF(
+    NULL, "tile-columns", 1, "Comma separated log2 tile columns (default 0)");
+static const arg_def_t threads_arg =
+    ARG_DEF(NULL, "threads", 1, "Comma separated thread counts (default 1)");
+static const arg_def_t thread_affinity_arg =
+    ARG_DEF(NULL, "thread-affinity", 0, "Pin the encoder worker threads");
+
+static const arg_def_t *all_args[] = {
+  &help_arg,   &output_arg,       &width_arg,   &height_arg,
+  &frames_arg, &bitrate_arg,      &content_arg, &bit_depths_arg,
+  &speeds_arg, &tile_columns_arg, &threads_arg, &thread_affinity_arg,
+  NULL
+};
+
+typedef struct {
+  int width;
+  int height;
+  int frames;
+  int bitrate;
+  int content[CONTENT_TYPES];
+  int num_content;
+  int bit_depths[MAX_LIST_SIZE];
+  int num_bit_depths;
+  int speeds[MAX_LIST_SIZE];
+  int num_speeds;
+  int tile_columns[MAX_LIST_SIZE];
+  int num_tile_columns;
+  int threads[MAX_LIST_SIZE];
+  int num_threads;
+  int thread_affinity;
+} BenchmarkConfig;
+
+typedef struct {
+  int content;
+  int bit_depth;
+  int speed;
+  int tile_columns;
+  int threads;
+  size_t encoded_bytes;
+  uint64_t encode_us;
+  uint64_t decode_us;
+  aom_enc_stage_timing_t enc_timing;
+  aom_dec_stage_timing_t dec_timing;
+  int decode_workers;
+  uint64_t worker_busy_us;
+  uint64_t worker_idle_us;
+  long peak_rss_kb;
+} BenchmarkResult;
+
+// The encoded frames of one run.
+typedef struct {
+  uint8_t *data;
+  size_t size;
+  size_t capacity;
+  size_t *frame_sizes;
+  int num_frames;
+  int frame_capacity;
+} EncodedStream;
+
+static const char *exec_name;
+
+void usage_exit(void) {
+  fprintf(stderr, "Usage: %s <options>\n\nOptions:\n", exec_name);
+  arg_show_usage(stderr, all_args);
+  exit(EXIT_FAILURE);
+}
+
+static uint32_t hash3(uint32_t a, uint32_t b, uint32_t c) {
+  uint32_t h = a * 0x9E3779B1u ^ b * 0x85EBCA77u ^ c * 0xC2B2AE3Du;
+  h ^= h >> 15;
+  h *= 0x2C1B3C6Du;
+  h ^= h >> 12;
+  h *= 0x297A2D39u;
+  h ^= h >> 15;
+  return h;
+}
+
+// Triangle wave with the given period, in [0, period / 2].
+static int triangle(int v, int period) {
+  v %= period;
+  if (v < 0) v += period;
+  return v < period / 2 ? v : period - v;
+}
+
+// The content generators return 10-bit samples for a sample of the plane
+// with the given dimensions.
+static int gradient_sample(int plane, int x, int y, int frame, int w, int h) {
+  if (plane == 0) {
+    return AOMMIN(triangle(x * 1024 / w + y * 512 / h + frame * 12, 2048),
+                  1023);
+  }
+  const int v = plane == 1 ? x * 256 / w + frame * 4 : y * 256 / h - frame * 3;
+  return 448 + triangle(v, 256);
+}
+
+static int noise_sample(int plane, int x, int y, int frame, int w, int h) {
+  (void)w;
+  (void)h;
+  const uint32_t r = hash3(x, y, frame * 4 + plane);
+  return plane == 0 ? 256 + (int)(r & 511) : 448 + (int)(r & 127);
+}
+
+// Rows of pseudo random 5x7 glyphs in 8x12 cells under a dark title bar.
+static int text_sample(int plane, int x, int y, int frame, int w, int h) {
+  (void)w;
+  const int title_bar = y < h / 12;
+  if (plane != 0) {
+    if (!title_bar) return 512;
+    return plane == 1 ? 640 : 384;
+  }
+  if (title_bar) return 300;
+  const int ty = y + frame;
+  const int cell_row = ty / 12, cell_col = x / 8;
+  const int gx = x % 8 - 1, gy = ty % 12 - 2;
+  if (gx < 0 || gx >= 5 || gy < 0 || gy >= 7) return 940;
+  // Leave some cells blank as spaces between words.
+  if (hash3(cell_row, cell_col, 0) % 6 == 0) return 940;
+  return (hash3(cell_row, cell_col, 1 + gy * 5 + gx) & 1) ? 80 : 940;
+}
+
+static int pan_texture(int u, int v) {
+  return triangle(u, 128) * 4 + triangle(v, 96) * 4 +
+         triangle(u + 2 * v, 180) * 2 + (int)(hash3(u >> 2, v >> 2, 0) & 255) +
+         32;
+}
+
+static int pan_sample(int plane, int x, int y, int frame, int w, int h) {
+  (void)w;
+  (void)h;
+  if (plane == 0) return pan_texture(x + frame * 3, y + frame);
+  // The chroma planes sample the texture at half resolution, so that they
+  // move with the luma plane.
+  return 256 + pan_texture(2 * x + frame * 3 + plane * 37,
+                           2 * y + frame + plane * 11) /
+                   2;
+}
+
+typedef int (*content_sample_fn)(int plane, int x, int y, int frame, int w,
+                                 int h);
+
+static const content_sample_fn content_fns[CONTENT_TYPES] = {
+  gradient_sample, noise_sample, text_sample, pan_sample
+};
+
+static void generate_frame(aom_image_t *img, int content, int frame) {
+  const content_sample_fn sample = content_fns[content];
+  const int shift = 10 - (int)img->bit_depth;
+  for (int plane = 0; plane < 3; ++plane) {
+    const int w = plane ? (int)(img->d_w + 1) >> 1 : (int)img->d_w;
+    const int h = plane ? (int)(img->d_h + 1) >> 1 : (int)img->d_h;
+    for (int y = 0; y < h; ++y) {
+      uint8_t *const row = img->planes[plane] + y * img->stride[plane];
+      for (int x = 0; x < w; ++x) {
+        const int v = sample(plane, x, y, frame, w, h) >> shift;
+        if (img->fmt & AOM_IMG_FMT_HIGHBITDEPTH) {
+          ((uint16_t *)row)[x] = (uint16_t)v;
+        } else {
+          row[x] = (uint8_t)v;
+        }
+      }
+    }
+  }
+}
+
+static long peak_rss_kb(void) {
+#if defined(__linux__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#if defined(__APPLE__)
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+#else
+  return -1;
+#endif
+}
+
+static void append_frame(EncodedStream *stream, const void *buf, size_t sz) {
+  if (stream->size + sz > stream->capacity) {
+    stream->capacity = AOMMAX(2 * stream->capacity, stream->size + sz);
+    stream->data = (uint8_t *)realloc(stream->data, stream->capacity);
+    if (!stream->data) die("Failed to grow the encoded stream.");
+  }
+  if (stream->num_frames == stream->frame_capacity) {
+    stream->frame_capacity = AOMMAX(2 * stream->frame_capacity, 64);
+    stream->frame_sizes = (size_t *)realloc(
+        stream->frame_sizes, stream->frame_capacity * sizeof(size_t));
+    if (!stream->frame_sizes) die("Failed to grow the encoded stream.");
+  }
+  memcpy(stream->data + stream->size, buf, sz);
+  stream->size += sz;
+  stream->frame_sizes[stream->num_frames++] = sz;
+}
+
+static void add_enc_timing(aom_codec_ctx_t *encoder,
+                           aom_enc_stage_timing_t *total) {
+  aom_enc_stage_timing_t timing;
+  if (aom_codec_control(encoder, AV1E_GET_STAGE_TIMING, &timing))
+    die_codec(encoder, "Failed to get the stage timing");
+  for (int i = 0; i < AOM_ENC_STAGES; ++i)
+    total->time_us[i] += timing.time_us[i];
+}
+
+// Encodes one aom_codec_encode() call and returns whether any packets were
+// output.
+static int encode_frame(aom_codec_ctx_t *encoder, const aom_image_t *img,
+                        aom_codec_pts_t pts, EncodedStream *stream,
+                        BenchmarkResult *result) {
+  struct aom_usec_timer timer;
+  aom_usec_timer_start(&timer);
+  if (aom_codec_encode(encoder, img, pts, 1, 0))
+    die_codec(encoder, "Failed to encode frame");
+  aom_codec_iter_t iter = NULL;
+  const aom_codec_cx_pkt_t *pkt;
+  int got_pkts = 0;
+  while ((pkt = aom_codec_get_cx_data(encoder, &iter)) != NULL) {
+    got_pkts = 1;
+    if (pkt->kind == AOM_CODEC_CX_FRAME_PKT)
+      append_frame(stream, pkt->data.frame.buf, pkt->data.frame.sz);
+  }
+  aom_usec_timer_mark(&timer);
+  result->encode_us += aom_usec_timer_elapsed(&timer);
+  add_enc_timing(encoder, &result->enc_timing);
+  return got_pkts;
+}
+
+static void encode_stream(const BenchmarkConfig *config,
+                          BenchmarkResult *result, EncodedStream *stream) {
+  aom_codec_iface_t *const iface = aom_codec_av1_cx();
+  const int hbd = result->bit_depth > 8;
+  aom_codec_enc_cfg_t cfg;
+  aom_codec_ctx_t encoder;
+  aom_image_t img;
+
+  if (hbd && !(aom_codec_get_caps(iface) & AOM_CODEC_CAP_HIGHBITDEPTH))
+    die("The encoder does not support high bit depth.");
+  if (aom_codec_enc_config_default(iface, &cfg, 0))
+    die("Failed to get the default encoder config.");
+  cfg.g_w = config->width;
+  cfg.g_h = config->height;
+  cfg.g_timebase.num = 1;
+  cfg.g_timebase.den = 30;
+  cfg.g_threads = result->threads;
+  cfg.g_bit_depth = (aom_bit_depth_t)result->bit_depth;
+  cfg.g_input_bit_depth = result->bit_depth;
+  cfg.rc_target_bitrate = config->bitrate;
+  if (aom_codec_enc_init(&encoder, iface, &cfg,
+                         hbd ? AOM_CODEC_USE_HIGHBITDEPTH : 0))
+    die_codec(&encoder, "Failed to initialize encoder");
+  if (aom_codec_control(&encoder, AOME_SET_CPUUSED, result->speed))
+    die_codec(&encoder, "Failed to set the speed");
+  if (aom_codec_control(&encoder, AV1E_SET_TILE_COLUMNS, result->tile_columns))
+    die_codec(&encoder, "Failed to set the tile columns");
+  if (aom_codec_control(&encoder, AV1E_SET_THREAD_AFFINITY,
+                        config->thread_affinity))
+    die_codec(&encoder, "Failed to set the thread affinity");
+  if (aom_codec_control(&encoder, AV1E_SET_STAGE_TIMING, 1))
+    die_codec(&encoder, "Failed to enable the stage timing");
+
+  if (!aom_img_alloc(&img, hbd ? AOM_IMG_FMT_I42016 : AOM_IMG_FMT_I420,
+                     config->width, config->height, 32))
+    die("Failed to allocate image.");
+  img.bit_depth = result->bit_depth;
+
+  for (int frame = 0; frame < config->frames; ++frame) {
+    generate_frame(&img, result->content, frame);
+    encode_frame(&encoder, &img, frame, stream, result);
+  }
+  while (encode_frame(&encoder, NULL, -1, stream, result)) {
+  }
+
+  result->encoded_bytes = stream->size;
+  aom_img_free(&img);
+  if (aom_codec_destroy(&encoder)) die_codec(&encoder, "Failed to destroy");
+}
+
+static void decode_stream(const EncodedStream *stream,
+                          BenchmarkResult *result) {
+  aom_codec_dec_cfg_t cfg;
+  aom_codec_ctx_t decoder;
+  const uint8_t *buf = stream->data;
+
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.threads = result->threads;
+
+  if (aom_codec_dec_init(&decoder, aom_codec_av1_dx(), &cfg, 0))
+    die_codec(&decoder, "Failed to initialize decoder");
+  if (aom_codec_control(&decoder, AV1D_SET_STAGE_TIMING, 1))
+    die_codec(&decoder, "Failed to enable the stage timing");
+
+  for (int i = 0; i < stream->num_frames; ++i) {
+    struct aom_usec_timer timer;
+    aom_usec_timer_start(&timer);
+    if (aom_codec_decode(&decoder, buf, stream->frame_sizes[i], NULL))
+      die_codec(&decoder, "Failed to decode frame");
+    aom_codec_iter_t iter = NULL;
+    while (aom_codec_get_frame(&decoder, &iter) != NULL) {
+    }
+    aom_usec_timer_mark(&timer);
+    result->decode_us += aom_usec_timer_elapsed(&timer);
+    buf += stream->frame_sizes[i];
+
+    aom_dec_stage_timing_t timing;
+    if (aom_codec_control(&decoder, AV1D_GET_STAGE_TIMING, &timing))
+      die_codec(&decoder, "Failed to get the stage timing");
+    for (int s = 0; s < AOM_DEC_STAGES; ++s)
+      result->dec_timing.time_us[s] += timing.time_us[s];
+    result->decode_workers = AOMMAX(result->decode_workers, timing.num_workers);
+    for (int w = 0; w < timing.num_workers; ++w) {
+      result->worker_busy_us += timing.worker_busy_us[w];
+      result->worker_idle_us += timing.worker_idle_us[w];
+    }
+  }
+  if (aom_codec_destroy(&decoder)) die_codec(&decoder, "Failed to destroy");
+}
+
+static double fps(int frames, uint64_t us) {
+  return us ? frames * 1000000.0 / us : 0.0;
+}
+
+static void write_stage_times(FILE *out, const char *name,
+                              const char *const *stage_names, int num_stages,
+                              const uint64_t *time_us) {
+  fprintf(out, "      \"%s\": {", name);
+  for (int i = 0; i < num_stages; ++i) {
+    fprintf(out, "%s\"%s\": %llu", i ? ", " : "", stage_names[i],
+            (unsigned long long)time_us[i]);
+  }
+  fprintf(out, "},\n");
+}
+
+static void write_result(FILE *out, const BenchmarkConfig *config,
+                         const BenchmarkResult *result, int last) {
+  fprintf(out, "    {\n");
+  fprintf(out, "      \"content\": \"%s\",\n", content_names[result->content]);
+  fprintf(out, "      \"bit_depth\": %d,\n", result->bit_depth);
+  fprintf(out, "      \"speed\": %d,\n", result->speed);
+  fprintf(out, "      \"tile_columns_log2\": %d,\n", result->tile_columns);
+  fprintf(out, "      \"threads\": %d,\n", result->threads);
+  fprintf(out, "      \"encoded_bytes\": %llu,\n",
+          (unsigned long long)result->encoded_bytes);
+  fprintf(out, "      \"encode_fps\": %.3f,\n",
+          fps(config->frames, result->encode_us));
+  fprintf(out, "      \"decode_fps\": %.3f,\n",
+          fps(config->frames, result->decode_us));
+  write_stage_times(out, "encode_stage_us", enc_stage_names, AOM_ENC_STAGES,
+                    result->enc_timing.time_us);
+  write_stage_times(out, "decode_stage_us", dec_stage_names, AOM_DEC_STAGES,
+                    result->dec_timing.time_us);
+  fprintf(out, "      \"decode_workers\": %d,\n", result->decode_workers);
+  fprintf(out, "      \"decode_worker_busy_us\": %llu,\n",
+          (unsigned long long)result->worker_busy_us);
+  fprintf(out, "      \"decode_worker_idle_us\": %llu,\n",
+          (unsigned long long)result->worker_idle_us);
+  fprintf(out, "      \"peak_rss_kb\": %ld\n", result->peak_rss_kb);
+  fprintf(out, "    }%s\n", last ? "" : ",");
+}
+
+static void parse_content(const char *list, BenchmarkConfig *config) {
+  config->num_content = 0;
+  while (*list != '\0') {
+    const char *const end = strchr(list, ',');
+    const size_t len = end ? (size_t)(end - list) : strlen(list);
+    int content = 0;
+    while (content < CONTENT_TYPES &&
+           (strlen(content_names[content]) != len ||
+            strncmp(list, content_names[content], len))) {
+      ++content;
+    }
+    if (content == CONTENT_TYPES)
+      die("Unknown content type: %.*s\n", (int)len, list);
+    if (config->num_content == CONTENT_TYPES)
+      die("Too many content types.\n");
+    config->content[config->num_content++] = content;
+    list += len + (end != NULL);
+  }
+}
+
+static void parse_args(char **argv, BenchmarkConfig *config,
+                       const char **output) {
+  struct arg arg;
+  char **argi, **argj;
+
+  for (argi = argj = argv; (*argj = *argi); argi += arg.argv_step) {
+    memset(&arg, 0, sizeof(arg));
+    arg.argv_step = 1;
+    if (arg_match(&arg, &help_arg, argi)) {
+      fprintf(stdout, "Usage: %s <options>\n\nOptions:\n", exec_name);
+      arg_show_usage(stdout, all_args);
+      exit(EXIT_SUCCESS);
+    } else if (arg_match(&arg, &output_arg, argi)) {
+      *output = arg.val;
+    } else if (arg_match(&arg, &width_arg, argi)) {
+      config->width = arg_parse_uint(&arg);
+    } else if (arg_match(&arg, &height_arg, argi)) {
+      config->height = arg_parse_uint(&arg);
+    } else if (arg_match(&arg, &frames_arg, argi)) {
+      config->frames = arg_parse_uint(&arg);
+    } else if (arg_match(&arg, &bitrate_arg, argi)) {
+      config->bitrate = arg_parse_uint(&arg);
+    } else if (arg_match(&arg, &content_arg, argi)) {
+      parse_content(arg.val, config);
+    } else if (arg_match(&arg, &bit_depths_arg, argi)) {
+      config->num_bit_depths =
+          arg_parse_list(&arg, config->bit_depths, MAX_LIST_SIZE);
+    } else if (arg_match(&arg, &speeds_arg, argi)) {
+      config->num_speeds = arg_parse_list(&arg, config->speeds, MAX_LIST_SIZE);
+    } else if (arg_match(&arg, &tile_columns_arg, argi)) {
+      config->num_tile_columns =
+          arg_parse_list(&arg, config->tile_columns, MAX_LIST_SIZE);
+    } else if (arg_match(&arg, &threads_arg, argi)) {
+      config->num_threads =
+          arg_parse_list(&arg, config->threads, MAX_LIST_SIZE);
+    } else if (arg_match(&arg, &thread_affinity_arg, argi)) {
+      config->thread_affinity = 1;
+    } else {
+      argj++;
+    }
+  }
+  for (argi = argv; *argi; ++argi) {
+    if (argi[0][0] == '-' && strlen(argi[0]) > 1)
+      die("Error: Unrecognized option %s\n", *argi);
+  }
+  if (argv[0]) usage_exit();
+
+  if (config->width < 16 || config->height < 16)
+    die("The frame must be at least 16x16.\n");
+  if (config->frames < 1) die("At least one frame must be encoded.\n");
+  if (config->num_content < 1 || config->num_bit_depths < 1 ||
+      config->num_speeds < 1 || config->num_tile_columns < 1 ||
+      config->num_threads < 1)
+    die("Every list option needs at least one value.\n");
+  for (int i = 0; i < config->num_bit_depths; ++i) {
+    if (config->bit_depths[i] != 8 && config->bit_depths[i] != 10)
+      die("Bit depth must be 8 or 10.\n");
+  }
+  for (int i = 0; i < config->num_threads; ++i) {
+    if (config->threads[i] < 1) die("Thread counts must be positive.\n");
+  }
+}
+
+int main(int argc, const char **argv_) {
+  BenchmarkConfig config;
+  const char *output = NULL;
+  FILE *out = stdout;
+
+  exec_name = argv_[0];
+  memset(&config, 0, sizeof(config));
+  config.width = 640;
+  config.height = 360;
+  config.frames = 30;
+  config.bitrate = 1000;
+  for (int i = 0; i < CONTENT_TYPES; ++i) config.content[i] = i;
+  config.num_content = CONTENT_TYPES;
+  config.bit_depths[0] = 8;
+  config.num_bit_depths = 1;
+  config.speeds[0] = 6;
+  config.num_speeds = 1;
+  config.tile_columns[0] = 0;
+  config.num_tile_columns = 1;
+  config.threads[0] = 1;
+  config.num_threads = 1;
+
+  char **argv = argv_dup(argc - 1, argv_ + 1);
+  if (!argv) die("Failed to allocate memory for the arguments.\n");
+  parse_args(argv, &config, &output);
+  free(argv);
+
+  if (output) {
+    out = fopen(output, "w");
+    if (!out) die("Failed to open %s for writing.\n", output);
+  }
+
+  const int num_runs = config.num_content * config.num_bit_depths *
+                       config.num_speeds * config.num_tile_columns *
+                       config.num_threads;
+  fprintf(out, "{\n");
+  fprintf(out, "  \"codec\": \"%s\",\n",
+          aom_codec_iface_name(aom_codec_av1_cx()));
+  fprintf(out, "  \"width\": %d,\n", config.width);
+  fprintf(out, "  \"height\": %d,\n", config.height);
+  fprintf(out, "  \"frames\": %d,\n", config.frames);
+  fprintf(out, "  \"bitrate_kbps\": %d,\n", config.bitrate);
+  fprintf(out, "  \"thread_affinity\": %d,\n", config.thread_affinity);
+  fprintf(out, "  \"runs\": [\n");
+  int run = 0;
+  for (int c = 0; c < config.num_content; ++c) {
+    for (int b = 0; b < config.num_bit_depths; ++b) {
+      for (int s = 0; s < config.num_speeds; ++s) {
+        for (int t = 0; t < config.num_tile_columns; ++t) {
+          for (int n = 0; n < config.num_threads; ++n) {
+            BenchmarkResult result;
+            EncodedStream stream;
+            memset(&result, 0, sizeof(result));
+            memset(&stream, 0, sizeof(stream));
+            result.content = config.content[c];
+            result.bit_depth = config.bit_depths[b];
+            result.speed = config.speeds[s];
+            result.tile_columns = config.tile_columns[t];
+            result.threads = config.threads[n];
+            encode_stream(&config, &result, &stream);
+            decode_stream(&stream, &result);
+            result.peak_rss_kb = peak_rss_kb();
+            write_result(out, &config, &result, ++run == num_runs);
+            fflush(out);
+            free(stream.data);
+            free(stream.frame_sizes);
+          }
+        }
+      }
+    }
+  }
+  fprintf(out, "  ]\n}\n");
+  if (out != stdout) fclose(out);
+  return EXIT_SUCCESS;
+}